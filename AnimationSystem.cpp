@@ -0,0 +1,139 @@
+#include "AnimationSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define ANIMATION_SYSTEM_AVX 1
+#else
+#define ANIMATION_SYSTEM_AVX 0
+#endif
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define ANIMATION_SYSTEM_SSE2 1
+#else
+#define ANIMATION_SYSTEM_SSE2 0
+#endif
+
+const float AnimationSystem::MaxStepSeconds = 1.0f;
+
+namespace
+{
+    // The definition the SIMD kernels follow operation for operation, so that
+    // they produce the same values. The phase stays in [0, 1) and below 2^31
+    // after the step, truncation is the floor.
+    inline float Animate(float& phase, float rate, float from, float range, float pingPong, float eased, float elapsed)
+    {
+        float p = phase + elapsed * rate;
+        p = p - static_cast<float>(static_cast<int32_t>(p));
+        phase = p;
+
+        const float triangle = 1.0f - std::fabs(2.0f * p - 1.0f);
+        float u = p + pingPong * (triangle - p);
+        const float smooth = u * u * (3.0f - 2.0f * u);
+        u = u + eased * (smooth - u);
+        return from + range * u;
+    }
+}
+
+uint32_t AnimationSystem::Add(float from, float to, float periodSeconds, AnimationCurve curve, float phase)
+{
+    if (!(periodSeconds > 0.0f))
+    {
+        throw std::invalid_argument("AnimationSystem::Add: the period must be positive");
+    }
+
+    m_phase.push_back(phase - std::floor(phase));
+    m_rate.push_back(1.0f / periodSeconds);
+    m_from.push_back(from);
+    m_range.push_back(to - from);
+    m_pingPong.push_back(curve != AnimationCurveLinear ? 1.0f : 0.0f);
+    m_eased.push_back(curve == AnimationCurveEased ? 1.0f : 0.0f);
+    return static_cast<uint32_t>(m_phase.size() - 1);
+}
+
+void AnimationSystem::Clear()
+{
+    m_phase.clear();
+    m_rate.clear();
+    m_from.clear();
+    m_range.clear();
+    m_pingPong.clear();
+    m_eased.clear();
+}
+
+void AnimationSystem::Update(float elapsedSeconds, float* values)
+{
+    const float elapsed = std::min<float>(std::max<float>(elapsedSeconds, 0.0f), MaxStepSeconds);
+    const uint32_t count = GetCount();
+    float* phase = m_phase.data();
+    uint32_t i = 0;
+
+#if ANIMATION_SYSTEM_AVX
+    {
+        const __m256 step = _mm256_set1_ps(elapsed);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 two = _mm256_set1_ps(2.0f);
+        const __m256 three = _mm256_set1_ps(3.0f);
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 p = _mm256_add_ps(_mm256_loadu_ps(phase + i), _mm256_mul_ps(step, _mm256_loadu_ps(&m_rate[i])));
+            p = _mm256_sub_ps(p, _mm256_cvtepi32_ps(_mm256_cvttps_epi32(p)));
+            _mm256_storeu_ps(phase + i, p);
+
+            const __m256 triangle = _mm256_sub_ps(one, _mm256_andnot_ps(signMask, _mm256_sub_ps(_mm256_mul_ps(two, p), one)));
+            __m256 u = _mm256_add_ps(p, _mm256_mul_ps(_mm256_loadu_ps(&m_pingPong[i]), _mm256_sub_ps(triangle, p)));
+            const __m256 smooth = _mm256_mul_ps(_mm256_mul_ps(u, u), _mm256_sub_ps(three, _mm256_mul_ps(two, u)));
+            u = _mm256_add_ps(u, _mm256_mul_ps(_mm256_loadu_ps(&m_eased[i]), _mm256_sub_ps(smooth, u)));
+            _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(&m_from[i]), _mm256_mul_ps(_mm256_loadu_ps(&m_range[i]), u)));
+        }
+    }
+#endif
+
+#if ANIMATION_SYSTEM_SSE2
+    {
+        const __m128 step = _mm_set1_ps(elapsed);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 three = _mm_set1_ps(3.0f);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 p = _mm_add_ps(_mm_loadu_ps(phase + i), _mm_mul_ps(step, _mm_loadu_ps(&m_rate[i])));
+            p = _mm_sub_ps(p, _mm_cvtepi32_ps(_mm_cvttps_epi32(p)));
+            _mm_storeu_ps(phase + i, p);
+
+            const __m128 triangle = _mm_sub_ps(one, _mm_andnot_ps(signMask, _mm_sub_ps(_mm_mul_ps(two, p), one)));
+            __m128 u = _mm_add_ps(p, _mm_mul_ps(_mm_loadu_ps(&m_pingPong[i]), _mm_sub_ps(triangle, p)));
+            const __m128 smooth = _mm_mul_ps(_mm_mul_ps(u, u), _mm_sub_ps(three, _mm_mul_ps(two, u)));
+            u = _mm_add_ps(u, _mm_mul_ps(_mm_loadu_ps(&m_eased[i]), _mm_sub_ps(smooth, u)));
+            _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(&m_from[i]), _mm_mul_ps(_mm_loadu_ps(&m_range[i]), u)));
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        values[i] = Animate(phase[i], m_rate[i], m_from[i], m_range[i], m_pingPong[i], m_eased[i], elapsed);
+    }
+}
+
+void AnimationSystem::UpdateReference(float elapsedSeconds, float* values)
+{
+    const float elapsed = std::min<float>(std::max<float>(elapsedSeconds, 0.0f), MaxStepSeconds);
+    for (uint32_t i = 0; i < GetCount(); ++i)
+    {
+        values[i] = Animate(m_phase[i], m_rate[i], m_from[i], m_range[i], m_pingPong[i], m_eased[i], elapsed);
+    }
+}
+
+const char* AnimationSystem::GetSimdName()
+{
+    return ANIMATION_SYSTEM_AVX ? "AVX" : ANIMATION_SYSTEM_SSE2 ? "SSE2" : "scalar";
+}
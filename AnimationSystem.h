@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+enum AnimationCurve
+{
+    AnimationCurveLinear,       // from to to, then starts over.
+    AnimationCurvePingPong,     // from to to and back, at constant speed.
+    AnimationCurveEased,        // Ping-pong slowing down at both ends (smoothstep).
+};
+
+// Float parameters animated over real time, stored as a structure of arrays.
+// Every parameter keeps its position in the cycle as a phase in [0, 1), which
+// Update advances by the elapsed time and turns into a value through its
+// curve. The curves are evaluated without branches, blended by per-parameter
+// weights, so a batch of any mix of curves runs through the same SIMD kernel:
+// AVX when the build enables it, SSE2 otherwise, scalar on other targets.
+class AnimationSystem
+{
+public:
+    // Longest step of a single Update, a longer gap (a debugger break, a
+    // window drag) does not make the animations jump.
+    static const float MaxStepSeconds;
+
+    // A parameter going through a whole cycle every periodSeconds, starting
+    // phase into it. Returns its index in the values Update writes.
+    uint32_t Add(float from, float to, float periodSeconds, AnimationCurve curve, float phase = 0.0f);
+
+    void Clear();
+    uint32_t GetCount() const                   { return static_cast<uint32_t>(m_phase.size()); }
+
+    // Advance every parameter and write the value of parameter i to values[i].
+    // values may point into write-combined memory, it is only written to.
+    void Update(float elapsedSeconds, float* values);
+    void UpdateReference(float elapsedSeconds, float* values);
+
+    static const char* GetSimdName();
+
+private:
+    std::vector<float> m_phase;
+    std::vector<float> m_rate;          // Cycles per second.
+    std::vector<float> m_from;
+    std::vector<float> m_range;         // to - from.
+    std::vector<float> m_pingPong;      // 1 folds the phase into a triangle wave.
+    std::vector<float> m_eased;         // 1 applies the smoothstep.
+};
@@ -0,0 +1,216 @@
+#include "BlobPack.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const uint32_t PackMagic = 0x50424c42; // "BLBP"
+    const uint32_t PackVersion = 1;
+    const uint64_t PackDataAlignment = 16;
+
+    struct PackHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+    };
+
+    struct PackEntry
+    {
+        uint64_t key;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+BlobPackReader::BlobPackReader() :
+    m_entries(nullptr),
+    m_entryCount(0)
+{
+}
+
+bool BlobPackReader::Open(const std::string& path)
+{
+    Close();
+
+    if (!m_file.Open(path))
+    {
+        return false;
+    }
+
+    // Validate everything up front so lookups can trust the table.
+    const uint64_t fileSize = m_file.GetSize();
+    if (fileSize < sizeof(PackHeader))
+    {
+        Close();
+        return false;
+    }
+
+    PackHeader header;
+    memcpy(&header, m_file.GetData(), sizeof(header));
+    if (header.magic != PackMagic || header.version != PackVersion ||
+        header.entryCount > (fileSize - sizeof(PackHeader)) / sizeof(PackEntry))
+    {
+        Close();
+        return false;
+    }
+
+    const Entry* entries = reinterpret_cast<const Entry*>(m_file.GetData() + sizeof(PackHeader));
+    for (uint32_t i = 0; i < header.entryCount; ++i)
+    {
+        const Entry& entry = entries[i];
+        if (entry.offset > fileSize || entry.size > fileSize - entry.offset ||
+            (i > 0 && entries[i - 1].key >= entry.key))
+        {
+            Close();
+            return false;
+        }
+    }
+
+    m_entries = entries;
+    m_entryCount = header.entryCount;
+    return true;
+}
+
+void BlobPackReader::Close()
+{
+    m_file.Close();
+    m_entries = nullptr;
+    m_entryCount = 0;
+}
+
+bool BlobPackReader::Find(uint64_t key, const uint8_t** data, uint64_t* size) const
+{
+    const Entry* end = m_entries + m_entryCount;
+    const Entry* entry = std::lower_bound(m_entries, end, key,
+        [](const Entry& e, uint64_t k) { return e.key < k; });
+
+    if (entry == end || entry->key != key)
+    {
+        return false;
+    }
+
+    *data = m_file.GetData() + entry->offset;
+    *size = entry->size;
+    return true;
+}
+
+void BlobPackReader::GetEntry(uint32_t index, uint64_t* key, const uint8_t** data, uint64_t* size) const
+{
+    const Entry& entry = m_entries[index];
+    *key = entry.key;
+    *data = m_file.GetData() + entry.offset;
+    *size = entry.size;
+}
+
+void BlobPackWriter::Add(uint64_t key, const void* data, uint64_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    m_blobs[key].assign(bytes, bytes + size);
+}
+
+bool BlobPackWriter::Write(const std::string& path) const
+{
+    static_assert(sizeof(PackEntry) == 24, "Pack entries are read in place");
+
+    PackHeader header = { PackMagic, PackVersion, static_cast<uint32_t>(m_blobs.size()), 0 };
+
+    // std::map keeps the keys sorted, which is what the reader's binary search expects.
+    std::vector<PackEntry> entries;
+    entries.reserve(m_blobs.size());
+
+    uint64_t offset = AlignUp(sizeof(PackHeader) + m_blobs.size() * sizeof(PackEntry), PackDataAlignment);
+    for (const auto& blob : m_blobs)
+    {
+        PackEntry entry = { blob.first, offset, blob.second.size() };
+        entries.push_back(entry);
+        offset = AlignUp(offset + blob.second.size(), PackDataAlignment);
+    }
+
+    std::vector<uint8_t> file(static_cast<size_t>(offset), 0);
+    memcpy(file.data(), &header, sizeof(header));
+    if (!entries.empty())
+    {
+        memcpy(file.data() + sizeof(header), entries.data(), entries.size() * sizeof(PackEntry));
+    }
+
+    size_t index = 0;
+    for (const auto& blob : m_blobs)
+    {
+        if (!blob.second.empty())
+        {
+            memcpy(file.data() + entries[index].offset, blob.second.data(), blob.second.size());
+        }
+        index++;
+    }
+
+    return WriteFileAtomic(path, file.data(), file.size());
+}
+
+BlobStore::BlobStore(const std::string& path) :
+    m_path(path)
+{
+    m_pack.Open(m_path);
+}
+
+bool BlobStore::Find(uint64_t key, const uint8_t** data, uint64_t* size) const
+{
+    auto added = m_added.find(key);
+    if (added != m_added.end())
+    {
+        *data = added->second.data();
+        *size = added->second.size();
+        return true;
+    }
+
+    return m_pack.Find(key, data, size);
+}
+
+void BlobStore::Add(uint64_t key, std::vector<uint8_t>& blob)
+{
+    m_added[key].swap(blob);
+}
+
+bool BlobStore::Save()
+{
+    if (m_added.empty())
+    {
+        return true;
+    }
+
+    // Keep the entries of the existing pack, they may belong to other build
+    // configurations.
+    BlobPackWriter writer;
+    for (uint32_t i = 0; i < m_pack.GetEntryCount(); ++i)
+    {
+        uint64_t key;
+        const uint8_t* data;
+        uint64_t size;
+        m_pack.GetEntry(i, &key, &data, &size);
+        writer.Add(key, data, size);
+    }
+
+    for (const auto& added : m_added)
+    {
+        writer.Add(added.first, added.second.data(), added.second.size());
+    }
+
+    // The old pack has to be unmapped before it can be replaced.
+    m_pack.Close();
+    const bool written = writer.Write(m_path);
+
+    if (written)
+    {
+        m_added.clear();
+    }
+    m_pack.Open(m_path);
+
+    return written;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Pack file of binary blobs keyed by a 64-bit hash. The file starts with a
+// header and an entry table sorted by key, followed by the blob data aligned to
+// 16 bytes. Readers memory-map the file and hand out pointers straight into it.
+class BlobPackReader
+{
+public:
+    BlobPackReader();
+
+    // Returns false if the file is missing or not a valid pack.
+    bool Open(const std::string& path);
+    void Close();
+
+    // Pointers stay valid until the reader is closed.
+    bool Find(uint64_t key, const uint8_t** data, uint64_t* size) const;
+
+    uint32_t GetEntryCount() const { return m_entryCount; }
+    void GetEntry(uint32_t index, uint64_t* key, const uint8_t** data, uint64_t* size) const;
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    MappedFile m_file;
+    const Entry* m_entries;
+    uint32_t m_entryCount;
+};
+
+class BlobPackWriter
+{
+public:
+    // Blobs are copied. Adding an existing key replaces its blob.
+    void Add(uint64_t key, const void* data, uint64_t size);
+
+    bool Contains(uint64_t key) const { return m_blobs.count(key) != 0; }
+    size_t GetEntryCount() const { return m_blobs.size(); }
+
+    // Writes the pack atomically, see WriteFileAtomic.
+    bool Write(const std::string& path) const;
+
+private:
+    std::map<uint64_t, std::vector<uint8_t>> m_blobs;
+};
+
+// Persistent key/blob store: a mapped pack file plus the blobs added since it
+// was opened. Lookups see the added blobs first, so adding an existing key
+// replaces a stale entry.
+class BlobStore
+{
+public:
+    // A missing or corrupt pack is simply an empty store.
+    explicit BlobStore(const std::string& path);
+
+    // Pointers stay valid until the store is saved or destroyed, or their key
+    // is added again.
+    bool Find(uint64_t key, const uint8_t** data, uint64_t* size) const;
+
+    // Takes the contents of blob.
+    void Add(uint64_t key, std::vector<uint8_t>& blob);
+
+    bool IsDirty() const { return !m_added.empty(); }
+
+    // Merge the added blobs into the pack. The pack is remapped, which
+    // invalidates every pointer returned so far.
+    bool Save();
+
+private:
+    std::string m_path;
+    BlobPackReader m_pack;
+    std::unordered_map<uint64_t, std::vector<uint8_t>> m_added;
+};
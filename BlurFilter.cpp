@@ -0,0 +1,240 @@
+#include "BlurFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define BLUR_FILTER_SSE2 1
+#else
+#define BLUR_FILTER_SSE2 0
+#endif
+
+namespace
+{
+    const uint32_t WeightOne = 1u << BlurKernel::WeightBits;
+    const uint32_t WeightHalf = WeightOne >> 1;
+
+    // dst[x] = sum over k of weights[k] * taps[k][x], for pixelCount RGBA8
+    // pixels. Each tap points at the source pixel of its offset for x = 0.
+    void ConvolveSpan(const uint8_t* const* taps, const uint16_t* weights, uint32_t tapCount, uint8_t* dst, uint32_t pixelCount)
+    {
+        uint32_t x = 0;
+
+#if BLUR_FILTER_SSE2
+        // Four pixels per iteration: bytes are widened to 16 bits, the 16x16
+        // products are rebuilt as 32 bits from their low and high halves.
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi32(WeightHalf);
+
+        for (; x + 4 <= pixelCount; x += 4)
+        {
+            __m128i acc0 = half;
+            __m128i acc1 = half;
+            __m128i acc2 = half;
+            __m128i acc3 = half;
+
+            for (uint32_t k = 0; k < tapCount; ++k)
+            {
+                const __m128i weight = _mm_set1_epi16(static_cast<short>(weights[k]));
+                const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(taps[k] + x * 4));
+
+                const __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+                const __m128i loLow = _mm_mullo_epi16(lo, weight);
+                const __m128i loHigh = _mm_mulhi_epu16(lo, weight);
+                acc0 = _mm_add_epi32(acc0, _mm_unpacklo_epi16(loLow, loHigh));
+                acc1 = _mm_add_epi32(acc1, _mm_unpackhi_epi16(loLow, loHigh));
+
+                const __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+                const __m128i hiLow = _mm_mullo_epi16(hi, weight);
+                const __m128i hiHigh = _mm_mulhi_epu16(hi, weight);
+                acc2 = _mm_add_epi32(acc2, _mm_unpacklo_epi16(hiLow, hiHigh));
+                acc3 = _mm_add_epi32(acc3, _mm_unpackhi_epi16(hiLow, hiHigh));
+            }
+
+            acc0 = _mm_srli_epi32(acc0, BlurKernel::WeightBits);
+            acc1 = _mm_srli_epi32(acc1, BlurKernel::WeightBits);
+            acc2 = _mm_srli_epi32(acc2, BlurKernel::WeightBits);
+            acc3 = _mm_srli_epi32(acc3, BlurKernel::WeightBits);
+
+            const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(acc0, acc1), _mm_packs_epi32(acc2, acc3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), packed);
+        }
+#endif
+
+        for (; x < pixelCount; ++x)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                uint32_t sum = WeightHalf;
+                for (uint32_t k = 0; k < tapCount; ++k)
+                {
+                    sum += weights[k] * taps[k][x * 4 + c];
+                }
+                dst[x * 4 + c] = static_cast<uint8_t>(sum >> BlurKernel::WeightBits);
+            }
+        }
+    }
+
+    uint8_t ReferenceTap(const BlurKernel& kernel, const uint8_t* image, size_t pitch, uint32_t width, uint32_t height,
+        int32_t x, int32_t y, int32_t dx, int32_t dy, uint32_t channel)
+    {
+        const int32_t radius = static_cast<int32_t>(kernel.GetRadius());
+
+        uint32_t sum = WeightHalf;
+        for (int32_t k = -radius; k <= radius; ++k)
+        {
+            const int32_t sx = std::min<int32_t>(std::max<int32_t>(x + k * dx, 0), static_cast<int32_t>(width) - 1);
+            const int32_t sy = std::min<int32_t>(std::max<int32_t>(y + k * dy, 0), static_cast<int32_t>(height) - 1);
+            sum += kernel.GetWeights()[k + radius] * image[sy * pitch + sx * 4 + channel];
+        }
+        return static_cast<uint8_t>(sum >> BlurKernel::WeightBits);
+    }
+}
+
+BlurKernel::BlurKernel() :
+    m_radius(0),
+    m_weights(1, static_cast<uint16_t>(WeightOne))
+{
+}
+
+BlurKernel::BlurKernel(const std::vector<double>& weights) :
+    m_radius(static_cast<uint32_t>(weights.size() / 2)),
+    m_weights(weights.size())
+{
+    double total = 0.0;
+    for (double weight : weights)
+    {
+        total += weight;
+    }
+
+    // Rounding leaves the sum a few units off, the center weight takes the
+    // difference so that flat areas come out unchanged.
+    int32_t sum = 0;
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        m_weights[i] = static_cast<uint16_t>(std::floor(weights[i] / total * WeightOne + 0.5));
+        sum += m_weights[i];
+    }
+    m_weights[m_radius] = static_cast<uint16_t>(m_weights[m_radius] + static_cast<int32_t>(WeightOne) - sum);
+}
+
+BlurKernel BlurKernel::Box(uint32_t radius)
+{
+    if (radius > MaxRadius)
+    {
+        throw std::invalid_argument("BlurKernel: radius too large");
+    }
+
+    return BlurKernel(std::vector<double>(2 * radius + 1, 1.0));
+}
+
+BlurKernel BlurKernel::Gaussian(uint32_t radius, double sigma)
+{
+    if (radius > MaxRadius)
+    {
+        throw std::invalid_argument("BlurKernel: radius too large");
+    }
+
+    if (sigma <= 0.0)
+    {
+        sigma = std::max<double>(radius * 0.5, 0.5);
+    }
+
+    std::vector<double> weights(2 * radius + 1);
+    for (uint32_t i = 0; i < weights.size(); ++i)
+    {
+        const double offset = static_cast<double>(i) - radius;
+        weights[i] = std::exp(-offset * offset / (2.0 * sigma * sigma));
+    }
+    return BlurKernel(weights);
+}
+
+BlurFilter::BlurFilter(const BlurKernel& kernel) :
+    m_kernel(kernel)
+{
+}
+
+bool BlurFilter::HasSimd()
+{
+    return BLUR_FILTER_SSE2 != 0;
+}
+
+void BlurFilter::Apply(const uint8_t* source, size_t sourcePitch, uint8_t* destination, size_t destinationPitch, uint32_t width, uint32_t height)
+{
+    if (width == 0 || height == 0)
+    {
+        return;
+    }
+
+    const uint32_t radius = m_kernel.GetRadius();
+    const uint32_t tapCount = m_kernel.GetTapCount();
+    const size_t rowSize = static_cast<size_t>(width) * 4;
+
+    m_intermediate.resize(rowSize * height);
+    m_paddedRow.resize((static_cast<size_t>(width) + 2 * radius) * 4);
+    m_taps.resize(tapCount);
+
+    // Horizontal: each row is copied with its edge pixels repeated, then the
+    // taps are consecutive pixels of the padded row.
+    for (uint32_t k = 0; k < tapCount; ++k)
+    {
+        m_taps[k] = m_paddedRow.data() + k * 4;
+    }
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        const uint8_t* row = source + y * sourcePitch;
+        uint8_t* padded = m_paddedRow.data();
+        for (uint32_t i = 0; i < radius; ++i)
+        {
+            memcpy(padded + i * 4, row, 4);
+            memcpy(padded + (radius + width + i) * 4, row + rowSize - 4, 4);
+        }
+        memcpy(padded + radius * 4, row, rowSize);
+
+        ConvolveSpan(m_taps.data(), m_kernel.GetWeights(), tapCount, m_intermediate.data() + y * rowSize, width);
+    }
+
+    // Vertical: the taps are the clamped rows above and below.
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t k = 0; k < tapCount; ++k)
+        {
+            const int32_t sy = std::min<int32_t>(std::max<int32_t>(static_cast<int32_t>(y + k) - static_cast<int32_t>(radius), 0), static_cast<int32_t>(height) - 1);
+            m_taps[k] = m_intermediate.data() + sy * rowSize;
+        }
+
+        ConvolveSpan(m_taps.data(), m_kernel.GetWeights(), tapCount, destination + y * destinationPitch, width);
+    }
+}
+
+void BlurFilter::ApplyReference(const uint8_t* source, size_t sourcePitch, uint8_t* destination, size_t destinationPitch, uint32_t width, uint32_t height) const
+{
+    const size_t rowSize = static_cast<size_t>(width) * 4;
+    std::vector<uint8_t> intermediate(rowSize * height);
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                intermediate[y * rowSize + x * 4 + c] = ReferenceTap(m_kernel, source, sourcePitch, width, height, x, y, 1, 0, c);
+            }
+        }
+    }
+
+    for (uint32_t y = 0; y < height; ++y)
+    {
+        for (uint32_t x = 0; x < width; ++x)
+        {
+            for (uint32_t c = 0; c < 4; ++c)
+            {
+                destination[y * destinationPitch + x * 4 + c] = ReferenceTap(m_kernel, intermediate.data(), rowSize, width, height, x, y, 0, 1, c);
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Weights of a separable blur, in 1.15 fixed point summing to exactly 32768.
+// Integer weights and a rounding to 8 bits after each pass make the filter
+// exact, so the CPU implementation and blur.hlsl produce the same bytes.
+class BlurKernel
+{
+public:
+    static const uint32_t MaxRadius = 32;
+    static const uint32_t MaxTapCount = 2 * MaxRadius + 1;
+    static const uint32_t WeightBits = 15;
+
+    BlurKernel();
+
+    static BlurKernel Box(uint32_t radius);
+
+    // A sigma of 0 picks radius / 2.
+    static BlurKernel Gaussian(uint32_t radius, double sigma = 0.0);
+
+    uint32_t GetRadius() const                  { return m_radius; }
+    uint32_t GetTapCount() const                { return 2 * m_radius + 1; }
+    const uint16_t* GetWeights() const          { return m_weights.data(); }
+
+private:
+    explicit BlurKernel(const std::vector<double>& weights);
+
+    uint32_t m_radius;
+    std::vector<uint16_t> m_weights;
+};
+
+// Two-pass blur of RGBA8 images, horizontal then vertical, edges clamped.
+// Apply uses SSE2 when available, ApplyReference is the plain definition both
+// Apply and the compute shader have to match.
+class BlurFilter
+{
+public:
+    explicit BlurFilter(const BlurKernel& kernel);
+
+    void SetKernel(const BlurKernel& kernel)    { m_kernel = kernel; }
+    const BlurKernel& GetKernel() const         { return m_kernel; }
+
+    // Pitches are in bytes. source and destination may be the same image.
+    void Apply(const uint8_t* source, size_t sourcePitch, uint8_t* destination, size_t destinationPitch, uint32_t width, uint32_t height);
+    void ApplyReference(const uint8_t* source, size_t sourcePitch, uint8_t* destination, size_t destinationPitch, uint32_t width, uint32_t height) const;
+
+    static bool HasSimd();
+
+private:
+    BlurKernel m_kernel;
+    std::vector<uint8_t> m_intermediate;        // Result of the horizontal pass.
+    std::vector<uint8_t> m_paddedRow;           // Source row extended by the radius on both sides.
+    std::vector<const uint8_t*> m_taps;
+};
@@ -0,0 +1,176 @@
+#include "BufferUploader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+BufferUploader::BufferUploader(IUploadBackend& backend, IFrameQueue& queue, uint8_t* staging, uint64_t stagingSize, uint64_t maxChunkSize) :
+    m_backend(backend),
+    m_queue(queue),
+    m_staging(staging),
+    m_ring(stagingSize),
+    m_maxChunkSize(maxChunkSize ? maxChunkSize : stagingSize / 4),
+    m_nextFenceValue(1),
+    m_pendingCopies(0),
+    m_stats()
+{
+    if (!staging || m_maxChunkSize == 0 || m_maxChunkSize > stagingSize)
+    {
+        throw std::invalid_argument("BufferUploader");
+    }
+
+    // The queue may already have been used, like in FrameScheduler.
+    m_nextFenceValue = std::max<uint64_t>(m_queue.GetCompletedValue() + 1, 1);
+}
+
+uint64_t BufferUploader::AllocateStaging(uint64_t size, uint64_t alignment)
+{
+    m_ring.ReleaseCompleted(m_queue.GetCompletedValue());
+
+    uint64_t offset = m_ring.Allocate(size, alignment);
+    if (offset != UploadRing::InvalidOffset)
+    {
+        return offset;
+    }
+
+    // The pending batch holds part of the ring, submit it so that its space
+    // comes back as well, then wait for the oldest batch.
+    Flush();
+    m_stats.stagingWaits++;
+    return m_ring.AllocateBlocking(size, alignment, m_queue);
+}
+
+uint64_t BufferUploader::Upload(void* destination, uint64_t destinationOffset, const void* data, uint64_t size)
+{
+    const uint8_t* source = static_cast<const uint8_t*>(data);
+
+    for (uint64_t copied = 0; copied < size;)
+    {
+        const uint64_t chunk = std::min<uint64_t>(size - copied, m_maxChunkSize);
+        const uint64_t offset = AllocateStaging(chunk);
+
+        memcpy(m_staging + offset, source + copied, static_cast<size_t>(chunk));
+        m_backend.CopyBuffer(destination, destinationOffset + copied, offset, chunk);
+
+        m_pendingCopies++;
+        m_stats.copies++;
+        copied += chunk;
+    }
+
+    m_stats.uploads++;
+    m_stats.bytes += size;
+    return m_nextFenceValue;
+}
+
+uint64_t BufferUploader::UploadTexture(void* destination, uint32_t subresource, const TextureFootprint& footprint,
+    const void* data, uint64_t sourceRowPitch, uint64_t sourceSlicePitch)
+{
+    if (footprint.rowPitch == 0 || footprint.rowPitch > m_maxChunkSize || footprint.rowSize > sourceRowPitch)
+    {
+        throw std::invalid_argument("BufferUploader::UploadTexture");
+    }
+
+    // Bands of whole rows within a depth slice, the block height converts rows to texels.
+    const uint32_t blockSize = footprint.rowCount ? footprint.height / footprint.rowCount : 1;
+    const uint32_t bandRows = static_cast<uint32_t>(std::min<uint64_t>(m_maxChunkSize / footprint.rowPitch, footprint.rowCount));
+
+    for (uint32_t slice = 0; slice < footprint.depth; ++slice)
+    {
+        const uint8_t* source = static_cast<const uint8_t*>(data) + slice * sourceSlicePitch;
+        for (uint32_t firstRow = 0; firstRow < footprint.rowCount; firstRow += bandRows)
+        {
+            TextureFootprint band = footprint;
+            band.rowCount = std::min<uint32_t>(bandRows, footprint.rowCount - firstRow);
+            band.height = band.rowCount * blockSize;
+            band.depth = 1;
+
+            const uint64_t size = static_cast<uint64_t>(band.rowPitch) * (band.rowCount - 1) + band.rowSize;
+            band.offset = AllocateStaging(size, TexturePlacementAlignment);
+            for (uint32_t row = 0; row < band.rowCount; ++row)
+            {
+                memcpy(m_staging + band.offset + static_cast<uint64_t>(row) * band.rowPitch,
+                    source + (firstRow + row) * sourceRowPitch, static_cast<size_t>(band.rowSize));
+            }
+            m_backend.CopyTexture(destination, subresource, firstRow, slice, band);
+
+            m_pendingCopies++;
+            m_stats.copies++;
+        }
+    }
+
+    m_stats.uploads++;
+    m_stats.bytes += footprint.rowSize * footprint.rowCount * footprint.depth;
+    return m_nextFenceValue;
+}
+
+uint64_t BufferUploader::Flush()
+{
+    if (m_pendingCopies == 0)
+    {
+        return m_nextFenceValue - 1;
+    }
+
+    const uint64_t fenceValue = m_nextFenceValue++;
+    m_backend.Submit(fenceValue);
+    m_queue.Signal(fenceValue);
+    m_ring.FinishFrame(fenceValue);
+
+    m_pendingCopies = 0;
+    m_stats.submissions++;
+    return fenceValue;
+}
+
+void BufferUploader::WaitForIdle()
+{
+    const uint64_t fenceValue = Flush();
+    if (m_queue.GetCompletedValue() < fenceValue)
+    {
+        m_queue.WaitForValue(fenceValue);
+    }
+    m_ring.ReleaseCompleted(m_queue.GetCompletedValue());
+}
+
+RecordingUploadBackend::RecordingUploadBackend(const uint8_t* staging) :
+    m_staging(staging),
+    m_submits(0),
+    m_largestBatch(0)
+{
+}
+
+void RecordingUploadBackend::CopyBuffer(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size)
+{
+    Copy copy = { static_cast<uint8_t*>(destination) + destinationOffset, stagingOffset, size };
+    m_copies.push_back(copy);
+}
+
+void RecordingUploadBackend::CopyTexture(void* destination, uint32_t subresource, uint32_t firstRow, uint32_t slice, const TextureFootprint& footprint)
+{
+    RecordingTexture& texture = *static_cast<RecordingTexture*>(destination);
+    const TextureFootprint& layout = texture.footprints[subresource];
+
+    for (uint32_t row = 0; row < footprint.rowCount; ++row)
+    {
+        const uint64_t destinationRow = static_cast<uint64_t>(slice) * layout.rowCount + firstRow + row;
+        Copy copy =
+        {
+            texture.data.data() + layout.offset + destinationRow * layout.rowPitch,
+            footprint.offset + static_cast<uint64_t>(row) * footprint.rowPitch,
+            footprint.rowSize
+        };
+        m_copies.push_back(copy);
+    }
+}
+
+void RecordingUploadBackend::Submit(uint64_t /*fenceValue*/)
+{
+    // The staging space of a batch is only reused after its fence, copying
+    // here reads the same bytes the GPU would.
+    for (const Copy& copy : m_copies)
+    {
+        memcpy(copy.destination, m_staging + copy.stagingOffset, static_cast<size_t>(copy.size));
+    }
+
+    m_largestBatch = std::max<uint64_t>(m_largestBatch, m_copies.size());
+    m_copies.clear();
+    m_submits++;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "FrameScheduler.h"
+#include "TextureLayout.h"
+#include "UploadRing.h"
+
+#include <cstdint>
+#include <vector>
+
+// Copy commands of an upload queue. Destinations are opaque here, the D3D12
+// backend gets ID3D12Resource pointers.
+class IUploadBackend
+{
+public:
+    virtual ~IUploadBackend() {}
+
+    // Record a copy of size bytes from the staging memory into destination.
+    virtual void CopyBuffer(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size) = 0;
+
+    // Record a copy of rows laid out as footprint in the staging memory into
+    // a subresource of a texture, from the row of blocks firstRow of the
+    // depth slice. The footprint offset is the staging offset.
+    virtual void CopyTexture(void* destination, uint32_t subresource, uint32_t firstRow, uint32_t slice, const TextureFootprint& footprint) = 0;
+
+    // Submit every copy recorded since the last call. The uploader signals
+    // fenceValue on the queue right after.
+    virtual void Submit(uint64_t fenceValue) = 0;
+};
+
+struct BufferUploaderStats
+{
+    uint64_t uploads;
+    uint64_t copies;                // Uploads are split into chunks of at most maxChunkSize.
+    uint64_t bytes;
+    uint64_t submissions;
+    uint64_t stagingWaits;          // Times the staging ring was full of batches in flight.
+};
+
+// Batches uploads to GPU-only memory through a staging ring. Data is copied
+// into the ring and a copy recorded for it; Flush submits everything recorded
+// so far as one batch and tags its staging space with a fence value of the
+// upload queue, the space is reused once the queue has reached it. Uploads
+// larger than maxChunkSize are split, so any size fits in a ring of a few
+// chunks.
+//
+// Only the upload queue is ever waited on, and only when the ring is full.
+// Consumers wait for the returned fence value on the GPU.
+class BufferUploader
+{
+public:
+    // maxChunkSize defaults to a quarter of the ring.
+    BufferUploader(IUploadBackend& backend, IFrameQueue& queue, uint8_t* staging, uint64_t stagingSize, uint64_t maxChunkSize = 0);
+
+    // Returns the fence value signalled once the data is in place, after the
+    // next Flush.
+    uint64_t Upload(void* destination, uint64_t destinationOffset, const void* data, uint64_t size);
+
+    // Upload a subresource whose rows of blocks are sourceRowPitch bytes apart
+    // in data and its depth slices sourceSlicePitch. footprint is its layout,
+    // see GetCopyableFootprints, the offset is ignored. The rows are staged
+    // with the pitch and placement alignments of texture copies; subresources
+    // larger than maxChunkSize go in bands of rows.
+    uint64_t UploadTexture(void* destination, uint32_t subresource, const TextureFootprint& footprint,
+        const void* data, uint64_t sourceRowPitch, uint64_t sourceSlicePitch);
+
+    // Submit the pending batch. Returns the fence value of the last batch.
+    uint64_t Flush();
+
+    bool IsComplete(uint64_t fenceValue)    { return m_queue.GetCompletedValue() >= fenceValue; }
+
+    // Block until every submitted batch has completed.
+    void WaitForIdle();
+
+    uint64_t GetPendingCopyCount() const    { return m_pendingCopies; }
+    BufferUploaderStats GetStats() const    { return m_stats; }
+
+private:
+    static const uint64_t StagingAlignment = 16;
+
+    uint64_t AllocateStaging(uint64_t size, uint64_t alignment = StagingAlignment);
+
+    IUploadBackend& m_backend;
+    IFrameQueue& m_queue;
+    uint8_t* m_staging;
+    UploadRing m_ring;
+    uint64_t m_maxChunkSize;
+    uint64_t m_nextFenceValue;
+    uint64_t m_pendingCopies;
+    BufferUploaderStats m_stats;
+};
+
+// Texture in CPU memory for RecordingUploadBackend, its subresources laid out
+// one after the other as footprints says.
+struct RecordingTexture
+{
+    std::vector<TextureFootprint> footprints;
+    std::vector<uint8_t> data;
+};
+
+// Stand-in for a copy queue. Destinations are CPU memory, RecordingTexture
+// for texture copies, and the recorded copies are carried out when they are
+// submitted, so the batching can be checked and timed without a GPU.
+class RecordingUploadBackend : public IUploadBackend
+{
+public:
+    explicit RecordingUploadBackend(const uint8_t* staging);
+
+    virtual void CopyBuffer(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size);
+    virtual void CopyTexture(void* destination, uint32_t subresource, uint32_t firstRow, uint32_t slice, const TextureFootprint& footprint);
+    virtual void Submit(uint64_t fenceValue);
+
+    uint64_t GetSubmitCount() const         { return m_submits; }
+    uint64_t GetLargestBatch() const        { return m_largestBatch; }
+
+private:
+    // Texture copies are split into one copy per row.
+    struct Copy
+    {
+        uint8_t* destination;
+        uint64_t stagingOffset;
+        uint64_t size;
+    };
+
+    const uint8_t* m_staging;
+    std::vector<Copy> m_copies;
+    uint64_t m_submits;
+    uint64_t m_largestBatch;
+};
@@ -0,0 +1,125 @@
+#include "CommandRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+ParallelCommandRecorder::ParallelCommandRecorder(JobSystem& jobs, ICommandListBackend& backend) :
+    m_jobs(jobs),
+    m_backend(backend)
+{
+    ResetStats();
+}
+
+uint32_t ParallelCommandRecorder::Record(uint32_t taskCount, const RecordTask& record)
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+
+    // One list per thread at most, each list still costs a reset and a close.
+    uint32_t listCount = std::min<uint32_t>(taskCount, std::min<uint32_t>(m_jobs.GetThreadCount(), m_backend.GetMaxListCount()));
+    listCount = std::max<uint32_t>(listCount, 1);
+
+    m_jobs.ParallelFor(listCount, [&](uint32_t list, uint32_t /*thread*/)
+    {
+        const uint32_t first = static_cast<uint32_t>(static_cast<uint64_t>(taskCount) * list / listCount);
+        const uint32_t end = static_cast<uint32_t>(static_cast<uint64_t>(taskCount) * (list + 1) / listCount);
+
+        m_backend.BeginList(list);
+        for (uint32_t task = first; task < end; ++task)
+        {
+            record(task, list);
+        }
+        m_backend.EndList(list);
+    });
+
+    m_backend.Submit(listCount);
+
+    const double recordMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    m_stats.frames++;
+    m_stats.tasks += taskCount;
+    m_stats.lists += listCount;
+    m_stats.totalRecordMs += recordMs;
+    m_stats.lastRecordMs = recordMs;
+
+    return listCount;
+}
+
+void ParallelCommandRecorder::ResetStats()
+{
+    m_stats = CommandRecorderStats();
+}
+
+RecordingCommandListBackend::RecordingCommandListBackend(uint32_t maxListCount, uint32_t wordsPerCommand) :
+    m_wordsPerCommand(wordsPerCommand),
+    m_lists(maxListCount),
+    m_submits(0),
+    m_submittedCommands(0),
+    m_submittedHash(0)
+{
+    for (List& list : m_lists)
+    {
+        list.commands = 0;
+        list.open = false;
+    }
+}
+
+void RecordingCommandListBackend::BeginList(uint32_t list)
+{
+    List& l = m_lists.at(list);
+    if (l.open)
+    {
+        throw std::logic_error("RecordingCommandListBackend: list already open");
+    }
+
+    l.data.clear();
+    l.commands = 0;
+    l.open = true;
+}
+
+void RecordingCommandListBackend::EndList(uint32_t list)
+{
+    m_lists.at(list).open = false;
+}
+
+void RecordingCommandListBackend::RecordCommand(uint32_t list, uint64_t payload)
+{
+    List& l = m_lists[list];
+
+    // Mix the payload into every word, like a driver translating state into
+    // hardware packets.
+    uint64_t word = payload;
+    for (uint32_t i = 0; i < m_wordsPerCommand; ++i)
+    {
+        word += 0x9e3779b97f4a7c15ull;
+        uint64_t z = word;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        l.data.push_back(z ^ (z >> 31));
+    }
+    l.commands++;
+}
+
+void RecordingCommandListBackend::Submit(uint32_t listCount)
+{
+    // Word-wise FNV, cheap enough not to dominate the serial part of a frame.
+    uint64_t hash = m_submittedHash ^ 14695981039346656037ull;
+
+    for (uint32_t list = 0; list < listCount; ++list)
+    {
+        const List& l = m_lists.at(list);
+        if (l.open)
+        {
+            throw std::logic_error("RecordingCommandListBackend: submitting an open list");
+        }
+
+        for (uint64_t word : l.data)
+        {
+            hash = (hash ^ word) * 1099511628211ull;
+        }
+        m_submittedCommands += l.commands;
+    }
+
+    m_submittedHash = hash;
+    m_submits++;
+}
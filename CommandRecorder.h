@@ -0,0 +1,95 @@
+#pragma once
+
+#include "JobSystem.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Command lists a ParallelCommandRecorder records into. Each list has its own
+// allocator per frame in flight and is only ever recorded by one thread at a
+// time, so the lists need no locking.
+class ICommandListBackend
+{
+public:
+    virtual ~ICommandListBackend() {}
+
+    virtual uint32_t GetMaxListCount() const = 0;
+
+    // Reset the list for the current frame, on the thread that records it.
+    virtual void BeginList(uint32_t list) = 0;
+    virtual void EndList(uint32_t list) = 0;
+
+    // Submit lists [0, listCount) in order, in a single call.
+    virtual void Submit(uint32_t listCount) = 0;
+};
+
+struct CommandRecorderStats
+{
+    uint64_t frames;
+    uint64_t tasks;
+    uint64_t lists;
+    double   totalRecordMs;     // Wall time from the first BeginList to Submit.
+    double   lastRecordMs;
+};
+
+// Records an ordered sequence of tasks (passes, draw batches) on a job system.
+// The tasks are cut into contiguous runs, one list per run, so submitting the
+// lists in order keeps the original order of the commands.
+class ParallelCommandRecorder
+{
+public:
+    typedef std::function<void(uint32_t task, uint32_t list)> RecordTask;
+
+    ParallelCommandRecorder(JobSystem& jobs, ICommandListBackend& backend);
+
+    // Record tasks [0, taskCount) and submit them. Returns the number of lists used.
+    uint32_t Record(uint32_t taskCount, const RecordTask& record);
+
+    CommandRecorderStats GetStats() const { return m_stats; }
+    void ResetStats();
+
+private:
+    JobSystem& m_jobs;
+    ICommandListBackend& m_backend;
+    CommandRecorderStats m_stats;
+};
+
+// Stand-in for GPU command lists. Commands are encoded into plain memory at
+// roughly the cost of a driver writing them, so recording can be timed and
+// scaled across cores without a GPU.
+class RecordingCommandListBackend : public ICommandListBackend
+{
+public:
+    explicit RecordingCommandListBackend(uint32_t maxListCount, uint32_t wordsPerCommand = 16);
+
+    virtual uint32_t GetMaxListCount() const { return static_cast<uint32_t>(m_lists.size()); }
+    virtual void BeginList(uint32_t list);
+    virtual void EndList(uint32_t list);
+    virtual void Submit(uint32_t listCount);
+
+    void RecordCommand(uint32_t list, uint64_t payload);
+
+    const std::vector<uint64_t>& GetListData(uint32_t list) const { return m_lists.at(list).data; }
+    uint64_t GetSubmitCount() const             { return m_submits; }
+    uint64_t GetSubmittedCommandCount() const   { return m_submittedCommands; }
+
+    // Hash of every submitted command in submission order, equal for any
+    // thread count when recording is deterministic.
+    uint64_t GetSubmittedHash() const           { return m_submittedHash; }
+
+private:
+    struct List
+    {
+        std::vector<uint64_t> data;
+        uint64_t commands;
+        bool open;
+        char padding[64];           // Keep lists recorded on different threads off the same cache line.
+    };
+
+    uint32_t m_wordsPerCommand;
+    std::vector<List> m_lists;
+    uint64_t m_submits;
+    uint64_t m_submittedCommands;
+    uint64_t m_submittedHash;
+};
@@ -0,0 +1,928 @@
+#include "CommandStream.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    const uint32_t CaptureMagic = 0x43444d43; // "CMDC"
+    const uint32_t CaptureVersion = 1;
+
+    struct CaptureHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t frameCount;
+        uint32_t reserved;
+    };
+
+    enum CommandOp
+    {
+        OpSetPipelineState = 1,
+        OpSetRootSignature,
+        OpSetDescriptorHeaps,
+        OpSetRootDescriptorTable,
+        OpSetRootView,
+        OpSetRoot32BitConstants,
+        OpResourceBarriers,
+        OpDiscardResource,
+        OpSetRenderTargets,
+        OpClearRenderTarget,
+        OpSetViewports,
+        OpSetScissorRects,
+        OpSetPrimitiveTopology,
+        OpSetVertexBuffers,
+        OpDraw,
+        OpExecuteIndirect,
+        OpDispatch
+    };
+
+    // Set in the opcode byte of the compute variants.
+    const uint8_t OpComputeFlag = 0x80;
+
+    uint64_t ZigZag(int32_t value)
+    {
+        return static_cast<uint32_t>((static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31));
+    }
+
+    int32_t UnZigZag(uint32_t value)
+    {
+        return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1)));
+    }
+
+    // Decoding side of CommandStreamWriter. Every read checks the end of the
+    // stream, the first failure sticks.
+    class StreamReader
+    {
+    public:
+        StreamReader(const uint8_t* data, size_t size) :
+            m_position(data),
+            m_end(data + size),
+            m_ok(true)
+        {
+        }
+
+        bool IsOk() const           { return m_ok; }
+        bool AtEnd() const          { return m_position == m_end; }
+        size_t GetRemaining() const { return static_cast<size_t>(m_end - m_position); }
+
+        uint8_t ReadByte()
+        {
+            if (m_position == m_end)
+            {
+                m_ok = false;
+                return 0;
+            }
+            return *m_position++;
+        }
+
+        uint64_t ReadVarint()
+        {
+            uint64_t value = 0;
+            for (uint32_t shift = 0; shift < 64; shift += 7)
+            {
+                const uint8_t byte = ReadByte();
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+            m_ok = false;
+            return 0;
+        }
+
+        uint32_t ReadUint32()
+        {
+            const uint64_t value = ReadVarint();
+            if (value > UINT32_MAX)
+            {
+                m_ok = false;
+                return 0;
+            }
+            return static_cast<uint32_t>(value);
+        }
+
+        // Element counts: every element takes a byte at least.
+        uint32_t ReadCount()
+        {
+            const uint32_t count = ReadUint32();
+            if (count > GetRemaining())
+            {
+                m_ok = false;
+                return 0;
+            }
+            return count;
+        }
+
+        float ReadFloat()
+        {
+            float value = 0.0f;
+            if (GetRemaining() < sizeof(value))
+            {
+                m_ok = false;
+                return value;
+            }
+            memcpy(&value, m_position, sizeof(value));
+            m_position += sizeof(value);
+            return value;
+        }
+
+        CommandHandle ReadObject()
+        {
+            const uint64_t index = ReadVarint();
+            if (index == m_objects.size())
+            {
+                m_objects.push_back(ReadVarint());
+            }
+            if (index >= m_objects.size())
+            {
+                m_ok = false;
+                return 0;
+            }
+            return m_objects[static_cast<size_t>(index)];
+        }
+
+        CommandRect ReadRect()
+        {
+            CommandRect rect;
+            rect.left = UnZigZag(ReadUint32());
+            rect.top = UnZigZag(ReadUint32());
+            rect.right = UnZigZag(ReadUint32());
+            rect.bottom = UnZigZag(ReadUint32());
+            return rect;
+        }
+
+    private:
+        const uint8_t* m_position;
+        const uint8_t* m_end;
+        bool m_ok;
+        std::vector<CommandHandle> m_objects;
+    };
+
+    void AppendBytes(std::vector<uint8_t>& file, const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        file.insert(file.end(), bytes, bytes + size);
+    }
+
+    bool ReadBytes(const std::vector<uint8_t>& file, size_t& offset, void* data, size_t size)
+    {
+        if (file.size() - offset < size)
+        {
+            return false;
+        }
+        memcpy(data, file.data() + offset, size);
+        offset += size;
+        return true;
+    }
+}
+
+CommandStreamWriter::CommandStreamWriter() :
+    m_commandCount(0)
+{
+}
+
+void CommandStreamWriter::Reset()
+{
+    m_data.clear();
+    m_objects.clear();
+    m_commandCount = 0;
+}
+
+void CommandStreamWriter::WriteOp(uint32_t op, bool compute)
+{
+    m_data.push_back(static_cast<uint8_t>(op | (compute ? OpComputeFlag : 0)));
+    m_commandCount++;
+}
+
+void CommandStreamWriter::WriteVarint(uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        m_data.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    m_data.push_back(static_cast<uint8_t>(value));
+}
+
+void CommandStreamWriter::WriteFloat(float value)
+{
+    uint8_t bytes[sizeof(value)];
+    memcpy(bytes, &value, sizeof(value));
+    m_data.insert(m_data.end(), bytes, bytes + sizeof(bytes));
+}
+
+void CommandStreamWriter::WriteObject(CommandHandle object)
+{
+    // A list binds a handful of objects, a linear search beats hashing them.
+    const auto found = std::find(m_objects.begin(), m_objects.end(), object);
+    WriteVarint(static_cast<uint64_t>(found - m_objects.begin()));
+    if (found == m_objects.end())
+    {
+        WriteVarint(object);
+        m_objects.push_back(object);
+    }
+}
+
+void CommandStreamWriter::WriteRect(const CommandRect& rect)
+{
+    WriteVarint(ZigZag(rect.left));
+    WriteVarint(ZigZag(rect.top));
+    WriteVarint(ZigZag(rect.right));
+    WriteVarint(ZigZag(rect.bottom));
+}
+
+void CommandStreamWriter::SetPipelineState(CommandHandle pipelineState)
+{
+    WriteOp(OpSetPipelineState, false);
+    WriteObject(pipelineState);
+}
+
+void CommandStreamWriter::SetRootSignature(bool compute, CommandHandle rootSignature)
+{
+    WriteOp(OpSetRootSignature, compute);
+    WriteObject(rootSignature);
+}
+
+void CommandStreamWriter::SetDescriptorHeaps(uint32_t count, const CommandHandle* heaps)
+{
+    WriteOp(OpSetDescriptorHeaps, false);
+    WriteVarint(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        WriteObject(heaps[i]);
+    }
+}
+
+void CommandStreamWriter::SetRootDescriptorTable(bool compute, uint32_t index, CommandHandle baseDescriptor)
+{
+    WriteOp(OpSetRootDescriptorTable, compute);
+    WriteVarint(index);
+    WriteVarint(baseDescriptor);
+}
+
+void CommandStreamWriter::SetRootView(bool compute, CommandRootView view, uint32_t index, CommandHandle address)
+{
+    WriteOp(OpSetRootView, compute);
+    WriteVarint(view);
+    WriteVarint(index);
+    WriteVarint(address);
+}
+
+void CommandStreamWriter::SetRoot32BitConstants(bool compute, uint32_t index, uint32_t count, const uint32_t* values, uint32_t offset)
+{
+    WriteOp(OpSetRoot32BitConstants, compute);
+    WriteVarint(index);
+    WriteVarint(offset);
+    WriteVarint(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        WriteVarint(values[i]);
+    }
+}
+
+void CommandStreamWriter::ResourceBarriers(uint32_t count, const CommandBarrier* barriers)
+{
+    WriteOp(OpResourceBarriers, false);
+    WriteVarint(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const CommandBarrier& barrier = barriers[i];
+        WriteVarint(barrier.type);
+        WriteVarint(barrier.flags);
+        WriteObject(barrier.resource);
+        if (barrier.type == CommandBarrierAliasing)
+        {
+            WriteObject(barrier.resourceBefore);
+        }
+        else if (barrier.type == CommandBarrierTransition)
+        {
+            WriteVarint(barrier.subresource);
+            WriteVarint(barrier.stateBefore);
+            WriteVarint(barrier.stateAfter);
+        }
+    }
+}
+
+void CommandStreamWriter::DiscardResource(CommandHandle resource)
+{
+    WriteOp(OpDiscardResource, false);
+    WriteObject(resource);
+}
+
+void CommandStreamWriter::SetRenderTargets(uint32_t count, const CommandHandle* renderTargets, CommandHandle depthStencil)
+{
+    WriteOp(OpSetRenderTargets, false);
+    WriteVarint(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        WriteVarint(renderTargets[i]);
+    }
+    WriteVarint(depthStencil);
+}
+
+void CommandStreamWriter::ClearRenderTarget(CommandHandle renderTarget, const float color[4], uint32_t rectCount, const CommandRect* rects)
+{
+    WriteOp(OpClearRenderTarget, false);
+    WriteVarint(renderTarget);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        WriteFloat(color[i]);
+    }
+    WriteVarint(rectCount);
+    for (uint32_t i = 0; i < rectCount; ++i)
+    {
+        WriteRect(rects[i]);
+    }
+}
+
+void CommandStreamWriter::SetViewports(uint32_t count, const CommandViewport* viewports)
+{
+    WriteOp(OpSetViewports, false);
+    WriteVarint(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        WriteFloat(viewports[i].x);
+        WriteFloat(viewports[i].y);
+        WriteFloat(viewports[i].width);
+        WriteFloat(viewports[i].height);
+        WriteFloat(viewports[i].minDepth);
+        WriteFloat(viewports[i].maxDepth);
+    }
+}
+
+void CommandStreamWriter::SetScissorRects(uint32_t count, const CommandRect* rects)
+{
+    WriteOp(OpSetScissorRects, false);
+    WriteVarint(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        WriteRect(rects[i]);
+    }
+}
+
+void CommandStreamWriter::SetPrimitiveTopology(uint32_t topology)
+{
+    WriteOp(OpSetPrimitiveTopology, false);
+    WriteVarint(topology);
+}
+
+void CommandStreamWriter::SetVertexBuffers(uint32_t startSlot, uint32_t count, const CommandVertexBufferView* views)
+{
+    WriteOp(OpSetVertexBuffers, false);
+    WriteVarint(startSlot);
+    WriteVarint(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        WriteVarint(views[i].address);
+        WriteVarint(views[i].size);
+        WriteVarint(views[i].stride);
+    }
+}
+
+void CommandStreamWriter::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance)
+{
+    WriteOp(OpDraw, false);
+    WriteVarint(vertexCount);
+    WriteVarint(instanceCount);
+    WriteVarint(startVertex);
+    WriteVarint(startInstance);
+}
+
+void CommandStreamWriter::ExecuteIndirect(CommandHandle commandSignature, uint32_t maxCommandCount, CommandHandle argumentBuffer,
+    uint64_t argumentOffset, CommandHandle countBuffer, uint64_t countOffset)
+{
+    WriteOp(OpExecuteIndirect, false);
+    WriteObject(commandSignature);
+    WriteVarint(maxCommandCount);
+    WriteObject(argumentBuffer);
+    WriteVarint(argumentOffset);
+    WriteObject(countBuffer);
+    WriteVarint(countOffset);
+}
+
+void CommandStreamWriter::Dispatch(uint32_t x, uint32_t y, uint32_t z)
+{
+    WriteOp(OpDispatch, true);
+    WriteVarint(x);
+    WriteVarint(y);
+    WriteVarint(z);
+}
+
+bool ReplayCommandStream(const uint8_t* data, size_t size, ICommandStreamSink& sink)
+{
+    StreamReader reader(data, size);
+
+    // Scratch arrays, reused across commands.
+    std::vector<CommandHandle> handles;
+    std::vector<uint32_t> values;
+    std::vector<CommandBarrier> barriers;
+    std::vector<CommandRect> rects;
+    std::vector<CommandViewport> viewports;
+    std::vector<CommandVertexBufferView> views;
+
+    while (!reader.AtEnd())
+    {
+        const uint8_t opByte = reader.ReadByte();
+        const bool compute = (opByte & OpComputeFlag) != 0;
+        const uint32_t op = opByte & ~OpComputeFlag;
+
+        // Each case reads its arguments, and calls the sink if they were all there.
+        switch (op)
+        {
+        case OpSetPipelineState:
+        {
+            const CommandHandle pipelineState = reader.ReadObject();
+            if (reader.IsOk())
+            {
+                sink.SetPipelineState(pipelineState);
+            }
+            break;
+        }
+
+        case OpSetRootSignature:
+        {
+            const CommandHandle rootSignature = reader.ReadObject();
+            if (reader.IsOk())
+            {
+                sink.SetRootSignature(compute, rootSignature);
+            }
+            break;
+        }
+
+        case OpSetDescriptorHeaps:
+        {
+            handles.resize(reader.ReadCount());
+            for (CommandHandle& heap : handles)
+            {
+                heap = reader.ReadObject();
+            }
+            if (reader.IsOk())
+            {
+                sink.SetDescriptorHeaps(static_cast<uint32_t>(handles.size()), handles.data());
+            }
+            break;
+        }
+
+        case OpSetRootDescriptorTable:
+        {
+            const uint32_t index = reader.ReadUint32();
+            const CommandHandle baseDescriptor = reader.ReadVarint();
+            if (reader.IsOk())
+            {
+                sink.SetRootDescriptorTable(compute, index, baseDescriptor);
+            }
+            break;
+        }
+
+        case OpSetRootView:
+        {
+            const uint32_t view = reader.ReadUint32();
+            const uint32_t index = reader.ReadUint32();
+            const CommandHandle address = reader.ReadVarint();
+            if (reader.IsOk() && view <= CommandRootViewUav)
+            {
+                sink.SetRootView(compute, static_cast<CommandRootView>(view), index, address);
+            }
+            else
+            {
+                return false;
+            }
+            break;
+        }
+
+        case OpSetRoot32BitConstants:
+        {
+            const uint32_t index = reader.ReadUint32();
+            const uint32_t offset = reader.ReadUint32();
+            values.resize(reader.ReadCount());
+            for (uint32_t& value : values)
+            {
+                value = reader.ReadUint32();
+            }
+            if (reader.IsOk())
+            {
+                sink.SetRoot32BitConstants(compute, index, static_cast<uint32_t>(values.size()), values.data(), offset);
+            }
+            break;
+        }
+
+        case OpResourceBarriers:
+        {
+            barriers.resize(reader.ReadCount());
+            for (CommandBarrier& barrier : barriers)
+            {
+                barrier = CommandBarrier();
+                barrier.type = reader.ReadUint32();
+                barrier.flags = reader.ReadUint32();
+                barrier.resource = reader.ReadObject();
+                if (barrier.type == CommandBarrierAliasing)
+                {
+                    barrier.resourceBefore = reader.ReadObject();
+                }
+                else if (barrier.type == CommandBarrierTransition)
+                {
+                    barrier.subresource = reader.ReadUint32();
+                    barrier.stateBefore = reader.ReadUint32();
+                    barrier.stateAfter = reader.ReadUint32();
+                }
+                else if (barrier.type != CommandBarrierUav)
+                {
+                    return false;
+                }
+            }
+            if (reader.IsOk())
+            {
+                sink.ResourceBarriers(static_cast<uint32_t>(barriers.size()), barriers.data());
+            }
+            break;
+        }
+
+        case OpDiscardResource:
+        {
+            const CommandHandle resource = reader.ReadObject();
+            if (reader.IsOk())
+            {
+                sink.DiscardResource(resource);
+            }
+            break;
+        }
+
+        case OpSetRenderTargets:
+        {
+            handles.resize(reader.ReadCount());
+            for (CommandHandle& renderTarget : handles)
+            {
+                renderTarget = reader.ReadVarint();
+            }
+            const CommandHandle depthStencil = reader.ReadVarint();
+            if (reader.IsOk())
+            {
+                sink.SetRenderTargets(static_cast<uint32_t>(handles.size()), handles.data(), depthStencil);
+            }
+            break;
+        }
+
+        case OpClearRenderTarget:
+        {
+            const CommandHandle renderTarget = reader.ReadVarint();
+            float color[4];
+            for (float& channel : color)
+            {
+                channel = reader.ReadFloat();
+            }
+            rects.resize(reader.ReadCount());
+            for (CommandRect& rect : rects)
+            {
+                rect = reader.ReadRect();
+            }
+            if (reader.IsOk())
+            {
+                sink.ClearRenderTarget(renderTarget, color, static_cast<uint32_t>(rects.size()), rects.data());
+            }
+            break;
+        }
+
+        case OpSetViewports:
+        {
+            viewports.resize(reader.ReadCount());
+            for (CommandViewport& viewport : viewports)
+            {
+                viewport.x = reader.ReadFloat();
+                viewport.y = reader.ReadFloat();
+                viewport.width = reader.ReadFloat();
+                viewport.height = reader.ReadFloat();
+                viewport.minDepth = reader.ReadFloat();
+                viewport.maxDepth = reader.ReadFloat();
+            }
+            if (reader.IsOk())
+            {
+                sink.SetViewports(static_cast<uint32_t>(viewports.size()), viewports.data());
+            }
+            break;
+        }
+
+        case OpSetScissorRects:
+        {
+            rects.resize(reader.ReadCount());
+            for (CommandRect& rect : rects)
+            {
+                rect = reader.ReadRect();
+            }
+            if (reader.IsOk())
+            {
+                sink.SetScissorRects(static_cast<uint32_t>(rects.size()), rects.data());
+            }
+            break;
+        }
+
+        case OpSetPrimitiveTopology:
+        {
+            const uint32_t topology = reader.ReadUint32();
+            if (reader.IsOk())
+            {
+                sink.SetPrimitiveTopology(topology);
+            }
+            break;
+        }
+
+        case OpSetVertexBuffers:
+        {
+            const uint32_t startSlot = reader.ReadUint32();
+            views.resize(reader.ReadCount());
+            for (CommandVertexBufferView& view : views)
+            {
+                view.address = reader.ReadVarint();
+                view.size = reader.ReadUint32();
+                view.stride = reader.ReadUint32();
+            }
+            if (reader.IsOk())
+            {
+                sink.SetVertexBuffers(startSlot, static_cast<uint32_t>(views.size()), views.data());
+            }
+            break;
+        }
+
+        case OpDraw:
+        {
+            const uint32_t vertexCount = reader.ReadUint32();
+            const uint32_t instanceCount = reader.ReadUint32();
+            const uint32_t startVertex = reader.ReadUint32();
+            const uint32_t startInstance = reader.ReadUint32();
+            if (reader.IsOk())
+            {
+                sink.Draw(vertexCount, instanceCount, startVertex, startInstance);
+            }
+            break;
+        }
+
+        case OpExecuteIndirect:
+        {
+            const CommandHandle commandSignature = reader.ReadObject();
+            const uint32_t maxCommandCount = reader.ReadUint32();
+            const CommandHandle argumentBuffer = reader.ReadObject();
+            const uint64_t argumentOffset = reader.ReadVarint();
+            const CommandHandle countBuffer = reader.ReadObject();
+            const uint64_t countOffset = reader.ReadVarint();
+            if (reader.IsOk())
+            {
+                sink.ExecuteIndirect(commandSignature, maxCommandCount, argumentBuffer, argumentOffset, countBuffer, countOffset);
+            }
+            break;
+        }
+
+        case OpDispatch:
+        {
+            const uint32_t x = reader.ReadUint32();
+            const uint32_t y = reader.ReadUint32();
+            const uint32_t z = reader.ReadUint32();
+            if (reader.IsOk())
+            {
+                sink.Dispatch(x, y, z);
+            }
+            break;
+        }
+
+        default:
+            return false;
+        }
+
+        if (!reader.IsOk())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+NullCommandStreamSink::NullCommandStreamSink() :
+    m_stats(),
+    m_pipelineSet(false),
+    m_rootSignatureSet()
+{
+}
+
+void NullCommandStreamSink::CheckState(bool compute)
+{
+    if (!m_pipelineSet || !m_rootSignatureSet[compute ? 1 : 0])
+    {
+        m_stats.errors++;
+    }
+}
+
+void NullCommandStreamSink::BeginList(uint32_t /*list*/)
+{
+    // Lists start with no state, like a reset command list.
+    m_stats.lists++;
+    m_pipelineSet = false;
+    m_rootSignatureSet[0] = false;
+    m_rootSignatureSet[1] = false;
+}
+
+void NullCommandStreamSink::SetPipelineState(CommandHandle /*pipelineState*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+    m_pipelineSet = true;
+}
+
+void NullCommandStreamSink::SetRootSignature(bool compute, CommandHandle /*rootSignature*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+    m_rootSignatureSet[compute ? 1 : 0] = true;
+}
+
+void NullCommandStreamSink::SetDescriptorHeaps(uint32_t /*count*/, const CommandHandle* /*heaps*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::SetRootDescriptorTable(bool /*compute*/, uint32_t /*index*/, CommandHandle /*baseDescriptor*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::SetRootView(bool /*compute*/, CommandRootView /*view*/, uint32_t /*index*/, CommandHandle /*address*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::SetRoot32BitConstants(bool /*compute*/, uint32_t /*index*/, uint32_t /*count*/, const uint32_t* /*values*/, uint32_t /*offset*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::ResourceBarriers(uint32_t count, const CommandBarrier* /*barriers*/)
+{
+    m_stats.commands++;
+    m_stats.barriers += count;
+}
+
+void NullCommandStreamSink::DiscardResource(CommandHandle /*resource*/)
+{
+    m_stats.commands++;
+}
+
+void NullCommandStreamSink::SetRenderTargets(uint32_t /*count*/, const CommandHandle* /*renderTargets*/, CommandHandle /*depthStencil*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::ClearRenderTarget(CommandHandle /*renderTarget*/, const float* /*color*/, uint32_t /*rectCount*/, const CommandRect* /*rects*/)
+{
+    m_stats.commands++;
+}
+
+void NullCommandStreamSink::SetViewports(uint32_t /*count*/, const CommandViewport* /*viewports*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::SetScissorRects(uint32_t /*count*/, const CommandRect* /*rects*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::SetPrimitiveTopology(uint32_t /*topology*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::SetVertexBuffers(uint32_t /*startSlot*/, uint32_t /*count*/, const CommandVertexBufferView* /*views*/)
+{
+    m_stats.commands++;
+    m_stats.stateChanges++;
+}
+
+void NullCommandStreamSink::Draw(uint32_t /*vertexCount*/, uint32_t /*instanceCount*/, uint32_t /*startVertex*/, uint32_t /*startInstance*/)
+{
+    m_stats.commands++;
+    m_stats.draws++;
+    CheckState(false);
+}
+
+void NullCommandStreamSink::ExecuteIndirect(CommandHandle /*commandSignature*/, uint32_t /*maxCommandCount*/, CommandHandle /*argumentBuffer*/,
+    uint64_t /*argumentOffset*/, CommandHandle /*countBuffer*/, uint64_t /*countOffset*/)
+{
+    m_stats.commands++;
+    m_stats.draws++;
+    CheckState(false);
+}
+
+void NullCommandStreamSink::Dispatch(uint32_t /*x*/, uint32_t /*y*/, uint32_t /*z*/)
+{
+    m_stats.commands++;
+    m_stats.dispatches++;
+    CheckState(true);
+}
+
+uint64_t CommandCapture::GetByteSize() const
+{
+    uint64_t size = 0;
+    for (const CapturedFrame& frame : m_frames)
+    {
+        for (const std::vector<uint8_t>& list : frame.lists)
+        {
+            size += list.size();
+        }
+    }
+    return size;
+}
+
+bool CommandCapture::Replay(uint32_t index, ICommandStreamSink& sink) const
+{
+    const CapturedFrame& frame = m_frames.at(index);
+    for (uint32_t list = 0; list < frame.lists.size(); ++list)
+    {
+        sink.BeginList(list);
+        const bool replayed = ReplayCommandStream(frame.lists[list].data(), frame.lists[list].size(), sink);
+        sink.EndList(list);
+        if (!replayed)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Header, then for each frame its number and list count, then each list as a
+// byte size and the stream.
+bool CommandCapture::Save(const std::string& path) const
+{
+    std::vector<uint8_t> file;
+    file.reserve(sizeof(CaptureHeader) + static_cast<size_t>(GetByteSize()));
+
+    const CaptureHeader header = { CaptureMagic, CaptureVersion, static_cast<uint32_t>(m_frames.size()), 0 };
+    AppendBytes(file, &header, sizeof(header));
+    for (const CapturedFrame& frame : m_frames)
+    {
+        const uint32_t listCount = static_cast<uint32_t>(frame.lists.size());
+        AppendBytes(file, &frame.frame, sizeof(frame.frame));
+        AppendBytes(file, &listCount, sizeof(listCount));
+        for (const std::vector<uint8_t>& list : frame.lists)
+        {
+            const uint64_t size = list.size();
+            AppendBytes(file, &size, sizeof(size));
+            AppendBytes(file, list.data(), list.size());
+        }
+    }
+    return WriteFileAtomic(path, file.data(), file.size());
+}
+
+bool CommandCapture::Load(const std::string& path)
+{
+    m_frames.clear();
+
+    std::vector<uint8_t> file;
+    CaptureHeader header = {};
+    size_t offset = 0;
+    if (!ReadFileBytes(path, file) || !ReadBytes(file, offset, &header, sizeof(header)) ||
+        header.magic != CaptureMagic || header.version != CaptureVersion)
+    {
+        return false;
+    }
+
+    for (uint32_t index = 0; index < header.frameCount; ++index)
+    {
+        CapturedFrame frame;
+        uint32_t listCount = 0;
+        if (!ReadBytes(file, offset, &frame.frame, sizeof(frame.frame)) || !ReadBytes(file, offset, &listCount, sizeof(listCount)) ||
+            listCount > file.size() - offset)
+        {
+            m_frames.clear();
+            return false;
+        }
+
+        frame.lists.resize(listCount);
+        for (std::vector<uint8_t>& list : frame.lists)
+        {
+            uint64_t size = 0;
+            if (!ReadBytes(file, offset, &size, sizeof(size)) || size > file.size() - offset)
+            {
+                m_frames.clear();
+                return false;
+            }
+            list.assign(file.begin() + offset, file.begin() + offset + static_cast<size_t>(size));
+            offset += static_cast<size_t>(size);
+        }
+        m_frames.push_back(std::move(frame));
+    }
+
+    if (offset != file.size())
+    {
+        m_frames.clear();
+        return false;
+    }
+    return true;
+}
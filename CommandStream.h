@@ -0,0 +1,239 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Objects and descriptors are opaque 64-bit handles: pointers, GPU virtual
+// addresses and descriptor handles of the process that recorded them.
+typedef uint64_t CommandHandle;
+
+// D3D12_VIEWPORT.
+struct CommandViewport
+{
+    float x;
+    float y;
+    float width;
+    float height;
+    float minDepth;
+    float maxDepth;
+};
+
+// D3D12_RECT.
+struct CommandRect
+{
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+};
+
+// D3D12_VERTEX_BUFFER_VIEW.
+struct CommandVertexBufferView
+{
+    CommandHandle address;
+    uint32_t size;
+    uint32_t stride;
+};
+
+// D3D12_RESOURCE_BARRIER_TYPE.
+enum CommandBarrierType
+{
+    CommandBarrierTransition,
+    CommandBarrierAliasing,
+    CommandBarrierUav
+};
+
+// D3D12_RESOURCE_BARRIER. resourceBefore is only used by aliasing barriers,
+// the states and subresource only by transitions.
+struct CommandBarrier
+{
+    uint32_t type;
+    uint32_t flags;
+    CommandHandle resource;
+    CommandHandle resourceBefore;
+    uint32_t subresource;
+    uint32_t stateBefore;
+    uint32_t stateAfter;
+};
+
+enum CommandRootView
+{
+    CommandRootViewCbv,
+    CommandRootViewSrv,
+    CommandRootViewUav
+};
+
+// The command list calls a frame is made of, with D3D12 semantics.
+// CommandStreamWriter encodes them, ReplayCommandStream decodes a stream
+// back into calls. compute selects the compute root signature and arguments
+// instead of the graphics ones.
+class ICommandStreamSink
+{
+public:
+    virtual ~ICommandStreamSink() {}
+
+    // A list of a replayed frame starts and ends.
+    virtual void BeginList(uint32_t /*list*/) {}
+    virtual void EndList(uint32_t /*list*/) {}
+
+    virtual void SetPipelineState(CommandHandle pipelineState) = 0;
+    virtual void SetRootSignature(bool compute, CommandHandle rootSignature) = 0;
+    virtual void SetDescriptorHeaps(uint32_t count, const CommandHandle* heaps) = 0;
+    virtual void SetRootDescriptorTable(bool compute, uint32_t index, CommandHandle baseDescriptor) = 0;
+    virtual void SetRootView(bool compute, CommandRootView view, uint32_t index, CommandHandle address) = 0;
+    virtual void SetRoot32BitConstants(bool compute, uint32_t index, uint32_t count, const uint32_t* values, uint32_t offset) = 0;
+
+    virtual void ResourceBarriers(uint32_t count, const CommandBarrier* barriers) = 0;
+    virtual void DiscardResource(CommandHandle resource) = 0;
+
+    // depthStencil is 0 without a depth target.
+    virtual void SetRenderTargets(uint32_t count, const CommandHandle* renderTargets, CommandHandle depthStencil) = 0;
+    virtual void ClearRenderTarget(CommandHandle renderTarget, const float color[4], uint32_t rectCount, const CommandRect* rects) = 0;
+    virtual void SetViewports(uint32_t count, const CommandViewport* viewports) = 0;
+    virtual void SetScissorRects(uint32_t count, const CommandRect* rects) = 0;
+
+    virtual void SetPrimitiveTopology(uint32_t topology) = 0;
+    virtual void SetVertexBuffers(uint32_t startSlot, uint32_t count, const CommandVertexBufferView* views) = 0;
+    virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance) = 0;
+    virtual void ExecuteIndirect(CommandHandle commandSignature, uint32_t maxCommandCount, CommandHandle argumentBuffer,
+        uint64_t argumentOffset, CommandHandle countBuffer, uint64_t countOffset) = 0;
+    virtual void Dispatch(uint32_t x, uint32_t y, uint32_t z) = 0;
+};
+
+// Encodes the calls into a compact byte stream: an opcode byte, then the
+// arguments as LEB128 varints and raw floats. Objects (pipelines, root
+// signatures, heaps, resources) go through a table, a repeated object costs
+// its index only; addresses and descriptors, which change every frame, are
+// written as varints.
+class CommandStreamWriter : public ICommandStreamSink
+{
+public:
+    CommandStreamWriter();
+
+    // Start an empty stream, with an empty object table.
+    void Reset();
+
+    const std::vector<uint8_t>& GetData() const     { return m_data; }
+    std::vector<uint8_t>& GetData()                 { return m_data; }
+    uint64_t GetCommandCount() const                { return m_commandCount; }
+
+    virtual void SetPipelineState(CommandHandle pipelineState);
+    virtual void SetRootSignature(bool compute, CommandHandle rootSignature);
+    virtual void SetDescriptorHeaps(uint32_t count, const CommandHandle* heaps);
+    virtual void SetRootDescriptorTable(bool compute, uint32_t index, CommandHandle baseDescriptor);
+    virtual void SetRootView(bool compute, CommandRootView view, uint32_t index, CommandHandle address);
+    virtual void SetRoot32BitConstants(bool compute, uint32_t index, uint32_t count, const uint32_t* values, uint32_t offset);
+    virtual void ResourceBarriers(uint32_t count, const CommandBarrier* barriers);
+    virtual void DiscardResource(CommandHandle resource);
+    virtual void SetRenderTargets(uint32_t count, const CommandHandle* renderTargets, CommandHandle depthStencil);
+    virtual void ClearRenderTarget(CommandHandle renderTarget, const float color[4], uint32_t rectCount, const CommandRect* rects);
+    virtual void SetViewports(uint32_t count, const CommandViewport* viewports);
+    virtual void SetScissorRects(uint32_t count, const CommandRect* rects);
+    virtual void SetPrimitiveTopology(uint32_t topology);
+    virtual void SetVertexBuffers(uint32_t startSlot, uint32_t count, const CommandVertexBufferView* views);
+    virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance);
+    virtual void ExecuteIndirect(CommandHandle commandSignature, uint32_t maxCommandCount, CommandHandle argumentBuffer,
+        uint64_t argumentOffset, CommandHandle countBuffer, uint64_t countOffset);
+    virtual void Dispatch(uint32_t x, uint32_t y, uint32_t z);
+
+private:
+    void WriteOp(uint32_t op, bool compute);
+    void WriteVarint(uint64_t value);
+    void WriteFloat(float value);
+    void WriteObject(CommandHandle object);
+    void WriteRect(const CommandRect& rect);
+
+    std::vector<uint8_t> m_data;
+    std::vector<CommandHandle> m_objects;
+    uint64_t m_commandCount;
+};
+
+// Decode a stream written by CommandStreamWriter into sink. Returns false,
+// having replayed the commands before it, at the first malformed command; a
+// stream is never read past its end.
+bool ReplayCommandStream(const uint8_t* data, size_t size, ICommandStreamSink& sink);
+
+struct NullCommandStreamStats
+{
+    uint64_t lists;
+    uint64_t commands;
+    uint64_t draws;             // Draw and ExecuteIndirect.
+    uint64_t dispatches;
+    uint64_t barriers;
+    uint64_t stateChanges;      // Pipeline, root signature, root argument, heap and output merger changes.
+    uint64_t errors;            // Draws and dispatches without a pipeline or root signature set in their list.
+};
+
+// Sink that executes nothing. It counts the commands and checks the state the
+// draws depend on is set, so replaying into it measures the cost of decoding
+// and dispatching a frame, and catches streams that lost a command.
+class NullCommandStreamSink : public ICommandStreamSink
+{
+public:
+    NullCommandStreamSink();
+
+    const NullCommandStreamStats& GetStats() const  { return m_stats; }
+
+    virtual void BeginList(uint32_t list);
+    virtual void SetPipelineState(CommandHandle pipelineState);
+    virtual void SetRootSignature(bool compute, CommandHandle rootSignature);
+    virtual void SetDescriptorHeaps(uint32_t count, const CommandHandle* heaps);
+    virtual void SetRootDescriptorTable(bool compute, uint32_t index, CommandHandle baseDescriptor);
+    virtual void SetRootView(bool compute, CommandRootView view, uint32_t index, CommandHandle address);
+    virtual void SetRoot32BitConstants(bool compute, uint32_t index, uint32_t count, const uint32_t* values, uint32_t offset);
+    virtual void ResourceBarriers(uint32_t count, const CommandBarrier* barriers);
+    virtual void DiscardResource(CommandHandle resource);
+    virtual void SetRenderTargets(uint32_t count, const CommandHandle* renderTargets, CommandHandle depthStencil);
+    virtual void ClearRenderTarget(CommandHandle renderTarget, const float color[4], uint32_t rectCount, const CommandRect* rects);
+    virtual void SetViewports(uint32_t count, const CommandViewport* viewports);
+    virtual void SetScissorRects(uint32_t count, const CommandRect* rects);
+    virtual void SetPrimitiveTopology(uint32_t topology);
+    virtual void SetVertexBuffers(uint32_t startSlot, uint32_t count, const CommandVertexBufferView* views);
+    virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance);
+    virtual void ExecuteIndirect(CommandHandle commandSignature, uint32_t maxCommandCount, CommandHandle argumentBuffer,
+        uint64_t argumentOffset, CommandHandle countBuffer, uint64_t countOffset);
+    virtual void Dispatch(uint32_t x, uint32_t y, uint32_t z);
+
+private:
+    void CheckState(bool compute);
+
+    NullCommandStreamStats m_stats;
+    bool m_pipelineSet;
+    bool m_rootSignatureSet[2];     // Graphics, compute.
+};
+
+// One submitted frame: the streams of its lists, in submission order.
+struct CapturedFrame
+{
+    uint64_t frame;
+    std::vector<std::vector<uint8_t>> lists;
+};
+
+// Frames captured from a running renderer, saved to and loaded from a file
+// so they can be replayed elsewhere. Handles keep the values of the
+// capturing process: a capture replays into sinks that only look at them,
+// not against live objects.
+class CommandCapture
+{
+public:
+    void AddFrame(CapturedFrame&& frame)            { m_frames.push_back(std::move(frame)); }
+    void Clear()                                    { m_frames.clear(); }
+
+    uint32_t GetFrameCount() const                  { return static_cast<uint32_t>(m_frames.size()); }
+    const CapturedFrame& GetFrame(uint32_t index) const { return m_frames[index]; }
+    uint64_t GetByteSize() const;
+
+    // Replay the lists of a frame in order, between BeginList and EndList.
+    bool Replay(uint32_t index, ICommandStreamSink& sink) const;
+
+    // Written atomically, see WriteFileAtomic. Load rejects truncated and
+    // foreign files.
+    bool Save(const std::string& path) const;
+    bool Load(const std::string& path);
+
+private:
+    std::vector<CapturedFrame> m_frames;
+};
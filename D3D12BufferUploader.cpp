@@ -0,0 +1,172 @@
+#include "stdafx.h"
+#include "D3D12BufferUploader.h"
+#include "DXSampleHelper.h"
+
+using Microsoft::WRL::ComPtr;
+
+D3D12BufferUploader::D3D12BufferUploader(_In_ ID3D12Device* device, UINT64 stagingSize) :
+    m_device(device),
+    m_listOpen(false)
+{
+    D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+    queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+    ThrowIfFailed(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_queue)));
+    m_queue->SetName(L"Upload Queue");
+    m_fence.reset(new D3D12FrameQueue(device, m_queue.Get()));
+
+    ThrowIfFailed(device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(stagingSize),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&m_staging)));
+    m_staging->SetName(L"Upload Staging");
+
+    // Upload heaps can stay mapped for their whole lifetime.
+    UINT8* staging = nullptr;
+    CD3DX12_RANGE readRange(0, 0);    // We do not intend to read from this resource on the CPU.
+    ThrowIfFailed(m_staging->Map(0, &readRange, reinterpret_cast<void**>(&staging)));
+
+    m_uploader.reset(new BufferUploader(*this, *m_fence, staging, stagingSize));
+}
+
+D3D12BufferUploader::~D3D12BufferUploader()
+{
+    // The copies still read the staging buffer.
+    m_uploader->WaitForIdle();
+    m_staging->Unmap(0, nullptr);
+}
+
+ComPtr<ID3D12Resource> D3D12BufferUploader::CreateBuffer(const void* data, UINT64 size, LPCWSTR name, _Out_opt_ UINT64* fenceValue)
+{
+    ComPtr<ID3D12Resource> buffer;
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(size),
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(&buffer)));
+    buffer->SetName(name);
+
+    const UINT64 uploadFence = Upload(buffer.Get(), 0, data, size);
+    if (fenceValue)
+    {
+        *fenceValue = uploadFence;
+    }
+    return buffer;
+}
+
+ComPtr<ID3D12Resource> D3D12BufferUploader::CreateTexture(const TextureDesc& desc, LPCWSTR name)
+{
+    D3D12_RESOURCE_DESC textureDesc = {};
+    textureDesc.Dimension = static_cast<D3D12_RESOURCE_DIMENSION>(desc.dimension);
+    textureDesc.Width = desc.width;
+    textureDesc.Height = desc.height;
+    textureDesc.DepthOrArraySize = static_cast<UINT16>(desc.dimension == TextureDimension3D ? desc.depth : desc.arraySize);
+    textureDesc.MipLevels = static_cast<UINT16>(desc.mipCount);
+    textureDesc.Format = static_cast<DXGI_FORMAT>(desc.format);
+    textureDesc.SampleDesc.Count = 1;
+    textureDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+    textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    ComPtr<ID3D12Resource> texture;
+    ThrowIfFailed(m_device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+        D3D12_HEAP_FLAG_NONE,
+        &textureDesc,
+        D3D12_RESOURCE_STATE_COMMON,
+        nullptr,
+        IID_PPV_ARGS(&texture)));
+    texture->SetName(name);
+    return texture;
+}
+
+UINT64 D3D12BufferUploader::Upload(_In_ ID3D12Resource* destination, UINT64 destinationOffset, const void* data, UINT64 size)
+{
+    return m_uploader->Upload(destination, destinationOffset, data, size);
+}
+
+UINT64 D3D12BufferUploader::Flush()
+{
+    return m_uploader->Flush();
+}
+
+void D3D12BufferUploader::QueueWait(_In_ ID3D12CommandQueue* queue, UINT64 fenceValue)
+{
+    ThrowIfFailed(queue->Wait(m_fence->GetFence(), fenceValue));
+}
+
+void D3D12BufferUploader::CopyBuffer(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size)
+{
+    OpenCommandList();
+
+    m_commandList->CopyBufferRegion(static_cast<ID3D12Resource*>(destination), destinationOffset, m_staging.Get(), stagingOffset, size);
+}
+
+void D3D12BufferUploader::CopyTexture(void* destination, uint32_t subresource, uint32_t firstRow, uint32_t slice, const TextureFootprint& footprint)
+{
+    OpenCommandList();
+
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT placedFootprint = {};
+    placedFootprint.Offset = footprint.offset;
+    placedFootprint.Footprint.Format = static_cast<DXGI_FORMAT>(footprint.format);
+    placedFootprint.Footprint.Width = footprint.width;
+    placedFootprint.Footprint.Height = footprint.height;
+    placedFootprint.Footprint.Depth = footprint.depth;
+    placedFootprint.Footprint.RowPitch = footprint.rowPitch;
+
+    // Rows are rows of blocks, the destination takes texel coordinates.
+    const UINT blockHeight = footprint.rowCount ? footprint.height / footprint.rowCount : 1;
+    const CD3DX12_TEXTURE_COPY_LOCATION source(m_staging.Get(), placedFootprint);
+    const CD3DX12_TEXTURE_COPY_LOCATION target(static_cast<ID3D12Resource*>(destination), subresource);
+    m_commandList->CopyTextureRegion(&target, 0, firstRow * blockHeight, slice, &source, nullptr);
+}
+
+void D3D12BufferUploader::Submit(uint64_t fenceValue)
+{
+    ThrowIfFailed(m_commandList->Close());
+    ID3D12CommandList* commandLists[] = { m_commandList.Get() };
+    m_queue->ExecuteCommandLists(_countof(commandLists), commandLists);
+    m_listOpen = false;
+
+    // The allocator of this batch goes to the back of the pool.
+    Allocator allocator = m_allocators.front();
+    allocator.fenceValue = fenceValue;
+    m_allocators.pop_front();
+    m_allocators.push_back(allocator);
+}
+
+void D3D12BufferUploader::OpenCommandList()
+{
+    if (m_listOpen)
+    {
+        return;
+    }
+
+    // Reuse the oldest allocator if the queue is done with it, the pool
+    // only grows while batches are in flight.
+    if (m_allocators.empty() || m_allocators.front().fenceValue > m_fence->GetCompletedValue())
+    {
+        Allocator allocator = {};
+        ThrowIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&allocator.allocator)));
+        m_allocators.push_front(allocator);
+    }
+    else
+    {
+        ThrowIfFailed(m_allocators.front().allocator->Reset());
+    }
+
+    if (m_commandList)
+    {
+        ThrowIfFailed(m_commandList->Reset(m_allocators.front().allocator.Get(), nullptr));
+    }
+    else
+    {
+        ThrowIfFailed(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, m_allocators.front().allocator.Get(), nullptr,
+            IID_PPV_ARGS(&m_commandList)));
+    }
+    m_listOpen = true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "stdafx.h"
+#include "BufferUploader.h"
+#include "D3D12FrameQueue.h"
+
+#include <deque>
+#include <memory>
+
+// Fills DEFAULT heap buffers from a dedicated copy queue. Data is staged in a
+// persistently mapped upload ring, batches of copies are recorded on one
+// command list with a pool of allocators recycled by fence, and the queue
+// using the buffers waits for the copy fence on the GPU.
+class D3D12BufferUploader : public IUploadBackend
+{
+public:
+    D3D12BufferUploader(_In_ ID3D12Device* device, UINT64 stagingSize);
+    ~D3D12BufferUploader();
+
+    // A buffer in the COMMON state holding data once the returned fence value
+    // has passed. Buffers are promoted to read states on first use, no
+    // barrier is needed.
+    Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(const void* data, UINT64 size, LPCWSTR name, _Out_opt_ UINT64* fenceValue = nullptr);
+
+    // A texture in the COMMON state, for UploadTexture or a TextureStreamer.
+    // Textures are promoted to copy and shader resource states on use as well.
+    Microsoft::WRL::ComPtr<ID3D12Resource> CreateTexture(const TextureDesc& desc, LPCWSTR name);
+
+    // See BufferUploader, the destination must outlive the copy.
+    UINT64 Upload(_In_ ID3D12Resource* destination, UINT64 destinationOffset, const void* data, UINT64 size);
+    UINT64 Flush();
+
+    // Make queue wait on the GPU until the uploads up to fenceValue are done.
+    void QueueWait(_In_ ID3D12CommandQueue* queue, UINT64 fenceValue);
+
+    BufferUploaderStats GetStats() const { return m_uploader->GetStats(); }
+    BufferUploader& GetUploader()        { return *m_uploader; }
+
+    virtual void CopyBuffer(void* destination, uint64_t destinationOffset, uint64_t stagingOffset, uint64_t size);
+    virtual void CopyTexture(void* destination, uint32_t subresource, uint32_t firstRow, uint32_t slice, const TextureFootprint& footprint);
+    virtual void Submit(uint64_t fenceValue);
+
+private:
+    void OpenCommandList();
+
+    struct Allocator
+    {
+        Microsoft::WRL::ComPtr<ID3D12CommandAllocator>  allocator;
+        UINT64                                          fenceValue;
+    };
+
+    Microsoft::WRL::ComPtr<ID3D12Device>                m_device;
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue>          m_queue;
+    std::unique_ptr<D3D12FrameQueue>                    m_fence;
+    Microsoft::WRL::ComPtr<ID3D12Resource>              m_staging;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>   m_commandList;
+    std::deque<Allocator>                               m_allocators;     // Oldest submission first.
+    bool                                                m_listOpen;
+    std::unique_ptr<BufferUploader>                     m_uploader;
+};
@@ -0,0 +1,285 @@
+#include "stdafx.h"
+#include "D3D12CapturingCommandList.h"
+
+namespace
+{
+    CommandHandle ToHandle(const void* object)
+    {
+        return reinterpret_cast<uintptr_t>(object);
+    }
+}
+
+D3D12CapturingCommandList::D3D12CapturingCommandList() :
+    m_commandList(nullptr),
+    m_writer(nullptr)
+{
+}
+
+D3D12CapturingCommandList::D3D12CapturingCommandList(_In_ ID3D12GraphicsCommandList* commandList) :
+    m_commandList(commandList),
+    m_writer(nullptr)
+{
+}
+
+void D3D12CapturingCommandList::CaptureRects(UINT count, const D3D12_RECT* rects)
+{
+    m_rects.resize(count);
+    for (UINT i = 0; i < count; ++i)
+    {
+        const CommandRect rect = { rects[i].left, rects[i].top, rects[i].right, rects[i].bottom };
+        m_rects[i] = rect;
+    }
+}
+
+void D3D12CapturingCommandList::SetPipelineState(_In_ ID3D12PipelineState* pipelineState)
+{
+    m_commandList->SetPipelineState(pipelineState);
+    if (m_writer)
+    {
+        m_writer->SetPipelineState(ToHandle(pipelineState));
+    }
+}
+
+void D3D12CapturingCommandList::SetGraphicsRootSignature(_In_ ID3D12RootSignature* rootSignature)
+{
+    m_commandList->SetGraphicsRootSignature(rootSignature);
+    if (m_writer)
+    {
+        m_writer->SetRootSignature(false, ToHandle(rootSignature));
+    }
+}
+
+void D3D12CapturingCommandList::SetComputeRootSignature(_In_ ID3D12RootSignature* rootSignature)
+{
+    m_commandList->SetComputeRootSignature(rootSignature);
+    if (m_writer)
+    {
+        m_writer->SetRootSignature(true, ToHandle(rootSignature));
+    }
+}
+
+void D3D12CapturingCommandList::SetDescriptorHeaps(UINT count, _In_reads_(count) ID3D12DescriptorHeap* const* heaps)
+{
+    m_commandList->SetDescriptorHeaps(count, heaps);
+    if (m_writer)
+    {
+        m_handles.resize(count);
+        for (UINT i = 0; i < count; ++i)
+        {
+            m_handles[i] = ToHandle(heaps[i]);
+        }
+        m_writer->SetDescriptorHeaps(count, m_handles.data());
+    }
+}
+
+void D3D12CapturingCommandList::SetGraphicsRootDescriptorTable(UINT index, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor)
+{
+    m_commandList->SetGraphicsRootDescriptorTable(index, baseDescriptor);
+    if (m_writer)
+    {
+        m_writer->SetRootDescriptorTable(false, index, baseDescriptor.ptr);
+    }
+}
+
+void D3D12CapturingCommandList::SetComputeRootDescriptorTable(UINT index, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor)
+{
+    m_commandList->SetComputeRootDescriptorTable(index, baseDescriptor);
+    if (m_writer)
+    {
+        m_writer->SetRootDescriptorTable(true, index, baseDescriptor.ptr);
+    }
+}
+
+void D3D12CapturingCommandList::SetGraphicsRootConstantBufferView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+    m_commandList->SetGraphicsRootConstantBufferView(index, address);
+    if (m_writer)
+    {
+        m_writer->SetRootView(false, CommandRootViewCbv, index, address);
+    }
+}
+
+void D3D12CapturingCommandList::SetGraphicsRootShaderResourceView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+    m_commandList->SetGraphicsRootShaderResourceView(index, address);
+    if (m_writer)
+    {
+        m_writer->SetRootView(false, CommandRootViewSrv, index, address);
+    }
+}
+
+void D3D12CapturingCommandList::SetComputeRootConstantBufferView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+    m_commandList->SetComputeRootConstantBufferView(index, address);
+    if (m_writer)
+    {
+        m_writer->SetRootView(true, CommandRootViewCbv, index, address);
+    }
+}
+
+void D3D12CapturingCommandList::SetGraphicsRoot32BitConstants(UINT index, UINT count, _In_reads_(count) const void* values, UINT offset)
+{
+    m_commandList->SetGraphicsRoot32BitConstants(index, count, values, offset);
+    if (m_writer)
+    {
+        m_writer->SetRoot32BitConstants(false, index, count, static_cast<const uint32_t*>(values), offset);
+    }
+}
+
+void D3D12CapturingCommandList::SetComputeRoot32BitConstants(UINT index, UINT count, _In_reads_(count) const void* values, UINT offset)
+{
+    m_commandList->SetComputeRoot32BitConstants(index, count, values, offset);
+    if (m_writer)
+    {
+        m_writer->SetRoot32BitConstants(true, index, count, static_cast<const uint32_t*>(values), offset);
+    }
+}
+
+void D3D12CapturingCommandList::ResourceBarrier(UINT count, _In_reads_(count) const D3D12_RESOURCE_BARRIER* barriers)
+{
+    m_commandList->ResourceBarrier(count, barriers);
+    if (!m_writer)
+    {
+        return;
+    }
+
+    m_barriers.resize(count);
+    for (UINT i = 0; i < count; ++i)
+    {
+        const D3D12_RESOURCE_BARRIER& barrier = barriers[i];
+        CommandBarrier& captured = m_barriers[i];
+        captured = CommandBarrier();
+        captured.type = barrier.Type;
+        captured.flags = barrier.Flags;
+
+        switch (barrier.Type)
+        {
+        case D3D12_RESOURCE_BARRIER_TYPE_TRANSITION:
+            captured.resource = ToHandle(barrier.Transition.pResource);
+            captured.subresource = barrier.Transition.Subresource;
+            captured.stateBefore = barrier.Transition.StateBefore;
+            captured.stateAfter = barrier.Transition.StateAfter;
+            break;
+
+        case D3D12_RESOURCE_BARRIER_TYPE_ALIASING:
+            captured.resource = ToHandle(barrier.Aliasing.pResourceAfter);
+            captured.resourceBefore = ToHandle(barrier.Aliasing.pResourceBefore);
+            break;
+
+        case D3D12_RESOURCE_BARRIER_TYPE_UAV:
+            captured.resource = ToHandle(barrier.UAV.pResource);
+            break;
+        }
+    }
+    m_writer->ResourceBarriers(count, m_barriers.data());
+}
+
+void D3D12CapturingCommandList::DiscardResource(_In_ ID3D12Resource* resource)
+{
+    m_commandList->DiscardResource(resource, nullptr);
+    if (m_writer)
+    {
+        m_writer->DiscardResource(ToHandle(resource));
+    }
+}
+
+void D3D12CapturingCommandList::OMSetRenderTargets(UINT count, _In_reads_opt_(count) const D3D12_CPU_DESCRIPTOR_HANDLE* renderTargets,
+    _In_opt_ const D3D12_CPU_DESCRIPTOR_HANDLE* depthStencil)
+{
+    m_commandList->OMSetRenderTargets(count, renderTargets, FALSE, depthStencil);
+    if (m_writer)
+    {
+        m_handles.resize(count);
+        for (UINT i = 0; i < count; ++i)
+        {
+            m_handles[i] = renderTargets[i].ptr;
+        }
+        m_writer->SetRenderTargets(count, m_handles.data(), depthStencil ? depthStencil->ptr : 0);
+    }
+}
+
+void D3D12CapturingCommandList::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, const FLOAT color[4], UINT rectCount,
+    _In_reads_opt_(rectCount) const D3D12_RECT* rects)
+{
+    m_commandList->ClearRenderTargetView(renderTarget, color, rectCount, rects);
+    if (m_writer)
+    {
+        CaptureRects(rectCount, rects);
+        m_writer->ClearRenderTarget(renderTarget.ptr, color, rectCount, m_rects.data());
+    }
+}
+
+void D3D12CapturingCommandList::RSSetViewports(UINT count, _In_reads_(count) const D3D12_VIEWPORT* viewports)
+{
+    m_commandList->RSSetViewports(count, viewports);
+    if (m_writer)
+    {
+        // Same six floats.
+        static_assert(sizeof(CommandViewport) == sizeof(D3D12_VIEWPORT), "CommandViewport must match D3D12_VIEWPORT");
+        m_writer->SetViewports(count, reinterpret_cast<const CommandViewport*>(viewports));
+    }
+}
+
+void D3D12CapturingCommandList::RSSetScissorRects(UINT count, _In_reads_(count) const D3D12_RECT* rects)
+{
+    m_commandList->RSSetScissorRects(count, rects);
+    if (m_writer)
+    {
+        CaptureRects(count, rects);
+        m_writer->SetScissorRects(count, m_rects.data());
+    }
+}
+
+void D3D12CapturingCommandList::IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology)
+{
+    m_commandList->IASetPrimitiveTopology(topology);
+    if (m_writer)
+    {
+        m_writer->SetPrimitiveTopology(topology);
+    }
+}
+
+void D3D12CapturingCommandList::IASetVertexBuffers(UINT startSlot, UINT count, _In_reads_opt_(count) const D3D12_VERTEX_BUFFER_VIEW* views)
+{
+    m_commandList->IASetVertexBuffers(startSlot, count, views);
+    if (m_writer)
+    {
+        // Null views unbind the slots.
+        m_views.resize(count);
+        for (UINT i = 0; i < count; ++i)
+        {
+            m_views[i].address = views ? views[i].BufferLocation : 0;
+            m_views[i].size = views ? views[i].SizeInBytes : 0;
+            m_views[i].stride = views ? views[i].StrideInBytes : 0;
+        }
+        m_writer->SetVertexBuffers(startSlot, count, m_views.data());
+    }
+}
+
+void D3D12CapturingCommandList::DrawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance)
+{
+    m_commandList->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+    if (m_writer)
+    {
+        m_writer->Draw(vertexCount, instanceCount, startVertex, startInstance);
+    }
+}
+
+void D3D12CapturingCommandList::ExecuteIndirect(_In_ ID3D12CommandSignature* commandSignature, UINT maxCommandCount, _In_ ID3D12Resource* argumentBuffer,
+    UINT64 argumentOffset, _In_opt_ ID3D12Resource* countBuffer, UINT64 countOffset)
+{
+    m_commandList->ExecuteIndirect(commandSignature, maxCommandCount, argumentBuffer, argumentOffset, countBuffer, countOffset);
+    if (m_writer)
+    {
+        m_writer->ExecuteIndirect(ToHandle(commandSignature), maxCommandCount, ToHandle(argumentBuffer), argumentOffset, ToHandle(countBuffer), countOffset);
+    }
+}
+
+void D3D12CapturingCommandList::Dispatch(UINT x, UINT y, UINT z)
+{
+    m_commandList->Dispatch(x, y, z);
+    if (m_writer)
+    {
+        m_writer->Dispatch(x, y, z);
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "stdafx.h"
+#include "CommandStream.h"
+
+#include <vector>
+
+// The calls the passes of a frame make on a command list, forwarded to the
+// list and, while a writer is set, encoded into it as well. Calls made on the
+// list directly (timestamp queries, readback copies) are not captured.
+class D3D12CapturingCommandList
+{
+public:
+    D3D12CapturingCommandList();
+    explicit D3D12CapturingCommandList(_In_ ID3D12GraphicsCommandList* commandList);
+
+    ID3D12GraphicsCommandList* GetCommandList() const   { return m_commandList; }
+
+    // Null stops the capture.
+    void SetWriter(CommandStreamWriter* writer)         { m_writer = writer; }
+    bool IsCapturing() const                            { return m_writer != nullptr; }
+
+    void SetPipelineState(_In_ ID3D12PipelineState* pipelineState);
+    void SetGraphicsRootSignature(_In_ ID3D12RootSignature* rootSignature);
+    void SetComputeRootSignature(_In_ ID3D12RootSignature* rootSignature);
+    void SetDescriptorHeaps(UINT count, _In_reads_(count) ID3D12DescriptorHeap* const* heaps);
+    void SetGraphicsRootDescriptorTable(UINT index, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor);
+    void SetComputeRootDescriptorTable(UINT index, D3D12_GPU_DESCRIPTOR_HANDLE baseDescriptor);
+    void SetGraphicsRootConstantBufferView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address);
+    void SetGraphicsRootShaderResourceView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address);
+    void SetComputeRootConstantBufferView(UINT index, D3D12_GPU_VIRTUAL_ADDRESS address);
+    void SetGraphicsRoot32BitConstants(UINT index, UINT count, _In_reads_(count) const void* values, UINT offset);
+    void SetComputeRoot32BitConstants(UINT index, UINT count, _In_reads_(count) const void* values, UINT offset);
+
+    void ResourceBarrier(UINT count, _In_reads_(count) const D3D12_RESOURCE_BARRIER* barriers);
+    void DiscardResource(_In_ ID3D12Resource* resource);
+
+    // Render targets are separate handles, not a single descriptor range.
+    void OMSetRenderTargets(UINT count, _In_reads_opt_(count) const D3D12_CPU_DESCRIPTOR_HANDLE* renderTargets,
+        _In_opt_ const D3D12_CPU_DESCRIPTOR_HANDLE* depthStencil);
+    void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, const FLOAT color[4], UINT rectCount, _In_reads_opt_(rectCount) const D3D12_RECT* rects);
+    void RSSetViewports(UINT count, _In_reads_(count) const D3D12_VIEWPORT* viewports);
+    void RSSetScissorRects(UINT count, _In_reads_(count) const D3D12_RECT* rects);
+
+    void IASetPrimitiveTopology(D3D12_PRIMITIVE_TOPOLOGY topology);
+    void IASetVertexBuffers(UINT startSlot, UINT count, _In_reads_opt_(count) const D3D12_VERTEX_BUFFER_VIEW* views);
+    void DrawInstanced(UINT vertexCount, UINT instanceCount, UINT startVertex, UINT startInstance);
+    void ExecuteIndirect(_In_ ID3D12CommandSignature* commandSignature, UINT maxCommandCount, _In_ ID3D12Resource* argumentBuffer,
+        UINT64 argumentOffset, _In_opt_ ID3D12Resource* countBuffer, UINT64 countOffset);
+    void Dispatch(UINT x, UINT y, UINT z);
+
+private:
+    void CaptureRects(UINT count, const D3D12_RECT* rects);
+
+    ID3D12GraphicsCommandList* m_commandList;
+    CommandStreamWriter* m_writer;
+
+    // Conversion scratch, the list is recorded by one thread at a time.
+    std::vector<CommandHandle> m_handles;
+    std::vector<CommandRect> m_rects;
+    std::vector<CommandBarrier> m_barriers;
+    std::vector<CommandVertexBufferView> m_views;
+};
@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "D3D12CommandListPool.h"
+#include "DXSampleHelper.h"
+
+D3D12CommandListPool::D3D12CommandListPool(_In_ ID3D12Device* device, _In_ ID3D12CommandQueue* queue, UINT framesInFlight, UINT maxListCount) :
+    m_queue(queue),
+    m_allocators(framesInFlight * maxListCount),
+    m_commandLists(maxListCount),
+    m_writers(maxListCount),
+    m_frameIndex(0),
+    m_capture(nullptr),
+    m_submitCount(0)
+{
+    for (auto& allocator : m_allocators)
+    {
+        ThrowIfFailed(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&allocator)));
+    }
+
+    // Command lists are created in the recording state, BeginList expects them closed.
+    for (UINT list = 0; list < maxListCount; ++list)
+    {
+        ThrowIfFailed(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_allocators[list].Get(), nullptr,
+            IID_PPV_ARGS(&m_commandLists[list])));
+        ThrowIfFailed(m_commandLists[list]->Close());
+        m_commands.push_back(D3D12CapturingCommandList(m_commandLists[list].Get()));
+    }
+
+    m_submitted.reserve(maxListCount);
+}
+
+void D3D12CommandListPool::BeginList(uint32_t list)
+{
+    // Each list is recorded by a single thread, its allocators are not shared.
+    ID3D12CommandAllocator* allocator = m_allocators[m_frameIndex * m_commandLists.size() + list].Get();
+    ThrowIfFailed(allocator->Reset());
+    ThrowIfFailed(m_commandLists[list]->Reset(allocator, nullptr));
+
+    // The list setup is part of the captured stream, a replayed list starts from scratch too.
+    CommandStreamWriter* writer = nullptr;
+    if (m_capture)
+    {
+        writer = &m_writers[list];
+        writer->Reset();
+    }
+    m_commands[list].SetWriter(writer);
+
+    if (m_setup)
+    {
+        m_setup(m_commands[list]);
+    }
+}
+
+void D3D12CommandListPool::EndList(uint32_t list)
+{
+    ThrowIfFailed(m_commandLists[list]->Close());
+}
+
+void D3D12CommandListPool::Submit(uint32_t listCount)
+{
+    m_submitted.clear();
+    for (uint32_t list = 0; list < listCount; ++list)
+    {
+        m_submitted.push_back(m_commandLists[list].Get());
+    }
+
+    m_queue->ExecuteCommandLists(static_cast<UINT>(m_submitted.size()), m_submitted.data());
+
+    if (m_capture)
+    {
+        CapturedFrame frame;
+        frame.frame = m_submitCount;
+        for (uint32_t list = 0; list < listCount; ++list)
+        {
+            frame.lists.push_back(m_writers[list].GetData());
+        }
+        m_capture->AddFrame(std::move(frame));
+    }
+    m_submitCount++;
+}
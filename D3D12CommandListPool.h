@@ -0,0 +1,50 @@
+#pragma once
+
+#include "stdafx.h"
+#include "CommandRecorder.h"
+#include "D3D12CapturingCommandList.h"
+
+#include <functional>
+#include <vector>
+
+// Direct command lists for a ParallelCommandRecorder. Each list has one
+// allocator per frame in flight, reset when the list is begun for that frame,
+// and the lists of a frame are submitted in one ExecuteCommandLists call.
+// While a capture is set, the calls made through GetCommands are recorded and
+// each submitted frame is added to the capture.
+class D3D12CommandListPool : public ICommandListBackend
+{
+public:
+    // Applied to every list after its reset: root signature, heaps, viewport.
+    typedef std::function<void(D3D12CapturingCommandList& commands)> ListSetup;
+
+    D3D12CommandListPool(_In_ ID3D12Device* device, _In_ ID3D12CommandQueue* queue, UINT framesInFlight, UINT maxListCount);
+
+    // The GPU must be done with the previous use of the frame, see FrameScheduler::BeginFrame.
+    void SetFrameIndex(UINT frameIndex) noexcept { m_frameIndex = frameIndex; }
+    void SetListSetup(const ListSetup& setup) { m_setup = setup; }
+
+    // Call between frames, null stops capturing. capture must outlive the
+    // frames submitted while it is set.
+    void SetCapture(CommandCapture* capture) { m_capture = capture; }
+
+    ID3D12GraphicsCommandList* GetCommandList(uint32_t list) const { return m_commandLists[list].Get(); }
+    D3D12CapturingCommandList& GetCommands(uint32_t list) { return m_commands[list]; }
+
+    virtual uint32_t GetMaxListCount() const { return static_cast<uint32_t>(m_commandLists.size()); }
+    virtual void BeginList(uint32_t list);
+    virtual void EndList(uint32_t list);
+    virtual void Submit(uint32_t listCount);
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue>                          m_queue;
+    std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>>         m_allocators;   // Frame major.
+    std::vector<Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList>>      m_commandLists;
+    std::vector<ID3D12CommandList*>                                     m_submitted;
+    std::vector<D3D12CapturingCommandList>                              m_commands;
+    std::vector<CommandStreamWriter>                                    m_writers;
+    ListSetup                                                           m_setup;
+    UINT                                                                m_frameIndex;
+    CommandCapture*                                                     m_capture;
+    uint64_t                                                            m_submitCount;
+};
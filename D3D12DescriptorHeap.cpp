@@ -0,0 +1,85 @@
+#include "stdafx.h"
+#include "D3D12DescriptorHeap.h"
+#include "DXSampleHelper.h"
+
+D3D12DescriptorHeap::D3D12DescriptorHeap(_In_ ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, bool shaderVisible,
+    UINT persistentCount, UINT transientCount, _In_opt_ IFrameQueue* queue) :
+    m_cpuStart{},
+    m_gpuStart{},
+    m_descriptorSize(device->GetDescriptorHandleIncrementSize(type)),
+    m_persistent(0, persistentCount),
+    m_queue(queue)
+{
+    if (transientCount && (!shaderVisible || !queue))
+    {
+        throw std::invalid_argument("Transient descriptors need a shader visible heap and a queue");
+    }
+
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
+    heapDesc.NumDescriptors = persistentCount + transientCount;
+    heapDesc.Type = type;
+    heapDesc.Flags = shaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+    ThrowIfFailed(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_heap)));
+
+    m_cpuStart = m_heap->GetCPUDescriptorHandleForHeapStart();
+    if (shaderVisible)
+    {
+        m_gpuStart = m_heap->GetGPUDescriptorHandleForHeapStart();
+    }
+
+    if (transientCount)
+    {
+        m_transient.reset(new TransientDescriptorAllocator(persistentCount, transientCount));
+    }
+}
+
+DescriptorHandle D3D12DescriptorHeap::GetHandle(UINT index) const
+{
+    DescriptorHandle handle;
+    handle.cpu = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_cpuStart, index, m_descriptorSize);
+    handle.gpu = m_gpuStart.ptr ? CD3DX12_GPU_DESCRIPTOR_HANDLE(m_gpuStart, index, m_descriptorSize) : D3D12_GPU_DESCRIPTOR_HANDLE{};
+    handle.index = index;
+    return handle;
+}
+
+DescriptorHandle D3D12DescriptorHeap::AllocatePersistent(UINT count)
+{
+    const UINT index = m_persistent.Allocate(count);
+    if (index == PersistentDescriptorAllocator::InvalidIndex)
+    {
+        throw std::runtime_error("D3D12DescriptorHeap: out of persistent descriptors");
+    }
+
+    return GetHandle(index);
+}
+
+void D3D12DescriptorHeap::FreePersistent(const DescriptorHandle& handle, UINT count)
+{
+    m_persistent.Free(handle.index, count);
+}
+
+DescriptorHandle D3D12DescriptorHeap::AllocateTransient(UINT count)
+{
+    if (!m_transient)
+    {
+        throw std::logic_error("D3D12DescriptorHeap: heap has no transient region");
+    }
+
+    return GetHandle(m_transient->Allocate(count, *m_queue));
+}
+
+void D3D12DescriptorHeap::FinishFrame(UINT64 fenceValue)
+{
+    if (m_transient)
+    {
+        m_transient->FinishFrame(fenceValue);
+    }
+}
+
+void D3D12DescriptorHeap::ReleaseCompleted()
+{
+    if (m_transient)
+    {
+        m_transient->ReleaseCompleted(m_queue->GetCompletedValue());
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "stdafx.h"
+#include "DescriptorAllocator.h"
+
+#include <memory>
+
+struct DescriptorHandle
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE cpu;
+    D3D12_GPU_DESCRIPTOR_HANDLE gpu;    // Null for heaps that are not shader visible.
+    UINT                        index;
+};
+
+// A descriptor heap split in two regions: persistent slots handed out by a
+// bitmap allocator, followed by per-frame transient ranges recycled by fence.
+class D3D12DescriptorHeap
+{
+public:
+    // The transient region needs a shader-visible heap and a queue to wait on.
+    D3D12DescriptorHeap(_In_ ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, bool shaderVisible,
+        UINT persistentCount, UINT transientCount = 0, _In_opt_ IFrameQueue* queue = nullptr);
+
+    // Throws if the persistent region is full.
+    DescriptorHandle AllocatePersistent(UINT count = 1);
+    void FreePersistent(const DescriptorHandle& handle, UINT count = 1);
+
+    // First descriptor of a range only valid for the frame being recorded.
+    DescriptorHandle AllocateTransient(UINT count);
+
+    // Close the current frame, see UploadRing::FinishFrame.
+    void FinishFrame(UINT64 fenceValue);
+
+    // Recycle the transient ranges of the frames the queue has completed.
+    void ReleaseCompleted();
+
+    DescriptorHandle GetHandle(UINT index) const;
+    ID3D12DescriptorHeap* GetHeap() const noexcept { return m_heap.Get(); }
+    UINT GetDescriptorSize() const noexcept { return m_descriptorSize; }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>        m_heap;
+    D3D12_CPU_DESCRIPTOR_HANDLE                         m_cpuStart;
+    D3D12_GPU_DESCRIPTOR_HANDLE                         m_gpuStart;
+    UINT                                                m_descriptorSize;
+    PersistentDescriptorAllocator                       m_persistent;
+    std::unique_ptr<TransientDescriptorAllocator>       m_transient;
+    IFrameQueue*                                        m_queue;
+};
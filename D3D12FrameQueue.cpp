@@ -0,0 +1,44 @@
+#include "stdafx.h"
+#include "D3D12FrameQueue.h"
+#include "DXSampleHelper.h"
+
+D3D12FrameQueue::D3D12FrameQueue(_In_ ID3D12Device* device, _In_ ID3D12CommandQueue* commandQueue) :
+    m_commandQueue(commandQueue),
+    m_fenceEvent(nullptr)
+{
+    ThrowIfFailed(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
+
+    // Create an event handle to use for frame synchronization.
+    m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    if (m_fenceEvent == nullptr)
+    {
+        ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+    }
+}
+
+D3D12FrameQueue::~D3D12FrameQueue()
+{
+    if (m_fenceEvent)
+    {
+        CloseHandle(m_fenceEvent);
+    }
+}
+
+void D3D12FrameQueue::Signal(uint64_t fenceValue)
+{
+    ThrowIfFailed(m_commandQueue->Signal(m_fence.Get(), fenceValue));
+}
+
+uint64_t D3D12FrameQueue::GetCompletedValue()
+{
+    return m_fence->GetCompletedValue();
+}
+
+void D3D12FrameQueue::WaitForValue(uint64_t fenceValue)
+{
+    if (m_fence->GetCompletedValue() < fenceValue)
+    {
+        ThrowIfFailed(m_fence->SetEventOnCompletion(fenceValue, m_fenceEvent));
+        WaitForSingleObject(m_fenceEvent, INFINITE);
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "stdafx.h"
+#include "FrameScheduler.h"
+
+// IFrameQueue backed by a D3D12 command queue and fence.
+class D3D12FrameQueue : public IFrameQueue
+{
+public:
+    D3D12FrameQueue(_In_ ID3D12Device* device, _In_ ID3D12CommandQueue* commandQueue);
+    ~D3D12FrameQueue();
+
+    virtual void Signal(uint64_t fenceValue);
+    virtual uint64_t GetCompletedValue();
+    virtual void WaitForValue(uint64_t fenceValue);
+
+    ID3D12Fence* GetFence() const noexcept { return m_fence.Get(); }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue>          m_commandQueue;
+    Microsoft::WRL::ComPtr<ID3D12Fence>                 m_fence;
+    HANDLE                                              m_fenceEvent;
+};
@@ -0,0 +1,145 @@
+#include "stdafx.h"
+#include "D3D12GpuProfiler.h"
+#include "DXSampleHelper.h"
+
+#include <algorithm>
+
+namespace
+{
+    // Recalibrate now and then, the two clocks drift apart slowly.
+    const UINT64 CalibrationInterval = 64;
+
+    INT64 QpcToNanoseconds(UINT64 counter, UINT64 frequency)
+    {
+        return static_cast<INT64>(counter / frequency * 1000000000ull + counter % frequency * 1000000000ull / frequency);
+    }
+}
+
+D3D12GpuProfiler::D3D12GpuProfiler(_In_ ID3D12Device* device, _In_ ID3D12CommandQueue* queue, Profiler& profiler,
+    UINT framesInFlight, UINT maxScopesPerFrame) :
+    m_queue(queue),
+    m_timestamps(nullptr),
+    m_profiler(profiler),
+    m_maxScopes(maxScopesPerFrame),
+    m_frameIndex(0),
+    m_frames(new Frame[framesInFlight]),
+    m_frequency(1),
+    m_calibrationGpu(0),
+    m_calibrationCpu(0),
+    m_framesSinceCalibration(0),
+    m_droppedScopes(0),
+    m_lastFrameMs(0.0)
+{
+    const UINT queryCount = framesInFlight * maxScopesPerFrame * 2;
+
+    D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+    queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    queryHeapDesc.Count = queryCount;
+    ThrowIfFailed(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&m_queryHeap)));
+
+    const CD3DX12_HEAP_PROPERTIES readbackHeap(D3D12_HEAP_TYPE_READBACK);
+    const CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(queryCount * sizeof(UINT64));
+    ThrowIfFailed(device->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&m_readback)));
+    m_readback->SetName(L"Timestamp Readback");
+
+    // Readback buffers may stay mapped, each range is only read after its fence.
+    void* data = nullptr;
+    ThrowIfFailed(m_readback->Map(0, nullptr, &data));
+    m_timestamps = static_cast<const UINT64*>(data);
+
+    for (UINT i = 0; i < framesInFlight; ++i)
+    {
+        m_frames[i].scopeCount = 0;
+        m_frames[i].names.resize(maxScopesPerFrame);
+        m_frames[i].frameNumber = 0;
+    }
+
+    ThrowIfFailed(m_queue->GetTimestampFrequency(&m_frequency));
+    Calibrate();
+}
+
+D3D12GpuProfiler::~D3D12GpuProfiler()
+{
+    const D3D12_RANGE nothingWritten = {};
+    m_readback->Unmap(0, &nothingWritten);
+}
+
+void D3D12GpuProfiler::Calibrate()
+{
+    UINT64 gpuTimestamp = 0;
+    UINT64 cpuCounter = 0;
+    ThrowIfFailed(m_queue->GetClockCalibration(&gpuTimestamp, &cpuCounter));
+
+    // The calibration is in QPC ticks, Profiler::Now has its own epoch.
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    const INT64 offset = Profiler::Now() - QpcToNanoseconds(now.QuadPart, frequency.QuadPart);
+
+    m_calibrationGpu = gpuTimestamp;
+    m_calibrationCpu = QpcToNanoseconds(cpuCounter, frequency.QuadPart) + offset;
+    m_framesSinceCalibration = 0;
+}
+
+void D3D12GpuProfiler::BeginFrame(UINT frameIndex)
+{
+    Frame& frame = m_frames[frameIndex];
+    const UINT scopeCount = std::min<UINT>(frame.scopeCount.load(), m_maxScopes);
+    const UINT64* timestamps = m_timestamps + frameIndex * m_maxScopes * 2;
+    const double nanosecondsPerTick = 1e9 / static_cast<double>(m_frequency);
+
+    INT64 frameBegin = INT64_MAX;
+    INT64 frameEnd = INT64_MIN;
+    for (UINT scope = 0; scope < scopeCount; ++scope)
+    {
+        const INT64 begin = static_cast<INT64>(timestamps[scope * 2] - m_calibrationGpu);
+        const INT64 end = static_cast<INT64>(timestamps[scope * 2 + 1] - m_calibrationGpu);
+        frameBegin = std::min<INT64>(frameBegin, begin);
+        frameEnd = std::max<INT64>(frameEnd, end);
+
+        m_profiler.AddGpuEvent(frame.names[scope], frame.frameNumber,
+            m_calibrationCpu + static_cast<INT64>(begin * nanosecondsPerTick),
+            m_calibrationCpu + static_cast<INT64>(end * nanosecondsPerTick));
+    }
+    m_lastFrameMs = scopeCount ? (frameEnd - frameBegin) * nanosecondsPerTick / 1e6 : 0.0;
+
+    if (++m_framesSinceCalibration >= CalibrationInterval)
+    {
+        Calibrate();
+    }
+
+    frame.scopeCount = 0;
+    frame.frameNumber = m_profiler.GetFrame();
+    m_frameIndex = frameIndex;
+}
+
+UINT D3D12GpuProfiler::BeginScope(_In_ ID3D12GraphicsCommandList* commandList, const char* name)
+{
+    Frame& frame = m_frames[m_frameIndex];
+    const UINT scope = frame.scopeCount.fetch_add(1);
+    if (scope >= m_maxScopes)
+    {
+        m_droppedScopes++;
+        return InvalidScope;
+    }
+
+    frame.names[scope] = name;
+    commandList->EndQuery(m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, (m_frameIndex * m_maxScopes + scope) * 2);
+    return scope;
+}
+
+void D3D12GpuProfiler::EndScope(_In_ ID3D12GraphicsCommandList* commandList, UINT scope)
+{
+    if (scope == InvalidScope)
+    {
+        return;
+    }
+
+    // Resolving the pair right away keeps every list self-contained, whatever
+    // order the lists are recorded in.
+    const UINT query = (m_frameIndex * m_maxScopes + scope) * 2;
+    commandList->EndQuery(m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query + 1);
+    commandList->ResolveQueryData(m_queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query, 2, m_readback.Get(), query * sizeof(UINT64));
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "stdafx.h"
+#include "Profiler.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// GPU timestamps around command list scopes, fed to a Profiler on the CPU
+// clock. Each frame in flight owns a range of the query heap and of a
+// persistently mapped readback buffer; a scope is resolved on its own list
+// when it ends, and read back once the frame scheduler has waited for that
+// frame again.
+class D3D12GpuProfiler
+{
+public:
+    D3D12GpuProfiler(_In_ ID3D12Device* device, _In_ ID3D12CommandQueue* queue, Profiler& profiler,
+        UINT framesInFlight, UINT maxScopesPerFrame = 64);
+    ~D3D12GpuProfiler();
+
+    // The GPU must be done with the previous use of the frame, see FrameScheduler::BeginFrame.
+    void BeginFrame(UINT frameIndex);
+
+    // Thread safe. Scopes past maxScopesPerFrame are dropped.
+    UINT BeginScope(_In_ ID3D12GraphicsCommandList* commandList, const char* name);
+    void EndScope(_In_ ID3D12GraphicsCommandList* commandList, UINT scope);
+
+    // Span from the first scope begin to the last scope end of the frame read
+    // back by the last BeginFrame, 0 when it had no scopes.
+    double GetLastFrameGpuMs() const noexcept { return m_lastFrameMs; }
+
+    Profiler& GetProfiler() const noexcept { return m_profiler; }
+    UINT64 GetDroppedScopeCount() const noexcept { return m_droppedScopes.load(); }
+
+private:
+    static const UINT InvalidScope = ~0u;
+
+    struct Frame
+    {
+        std::atomic<UINT>           scopeCount;
+        std::vector<const char*>    names;
+        UINT64                      frameNumber;
+    };
+
+    void Calibrate();
+
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue>          m_queue;
+    Microsoft::WRL::ComPtr<ID3D12QueryHeap>             m_queryHeap;
+    Microsoft::WRL::ComPtr<ID3D12Resource>              m_readback;
+    const UINT64*                                       m_timestamps;
+    Profiler&                                           m_profiler;
+    UINT                                                m_maxScopes;
+    UINT                                                m_frameIndex;
+    std::unique_ptr<Frame[]>                            m_frames;
+
+    // GPU ticks to Profiler::Now nanoseconds.
+    UINT64                                              m_frequency;
+    UINT64                                              m_calibrationGpu;
+    INT64                                               m_calibrationCpu;
+    UINT64                                              m_framesSinceCalibration;
+    std::atomic<UINT64>                                 m_droppedScopes;
+    double                                              m_lastFrameMs;
+};
@@ -11,13 +11,74 @@
 
 #include "stdafx.h"
 #include "D3D12HelloTriangle.h"
+#include "MappedFile.h"
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace
+{
+    // Binary PPM of a tightly packed RGBA8 image, the alpha is dropped.
+    bool WritePpm(const std::string& path, const std::vector<uint8_t>& rgba, UINT width, UINT height)
+    {
+        char header[64] = {};
+        const int headerSize = sprintf_s(header, "P6\n%u %u\n255\n", width, height);
+
+        std::vector<uint8_t> image(header, header + headerSize);
+        image.reserve(image.size() + static_cast<size_t>(width) * height * 3);
+        for (size_t i = 0; i + 3 < rgba.size(); i += 4)
+        {
+            image.insert(image.end(), rgba.begin() + i, rgba.begin() + i + 3);
+        }
+        return WriteFileAtomic(path, image.data(), image.size());
+    }
+}
 
 D3D12HelloTriangle::D3D12HelloTriangle(UINT width, UINT height, std::wstring name) :
     DXSample(width, height, name),
     m_frameIndex(0),
+    m_backBufferIndex(0),
+    m_frameNumber(0),
+    m_capturedFrame(0),
+    m_color(),
+    m_previousColor(),
+    m_instanceRadius(0.0f),
+    m_visibleInstanceCount(0),
+    m_instanceBuffer(0),
+    m_drawArgumentsOffset(0),
+    m_textureView(),
+    m_captureLatency(0),
+    m_backBufferCount(0),
+    m_rootSignatureHash(0),
+    m_blurRootSignatureHash(0),
+    m_frameConstantsParameter(0),
+    m_textureParameter(0),
+    m_instancesParameter(0),
+    m_blurKernelParameter(0),
+    m_blurPassParameter(0),
+    m_blurSourceParameter(0),
+    m_blurDestinationParameter(0),
+    m_sceneTexture(RenderGraph::InvalidResource),
+    m_blurTempTexture(RenderGraph::InvalidResource),
+    m_blurredTexture(RenderGraph::InvalidResource),
+    m_displayTexture(RenderGraph::InvalidResource),
+    m_backBufferTexture(RenderGraph::InvalidResource),
+    m_sceneWidth(width),
+    m_sceneHeight(height),
+    m_sceneScaleTotal(0.0),
+    m_sceneViewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)),
+    m_sceneScissorRect(0, 0, static_cast<LONG>(width), static_cast<LONG>(height)),
     m_viewport(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)),
     m_scissorRect(0, 0, static_cast<LONG>(width), static_cast<LONG>(height)),
-    m_rtvDescriptorSize(0)
+    m_frameConstants(),
+    m_frameConstantBuffer(0),
+    m_blurConstants(),
+    m_blurConstantBuffer(0)
 {
 }
 
@@ -80,309 +141,413 @@ void D3D12HelloTriangle::LoadPipeline()
 
     ThrowIfFailed(m_device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_commandQueue)));
 
-    // Describe and create the swap chain.
-    DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
-    swapChainDesc.BufferCount = FrameCount;
-    swapChainDesc.Width = m_width;
-    swapChainDesc.Height = m_height;
-    swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-    swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-    swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-    swapChainDesc.SampleDesc.Count = 1;
-
-    ComPtr<IDXGISwapChain1> swapChain;
-    ThrowIfFailed(factory->CreateSwapChainForHwnd(
-        m_commandQueue.Get(),        // Swap chain needs the queue so that it can force a flush on it.
-        Win32Application::GetHwnd(),
-        &swapChainDesc,
-        nullptr,
-        nullptr,
-        &swapChain
-        ));
-
-    // This sample does not support fullscreen transitions.
-    ThrowIfFailed(factory->MakeWindowAssociation(Win32Application::GetHwnd(), DXGI_MWA_NO_ALT_ENTER));
-
-    ThrowIfFailed(swapChain.As(&m_swapChain));
-    m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+    // Create the fence used to pace the frames in flight.
+    m_frameQueue.reset(new D3D12FrameQueue(m_device.Get(), m_commandQueue.Get()));
+    m_frameScheduler.reset(new FrameScheduler(m_frameQueue.get(), m_framesInFlight));
 
-    // Create descriptor heaps.
+    if (m_headless)
     {
-        // Describe and create a shader resource view (SRV) heap for the shader parameters.
-        for (int i = 0; i < FrameCount; ++i)
-        {
-            D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-            srvHeapDesc.NumDescriptors = 2;
-            srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-            srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-            ThrowIfFailed(m_device->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_descriptorHeap[i])));
+        // Without a swap chain each frame in flight renders into its own output texture.
+        m_backBufferCount = m_framesInFlight;
+        m_backBufferIndex = 0;
+    }
+    else
+    {
+        // The swap chain needs at least two buffers for flip model presentation,
+        // everything else is sized by the number of frames in flight.
+        m_backBufferCount = m_framesInFlight < 2 ? 2 : m_framesInFlight;
+
+        // Describe and create the swap chain.
+        DXGI_SWAP_CHAIN_DESC1 swapChainDesc = {};
+        swapChainDesc.BufferCount = m_backBufferCount;
+        swapChainDesc.Width = m_width;
+        swapChainDesc.Height = m_height;
+        swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        swapChainDesc.SampleDesc.Count = 1;
+
+        ComPtr<IDXGISwapChain1> swapChain;
+        ThrowIfFailed(factory->CreateSwapChainForHwnd(
+            m_commandQueue.Get(),        // Swap chain needs the queue so that it can force a flush on it.
+            Win32Application::GetHwnd(),
+            &swapChainDesc,
+            nullptr,
+            nullptr,
+            &swapChain
+            ));
 
-            m_srvDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-        }
+        // This sample does not support fullscreen transitions.
+        ThrowIfFailed(factory->MakeWindowAssociation(Win32Application::GetHwnd(), DXGI_MWA_NO_ALT_ENTER));
 
-        // Describe and create a render target view (RTV) descriptor heap.
-        D3D12_DESCRIPTOR_HEAP_DESC rtvHeapDesc = {};
-        rtvHeapDesc.NumDescriptors = FrameCount * 2;
-        rtvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-        rtvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
-        ThrowIfFailed(m_device->CreateDescriptorHeap(&rtvHeapDesc, IID_PPV_ARGS(&m_rtvHeap)));
+        ThrowIfFailed(swapChain.As(&m_swapChain));
+        m_backBufferIndex = m_swapChain->GetCurrentBackBufferIndex();
+    }
+
+    m_renderTargets.resize(m_backBufferCount);
+    m_renderTargetRtv.resize(m_backBufferCount);
+    m_outputTexture.reserve(m_backBufferCount);
 
-        m_rtvDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+    // Create descriptor heaps.
+    {
+        // A single shader visible heap for the whole app, so it is only bound once per
+        // command list. Views of long-lived resources get persistent slots, the tables
+        // rebuilt every frame come from transient ranges recycled by fence.
+        m_srvHeap.reset(new D3D12DescriptorHeap(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, true,
+            SrvHeapPersistentCount, SrvHeapTransientCount, m_frameQueue.get()));
+
+        // Render target views are never shader visible and only need persistent slots.
+        m_rtvHeap.reset(new D3D12DescriptorHeap(m_device.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_RTV, false, RtvHeapCount));
     }
 
+    // Offscreen render targets are placed in shared heaps and recycled by
+    // fence when they are resized or released.
+    m_renderTargetPool.reset(new D3D12RenderTargetPool(m_device.Get(), *m_frameScheduler));
+
     // Create frame resources.
     {
-        CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
-
-        // Create a RTV for each frame.
-        for (UINT n = 0; n < FrameCount; n++)
+        // Create a RTV for each back buffer.
+        for (UINT n = 0; n < m_backBufferCount; n++)
         {
-            ThrowIfFailed(m_swapChain->GetBuffer(n, IID_PPV_ARGS(&m_renderTargets[n])));
-            m_device->CreateRenderTargetView(m_renderTargets[n].Get(), nullptr, rtvHandle);
-            rtvHandle.Offset(1, m_rtvDescriptorSize);
+            m_renderTargetRtv[n] = m_rtvHeap->AllocatePersistent();
+
+            if (m_headless)
+            {
+                RECT dimension = { 0, 0, static_cast<LONG>(m_width), static_cast<LONG>(m_height) };
+
+                m_outputTexture.emplace_back(DXGI_FORMAT_R8G8B8A8_UNORM);
+                m_outputTexture[n].SetClearColor({ 0.0f, 0.2f, 0.4f, 1.0f });
+                m_outputTexture[n].SetDevice(m_device.Get(), D3D12_CPU_DESCRIPTOR_HANDLE{}, m_renderTargetRtv[n].cpu);
+                m_outputTexture[n].SetStateTracker(&m_stateTracker);
+                m_outputTexture[n].SetPool(m_renderTargetPool.get());
+                m_outputTexture[n].SetWindow(dimension);
+                m_renderTargets[n] = m_outputTexture[n].GetResource();
+            }
+            else
+            {
+                ThrowIfFailed(m_swapChain->GetBuffer(n, IID_PPV_ARGS(&m_renderTargets[n])));
+                m_device->CreateRenderTargetView(m_renderTargets[n].Get(), nullptr, m_renderTargetRtv[n].cpu);
+                m_stateTracker.Track(m_renderTargets[n].Get(), D3D12_RESOURCE_STATE_PRESENT);
+            }
         }
     }
 
-    ThrowIfFailed(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_commandAllocator)));
+    // Create the command lists, one per recording thread. Each has an allocator
+    // per frame in flight, an allocator can only be reset once the GPU is done
+    // with the frame that used it.
+    m_jobSystem.reset(new JobSystem(m_recordThreads));
+    m_commandListPool.reset(new D3D12CommandListPool(m_device.Get(), m_commandQueue.Get(), m_framesInFlight, m_jobSystem->GetThreadCount()));
+    m_commandListPool->SetListSetup([this](D3D12CapturingCommandList& commands) { SetupCommandList(commands); });
+    m_commandRecorder.reset(new ParallelCommandRecorder(*m_jobSystem, *m_commandListPool));
+
+    m_profiler.reset(new Profiler());
+    m_gpuProfiler.reset(new D3D12GpuProfiler(m_device.Get(), m_commandQueue.Get(), *m_profiler, m_framesInFlight));
+
+    // A capture completes when its frame slot comes around again, one more
+    // slot than frames in flight leaves room to hold a completed one.
+    if (m_captureInterval)
+    {
+        m_readback.reset(new D3D12TextureReadback(m_device.Get(), m_frameQueue.get(), m_framesInFlight + 1,
+            m_width, m_height, DXGI_FORMAT_R8G8B8A8_UNORM));
+    }
 }
 
 // Load the sample assets.
 void D3D12HelloTriangle::LoadAssets()
 {
+    // Root signatures are laid out by a builder and shared between identical
+    // layouts. They are version 1.1 where the runtime has it, the flags tell
+    // the driver which data it can treat as static.
+    m_rootSignatureCache.reset(new D3D12RootSignatureCache(m_device.Get()));
+
     // Create Root signature
     {
-        // Descriptor range (one type cbv)
-        D3D12_DESCRIPTOR_RANGE  descriptorTableRanges[2]; // only one range right now
-        descriptorTableRanges[0].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV; // this is a range of constant buffer views (descriptors)
-        descriptorTableRanges[0].NumDescriptors = 1; // we only have one constant buffer, so the range is only 1
-        descriptorTableRanges[0].BaseShaderRegister = 0; // start index of the shader registers in the range
-        descriptorTableRanges[0].RegisterSpace = 0; // space 0. can usually be zero
-        descriptorTableRanges[0].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND; // this appends the range to the end of the root signature descriptor tables
-
-        descriptorTableRanges[1].RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV; // this is a range of constant buffer views (descriptors)
-        descriptorTableRanges[1].NumDescriptors = 1; // we only have one texture, so the range is only 1
-        descriptorTableRanges[1].BaseShaderRegister = 0; // start index of the shader registers in the range
-        descriptorTableRanges[1].RegisterSpace = 0; // space 0. can usually be zero
-        descriptorTableRanges[1].OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND; // this appends the range to the end of the root signature descriptor tables
-
-        // create a descriptor table (multiple type)
-        D3D12_ROOT_DESCRIPTOR_TABLE descriptorTable;
-        descriptorTable.NumDescriptorRanges = _countof(descriptorTableRanges); // we only have one range
-        descriptorTable.pDescriptorRanges = &descriptorTableRanges[0]; // the pointer to the beginning of our ranges array
-
-        // create a static sampler
-        D3D12_STATIC_SAMPLER_DESC staticSampler = {};
-        staticSampler.Filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
-        staticSampler.AddressU = D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
-        staticSampler.AddressV = D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
-        staticSampler.AddressW = D3D12_TEXTURE_ADDRESS_MODE_MIRROR;
-        staticSampler.MipLODBias = 0;
-        staticSampler.MaxAnisotropy = 0;
-        staticSampler.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER;
-        staticSampler.BorderColor = D3D12_STATIC_BORDER_COLOR_OPAQUE_WHITE;
-        staticSampler.MinLOD = 0.0f;
-        staticSampler.MaxLOD = D3D12_FLOAT32_MAX;
-        staticSampler.ShaderRegister = 0;
-        staticSampler.RegisterSpace = 0;
-        staticSampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
-
-        // Create root signature.
-        {
-            // create a root parameter and fill it out
-            D3D12_ROOT_PARAMETER  rootParameters[1];
-            rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE; // this is a descriptor table
-            rootParameters[0].DescriptorTable = descriptorTable; // this is our descriptor table for this root parameter
-            rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
-
-            CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
-            rootSignatureDesc.Init(_countof(rootParameters), 
-                rootParameters,
-                1, 
-                &staticSampler,
-                D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT
-            );
-
-            ComPtr<ID3DBlob> signature;
-            ComPtr<ID3DBlob> error;
-            ThrowIfFailed(D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error));
-            ThrowIfFailed(m_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&m_rootSignature)));
-        }
+        RootSignatureBuilder builder;
+
+        // The frame constants are small enough to live in the root, setting
+        // them needs neither a slice of the constant ring nor a view.
+        m_frameConstantsParameter = builder.AddConstantBuffer(0, sizeof(ShaderData));
+
+        // The texture has a transient view written every frame.
+        m_textureParameter = builder.AddTable(RootRangeSrv, 0, 1, RootVisibilityPixel);
+
+        // The instances are a root SRV, written by the CPU before the list runs.
+        m_instancesParameter = builder.AddRootView(RootParameterSrv, 1, RootVisibilityVertex, RootDataStatic);
+
+        // Bilinear, the quad upscales the scene under dynamic resolution.
+        const RootStaticSamplerDesc staticSampler = { D3D12_FILTER_MIN_MAG_MIP_LINEAR, D3D12_TEXTURE_ADDRESS_MODE_MIRROR, 0, 0, RootVisibilityPixel };
+        builder.AddStaticSampler(staticSampler);
+        builder.SetFlags(RootSignatureAllowInputLayout);
+
+        m_rootSignatureLayout = builder.Build();
+        CreateRootSignature(m_rootSignatureLayout, m_rootSignature, m_rootSignatureHash);
     }
 
-    m_shaderData.solidColor = XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f);
+    // Create the blur root signature: the kernel weights are a buffer of their
+    // own, the direction and the scene size are root constants, the textures
+    // are single views.
+    {
+        RootSignatureBuilder builder;
+        m_blurKernelParameter = builder.AddConstantBuffer(0, sizeof(BlurConstants));
+        m_blurPassParameter = builder.AddRootConstants(1, 4);
+        m_blurSourceParameter = builder.AddTable(RootRangeSrv, 0);
+        m_blurDestinationParameter = builder.AddTable(RootRangeUav, 0);
+
+        m_blurRootSignatureLayout = builder.Build();
+        CreateRootSignature(m_blurRootSignatureLayout, m_blurRootSignature, m_blurRootSignatureHash);
+    }
 
-    // Create the constant buffers.
     {
-        // create a resource heap, descriptor heap, and pointer to cbv for each frame
-        for (int i = 0; i < FrameCount; ++i)
-        {
-            ThrowIfFailed(m_device->CreateCommittedResource(
-                &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD), // this heap will be used to upload the constant buffer data
-                D3D12_HEAP_FLAG_NONE, // no flags
-                &CD3DX12_RESOURCE_DESC::Buffer(1024 * 64), // size of the resource heap. Must be a multiple of 64KB for single-textures and constant buffers
-                D3D12_RESOURCE_STATE_GENERIC_READ, // will be data that is read from so we keep it in the generic read state
-                nullptr, // we do not have use an optimized clear value for constant buffers
-                IID_PPV_ARGS(&m_ressourcesMemory[i])
-            ));
-            m_ressourcesMemory[i]->SetName(L"Constant Buffer Upload Resource Heap");
+        const RootSignatureCacheStats stats = m_rootSignatureCache->GetStats();
+        char buff[64] = {};
+        sprintf_s(buff, "Root signatures: %u created for %u layouts, version 1.%u\n", stats.signatures, stats.requests,
+            m_rootSignatureCache->GetVersion() == D3D_ROOT_SIGNATURE_VERSION_1_1 ? 1 : 0);
+        OutputDebugStringA(buff);
+    }
 
-            D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc = {};
-            cbvDesc.BufferLocation = m_ressourcesMemory[i]->GetGPUVirtualAddress();
-            cbvDesc.SizeInBytes = (sizeof(ShaderData) + 255) & ~255;    // CB size is required to be 256-byte aligned.
-            m_device->CreateConstantBufferView(&cbvDesc, m_descriptorHeap[i]->GetCPUDescriptorHandleForHeapStart());
+    // Blur weights, packed for blur.hlsl once for the whole run.
+    {
+        const BlurKernel kernel = m_boxBlur ? BlurKernel::Box(m_blurRadius) : BlurKernel::Gaussian(m_blurRadius);
 
-            // Get cpu mappable address
-            CD3DX12_RANGE readRange(0, 0);    // We do not intend to read from this resource on the CPU. (End is less than or equal to begin)
-            ThrowIfFailed(m_ressourcesMemory[i]->Map(0, &readRange, reinterpret_cast<void**>(&m_writableAdresses[i])));
-            memcpy(m_writableAdresses[i], &m_shaderData, sizeof(ShaderData));
-        }
+        m_blurConstants = {};
+        m_blurConstants.radius = kernel.GetRadius();
+        std::copy(kernel.GetWeights(), kernel.GetWeights() + kernel.GetTapCount(), m_blurConstants.weights);
     }
 
-    // Create RenderTexture
+    // The color cycling, one ping-pong per channel into m_color. Each packet
+    // interpolates it into FrameState::color, which ends up in
+    // ShaderData::solidColor. Red starts at 1 on its way down.
+    m_colorAnimation.Add(0.0f, 1.0f, 16.7f, AnimationCurvePingPong, 0.5f);
+    m_colorAnimation.Add(0.0f, 1.0f, 5.6f, AnimationCurvePingPong);
+    m_colorAnimation.Add(0.0f, 1.0f, 3.7f, AnimationCurvePingPong);
+
+    if (m_dynamicResolutionMs > 0.0f)
     {
-        RECT dimension;
-        dimension.left = m_viewport.TopLeftX;
-        dimension.top = m_viewport.TopLeftY;
-        dimension.right = m_viewport.TopLeftX + m_viewport.Width;
-        dimension.bottom = m_viewport.TopLeftY + m_viewport.Height;
+        DynamicResolutionSettings settings;
+        settings.targetMs = m_dynamicResolutionMs;
+        m_dynamicResolution.reset(new DynamicResolutionController(settings));
+        m_sceneSlotScales.assign(m_framesInFlight, 1.0);
+    }
 
-        CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart());
-        // Render Target offset
-        rtvHandle.Offset(2, m_rtvDescriptorSize);
+    // One instance reproduces the original triangle, more are scattered over
+    // an area larger than the screen so that culling has work to do.
+    if (m_instanceCount > 1)
+    {
+        const CullRect area = { -1.5f, -1.5f, 1.5f, 1.5f };
+        m_instances.Scatter(m_instanceCount, area, 0.05f, 0.15f, 1);
+
+        // Each spins a full turn, one way or the other, in 2 to 12 seconds.
+        std::mt19937 random(2);
+        std::uniform_real_distribution<float> period(2.0f, 12.0f);
+        std::bernoulli_distribution clockwise(0.5);
+        const float twoPi = 6.28318531f;
+        for (UINT i = 0; i < m_instanceCount; ++i)
+        {
+            const float start = m_instances.rotation[i];
+            m_instanceAnimation.Add(start, clockwise(random) ? start - twoPi : start + twoPi, period(random), AnimationCurveLinear);
+        }
+    }
+    else
+    {
+        const InstanceData instance = { { 0.0f, 0.0f }, 1.0f, 0.0f, { 1.0f, 1.0f, 1.0f, 1.0f } };
+        m_instances.Resize(1);
+        m_instances.Set(0, instance);
+    }
 
-        for (UINT i = 0; i < FrameCount; i++)
+    // The first packets show the initial state.
+    {
+        m_rotation = m_instances.rotation;
+        m_colorAnimation.Update(0.0f, m_color);
+        m_instanceAnimation.Update(0.0f, m_rotation.data());
+        std::copy(m_color, m_color + _countof(m_color), m_previousColor);
+        m_previousRotation = m_rotation;
+
+        for (FrameState& state : m_frameStates)
         {
-            CD3DX12_CPU_DESCRIPTOR_HANDLE srvHandle(m_descriptorHeap[i]->GetCPUDescriptorHandleForHeapStart());
-            srvHandle.Offset(1, m_srvDescriptorSize);
-            m_renderTexture[i] = new RenderTexture(DXGI_FORMAT_R8G8B8A8_UNORM);
-            m_renderTexture[i]->SetClearColor({ 0.1f, 0.1f, 1.0f, 1.0f });
-            m_renderTexture[i]->SetDevice(m_device.Get(), srvHandle, rtvHandle);
-            m_renderTexture[i]->SetWindow(dimension);
-            rtvHandle.Offset(1, m_rtvDescriptorSize);
+            std::copy(m_color, m_color + _countof(m_color), state.color);
+            state.rotation = m_rotation;
         }
     }
 
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC trianglePsoDesc = {};
-    // Create pipeline states, which includes compiling and loading shaders.
+    // The draw of the triangle pass reads its instance count from the GPU.
     {
-        ComPtr<ID3DBlob> triangleVertexShader;
-        ComPtr<ID3DBlob> trianglePixelShader;
+        D3D12_INDIRECT_ARGUMENT_DESC argumentDesc = {};
+        argumentDesc.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DRAW;
+
+        D3D12_COMMAND_SIGNATURE_DESC signatureDesc = {};
+        signatureDesc.ByteStride = sizeof(IndirectDrawArguments);
+        signatureDesc.NumArgumentDescs = 1;
+        signatureDesc.pArgumentDescs = &argumentDesc;
+        ThrowIfFailed(m_device->CreateCommandSignature(&signatureDesc, nullptr, IID_PPV_ARGS(&m_drawSignature)));
+    }
 
-#if defined(_DEBUG)
-        // Enable better shader debugging with the graphics debugging tools.
-        UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#else
-        UINT compileFlags = 0;
-#endif
+    // Create the constant buffer ring.
+    {
+        // A single persistently mapped upload buffer shared by all the frames in flight,
+        // each draw gets its own 256-byte aligned slice, see WriteFrameConstants(). The
+        // instances of a frame come on top of the constants.
+        const UINT64 instanceBufferSize = static_cast<UINT64>(m_instanceCount) * sizeof(InstanceData) + D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+        m_constantRing.reset(new UploadHeapRing(m_device.Get(), (ConstantRingFrameSize + instanceBufferSize) * m_framesInFlight, m_frameQueue.get()));
+    }
 
-        ThrowIfFailed(D3DCompileFromFile(GetAssetFullPath(L"shaders.hlsl").c_str(), nullptr, nullptr, "VSMain", "vs_5_0", compileFlags, 0, &triangleVertexShader, nullptr));
-        ThrowIfFailed(D3DCompileFromFile(GetAssetFullPath(L"shaders.hlsl").c_str(), nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &trianglePixelShader, nullptr));
+    // Describe the frame as a render graph, the offscreen texture becomes a
+    // transient placed in a heap owned by the graph backend.
+    BuildRenderGraph();
 
-        // Define the vertex input layout.
-        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+    // Shader bytecode is cached next to the executable, the compiler only runs on a miss.
+    m_shaderCache.reset(new ShaderCache(WideToUtf8(GetAssetFullPath(L"shaders.cache")), GetD3DCompilerId(), CreateD3DCompileCallback()));
+
+    // Same for the driver-compiled pipeline states.
+    m_pipelineCache.reset(new PipelineStateCache(WideToUtf8(GetAssetFullPath(L"pipelines.cache"))));
+
+    // Define the vertex input layouts.
+    D3D12_INPUT_ELEMENT_DESC triangleInputElementDescs[] =
+    {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+    };
+    D3D12_INPUT_ELEMENT_DESC quadInputElementDescs[] =
+    {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+    };
+
+    // Describe the graphics pipeline state objects (PSO), their shaders are
+    // filled in once compiled.
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC trianglePsoDesc = {};
+    trianglePsoDesc.InputLayout = { triangleInputElementDescs, _countof(triangleInputElementDescs) };
+    trianglePsoDesc.pRootSignature = m_rootSignature.Get();
+    trianglePsoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+    trianglePsoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+    trianglePsoDesc.DepthStencilState.DepthEnable = FALSE;
+    trianglePsoDesc.DepthStencilState.StencilEnable = FALSE;
+    trianglePsoDesc.SampleMask = UINT_MAX;
+    trianglePsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+    trianglePsoDesc.NumRenderTargets = 1;
+    trianglePsoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+    trianglePsoDesc.SampleDesc.Count = 1;
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC quadPsoDesc = trianglePsoDesc;
+    quadPsoDesc.InputLayout = { quadInputElementDescs, _countof(quadInputElementDescs) };
+
+    // Blur PSO, the same shader runs both directions.
+    D3D12_COMPUTE_PIPELINE_STATE_DESC blurPsoDesc = {};
+    blurPsoDesc.pRootSignature = m_blurRootSignature.Get();
+
+    // Compile the shaders and create the pipeline states on the job threads.
+    // Each shader is a task and each pipeline state waits on its own shaders
+    // only, the caches are safe to share between the tasks.
+    enum
+    {
+        TriangleVertexShader,
+        TrianglePixelShader,
+        QuadVertexShader,
+        QuadPixelShader,
+        BlurShader,
+        ShaderCount
+    };
+    struct ShaderStage
+    {
+        LPCWSTR assetName;
+        const char* entryPoint;
+        const char* target;
+        D3D12_SHADER_BYTECODE bytecode;
+        uint32_t task;
+    };
+    ShaderStage shaders[ShaderCount] =
+    {
+        { L"shaders.hlsl", "VSMain", "vs_5_0" },
+        { L"shaders.hlsl", "PSMain", "ps_5_0" },
+        { L"quad_shaders.hlsl", "VSMain", "vs_5_0" },
+        { L"quad_shaders.hlsl", "PSMain", "ps_5_0" },
+        { L"blur.hlsl", "CSMain", "cs_5_0" }
+    };
+
+    TaskGraph startup;
+    for (ShaderStage& shader : shaders)
+    {
+        shader.task = startup.AddTask(WideToUtf8(shader.assetName) + " " + shader.entryPoint, [this, &shader]
         {
-            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-            { "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-        };
-
-        // Describe and create the graphics pipeline state object (PSO).
-        trianglePsoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
-        trianglePsoDesc.pRootSignature = m_rootSignature.Get();
-        trianglePsoDesc.VS = CD3DX12_SHADER_BYTECODE(triangleVertexShader.Get());
-        trianglePsoDesc.PS = CD3DX12_SHADER_BYTECODE(trianglePixelShader.Get());
-        trianglePsoDesc.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
-        trianglePsoDesc.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
-        trianglePsoDesc.DepthStencilState.DepthEnable = FALSE;
-        trianglePsoDesc.DepthStencilState.StencilEnable = FALSE;
-        trianglePsoDesc.SampleMask = UINT_MAX;
-        trianglePsoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-        trianglePsoDesc.NumRenderTargets = 1;
-        trianglePsoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
-        trianglePsoDesc.SampleDesc.Count = 1;
-        ThrowIfFailed(m_device->CreateGraphicsPipelineState(&trianglePsoDesc, IID_PPV_ARGS(&m_trianglePipelineState)));
-    }
-
-    {
-        // Quad PSO
-        ComPtr<ID3DBlob> quadVertexShader;
-        ComPtr<ID3DBlob> quadPixelShader;
-        ID3DBlob* errorBlob1 = nullptr;
-        ID3DBlob* errorBlob2 = nullptr;
+            shader.bytecode = LoadShader(shader.assetName, shader.entryPoint, shader.target);
+        });
+    }
 
-#if defined(_DEBUG)
-        // Enable better shader debugging with the graphics debugging tools.
-        UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
-#else
-        UINT compileFlags = 0;
-#endif
+    startup.AddTask("Triangle PSO", [&]
+    {
+        trianglePsoDesc.VS = shaders[TriangleVertexShader].bytecode;
+        trianglePsoDesc.PS = shaders[TrianglePixelShader].bytecode;
+        CreatePipelineState(trianglePsoDesc, m_trianglePipelineState);
+    }, { shaders[TriangleVertexShader].task, shaders[TrianglePixelShader].task });
 
+    startup.AddTask("Quad PSO", [&]
+    {
+        quadPsoDesc.VS = shaders[QuadVertexShader].bytecode;
+        quadPsoDesc.PS = shaders[QuadPixelShader].bytecode;
+        CreatePipelineState(quadPsoDesc, m_quadPipelineState);
+    }, { shaders[QuadVertexShader].task, shaders[QuadPixelShader].task });
 
-        HRESULT hr = D3DCompileFromFile(GetAssetFullPath(L"quad_shaders.hlsl").c_str(), nullptr, nullptr, "VSMain", "vs_5_0", compileFlags, 0, &quadVertexShader, &errorBlob1);
-        hr &= D3DCompileFromFile(GetAssetFullPath(L"quad_shaders.hlsl").c_str(), nullptr, nullptr, "PSMain", "ps_5_0", compileFlags, 0, &quadPixelShader, &errorBlob2);
+    startup.AddTask("Blur PSO", [&]
+    {
+        blurPsoDesc.CS = shaders[BlurShader].bytecode;
+        CreatePipelineState(blurPsoDesc, m_blurRootSignatureHash, m_blurPipelineState);
+    }, { shaders[BlurShader].task });
 
-        if (FAILED(hr)) {
-            if (errorBlob1) {
-                OutputDebugStringA((char*)errorBlob1->GetBufferPointer());
-                errorBlob1->Release();
-            } 
-            if (errorBlob2) {
-                OutputDebugStringA((char*)errorBlob2->GetBufferPointer());
-                errorBlob2->Release();
-            }
-            throw HrException(hr);
-        }
+    startup.Run(*m_jobSystem);
 
-        // Define the vertex input layout.
-        D3D12_INPUT_ELEMENT_DESC inputElementDescs[] =
+    {
+        const TaskGraphStats& stats = startup.GetStats();
+        char buff[256] = {};
+        sprintf_s(buff, "Startup: %u tasks on %u threads in %.1f ms (serial %.1f ms, critical path %.1f ms): ",
+            stats.taskCount, stats.threadCount, stats.wallMs, stats.totalTaskMs, stats.criticalPathMs);
+        OutputDebugStringA((buff + startup.FormatCriticalPath() + "\n").c_str());
+    }
+
+    // Register the shaders and the pipelines using them, then watch the shader
+    // files from here on. The reloader keeps copies of the bytecode, saving
+    // the cache below does not affect it.
+    if (m_hotReload)
+    {
+        m_shaderReload.reset(new D3D12ShaderHotReload(m_device.Get(), CreateD3DCompileCallback()));
+
+        UINT reloadShaders[ShaderCount] = {};
+        for (UINT i = 0; i < ShaderCount; ++i)
         {
-            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-        };
+            reloadShaders[i] = m_shaderReload->AddShader(GetShaderRequest(shaders[i].assetName, shaders[i].entryPoint, shaders[i].target), shaders[i].bytecode);
+        }
 
-        D3D12_GRAPHICS_PIPELINE_STATE_DESC quadPsoDesc = trianglePsoDesc;
-        quadPsoDesc.InputLayout = { inputElementDescs, _countof(inputElementDescs) };
-        quadPsoDesc.VS = CD3DX12_SHADER_BYTECODE(quadVertexShader.Get());
-        quadPsoDesc.PS = CD3DX12_SHADER_BYTECODE(quadPixelShader.Get());
-        ThrowIfFailed(m_device->CreateGraphicsPipelineState(&quadPsoDesc, IID_PPV_ARGS(&m_quadPipelineState)));
+        m_shaderReload->AddPipeline(trianglePsoDesc, reloadShaders[TriangleVertexShader], reloadShaders[TrianglePixelShader], &m_trianglePipelineState);
+        m_shaderReload->AddPipeline(quadPsoDesc, reloadShaders[QuadVertexShader], reloadShaders[QuadPixelShader], &m_quadPipelineState);
+        m_shaderReload->AddPipeline(blurPsoDesc, reloadShaders[BlurShader], &m_blurPipelineState);
+        m_shaderReload->Start();
     }
 
-    // Create the command list.
-    ThrowIfFailed(m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocator.Get(), m_trianglePipelineState.Get(), IID_PPV_ARGS(&m_commandList)));
+    // The PSOs hold their own copy of the bytecode, persisting the cache can
+    // invalidate the pointers we used.
+    if (!m_shaderCache->Save())
+    {
+        OutputDebugStringA("Failed to save the shader cache\n");
+    }
+    if (!m_pipelineCache->Save())
+    {
+        OutputDebugStringA("Failed to save the pipeline cache\n");
+    }
 
-    // Command lists are created in the recording state, but there is nothing
-    // to record yet. The main loop expects it to be closed, so close it now.
-    ThrowIfFailed(m_commandList->Close());
+    // Both vertex buffers go out in one batch.
+    m_bufferUploader.reset(new D3D12BufferUploader(m_device.Get(), UploadStagingSize));
 
     // Create the Triangle vertex buffer.
     {
-        // Define the geometry for a triangle.
-        Vertex triangleVertices[] =
-        {
-            { { 0.0f, 0.25f * m_aspectRatio, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
-            { { 0.25f, -0.25f * m_aspectRatio, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
-            { { -0.25f, -0.25f * m_aspectRatio, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } }
-        };
+        // The geometry for a triangle, shared with SoftwareRasterizer frames.
+        static_assert(sizeof(Vertex) == sizeof(SoftwareVertex), "Vertex layout");
+        SoftwareVertex triangleVertices[SampleTriangleVertexCount];
+        GetSampleTriangleVertices(m_aspectRatio, triangleVertices);
+        m_instanceRadius = GetBoundingRadius(triangleVertices, SampleTriangleVertexCount);
 
         const UINT vertexBufferSize = sizeof(triangleVertices);
 
-        // Note: using upload heaps to transfer static data like vert buffers is not 
-        // recommended. Every time the GPU needs it, the upload heap will be marshalled 
-        // over. Please read up on Default Heap usage. An upload heap is used here for 
-        // code simplicity and because there are very few verts to actually transfer.
-        ThrowIfFailed(m_device->CreateCommittedResource(
-            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-            D3D12_HEAP_FLAG_NONE,
-            &CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(&m_triangleVertexBuffer)));
-
-        // Copy the triangle data to the vertex buffer.
-        UINT8* pVertexDataBegin;
-        CD3DX12_RANGE readRange(0, 0);        // We do not intend to read from this resource on the CPU.
-        ThrowIfFailed(m_triangleVertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin)));
-        memcpy(pVertexDataBegin, triangleVertices, sizeof(triangleVertices));
-        m_triangleVertexBuffer->Unmap(0, nullptr);
+        // The vertices are staged and copied to a DEFAULT heap buffer on the
+        // copy queue, the GPU never reads them over the bus.
+        m_triangleVertexBuffer = m_bufferUploader->CreateBuffer(triangleVertices, vertexBufferSize, L"Triangle Vertices");
 
         // Initialize the vertex buffer view.
         m_triangleVertexBufferView.BufferLocation = m_triangleVertexBuffer->GetGPUVirtualAddress();
@@ -392,33 +557,10 @@ void D3D12HelloTriangle::LoadAssets()
 
     // Create the Quad vertex buffer.
     {
-        // Define the geometry for a quad.
-        TextureVertex quadVertices[] =
-        {
-            { { -1.0f, 1.0f, 0.0f }, { 0.0f, 0.0f} },
-            { { 1.0f,  1.0f, 0.0f }, { 1.0f, 0.0f} },
-            { { 1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f} },
-
-            { { -1.0f,  1.0f, 0.0f }, { 0.0f, 0.0f } },
-            { {  1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f } },
-            { { -1.0f, -1.0f, 0.0f }, { 0.0f, 1.0f } }
-        };
-
-        const UINT vertexBufferSize = sizeof(quadVertices);
-        ThrowIfFailed(m_device->CreateCommittedResource(
-            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-            D3D12_HEAP_FLAG_NONE,
-            &CD3DX12_RESOURCE_DESC::Buffer(vertexBufferSize),
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(&m_quadVertexBuffer)));
-
-        // Copy the triangle data to the vertex buffer.
-        UINT8* pVertexDataBegin;
-        CD3DX12_RANGE readRange(0, 0);        // We do not intend to read from this resource on the CPU.
-        ThrowIfFailed(m_quadVertexBuffer->Map(0, &readRange, reinterpret_cast<void**>(&pVertexDataBegin)));
-        memcpy(pVertexDataBegin, quadVertices, sizeof(quadVertices));
-        m_quadVertexBuffer->Unmap(0, nullptr);
+        // The geometry for a quad covering the target.
+        static_assert(sizeof(TextureVertex) == sizeof(SoftwareTextureVertex), "TextureVertex layout");
+        const UINT vertexBufferSize = sizeof(SampleQuadVertices);
+        m_quadVertexBuffer = m_bufferUploader->CreateBuffer(SampleQuadVertices, vertexBufferSize, L"Quad Vertices");
 
         // Initialize the vertex buffer view.
         m_quadVertexBufferView.BufferLocation = m_quadVertexBuffer->GetGPUVirtualAddress();
@@ -426,165 +568,680 @@ void D3D12HelloTriangle::LoadAssets()
         m_quadVertexBufferView.SizeInBytes = vertexBufferSize;
     }
 
-    // Create synchronization objects and wait until assets have been uploaded to the GPU.
+    // The blur weights do not change for the whole run, they go out with the
+    // vertices and every dispatch binds the same buffer.
+    if (m_blurRootSignatureLayout.GetParameter(m_blurKernelParameter).type == RootParameterCbv)
     {
-        ThrowIfFailed(m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&m_fence)));
-        m_fenceValue = 1;
+        m_blurConstantResource = m_bufferUploader->CreateBuffer(&m_blurConstants, sizeof(m_blurConstants), L"Blur Kernel");
+        m_blurConstantBuffer = m_blurConstantResource->GetGPUVirtualAddress();
+    }
 
-        // Create an event handle to use for frame synchronization.
-        m_fenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
-        if (m_fenceEvent == nullptr)
-        {
-            ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
-        }
+    if (!m_texturePath.empty())
+    {
+        LoadTexture();
+    }
+
+    // Wait until assets have been uploaded to the GPU.
+    {
+        // The direct queue waits for the copies on the GPU, not the CPU.
+        m_bufferUploader->QueueWait(m_commandQueue.Get(), m_bufferUploader->Flush());
 
-        // Wait for the command list to execute; we are reusing the same command 
-        // list in our main loop but for now, we just want to wait for setup to 
-        // complete before continuing.
-        WaitForPreviousFrame();
+        // Wait for the setup work to complete before opening the first frame.
+        m_frameScheduler->WaitForIdle();
+        m_frameIndex = m_frameScheduler->BeginFrame();
+        m_gpuProfiler->BeginFrame(m_frameIndex);
     }
 }
 
-// Update frame-based values.
-void D3D12HelloTriangle::OnUpdate()
+// Open the DDS file of the triangles and create their texture, the frames
+// stream its mips in.
+void D3D12HelloTriangle::LoadTexture()
 {
-    // update app logic, such as moving the camera or figuring out what objects are in view
-    static float rIncrement = 0.002f;
-    static float gIncrement = 0.006f;
-    static float bIncrement = 0.009f;
+    char buff[512] = {};
+    const std::string path = WideToUtf8(m_texturePath);
+    if (!m_textureFile.Open(path))
+    {
+        sprintf_s(buff, "Texture: cannot read %s\n", path.c_str());
+        OutputDebugStringA(buff);
+        return;
+    }
+
+    // The loader reads every kind of DDS texture, the triangles sample a single 2D one.
+    const DdsResult result = m_textureData.Parse(m_textureFile.GetData(), m_textureFile.GetSize());
+    const TextureDesc& desc = m_textureData.GetDesc();
+    if (result != DdsResultOk || desc.dimension != TextureDimension2D || desc.arraySize != 1)
+    {
+        sprintf_s(buff, "Texture: %s is %s\n", path.c_str(), result != DdsResultOk ? GetDdsResultName(result) : "not a single 2D texture");
+        OutputDebugStringA(buff);
+        m_textureFile.Close();
+        return;
+    }
+
+    m_texture = m_bufferUploader->CreateTexture(desc, L"Triangle Texture");
+    m_textureStreamer.reset(new TextureStreamer(m_bufferUploader->GetUploader(), m_textureData, m_texture.Get()));
+
+    // The coarse mips go out with the vertex buffers, the first frame samples them.
+    m_textureStreamer->Update(TextureStreamBudget);
+
+    sprintf_s(buff, "Texture: %s, %ux%u, format %u, %u mips, %s\n", path.c_str(), desc.width, desc.height, desc.format, desc.mipCount,
+        m_textureFile.IsMapped() ? "mapped" : "read in chunks");
+    OutputDebugStringA(buff);
+}
 
-    m_shaderData.solidColor.x += rIncrement;
-    m_shaderData.solidColor.y += gIncrement;
-    m_shaderData.solidColor.z += bIncrement;
+// Describe the compile of a shader asset with the flags of this build.
+ShaderCompileRequest D3D12HelloTriangle::GetShaderRequest(LPCWSTR assetName, const char* entryPoint, const char* target)
+{
+#if defined(_DEBUG)
+    // Enable better shader debugging with the graphics debugging tools.
+    UINT compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+    UINT compileFlags = 0;
+#endif
+
+    ShaderCompileRequest request;
+    request.sourcePath = WideToUtf8(GetAssetFullPath(assetName));
+    request.entryPoint = entryPoint;
+    request.target = target;
+    request.flags = compileFlags;
+    return request;
+}
+
+// Get the bytecode of a shader, compiling it only if the cache has no up to date copy.
+D3D12_SHADER_BYTECODE D3D12HelloTriangle::LoadShader(LPCWSTR assetName, const char* entryPoint, const char* target)
+{
+    return ToShaderBytecode(m_shaderCache->Get(GetShaderRequest(assetName, entryPoint, target)));
+}
+
+void D3D12HelloTriangle::CreateRootSignature(const RootSignatureLayout& layout, ComPtr<ID3D12RootSignature>& rootSignature, UINT64& rootSignatureHash)
+{
+    rootSignature = m_rootSignatureCache->Create(layout, &rootSignatureHash);
+
+    char buff[256] = {};
+    sprintf_s(buff, "Root signature: %s\n", layout.Describe().c_str());
+    OutputDebugStringA(buff);
+}
+
+// Create a pipeline state from its cached blob, or from scratch if the cache has none.
+void D3D12HelloTriangle::CreatePipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ComPtr<ID3D12PipelineState>& pipelineState)
+{
+    D3D12GraphicsPipelineBuilder builder(m_device.Get(), desc);
+    m_pipelineCache->Create(HashGraphicsPipelineDesc(desc, m_rootSignatureHash), builder);
+    pipelineState = builder.GetPipelineState();
+}
+
+void D3D12HelloTriangle::CreatePipelineState(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, UINT64 rootSignatureHash, ComPtr<ID3D12PipelineState>& pipelineState)
+{
+    D3D12ComputePipelineBuilder builder(m_device.Get(), desc);
+    m_pipelineCache->Create(HashComputePipelineDesc(desc, rootSignatureHash), builder);
+    pipelineState = builder.GetPipelineState();
+}
+
+// Advance the simulation by one fixed step.
+void D3D12HelloTriangle::OnUpdate(double stepSeconds)
+{
+    ProfileScope scope(m_profiler.get(), "Update");
 
-    if (m_shaderData.solidColor.x >= 1.0 || m_shaderData.solidColor.x <= 0.0)
+    // The last step becomes the previous one, the packets interpolate between them.
+    std::copy(m_color, m_color + _countof(m_color), m_previousColor);
+    m_previousRotation.swap(m_rotation);
+
+    const float step = static_cast<float>(stepSeconds);
+    m_colorAnimation.Update(step, m_color);
+    m_instanceAnimation.Update(step, m_rotation.data());
+}
+
+// Interpolate the state of the frame into its packet slot, on the simulation thread.
+void D3D12HelloTriangle::OnPreparePacket(const FramePacket& packet)
+{
+    ProfileScope scope(m_profiler.get(), "Prepare");
+
+    FrameState& state = m_frameStates[packet.slot];
+    const float alpha = static_cast<float>(packet.alpha);
+    for (UINT channel = 0; channel < _countof(m_color); ++channel)
     {
-        m_shaderData.solidColor.x = m_shaderData.solidColor.x >= 1.0 ? 1.0 : 0.0;
-        rIncrement = -rIncrement;
+        state.color[channel] = m_previousColor[channel] + (m_color[channel] - m_previousColor[channel]) * alpha;
     }
-    if (m_shaderData.solidColor.y >= 1.0 || m_shaderData.solidColor.y <= 0.0)
+
+    // A rotation jumps back a full turn at the end of its cycle, the
+    // interpolation takes the short way round.
+    const float pi = 3.14159265f;
+    for (size_t i = 0; i < m_rotation.size(); ++i)
+    {
+        float delta = m_rotation[i] - m_previousRotation[i];
+        delta -= delta > pi ? 2.0f * pi : delta < -pi ? -2.0f * pi : 0.0f;
+        state.rotation[i] = m_previousRotation[i] + delta * alpha;
+    }
+}
+
+// Render the scene, on the render thread when there is one.
+void D3D12HelloTriangle::OnRender(const FramePacket& packet)
+{
     {
-        m_shaderData.solidColor.y = m_shaderData.solidColor.y >= 1.0 ? 1.0 : 0.0;
-        gIncrement = -gIncrement;
+        ProfileScope scope(m_profiler.get(), "Constants");
+        WriteFrameConstants(m_frameStates[packet.slot]);
     }
-    if (m_shaderData.solidColor.z >= 1.0 || m_shaderData.solidColor.z <= 0.0)
+
+    // Record all the commands we need to render the scene and execute them.
     {
-        m_shaderData.solidColor.z = m_shaderData.solidColor.z >= 1.0 ? 1.0 : 0.0;
-        bIncrement = -bIncrement;
+        ProfileScope scope(m_profiler.get(), "Record");
+        PopulateCommandList();
     }
 
-    // copy our ConstantBuffer instance to the mapped constant buffer resource
-    memcpy(m_writableAdresses[m_frameIndex], &m_shaderData, sizeof(ShaderData));
+    // Present the frame.
+    if (!m_headless)
+    {
+        ProfileScope scope(m_profiler.get(), "Present");
+        ThrowIfFailed(m_swapChain->Present(1, 0));
+    }
 
+    MoveToNextFrame();
 }
 
-// Render the scene.
-void D3D12HelloTriangle::OnRender()
+void D3D12HelloTriangle::WriteFrameConstants(FrameState& state)
 {
-    // Record all the commands we need to render the scene into the command list.
-    PopulateCommandList();
+    SampleFrameParams params = {};
+    params.width = m_width;
+    params.height = m_height;
+    params.sceneWidth = m_sceneWidth;
+    params.sceneHeight = m_sceneHeight;
+    std::copy(state.color, state.color + 3, params.color);
+
+    // The texture view covers the mips resident so far, the coarsest are in
+    // after the first frames. Without them the view is null and unused.
+    D3D12_SHADER_RESOURCE_VIEW_DESC textureViewDesc = {};
+    textureViewDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+    textureViewDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    textureViewDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+    textureViewDesc.Texture2D.MipLevels = 1;
+    ID3D12Resource* texture = nullptr;
+    if (m_textureStreamer)
+    {
+        ProfileScope textureScope(m_profiler.get(), "Texture");
+        m_textureStreamer->Update(TextureStreamBudget);
 
-    // Execute the command list.
-    ID3D12CommandList* ppCommandLists[] = { m_commandList.Get() };
-    m_commandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+        const TextureDesc& desc = m_textureData.GetDesc();
+        const UINT residentMip = m_textureStreamer->GetResidentMip();
+        if (residentMip < desc.mipCount)
+        {
+            texture = m_texture.Get();
+            textureViewDesc.Format = static_cast<DXGI_FORMAT>(desc.format);
+            textureViewDesc.Texture2D.MostDetailedMip = residentMip;
+            textureViewDesc.Texture2D.MipLevels = desc.mipCount - residentMip;
+            params.textured = true;
+        }
+    }
+    DescriptorHandle textureView = m_srvHeap->AllocateTransient(1);
+    m_device->CreateShaderResourceView(texture, &textureViewDesc, textureView.cpu);
+    m_textureView = textureView.gpu;
+
+    // The constants are set on the command lists of the frame, see SetRootConstantBuffer().
+    static_assert(sizeof(ShaderData) == sizeof(SoftwareShaderData), "ShaderData layout");
+    const SoftwareShaderData shaderData = GetSampleShaderData(params);
+    memcpy(&m_frameConstants, &shaderData, sizeof(m_frameConstants));
+
+    // Constants the root signature holds as a root CBV need a slice of the
+    // constant ring, which needs no view, only its address.
+    m_frameConstantBuffer = 0;
+    if (m_rootSignatureLayout.GetParameter(m_frameConstantsParameter).type == RootParameterCbv)
+    {
+        m_frameConstantBuffer = m_constantRing->AllocateConstants(m_frameConstants).gpuAddress;
+    }
 
-    // Present the frame.
-    ThrowIfFailed(m_swapChain->Present(1, 0));
+    // The visible instances go straight to the upload memory, and so do the
+    // draw arguments holding their count. The rotations of the packet are
+    // swapped in, its slot gets the old ones to overwrite next time.
+    {
+        ProfileScope cullScope(m_profiler.get(), "Instances");
+        m_instances.rotation.swap(state.rotation);
+
+        const UploadAllocation instances = m_constantRing->Allocate(m_instances.GetCount() * sizeof(InstanceData));
+        const UploadAllocation arguments = m_constantRing->Allocate(sizeof(IndirectDrawArguments));
+        const CullRect screen = { -1.0f, -1.0f, 1.0f, 1.0f };
+        m_visibleInstanceCount = CullInstances(m_instances, screen, m_instanceRadius,
+            static_cast<InstanceData*>(instances.cpuAddress), m_instances.GetCount(), 3, *static_cast<IndirectDrawArguments*>(arguments.cpuAddress));
+        m_instanceBuffer = instances.gpuAddress;
+        m_drawArgumentsOffset = arguments.offset;
+    }
+}
 
-    WaitForPreviousFrame();
+void D3D12HelloTriangle::WaitForIdle()
+{
+    m_frameScheduler->WaitForIdle();
 }
 
 void D3D12HelloTriangle::OnDestroy()
 {
     // Ensure that the GPU is no longer referencing resources that are about to be
     // cleaned up by the destructor.
-    WaitForPreviousFrame();
+    m_frameScheduler->WaitForIdle();
+
+    const ResourceStateTrackerStats barrierStats = m_stateTracker.GetTracker().GetStats();
+    char buff[256] = {};
+    sprintf_s(buff, "Barriers: %llu transitions requested, %llu dropped, %llu issued in %llu calls (%llu calls saved)\n",
+        barrierStats.transitionsRequested, barrierStats.transitionsDropped, barrierStats.barriersIssued,
+        barrierStats.barrierCalls, m_stateTracker.GetTracker().GetRemovedCallCount());
+    OutputDebugStringA(buff);
+
+    const CommandRecorderStats recorderStats = m_commandRecorder->GetStats();
+    sprintf_s(buff, "Recording: %u threads, %.1f lists per frame, %.3f ms per frame\n",
+        m_jobSystem->GetThreadCount(), recorderStats.frames ? static_cast<double>(recorderStats.lists) / recorderStats.frames : 0.0,
+        recorderStats.frames ? recorderStats.totalRecordMs / recorderStats.frames : 0.0);
+    OutputDebugStringA(buff);
+
+    sprintf_s(buff, "Instances: %u, %u visible in the last frame, %s culling\n",
+        m_instances.GetCount(), m_visibleInstanceCount, InstanceCullingHasSimd() ? "SSE2" : "scalar");
+    OutputDebugStringA(buff);
+
+    if (m_dynamicResolution)
+    {
+        sprintf_s(buff, "Dynamic resolution: %.1f ms budget, average scale %.3f, last %ux%u\n",
+            m_dynamicResolutionMs, m_frameNumber ? m_sceneScaleTotal / m_frameNumber : 1.0, m_sceneWidth, m_sceneHeight);
+        OutputDebugStringA(buff);
+    }
 
-    for (int i = 0; i < FrameCount; ++i)
+    if (m_textureStreamer)
     {
-        SAFE_RELEASE(m_descriptorHeap[i]);
-        SAFE_RELEASE(m_ressourcesMemory[i]);
-        m_renderTexture[i]->ReleaseDevice();
-        delete m_renderTexture[i];
-    };
+        const TextureStreamerStats textureStats = m_textureStreamer->GetStats();
+        sprintf_s(buff, "Texture: %u of %u mips, %llu KB in %llu updates, first mips resident after %u\n",
+            textureStats.mipsUploaded, m_textureData.GetDesc().mipCount, textureStats.bytes / 1024, textureStats.updates,
+            textureStats.firstResidentUpdate);
+        OutputDebugStringA(buff);
+    }
+
+    const BufferUploaderStats uploadStats = m_bufferUploader->GetStats();
+    sprintf_s(buff, "Uploads: %llu buffers and textures, %llu KB in %llu copies and %llu batches, %llu staging waits\n",
+        uploadStats.uploads, uploadStats.bytes / 1024, uploadStats.copies, uploadStats.submissions, uploadStats.stagingWaits);
+    OutputDebugStringA(buff);
+
+    // Rolling statistics of the last frames, the full trace on request.
+    for (const ProfilerSummary& summary : m_profiler->GetSummary())
+    {
+        sprintf_s(buff, "Profile: %-4s %-12s min %.3f ms, avg %.3f ms, p99 %.3f ms over %u frames\n",
+            summary.gpu ? "GPU" : "CPU", summary.name.c_str(), summary.minMs, summary.avgMs, summary.p99Ms, summary.samples);
+        OutputDebugStringA(buff);
+    }
+    if (m_writeTrace && !m_profiler->WriteChromeTrace(WideToUtf8(GetAssetFullPath(L"trace.json"))))
+    {
+        OutputDebugStringA("Failed to write the profiler trace\n");
+    }
+    if (m_writeTrace && m_dynamicResolution && !SaveDynamicResolutionTrace(WideToUtf8(GetAssetFullPath(L"dynres_trace.txt")),
+        m_dynamicResolutionTrace, "Full resolution GPU frame times of D3D12HelloTriangle, in ms."))
+    {
+        OutputDebugStringA("Failed to write the dynamic resolution trace\n");
+    }
+
+    // Every capture has completed after the wait, the last one is written out.
+    if (m_readback)
+    {
+        ReadCompletedCaptures();
+
+        const ReadbackRingStats readbackStats = m_readback->GetStats();
+        sprintf_s(buff, "Readback: %llu captures, %llu dropped, %.1f frames of latency, last frame %llu\n",
+            readbackStats.completedCaptures, readbackStats.droppedCaptures,
+            readbackStats.completedCaptures ? static_cast<double>(m_captureLatency) / readbackStats.completedCaptures : 0.0,
+            m_capturedFrame);
+        OutputDebugStringA(buff);
+
+        if (!m_captureImage.empty() && !WritePpm(WideToUtf8(GetAssetFullPath(L"capture.ppm")), m_captureImage, m_width, m_height))
+        {
+            OutputDebugStringA("Failed to write the captured frame\n");
+        }
+    }
+
+    // The reload thread stops, the GPU is done with the pipelines it replaced.
+    if (m_shaderReload)
+    {
+        const ShaderHotReloadStats reloadStats = m_shaderReload->GetStats();
+        sprintf_s(buff, "Shader reload: %llu file changes, %llu compiles (%llu failed), %llu pipelines rebuilt (%llu failed), %llu swapped in, last reload %.1f ms\n",
+            reloadStats.fileChanges, reloadStats.shaderCompiles, reloadStats.compileErrors, reloadStats.pipelineBuilds,
+            reloadStats.buildErrors, reloadStats.pipelineSwaps, reloadStats.lastReloadMs);
+        OutputDebugStringA(buff);
+        m_shaderReload.reset();
+    }
+
+    // Replaying the captured frames measures the CPU cost of decoding them,
+    // the file replays elsewhere.
+    if (m_commandCapture.GetFrameCount())
+    {
+        NullCommandStreamSink sink;
+        const std::chrono::steady_clock::time_point replayStart = std::chrono::steady_clock::now();
+        for (UINT i = 0; i < m_commandCapture.GetFrameCount(); ++i)
+        {
+            if (!m_commandCapture.Replay(i, sink))
+            {
+                OutputDebugStringA("Failed to replay a captured frame\n");
+                break;
+            }
+        }
+        const double replayMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - replayStart).count();
 
-    CloseHandle(m_fenceEvent);
+        const NullCommandStreamStats& replayStats = sink.GetStats();
+        sprintf_s(buff, "Command capture: %u frames, %llu KB, %llu commands (%llu draws, %llu dispatches, %llu barriers), %llu errors, replayed in %.3f ms\n",
+            m_commandCapture.GetFrameCount(), m_commandCapture.GetByteSize() / 1024, replayStats.commands, replayStats.draws,
+            replayStats.dispatches, replayStats.barriers, replayStats.errors, replayMs);
+        OutputDebugStringA(buff);
+
+        if (!m_commandCapture.Save(WideToUtf8(GetAssetFullPath(L"commands.cap"))))
+        {
+            OutputDebugStringA("Failed to write the command capture\n");
+        }
+        m_commandCapture.Clear();
+    }
+
+    m_renderGraphBackend.reset();
+    m_commandRecorder.reset();
+    m_commandListPool.reset();
+    m_jobSystem.reset();
+    m_gpuProfiler.reset();
+    m_readback.reset();
+    m_textureStreamer.reset();
+    m_bufferUploader.reset();
+
+    for (RenderTexture& outputTexture : m_outputTexture)
+    {
+        outputTexture.ReleaseDevice();
+    }
+    m_outputTexture.clear();
+
+    const TexturePoolStats poolStats = m_renderTargetPool->GetPool().GetStats();
+    sprintf_s(buff, "Render target pool: %llu acquires, %llu reused, %u heaps, peak %llu KB\n",
+        poolStats.acquires, poolStats.reuseHits, poolStats.heapCount, poolStats.peakHeapBytes / 1024);
+    OutputDebugStringA(buff);
+    m_renderTargets.clear();
+    m_renderTargetPool.reset();
+
+    m_constantRing.reset();
+    m_srvHeap.reset();
+    m_rtvHeap.reset();
+    m_frameScheduler.reset();
+    m_frameQueue.reset();
 }
 
 void D3D12HelloTriangle::PopulateCommandList()
 {
     // Command list allocators can only be reset when the associated 
-    // command lists have finished execution on the GPU; apps should use 
-    // fences to determine GPU execution progress.
-    ThrowIfFailed(m_commandAllocator->Reset());
+    // command lists have finished execution on the GPU; the frame scheduler
+    // already waited on this frame's fence in MoveToNextFrame().
+    m_commandListPool->SetFrameIndex(m_frameIndex);
 
-    // However, when ExecuteCommandList() is called on a particular command 
-    // list, that command list can then be reset at any time and must be before 
-    // re-recording.
-    ThrowIfFailed(m_commandList->Reset(m_commandAllocator.Get(), m_trianglePipelineState.Get()));
+    // Reloaded pipelines are swapped in before any pass can use them, the
+    // ones they replace are released after the GPU is done with this frame.
+    if (m_shaderReload)
+    {
+        m_shaderReload->Apply(m_frameScheduler->GetCurrentFenceValue(), m_frameScheduler->GetCompletedFenceValue());
+    }
+    m_commandListPool->SetCapture(m_frameNumber < m_commandCaptureFrames ? &m_commandCapture : nullptr);
+
+    // The graph places the barriers between the passes, including a split
+    // barrier taking the back buffer out of the present state. The passes are
+    // recorded on the job system and their lists executed in order.
+    m_renderGraphBackend->SetFrameIndex(m_frameIndex);
+    m_renderGraphBackend->BindImported(m_backBufferTexture, m_renderTargets[m_backBufferIndex].Get(), m_renderTargetRtv[m_backBufferIndex].cpu);
+    m_renderGraph.Execute(*m_renderGraphBackend, *m_commandRecorder);
+}
 
-    // Set necessary state.
-    m_commandList->SetGraphicsRootSignature(m_rootSignature.Get());
-    m_commandList->RSSetViewports(1, &m_viewport);
-    m_commandList->RSSetScissorRects(1, &m_scissorRect);
+void D3D12HelloTriangle::SetupCommandList(D3D12CapturingCommandList& commands)
+{
+    // Set necessary state, every list of the frame starts from scratch.
+    commands.SetGraphicsRootSignature(m_rootSignature.Get());
+    commands.RSSetViewports(1, &m_viewport);
+    commands.RSSetScissorRects(1, &m_scissorRect);
 
     // Set descriptors Heaps
-    ID3D12DescriptorHeap* descriptorHeaps[] = { m_descriptorHeap[m_frameIndex].Get() };
-    m_commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
-    m_commandList->SetGraphicsRootDescriptorTable(0, m_descriptorHeap[m_frameIndex]->GetGPUDescriptorHandleForHeapStart());
-
-    // -------------------------------- Draw Triangle 
-    m_renderTexture[m_frameIndex]->BeginScene(m_commandList.Get());
-    CD3DX12_CPU_DESCRIPTOR_HANDLE offscreenHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_frameIndex + 2, m_rtvDescriptorSize);
-    m_commandList->OMSetRenderTargets(1, &offscreenHandle, FALSE, nullptr);
-
-    m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    m_commandList->SetPipelineState(m_trianglePipelineState.Get());
-    m_commandList->IASetVertexBuffers(0, 1, &m_triangleVertexBufferView);
-    m_commandList->DrawInstanced(3, 1, 0, 0);
-
-    m_renderTexture[m_frameIndex]->EndScene(m_commandList.Get());
-
-    // -------------------------------- Draw Quad 
-    // Indicate that the back buffer will be used as a render target.
-    m_commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_renderTargets[m_frameIndex].Get(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
-
-    CD3DX12_CPU_DESCRIPTOR_HANDLE rtvHandle(m_rtvHeap->GetCPUDescriptorHandleForHeapStart(), m_frameIndex, m_rtvDescriptorSize);
-    m_commandList->OMSetRenderTargets(1, &rtvHandle, FALSE, nullptr);
-
-    // Record commands.
-    const float clearColor[] = { 0.0f, 0.2f, 0.4f, 1.0f };
-    m_commandList->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
-    m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    m_commandList->SetPipelineState(m_quadPipelineState.Get());
-    m_commandList->IASetVertexBuffers(0, 1, &m_quadVertexBufferView);
-    m_commandList->DrawInstanced(6, 1, 0, 0);
-
-    // -------------------------------- Present frame
-    // Indicate that the back buffer will now be used to present.
-    m_commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_renderTargets[m_frameIndex].Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
-
-    ThrowIfFailed(m_commandList->Close());
+    ID3D12DescriptorHeap* descriptorHeaps[] = { m_srvHeap->GetHeap() };
+    commands.SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+    SetRootConstantBuffer(commands, false, m_rootSignatureLayout, m_frameConstantsParameter, &m_frameConstants, m_frameConstantBuffer);
+}
+
+// Set the constants of a constant buffer parameter, copied into the root or
+// through the address of the buffer holding them.
+void D3D12HelloTriangle::SetRootConstantBuffer(D3D12CapturingCommandList& commands, bool compute, const RootSignatureLayout& layout, UINT index,
+    const void* data, D3D12_GPU_VIRTUAL_ADDRESS address)
+{
+    const RootParameterDesc& parameter = layout.GetParameter(index);
+    if (parameter.type == RootParameterConstants)
+    {
+        if (compute)
+        {
+            commands.SetComputeRoot32BitConstants(index, parameter.count, data, 0);
+        }
+        else
+        {
+            commands.SetGraphicsRoot32BitConstants(index, parameter.count, data, 0);
+        }
+    }
+    else if (compute)
+    {
+        commands.SetComputeRootConstantBufferView(index, address);
+    }
+    else
+    {
+        commands.SetGraphicsRootConstantBufferView(index, address);
+    }
+}
+
+void D3D12HelloTriangle::BuildRenderGraph()
+{
+    m_renderGraphBackend.reset(new D3D12RenderGraphBackend(m_device.Get(), *m_commandListPool, m_stateTracker, *m_rtvHeap, *m_srvHeap, m_framesInFlight));
+    m_renderGraphBackend->SetProfiler(m_gpuProfiler.get());
+
+    RenderGraphTextureDesc sceneDesc = { m_width, m_height, DXGI_FORMAT_R8G8B8A8_UNORM, false, { 0.1f, 0.1f, 1.0f, 1.0f } };
+    m_sceneTexture = m_renderGraph.CreateTexture("Scene", sceneDesc);
+
+    // Headless targets go through the present state as well, so both paths share the graph.
+    m_backBufferTexture = m_renderGraph.ImportTexture("BackBuffer", D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+
+    const uint32_t trianglePass = m_renderGraph.AddPass("Triangle", [this](uint32_t list)
+    {
+        RecordTrianglePass(m_commandListPool->GetCommands(list));
+    });
+    m_renderGraph.Write(trianglePass, m_sceneTexture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    // Separable blur, rows into a temporary texture then columns. A radius of
+    // 0 leaves the blur out of the frame.
+    m_displayTexture = m_sceneTexture;
+    if (m_blurRadius > 0)
+    {
+        RenderGraphTextureDesc blurDesc = sceneDesc;
+        blurDesc.allowUnorderedAccess = true;
+        m_blurTempTexture = m_renderGraph.CreateTexture("BlurTemp", blurDesc);
+        m_blurredTexture = m_renderGraph.CreateTexture("Blurred", blurDesc);
+
+        const uint32_t blurRowsPass = m_renderGraph.AddPass("BlurRows", [this](uint32_t list)
+        {
+            RecordBlurPass(m_commandListPool->GetCommands(list), m_sceneTexture, m_blurTempTexture, false);
+        });
+        m_renderGraph.Read(blurRowsPass, m_sceneTexture, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        m_renderGraph.Write(blurRowsPass, m_blurTempTexture, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+        const uint32_t blurColumnsPass = m_renderGraph.AddPass("BlurColumns", [this](uint32_t list)
+        {
+            RecordBlurPass(m_commandListPool->GetCommands(list), m_blurTempTexture, m_blurredTexture, true);
+        });
+        m_renderGraph.Read(blurColumnsPass, m_blurTempTexture, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+        m_renderGraph.Write(blurColumnsPass, m_blurredTexture, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+
+        m_displayTexture = m_blurredTexture;
+    }
+
+    const uint32_t quadPass = m_renderGraph.AddPass("Quad", [this](uint32_t list)
+    {
+        RecordQuadPass(m_commandListPool->GetCommands(list));
+    });
+    m_renderGraph.Read(quadPass, m_displayTexture, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+    m_renderGraph.Write(quadPass, m_backBufferTexture, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+    // The copy to the readback ring, its result leaves the graph.
+    if (m_readback)
+    {
+        const uint32_t capturePass = m_renderGraph.AddPass("Capture", [this](uint32_t list)
+        {
+            RecordCapturePass(m_commandListPool->GetCommands(list));
+        });
+        m_renderGraph.Read(capturePass, m_backBufferTexture, D3D12_RESOURCE_STATE_COPY_SOURCE);
+        m_renderGraph.SetSideEffect(capturePass);
+    }
+
+    m_renderGraph.Compile(*m_renderGraphBackend);
+
+    const RenderGraphStats& stats = m_renderGraph.GetStats();
+    char buff[256] = {};
+    sprintf_s(buff, "Render graph: %u passes (%u culled), %u barriers, transient heap %llu KB (%llu KB unaliased), compiled in %.3f ms\n",
+        stats.passCount, stats.culledPassCount, stats.barrierCount,
+        stats.transientHeapSize / 1024, stats.unaliasedSize / 1024, stats.compileMs);
+    OutputDebugStringA(buff);
+}
+
+void D3D12HelloTriangle::RecordTrianglePass(D3D12CapturingCommandList& commands)
+{
+    // The render graph discards the texture before this pass, which is what
+    // initializes its aliased memory. Only the scaled corner is cleared and
+    // drawn to, the passes after this one never read the rest.
+    D3D12_CPU_DESCRIPTOR_HANDLE offscreenHandle = m_renderGraphBackend->GetRtv(m_sceneTexture);
+    commands.OMSetRenderTargets(1, &offscreenHandle, nullptr);
+    commands.ClearRenderTargetView(offscreenHandle, SampleSceneClearColor, 1, &m_sceneScissorRect);
+    commands.RSSetViewports(1, &m_sceneViewport);
+    commands.RSSetScissorRects(1, &m_sceneScissorRect);
+
+    commands.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    commands.SetPipelineState(m_trianglePipelineState.Get());
+    commands.IASetVertexBuffers(0, 1, &m_triangleVertexBufferView);
+    commands.SetGraphicsRootDescriptorTable(m_textureParameter, m_textureView);
+    commands.SetGraphicsRootShaderResourceView(m_instancesParameter, m_instanceBuffer);
+    commands.ExecuteIndirect(m_drawSignature.Get(), 1, m_constantRing->GetResource(), m_drawArgumentsOffset, nullptr, 0);
+}
+
+void D3D12HelloTriangle::RecordBlurPass(D3D12CapturingCommandList& commands, RenderGraphResource source, RenderGraphResource destination, bool vertical)
+{
+    commands.SetComputeRootSignature(m_blurRootSignature.Get());
+    commands.SetPipelineState(m_blurPipelineState.Get());
+    SetRootConstantBuffer(commands, true, m_blurRootSignatureLayout, m_blurKernelParameter, &m_blurConstants, m_blurConstantBuffer);
+
+    const INT constants[] = { vertical ? 0 : 1, vertical ? 1 : 0, static_cast<INT>(m_sceneWidth), static_cast<INT>(m_sceneHeight) };
+    commands.SetComputeRoot32BitConstants(m_blurPassParameter, _countof(constants), constants, 0);
+    commands.SetComputeRootDescriptorTable(m_blurSourceParameter, m_renderGraphBackend->GetSrv(source));
+    commands.SetComputeRootDescriptorTable(m_blurDestinationParameter, m_renderGraphBackend->GetUav(destination));
+
+    // A group blurs BlurGroupSize pixels of one row or column of the scaled scene.
+    const UINT length = vertical ? m_sceneHeight : m_sceneWidth;
+    const UINT lines = vertical ? m_sceneWidth : m_sceneHeight;
+    commands.Dispatch((length + BlurGroupSize - 1) / BlurGroupSize, lines, 1);
+}
+
+void D3D12HelloTriangle::RecordQuadPass(D3D12CapturingCommandList& commands)
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = m_renderGraphBackend->GetRtv(m_backBufferTexture);
+    commands.OMSetRenderTargets(1, &rtvHandle, nullptr);
+    commands.RSSetViewports(1, &m_viewport);
+    commands.RSSetScissorRects(1, &m_scissorRect);
+
+    commands.ClearRenderTargetView(rtvHandle, SampleClearColor, 0, nullptr);
+    commands.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    commands.SetPipelineState(m_quadPipelineState.Get());
+    commands.SetGraphicsRootDescriptorTable(m_textureParameter, m_renderGraphBackend->GetSrv(m_displayTexture));
+    commands.IASetVertexBuffers(0, 1, &m_quadVertexBufferView);
+    commands.DrawInstanced(6, 1, 0, 0);
 }
 
-void D3D12HelloTriangle::WaitForPreviousFrame()
+void D3D12HelloTriangle::RecordCapturePass(D3D12CapturingCommandList& commands)
 {
-    // WAITING FOR THE FRAME TO COMPLETE BEFORE CONTINUING IS NOT BEST PRACTICE.
-    // This is code implemented as such for simplicity. The D3D12HelloFrameBuffering
-    // sample illustrates how to use fences for efficient resource usage and to
-    // maximize GPU utilization.
+    if (m_frameNumber % m_captureInterval != 0)
+    {
+        return;
+    }
+
+    // A full ring drops the capture rather than waiting for the GPU.
+    if (m_headless)
+    {
+        m_readback->Capture(commands.GetCommandList(), m_outputTexture[m_backBufferIndex], m_frameNumber);
+    }
+    else
+    {
+        m_readback->Capture(commands.GetCommandList(), m_renderTargets[m_backBufferIndex].Get(), m_frameNumber);
+    }
+}
 
-    // Signal and increment the fence value.
-    const UINT64 fence = m_fenceValue;
-    ThrowIfFailed(m_commandQueue->Signal(m_fence.Get(), fence));
-    m_fenceValue++;
+void D3D12HelloTriangle::ReadCompletedCaptures()
+{
+    if (!m_readback)
+    {
+        return;
+    }
 
-    // Wait until the previous frame is finished.
-    if (m_fence->GetCompletedValue() < fence)
+    // The views point into the mapped readback buffer, the rows are only
+    // copied out to drop their padding.
+    ReadbackView view;
+    while (m_readback->TryGetCompleted(view))
     {
-        ThrowIfFailed(m_fence->SetEventOnCompletion(fence, m_fenceEvent));
-        WaitForSingleObject(m_fenceEvent, INFINITE);
+        m_captureImage.resize(static_cast<size_t>(view.rowSize) * view.rowCount);
+        view.CopyRows(m_captureImage.data(), view.rowSize);
+        m_capturedFrame = view.frame;
+        m_captureLatency += m_frameNumber - view.frame;
+        m_readback->Release(view);
     }
+}
 
-    m_frameIndex = m_swapChain->GetCurrentBackBufferIndex();
+void D3D12HelloTriangle::UpdateSceneSize()
+{
+    // The GPU time comes from the frame that last used this slot, rendered
+    // at the scale it was given then.
+    double scale = 1.0;
+    if (m_dynamicResolution)
+    {
+        const double gpuMs = m_gpuProfiler->GetLastFrameGpuMs();
+        const double slotScale = m_sceneSlotScales[m_frameIndex];
+        scale = m_dynamicResolution->Update(gpuMs, slotScale);
+
+        // With -trace the time is also kept at full resolution, for
+        // SimulateDynamicResolution. The passes that do not scale are divided
+        // by the area too, the estimate is a bit high.
+        if (m_writeTrace && gpuMs > 0.0)
+        {
+            m_dynamicResolutionTrace.push_back(gpuMs / (slotScale * slotScale));
+        }
+    }
+    m_sceneScaleTotal += scale;
+
+    // The size only changes the viewport and the dispatches, the textures
+    // keep their full size and nothing is reallocated.
+    DynamicResolutionController::GetScaledSize(scale, m_width, m_height, SceneSizeAlignment, m_sceneWidth, m_sceneHeight);
+    m_sceneViewport = CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(m_sceneWidth), static_cast<float>(m_sceneHeight));
+    m_sceneScissorRect = CD3DX12_RECT(0, 0, static_cast<LONG>(m_sceneWidth), static_cast<LONG>(m_sceneHeight));
+
+    // The scale of the pixels actually rendered, after the rounding.
+    if (m_dynamicResolution)
+    {
+        m_sceneSlotScales[m_frameIndex] = std::sqrt(static_cast<double>(m_sceneWidth) * m_sceneHeight / (static_cast<double>(m_width) * m_height));
+    }
+}
+
+void D3D12HelloTriangle::MoveToNextFrame()
+{
+    // Signal the fence for the frame we just submitted, then wait for the next
+    // frame slot. This only blocks when the CPU is m_framesInFlight frames
+    // ahead of the GPU.
+    const UINT64 fenceValue = m_frameScheduler->EndFrame();
+    m_constantRing->FinishFrame(fenceValue);
+    m_srvHeap->FinishFrame(fenceValue);
+    if (m_readback)
+    {
+        m_readback->FinishFrame(fenceValue);
+    }
+
+    {
+        ProfileScope scope(m_profiler.get(), "FrameWait");
+        m_frameIndex = m_frameScheduler->BeginFrame();
+    }
+    m_constantRing->ReleaseCompleted();
+    m_srvHeap->ReleaseCompleted();
+    m_renderTargetPool->ReleaseCompleted();
+    m_frameNumber++;
+    ReadCompletedCaptures();
+
+    // The timestamps of the frame that last used this slot are ready now.
+    m_gpuProfiler->BeginFrame(m_frameIndex);
+    m_profiler->EndFrame();
+    UpdateSceneSize();
+
+    m_backBufferIndex = m_headless ? m_frameIndex : m_swapChain->GetCurrentBackBufferIndex();
 }
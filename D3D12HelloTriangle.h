@@ -13,6 +13,31 @@
 
 #include "DXSample.h"
 #include "RenderTexture.h"
+#include "FrameScheduler.h"
+#include "D3D12FrameQueue.h"
+#include "UploadHeapRing.h"
+#include "ShaderCache.h"
+#include "D3DShaderCompiler.h"
+#include "D3D12PipelineCache.h"
+#include "D3D12RootSignatureCache.h"
+#include "D3D12ShaderHotReload.h"
+#include "D3D12DescriptorHeap.h"
+#include "D3D12ResourceStateTracker.h"
+#include "D3D12RenderGraphBackend.h"
+#include "D3D12CommandListPool.h"
+#include "BlurFilter.h"
+#include "D3D12GpuProfiler.h"
+#include "D3D12TextureReadback.h"
+#include "D3D12BufferUploader.h"
+#include "DynamicResolution.h"
+#include "InstanceCulling.h"
+#include "TextureStreamer.h"
+#include "AnimationSystem.h"
+#include "SampleFrame.h"
+#include "Hash.h"
+
+#include <memory>
+#include <vector>
 
 using namespace DirectX;
 
@@ -24,10 +49,21 @@ using namespace DirectX;
 using Microsoft::WRL::ComPtr;
 
 
+// Root constants, or a 256-byte aligned slice of the constant ring behind a root
+// CBV, either way the struct does not need padding.
 struct ShaderData
 {
     XMFLOAT4 solidColor;
-    float padding[60]; // Padding so the constant buffer is 256-byte aligned.
+    XMFLOAT4 sceneUv;       // Scale to the rendered part of the scene, then the largest UV to sample.
+    XMFLOAT4 textureWeight; // x: how much of the triangle color comes from its texture.
+};
+
+// BlurKernel constant buffer of blur.hlsl, weights packed four per register.
+struct BlurConstants
+{
+    UINT radius;
+    UINT padding[3];
+    UINT weights[(BlurKernel::MaxTapCount + 3) / 4 * 4];
 };
 
 class D3D12HelloTriangle : public DXSample
@@ -36,12 +72,32 @@ public:
     D3D12HelloTriangle(UINT width, UINT height, std::wstring name);
 
     virtual void OnInit();
-    virtual void OnUpdate();
-    virtual void OnRender();
+    virtual void OnUpdate(double stepSeconds);
+    virtual void OnPreparePacket(const FramePacket& packet);
+    virtual void OnRender(const FramePacket& packet);
     virtual void OnDestroy();
+    virtual void WaitForIdle();
 
 private:
-    static const UINT FrameCount = 2;
+    // Constant ring budget for each frame in flight.
+    static const UINT ConstantRingFrameSize = 1024 * 1024;
+
+    // Staging ring of the copy queue filling the static buffers and textures.
+    static const UINT UploadStagingSize = 4 * 1024 * 1024;
+
+    // Texture bytes uploaded per frame, a mip goes out whole past it.
+    static const UINT TextureStreamBudget = 2 * 1024 * 1024;
+
+    // Descriptor heap budgets. The transient region is shared by all the frames in flight.
+    static const UINT SrvHeapPersistentCount = 256;
+    static const UINT SrvHeapTransientCount = 4096;
+    static const UINT RtvHeapCount = 64;
+
+    // Threads per blur group, GROUP_SIZE in blur.hlsl.
+    static const UINT BlurGroupSize = 256;
+
+    // Granularity of the dynamic resolution scene size, in pixels.
+    static const UINT SceneSizeAlignment = 8;
 
     struct Vertex
     {
@@ -60,42 +116,167 @@ private:
     CD3DX12_RECT m_scissorRect;
     ComPtr<IDXGISwapChain3> m_swapChain;
     ComPtr<ID3D12Device> m_device;
-    ComPtr<ID3D12Resource> m_renderTargets[FrameCount];
+    std::vector<ComPtr<ID3D12Resource>> m_renderTargets;
+    std::vector<DescriptorHandle> m_renderTargetRtv;
+    UINT m_backBufferCount;
+
+    // Headless output targets, standing in for the swap chain buffers. Their
+    // memory comes from the render target pool.
+    std::unique_ptr<D3D12RenderTargetPool> m_renderTargetPool;
+    std::vector<RenderTexture> m_outputTexture;
 
-    // Deferred Ressources
-    RenderTexture* m_renderTexture[FrameCount];
+    // Frame passes, the deferred texture is a transient of the graph.
+    RenderGraph m_renderGraph;
+    RenderGraphResource m_sceneTexture;
+    RenderGraphResource m_blurTempTexture;
+    RenderGraphResource m_blurredTexture;
+    RenderGraphResource m_displayTexture;
+    RenderGraphResource m_backBufferTexture;
 
-    // Shader Ressources
-    ComPtr<ID3D12DescriptorHeap> m_descriptorHeap[FrameCount];
-    ComPtr<ID3D12Resource> m_ressourcesMemory[FrameCount];
-    ComPtr<ID3D12Resource> m_uploadResourceHeap;
-    UINT8* m_writableAdresses[FrameCount];
-    ShaderData m_shaderData;
+    // The scene textures are allocated at the output size and rendered in
+    // their top left corner, at the size the dynamic resolution picks from
+    // the GPU frame time. The quad pass upscales it.
+    std::unique_ptr<DynamicResolutionController> m_dynamicResolution;
+    UINT m_sceneWidth;
+    UINT m_sceneHeight;
+    double m_sceneScaleTotal;
+    std::vector<double> m_sceneSlotScales;          // Scale of the frame in each slot.
+    std::vector<double> m_dynamicResolutionTrace;   // Full resolution GPU ms, with -trace.
+    CD3DX12_VIEWPORT m_sceneViewport;
+    CD3DX12_RECT m_sceneScissorRect;
+
+    // Shader Ressources.
+    std::unique_ptr<D3D12DescriptorHeap> m_srvHeap;
+    std::unique_ptr<UploadHeapRing> m_constantRing;
+    // The constants of the frame being recorded, the ring slice they were
+    // copied to is only used if the root signature holds them as a CBV.
+    ShaderData m_frameConstants;
+    D3D12_GPU_VIRTUAL_ADDRESS m_frameConstantBuffer;
+    // The blur weights, in a DEFAULT buffer uploaded once unless they fit in the root.
+    BlurConstants m_blurConstants;
+    D3D12_GPU_VIRTUAL_ADDRESS m_blurConstantBuffer;
 
-    ComPtr<ID3D12CommandAllocator> m_commandAllocator;
     ComPtr<ID3D12CommandQueue> m_commandQueue;
+    std::unique_ptr<D3D12RootSignatureCache> m_rootSignatureCache;
+    RootSignatureLayout m_rootSignatureLayout;
     ComPtr<ID3D12RootSignature> m_rootSignature;
-    ComPtr<ID3D12DescriptorHeap> m_rtvHeap;
+
+    // Root parameter indices of the signatures, as RootSignatureBuilder returned them.
+    UINT m_frameConstantsParameter;
+    UINT m_textureParameter;
+    UINT m_instancesParameter;
+    UINT m_blurKernelParameter;
+    UINT m_blurPassParameter;
+    UINT m_blurSourceParameter;
+    UINT m_blurDestinationParameter;
+
+    std::unique_ptr<D3D12DescriptorHeap> m_rtvHeap;
     ComPtr<ID3D12PipelineState> m_trianglePipelineState;
     ComPtr<ID3D12PipelineState> m_quadPipelineState;
-    ComPtr<ID3D12GraphicsCommandList> m_commandList;
-    UINT m_srvDescriptorSize;
-    UINT m_rtvDescriptorSize;
+    RootSignatureLayout m_blurRootSignatureLayout;
+    ComPtr<ID3D12RootSignature> m_blurRootSignature;
+    ComPtr<ID3D12PipelineState> m_blurPipelineState;
+    std::unique_ptr<ShaderCache> m_shaderCache;
+    std::unique_ptr<PipelineStateCache> m_pipelineCache;
 
-    // App resources.
+    // Rebuilds the pipeline states above when their shaders change, see -hotreload.
+    std::unique_ptr<D3D12ShaderHotReload> m_shaderReload;
+    UINT64 m_rootSignatureHash;
+    UINT64 m_blurRootSignatureHash;
+
+    // Passes are recorded in parallel, one command list per recording thread.
+    std::unique_ptr<JobSystem> m_jobSystem;
+    std::unique_ptr<D3D12CommandListPool> m_commandListPool;
+    std::unique_ptr<ParallelCommandRecorder> m_commandRecorder;
+
+    // CPU scopes and GPU timestamps of every pass.
+    std::unique_ptr<Profiler> m_profiler;
+    std::unique_ptr<D3D12GpuProfiler> m_gpuProfiler;
+
+    // CPU copies of the back buffer, see -capture. Only the latest one is kept.
+    std::unique_ptr<D3D12TextureReadback> m_readback;
+    std::vector<uint8_t> m_captureImage;
+    UINT64 m_capturedFrame;
+    UINT64 m_captureLatency;
+
+    // Command streams of the first frames, see -cmdcapture.
+    CommandCapture m_commandCapture;
+
+    // Resource states of the render targets, barriers are batched at each draw.
+    D3D12ResourceStateTracker m_stateTracker;
+    std::unique_ptr<D3D12RenderGraphBackend> m_renderGraphBackend;
+
+    // Simulation state, stepped by OnUpdate on the simulation thread. The last
+    // two steps are kept for the frame packets to interpolate between.
+    AnimationSystem m_colorAnimation;
+    AnimationSystem m_instanceAnimation;
+    float m_color[3];
+    float m_previousColor[3];
+    std::vector<float> m_rotation;
+    std::vector<float> m_previousRotation;
+
+    // What rendering a frame takes from the simulation, one per packet slot.
+    struct FrameState
+    {
+        float color[3];
+        std::vector<float> rotation;
+    };
+    FrameState m_frameStates[FramePacketSlotCount];
+
+    // Triangle instances, culled on the CPU every frame into a slice of the
+    // constant ring along with the arguments of their indirect draw. Their
+    // rotations come from the frame packet.
+    InstanceSet m_instances;
+    float m_instanceRadius;
+    UINT m_visibleInstanceCount;
+    D3D12_GPU_VIRTUAL_ADDRESS m_instanceBuffer;
+    UINT64 m_drawArgumentsOffset;
+    ComPtr<ID3D12CommandSignature> m_drawSignature;
+
+    // App resources, static geometry lives in DEFAULT heaps.
+    std::unique_ptr<D3D12BufferUploader> m_bufferUploader;
     ComPtr<ID3D12Resource> m_triangleVertexBuffer;
     D3D12_VERTEX_BUFFER_VIEW m_triangleVertexBufferView;
     ComPtr<ID3D12Resource> m_quadVertexBuffer;
     D3D12_VERTEX_BUFFER_VIEW m_quadVertexBufferView;
+    ComPtr<ID3D12Resource> m_blurConstantResource;
+
+    // Texture of the triangles, streamed from its mapped DDS file coarsest
+    // mip first. Each frame views the mips resident so far.
+    AssetFile m_textureFile;
+    DdsTexture m_textureData;
+    ComPtr<ID3D12Resource> m_texture;
+    std::unique_ptr<TextureStreamer> m_textureStreamer;
+    D3D12_GPU_DESCRIPTOR_HANDLE m_textureView;
 
     // Synchronization objects.
+    // m_frameIndex selects the per-frame resources of the frame being recorded,
+    // m_backBufferIndex the swap chain buffer it presents to.
     UINT m_frameIndex;
-    HANDLE m_fenceEvent;
-    ComPtr<ID3D12Fence> m_fence;
-    UINT64 m_fenceValue;
+    UINT m_backBufferIndex;
+    UINT64 m_frameNumber;
+    std::unique_ptr<D3D12FrameQueue> m_frameQueue;
+    std::unique_ptr<FrameScheduler> m_frameScheduler;
 
     void LoadPipeline();
     void LoadAssets();
+    ShaderCompileRequest GetShaderRequest(LPCWSTR assetName, const char* entryPoint, const char* target);
+    D3D12_SHADER_BYTECODE LoadShader(LPCWSTR assetName, const char* entryPoint, const char* target);
+    void CreateRootSignature(const RootSignatureLayout& layout, ComPtr<ID3D12RootSignature>& rootSignature, UINT64& rootSignatureHash);
+    void CreatePipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, ComPtr<ID3D12PipelineState>& pipelineState);
+    void CreatePipelineState(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, UINT64 rootSignatureHash, ComPtr<ID3D12PipelineState>& pipelineState);
+    void BuildRenderGraph();
+    void SetupCommandList(D3D12CapturingCommandList& commands);
+    void SetRootConstantBuffer(D3D12CapturingCommandList& commands, bool compute, const RootSignatureLayout& layout, UINT index,
+        const void* data, D3D12_GPU_VIRTUAL_ADDRESS address);
+    void RecordTrianglePass(D3D12CapturingCommandList& commands);
+    void RecordBlurPass(D3D12CapturingCommandList& commands, RenderGraphResource source, RenderGraphResource destination, bool vertical);
+    void RecordQuadPass(D3D12CapturingCommandList& commands);
+    void RecordCapturePass(D3D12CapturingCommandList& commands);
+    void ReadCompletedCaptures();
+    void UpdateSceneSize();
+    void LoadTexture();
+    void WriteFrameConstants(FrameState& state);
     void PopulateCommandList();
-    void WaitForPreviousFrame();
+    void MoveToNextFrame();
 };
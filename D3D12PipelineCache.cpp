@@ -0,0 +1,234 @@
+#include "stdafx.h"
+#include "D3D12PipelineCache.h"
+#include "DXSampleHelper.h"
+#include "Hash.h"
+
+namespace
+{
+    void HashShader(Hasher64& hasher, const D3D12_SHADER_BYTECODE& shader)
+    {
+        hasher.UpdateValue(static_cast<uint64_t>(shader.BytecodeLength));
+        if (shader.pShaderBytecode)
+        {
+            hasher.Update(shader.pShaderBytecode, shader.BytecodeLength);
+        }
+    }
+
+    bool CopyCachedBlob(ID3D12PipelineState* pipelineState, std::vector<uint8_t>& blob)
+    {
+        Microsoft::WRL::ComPtr<ID3DBlob> cachedBlob;
+        if (!pipelineState || FAILED(pipelineState->GetCachedBlob(&cachedBlob)))
+        {
+            return false;
+        }
+
+        const uint8_t* data = static_cast<const uint8_t*>(cachedBlob->GetBufferPointer());
+        blob.assign(data, data + cachedBlob->GetBufferSize());
+        return true;
+    }
+
+    void HashString(Hasher64& hasher, LPCSTR text)
+    {
+        hasher.UpdateString(text ? std::string(text) : std::string());
+    }
+
+    // Structures with padding are hashed member by member, the padding bytes
+    // are not guaranteed to be initialized.
+    void HashBlendState(Hasher64& hasher, const D3D12_BLEND_DESC& blend)
+    {
+        hasher.UpdateValue(blend.AlphaToCoverageEnable);
+        hasher.UpdateValue(blend.IndependentBlendEnable);
+        for (const D3D12_RENDER_TARGET_BLEND_DESC& target : blend.RenderTarget)
+        {
+            hasher.UpdateValue(target.BlendEnable);
+            hasher.UpdateValue(target.LogicOpEnable);
+            hasher.UpdateValue(target.SrcBlend);
+            hasher.UpdateValue(target.DestBlend);
+            hasher.UpdateValue(target.BlendOp);
+            hasher.UpdateValue(target.SrcBlendAlpha);
+            hasher.UpdateValue(target.DestBlendAlpha);
+            hasher.UpdateValue(target.BlendOpAlpha);
+            hasher.UpdateValue(target.LogicOp);
+            hasher.UpdateValue(target.RenderTargetWriteMask);
+        }
+    }
+
+    void HashStencilOp(Hasher64& hasher, const D3D12_DEPTH_STENCILOP_DESC& op)
+    {
+        hasher.UpdateValue(op.StencilFailOp);
+        hasher.UpdateValue(op.StencilDepthFailOp);
+        hasher.UpdateValue(op.StencilPassOp);
+        hasher.UpdateValue(op.StencilFunc);
+    }
+
+    void HashDepthStencilState(Hasher64& hasher, const D3D12_DEPTH_STENCIL_DESC& depthStencil)
+    {
+        hasher.UpdateValue(depthStencil.DepthEnable);
+        hasher.UpdateValue(depthStencil.DepthWriteMask);
+        hasher.UpdateValue(depthStencil.DepthFunc);
+        hasher.UpdateValue(depthStencil.StencilEnable);
+        hasher.UpdateValue(depthStencil.StencilReadMask);
+        hasher.UpdateValue(depthStencil.StencilWriteMask);
+        HashStencilOp(hasher, depthStencil.FrontFace);
+        HashStencilOp(hasher, depthStencil.BackFace);
+    }
+
+    void HashRasterizerState(Hasher64& hasher, const D3D12_RASTERIZER_DESC& rasterizer)
+    {
+        hasher.UpdateValue(rasterizer.FillMode);
+        hasher.UpdateValue(rasterizer.CullMode);
+        hasher.UpdateValue(rasterizer.FrontCounterClockwise);
+        hasher.UpdateValue(rasterizer.DepthBias);
+        hasher.UpdateValue(rasterizer.DepthBiasClamp);
+        hasher.UpdateValue(rasterizer.SlopeScaledDepthBias);
+        hasher.UpdateValue(rasterizer.DepthClipEnable);
+        hasher.UpdateValue(rasterizer.MultisampleEnable);
+        hasher.UpdateValue(rasterizer.AntialiasedLineEnable);
+        hasher.UpdateValue(rasterizer.ForcedSampleCount);
+        hasher.UpdateValue(rasterizer.ConservativeRaster);
+    }
+
+    void HashInputLayout(Hasher64& hasher, const D3D12_INPUT_LAYOUT_DESC& inputLayout)
+    {
+        hasher.UpdateValue(inputLayout.NumElements);
+        for (UINT i = 0; i < inputLayout.NumElements; ++i)
+        {
+            const D3D12_INPUT_ELEMENT_DESC& element = inputLayout.pInputElementDescs[i];
+            HashString(hasher, element.SemanticName);
+            hasher.UpdateValue(element.SemanticIndex);
+            hasher.UpdateValue(element.Format);
+            hasher.UpdateValue(element.InputSlot);
+            hasher.UpdateValue(element.AlignedByteOffset);
+            hasher.UpdateValue(element.InputSlotClass);
+            hasher.UpdateValue(element.InstanceDataStepRate);
+        }
+    }
+
+    void HashStreamOutput(Hasher64& hasher, const D3D12_STREAM_OUTPUT_DESC& streamOutput)
+    {
+        hasher.UpdateValue(streamOutput.NumEntries);
+        for (UINT i = 0; i < streamOutput.NumEntries; ++i)
+        {
+            const D3D12_SO_DECLARATION_ENTRY& entry = streamOutput.pSODeclaration[i];
+            hasher.UpdateValue(entry.Stream);
+            HashString(hasher, entry.SemanticName);
+            hasher.UpdateValue(entry.SemanticIndex);
+            hasher.UpdateValue(entry.StartComponent);
+            hasher.UpdateValue(entry.ComponentCount);
+            hasher.UpdateValue(entry.OutputSlot);
+        }
+
+        hasher.UpdateValue(streamOutput.NumStrides);
+        for (UINT i = 0; i < streamOutput.NumStrides; ++i)
+        {
+            hasher.UpdateValue(streamOutput.pBufferStrides[i]);
+        }
+        hasher.UpdateValue(streamOutput.RasterizedStream);
+    }
+}
+
+uint64_t HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash)
+{
+    Hasher64 hasher;
+    hasher.UpdateValue(rootSignatureHash);
+
+    HashShader(hasher, desc.VS);
+    HashShader(hasher, desc.PS);
+    HashShader(hasher, desc.DS);
+    HashShader(hasher, desc.HS);
+    HashShader(hasher, desc.GS);
+    HashStreamOutput(hasher, desc.StreamOutput);
+    HashBlendState(hasher, desc.BlendState);
+    hasher.UpdateValue(desc.SampleMask);
+    HashRasterizerState(hasher, desc.RasterizerState);
+    HashDepthStencilState(hasher, desc.DepthStencilState);
+    HashInputLayout(hasher, desc.InputLayout);
+    hasher.UpdateValue(desc.IBStripCutValue);
+    hasher.UpdateValue(desc.PrimitiveTopologyType);
+    hasher.UpdateValue(desc.NumRenderTargets);
+    for (DXGI_FORMAT format : desc.RTVFormats)
+    {
+        hasher.UpdateValue(format);
+    }
+    hasher.UpdateValue(desc.DSVFormat);
+    hasher.UpdateValue(desc.SampleDesc.Count);
+    hasher.UpdateValue(desc.SampleDesc.Quality);
+    hasher.UpdateValue(desc.NodeMask);
+    hasher.UpdateValue(desc.Flags);
+
+    // CachedPSO is deliberately left out, it is what the cache provides.
+    return hasher.Final();
+}
+
+uint64_t HashComputePipelineDesc(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash)
+{
+    // Tagged, so a compute pipeline never shares a key with a graphics one.
+    Hasher64 hasher;
+    hasher.UpdateString(std::string("Compute"));
+    hasher.UpdateValue(rootSignatureHash);
+
+    HashShader(hasher, desc.CS);
+    hasher.UpdateValue(desc.NodeMask);
+    hasher.UpdateValue(desc.Flags);
+
+    return hasher.Final();
+}
+
+D3D12GraphicsPipelineBuilder::D3D12GraphicsPipelineBuilder(_In_ ID3D12Device* device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) :
+    m_device(device),
+    m_desc(desc)
+{
+}
+
+bool D3D12GraphicsPipelineBuilder::CreateFromBlob(const void* blob, size_t size)
+{
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = m_desc;
+    desc.CachedPSO.pCachedBlob = blob;
+    desc.CachedPSO.CachedBlobSizeInBytes = size;
+
+    // The runtime rejects blobs produced by another adapter or driver version.
+    return SUCCEEDED(m_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(m_pipelineState.ReleaseAndGetAddressOf())));
+}
+
+void D3D12GraphicsPipelineBuilder::CreateFromScratch()
+{
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = m_desc;
+    desc.CachedPSO.pCachedBlob = nullptr;
+    desc.CachedPSO.CachedBlobSizeInBytes = 0;
+
+    ThrowIfFailed(m_device->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(m_pipelineState.ReleaseAndGetAddressOf())));
+}
+
+bool D3D12GraphicsPipelineBuilder::GetCachedBlob(std::vector<uint8_t>& blob)
+{
+    return CopyCachedBlob(m_pipelineState.Get(), blob);
+}
+
+D3D12ComputePipelineBuilder::D3D12ComputePipelineBuilder(_In_ ID3D12Device* device, const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc) :
+    m_device(device),
+    m_desc(desc)
+{
+}
+
+bool D3D12ComputePipelineBuilder::CreateFromBlob(const void* blob, size_t size)
+{
+    D3D12_COMPUTE_PIPELINE_STATE_DESC desc = m_desc;
+    desc.CachedPSO.pCachedBlob = blob;
+    desc.CachedPSO.CachedBlobSizeInBytes = size;
+
+    return SUCCEEDED(m_device->CreateComputePipelineState(&desc, IID_PPV_ARGS(m_pipelineState.ReleaseAndGetAddressOf())));
+}
+
+void D3D12ComputePipelineBuilder::CreateFromScratch()
+{
+    D3D12_COMPUTE_PIPELINE_STATE_DESC desc = m_desc;
+    desc.CachedPSO.pCachedBlob = nullptr;
+    desc.CachedPSO.CachedBlobSizeInBytes = 0;
+
+    ThrowIfFailed(m_device->CreateComputePipelineState(&desc, IID_PPV_ARGS(m_pipelineState.ReleaseAndGetAddressOf())));
+}
+
+bool D3D12ComputePipelineBuilder::GetCachedBlob(std::vector<uint8_t>& blob)
+{
+    return CopyCachedBlob(m_pipelineState.Get(), blob);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "stdafx.h"
+#include "PipelineStateCache.h"
+
+// Stable hash of a graphics pipeline description. Pointed-to data (shader
+// bytecode, input layout, stream output) is hashed by content and the root
+// signature by the hash of its serialized blob, so the key survives restarts.
+uint64_t HashGraphicsPipelineDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+uint64_t HashComputePipelineDesc(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash);
+
+// IPipelineBuilder for CreateGraphicsPipelineState.
+class D3D12GraphicsPipelineBuilder : public IPipelineBuilder
+{
+public:
+    D3D12GraphicsPipelineBuilder(_In_ ID3D12Device* device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+    virtual bool CreateFromBlob(const void* blob, size_t size);
+    virtual void CreateFromScratch();
+    virtual bool GetCachedBlob(std::vector<uint8_t>& blob);
+
+    ID3D12PipelineState* GetPipelineState() const noexcept { return m_pipelineState.Get(); }
+
+private:
+    ID3D12Device*                                       m_device;
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC                  m_desc;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState>         m_pipelineState;
+};
+
+// IPipelineBuilder for CreateComputePipelineState.
+class D3D12ComputePipelineBuilder : public IPipelineBuilder
+{
+public:
+    D3D12ComputePipelineBuilder(_In_ ID3D12Device* device, const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc);
+
+    virtual bool CreateFromBlob(const void* blob, size_t size);
+    virtual void CreateFromScratch();
+    virtual bool GetCachedBlob(std::vector<uint8_t>& blob);
+
+    ID3D12PipelineState* GetPipelineState() const noexcept { return m_pipelineState.Get(); }
+
+private:
+    ID3D12Device*                                       m_device;
+    D3D12_COMPUTE_PIPELINE_STATE_DESC                   m_desc;
+    Microsoft::WRL::ComPtr<ID3D12PipelineState>         m_pipelineState;
+};
@@ -0,0 +1,272 @@
+#include "stdafx.h"
+#include "D3D12RenderGraphBackend.h"
+#include "DXSampleHelper.h"
+
+#include <stdexcept>
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    D3D12_RESOURCE_DESC GetTextureDesc(const RenderGraphTextureDesc& desc)
+    {
+        D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+        if (desc.allowUnorderedAccess)
+        {
+            flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+        }
+
+        return CD3DX12_RESOURCE_DESC::Tex2D(static_cast<DXGI_FORMAT>(desc.format), desc.width, desc.height, 1, 1, 1, 0, flags);
+    }
+}
+
+D3D12RenderGraphBackend::D3D12RenderGraphBackend(_In_ ID3D12Device* device, D3D12CommandListPool& commandLists, D3D12ResourceStateTracker& stateTracker,
+    D3D12DescriptorHeap& rtvHeap, D3D12DescriptorHeap& srvHeap, UINT framesInFlight) :
+    m_device(device),
+    m_stateTracker(stateTracker),
+    m_rtvHeap(rtvHeap),
+    m_srvHeap(srvHeap),
+    m_commandLists(commandLists),
+    m_frameIndex(0),
+    m_layoutVersion(0),
+    m_frames(framesInFlight),
+    m_profiler(nullptr),
+    m_passScopes(commandLists.GetMaxListCount())
+{
+}
+
+D3D12RenderGraphBackend::~D3D12RenderGraphBackend()
+{
+    ReleaseTextures();
+}
+
+void D3D12RenderGraphBackend::BindImported(RenderGraphResource resource, _In_ ID3D12Resource* d3dResource, D3D12_CPU_DESCRIPTOR_HANDLE rtv)
+{
+    if (resource >= m_imported.size())
+    {
+        Imported none = { nullptr, {} };
+        m_imported.resize(resource + 1, none);
+    }
+
+    m_imported[resource].resource = d3dResource;
+    m_imported[resource].rtv = rtv;
+}
+
+const D3D12RenderGraphBackend::Texture& D3D12RenderGraphBackend::GetTexture(RenderGraphResource resource) const
+{
+    const std::vector<Texture>& textures = m_frames[m_frameIndex].textures;
+    if (resource >= textures.size() || !textures[resource].resource)
+    {
+        throw std::logic_error("D3D12RenderGraphBackend: resource is not bound");
+    }
+
+    return textures[resource];
+}
+
+ID3D12Resource* D3D12RenderGraphBackend::GetResource(RenderGraphResource resource) const
+{
+    if (resource < m_imported.size() && m_imported[resource].resource)
+    {
+        return m_imported[resource].resource;
+    }
+
+    return GetTexture(resource).resource.Get();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE D3D12RenderGraphBackend::GetRtv(RenderGraphResource resource) const
+{
+    if (resource < m_imported.size() && m_imported[resource].resource)
+    {
+        return m_imported[resource].rtv;
+    }
+
+    return GetTexture(resource).rtv.cpu;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE D3D12RenderGraphBackend::GetSrv(RenderGraphResource resource) const
+{
+    return GetTexture(resource).srv.gpu;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE D3D12RenderGraphBackend::GetUav(RenderGraphResource resource) const
+{
+    const Texture& texture = GetTexture(resource);
+    if (!texture.hasUav)
+    {
+        throw std::logic_error("D3D12RenderGraphBackend: texture has no unordered access view");
+    }
+
+    return texture.uav.gpu;
+}
+
+RenderGraphAllocationInfo D3D12RenderGraphBackend::GetAllocationInfo(const RenderGraphTextureDesc& desc)
+{
+    const D3D12_RESOURCE_DESC resourceDesc = GetTextureDesc(desc);
+    const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &resourceDesc);
+
+    RenderGraphAllocationInfo allocation = { info.SizeInBytes, info.Alignment };
+    return allocation;
+}
+
+void D3D12RenderGraphBackend::BeginGraph(const RenderGraphLayout& layout)
+{
+    if (layout.version == m_layoutVersion)
+    {
+        return;
+    }
+
+    ReleaseTextures();
+    m_layoutVersion = layout.version;
+
+    if (layout.heapSize == 0)
+    {
+        return;
+    }
+
+    // Every transient is a render target, so the heap works on resource heap tier 1.
+    const CD3DX12_HEAP_DESC heapDesc(layout.heapSize, D3D12_HEAP_TYPE_DEFAULT, layout.heapAlignment, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES);
+
+    for (FrameHeap& frame : m_frames)
+    {
+        ThrowIfFailed(m_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&frame.heap)));
+        frame.heap->SetName(L"Render Graph Transient Heap");
+
+        for (const RenderGraphTexturePlacement& placement : layout.textures)
+        {
+            if (placement.resource >= frame.textures.size())
+            {
+                frame.textures.resize(placement.resource + 1);
+            }
+            Texture& texture = frame.textures[placement.resource];
+
+            const D3D12_RESOURCE_DESC desc = GetTextureDesc(placement.desc);
+            D3D12_CLEAR_VALUE clearValue = { desc.Format, {} };
+            memcpy(clearValue.Color, placement.desc.clearColor, sizeof(clearValue.Color));
+
+            const D3D12_RESOURCE_STATES initialState = static_cast<D3D12_RESOURCE_STATES>(placement.initialState);
+            ThrowIfFailed(m_device->CreatePlacedResource(frame.heap.Get(), placement.offset, &desc, initialState, &clearValue,
+                IID_PPV_ARGS(&texture.resource)));
+            texture.resource->SetName(L"Render Graph Transient Texture");
+
+            texture.rtv = m_rtvHeap.AllocatePersistent();
+            m_device->CreateRenderTargetView(texture.resource.Get(), nullptr, texture.rtv.cpu);
+
+            texture.srv = m_srvHeap.AllocatePersistent();
+            m_device->CreateShaderResourceView(texture.resource.Get(), nullptr, texture.srv.cpu);
+
+            texture.hasUav = placement.desc.allowUnorderedAccess;
+            if (texture.hasUav)
+            {
+                texture.uav = m_srvHeap.AllocatePersistent();
+                m_device->CreateUnorderedAccessView(texture.resource.Get(), nullptr, nullptr, texture.uav.cpu);
+            }
+
+            m_stateTracker.Track(texture.resource.Get(), initialState);
+        }
+    }
+}
+
+void D3D12RenderGraphBackend::ReleaseTextures()
+{
+    for (FrameHeap& frame : m_frames)
+    {
+        for (Texture& texture : frame.textures)
+        {
+            if (texture.resource)
+            {
+                m_stateTracker.Untrack(texture.resource.Get());
+                m_rtvHeap.FreePersistent(texture.rtv);
+                m_srvHeap.FreePersistent(texture.srv);
+                if (texture.hasUav)
+                {
+                    m_srvHeap.FreePersistent(texture.uav);
+                }
+            }
+        }
+
+        frame.textures.clear();
+        frame.heap.Reset();
+    }
+}
+
+void D3D12RenderGraphBackend::PrepareBarriers(uint32_t boundary, const RenderGraphBarrier* barriers, uint32_t count)
+{
+    if (boundary >= m_boundaries.size())
+    {
+        m_boundaries.resize(boundary + 1);
+    }
+    std::vector<D3D12_RESOURCE_BARRIER>& resolved = m_boundaries[boundary];
+    resolved.clear();
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const RenderGraphBarrier& barrier = barriers[i];
+        ID3D12Resource* resource = GetResource(barrier.resource);
+
+        switch (barrier.type)
+        {
+        case RenderGraphBarrierAliasing:
+        {
+            ID3D12Resource* before = barrier.resourceBefore != RenderGraph::InvalidResource ? GetResource(barrier.resourceBefore) : nullptr;
+            resolved.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(before, resource));
+            break;
+        }
+
+        case RenderGraphBarrierUav:
+            resolved.push_back(CD3DX12_RESOURCE_BARRIER::UAV(resource));
+            break;
+
+        case RenderGraphBarrierTransition:
+            // The tracker knows the actual state, imported resources may not
+            // be in the one the graph was told about.
+            if (barrier.flags == ResourceBarrierFlagBeginOnly)
+            {
+                m_stateTracker.BeginTransition(resource, static_cast<D3D12_RESOURCE_STATES>(barrier.after));
+            }
+            else if (barrier.flags == ResourceBarrierFlagEndOnly)
+            {
+                m_stateTracker.EndTransition(resource);
+            }
+            else
+            {
+                m_stateTracker.Transition(resource, static_cast<D3D12_RESOURCE_STATES>(barrier.after));
+            }
+            break;
+        }
+    }
+
+    m_stateTracker.Flush(resolved);
+}
+
+void D3D12RenderGraphBackend::RecordBarriers(uint32_t list, uint32_t boundary)
+{
+    const std::vector<D3D12_RESOURCE_BARRIER>& barriers = m_boundaries.at(boundary);
+    if (!barriers.empty())
+    {
+        m_commandLists.GetCommands(list).ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+    }
+}
+
+void D3D12RenderGraphBackend::DiscardResource(uint32_t list, RenderGraphResource resource)
+{
+    m_commandLists.GetCommands(list).DiscardResource(GetResource(resource));
+}
+
+void D3D12RenderGraphBackend::BeginPass(uint32_t list, const std::string& name)
+{
+    if (m_profiler)
+    {
+        // Pass names live as long as the graph.
+        m_passScopes[list].cpu = m_profiler->GetProfiler().BeginScope(name.c_str());
+        m_passScopes[list].gpu = m_profiler->BeginScope(m_commandLists.GetCommandList(list), name.c_str());
+    }
+}
+
+void D3D12RenderGraphBackend::EndPass(uint32_t list)
+{
+    if (m_profiler)
+    {
+        m_profiler->EndScope(m_commandLists.GetCommandList(list), m_passScopes[list].gpu);
+        m_profiler->GetProfiler().EndScope(m_passScopes[list].cpu);
+    }
+}
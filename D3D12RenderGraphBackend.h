@@ -0,0 +1,91 @@
+#pragma once
+
+#include "stdafx.h"
+#include "RenderGraph.h"
+#include "D3D12DescriptorHeap.h"
+#include "D3D12ResourceStateTracker.h"
+#include "D3D12CommandListPool.h"
+#include "D3D12GpuProfiler.h"
+
+#include <vector>
+
+// Runs a RenderGraph on the command lists of a D3D12CommandListPool. Transient
+// textures are placed resources in one heap per frame in flight, each with an
+// RTV, an SRV and, when it allows unordered access, a UAV. Transitions are
+// resolved by the state tracker before the passes are recorded; each pass
+// boundary becomes a single ResourceBarrier call, aliasing and UAV barriers
+// first.
+class D3D12RenderGraphBackend : public IRenderGraphBackend
+{
+public:
+    D3D12RenderGraphBackend(_In_ ID3D12Device* device, D3D12CommandListPool& commandLists, D3D12ResourceStateTracker& stateTracker,
+        D3D12DescriptorHeap& rtvHeap, D3D12DescriptorHeap& srvHeap, UINT framesInFlight);
+    ~D3D12RenderGraphBackend();
+
+    // Bindings for the frame being recorded, set before RenderGraph::Execute.
+    void SetFrameIndex(UINT frameIndex) noexcept { m_frameIndex = frameIndex; }
+    void BindImported(RenderGraphResource resource, _In_ ID3D12Resource* d3dResource, D3D12_CPU_DESCRIPTOR_HANDLE rtv);
+
+    // Time every pass on the CPU and the GPU, null to stop.
+    void SetProfiler(_In_opt_ D3D12GpuProfiler* profiler) noexcept { m_profiler = profiler; }
+
+    // For the pass callbacks.
+    ID3D12Resource* GetResource(RenderGraphResource resource) const;
+    D3D12_CPU_DESCRIPTOR_HANDLE GetRtv(RenderGraphResource resource) const;
+    D3D12_GPU_DESCRIPTOR_HANDLE GetSrv(RenderGraphResource resource) const;
+    D3D12_GPU_DESCRIPTOR_HANDLE GetUav(RenderGraphResource resource) const;
+
+    virtual RenderGraphAllocationInfo GetAllocationInfo(const RenderGraphTextureDesc& desc);
+
+    // Recreates the heaps when the layout changed, the GPU must be idle then.
+    virtual void BeginGraph(const RenderGraphLayout& layout);
+    virtual void PrepareBarriers(uint32_t boundary, const RenderGraphBarrier* barriers, uint32_t count);
+    virtual void RecordBarriers(uint32_t list, uint32_t boundary);
+    virtual void DiscardResource(uint32_t list, RenderGraphResource resource);
+    virtual void BeginPass(uint32_t list, const std::string& name);
+    virtual void EndPass(uint32_t list);
+
+private:
+    struct Texture
+    {
+        Microsoft::WRL::ComPtr<ID3D12Resource>          resource;
+        DescriptorHandle                                rtv;
+        DescriptorHandle                                srv;
+        DescriptorHandle                                uav;
+        bool                                            hasUav;
+    };
+
+    struct FrameHeap
+    {
+        Microsoft::WRL::ComPtr<ID3D12Heap>              heap;
+        std::vector<Texture>                            textures;   // Indexed by RenderGraphResource.
+    };
+
+    struct PassScope
+    {
+        uint64_t                                        cpu;
+        UINT                                            gpu;
+    };
+
+    struct Imported
+    {
+        ID3D12Resource*                                 resource;
+        D3D12_CPU_DESCRIPTOR_HANDLE                     rtv;
+    };
+
+    const Texture& GetTexture(RenderGraphResource resource) const;
+    void ReleaseTextures();
+
+    Microsoft::WRL::ComPtr<ID3D12Device>                m_device;
+    D3D12ResourceStateTracker&                          m_stateTracker;
+    D3D12DescriptorHeap&                                m_rtvHeap;
+    D3D12DescriptorHeap&                                m_srvHeap;
+    D3D12CommandListPool&                               m_commandLists;
+    UINT                                                m_frameIndex;
+    uint64_t                                            m_layoutVersion;
+    std::vector<FrameHeap>                              m_frames;
+    std::vector<Imported>                               m_imported;
+    std::vector<std::vector<D3D12_RESOURCE_BARRIER>>    m_boundaries;
+    D3D12GpuProfiler*                                   m_profiler;
+    std::vector<PassScope>                              m_passScopes;   // Open scope of each list.
+};
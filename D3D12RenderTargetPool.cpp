@@ -0,0 +1,87 @@
+#include "stdafx.h"
+#include "D3D12RenderTargetPool.h"
+#include "DXSampleHelper.h"
+
+#include <cstring>
+
+D3D12RenderTargetPool::D3D12RenderTargetPool(_In_ ID3D12Device* device, FrameScheduler& scheduler, UINT64 heapSize) :
+    m_device(device),
+    m_scheduler(scheduler),
+    m_pool(*this, heapSize)
+{
+}
+
+D3D12_RESOURCE_DESC D3D12RenderTargetPool::GetResourceDesc(const TexturePoolKey& key)
+{
+    return CD3DX12_RESOURCE_DESC::Tex2D(static_cast<DXGI_FORMAT>(key.format), key.width, key.height, 1, 1, 1, 0,
+        static_cast<D3D12_RESOURCE_FLAGS>(key.flags));
+}
+
+UINT D3D12RenderTargetPool::Acquire(DXGI_FORMAT format, UINT width, UINT height, D3D12_RESOURCE_FLAGS flags, const float clearColor[4])
+{
+    TexturePoolKey key = { width, height, static_cast<uint32_t>(format), static_cast<uint32_t>(flags | D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET) };
+    memcpy(key.clearColor, clearColor, sizeof(key.clearColor));
+    return m_pool.Acquire(key);
+}
+
+void D3D12RenderTargetPool::Release(UINT texture, D3D12_RESOURCE_STATES state)
+{
+    // The frame being recorded may still use the texture.
+    m_textures[texture].state = state;
+    m_pool.Release(texture, m_scheduler.GetCurrentFenceValue());
+}
+
+void D3D12RenderTargetPool::ReleaseCompleted()
+{
+    m_pool.ReleaseCompleted(m_scheduler.GetCompletedFenceValue());
+}
+
+TexturePoolAllocationInfo D3D12RenderTargetPool::GetAllocationInfo(const TexturePoolKey& key)
+{
+    const D3D12_RESOURCE_DESC desc = GetResourceDesc(key);
+    const D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = m_device->GetResourceAllocationInfo(0, 1, &desc);
+
+    TexturePoolAllocationInfo info = { allocationInfo.SizeInBytes, allocationInfo.Alignment };
+    return info;
+}
+
+void D3D12RenderTargetPool::CreateHeap(uint32_t heap, uint64_t size)
+{
+    if (heap >= m_heaps.size())
+    {
+        m_heaps.resize(heap + 1);
+    }
+
+    // Render targets only, which resource heap tier 1 requires.
+    CD3DX12_HEAP_DESC heapDesc(size, D3D12_HEAP_TYPE_DEFAULT, 0, D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES);
+    ThrowIfFailed(m_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&m_heaps[heap])));
+    m_heaps[heap]->SetName(L"Render Target Pool");
+}
+
+void D3D12RenderTargetPool::DestroyHeap(uint32_t heap)
+{
+    m_heaps[heap].Reset();
+}
+
+void D3D12RenderTargetPool::CreateTexture(uint32_t texture, const TexturePoolKey& key, uint32_t heap, uint64_t offset)
+{
+    if (texture >= m_textures.size())
+    {
+        m_textures.resize(texture + 1);
+    }
+
+    const D3D12_RESOURCE_DESC desc = GetResourceDesc(key);
+    D3D12_CLEAR_VALUE clearValue = { static_cast<DXGI_FORMAT>(key.format), {} };
+    memcpy(clearValue.Color, key.clearColor, sizeof(clearValue.Color));
+
+    Texture& entry = m_textures[texture];
+    entry.state = D3D12_RESOURCE_STATE_RENDER_TARGET;
+    ThrowIfFailed(m_device->CreatePlacedResource(m_heaps[heap].Get(), offset, &desc, entry.state, &clearValue,
+        IID_PPV_ARGS(entry.resource.ReleaseAndGetAddressOf())));
+    entry.resource->SetName(L"Pooled Render Target");
+}
+
+void D3D12RenderTargetPool::DestroyTexture(uint32_t texture)
+{
+    m_textures[texture].resource.Reset();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "stdafx.h"
+#include "TexturePool.h"
+#include "FrameScheduler.h"
+
+#include <vector>
+
+// TexturePool of render targets placed in D3D12 heaps. Textures are released
+// with the fence of the frame being recorded and recycled once the scheduler
+// has seen it complete. The pool remembers the state a texture was released
+// in, for the next owner to start from.
+//
+// A texture placed over memory another texture used is not initialized, its
+// first use must be a clear or a DiscardResource.
+class D3D12RenderTargetPool : public ITexturePoolBackend
+{
+public:
+    D3D12RenderTargetPool(_In_ ID3D12Device* device, FrameScheduler& scheduler, UINT64 heapSize = 64 * 1024 * 1024);
+
+    UINT Acquire(DXGI_FORMAT format, UINT width, UINT height, D3D12_RESOURCE_FLAGS flags, const float clearColor[4]);
+    void Release(UINT texture, D3D12_RESOURCE_STATES state);
+
+    // Recycle the textures of every completed frame, once per frame.
+    void ReleaseCompleted();
+
+    ID3D12Resource* GetResource(UINT texture) const     { return m_textures[texture].resource.Get(); }
+    D3D12_RESOURCE_STATES GetState(UINT texture) const  { return m_textures[texture].state; }
+
+    const TexturePool& GetPool() const                  { return m_pool; }
+    void Trim()                                         { m_pool.Trim(); }
+
+    virtual TexturePoolAllocationInfo GetAllocationInfo(const TexturePoolKey& key);
+    virtual void CreateHeap(uint32_t heap, uint64_t size);
+    virtual void DestroyHeap(uint32_t heap);
+    virtual void CreateTexture(uint32_t texture, const TexturePoolKey& key, uint32_t heap, uint64_t offset);
+    virtual void DestroyTexture(uint32_t texture);
+
+private:
+    struct Texture
+    {
+        Microsoft::WRL::ComPtr<ID3D12Resource>  resource;
+        D3D12_RESOURCE_STATES                   state;
+    };
+
+    static D3D12_RESOURCE_DESC GetResourceDesc(const TexturePoolKey& key);
+
+    Microsoft::WRL::ComPtr<ID3D12Device>                m_device;
+    FrameScheduler&                                     m_scheduler;
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Heap>>     m_heaps;
+    std::vector<Texture>                                m_textures;
+
+    // Last, it is destroyed first and releases its textures and heaps
+    // through the backend while they still exist.
+    TexturePool                                         m_pool;
+};
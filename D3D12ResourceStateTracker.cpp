@@ -0,0 +1,82 @@
+#include "stdafx.h"
+#include "D3D12ResourceStateTracker.h"
+
+D3D12ResourceStateTracker::D3D12ResourceStateTracker() :
+    m_output(nullptr)
+{
+}
+
+void D3D12ResourceStateTracker::Track(_In_ ID3D12Resource* resource, D3D12_RESOURCE_STATES initialState)
+{
+    const D3D12_RESOURCE_DESC desc = resource->GetDesc();
+
+    UINT subresourceCount = 1;
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D)
+    {
+        subresourceCount = desc.MipLevels;
+    }
+    else if (desc.Dimension != D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        subresourceCount = desc.MipLevels * desc.DepthOrArraySize;
+    }
+
+    m_tracker.Track(resource, subresourceCount, static_cast<uint32_t>(initialState));
+}
+
+void D3D12ResourceStateTracker::Untrack(_In_ ID3D12Resource* resource)
+{
+    m_tracker.Untrack(resource);
+}
+
+D3D12_RESOURCE_STATES D3D12ResourceStateTracker::GetState(_In_ ID3D12Resource* resource, UINT subresource) const
+{
+    return static_cast<D3D12_RESOURCE_STATES>(m_tracker.GetState(resource, subresource));
+}
+
+void D3D12ResourceStateTracker::Transition(_In_ ID3D12Resource* resource, D3D12_RESOURCE_STATES state, UINT subresource)
+{
+    m_tracker.Transition(resource, static_cast<uint32_t>(state), subresource);
+}
+
+void D3D12ResourceStateTracker::BeginTransition(_In_ ID3D12Resource* resource, D3D12_RESOURCE_STATES state, UINT subresource)
+{
+    m_tracker.BeginTransition(resource, static_cast<uint32_t>(state), subresource);
+}
+
+void D3D12ResourceStateTracker::EndTransition(_In_ ID3D12Resource* resource, UINT subresource)
+{
+    m_tracker.EndTransition(resource, subresource);
+}
+
+void D3D12ResourceStateTracker::Flush(_In_ ID3D12GraphicsCommandList* commandList)
+{
+    m_barriers.clear();
+    Flush(m_barriers);
+
+    if (!m_barriers.empty())
+    {
+        commandList->ResourceBarrier(static_cast<UINT>(m_barriers.size()), m_barriers.data());
+    }
+}
+
+void D3D12ResourceStateTracker::Flush(std::vector<D3D12_RESOURCE_BARRIER>& barriers)
+{
+    m_output = &barriers;
+    m_tracker.Flush(*this);
+    m_output = nullptr;
+}
+
+void D3D12ResourceStateTracker::ResourceBarrier(const ResourceTransition* transitions, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // The tracker only keys on the pointer, the resources are the ones passed to Track.
+        ID3D12Resource* resource = static_cast<ID3D12Resource*>(const_cast<void*>(transitions[i].resource));
+
+        m_output->push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource,
+            static_cast<D3D12_RESOURCE_STATES>(transitions[i].before),
+            static_cast<D3D12_RESOURCE_STATES>(transitions[i].after),
+            transitions[i].subresource,
+            static_cast<D3D12_RESOURCE_BARRIER_FLAGS>(transitions[i].flags)));
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "stdafx.h"
+#include "ResourceStateTracker.h"
+
+#include <vector>
+
+// ResourceStateTracker keyed by ID3D12Resource, flushing its batches into a
+// command list. Call Flush before each draw, dispatch, clear or copy that
+// depends on the requested states.
+class D3D12ResourceStateTracker : public IResourceBarrierSink
+{
+public:
+    D3D12ResourceStateTracker();
+
+    // Subresources are counted from the resource description, planes excluded.
+    void Track(_In_ ID3D12Resource* resource, D3D12_RESOURCE_STATES initialState);
+    void Untrack(_In_ ID3D12Resource* resource);
+
+    D3D12_RESOURCE_STATES GetState(_In_ ID3D12Resource* resource, UINT subresource = 0) const;
+
+    void Transition(_In_ ID3D12Resource* resource, D3D12_RESOURCE_STATES state, UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    void BeginTransition(_In_ ID3D12Resource* resource, D3D12_RESOURCE_STATES state, UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+    void EndTransition(_In_ ID3D12Resource* resource, UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+    void Flush(_In_ ID3D12GraphicsCommandList* commandList);
+
+    // Resolve the pending barriers without recording them, appending them to
+    // barriers, for command lists recorded later or on another thread.
+    void Flush(std::vector<D3D12_RESOURCE_BARRIER>& barriers);
+
+    const ResourceStateTracker& GetTracker() const noexcept { return m_tracker; }
+
+private:
+    virtual void ResourceBarrier(const ResourceTransition* transitions, uint32_t count);
+
+    ResourceStateTracker                                m_tracker;
+    std::vector<D3D12_RESOURCE_BARRIER>*                m_output;
+    std::vector<D3D12_RESOURCE_BARRIER>                 m_barriers;
+};
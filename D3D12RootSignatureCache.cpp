@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "D3D12RootSignatureCache.h"
+#include "DXSampleHelper.h"
+#include "Hash.h"
+
+using Microsoft::WRL::ComPtr;
+
+D3D12RootSignatureCache::D3D12RootSignatureCache(_In_ ID3D12Device* device) :
+    m_device(device),
+    m_version(D3D_ROOT_SIGNATURE_VERSION_1_1)
+{
+    D3D12_FEATURE_DATA_ROOT_SIGNATURE feature = {};
+    feature.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
+    if (FAILED(m_device->CheckFeatureSupport(D3D12_FEATURE_ROOT_SIGNATURE, &feature, sizeof(feature))))
+    {
+        feature.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
+    }
+    m_version = feature.HighestVersion;
+}
+
+ID3D12RootSignature* D3D12RootSignatureCache::Create(const RootSignatureLayout& layout, _Out_opt_ UINT64* serializedHash)
+{
+    bool added = false;
+    const uint32_t index = m_layouts.Add(layout, &added);
+    if (added)
+    {
+        m_entries.resize(index + 1);
+        CreateEntry(layout, m_entries[index]);
+    }
+
+    const Entry& entry = m_entries[index];
+    if (serializedHash)
+    {
+        *serializedHash = entry.serializedHash;
+    }
+    return entry.rootSignature.Get();
+}
+
+void D3D12RootSignatureCache::CreateEntry(const RootSignatureLayout& layout, Entry& entry)
+{
+    const std::vector<RootParameterDesc>& parameters = layout.GetParameters();
+
+    // Ranges first, the table parameters point into them.
+    std::vector<CD3DX12_DESCRIPTOR_RANGE1> ranges(parameters.size());
+    std::vector<CD3DX12_ROOT_PARAMETER1> rootParameters(parameters.size());
+    for (size_t i = 0; i < parameters.size(); ++i)
+    {
+        const RootParameterDesc& parameter = parameters[i];
+        const D3D12_SHADER_VISIBILITY visibility = static_cast<D3D12_SHADER_VISIBILITY>(parameter.visibility);
+        const D3D12_ROOT_DESCRIPTOR_FLAGS descriptorFlags = static_cast<D3D12_ROOT_DESCRIPTOR_FLAGS>(parameter.flags);
+        switch (parameter.type)
+        {
+        case RootParameterConstants:
+            rootParameters[i].InitAsConstants(parameter.count, parameter.shaderRegister, parameter.registerSpace, visibility);
+            break;
+        case RootParameterCbv:
+            rootParameters[i].InitAsConstantBufferView(parameter.shaderRegister, parameter.registerSpace, descriptorFlags, visibility);
+            break;
+        case RootParameterSrv:
+            rootParameters[i].InitAsShaderResourceView(parameter.shaderRegister, parameter.registerSpace, descriptorFlags, visibility);
+            break;
+        case RootParameterUav:
+            rootParameters[i].InitAsUnorderedAccessView(parameter.shaderRegister, parameter.registerSpace, descriptorFlags, visibility);
+            break;
+        default:
+            ranges[i].Init(static_cast<D3D12_DESCRIPTOR_RANGE_TYPE>(parameter.rangeType), parameter.count, parameter.shaderRegister,
+                parameter.registerSpace, static_cast<D3D12_DESCRIPTOR_RANGE_FLAGS>(parameter.flags));
+            rootParameters[i].InitAsDescriptorTable(1, &ranges[i], visibility);
+            break;
+        }
+    }
+
+    std::vector<D3D12_STATIC_SAMPLER_DESC> staticSamplers;
+    for (const RootStaticSamplerDesc& sampler : layout.GetStaticSamplers())
+    {
+        const D3D12_TEXTURE_ADDRESS_MODE addressMode = static_cast<D3D12_TEXTURE_ADDRESS_MODE>(sampler.addressMode);
+        CD3DX12_STATIC_SAMPLER_DESC desc(sampler.shaderRegister, static_cast<D3D12_FILTER>(sampler.filter), addressMode, addressMode, addressMode);
+        desc.RegisterSpace = sampler.registerSpace;
+        desc.ShaderVisibility = static_cast<D3D12_SHADER_VISIBILITY>(sampler.visibility);
+        staticSamplers.push_back(desc);
+    }
+
+    CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC desc;
+    desc.Init_1_1(static_cast<UINT>(rootParameters.size()), rootParameters.data(), static_cast<UINT>(staticSamplers.size()), staticSamplers.data(),
+        static_cast<D3D12_ROOT_SIGNATURE_FLAGS>(layout.GetFlags()));
+
+    // Converted to version 1.0 on older runtimes.
+    ComPtr<ID3DBlob> signature;
+    ComPtr<ID3DBlob> error;
+    const HRESULT hr = D3DX12SerializeVersionedRootSignature(&desc, m_version, &signature, &error);
+    if (error)
+    {
+        OutputDebugStringA(static_cast<const char*>(error->GetBufferPointer()));
+    }
+    ThrowIfFailed(hr);
+    ThrowIfFailed(m_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&entry.rootSignature)));
+
+    Hasher64 hasher;
+    hasher.Update(signature->GetBufferPointer(), signature->GetBufferSize());
+    entry.serializedHash = hasher.Final();
+}
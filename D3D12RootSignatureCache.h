@@ -0,0 +1,37 @@
+#pragma once
+
+#include "stdafx.h"
+#include "RootSignatureBuilder.h"
+
+#include <vector>
+
+// Creates the root signatures laid out by RootSignatureBuilder, one per
+// distinct layout. They are serialized as version 1.1 where the device
+// supports it, version 1.0 drops the data and descriptor flags.
+class D3D12RootSignatureCache
+{
+public:
+    explicit D3D12RootSignatureCache(_In_ ID3D12Device* device);
+
+    // The root signature of layout, shared with the identical layouts created
+    // before. serializedHash receives the hash of the serialized blob, which
+    // pipeline cache keys refer to the root signature by.
+    ID3D12RootSignature* Create(const RootSignatureLayout& layout, _Out_opt_ UINT64* serializedHash = nullptr);
+
+    D3D_ROOT_SIGNATURE_VERSION GetVersion() const   { return m_version; }
+    RootSignatureCacheStats GetStats() const        { return m_layouts.GetStats(); }
+
+private:
+    struct Entry
+    {
+        Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature;
+        UINT64 serializedHash;
+    };
+
+    void CreateEntry(const RootSignatureLayout& layout, Entry& entry);
+
+    ID3D12Device* m_device;
+    D3D_ROOT_SIGNATURE_VERSION m_version;
+    RootSignatureCache m_layouts;
+    std::vector<Entry> m_entries;   // By layout index.
+};
@@ -0,0 +1,127 @@
+#include "stdafx.h"
+#include "D3D12ShaderHotReload.h"
+#include "D3D12PipelineCache.h"
+#include "D3DShaderCompiler.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    class D3D12ReloadedPipeline : public IReloadedPipeline
+    {
+    public:
+        ComPtr<ID3D12PipelineState> pipelineState;
+    };
+}
+
+D3D12ShaderHotReload::D3D12ShaderHotReload(_In_ ID3D12Device* device, ShaderCompileCallback compiler) :
+    m_device(device),
+    m_reload(m_watcher, compiler, [this](uint32_t pipeline, const std::vector<ShaderBytecode>& shaders, std::string& /*errors*/)
+        {
+            // Creation failures throw an HrException, the reloader reports it.
+            return Rebuild(pipeline, shaders);
+        })
+{
+}
+
+UINT D3D12ShaderHotReload::AddShader(const ShaderCompileRequest& request, const D3D12_SHADER_BYTECODE& bytecode)
+{
+    return m_reload.AddShader(request, bytecode.pShaderBytecode, bytecode.BytecodeLength);
+}
+
+void D3D12ShaderHotReload::AddPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT vertexShader, UINT pixelShader,
+    ComPtr<ID3D12PipelineState>* pipelineState)
+{
+    std::unique_ptr<Pipeline> pipeline(new Pipeline());
+    pipeline->compute = false;
+    pipeline->graphicsDesc = desc;
+    pipeline->pipelineState = pipelineState;
+
+    // The names first, the elements point into them.
+    const D3D12_INPUT_LAYOUT_DESC& inputLayout = desc.InputLayout;
+    for (UINT i = 0; i < inputLayout.NumElements; ++i)
+    {
+        pipeline->semanticNames.push_back(inputLayout.pInputElementDescs[i].SemanticName);
+    }
+    for (UINT i = 0; i < inputLayout.NumElements; ++i)
+    {
+        D3D12_INPUT_ELEMENT_DESC element = inputLayout.pInputElementDescs[i];
+        element.SemanticName = pipeline->semanticNames[i].c_str();
+        pipeline->inputLayout.push_back(element);
+    }
+    pipeline->graphicsDesc.InputLayout.pInputElementDescs = pipeline->inputLayout.data();
+
+    const UINT shaders[] = { vertexShader, pixelShader };
+    m_reload.AddPipeline(std::vector<uint32_t>(shaders, shaders + _countof(shaders)));
+    m_pipelines.push_back(std::move(pipeline));
+}
+
+void D3D12ShaderHotReload::AddPipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, UINT computeShader,
+    ComPtr<ID3D12PipelineState>* pipelineState)
+{
+    std::unique_ptr<Pipeline> pipeline(new Pipeline());
+    pipeline->compute = true;
+    pipeline->computeDesc = desc;
+    pipeline->pipelineState = pipelineState;
+
+    m_reload.AddPipeline(std::vector<uint32_t>(1, computeShader));
+    m_pipelines.push_back(std::move(pipeline));
+}
+
+void D3D12ShaderHotReload::Start()
+{
+    m_reload.Start();
+}
+
+std::unique_ptr<IReloadedPipeline> D3D12ShaderHotReload::Rebuild(uint32_t index, const std::vector<ShaderBytecode>& shaders)
+{
+    const Pipeline& pipeline = *m_pipelines[index];
+    std::unique_ptr<D3D12ReloadedPipeline> reloaded(new D3D12ReloadedPipeline());
+
+    // Reloaded pipelines skip the pipeline cache, the next start compiles them
+    // once and caches them again.
+    if (pipeline.compute)
+    {
+        D3D12_COMPUTE_PIPELINE_STATE_DESC desc = pipeline.computeDesc;
+        desc.CS = ToShaderBytecode(shaders[0]);
+
+        D3D12ComputePipelineBuilder builder(m_device, desc);
+        builder.CreateFromScratch();
+        reloaded->pipelineState = builder.GetPipelineState();
+    }
+    else
+    {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC desc = pipeline.graphicsDesc;
+        desc.VS = ToShaderBytecode(shaders[0]);
+        desc.PS = ToShaderBytecode(shaders[1]);
+
+        D3D12GraphicsPipelineBuilder builder(m_device, desc);
+        builder.CreateFromScratch();
+        reloaded->pipelineState = builder.GetPipelineState();
+    }
+
+    return std::move(reloaded);
+}
+
+UINT D3D12ShaderHotReload::Apply(UINT64 retireFenceValue, UINT64 completedFenceValue)
+{
+    const UINT swapped = m_reload.Apply(retireFenceValue, completedFenceValue, [this](uint32_t pipeline, IReloadedPipeline& rebuilt)
+    {
+        m_pipelines[pipeline]->pipelineState->Swap(static_cast<D3D12ReloadedPipeline&>(rebuilt).pipelineState);
+    });
+
+    m_errors.clear();
+    m_reload.TakeErrors(m_errors);
+    for (const std::string& error : m_errors)
+    {
+        OutputDebugStringA(("Shader reload failed: " + error + "\n").c_str());
+    }
+
+    if (swapped)
+    {
+        char buff[64] = {};
+        sprintf_s(buff, "Shader reload: %u pipelines swapped in\n", swapped);
+        OutputDebugStringA(buff);
+    }
+    return swapped;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "stdafx.h"
+#include "ShaderHotReload.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Reloads the shaders of pipeline states while the sample runs, see
+// ShaderHotReload. The pipelines are created from scratch on the reload
+// thread, device creation methods are free threaded, and swapped into the
+// ComPtr they live in by Apply.
+class D3D12ShaderHotReload
+{
+public:
+    D3D12ShaderHotReload(_In_ ID3D12Device* device, ShaderCompileCallback compiler);
+
+    // bytecode is the result of the initial compile and is copied.
+    UINT AddShader(const ShaderCompileRequest& request, const D3D12_SHADER_BYTECODE& bytecode);
+
+    // The input layout of desc is copied, its root signature has to outlive
+    // the reloader and so does pipelineState, which Apply swaps into.
+    void AddPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, UINT vertexShader, UINT pixelShader,
+        Microsoft::WRL::ComPtr<ID3D12PipelineState>* pipelineState);
+    void AddPipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& desc, UINT computeShader,
+        Microsoft::WRL::ComPtr<ID3D12PipelineState>* pipelineState);
+
+    void Start();
+
+    // Swap the rebuilt pipelines in, at a frame boundary on the render thread,
+    // and log the reload errors.
+    UINT Apply(UINT64 retireFenceValue, UINT64 completedFenceValue);
+
+    ShaderHotReloadStats GetStats() const   { return m_reload.GetStats(); }
+
+private:
+    struct Pipeline
+    {
+        bool compute;
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsDesc;
+        D3D12_COMPUTE_PIPELINE_STATE_DESC computeDesc;
+        std::vector<std::string> semanticNames;
+        std::vector<D3D12_INPUT_ELEMENT_DESC> inputLayout;
+        Microsoft::WRL::ComPtr<ID3D12PipelineState>* pipelineState;
+    };
+
+    std::unique_ptr<IReloadedPipeline> Rebuild(uint32_t pipeline, const std::vector<ShaderBytecode>& shaders);
+
+    ID3D12Device* m_device;
+
+    // Read by the reload thread, which m_reload stops first.
+    std::vector<std::unique_ptr<Pipeline>> m_pipelines;
+    FileWatcher m_watcher;
+    ShaderHotReload m_reload;
+    std::vector<std::string> m_errors;
+};
@@ -0,0 +1,79 @@
+#include "stdafx.h"
+#include "D3D12TextureReadback.h"
+#include "DXSampleHelper.h"
+
+D3D12TextureReadback::D3D12TextureReadback(_In_ ID3D12Device* device, _In_ IFrameQueue* queue, UINT slotCount,
+    UINT width, UINT height, DXGI_FORMAT format) :
+    m_device(device),
+    m_queue(queue)
+{
+    // The ring lays the rows out like GetCopyableFootprints, only the row
+    // size of the format is needed from it.
+    const D3D12_RESOURCE_DESC textureDesc = CD3DX12_RESOURCE_DESC::Tex2D(format, width, height, 1, 1);
+    UINT numRows = 0;
+    UINT64 rowSize = 0;
+    device->GetCopyableFootprints(&textureDesc, 0, 1, 0, nullptr, &numRows, &rowSize, nullptr);
+
+    const UINT64 slotSize = ReadbackRing::GetSlotSize(static_cast<uint32_t>(rowSize), numRows);
+
+    const CD3DX12_HEAP_PROPERTIES readbackHeap(D3D12_HEAP_TYPE_READBACK);
+    const CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(slotSize * slotCount);
+    ThrowIfFailed(device->CreateCommittedResource(&readbackHeap, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+        D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&m_readback)));
+    m_readback->SetName(L"Texture Readback");
+
+    // Readback buffers may stay mapped, each slot is only read after its fence.
+    void* data = nullptr;
+    ThrowIfFailed(m_readback->Map(0, nullptr, &data));
+    m_ring.reset(new ReadbackRing(static_cast<const uint8_t*>(data), slotCount, slotSize));
+}
+
+D3D12TextureReadback::~D3D12TextureReadback()
+{
+    const D3D12_RANGE nothingWritten = {};
+    m_readback->Unmap(0, &nothingWritten);
+}
+
+UINT D3D12TextureReadback::Capture(_In_ ID3D12GraphicsCommandList* commandList, _In_ ID3D12Resource* texture, UINT64 frame)
+{
+    const D3D12_RESOURCE_DESC textureDesc = texture->GetDesc();
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout = {};
+    UINT numRows = 0;
+    UINT64 rowSize = 0;
+    m_device->GetCopyableFootprints(&textureDesc, 0, 1, 0, &layout, &numRows, &rowSize, nullptr);
+
+    const UINT capture = m_ring->Begin(static_cast<uint32_t>(rowSize), numRows, frame);
+    if (capture == ReadbackRing::InvalidCapture)
+    {
+        return capture;
+    }
+
+    const ReadbackFootprint& footprint = m_ring->GetFootprint(capture);
+    layout.Offset = footprint.offset;
+    layout.Footprint.RowPitch = footprint.rowPitch;
+
+    const CD3DX12_TEXTURE_COPY_LOCATION destination(m_readback.Get(), layout);
+    const CD3DX12_TEXTURE_COPY_LOCATION source(texture, 0);
+    commandList->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+    return capture;
+}
+
+UINT D3D12TextureReadback::Capture(_In_ ID3D12GraphicsCommandList* commandList, const RenderTexture& texture, UINT64 frame)
+{
+    return Capture(commandList, texture.GetResource(), frame);
+}
+
+void D3D12TextureReadback::FinishFrame(UINT64 fenceValue)
+{
+    m_ring->FinishFrame(fenceValue);
+}
+
+bool D3D12TextureReadback::TryGetCompleted(ReadbackView& view)
+{
+    return m_ring->Acquire(m_queue->GetCompletedValue(), view);
+}
+
+void D3D12TextureReadback::Release(const ReadbackView& view)
+{
+    m_ring->Release(view.capture);
+}
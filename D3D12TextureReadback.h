@@ -0,0 +1,43 @@
+#pragma once
+
+#include "stdafx.h"
+#include "ReadbackRing.h"
+#include "RenderTexture.h"
+#include "FrameScheduler.h"
+
+#include <memory>
+
+// Asynchronous texture captures. Each capture is a CopyTextureRegion into a
+// slot of one persistently mapped readback buffer; the mapped rows are handed
+// back frames later, once the queue fence has passed, so the GPU is never
+// waited on. Captures are recorded from one thread at a time.
+class D3D12TextureReadback
+{
+public:
+    // Slots are sized for a width x height texture of the given format.
+    D3D12TextureReadback(_In_ ID3D12Device* device, _In_ IFrameQueue* queue, UINT slotCount,
+        UINT width, UINT height, DXGI_FORMAT format);
+    ~D3D12TextureReadback();
+
+    // Record the copy of subresource 0, the texture must be in the
+    // D3D12_RESOURCE_STATE_COPY_SOURCE state. Returns
+    // ReadbackRing::InvalidCapture when every slot is still in use.
+    UINT Capture(_In_ ID3D12GraphicsCommandList* commandList, _In_ ID3D12Resource* texture, UINT64 frame);
+    UINT Capture(_In_ ID3D12GraphicsCommandList* commandList, const RenderTexture& texture, UINT64 frame);
+
+    // Close the current frame, see ReadbackRing::FinishFrame.
+    void FinishFrame(UINT64 fenceValue);
+
+    // Oldest capture the queue has completed. The view stays valid until it
+    // is released.
+    bool TryGetCompleted(ReadbackView& view);
+    void Release(const ReadbackView& view);
+
+    ReadbackRingStats GetStats() const { return m_ring->GetStats(); }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device>                m_device;
+    Microsoft::WRL::ComPtr<ID3D12Resource>              m_readback;
+    std::unique_ptr<ReadbackRing>                       m_ring;
+    IFrameQueue*                                        m_queue;
+};
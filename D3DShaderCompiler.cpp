@@ -0,0 +1,52 @@
+#include "stdafx.h"
+#include "D3DShaderCompiler.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace
+{
+    bool CompileWithD3D(const ShaderCompileRequest& request, const std::vector<uint8_t>& source,
+        std::vector<uint8_t>& bytecode, std::string& errors)
+    {
+        std::vector<D3D_SHADER_MACRO> macros;
+        for (const auto& define : request.defines)
+        {
+            D3D_SHADER_MACRO macro = { define.first.c_str(), define.second.c_str() };
+            macros.push_back(macro);
+        }
+        D3D_SHADER_MACRO terminator = { nullptr, nullptr };
+        macros.push_back(terminator);
+
+        // Includes are resolved relative to the source name.
+        ComPtr<ID3DBlob> code;
+        ComPtr<ID3DBlob> errorBlob;
+        HRESULT hr = D3DCompile(source.data(), source.size(), request.sourcePath.c_str(), macros.data(),
+            D3D_COMPILE_STANDARD_FILE_INCLUDE, request.entryPoint.c_str(), request.target.c_str(),
+            request.flags, 0, &code, &errorBlob);
+
+        if (errorBlob)
+        {
+            errors.assign(static_cast<const char*>(errorBlob->GetBufferPointer()), errorBlob->GetBufferSize());
+            OutputDebugStringA(errors.c_str());
+        }
+
+        if (FAILED(hr))
+        {
+            return false;
+        }
+
+        const uint8_t* data = static_cast<const uint8_t*>(code->GetBufferPointer());
+        bytecode.assign(data, data + code->GetBufferSize());
+        return true;
+    }
+}
+
+ShaderCompileCallback CreateD3DCompileCallback()
+{
+    return CompileWithD3D;
+}
+
+const char* GetD3DCompilerId()
+{
+    return D3DCOMPILER_DLL_A;
+}
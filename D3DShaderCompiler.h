@@ -0,0 +1,15 @@
+#pragma once
+
+#include "stdafx.h"
+#include "ShaderCache.h"
+
+// ShaderCompileCallback that runs the HLSL compiler from d3dcompiler_47.
+ShaderCompileCallback CreateD3DCompileCallback();
+
+// Identifies the compiler in ShaderCache keys.
+const char* GetD3DCompilerId();
+
+inline D3D12_SHADER_BYTECODE ToShaderBytecode(const ShaderBytecode& bytecode)
+{
+    return CD3DX12_SHADER_BYTECODE(bytecode.data, bytecode.size);
+}
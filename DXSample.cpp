@@ -11,6 +11,9 @@
 
 #include "stdafx.h"
 #include "DXSample.h"
+#include "BlurFilter.h"
+
+#include <algorithm>
 
 using namespace Microsoft::WRL;
 
@@ -18,7 +21,21 @@ DXSample::DXSample(UINT width, UINT height, std::wstring name) :
     m_width(width),
     m_height(height),
     m_title(name),
-    m_useWarpDevice(false)
+    m_useWarpDevice(false),
+    m_framesInFlight(2),
+    m_headless(false),
+    m_headlessFrameCount(1000),
+    m_simulationRate(60),
+    m_renderThread(false),
+    m_recordThreads(0),
+    m_instanceCount(1),
+    m_blurRadius(4),
+    m_boxBlur(false),
+    m_writeTrace(false),
+    m_captureInterval(0),
+    m_commandCaptureFrames(0),
+    m_hotReload(false),
+    m_dynamicResolutionMs(0.0f)
 {
     WCHAR assetsPath[512];
     GetAssetsPath(assetsPath, _countof(assetsPath));
@@ -112,6 +129,14 @@ void DXSample::SetCustomWindowText(LPCWSTR text)
     SetWindowText(Win32Application::GetHwnd(), windowText.c_str());
 }
 
+FrameLoopSettings DXSample::GetFrameLoopSettings() const
+{
+    FrameLoopSettings settings;
+    settings.stepSeconds = 1.0 / m_simulationRate;
+    settings.renderThread = m_renderThread;
+    return settings;
+}
+
 // Helper function for parsing any supplied command line args.
 _Use_decl_annotations_
 void DXSample::ParseCommandLineArgs(WCHAR* argv[], int argc)
@@ -124,5 +149,104 @@ void DXSample::ParseCommandLineArgs(WCHAR* argv[], int argc)
             m_useWarpDevice = true;
             m_title = m_title + L" (WARP)";
         }
+        else if ((_wcsnicmp(argv[i], L"-frames", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/frames", wcslen(argv[i])) == 0) && i + 1 < argc)
+        {
+            const int frames = _wtoi(argv[++i]);
+            m_framesInFlight = frames > 0 ? static_cast<UINT>(frames) : 1;
+        }
+        else if ((_wcsnicmp(argv[i], L"-threads", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/threads", wcslen(argv[i])) == 0) && i + 1 < argc)
+        {
+            const int threads = _wtoi(argv[++i]);
+            m_recordThreads = threads > 0 ? static_cast<UINT>(threads) : 0;
+        }
+        else if ((_wcsnicmp(argv[i], L"-step", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/step", wcslen(argv[i])) == 0) && i + 1 < argc)
+        {
+            const int rate = _wtoi(argv[++i]);
+            m_simulationRate = rate > 0 ? static_cast<UINT>(rate) : 60;
+        }
+        else if (_wcsnicmp(argv[i], L"-renderthread", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/renderthread", wcslen(argv[i])) == 0)
+        {
+            m_renderThread = true;
+        }
+        else if ((_wcsnicmp(argv[i], L"-instances", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/instances", wcslen(argv[i])) == 0) && i + 1 < argc)
+        {
+            const int instances = _wtoi(argv[++i]);
+            m_instanceCount = instances > 0 ? static_cast<UINT>(instances) : 1;
+        }
+        else if ((_wcsnicmp(argv[i], L"-texture", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/texture", wcslen(argv[i])) == 0) && i + 1 < argc)
+        {
+            m_texturePath = argv[++i];
+        }
+        else if ((_wcsnicmp(argv[i], L"-blur", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/blur", wcslen(argv[i])) == 0) && i + 1 < argc)
+        {
+            const int radius = _wtoi(argv[++i]);
+            m_blurRadius = std::min<UINT>(radius > 0 ? static_cast<UINT>(radius) : 0, BlurKernel::MaxRadius);
+        }
+        else if (_wcsnicmp(argv[i], L"-box", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/box", wcslen(argv[i])) == 0)
+        {
+            m_boxBlur = true;
+        }
+        else if (_wcsnicmp(argv[i], L"-trace", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/trace", wcslen(argv[i])) == 0)
+        {
+            m_writeTrace = true;
+        }
+        else if (_wcsnicmp(argv[i], L"-capture", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/capture", wcslen(argv[i])) == 0)
+        {
+            m_captureInterval = 1;
+
+            // The interval is optional.
+            if (i + 1 < argc && _wtoi(argv[i + 1]) > 0)
+            {
+                m_captureInterval = static_cast<UINT>(_wtoi(argv[++i]));
+            }
+        }
+        else if (_wcsnicmp(argv[i], L"-cmdcapture", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/cmdcapture", wcslen(argv[i])) == 0)
+        {
+            m_commandCaptureFrames = 60;
+
+            // The frame count is optional.
+            if (i + 1 < argc && _wtoi(argv[i + 1]) > 0)
+            {
+                m_commandCaptureFrames = static_cast<UINT>(_wtoi(argv[++i]));
+            }
+        }
+        else if (_wcsnicmp(argv[i], L"-dynres", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/dynres", wcslen(argv[i])) == 0)
+        {
+            m_dynamicResolutionMs = 16.0f;
+
+            // The budget is optional.
+            if (i + 1 < argc && _wtof(argv[i + 1]) > 0.0)
+            {
+                m_dynamicResolutionMs = static_cast<float>(_wtof(argv[++i]));
+            }
+        }
+        else if (_wcsnicmp(argv[i], L"-headless", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/headless", wcslen(argv[i])) == 0)
+        {
+            m_headless = true;
+
+            // The frame count is optional.
+            if (i + 1 < argc && _wtoi(argv[i + 1]) > 0)
+            {
+                m_headlessFrameCount = static_cast<UINT>(_wtoi(argv[++i]));
+            }
+        }
+        else if (_wcsnicmp(argv[i], L"-hotreload", wcslen(argv[i])) == 0 ||
+            _wcsnicmp(argv[i], L"/hotreload", wcslen(argv[i])) == 0)
+        {
+            m_hotReload = true;
+        }
     }
 }
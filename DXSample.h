@@ -13,16 +13,18 @@
 
 #include "DXSampleHelper.h"
 #include "Win32Application.h"
+#include "FrameLoop.h"
 
-class DXSample
+class DXSample : public IFrameBackend
 {
 public:
     DXSample(UINT width, UINT height, std::wstring name);
     virtual ~DXSample();
 
     virtual void OnInit() = 0;
-    virtual void OnUpdate() = 0;
-    virtual void OnRender() = 0;
+    virtual void OnUpdate(double stepSeconds) = 0;
+    virtual void OnPreparePacket(const FramePacket& packet) = 0;
+    virtual void OnRender(const FramePacket& packet) = 0;
     virtual void OnDestroy() = 0;
 
     // Samples override the event handlers to handle specific messages.
@@ -33,6 +35,9 @@ public:
     UINT GetWidth() const           { return m_width; }
     UINT GetHeight() const          { return m_height; }
     const WCHAR* GetTitle() const   { return m_title.c_str(); }
+    bool IsHeadless() const         { return m_headless; }
+    UINT GetHeadlessFrameCount() const { return m_headlessFrameCount; }
+    FrameLoopSettings GetFrameLoopSettings() const;
 
     void ParseCommandLineArgs(_In_reads_(argc) WCHAR* argv[], int argc);
 
@@ -54,6 +59,47 @@ protected:
     // Adapter info.
     bool m_useWarpDevice;
 
+    // Number of frames the CPU may record ahead of the GPU.
+    UINT m_framesInFlight;
+
+    // Headless mode renders offscreen without a window or swap chain.
+    bool m_headless;
+    UINT m_headlessFrameCount;
+
+    // Fixed simulation steps per second, and whether frames are rendered on
+    // a thread of their own.
+    UINT m_simulationRate;
+    bool m_renderThread;
+
+    // Threads recording command lists, 0 for one per core.
+    UINT m_recordThreads;
+
+    // Triangles drawn by the scene pass, through one indirect draw.
+    UINT m_instanceCount;
+
+    // DDS texture the triangles are drawn with, none when empty.
+    std::wstring m_texturePath;
+
+    // Radius of the blur applied to the offscreen texture, 0 to disable it.
+    UINT m_blurRadius;
+    bool m_boxBlur;
+
+    // Write a Chrome trace of the last profiled frames on exit.
+    bool m_writeTrace;
+
+    // Read back every Nth frame on the CPU, 0 to disable it.
+    UINT m_captureInterval;
+
+    // Capture the command lists of the first N frames, 0 to disable it.
+    UINT m_commandCaptureFrames;
+
+    // Recompile the shaders when their files change.
+    bool m_hotReload;
+
+    // GPU frame time budget of the dynamic resolution, in milliseconds, 0 to
+    // render the scene at full size.
+    float m_dynamicResolutionMs;
+
 private:
     // Root assets path.
     std::wstring m_assetsPath;
@@ -0,0 +1,371 @@
+#include "DdsTexture.h"
+
+#include <cstring>
+
+namespace
+{
+    const uint32_t DdsMagic = 0x20534444;               // "DDS "
+    const uint32_t HeaderSize = 124;
+    const uint32_t PixelFormatSize = 32;
+    const uint32_t Dx10HeaderSize = 20;
+
+    // DDS_HEADER flags, caps2 and pixel format flags.
+    const uint32_t HeaderFlagDepth = 0x800000;
+    const uint32_t Caps2Cubemap = 0x200;
+    const uint32_t Caps2CubemapAllFaces = 0xfc00;
+    const uint32_t Caps2Volume = 0x200000;
+    const uint32_t PixelFormatAlpha = 0x2;
+    const uint32_t PixelFormatFourCC = 0x4;
+    const uint32_t PixelFormatRgb = 0x40;
+    const uint32_t PixelFormatLuminance = 0x20000;
+    const uint32_t PixelFormatBumpDuDv = 0x80000;
+
+    // DDS_HEADER_DXT10 misc flags.
+    const uint32_t MiscTextureCube = 0x4;
+    const uint32_t AlphaModeMask = 0x7;
+    const uint32_t AlphaModePremultiplied = 2;
+
+    // D3D12_REQ_* limits.
+    const uint32_t MaxTextureSize = 16384;
+    const uint32_t MaxVolumeSize = 2048;
+    const uint32_t MaxArraySize = 2048;
+
+    uint32_t MakeFourCC(char a, char b, char c, char d)
+    {
+        return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) | (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+    }
+
+    uint32_t ReadUint(const uint8_t* data, uint32_t offset)
+    {
+        uint32_t value;
+        memcpy(&value, data + offset, sizeof(value));
+        return value;
+    }
+
+    struct PixelFormat
+    {
+        uint32_t flags;
+        uint32_t fourCC;
+        uint32_t bitCount;
+        uint32_t masks[4];
+
+        bool HasMasks(uint32_t r, uint32_t g, uint32_t b, uint32_t a) const
+        {
+            return masks[0] == r && masks[1] == g && masks[2] == b && masks[3] == a;
+        }
+    };
+
+    // The DXGI format of a legacy pixel format, the mapping of DirectXTex.
+    // Returns 0 (DXGI_FORMAT_UNKNOWN) when there is none.
+    uint32_t GetLegacyFormat(const PixelFormat& format, bool* premultipliedAlpha)
+    {
+        if (format.flags & PixelFormatFourCC)
+        {
+            switch (format.fourCC)
+            {
+            case 36:  return 11;                        // D3DFMT_A16B16G16R16
+            case 110: return 13;                        // D3DFMT_Q16W16V16U16
+            case 111: return 54;                        // D3DFMT_R16F
+            case 112: return 34;                        // D3DFMT_G16R16F
+            case 113: return 10;                        // D3DFMT_A16B16G16R16F
+            case 114: return 41;                        // D3DFMT_R32F
+            case 115: return 16;                        // D3DFMT_G32R32F
+            case 116: return 2;                         // D3DFMT_A32B32G32R32F
+            default:
+                break;
+            }
+
+            if (format.fourCC == MakeFourCC('D', 'X', 'T', '1')) return 71;
+            if (format.fourCC == MakeFourCC('D', 'X', 'T', '3')) return 74;
+            if (format.fourCC == MakeFourCC('D', 'X', 'T', '5')) return 77;
+            if (format.fourCC == MakeFourCC('D', 'X', 'T', '2'))
+            {
+                *premultipliedAlpha = true;
+                return 74;
+            }
+            if (format.fourCC == MakeFourCC('D', 'X', 'T', '4'))
+            {
+                *premultipliedAlpha = true;
+                return 77;
+            }
+            if (format.fourCC == MakeFourCC('A', 'T', 'I', '1') || format.fourCC == MakeFourCC('B', 'C', '4', 'U')) return 80;
+            if (format.fourCC == MakeFourCC('B', 'C', '4', 'S')) return 81;
+            if (format.fourCC == MakeFourCC('A', 'T', 'I', '2') || format.fourCC == MakeFourCC('B', 'C', '5', 'U')) return 83;
+            if (format.fourCC == MakeFourCC('B', 'C', '5', 'S')) return 84;
+            return 0;
+        }
+
+        if (format.flags & PixelFormatRgb)
+        {
+            switch (format.bitCount)
+            {
+            case 32:
+                if (format.HasMasks(0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000)) return 28;
+                if (format.HasMasks(0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000)) return 87;
+                if (format.HasMasks(0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000)) return 88;
+                // D3DX writes R10G10B10A2 with the red and blue masks swapped.
+                if (format.HasMasks(0x3ff00000, 0x000ffc00, 0x000003ff, 0xc0000000)) return 24;
+                if (format.HasMasks(0x000003ff, 0x000ffc00, 0x3ff00000, 0xc0000000)) return 24;
+                if (format.HasMasks(0x0000ffff, 0xffff0000, 0x00000000, 0x00000000)) return 35;
+                if (format.HasMasks(0xffffffff, 0x00000000, 0x00000000, 0x00000000)) return 41;
+                return 0;
+            case 16:
+                if (format.HasMasks(0x7c00, 0x03e0, 0x001f, 0x8000)) return 86;
+                if (format.HasMasks(0xf800, 0x07e0, 0x001f, 0x0000)) return 85;
+                if (format.HasMasks(0x0f00, 0x00f0, 0x000f, 0xf000)) return 115;
+                return 0;
+            default:
+                return 0;
+            }
+        }
+
+        if (format.flags & PixelFormatLuminance)
+        {
+            if (format.bitCount == 8 && format.HasMasks(0xff, 0, 0, 0)) return 61;
+            if (format.bitCount == 16 && format.HasMasks(0xffff, 0, 0, 0)) return 56;
+            if (format.bitCount == 16 && format.HasMasks(0x00ff, 0, 0, 0xff00)) return 49;
+            return 0;
+        }
+
+        if (format.flags & PixelFormatAlpha)
+        {
+            return format.bitCount == 8 ? 65 : 0;
+        }
+
+        if (format.flags & PixelFormatBumpDuDv)
+        {
+            if (format.bitCount == 16 && format.HasMasks(0x00ff, 0xff00, 0, 0)) return 51;
+            if (format.bitCount == 32 && format.HasMasks(0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000)) return 31;
+            if (format.bitCount == 32 && format.HasMasks(0x0000ffff, 0xffff0000, 0, 0)) return 37;
+            return 0;
+        }
+
+        return 0;
+    }
+
+    uint32_t GetFullMipCount(uint32_t width, uint32_t height, uint32_t depth)
+    {
+        uint32_t size = width > height ? width : height;
+        size = size > depth ? size : depth;
+
+        uint32_t count = 1;
+        while (size > 1)
+        {
+            size >>= 1;
+            count++;
+        }
+        return count;
+    }
+}
+
+const char* GetDdsResultName(DdsResult result)
+{
+    switch (result)
+    {
+    case DdsResultOk:                   return "ok";
+    case DdsResultTruncated:            return "truncated";
+    case DdsResultBadMagic:             return "not a DDS file";
+    case DdsResultBadHeader:            return "invalid header";
+    case DdsResultUnsupportedFormat:    return "unsupported format";
+    default:                            return "unknown";
+    }
+}
+
+DdsTexture::DdsTexture() :
+    m_data(nullptr),
+    m_desc(),
+    m_premultipliedAlpha(false)
+{
+}
+
+DdsResult DdsTexture::Parse(const uint8_t* data, uint64_t size)
+{
+    m_data = nullptr;
+    m_desc = TextureDesc();
+    m_premultipliedAlpha = false;
+    m_subresources.clear();
+
+    uint64_t dataOffset = 0;
+    const DdsResult result = ParseHeader(data, size, &dataOffset);
+    if (result != DdsResultOk)
+    {
+        return result;
+    }
+
+    uint32_t blockSize = 0;
+    uint32_t bytesPerBlock = 0;
+    if (!GetFormatBlockInfo(m_desc.format, &blockSize, &bytesPerBlock))
+    {
+        m_desc = TextureDesc();
+        return DdsResultUnsupportedFormat;
+    }
+
+    // The dimensions are within the D3D12 limits, the sizes cannot overflow.
+    std::vector<DdsSubresource> subresources;
+    subresources.reserve(static_cast<size_t>(m_desc.arraySize) * m_desc.mipCount);
+    uint64_t offset = dataOffset;
+    for (uint32_t slice = 0; slice < m_desc.arraySize; ++slice)
+    {
+        for (uint32_t mip = 0; mip < m_desc.mipCount; ++mip)
+        {
+            DdsSubresource subresource;
+            subresource.offset = offset;
+            subresource.width = GetMipSize(m_desc.width, mip);
+            subresource.height = GetMipSize(m_desc.height, mip);
+            subresource.depth = GetMipSize(m_desc.depth, mip);
+            subresource.rowSize = (subresource.width + blockSize - 1) / blockSize * bytesPerBlock;
+            subresource.rowCount = (subresource.height + blockSize - 1) / blockSize;
+            subresource.size = static_cast<uint64_t>(subresource.rowSize) * subresource.rowCount * subresource.depth;
+
+            offset += subresource.size;
+            if (offset > size)
+            {
+                m_desc = TextureDesc();
+                return DdsResultTruncated;
+            }
+            subresources.push_back(subresource);
+        }
+    }
+
+    m_data = data;
+    m_subresources.swap(subresources);
+    return DdsResultOk;
+}
+
+DdsResult DdsTexture::ParseHeader(const uint8_t* data, uint64_t size, uint64_t* dataOffset)
+{
+    if (size < sizeof(uint32_t) + HeaderSize)
+    {
+        return size >= sizeof(uint32_t) && ReadUint(data, 0) != DdsMagic ? DdsResultBadMagic : DdsResultTruncated;
+    }
+    if (ReadUint(data, 0) != DdsMagic)
+    {
+        return DdsResultBadMagic;
+    }
+
+    const uint8_t* header = data + sizeof(uint32_t);
+    if (ReadUint(header, 0) != HeaderSize || ReadUint(header, 72) != PixelFormatSize)
+    {
+        return DdsResultBadHeader;
+    }
+
+    const uint32_t flags = ReadUint(header, 4);
+    const uint32_t caps2 = ReadUint(header, 108);
+    PixelFormat pixelFormat;
+    pixelFormat.flags = ReadUint(header, 76);
+    pixelFormat.fourCC = ReadUint(header, 80);
+    pixelFormat.bitCount = ReadUint(header, 84);
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        pixelFormat.masks[i] = ReadUint(header, 88 + i * 4);
+    }
+
+    TextureDesc desc = {};
+    desc.height = ReadUint(header, 8);
+    desc.width = ReadUint(header, 12);
+    desc.depth = 1;
+    desc.mipCount = ReadUint(header, 24) ? ReadUint(header, 24) : 1;
+    desc.arraySize = 1;
+    *dataOffset = sizeof(uint32_t) + HeaderSize;
+
+    const bool dx10 = (pixelFormat.flags & PixelFormatFourCC) && pixelFormat.fourCC == MakeFourCC('D', 'X', '1', '0');
+    if (dx10)
+    {
+        if (size < *dataOffset + Dx10HeaderSize)
+        {
+            return DdsResultTruncated;
+        }
+
+        const uint8_t* extended = data + *dataOffset;
+        *dataOffset += Dx10HeaderSize;
+        desc.format = ReadUint(extended, 0);
+        desc.arraySize = ReadUint(extended, 12);
+        m_premultipliedAlpha = (ReadUint(extended, 16) & AlphaModeMask) == AlphaModePremultiplied;
+        if (desc.arraySize == 0)
+        {
+            return DdsResultBadHeader;
+        }
+
+        switch (ReadUint(extended, 4))
+        {
+        case TextureDimension1D:
+            // Some writers leave the height of 1D textures at 0.
+            if (desc.height > 1)
+            {
+                return DdsResultBadHeader;
+            }
+            desc.dimension = TextureDimension1D;
+            desc.height = 1;
+            break;
+        case TextureDimension2D:
+            desc.dimension = TextureDimension2D;
+            if (ReadUint(extended, 8) & MiscTextureCube)
+            {
+                if (desc.arraySize > MaxArraySize / 6)
+                {
+                    return DdsResultBadHeader;
+                }
+                desc.cube = true;
+                desc.arraySize *= 6;
+            }
+            break;
+        case TextureDimension3D:
+            if (!(flags & HeaderFlagDepth) || desc.arraySize != 1)
+            {
+                return DdsResultBadHeader;
+            }
+            desc.dimension = TextureDimension3D;
+            desc.depth = ReadUint(header, 20);
+            break;
+        default:
+            return DdsResultBadHeader;
+        }
+    }
+    else
+    {
+        desc.format = GetLegacyFormat(pixelFormat, &m_premultipliedAlpha);
+        if (desc.format == 0)
+        {
+            return DdsResultUnsupportedFormat;
+        }
+
+        desc.dimension = TextureDimension2D;
+        if (flags & HeaderFlagDepth && caps2 & Caps2Volume)
+        {
+            desc.dimension = TextureDimension3D;
+            desc.depth = ReadUint(header, 20);
+        }
+        else if (caps2 & Caps2Cubemap)
+        {
+            // Legacy cube maps may leave faces out, D3D has no such thing.
+            if ((caps2 & Caps2CubemapAllFaces) != Caps2CubemapAllFaces)
+            {
+                return DdsResultUnsupportedFormat;
+            }
+            desc.cube = true;
+            desc.arraySize = 6;
+        }
+    }
+
+    const uint32_t maxSize = desc.dimension == TextureDimension3D ? MaxVolumeSize : MaxTextureSize;
+    if (desc.width == 0 || desc.width > maxSize || desc.height == 0 || desc.height > maxSize
+        || desc.depth == 0 || desc.depth > maxSize || desc.arraySize > MaxArraySize
+        || (desc.cube && desc.width != desc.height)
+        || desc.mipCount > GetFullMipCount(desc.width, desc.height, desc.depth))
+    {
+        return DdsResultBadHeader;
+    }
+
+    m_desc = desc;
+    return DdsResultOk;
+}
+
+uint64_t DdsTexture::GetMipBytes(uint32_t mip) const
+{
+    uint64_t size = 0;
+    for (uint32_t slice = 0; slice < m_desc.arraySize; ++slice)
+    {
+        size += m_subresources[GetSubresourceIndex(m_desc, mip, slice)].size;
+    }
+    return size;
+}
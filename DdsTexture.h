@@ -0,0 +1,64 @@
+#pragma once
+
+#include "TextureLayout.h"
+
+#include <cstdint>
+#include <vector>
+
+enum DdsResult
+{
+    DdsResultOk,
+    DdsResultTruncated,             // The file ends before the header or the data.
+    DdsResultBadMagic,
+    DdsResultBadHeader,             // Header sizes, flags or dimensions out of range.
+    DdsResultUnsupportedFormat
+};
+
+const char* GetDdsResultName(DdsResult result);
+
+// Where a subresource is in the file. Rows are packed, rowSize apart.
+struct DdsSubresource
+{
+    uint64_t offset;
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t rowSize;               // Bytes per row of blocks.
+    uint32_t rowCount;              // Rows of blocks per depth slice.
+    uint64_t size;
+};
+
+// DDS texture file: the legacy header with its pixel formats and four
+// character codes, or the DX10 extended header. 1D, 2D and 3D textures, mip
+// chains, arrays and cube maps, every format of GetFormatBlockInfo. Every
+// size and offset is checked against the file, a corrupt file is rejected and
+// never read past its end.
+//
+// The subresources follow each other in the file in the order of their
+// subresource index, every mip of the first slice first.
+class DdsTexture
+{
+public:
+    DdsTexture();
+
+    // The data is not copied, it must outlive the texture.
+    DdsResult Parse(const uint8_t* data, uint64_t size);
+
+    const TextureDesc& GetDesc() const                          { return m_desc; }
+    bool IsPremultipliedAlpha() const                           { return m_premultipliedAlpha; }
+
+    uint32_t GetSubresourceCount() const                        { return static_cast<uint32_t>(m_subresources.size()); }
+    const DdsSubresource& GetSubresource(uint32_t index) const  { return m_subresources[index]; }
+    const uint8_t* GetSubresourceData(uint32_t index) const     { return m_data + m_subresources[index].offset; }
+
+    // Bytes of every subresource of a mip, over all the array slices.
+    uint64_t GetMipBytes(uint32_t mip) const;
+
+private:
+    DdsResult ParseHeader(const uint8_t* data, uint64_t size, uint64_t* dataOffset);
+
+    const uint8_t* m_data;
+    TextureDesc m_desc;
+    bool m_premultipliedAlpha;
+    std::vector<DdsSubresource> m_subresources;
+};
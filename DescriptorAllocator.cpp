@@ -0,0 +1,165 @@
+#include "DescriptorAllocator.h"
+
+#include <stdexcept>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    uint32_t CountTrailingZeros(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(value));
+#endif
+    }
+}
+
+const uint32_t PersistentDescriptorAllocator::InvalidIndex;
+
+PersistentDescriptorAllocator::PersistentDescriptorAllocator(uint32_t baseIndex, uint32_t capacity) :
+    m_baseIndex(baseIndex),
+    m_capacity(capacity),
+    m_allocatedCount(0),
+    m_searchWord(0),
+    m_words((capacity + 63) / 64, 0)
+{
+    // Mark the bits past the end of the heap as allocated so the word scan
+    // never hands them out.
+    if (capacity % 64)
+    {
+        m_words.back() = ~0ull << (capacity % 64);
+    }
+}
+
+bool PersistentDescriptorAllocator::IsAllocated(uint32_t slot) const
+{
+    return (m_words[slot / 64] >> (slot % 64)) & 1;
+}
+
+void PersistentDescriptorAllocator::SetRange(uint32_t slot, uint32_t count, bool allocated)
+{
+    for (uint32_t i = slot; i < slot + count; ++i)
+    {
+        const uint64_t bit = 1ull << (i % 64);
+        if (allocated)
+        {
+            m_words[i / 64] |= bit;
+        }
+        else
+        {
+            m_words[i / 64] &= ~bit;
+        }
+    }
+}
+
+uint32_t PersistentDescriptorAllocator::AllocateSingle()
+{
+    for (uint32_t word = m_searchWord; word < m_words.size(); ++word)
+    {
+        if (m_words[word] != ~0ull)
+        {
+            const uint32_t bit = CountTrailingZeros(~m_words[word]);
+            m_words[word] |= 1ull << bit;
+            m_searchWord = word;
+            return word * 64 + bit;
+        }
+    }
+
+    m_searchWord = static_cast<uint32_t>(m_words.size());
+    return InvalidIndex;
+}
+
+uint32_t PersistentDescriptorAllocator::AllocateRange(uint32_t count)
+{
+    uint32_t runStart = 0;
+    uint32_t runLength = 0;
+
+    for (uint32_t slot = m_searchWord * 64; slot < m_capacity; ++slot)
+    {
+        // Skip full words in one step.
+        if (slot % 64 == 0 && m_words[slot / 64] == ~0ull)
+        {
+            runLength = 0;
+            slot += 63;
+            continue;
+        }
+
+        if (IsAllocated(slot))
+        {
+            runLength = 0;
+            continue;
+        }
+
+        if (runLength++ == 0)
+        {
+            runStart = slot;
+        }
+
+        if (runLength == count)
+        {
+            SetRange(runStart, count, true);
+            return runStart;
+        }
+    }
+
+    return InvalidIndex;
+}
+
+uint32_t PersistentDescriptorAllocator::Allocate(uint32_t count)
+{
+    if (count == 0 || count > m_capacity - m_allocatedCount)
+    {
+        return InvalidIndex;
+    }
+
+    const uint32_t slot = count == 1 ? AllocateSingle() : AllocateRange(count);
+    if (slot == InvalidIndex)
+    {
+        return InvalidIndex;
+    }
+
+    m_allocatedCount += count;
+    return m_baseIndex + slot;
+}
+
+void PersistentDescriptorAllocator::Free(uint32_t index, uint32_t count)
+{
+    if (index < m_baseIndex || index - m_baseIndex >= m_capacity || count > m_capacity - (index - m_baseIndex))
+    {
+        throw std::out_of_range("PersistentDescriptorAllocator::Free");
+    }
+
+    const uint32_t slot = index - m_baseIndex;
+    for (uint32_t i = slot; i < slot + count; ++i)
+    {
+        if (!IsAllocated(i))
+        {
+            throw std::logic_error("PersistentDescriptorAllocator: descriptor freed twice");
+        }
+    }
+
+    SetRange(slot, count, false);
+    m_allocatedCount -= count;
+
+    if (slot / 64 < m_searchWord)
+    {
+        m_searchWord = slot / 64;
+    }
+}
+
+TransientDescriptorAllocator::TransientDescriptorAllocator(uint32_t baseIndex, uint32_t capacity) :
+    m_baseIndex(baseIndex),
+    m_ring(capacity)
+{
+}
+
+uint32_t TransientDescriptorAllocator::Allocate(uint32_t count, IFrameQueue& queue)
+{
+    return m_baseIndex + static_cast<uint32_t>(m_ring.AllocateBlocking(count, 1, queue));
+}
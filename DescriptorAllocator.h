@@ -0,0 +1,65 @@
+#pragma once
+
+#include "UploadRing.h"
+
+#include <cstdint>
+#include <vector>
+
+// Index math for descriptor heaps, independent of D3D12. Indices are relative
+// to the start of the heap.
+
+// Persistent descriptor slots backed by a bitmap, one bit per descriptor.
+// Single slots are found a 64-bit word at a time; ranges use first fit.
+class PersistentDescriptorAllocator
+{
+public:
+    static const uint32_t InvalidIndex = ~0u;
+
+    PersistentDescriptorAllocator(uint32_t baseIndex, uint32_t capacity);
+
+    // Returns the first index of count contiguous free slots, or InvalidIndex.
+    uint32_t Allocate(uint32_t count = 1);
+
+    // Throws std::logic_error if any of the slots is not allocated.
+    void Free(uint32_t index, uint32_t count = 1);
+
+    uint32_t GetBaseIndex() const       { return m_baseIndex; }
+    uint32_t GetCapacity() const        { return m_capacity; }
+    uint32_t GetAllocatedCount() const  { return m_allocatedCount; }
+
+private:
+    bool IsAllocated(uint32_t slot) const;
+    void SetRange(uint32_t slot, uint32_t count, bool allocated);
+    uint32_t AllocateSingle();
+    uint32_t AllocateRange(uint32_t count);
+
+    uint32_t m_baseIndex;
+    uint32_t m_capacity;
+    uint32_t m_allocatedCount;
+    uint32_t m_searchWord;      // No free slot below this word.
+    std::vector<uint64_t> m_words;
+};
+
+// Per-frame linear ranges of descriptors, recycled once the frame that used
+// them has completed on the queue. Built on UploadRing, counting descriptors
+// instead of bytes.
+class TransientDescriptorAllocator
+{
+public:
+    TransientDescriptorAllocator(uint32_t baseIndex, uint32_t capacity);
+
+    // First index of count contiguous descriptors. Waits on the queue when the
+    // range is full of frames still in flight.
+    uint32_t Allocate(uint32_t count, IFrameQueue& queue);
+
+    void FinishFrame(uint64_t fenceValue)               { m_ring.FinishFrame(fenceValue); }
+    void ReleaseCompleted(uint64_t completedFenceValue) { m_ring.ReleaseCompleted(completedFenceValue); }
+
+    uint32_t GetBaseIndex() const   { return m_baseIndex; }
+    uint32_t GetCapacity() const    { return static_cast<uint32_t>(m_ring.GetSize()); }
+    uint32_t GetUsedCount() const   { return static_cast<uint32_t>(m_ring.GetUsedSize()); }
+
+private:
+    uint32_t m_baseIndex;
+    UploadRing m_ring;
+};
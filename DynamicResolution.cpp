@@ -0,0 +1,246 @@
+#include "DynamicResolution.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace
+{
+    // Bound on the accumulated error, keeps the integral from winding up
+    // while the scale sits at a limit.
+    const double IntegralLimit = 4.0;
+
+    // Largest area change of a single update.
+    const double MaxStep = 0.25;
+}
+
+DynamicResolutionSettings::DynamicResolutionSettings() :
+    targetMs(16.0),
+    headroom(0.1),
+    minScale(0.5),
+    maxScale(1.0),
+    kp(0.5),
+    ki(0.05),
+    kd(0.1),
+    historySize(4),
+    panicRatio(1.3),
+    deadband(0.03)
+{
+}
+
+DynamicResolutionController::DynamicResolutionController(const DynamicResolutionSettings& settings) :
+    m_settings(settings)
+{
+    if (settings.targetMs <= 0.0 || settings.headroom < 0.0 || settings.headroom >= 1.0 || settings.minScale <= 0.0 || settings.minScale > settings.maxScale || settings.historySize == 0)
+    {
+        throw std::invalid_argument("DynamicResolutionController");
+    }
+
+    Reset();
+}
+
+void DynamicResolutionController::Reset()
+{
+    m_history.assign(m_settings.historySize, 0.0);
+    m_historyNext = 0;
+    m_historyCount = 0;
+    m_integral = 0.0;
+    m_previousError = 0.0;
+    m_scale = m_settings.maxScale;
+    m_area = m_scale * m_scale;
+}
+
+double DynamicResolutionController::Update(double gpuFrameMs, double frameScale)
+{
+    // No measurement yet, the timestamps of the frame were not available.
+    if (gpuFrameMs <= 0.0 || frameScale <= 0.0)
+    {
+        return m_scale;
+    }
+
+    // The measured frame may predate the last few changes of the scale: work
+    // on its cost per unit of area, and predict the time at the current area.
+    const double frameCost = gpuFrameMs / (frameScale * frameScale);
+
+    const double targetMs = m_settings.targetMs * (1.0 - m_settings.headroom);
+    const double minArea = m_settings.minScale * m_settings.minScale;
+    const double maxArea = m_settings.maxScale * m_settings.maxScale;
+
+    if (frameCost * m_area > m_settings.targetMs * m_settings.panicRatio)
+    {
+        // Far over budget: drop to the area that frame says fits, without
+        // waiting for the average to catch up, and forget the cheaper frames.
+        m_area = std::min<double>(std::max<double>(targetMs / frameCost, minArea), maxArea);
+        m_history.assign(m_settings.historySize, 0.0);
+        m_history[0] = frameCost;
+        m_historyNext = 1 % m_settings.historySize;
+        m_historyCount = 1;
+        m_integral = 0.0;
+        m_previousError = 0.0;
+        m_scale = std::sqrt(m_area);
+        return m_scale;
+    }
+
+    m_history[m_historyNext] = frameCost;
+    m_historyNext = (m_historyNext + 1) % m_settings.historySize;
+    m_historyCount = std::min<uint32_t>(m_historyCount + 1, m_settings.historySize);
+
+    double total = 0.0;
+    for (uint32_t i = 0; i < m_historyCount; ++i)
+    {
+        total += m_history[i];
+    }
+    const double averageMs = total / m_historyCount * m_area;
+
+    double error = (targetMs - averageMs) / targetMs;
+    if (std::fabs(error) < m_settings.deadband)
+    {
+        error = 0.0;
+    }
+
+    // Only integrate while the output can still move in that direction.
+    const bool saturated = (error > 0.0 && m_area >= maxArea) || (error < 0.0 && m_area <= minArea);
+    if (!saturated)
+    {
+        m_integral = std::min<double>(std::max<double>(m_integral + error, -IntegralLimit), IntegralLimit);
+    }
+
+    const double derivative = error - m_previousError;
+    m_previousError = error;
+
+    double output = m_settings.kp * error + m_settings.ki * m_integral + m_settings.kd * derivative;
+    output = std::min<double>(std::max<double>(output, -MaxStep), MaxStep);
+
+    m_area = std::min<double>(std::max<double>(m_area * (1.0 + output), minArea), maxArea);
+    m_scale = std::sqrt(m_area);
+    return m_scale;
+}
+
+void DynamicResolutionController::GetScaledSize(double scale, uint32_t width, uint32_t height, uint32_t alignment,
+    uint32_t& scaledWidth, uint32_t& scaledHeight)
+{
+    alignment = std::max<uint32_t>(alignment, 1);
+
+    const uint32_t w = static_cast<uint32_t>(width * scale) / alignment * alignment;
+    const uint32_t h = static_cast<uint32_t>(height * scale) / alignment * alignment;
+    scaledWidth = std::min<uint32_t>(std::max<uint32_t>(w, alignment), width);
+    scaledHeight = std::min<uint32_t>(std::max<uint32_t>(h, alignment), height);
+}
+
+DynamicResolutionSimulation SimulateDynamicResolution(const DynamicResolutionSettings& settings,
+    const std::vector<double>& fullResolutionMs, double fixedMs, uint32_t latencyFrames)
+{
+    DynamicResolutionController controller(settings);
+
+    DynamicResolutionSimulation result = {};
+    result.minScale = controller.GetScale();
+
+    std::vector<double> frameMs(fullResolutionMs.size());
+    std::vector<double> frameScale(fullResolutionMs.size());
+    double scale = controller.GetScale();
+    double totalMs = 0.0;
+    double totalScale = 0.0;
+
+    for (size_t frame = 0; frame < fullResolutionMs.size(); ++frame)
+    {
+        frameMs[frame] = fullResolutionMs[frame] * scale * scale + fixedMs;
+        frameScale[frame] = scale;
+
+        totalMs += frameMs[frame];
+        totalScale += scale;
+        result.maxMs = std::max<double>(result.maxMs, frameMs[frame]);
+        result.minScale = std::min<double>(result.minScale, scale);
+        if (frameMs[frame] > settings.targetMs)
+        {
+            result.framesOverBudget++;
+        }
+
+        // The GPU time of a frame is only known once its timestamps are read back.
+        if (frame >= latencyFrames)
+        {
+            const double next = controller.Update(frameMs[frame - latencyFrames], frameScale[frame - latencyFrames]);
+            if (next != scale)
+            {
+                result.scaleChanges++;
+                scale = next;
+            }
+        }
+    }
+
+    result.frames = static_cast<uint32_t>(fullResolutionMs.size());
+    result.averageMs = result.frames ? totalMs / result.frames : 0.0;
+    result.averageScale = result.frames ? totalScale / result.frames : 0.0;
+    return result;
+}
+
+bool LoadDynamicResolutionTrace(const std::string& path, std::vector<double>& fullResolutionMs)
+{
+    std::vector<uint8_t> data;
+    if (!ReadFileBytes(path, data))
+    {
+        return false;
+    }
+
+    const std::string text(data.begin(), data.end());
+    fullResolutionMs.clear();
+    size_t start = 0;
+    while (start < text.size())
+    {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        char* parsed = nullptr;
+        const double ms = strtod(line.c_str(), &parsed);
+        while (*parsed == ' ' || *parsed == '\t')
+        {
+            parsed++;
+        }
+        if (parsed == line.c_str() || *parsed != '\0' || !(ms >= 0.0))
+        {
+            return false;
+        }
+        fullResolutionMs.push_back(ms);
+    }
+    return true;
+}
+
+bool SaveDynamicResolutionTrace(const std::string& path, const std::vector<double>& fullResolutionMs, const std::string& comment)
+{
+    std::string text;
+    size_t start = 0;
+    while (start < comment.size())
+    {
+        size_t end = comment.find('\n', start);
+        if (end == std::string::npos)
+        {
+            end = comment.size();
+        }
+        text += "# " + comment.substr(start, end - start) + "\n";
+        start = end + 1;
+    }
+
+    char line[32];
+    for (double ms : fullResolutionMs)
+    {
+        snprintf(line, sizeof(line), "%.3f\n", ms);
+        text += line;
+    }
+    return WriteFileAtomic(path, text.data(), text.size());
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct DynamicResolutionSettings
+{
+    double   targetMs;              // GPU frame time budget.
+    double   headroom;              // Fraction of the budget kept free for noise.
+    double   minScale;              // Per axis, of the output size.
+    double   maxScale;
+    double   kp;                    // PID gains, on the relative error of the frame time.
+    double   ki;
+    double   kd;
+    uint32_t historySize;           // Frame times averaged before the error is taken.
+    double   panicRatio;            // A single frame this far over budget drops the scale at once.
+    double   deadband;              // Relative error ignored, avoids resizing on noise.
+
+    DynamicResolutionSettings();
+};
+
+// Picks the render scale from measured GPU frame times. The GPU cost of the
+// scaled passes goes with their pixel count, so the controller works on the
+// area fraction: a PID on the relative error of the averaged frame time
+// against the budget grows or shrinks the area multiplicatively, and the
+// scale per axis is its square root. Frame times arrive several frames late,
+// rendered at an older scale: they are divided by the area of their own frame,
+// so a measurement that predates the last change is not taken for its result.
+class DynamicResolutionController
+{
+public:
+    explicit DynamicResolutionController(const DynamicResolutionSettings& settings = DynamicResolutionSettings());
+
+    // Feed the GPU time of a completed frame and the scale it was rendered
+    // at, returns the scale for the next one.
+    double Update(double gpuFrameMs, double frameScale);
+
+    void Reset();
+
+    double GetScale() const                         { return m_scale; }
+    const DynamicResolutionSettings& GetSettings() const { return m_settings; }
+
+    // Size of the scaled viewport, rounded down to a multiple of alignment
+    // and at least alignment pixels.
+    static void GetScaledSize(double scale, uint32_t width, uint32_t height, uint32_t alignment,
+        uint32_t& scaledWidth, uint32_t& scaledHeight);
+
+private:
+    DynamicResolutionSettings m_settings;
+    std::vector<double> m_history;
+    uint32_t m_historyNext;
+    uint32_t m_historyCount;
+    double m_integral;
+    double m_previousError;
+    double m_area;
+    double m_scale;
+};
+
+struct DynamicResolutionSimulation
+{
+    uint32_t frames;
+    uint32_t framesOverBudget;
+    double   averageMs;
+    double   maxMs;
+    double   averageScale;
+    double   minScale;
+    uint32_t scaleChanges;
+};
+
+// Replay a trace of full resolution GPU frame times: each frame costs its
+// trace time times the area fraction it was rendered at, plus fixedMs that
+// does not scale, and is only seen by the controller latencyFrames later.
+DynamicResolutionSimulation SimulateDynamicResolution(const DynamicResolutionSettings& settings,
+    const std::vector<double>& fullResolutionMs, double fixedMs, uint32_t latencyFrames);
+
+// Frame time traces for SimulateDynamicResolution: text, one full resolution
+// GPU time in milliseconds per line, lines starting with # are comments.
+// Load returns false if the file cannot be read or a line is not a time.
+bool LoadDynamicResolutionTrace(const std::string& path, std::vector<double>& fullResolutionMs);
+bool SaveDynamicResolutionTrace(const std::string& path, const std::vector<double>& fullResolutionMs, const std::string& comment);
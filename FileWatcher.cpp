@@ -0,0 +1,273 @@
+#include "FileWatcher.h"
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    std::string WithSeparator(const std::string& directory)
+    {
+        if (directory.empty() || directory.back() == '/' || directory.back() == '\\')
+        {
+            return directory;
+        }
+#ifdef _WIN32
+        return directory + '\\';
+#else
+        return directory + '/';
+#endif
+    }
+
+#ifdef _WIN32
+    std::wstring Utf8ToWide(const std::string& text)
+    {
+        if (text.empty())
+        {
+            return std::wstring();
+        }
+
+        const int length = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()), nullptr, 0);
+        std::wstring wide(length, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()), &wide[0], length);
+        return wide;
+    }
+
+    std::string WideToUtf8(const wchar_t* text, int length)
+    {
+        if (length == 0)
+        {
+            return std::string();
+        }
+
+        const int size = WideCharToMultiByte(CP_UTF8, 0, text, length, nullptr, 0, nullptr, nullptr);
+        std::string utf8(size, '\0');
+        WideCharToMultiByte(CP_UTF8, 0, text, length, &utf8[0], size, nullptr, nullptr);
+        return utf8;
+    }
+
+    // Large enough for the changes of a busy directory between two polls, an
+    // overflowing buffer drops its changes.
+    const DWORD NotifyBufferSize = 64 * 1024;
+#endif
+}
+
+#ifdef _WIN32
+
+// One outstanding ReadDirectoryChangesW per directory, completed in Poll.
+struct FileWatcher::Directory
+{
+    std::string path;
+    HANDLE handle;
+    OVERLAPPED overlapped;
+    DWORD buffer[NotifyBufferSize / sizeof(DWORD)];
+
+    bool Read()
+    {
+        return ReadDirectoryChangesW(handle, buffer, sizeof(buffer), FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, nullptr, &overlapped, nullptr) != FALSE;
+    }
+};
+
+FileWatcher::FileWatcher()
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    for (Directory* directory : m_directories)
+    {
+        DWORD bytes = 0;
+        CancelIoEx(directory->handle, &directory->overlapped);
+        GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, TRUE);
+        CloseHandle(directory->overlapped.hEvent);
+        CloseHandle(directory->handle);
+        delete directory;
+    }
+}
+
+bool FileWatcher::Watch(const std::string& path)
+{
+    const std::string directoryPath = WithSeparator(path);
+    for (const Directory* directory : m_directories)
+    {
+        if (_stricmp(directory->path.c_str(), directoryPath.c_str()) == 0)
+        {
+            return true;
+        }
+    }
+
+    const HANDLE handle = CreateFileW(Utf8ToWide(directoryPath).c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    Directory* directory = new Directory();
+    directory->path = directoryPath;
+    directory->handle = handle;
+    directory->overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!directory->overlapped.hEvent || !directory->Read())
+    {
+        if (directory->overlapped.hEvent)
+        {
+            CloseHandle(directory->overlapped.hEvent);
+        }
+        CloseHandle(handle);
+        delete directory;
+        return false;
+    }
+
+    m_directories.push_back(directory);
+    return true;
+}
+
+void FileWatcher::Poll(std::vector<std::string>& changed)
+{
+    for (Directory* directory : m_directories)
+    {
+        DWORD bytes = 0;
+        if (!GetOverlappedResult(directory->handle, &directory->overlapped, &bytes, FALSE))
+        {
+            // ERROR_IO_INCOMPLETE: nothing changed yet. A failed read is
+            // issued again below.
+            if (GetLastError() == ERROR_IO_INCOMPLETE)
+            {
+                continue;
+            }
+            bytes = 0;
+        }
+
+        // No bytes means the buffer overflowed and the changes are lost.
+        const uint8_t* entry = reinterpret_cast<const uint8_t*>(directory->buffer);
+        while (bytes)
+        {
+            const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(entry);
+            if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+            {
+                changed.push_back(directory->path + WideToUtf8(info->FileName, static_cast<int>(info->FileNameLength / sizeof(WCHAR))));
+            }
+
+            if (!info->NextEntryOffset)
+            {
+                break;
+            }
+            entry += info->NextEntryOffset;
+        }
+
+        ResetEvent(directory->overlapped.hEvent);
+        directory->Read();
+    }
+}
+
+#else
+
+struct FileWatcher::Directory
+{
+    std::string path;
+    int watch;
+};
+
+FileWatcher::FileWatcher() :
+    m_inotify(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    if (m_inotify >= 0)
+    {
+        close(m_inotify);
+    }
+
+    for (Directory* directory : m_directories)
+    {
+        delete directory;
+    }
+}
+
+bool FileWatcher::Watch(const std::string& path)
+{
+    if (m_inotify < 0)
+    {
+        return false;
+    }
+
+    // Files written in place close after writing, editors saving through a
+    // temporary file rename it over the original.
+    const int watch = inotify_add_watch(m_inotify, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watch < 0)
+    {
+        return false;
+    }
+
+    // inotify hands out the same watch for another spelling of a directory.
+    for (const Directory* directory : m_directories)
+    {
+        if (directory->watch == watch)
+        {
+            return true;
+        }
+    }
+
+    Directory* directory = new Directory();
+    directory->path = WithSeparator(path);
+    directory->watch = watch;
+    m_directories.push_back(directory);
+    return true;
+}
+
+void FileWatcher::Poll(std::vector<std::string>& changed)
+{
+    if (m_inotify < 0)
+    {
+        return;
+    }
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    for (;;)
+    {
+        const ssize_t bytes = read(m_inotify, buffer, sizeof(buffer));
+        if (bytes <= 0)
+        {
+            // EAGAIN once the queue is drained.
+            break;
+        }
+
+        for (ssize_t offset = 0; offset < bytes; )
+        {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (!event->len)
+            {
+                continue;
+            }
+
+            for (const Directory* directory : m_directories)
+            {
+                if (directory->watch == event->wd)
+                {
+                    changed.push_back(directory->path + event->name);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Reports the files written in a set of directories. The D3D12 sample watches
+// its shader sources with FileWatcher, tests feed changes in by hand.
+class IFileWatcher
+{
+public:
+    virtual ~IFileWatcher() {}
+
+    // Watch the files directly in directory, not in its subdirectories.
+    // Watching a directory twice is harmless. Returns false if it cannot be
+    // watched.
+    virtual bool Watch(const std::string& directory) = 0;
+
+    // Append the paths of the files created, written or renamed into a watched
+    // directory since the last call, as the watched directory followed by the
+    // file name. Never blocks. A file written in several steps is reported
+    // once per step.
+    virtual void Poll(std::vector<std::string>& changed) = 0;
+};
+
+// IFileWatcher on ReadDirectoryChangesW on Windows and inotify elsewhere.
+// Paths are UTF-8 on every platform.
+class FileWatcher : public IFileWatcher
+{
+public:
+    FileWatcher();
+    ~FileWatcher();
+
+    virtual bool Watch(const std::string& directory);
+    virtual void Poll(std::vector<std::string>& changed);
+
+private:
+    FileWatcher(const FileWatcher&);
+    FileWatcher& operator=(const FileWatcher&);
+
+    struct Directory;
+
+    std::vector<Directory*> m_directories;
+
+#ifndef _WIN32
+    int m_inotify;
+#endif
+};
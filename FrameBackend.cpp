@@ -0,0 +1,127 @@
+#include "FrameBackend.h"
+
+#include <algorithm>
+
+NullFrameBackend::NullFrameBackend(uint32_t framesInFlight, std::chrono::microseconds gpuFrameTime) :
+    m_framesInFlight(framesInFlight),
+    m_gpuFrameTime(gpuFrameTime),
+    m_updateTime(0),
+    m_framesRendered(0),
+    m_packetErrors(0),
+    m_slotFrames(),
+    m_recordThreads(1),
+    m_drawsPerFrame(0)
+{
+}
+
+void NullFrameBackend::SetRecordingWorkload(uint32_t recordThreads, uint32_t drawsPerFrame)
+{
+    m_recordThreads = recordThreads;
+    m_drawsPerFrame = drawsPerFrame;
+}
+
+void NullFrameBackend::SetUpdateWorkload(std::chrono::microseconds updateTime)
+{
+    m_updateTime = updateTime;
+}
+
+void NullFrameBackend::OnInit()
+{
+    m_calls.push_back(CallInit);
+
+    m_queue.reset(new SimulatedFrameQueue(m_gpuFrameTime));
+    m_scheduler.reset(new FrameScheduler(m_queue.get(), m_framesInFlight));
+    m_scheduler->BeginFrame();
+
+    if (m_drawsPerFrame)
+    {
+        m_jobs.reset(new JobSystem(m_recordThreads));
+        m_commandLists.reset(new RecordingCommandListBackend(m_jobs->GetThreadCount()));
+        m_recorder.reset(new ParallelCommandRecorder(*m_jobs, *m_commandLists));
+    }
+}
+
+void NullFrameBackend::OnUpdate(double /*stepSeconds*/)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_callMutex);
+        m_calls.push_back(CallUpdate);
+    }
+
+    // Spin rather than sleep, a simulation step keeps its thread busy.
+    const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + m_updateTime;
+    while (std::chrono::steady_clock::now() < end)
+    {
+    }
+}
+
+void NullFrameBackend::OnPreparePacket(const FramePacket& packet)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_callMutex);
+        m_calls.push_back(CallPreparePacket);
+    }
+
+    m_slotFrames[packet.slot] = packet.frame;
+}
+
+void NullFrameBackend::OnRender(const FramePacket& packet)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_callMutex);
+        m_calls.push_back(CallRender);
+    }
+
+    if (packet.frame != m_framesRendered || m_slotFrames[packet.slot] != packet.frame)
+    {
+        m_packetErrors++;
+    }
+
+    if (m_recorder)
+    {
+        const uint32_t drawCount = m_drawsPerFrame;
+        const uint32_t batchCount = (drawCount + DrawsPerBatch - 1) / DrawsPerBatch;
+        m_recorder->Record(batchCount, [this, drawCount](uint32_t batch, uint32_t list)
+        {
+            const uint32_t end = std::min<uint32_t>(drawCount, (batch + 1) * DrawsPerBatch);
+            for (uint32_t draw = batch * DrawsPerBatch; draw < end; ++draw)
+            {
+                m_commandLists->RecordCommand(list, draw);
+            }
+        });
+    }
+
+    m_scheduler->EndFrame();
+    m_scheduler->BeginFrame();
+    m_framesRendered++;
+}
+
+void NullFrameBackend::OnDestroy()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_callMutex);
+        m_calls.push_back(CallDestroy);
+    }
+
+    m_scheduler->WaitForIdle();
+}
+
+void NullFrameBackend::WaitForIdle()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_callMutex);
+        m_calls.push_back(CallWaitForIdle);
+    }
+
+    m_scheduler->WaitForIdle();
+}
+
+FrameSchedulerStats NullFrameBackend::GetSchedulerStats() const
+{
+    return m_scheduler ? m_scheduler->GetStats() : FrameSchedulerStats();
+}
+
+CommandRecorderStats NullFrameBackend::GetRecorderStats() const
+{
+    return m_recorder ? m_recorder->GetStats() : CommandRecorderStats();
+}
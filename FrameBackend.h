@@ -0,0 +1,117 @@
+#pragma once
+
+#include "FrameScheduler.h"
+#include "CommandRecorder.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Frame packet slots of a backend: up to two packets queued for the render
+// thread, one being rendered and one being prepared.
+static const uint32_t FramePacketSlotCount = 4;
+
+// What the simulation hands to the renderer for one frame. The backend keeps
+// the data of the frame itself, in the storage of slot.
+struct FramePacket
+{
+    uint64_t frame;             // 0 for the first packet.
+    uint32_t slot;              // Below FramePacketSlotCount.
+    uint32_t steps;             // Simulation steps since the previous packet.
+    double   time;              // Simulation time of the last step, in seconds.
+    double   alpha;             // Fraction of a step real time is past the last one, in [0, 1).
+};
+
+// Per-frame entry points a driver (the Win32 message loop or the headless
+// runner) calls into through a FrameLoop. DXSample implements it for the
+// D3D12 renderer.
+//
+// OnUpdate and OnPreparePacket run on the simulation thread, OnRender on the
+// render thread, which is the simulation thread as well unless the loop has a
+// dedicated one. A packet slot is only handed out again once its OnRender has
+// returned.
+class IFrameBackend
+{
+public:
+    virtual ~IFrameBackend() {}
+
+    virtual void OnInit() = 0;
+
+    // Advance the simulation by one fixed step.
+    virtual void OnUpdate(double stepSeconds) = 0;
+
+    // Store what rendering the frame needs in the slot of the packet,
+    // interpolating alpha of the way from the previous step to the last one.
+    virtual void OnPreparePacket(const FramePacket& packet) = 0;
+
+    virtual void OnRender(const FramePacket& packet) = 0;
+    virtual void OnDestroy() = 0;
+
+    // Block until all the submitted frames have been executed.
+    virtual void WaitForIdle() {}
+};
+
+// Backend that does no rendering. It records the calls it receives and paces
+// its frames against a SimulatedFrameQueue, so drivers can be exercised
+// without a GPU. With a recording workload, each frame also records stand-in
+// draws on a job system, to measure how recording scales with the threads.
+class NullFrameBackend : public IFrameBackend
+{
+public:
+    enum Call
+    {
+        CallInit,
+        CallUpdate,
+        CallPreparePacket,
+        CallRender,
+        CallDestroy,
+        CallWaitForIdle
+    };
+
+    NullFrameBackend(uint32_t framesInFlight, std::chrono::microseconds gpuFrameTime);
+
+    // Call before OnInit. Draws are recorded in batches of DrawsPerBatch.
+    void SetRecordingWorkload(uint32_t recordThreads, uint32_t drawsPerFrame);
+
+    // Call before OnInit. Busy time of each simulation step, on the CPU.
+    void SetUpdateWorkload(std::chrono::microseconds updateTime);
+
+    virtual void OnInit();
+    virtual void OnUpdate(double stepSeconds);
+    virtual void OnPreparePacket(const FramePacket& packet);
+    virtual void OnRender(const FramePacket& packet);
+    virtual void OnDestroy();
+    virtual void WaitForIdle();
+
+    // Only consistent once the loop has stopped.
+    const std::vector<Call>& GetCalls() const   { return m_calls; }
+    uint64_t GetFramesRendered() const          { return m_framesRendered; }
+
+    // Frames rendered out of order or from a slot prepared for another frame.
+    uint64_t GetPacketErrors() const            { return m_packetErrors; }
+    FrameSchedulerStats GetSchedulerStats() const;
+    CommandRecorderStats GetRecorderStats() const;
+
+    static const uint32_t DrawsPerBatch = 64;
+
+private:
+    uint32_t m_framesInFlight;
+    std::chrono::microseconds m_gpuFrameTime;
+    std::unique_ptr<SimulatedFrameQueue> m_queue;
+    std::unique_ptr<FrameScheduler> m_scheduler;
+    std::chrono::microseconds m_updateTime;
+
+    // Both threads log their calls.
+    std::mutex m_callMutex;
+    std::vector<Call> m_calls;
+    uint64_t m_framesRendered;
+    uint64_t m_packetErrors;
+    uint64_t m_slotFrames[FramePacketSlotCount];
+
+    uint32_t m_recordThreads;
+    uint32_t m_drawsPerFrame;
+    std::unique_ptr<JobSystem> m_jobs;
+    std::unique_ptr<RecordingCommandListBackend> m_commandLists;
+    std::unique_ptr<ParallelCommandRecorder> m_recorder;
+};
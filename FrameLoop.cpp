@@ -0,0 +1,214 @@
+#include "FrameLoop.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+FrameLoopSettings::FrameLoopSettings() :
+    stepSeconds(1.0 / 60.0),
+    maxStepsPerTick(8),
+    renderThread(false)
+{
+}
+
+FrameLoop::FrameLoop(IFrameBackend& backend, const FrameLoopSettings& settings) :
+    m_backend(backend),
+    m_settings(settings),
+    m_packets(FramePacketSlotCount),
+    m_freeSlots(FramePacketSlotCount),
+    m_stopping(false),
+    m_renderWaiting(false),
+    m_simulationWaiting(false),
+    m_packetsRendered(0),
+    m_running(false),
+    m_lastTime(0.0),
+    m_accumulator(0.0),
+    m_frame(0),
+    m_stats()
+{
+    if (!(settings.stepSeconds > 0.0) || settings.maxStepsPerTick == 0)
+    {
+        throw std::invalid_argument("FrameLoop");
+    }
+}
+
+FrameLoop::~FrameLoop()
+{
+    Stop();
+}
+
+void FrameLoop::Start(double nowSeconds)
+{
+    if (m_running)
+    {
+        throw std::logic_error("FrameLoop::Start: already running");
+    }
+
+    for (uint32_t slot = 0; slot < FramePacketSlotCount; ++slot)
+    {
+        m_freeSlots.TryPush(slot);
+    }
+
+    m_lastTime = nowSeconds;
+    m_accumulator = 0.0;
+    m_stopping = false;
+    m_running = true;
+
+    if (m_settings.renderThread)
+    {
+        m_thread = std::thread(&FrameLoop::RenderThread, this);
+    }
+}
+
+void FrameLoop::Tick(double nowSeconds)
+{
+    const double step = m_settings.stepSeconds;
+
+    // A clock going backwards does not run the simulation backwards.
+    m_accumulator += std::max<double>(nowSeconds - m_lastTime, 0.0);
+    m_lastTime = nowSeconds;
+
+    uint32_t steps = 0;
+    while (m_accumulator >= step)
+    {
+        if (steps == m_settings.maxStepsPerTick)
+        {
+            // Too far behind to catch up, skip whole steps and keep the fraction.
+            const double skipped = std::floor(m_accumulator / step) * step;
+            m_stats.droppedSeconds += skipped;
+            m_accumulator -= skipped;
+            break;
+        }
+
+        m_backend.OnUpdate(step);
+        m_accumulator -= step;
+        m_stats.simulationSeconds += step;
+        steps++;
+    }
+    m_stats.steps += steps;
+    m_stats.ticks++;
+
+    uint32_t slot = 0;
+    if (!m_freeSlots.TryPop(slot))
+    {
+        // The flag is raised before the wait looks at the queue again, so
+        // either that look finds the slot or the push finds the flag.
+        m_stats.slotWaits++;
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_simulationWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        m_slotFreed.wait(lock, [&]() { return m_freeSlots.TryPop(slot); });
+        m_simulationWaiting.store(false, std::memory_order_relaxed);
+    }
+
+    FramePacket packet = {};
+    packet.frame = m_frame++;
+    packet.slot = slot;
+    packet.steps = steps;
+    packet.time = m_stats.simulationSeconds;
+    packet.alpha = std::min<double>(m_accumulator / step, 1.0);
+    m_backend.OnPreparePacket(packet);
+
+    if (m_thread.joinable())
+    {
+        // There are as many queue entries as slots, the push cannot fail.
+        m_packets.TryPush(packet);
+        Wake(m_renderWaiting, m_packetPushed);
+    }
+    else
+    {
+        m_backend.OnRender(packet);
+        m_packetsRendered++;
+        m_freeSlots.TryPush(slot);
+    }
+}
+
+void FrameLoop::Stop()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stopping.store(true, std::memory_order_release);
+        }
+        m_packetPushed.notify_one();
+        m_thread.join();
+    }
+
+    // Every slot is free again, drop them for the next Start.
+    uint32_t slot = 0;
+    while (m_freeSlots.TryPop(slot))
+    {
+    }
+    m_running = false;
+}
+
+FrameLoopStats FrameLoop::GetStats() const
+{
+    FrameLoopStats stats = m_stats;
+    stats.packetsRendered = m_packetsRendered.load();
+    return stats;
+}
+
+void FrameLoop::Wake(std::atomic<bool>& waiting, std::condition_variable& condition)
+{
+    // Pairs with the fence of the waiting thread: the push is visible to its
+    // last look at the queue, or its flag is visible here.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!waiting.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // The waiting thread holds the mutex from raising its flag until it
+    // sleeps, once the mutex is taken here the notification reaches it.
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    condition.notify_one();
+}
+
+double FrameLoop::Now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FrameLoop::RenderThread()
+{
+    FramePacket packet = {};
+    for (;;)
+    {
+        // Sleep until the simulation thread pushes a packet or stops. The
+        // stop flag is read first: once it is set every packet has been
+        // pushed, and an empty queue means there is nothing left.
+        if (!m_packets.TryPop(packet))
+        {
+            bool popped = false;
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_renderWaiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            m_packetPushed.wait(lock, [&]()
+            {
+                const bool stopping = m_stopping.load(std::memory_order_acquire);
+                popped = m_packets.TryPop(packet);
+                return popped || stopping;
+            });
+            m_renderWaiting.store(false, std::memory_order_relaxed);
+            if (!popped)
+            {
+                break;
+            }
+        }
+
+        m_backend.OnRender(packet);
+        m_packetsRendered.fetch_add(1, std::memory_order_relaxed);
+        m_freeSlots.TryPush(packet.slot);
+        Wake(m_simulationWaiting, m_slotFreed);
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "FrameBackend.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+struct FrameLoopSettings
+{
+    double   stepSeconds;           // Fixed simulation step.
+    uint32_t maxStepsPerTick;       // Past this, the simulation falls behind real time instead of spiraling.
+    bool     renderThread;          // Render on a thread of its own, fed through a lock-free packet queue.
+
+    FrameLoopSettings();
+};
+
+struct FrameLoopStats
+{
+    uint64_t ticks;
+    uint64_t steps;
+    uint64_t packetsRendered;
+    uint64_t slotWaits;             // Ticks that waited for the render thread to free a slot.
+    double   droppedSeconds;        // Real time the simulation skipped, see maxStepsPerTick.
+    double   simulationSeconds;
+};
+
+// Fixed timestep main loop. Each Tick runs as many simulation steps as real
+// time allows, prepares a frame packet with the fraction of a step left over
+// for the renderer to interpolate with, and renders it: right away, or on the
+// render thread so that the next ticks (input, simulation) overlap rendering
+// and GPU submission. Packets go through one SpscQueue and their slots come
+// back through another, both pushed and popped without a lock. A thread with
+// nothing to do raises its waiting flag, looks at its queue once more and
+// sleeps on a condition variable; the other thread only takes the mutex to
+// wake it after a push that finds the flag raised.
+//
+// The driver calls Start, Tick and Stop from the simulation thread. Ticks
+// take the time as an argument, so a loop can be replayed on a simulated clock.
+class FrameLoop
+{
+public:
+    FrameLoop(IFrameBackend& backend, const FrameLoopSettings& settings = FrameLoopSettings());
+    ~FrameLoop();
+
+    void Start(double nowSeconds);
+
+    // Blocks while every packet slot is queued or being rendered.
+    void Tick(double nowSeconds);
+
+    // Waits for the queued packets to be rendered, then joins the render thread.
+    void Stop();
+    bool IsRunning() const                          { return m_running; }
+
+    // The render thread counters are exact once stopped.
+    FrameLoopStats GetStats() const;
+    const FrameLoopSettings& GetSettings() const   { return m_settings; }
+
+    // Seconds on a steady clock, for drivers running in real time.
+    static double Now();
+
+private:
+    void RenderThread();
+
+    // After a push: wake the thread sleeping on condition, if it is.
+    void Wake(std::atomic<bool>& waiting, std::condition_variable& condition);
+
+    IFrameBackend&              m_backend;
+    FrameLoopSettings           m_settings;
+    SpscQueue<FramePacket>      m_packets;          // Simulation to render thread.
+    SpscQueue<uint32_t>         m_freeSlots;        // Render to simulation thread.
+    std::thread                 m_thread;
+    std::atomic<bool>           m_stopping;
+    std::mutex                  m_wakeMutex;        // Only to sleep and to wake a sleeping thread.
+    std::condition_variable     m_packetPushed;
+    std::condition_variable     m_slotFreed;
+    // Raised while the render thread sleeps on m_packetPushed and the
+    // simulation thread on m_slotFreed.
+    std::atomic<bool>           m_renderWaiting;
+    std::atomic<bool>           m_simulationWaiting;
+    std::atomic<uint64_t>       m_packetsRendered;
+
+    bool                        m_running;
+    double                      m_lastTime;
+    double                      m_accumulator;
+    uint64_t                    m_frame;
+    FrameLoopStats              m_stats;
+};
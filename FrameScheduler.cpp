@@ -0,0 +1,191 @@
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+    double ToMilliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+FrameScheduler::FrameScheduler(IFrameQueue* queue, uint32_t framesInFlight) :
+    m_queue(queue),
+    m_frameIndex(0),
+    m_nextFenceValue(1),
+    m_frameOpen(false)
+{
+    if (!queue || framesInFlight == 0)
+    {
+        throw std::invalid_argument("FrameScheduler");
+    }
+
+    FrameSlot slot = { 0, Clock::time_point(), true };
+    m_slots.assign(framesInFlight, slot);
+
+    // Start after whatever the queue has already reached, the fence may have
+    // been used for setup work.
+    m_nextFenceValue = std::max<uint64_t>(m_queue->GetCompletedValue() + 1, 1);
+
+    ResetStats();
+}
+
+uint32_t FrameScheduler::BeginFrame()
+{
+    if (m_frameOpen)
+    {
+        throw std::logic_error("FrameScheduler::BeginFrame called twice");
+    }
+
+    FrameSlot& slot = m_slots[m_frameIndex];
+    if (!slot.retired)
+    {
+        // Only block when the CPU is a full ring of frames ahead of the GPU.
+        if (m_queue->GetCompletedValue() < slot.fenceValue)
+        {
+            const Clock::time_point waitStart = Clock::now();
+            m_queue->WaitForValue(slot.fenceValue);
+            const double waitMs = ToMilliseconds(Clock::now() - waitStart);
+
+            m_framesStalled++;
+            m_totalWaitMs += waitMs;
+            m_maxWaitMs = std::max(m_maxWaitMs, waitMs);
+        }
+
+        RetireSlot(slot, Clock::now());
+    }
+
+    m_frameOpen = true;
+    return m_frameIndex;
+}
+
+uint64_t FrameScheduler::EndFrame()
+{
+    if (!m_frameOpen)
+    {
+        throw std::logic_error("FrameScheduler::EndFrame without BeginFrame");
+    }
+
+    const uint64_t fenceValue = m_nextFenceValue++;
+    m_queue->Signal(fenceValue);
+
+    FrameSlot& slot = m_slots[m_frameIndex];
+    slot.fenceValue = fenceValue;
+    slot.submitTime = Clock::now();
+    slot.retired = false;
+
+    m_framesSubmitted++;
+    m_frameOpen = false;
+    m_frameIndex = (m_frameIndex + 1) % static_cast<uint32_t>(m_slots.size());
+
+    return fenceValue;
+}
+
+void FrameScheduler::WaitForIdle()
+{
+    // Signal a value of our own so that work submitted outside of a frame
+    // (uploads, setup command lists) is covered as well.
+    const uint64_t fenceValue = m_nextFenceValue++;
+    m_queue->Signal(fenceValue);
+    m_queue->WaitForValue(fenceValue);
+
+    const Clock::time_point now = Clock::now();
+    for (FrameSlot& slot : m_slots)
+    {
+        if (!slot.retired)
+        {
+            RetireSlot(slot, now);
+        }
+    }
+}
+
+void FrameScheduler::RetireSlot(FrameSlot& slot, Clock::time_point now)
+{
+    // The completion is only observed here, so this is an upper bound of the
+    // real GPU latency.
+    const double latencyMs = ToMilliseconds(now - slot.submitTime);
+    m_totalLatencyMs += latencyMs;
+    m_maxLatencyMs = std::max(m_maxLatencyMs, latencyMs);
+    m_framesRetired++;
+
+    slot.retired = true;
+}
+
+FrameSchedulerStats FrameScheduler::GetStats() const
+{
+    FrameSchedulerStats stats = {};
+    stats.framesSubmitted = m_framesSubmitted;
+    stats.framesStalled = m_framesStalled;
+    stats.totalWaitMs = m_totalWaitMs;
+    stats.maxWaitMs = m_maxWaitMs;
+    stats.averageLatencyMs = m_framesRetired ? m_totalLatencyMs / m_framesRetired : 0.0;
+    stats.maxLatencyMs = m_maxLatencyMs;
+
+    const double elapsedMs = ToMilliseconds(Clock::now() - m_statsStart);
+    stats.framesPerSecond = elapsedMs > 0.0 ? m_framesSubmitted * 1000.0 / elapsedMs : 0.0;
+
+    return stats;
+}
+
+void FrameScheduler::ResetStats()
+{
+    m_framesSubmitted = 0;
+    m_framesStalled = 0;
+    m_framesRetired = 0;
+    m_totalWaitMs = 0.0;
+    m_maxWaitMs = 0.0;
+    m_totalLatencyMs = 0.0;
+    m_maxLatencyMs = 0.0;
+    m_statsStart = Clock::now();
+}
+
+SimulatedFrameQueue::SimulatedFrameQueue(std::chrono::microseconds gpuFrameTime) :
+    m_gpuFrameTime(gpuFrameTime),
+    m_lastCompletion(Clock::now()),
+    m_completedValue(0)
+{
+}
+
+void SimulatedFrameQueue::Signal(uint64_t fenceValue)
+{
+    // The GPU starts on this frame once it is done with the previous one.
+    const Clock::time_point start = std::max(Clock::now(), m_lastCompletion);
+    m_lastCompletion = start + m_gpuFrameTime;
+    m_pending.push_back(std::make_pair(fenceValue, m_lastCompletion));
+}
+
+uint64_t SimulatedFrameQueue::GetCompletedValue()
+{
+    Update(Clock::now());
+    return m_completedValue;
+}
+
+void SimulatedFrameQueue::WaitForValue(uint64_t fenceValue)
+{
+    if (GetCompletedValue() >= fenceValue)
+    {
+        return;
+    }
+
+    for (const auto& pending : m_pending)
+    {
+        if (pending.first >= fenceValue)
+        {
+            std::this_thread::sleep_until(pending.second);
+            Update(std::max(Clock::now(), pending.second));
+            return;
+        }
+    }
+}
+
+void SimulatedFrameQueue::Update(Clock::time_point now)
+{
+    while (!m_pending.empty() && m_pending.front().second <= now)
+    {
+        m_completedValue = m_pending.front().first;
+        m_pending.pop_front();
+    }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+// Queue/fence pair the scheduler paces against. The D3D12 implementation wraps
+// an ID3D12CommandQueue and an ID3D12Fence, SimulatedFrameQueue stands in for it
+// when no GPU is available.
+class IFrameQueue
+{
+public:
+    virtual ~IFrameQueue() {}
+
+    // Enqueue a signal of fenceValue behind all the work submitted so far.
+    virtual void Signal(uint64_t fenceValue) = 0;
+
+    // Last fence value reached by the queue.
+    virtual uint64_t GetCompletedValue() = 0;
+
+    // Block the calling thread until the queue reaches fenceValue.
+    virtual void WaitForValue(uint64_t fenceValue) = 0;
+};
+
+struct FrameSchedulerStats
+{
+    uint64_t framesSubmitted;
+    uint64_t framesStalled;         // BeginFrame calls that had to block on the queue.
+    double   totalWaitMs;
+    double   maxWaitMs;
+    double   averageLatencyMs;      // Submit to observed completion.
+    double   maxLatencyMs;
+    double   framesPerSecond;
+};
+
+// Keeps up to N frames in flight. Each frame slot remembers the fence value that
+// was signalled when it was submitted, so the CPU only blocks when it is about to
+// reuse a slot the GPU has not finished with yet.
+class FrameScheduler
+{
+public:
+    FrameScheduler(IFrameQueue* queue, uint32_t framesInFlight);
+
+    // Wait until the next slot is free and return its index.
+    uint32_t BeginFrame();
+
+    // Signal the queue for the current slot and return the fence value used.
+    uint64_t EndFrame();
+
+    // Block until every submitted frame has completed.
+    void WaitForIdle();
+
+    // Fence value EndFrame will signal for the frame being recorded.
+    uint64_t GetCurrentFenceValue() const   { return m_nextFenceValue; }
+    uint64_t GetCompletedFenceValue()       { return m_queue->GetCompletedValue(); }
+
+    uint32_t GetFrameIndex() const          { return m_frameIndex; }
+    uint32_t GetFramesInFlight() const      { return static_cast<uint32_t>(m_slots.size()); }
+
+    FrameSchedulerStats GetStats() const;
+    void ResetStats();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct FrameSlot
+    {
+        uint64_t fenceValue;
+        Clock::time_point submitTime;
+        bool retired;
+    };
+
+    void RetireSlot(FrameSlot& slot, Clock::time_point now);
+
+    IFrameQueue* m_queue;
+    std::vector<FrameSlot> m_slots;
+    uint32_t m_frameIndex;
+    uint64_t m_nextFenceValue;
+    bool m_frameOpen;
+
+    // Statistics.
+    uint64_t m_framesSubmitted;
+    uint64_t m_framesStalled;
+    uint64_t m_framesRetired;
+    double m_totalWaitMs;
+    double m_maxWaitMs;
+    double m_totalLatencyMs;
+    double m_maxLatencyMs;
+    Clock::time_point m_statsStart;
+};
+
+// CPU stand-in for a GPU queue. Signals complete in order, each one a fixed
+// simulated GPU duration after the previous one, like a serial hardware queue.
+class SimulatedFrameQueue : public IFrameQueue
+{
+public:
+    explicit SimulatedFrameQueue(std::chrono::microseconds gpuFrameTime);
+
+    void SetGpuFrameTime(std::chrono::microseconds gpuFrameTime) { m_gpuFrameTime = gpuFrameTime; }
+
+    virtual void Signal(uint64_t fenceValue);
+    virtual uint64_t GetCompletedValue();
+    virtual void WaitForValue(uint64_t fenceValue);
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    void Update(Clock::time_point now);
+
+    std::chrono::microseconds m_gpuFrameTime;
+    std::deque<std::pair<uint64_t, Clock::time_point>> m_pending;
+    Clock::time_point m_lastCompletion;
+    uint64_t m_completedValue;
+};
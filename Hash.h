@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 64-bit FNV-1a with a final avalanche step. Stable across runs and platforms,
+// used for cache keys that are persisted to disk.
+class Hasher64
+{
+public:
+    Hasher64() : m_state(14695981039346656037ull) {}
+
+    void Update(const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            m_state = (m_state ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+
+    // Only use on types without padding, the bytes are hashed as they are in memory.
+    template<typename T>
+    void UpdateValue(const T& value)
+    {
+        Update(&value, sizeof(value));
+    }
+
+    // Strings are length prefixed so that ("ab", "c") and ("a", "bc") differ.
+    void UpdateString(const std::string& text)
+    {
+        UpdateValue(static_cast<uint64_t>(text.size()));
+        Update(text.data(), text.size());
+    }
+
+    uint64_t Final() const
+    {
+        uint64_t hash = m_state;
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdull;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+private:
+    uint64_t m_state;
+};
@@ -0,0 +1,36 @@
+#include "HeadlessDriver.h"
+
+#include <chrono>
+
+HeadlessRunStats HeadlessDriver::Run(IFrameBackend& backend, uint32_t frameCount, const FrameLoopSettings& settings)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    backend.OnInit();
+
+    // Make sure the setup work is not counted in the frame time.
+    backend.WaitForIdle();
+
+    FrameLoop loop(backend, settings);
+
+    const Clock::time_point start = Clock::now();
+    loop.Start(FrameLoop::Now());
+    for (uint32_t i = 0; i < frameCount; ++i)
+    {
+        loop.Tick(FrameLoop::Now());
+    }
+    loop.Stop();
+
+    // The last frames are only done once the GPU has executed them.
+    backend.WaitForIdle();
+    const Clock::time_point end = Clock::now();
+
+    backend.OnDestroy();
+
+    HeadlessRunStats stats = {};
+    stats.frameCount = frameCount;
+    stats.seconds = std::chrono::duration<double>(end - start).count();
+    stats.framesPerSecond = stats.seconds > 0.0 ? frameCount / stats.seconds : 0.0;
+    stats.loop = loop.GetStats();
+    return stats;
+}
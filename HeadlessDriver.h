@@ -0,0 +1,22 @@
+#pragma once
+
+#include "FrameLoop.h"
+
+#include <cstdint>
+
+struct HeadlessRunStats
+{
+    uint32_t       frameCount;
+    double         seconds;
+    double         framesPerSecond;
+    FrameLoopStats loop;
+};
+
+// Runs a backend for a fixed number of frames without a window or message
+// loop, as fast as the backend allows. The frames go through a FrameLoop in
+// real time, so the simulation advances at its fixed step whatever the frame rate.
+class HeadlessDriver
+{
+public:
+    static HeadlessRunStats Run(IFrameBackend& backend, uint32_t frameCount, const FrameLoopSettings& settings = FrameLoopSettings());
+};
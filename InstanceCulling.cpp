@@ -0,0 +1,186 @@
+#include "InstanceCulling.h"
+
+#include <random>
+#include <stdexcept>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define INSTANCE_CULLING_SSE2 1
+#else
+#define INSTANCE_CULLING_SSE2 0
+#endif
+
+namespace
+{
+    bool IsVisible(const InstanceSet& instances, uint32_t i, const CullRect& rect, float boundingRadius)
+    {
+        const float radius = boundingRadius * instances.scale[i];
+        return instances.positionX[i] + radius >= rect.minX && instances.positionX[i] - radius <= rect.maxX
+            && instances.positionY[i] + radius >= rect.minY && instances.positionY[i] - radius <= rect.maxY;
+    }
+
+    void CheckCapacity(const InstanceSet& instances, uint32_t capacity)
+    {
+        if (capacity < instances.GetCount())
+        {
+            throw std::invalid_argument("CullInstances: the output cannot hold every instance");
+        }
+    }
+
+    void SetArguments(uint32_t visibleCount, uint32_t vertexCount, IndirectDrawArguments& arguments)
+    {
+        arguments.vertexCountPerInstance = vertexCount;
+        arguments.instanceCount = visibleCount;
+        arguments.startVertexLocation = 0;
+        arguments.startInstanceLocation = 0;
+    }
+}
+
+void InstanceSet::Resize(uint32_t count)
+{
+    positionX.resize(count);
+    positionY.resize(count);
+    scale.resize(count);
+    rotation.resize(count);
+    red.resize(count);
+    green.resize(count);
+    blue.resize(count);
+    alpha.resize(count);
+}
+
+void InstanceSet::Set(uint32_t index, const InstanceData& instance)
+{
+    positionX[index] = instance.position[0];
+    positionY[index] = instance.position[1];
+    scale[index] = instance.scale;
+    rotation[index] = instance.rotation;
+    red[index] = instance.color[0];
+    green[index] = instance.color[1];
+    blue[index] = instance.color[2];
+    alpha[index] = instance.color[3];
+}
+
+InstanceData InstanceSet::Get(uint32_t index) const
+{
+    InstanceData instance =
+    {
+        { positionX[index], positionY[index] }, scale[index], rotation[index],
+        { red[index], green[index], blue[index], alpha[index] }
+    };
+    return instance;
+}
+
+void InstanceSet::Scatter(uint32_t count, const CullRect& area, float minScale, float maxScale, uint32_t seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> x(area.minX, area.maxX);
+    std::uniform_real_distribution<float> y(area.minY, area.maxY);
+    std::uniform_real_distribution<float> size(minScale, maxScale);
+    std::uniform_real_distribution<float> angle(0.0f, 6.28318531f);
+    std::uniform_real_distribution<float> channel(0.2f, 1.0f);
+
+    Resize(count);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        InstanceData instance = { { x(random), y(random) }, size(random), angle(random), { channel(random), channel(random), channel(random), 1.0f } };
+        Set(i, instance);
+    }
+}
+
+uint32_t CullInstances(const InstanceSet& instances, const CullRect& rect, float boundingRadius,
+    InstanceData* visible, uint32_t capacity, uint32_t vertexCount, IndirectDrawArguments& arguments)
+{
+    CheckCapacity(instances, capacity);
+
+    const uint32_t count = instances.GetCount();
+    uint32_t visibleCount = 0;
+    uint32_t i = 0;
+
+#if INSTANCE_CULLING_SSE2
+    // Four instances per iteration: a mask of the visible ones, then the
+    // structure of arrays is transposed to four InstanceData. Every one is
+    // stored at the next output slot and the slot only advances past the
+    // visible ones, which keeps the loop free of unpredictable branches.
+    // visibleCount never passes i, the stores stay inside the first count slots.
+    const __m128 radius = _mm_set1_ps(boundingRadius);
+    const __m128 minX = _mm_set1_ps(rect.minX);
+    const __m128 minY = _mm_set1_ps(rect.minY);
+    const __m128 maxX = _mm_set1_ps(rect.maxX);
+    const __m128 maxY = _mm_set1_ps(rect.maxY);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 x = _mm_loadu_ps(&instances.positionX[i]);
+        const __m128 y = _mm_loadu_ps(&instances.positionY[i]);
+        const __m128 scale = _mm_loadu_ps(&instances.scale[i]);
+        const __m128 extent = _mm_mul_ps(scale, radius);
+
+        const __m128 inX = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(x, extent), minX), _mm_cmple_ps(_mm_sub_ps(x, extent), maxX));
+        const __m128 inY = _mm_and_ps(_mm_cmpge_ps(_mm_add_ps(y, extent), minY), _mm_cmple_ps(_mm_sub_ps(y, extent), maxY));
+        const int mask = _mm_movemask_ps(_mm_and_ps(inX, inY));
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        __m128 transform0 = x;
+        __m128 transform1 = y;
+        __m128 transform2 = scale;
+        __m128 transform3 = _mm_loadu_ps(&instances.rotation[i]);
+        _MM_TRANSPOSE4_PS(transform0, transform1, transform2, transform3);
+
+        __m128 color0 = _mm_loadu_ps(&instances.red[i]);
+        __m128 color1 = _mm_loadu_ps(&instances.green[i]);
+        __m128 color2 = _mm_loadu_ps(&instances.blue[i]);
+        __m128 color3 = _mm_loadu_ps(&instances.alpha[i]);
+        _MM_TRANSPOSE4_PS(color0, color1, color2, color3);
+
+        _mm_storeu_ps(visible[visibleCount].position, transform0);
+        _mm_storeu_ps(visible[visibleCount].color, color0);
+        visibleCount += mask & 1;
+        _mm_storeu_ps(visible[visibleCount].position, transform1);
+        _mm_storeu_ps(visible[visibleCount].color, color1);
+        visibleCount += (mask >> 1) & 1;
+        _mm_storeu_ps(visible[visibleCount].position, transform2);
+        _mm_storeu_ps(visible[visibleCount].color, color2);
+        visibleCount += (mask >> 2) & 1;
+        _mm_storeu_ps(visible[visibleCount].position, transform3);
+        _mm_storeu_ps(visible[visibleCount].color, color3);
+        visibleCount += (mask >> 3) & 1;
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        if (IsVisible(instances, i, rect, boundingRadius))
+        {
+            visible[visibleCount++] = instances.Get(i);
+        }
+    }
+
+    SetArguments(visibleCount, vertexCount, arguments);
+    return visibleCount;
+}
+
+uint32_t CullInstancesReference(const InstanceSet& instances, const CullRect& rect, float boundingRadius,
+    InstanceData* visible, uint32_t capacity, uint32_t vertexCount, IndirectDrawArguments& arguments)
+{
+    CheckCapacity(instances, capacity);
+
+    uint32_t visibleCount = 0;
+    for (uint32_t i = 0; i < instances.GetCount(); ++i)
+    {
+        if (IsVisible(instances, i, rect, boundingRadius))
+        {
+            visible[visibleCount++] = instances.Get(i);
+        }
+    }
+
+    SetArguments(visibleCount, vertexCount, arguments);
+    return visibleCount;
+}
+
+bool InstanceCullingHasSimd()
+{
+    return INSTANCE_CULLING_SSE2 != 0;
+}
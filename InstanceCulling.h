@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// One instance as the vertex shader reads it, StructuredBuffer<Instance> in
+// shaders.hlsl. 32 bytes, two float4 registers.
+struct InstanceData
+{
+    float position[2];      // Offset in normalized device coordinates.
+    float scale;
+    float rotation;         // Radians.
+    float color[4];
+};
+
+// D3D12_DRAW_ARGUMENTS, the layout ExecuteIndirect reads.
+struct IndirectDrawArguments
+{
+    uint32_t vertexCountPerInstance;
+    uint32_t instanceCount;
+    uint32_t startVertexLocation;
+    uint32_t startInstanceLocation;
+};
+
+struct CullRect
+{
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+};
+
+// Instances as a structure of arrays, the culling loads four of a field at a
+// time.
+struct InstanceSet
+{
+    std::vector<float> positionX;
+    std::vector<float> positionY;
+    std::vector<float> scale;
+    std::vector<float> rotation;
+    std::vector<float> red;
+    std::vector<float> green;
+    std::vector<float> blue;
+    std::vector<float> alpha;
+
+    void Resize(uint32_t count);
+    uint32_t GetCount() const                   { return static_cast<uint32_t>(positionX.size()); }
+
+    void Set(uint32_t index, const InstanceData& instance);
+    InstanceData Get(uint32_t index) const;
+
+    // Replace the set with count instances spread uniformly over area, with
+    // random scales, rotations and colors. The same seed gives the same set.
+    void Scatter(uint32_t count, const CullRect& area, float minScale, float maxScale, uint32_t seed);
+};
+
+// Keeps the instances whose bounding circle, boundingRadius times their scale,
+// overlaps rect, packs them for the GPU and fills the draw arguments of a
+// single instanced draw of vertexCount vertices. Instances keep their order.
+// visible must have room for every instance of the set: CullInstances uses
+// SSE2 when available and also writes culled instances, into slots past the
+// visible ones or that a later one overwrites. CullInstancesReference is the
+// plain definition it has to match.
+uint32_t CullInstances(const InstanceSet& instances, const CullRect& rect, float boundingRadius,
+    InstanceData* visible, uint32_t capacity, uint32_t vertexCount, IndirectDrawArguments& arguments);
+uint32_t CullInstancesReference(const InstanceSet& instances, const CullRect& rect, float boundingRadius,
+    InstanceData* visible, uint32_t capacity, uint32_t vertexCount, IndirectDrawArguments& arguments);
+
+bool InstanceCullingHasSimd();
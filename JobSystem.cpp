@@ -0,0 +1,125 @@
+#include "JobSystem.h"
+
+JobSystem::JobSystem(uint32_t threadCount) :
+    m_job(nullptr),
+    m_count(0),
+    m_next(0),
+    m_busyWorkers(0),
+    m_generation(0),
+    m_quit(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+
+    for (uint32_t thread = 1; thread < threadCount; ++thread)
+    {
+        m_workers.push_back(std::thread(&JobSystem::WorkerMain, this, thread));
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_wake.notify_all();
+
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, const Job& job)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    if (m_workers.empty() || count == 1)
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            job(i, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_count = count;
+        m_next = 0;
+        m_busyWorkers = static_cast<uint32_t>(m_workers.size());
+        m_error = nullptr;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    RunJobs(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_busyWorkers == 0; });
+        m_job = nullptr;
+        error = m_error;
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void JobSystem::WorkerMain(uint32_t thread)
+{
+    uint64_t generation = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this, generation]() { return m_quit || m_generation != generation; });
+            if (m_quit)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        RunJobs(thread);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_busyWorkers == 0)
+            {
+                m_done.notify_one();
+            }
+        }
+    }
+}
+
+void JobSystem::RunJobs(uint32_t thread)
+{
+    // Indices are handed out one at a time, so uneven jobs balance themselves.
+    for (uint32_t index = m_next.fetch_add(1); index < m_count; index = m_next.fetch_add(1))
+    {
+        try
+        {
+            (*m_job)(index, thread);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_errorMutex);
+            if (!m_error)
+            {
+                m_error = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed pool of worker threads running batches of indexed jobs. The calling
+// thread takes part in every batch, so a pool of one thread runs inline.
+class JobSystem
+{
+public:
+    typedef std::function<void(uint32_t index, uint32_t thread)> Job;
+
+    // threadCount includes the calling thread, 0 uses one per hardware thread.
+    explicit JobSystem(uint32_t threadCount = 0);
+    ~JobSystem();
+
+    uint32_t GetThreadCount() const { return static_cast<uint32_t>(m_workers.size()) + 1; }
+
+    // Run job for every index in [0, count) and return once all are done. The
+    // calling thread is thread 0. The first exception a job throws is rethrown
+    // here. Not reentrant: jobs must not call ParallelFor.
+    void ParallelFor(uint32_t count, const Job& job);
+
+private:
+    void WorkerMain(uint32_t thread);
+    void RunJobs(uint32_t thread);
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    // Current batch, published under m_mutex.
+    const Job* m_job;
+    uint32_t m_count;
+    std::atomic<uint32_t> m_next;
+    uint32_t m_busyWorkers;
+    uint64_t m_generation;
+    bool m_quit;
+
+    std::mutex m_errorMutex;
+    std::exception_ptr m_error;
+};
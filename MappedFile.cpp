@@ -0,0 +1,363 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#ifdef _WIN32
+    std::wstring Utf8ToWide(const std::string& text)
+    {
+        if (text.empty())
+        {
+            return std::wstring();
+        }
+
+        const int length = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()), nullptr, 0);
+        std::wstring wide(length, L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, text.c_str(), static_cast<int>(text.size()), &wide[0], length);
+        return wide;
+    }
+#endif
+
+    FILE* OpenFile(const std::string& path, const char* mode)
+    {
+#ifdef _WIN32
+        FILE* file = nullptr;
+        const std::wstring wideMode(mode, mode + strlen(mode));
+        return _wfopen_s(&file, Utf8ToWide(path).c_str(), wideMode.c_str()) == 0 ? file : nullptr;
+#else
+        return fopen(path.c_str(), mode);
+#endif
+    }
+
+    void RemoveFile(const std::string& path)
+    {
+#ifdef _WIN32
+        DeleteFileW(Utf8ToWide(path).c_str());
+#else
+        remove(path.c_str());
+#endif
+    }
+}
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() :
+    m_data(nullptr),
+    m_size(0),
+    m_isOpen(false),
+    m_file(INVALID_HANDLE_VALUE),
+    m_mapping(nullptr)
+{
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    m_file = CreateFileW(Utf8ToWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(m_file, &size))
+    {
+        Close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+    if (m_size > SIZE_MAX)
+    {
+        Close();
+        return false;
+    }
+
+    // Empty files cannot be mapped, they are simply open with no data.
+    if (m_size > 0)
+    {
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping)
+        {
+            Close();
+            return false;
+        }
+
+        m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data)
+        {
+            Close();
+            return false;
+        }
+    }
+
+    m_isOpen = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+    }
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+}
+
+bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& data)
+{
+    const HANDLE file = CreateFileW(Utf8ToWide(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || static_cast<uint64_t>(size.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // ReadFile takes a 32-bit count, the file is read in chunks below that.
+    data.resize(static_cast<size_t>(size.QuadPart));
+    size_t offset = 0;
+    bool succeeded = true;
+    while (offset < data.size())
+    {
+        const DWORD request = static_cast<DWORD>(std::min<size_t>(data.size() - offset, ReadChunkSize));
+        DWORD read = 0;
+        if (!ReadFile(file, data.data() + offset, request, &read, nullptr))
+        {
+            succeeded = false;
+            break;
+        }
+        if (read == 0)
+        {
+            break;
+        }
+        offset += read;
+    }
+
+    // The file may have been truncated since its size was read.
+    data.resize(offset);
+    CloseHandle(file);
+    return succeeded;
+}
+
+#else
+
+MappedFile::MappedFile() :
+    m_data(nullptr),
+    m_size(0),
+    m_isOpen(false),
+    m_file(-1)
+{
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+
+    m_file = open(path.c_str(), O_RDONLY);
+    if (m_file < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(m_file, &info) != 0)
+    {
+        Close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(info.st_size);
+    if (m_size > SIZE_MAX)
+    {
+        Close();
+        return false;
+    }
+
+    // Empty files cannot be mapped, they are simply open with no data.
+    if (m_size > 0)
+    {
+        void* data = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+        if (data == MAP_FAILED)
+        {
+            Close();
+            return false;
+        }
+        m_data = static_cast<const uint8_t*>(data);
+    }
+
+    m_isOpen = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<uint8_t*>(m_data), static_cast<size_t>(m_size));
+    }
+    if (m_file >= 0)
+    {
+        close(m_file);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+    m_file = -1;
+}
+
+bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& data)
+{
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || static_cast<uint64_t>(info.st_size) > SIZE_MAX)
+    {
+        close(file);
+        return false;
+    }
+
+    data.resize(static_cast<size_t>(info.st_size));
+    size_t offset = 0;
+    bool succeeded = true;
+    while (offset < data.size())
+    {
+        const ssize_t read = ::read(file, data.data() + offset, std::min<size_t>(data.size() - offset, ReadChunkSize));
+        if (read < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            succeeded = false;
+            break;
+        }
+        if (read == 0)
+        {
+            break;
+        }
+        offset += static_cast<size_t>(read);
+    }
+
+    // The file may have been truncated since its size was read.
+    data.resize(offset);
+    close(file);
+    return succeeded;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+AssetFile::AssetFile() :
+    m_isOpen(false)
+{
+}
+
+bool AssetFile::Open(const std::string& path, bool allowMapping)
+{
+    Close();
+
+    m_isOpen = (allowMapping && m_mapped.Open(path)) || ReadFileBytes(path, m_buffer);
+    if (!m_isOpen)
+    {
+        Close();
+    }
+    return m_isOpen;
+}
+
+void AssetFile::Close()
+{
+    m_mapped.Close();
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
+    m_isOpen = false;
+}
+
+const uint8_t* AssetFile::GetRange(uint64_t offset, uint64_t size) const
+{
+    const uint64_t fileSize = GetSize();
+    if (offset > fileSize || size > fileSize - offset)
+    {
+        return nullptr;
+    }
+    return GetData() + offset;
+}
+
+bool WriteFileAtomic(const std::string& path, const void* data, size_t size)
+{
+    const std::string temporaryPath = path + ".tmp";
+
+    FILE* file = OpenFile(temporaryPath, "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    const bool written = size == 0 || fwrite(data, 1, size, file) == size;
+    if (fclose(file) != 0 || !written)
+    {
+        RemoveFile(temporaryPath);
+        return false;
+    }
+
+#ifdef _WIN32
+    if (!MoveFileExW(Utf8ToWide(temporaryPath).c_str(), Utf8ToWide(path).c_str(), MOVEFILE_REPLACE_EXISTING))
+    {
+        RemoveFile(temporaryPath);
+        return false;
+    }
+#else
+    if (rename(temporaryPath.c_str(), path.c_str()) != 0)
+    {
+        RemoveFile(temporaryPath);
+        return false;
+    }
+#endif
+
+    return true;
+}
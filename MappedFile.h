@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only memory mapping of a whole file. Paths are UTF-8 on every platform.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    // Returns false if the file does not exist or cannot be mapped.
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const             { return m_isOpen; }
+    const uint8_t* GetData() const  { return m_data; }
+    uint64_t GetSize() const        { return m_size; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const uint8_t* m_data;
+    uint64_t m_size;
+    bool m_isOpen;
+
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#else
+    int m_file;
+#endif
+};
+
+// The bytes of an asset file, read only. The file is mapped when it can be and
+// read into memory in chunks otherwise; either way the bytes are handed out
+// without a copy and stay valid until the file is closed.
+class AssetFile
+{
+public:
+    AssetFile();
+
+    // Streams the file when mapping fails or is not allowed. Returns false if
+    // the file does not exist or cannot be read either way.
+    bool Open(const std::string& path, bool allowMapping = true);
+    void Close();
+
+    bool IsOpen() const             { return m_isOpen; }
+    bool IsMapped() const           { return m_mapped.IsOpen(); }
+    const uint8_t* GetData() const  { return IsMapped() ? m_mapped.GetData() : m_buffer.data(); }
+    uint64_t GetSize() const        { return IsMapped() ? m_mapped.GetSize() : m_buffer.size(); }
+
+    // The size bytes at offset, or nullptr when they are not all in the file.
+    const uint8_t* GetRange(uint64_t offset, uint64_t size) const;
+
+private:
+    MappedFile m_mapped;
+    std::vector<uint8_t> m_buffer;
+    bool m_isOpen;
+};
+
+// Read a whole file into memory. The file is read in chunks of at most
+// ReadChunkSize bytes, its size is only limited by the address space.
+static const uint32_t ReadChunkSize = 8 * 1024 * 1024;
+bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& data);
+
+// Write data to a temporary file next to path and rename it over path, so
+// readers never observe a partially written file.
+bool WriteFileAtomic(const std::string& path, const void* data, size_t size);
@@ -0,0 +1,89 @@
+#include "PipelineStateCache.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double ToMilliseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+PipelineStateCache::PipelineStateCache(const std::string& packPath) :
+    m_store(packPath),
+    m_stats()
+{
+}
+
+void PipelineStateCache::Create(uint64_t key, IPipelineBuilder& builder)
+{
+    // The blob is copied under the lock and used unlocked: a stale blob is
+    // replaced, and freed, by the first create that rebuilds its pipeline,
+    // while concurrent creates of the same pipeline may still be reading it.
+    std::vector<uint8_t> blob;
+    bool found;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const uint8_t* stored;
+        uint64_t storedSize;
+        found = m_store.Find(key, &stored, &storedSize);
+        if (found)
+        {
+            blob.assign(stored, stored + storedSize);
+        }
+    }
+
+    if (found)
+    {
+        const Clock::time_point start = Clock::now();
+        const bool created = builder.CreateFromBlob(blob.data(), blob.size());
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (created)
+        {
+            m_stats.blobCreates++;
+            m_stats.blobMilliseconds += ToMilliseconds(Clock::now() - start);
+            return;
+        }
+
+        // The blob is stale, it gets replaced below.
+        m_stats.rejectedBlobs++;
+    }
+
+    const Clock::time_point start = Clock::now();
+    builder.CreateFromScratch();
+    const double scratchMilliseconds = ToMilliseconds(Clock::now() - start);
+
+    std::vector<uint8_t> cachedBlob;
+    const bool serialized = builder.GetCachedBlob(cachedBlob) && !cachedBlob.empty();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.scratchCreates++;
+    m_stats.scratchMilliseconds += scratchMilliseconds;
+
+    // A stale blob is replaced, one added by a concurrent create of the same
+    // pipeline is kept.
+    const uint8_t* stored;
+    uint64_t storedSize;
+    if (serialized && (!m_store.Find(key, &stored, &storedSize) ||
+        (found && storedSize == blob.size() && std::equal(blob.begin(), blob.end(), stored))))
+    {
+        m_store.Add(key, cachedBlob);
+    }
+}
+
+bool PipelineStateCache::Save()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_store.Save();
+}
+
+PipelineStateCacheStats PipelineStateCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "BlobPack.h"
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Creates one pipeline on behalf of the cache. The D3D12 implementation wraps
+// CreateGraphicsPipelineState and ID3D12PipelineState::GetCachedBlob.
+class IPipelineBuilder
+{
+public:
+    virtual ~IPipelineBuilder() {}
+
+    // Create the pipeline from a blob returned by GetCachedBlob in an earlier
+    // run. Returns false if the driver rejects it (new driver, other adapter).
+    virtual bool CreateFromBlob(const void* blob, size_t size) = 0;
+
+    // Create the pipeline from its description.
+    virtual void CreateFromScratch() = 0;
+
+    // Serialize the pipeline created by CreateFromScratch.
+    virtual bool GetCachedBlob(std::vector<uint8_t>& blob) = 0;
+};
+
+struct PipelineStateCacheStats
+{
+    uint32_t blobCreates;       // Pipelines created from a cached blob.
+    uint32_t scratchCreates;    // Pipelines compiled from scratch.
+    uint32_t rejectedBlobs;     // Cached blobs the driver refused.
+    double blobMilliseconds;
+    double scratchMilliseconds;
+};
+
+// Pipeline state cache keyed by a stable hash of the full pipeline description.
+// Blobs are persisted in a BlobPack so that a warm start creates no pipeline
+// from scratch. Create can be called from several threads at once, the
+// pipelines are created in parallel.
+class PipelineStateCache
+{
+public:
+    explicit PipelineStateCache(const std::string& packPath);
+
+    void Create(uint64_t key, IPipelineBuilder& builder);
+
+    // Persist the blobs of the pipelines created from scratch. Not while
+    // Create runs on another thread.
+    bool Save();
+
+    PipelineStateCacheStats GetStats() const;
+
+private:
+    mutable std::mutex m_mutex;     // Guards the store and the stats.
+    BlobStore m_store;
+    PipelineStateCacheStats m_stats;
+};
@@ -0,0 +1,276 @@
+#include "Profiler.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <stdexcept>
+
+namespace
+{
+    // Small thread numbers for the trace, in order of first use.
+    uint32_t CurrentThread()
+    {
+        static std::atomic<uint32_t> s_nextThread(1);
+        static thread_local uint32_t t_thread = s_nextThread.fetch_add(1);
+        return t_thread;
+    }
+
+    void AppendEscaped(std::string& out, const char* text)
+    {
+        for (const char* c = text ? text : ""; *c; ++c)
+        {
+            if (*c == '"' || *c == '\\')
+            {
+                out += '\\';
+                out += *c;
+            }
+            else if (static_cast<unsigned char>(*c) < 0x20)
+            {
+                char buff[8];
+                snprintf(buff, sizeof(buff), "\\u%04x", *c);
+                out += buff;
+            }
+            else
+            {
+                out += *c;
+            }
+        }
+    }
+}
+
+Profiler::Profiler(uint32_t capacity, uint32_t windowSize) :
+    m_slots(capacity),
+    m_next(0),
+    m_frame(0),
+    m_processed(0),
+    m_windowSize(windowSize)
+{
+    if (capacity == 0 || windowSize == 0)
+    {
+        throw std::invalid_argument("Profiler");
+    }
+
+    for (Slot& slot : m_slots)
+    {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+int64_t Profiler::Now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t Profiler::Reserve(const char* name, uint64_t frame, uint32_t thread, int64_t begin)
+{
+    // The slot is only written by this thread until the event is complete,
+    // older events are overwritten once the ring wraps. The fence keeps the
+    // fields from being seen before the sequence that hides them.
+    const uint64_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_slots[index % m_slots.size()];
+    slot.sequence.store(OpenSequence(index), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.frame.store(frame, std::memory_order_relaxed);
+    slot.thread.store(thread, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    return index;
+}
+
+uint64_t Profiler::BeginScope(const char* name)
+{
+    return Reserve(name, m_frame.load(std::memory_order_relaxed), CurrentThread(), Now());
+}
+
+void Profiler::EndScope(uint64_t scope)
+{
+    Slot& slot = m_slots[scope % m_slots.size()];
+    if (slot.sequence.load(std::memory_order_relaxed) != OpenSequence(scope))
+    {
+        return;
+    }
+
+    slot.end.store(Now(), std::memory_order_relaxed);
+    slot.sequence.store(scope + 1, std::memory_order_release);
+}
+
+void Profiler::AddGpuEvent(const char* name, uint64_t frame, int64_t begin, int64_t end)
+{
+    const uint64_t index = Reserve(name, frame, GpuThread, begin);
+    Slot& slot = m_slots[index % m_slots.size()];
+    slot.end.store(std::max<int64_t>(begin, end), std::memory_order_relaxed);
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::ReadEvent(uint64_t index, ProfilerEvent& event) const
+{
+    const Slot& slot = m_slots[index % m_slots.size()];
+    if (slot.sequence.load(std::memory_order_acquire) != index + 1)
+    {
+        return false;
+    }
+
+    event.name = slot.name.load(std::memory_order_relaxed);
+    event.begin = slot.begin.load(std::memory_order_relaxed);
+    event.end = slot.end.load(std::memory_order_relaxed);
+    event.frame = slot.frame.load(std::memory_order_relaxed);
+    event.thread = slot.thread.load(std::memory_order_relaxed);
+
+    // Overwritten during the copy if the sequence changed.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+}
+
+void Profiler::AddToWindow(const ProfilerEvent& event)
+{
+    Window& window = m_windows[std::make_pair(std::string(event.name ? event.name : ""), event.thread == GpuThread)];
+    if (window.durations.empty())
+    {
+        window.durations.resize(m_windowSize);
+        window.next = 0;
+        window.count = 0;
+    }
+
+    window.durations[window.next] = (event.end - event.begin) * 1e-6;
+    window.next = (window.next + 1) % m_windowSize;
+    window.count = std::min<uint32_t>(window.count + 1, m_windowSize);
+}
+
+void Profiler::EndFrame()
+{
+    const uint64_t next = m_next.load(std::memory_order_acquire);
+    const uint64_t oldest = next > m_slots.size() ? next - m_slots.size() : 0;
+
+    // The events still open last time first, then the new ones. An event
+    // that is not complete yet is kept for the next frame, unless the ring
+    // has moved past it.
+    std::vector<uint64_t> open;
+    ProfilerEvent event;
+    for (uint64_t index : m_open)
+    {
+        if (index < oldest)
+        {
+            continue;
+        }
+        if (ReadEvent(index, event))
+        {
+            AddToWindow(event);
+        }
+        else
+        {
+            open.push_back(index);
+        }
+    }
+
+    for (uint64_t index = std::max<uint64_t>(m_processed, oldest); index < next; ++index)
+    {
+        if (ReadEvent(index, event))
+        {
+            AddToWindow(event);
+        }
+        else
+        {
+            open.push_back(index);
+        }
+    }
+
+    m_open.swap(open);
+    m_processed = next;
+    m_frame.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::vector<ProfilerSummary> Profiler::GetSummary() const
+{
+    std::vector<ProfilerSummary> summary;
+    std::vector<double> sorted;
+
+    for (const auto& entry : m_windows)
+    {
+        const Window& window = entry.second;
+        sorted.assign(window.durations.begin(), window.durations.begin() + window.count);
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0.0;
+        for (double duration : sorted)
+        {
+            total += duration;
+        }
+
+        // Nearest rank, the worst sample for windows under 100 samples.
+        const size_t rank = (sorted.size() * 99 + 99) / 100;
+
+        ProfilerSummary item;
+        item.name = entry.first.first;
+        item.gpu = entry.first.second;
+        item.samples = window.count;
+        item.minMs = sorted.front();
+        item.avgMs = total / sorted.size();
+        item.p99Ms = sorted[rank - 1];
+        summary.push_back(item);
+    }
+
+    return summary;
+}
+
+std::string Profiler::ExportChromeTrace() const
+{
+    const uint64_t next = m_next.load(std::memory_order_acquire);
+    const uint64_t first = next > m_slots.size() ? next - m_slots.size() : 0;
+
+    // Only the complete events, open scopes and overwritten slots are skipped.
+    std::vector<ProfilerEvent> events;
+    events.reserve(static_cast<size_t>(next - first));
+    ProfilerEvent read;
+    int64_t origin = INT64_MAX;
+    for (uint64_t i = first; i < next; ++i)
+    {
+        if (ReadEvent(i, read))
+        {
+            events.push_back(read);
+            origin = std::min<int64_t>(origin, read.begin);
+        }
+    }
+
+    // Complete events, timestamps in microseconds. The GPU queue gets thread 0.
+    std::string out = "{\"traceEvents\":[\n";
+    std::set<uint32_t> threads;
+    char buff[192];
+
+    for (const ProfilerEvent& event : events)
+    {
+        const uint32_t tid = event.thread == GpuThread ? 0 : event.thread;
+        threads.insert(tid);
+
+        out += "{\"name\":\"";
+        AppendEscaped(out, event.name);
+        snprintf(buff, sizeof(buff), "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%llu}},\n",
+            tid ? "cpu" : "gpu", (event.begin - origin) * 1e-3, (event.end - event.begin) * 1e-3, tid,
+            static_cast<unsigned long long>(event.frame));
+        out += buff;
+    }
+
+    for (uint32_t tid : threads)
+    {
+        if (tid)
+        {
+            snprintf(buff, sizeof(buff), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"CPU %u\"}},\n", tid, tid);
+        }
+        else
+        {
+            snprintf(buff, sizeof(buff), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}},\n");
+        }
+        out += buff;
+    }
+
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"D3D12HelloTriangle\"}}\n]}\n";
+    return out;
+}
+
+bool Profiler::WriteChromeTrace(const std::string& path) const
+{
+    const std::string trace = ExportChromeTrace();
+    return WriteFileAtomic(path, trace.data(), trace.size());
+}
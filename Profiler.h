@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+struct ProfilerEvent
+{
+    const char* name;
+    int64_t     begin;          // Nanoseconds on the Profiler::Now clock.
+    int64_t     end;
+    uint64_t    frame;
+    uint32_t    thread;         // Profiler::GpuThread for GPU events.
+};
+
+struct ProfilerSummary
+{
+    std::string name;
+    bool        gpu;
+    uint32_t    samples;        // In the rolling window.
+    double      minMs;
+    double      avgMs;
+    double      p99Ms;
+};
+
+// Records CPU scopes and GPU intervals into a ring of the last events, keeps
+// rolling statistics per scope name and exports Chrome trace JSON.
+// BeginScope, EndScope, AddGpuEvent and ExportChromeTrace are lock free and
+// may be called from any thread, also while EndFrame runs on another one.
+// EndFrame and GetSummary must not run concurrently with each other. Names
+// are not copied, they have to outlive the profiler.
+class Profiler
+{
+public:
+    static const uint32_t GpuThread = 0xffffffff;
+
+    explicit Profiler(uint32_t capacity = 1 << 16, uint32_t windowSize = 256);
+
+    static int64_t Now();
+
+    // A scope left open for a whole lap of the ring is lost.
+    uint64_t BeginScope(const char* name);
+    void EndScope(uint64_t scope);
+
+    // An interval already converted to the Now clock, see D3D12GpuProfiler.
+    void AddGpuEvent(const char* name, uint64_t frame, int64_t begin, int64_t end);
+
+    // Fold the events closed since the last call into the statistics and
+    // start the next frame. Scopes still open are folded in once closed.
+    void EndFrame();
+    uint64_t GetFrame() const                   { return m_frame.load(std::memory_order_relaxed); }
+
+    std::vector<ProfilerSummary> GetSummary() const;
+
+    // Every event still in the ring, in the Trace Event Format read by
+    // chrome://tracing and Perfetto.
+    std::string ExportChromeTrace() const;
+    bool WriteChromeTrace(const std::string& path) const;
+
+private:
+    // An event of the ring, written with relaxed atomics and published by
+    // sequence: index + 1 of the event once complete, OpenSequence while it
+    // is being written or the scope is open. Readers copy the fields and keep
+    // the copy if the sequence was index + 1 before and after.
+    struct Slot
+    {
+        std::atomic<const char*> name;
+        std::atomic<int64_t>     begin;
+        std::atomic<int64_t>     end;
+        std::atomic<uint64_t>    frame;
+        std::atomic<uint32_t>    thread;
+        std::atomic<uint64_t>    sequence;
+    };
+
+    struct Window
+    {
+        std::vector<double> durations;          // Milliseconds, ring of windowSize.
+        uint32_t next;
+        uint32_t count;
+    };
+
+    static uint64_t OpenSequence(uint64_t index)    { return (index + 1) | (1ull << 63); }
+
+    uint64_t Reserve(const char* name, uint64_t frame, uint32_t thread, int64_t begin);
+    bool ReadEvent(uint64_t index, ProfilerEvent& event) const;
+    void AddToWindow(const ProfilerEvent& event);
+
+    std::vector<Slot> m_slots;
+    std::atomic<uint64_t> m_next;
+    std::atomic<uint64_t> m_frame;
+    uint64_t m_processed;
+    std::vector<uint64_t> m_open;               // Events not yet complete at the last EndFrame.
+    uint32_t m_windowSize;
+    std::map<std::pair<std::string, bool>, Window> m_windows;
+};
+
+// Times the enclosing block.
+class ProfileScope
+{
+public:
+    ProfileScope(Profiler* profiler, const char* name) :
+        m_profiler(profiler),
+        m_scope(profiler ? profiler->BeginScope(name) : 0)
+    {
+    }
+
+    ~ProfileScope()
+    {
+        if (m_profiler)
+        {
+            m_profiler->EndScope(m_scope);
+        }
+    }
+
+private:
+    ProfileScope(const ProfileScope&);
+    ProfileScope& operator=(const ProfileScope&);
+
+    Profiler* m_profiler;
+    uint64_t m_scope;
+};
@@ -0,0 +1,151 @@
+#include "ReadbackRing.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+const uint32_t ReadbackRing::InvalidCapture;
+
+void ReadbackView::CopyRows(uint8_t* destination, size_t destinationPitch) const
+{
+    if (destinationPitch == rowPitch)
+    {
+        // Same layout, the padding comes along in a single copy.
+        memcpy(destination, data, static_cast<size_t>(rowPitch) * (rowCount - 1) + rowSize);
+        return;
+    }
+
+    for (uint32_t row = 0; row < rowCount; ++row)
+    {
+        memcpy(destination + row * destinationPitch, data + static_cast<size_t>(row) * rowPitch, rowSize);
+    }
+}
+
+uint32_t ReadbackRing::GetRowPitch(uint32_t rowSize)
+{
+    return static_cast<uint32_t>(AlignUp(rowSize, RowPitchAlignment));
+}
+
+uint64_t ReadbackRing::GetSlotSize(uint32_t rowSize, uint32_t rowCount)
+{
+    // The last row does not need its padding.
+    if (rowCount == 0)
+    {
+        return 0;
+    }
+    return AlignUp(static_cast<uint64_t>(GetRowPitch(rowSize)) * (rowCount - 1) + rowSize, PlacementAlignment);
+}
+
+ReadbackRing::ReadbackRing(const uint8_t* memory, uint32_t slotCount, uint64_t slotSize) :
+    m_memory(memory),
+    m_slotSize(AlignUp(slotSize, PlacementAlignment)),
+    m_nextSlot(0),
+    m_slotsInUse(0),
+    m_stats()
+{
+    if (!memory || slotCount == 0 || slotSize == 0)
+    {
+        throw std::invalid_argument("ReadbackRing");
+    }
+
+    Slot slot = {};
+    slot.state = SlotFree;
+    m_slots.assign(slotCount, slot);
+}
+
+uint32_t ReadbackRing::Begin(uint32_t rowSize, uint32_t rowCount, uint64_t frame)
+{
+    if (GetSlotSize(rowSize, rowCount) > m_slotSize || rowCount == 0)
+    {
+        throw std::invalid_argument("ReadbackRing: capture does not fit in a slot");
+    }
+
+    // Slots are handed out round robin, so they complete roughly in the order
+    // they are scanned.
+    for (uint32_t i = 0; i < m_slots.size(); ++i)
+    {
+        const uint32_t capture = (m_nextSlot + i) % m_slots.size();
+        Slot& slot = m_slots[capture];
+        if (slot.state != SlotFree)
+        {
+            continue;
+        }
+
+        slot.state = SlotRecorded;
+        slot.footprint.offset = capture * m_slotSize;
+        slot.footprint.rowSize = rowSize;
+        slot.footprint.rowPitch = GetRowPitch(rowSize);
+        slot.footprint.rowCount = rowCount;
+        slot.frame = frame;
+        slot.fenceValue = 0;
+        m_recorded.push_back(capture);
+
+        m_nextSlot = (capture + 1) % m_slots.size();
+        m_slotsInUse++;
+        m_stats.captures++;
+        m_stats.peakSlotsInUse = std::max<uint32_t>(m_stats.peakSlotsInUse, m_slotsInUse);
+        return capture;
+    }
+
+    m_stats.droppedCaptures++;
+    return InvalidCapture;
+}
+
+const ReadbackFootprint& ReadbackRing::GetFootprint(uint32_t capture) const
+{
+    return m_slots.at(capture).footprint;
+}
+
+void ReadbackRing::FinishFrame(uint64_t fenceValue)
+{
+    for (uint32_t capture : m_recorded)
+    {
+        m_slots[capture].state = SlotPending;
+        m_slots[capture].fenceValue = fenceValue;
+        m_pending.push_back(capture);
+    }
+    m_recorded.clear();
+}
+
+bool ReadbackRing::Acquire(uint64_t completedFenceValue, ReadbackView& view)
+{
+    if (m_pending.empty() || m_slots[m_pending.front()].fenceValue > completedFenceValue)
+    {
+        return false;
+    }
+
+    const uint32_t capture = m_pending.front();
+    m_pending.pop_front();
+
+    Slot& slot = m_slots[capture];
+    slot.state = SlotAcquired;
+    m_stats.completedCaptures++;
+
+    view.capture = capture;
+    view.frame = slot.frame;
+    view.data = m_memory + slot.footprint.offset;
+    view.rowSize = slot.footprint.rowSize;
+    view.rowPitch = slot.footprint.rowPitch;
+    view.rowCount = slot.footprint.rowCount;
+    return true;
+}
+
+void ReadbackRing::Release(uint32_t capture)
+{
+    Slot& slot = m_slots.at(capture);
+    if (slot.state != SlotAcquired)
+    {
+        throw std::logic_error("ReadbackRing::Release of a capture that was not acquired");
+    }
+
+    slot.state = SlotFree;
+    m_slotsInUse--;
+}
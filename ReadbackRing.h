@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Where a texture copy lands in its slot. Rows are rowPitch bytes apart and
+// only the first rowSize bytes of each one are pixels.
+struct ReadbackFootprint
+{
+    uint64_t offset;
+    uint32_t rowSize;
+    uint32_t rowPitch;
+    uint32_t rowCount;
+};
+
+// Completed capture, pointing straight into the ring memory. Valid until the
+// capture is released.
+struct ReadbackView
+{
+    uint32_t        capture;
+    uint64_t        frame;
+    const uint8_t*  data;
+    uint32_t        rowSize;
+    uint32_t        rowPitch;
+    uint32_t        rowCount;
+
+    // Copy the rows without their padding, destinationPitch >= rowSize.
+    void CopyRows(uint8_t* destination, size_t destinationPitch) const;
+};
+
+struct ReadbackRingStats
+{
+    uint64_t captures;
+    uint64_t droppedCaptures;       // Begin calls that found every slot busy.
+    uint64_t completedCaptures;
+    uint32_t peakSlotsInUse;
+};
+
+// Fixed slots over a block of memory the GPU copies textures into, typically
+// one persistently mapped readback buffer. A capture takes a free slot,
+// FinishFrame tags every capture of the frame with its fence value, and
+// Acquire hands them back in order once the queue has reached it. Nothing
+// ever waits: when every slot is busy the capture is dropped.
+//
+// Pitches and offsets follow the D3D12 placed footprint rules, the owner
+// records the copies.
+class ReadbackRing
+{
+public:
+    static const uint32_t InvalidCapture = ~0u;
+    static const uint32_t RowPitchAlignment = 256;      // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+    static const uint32_t PlacementAlignment = 512;     // D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+
+    static uint32_t GetRowPitch(uint32_t rowSize);
+    static uint64_t GetSlotSize(uint32_t rowSize, uint32_t rowCount);
+
+    // memory holds slotCount slots of slotSize bytes, slotSize is rounded up
+    // to PlacementAlignment.
+    ReadbackRing(const uint8_t* memory, uint32_t slotCount, uint64_t slotSize);
+
+    // Reserve a slot for rowCount rows of rowSize bytes. Returns
+    // InvalidCapture when every slot is busy, throws if the copy can never fit.
+    uint32_t Begin(uint32_t rowSize, uint32_t rowCount, uint64_t frame);
+    const ReadbackFootprint& GetFootprint(uint32_t capture) const;
+
+    // Close the current frame, its captures complete once fenceValue does.
+    void FinishFrame(uint64_t fenceValue);
+
+    // Oldest capture whose fence is <= completedFenceValue, false if none.
+    bool Acquire(uint64_t completedFenceValue, ReadbackView& view);
+    void Release(uint32_t capture);
+
+    uint32_t GetSlotCount() const           { return static_cast<uint32_t>(m_slots.size()); }
+    uint64_t GetSlotSize() const            { return m_slotSize; }
+    ReadbackRingStats GetStats() const      { return m_stats; }
+
+private:
+    enum SlotState
+    {
+        SlotFree,
+        SlotRecorded,       // Copy recorded, frame not finished.
+        SlotPending,        // Waiting for its fence.
+        SlotAcquired,
+    };
+
+    struct Slot
+    {
+        SlotState           state;
+        ReadbackFootprint   footprint;
+        uint64_t            frame;
+        uint64_t            fenceValue;
+    };
+
+    const uint8_t* m_memory;
+    uint64_t m_slotSize;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_recorded;       // Captures of the current frame.
+    std::deque<uint32_t> m_pending;         // In submission order.
+    uint32_t m_nextSlot;
+    uint32_t m_slotsInUse;
+    ReadbackRingStats m_stats;
+};
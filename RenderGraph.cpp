@@ -0,0 +1,598 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    const uint32_t RenderTargetState = 0x4;        // D3D12_RESOURCE_STATE_RENDER_TARGET
+    const uint32_t UnorderedAccessState = 0x8;     // D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+    const uint32_t DepthWriteState = 0x10;         // D3D12_RESOURCE_STATE_DEPTH_WRITE
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return alignment ? (value + alignment - 1) / alignment * alignment : value;
+    }
+
+    bool IsReadOnly(uint32_t state)
+    {
+        return state != 0 && (state & ~ResourceStateTracker::ReadOnlyStates) == 0;
+    }
+
+    bool SameLayout(const RenderGraphLayout& a, const RenderGraphLayout& b)
+    {
+        if (a.heapSize != b.heapSize || a.heapAlignment != b.heapAlignment || a.textures.size() != b.textures.size())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.textures.size(); ++i)
+        {
+            const RenderGraphTexturePlacement& x = a.textures[i];
+            const RenderGraphTexturePlacement& y = b.textures[i];
+            if (x.resource != y.resource || x.offset != y.offset || x.size != y.size || x.initialState != y.initialState
+                || memcmp(&x.desc, &y.desc, sizeof(x.desc)) != 0)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+RenderGraph::RenderGraph() :
+    m_compiled(false),
+    m_layout(),
+    m_stats()
+{
+}
+
+RenderGraphResource RenderGraph::CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+{
+    if (desc.width == 0 || desc.height == 0)
+    {
+        throw std::invalid_argument("RenderGraph::CreateTexture");
+    }
+
+    Resource resource = {};
+    resource.name = name;
+    resource.imported = false;
+    resource.desc = desc;
+    m_resources.push_back(resource);
+
+    Invalidate();
+    return static_cast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::ImportTexture(const std::string& name, uint32_t initialState, uint32_t finalState)
+{
+    Resource resource = {};
+    resource.name = name;
+    resource.imported = true;
+    resource.initialState = initialState;
+    resource.finalState = finalState;
+    m_resources.push_back(resource);
+
+    Invalidate();
+    return static_cast<RenderGraphResource>(m_resources.size() - 1);
+}
+
+uint32_t RenderGraph::AddPass(const std::string& name, ExecuteCallback execute)
+{
+    Pass pass;
+    pass.name = name;
+    pass.execute = execute;
+    pass.sideEffect = false;
+    pass.culled = false;
+    m_passes.push_back(pass);
+
+    Invalidate();
+    return static_cast<uint32_t>(m_passes.size() - 1);
+}
+
+void RenderGraph::Read(uint32_t pass, RenderGraphResource resource, uint32_t state)
+{
+    AddAccess(pass, resource, state, false);
+}
+
+void RenderGraph::Write(uint32_t pass, RenderGraphResource resource, uint32_t state)
+{
+    AddAccess(pass, resource, state, true);
+}
+
+void RenderGraph::AddAccess(uint32_t pass, RenderGraphResource resource, uint32_t state, bool write)
+{
+    if (pass >= m_passes.size() || resource >= m_resources.size())
+    {
+        throw std::out_of_range("RenderGraph: invalid pass or resource");
+    }
+
+    // A pass sees a resource in a single state, several reads combine.
+    for (Access& access : m_passes[pass].accesses)
+    {
+        if (access.resource != resource)
+        {
+            continue;
+        }
+
+        if (access.state != state)
+        {
+            if (!IsReadOnly(access.state) || !IsReadOnly(state))
+            {
+                throw std::logic_error("RenderGraph: resource used in two states by the same pass");
+            }
+            access.state |= state;
+        }
+        access.write = access.write || write;
+
+        Invalidate();
+        return;
+    }
+
+    Access access = { resource, state, write };
+    m_passes[pass].accesses.push_back(access);
+
+    Invalidate();
+}
+
+void RenderGraph::SetSideEffect(uint32_t pass)
+{
+    m_passes.at(pass).sideEffect = true;
+    Invalidate();
+}
+
+void RenderGraph::Reset()
+{
+    m_passes.clear();
+    m_resources.clear();
+    m_livePasses.clear();
+    m_boundaries.clear();
+    Invalidate();
+}
+
+void RenderGraph::Compile(IRenderGraphBackend& backend)
+{
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+
+    m_stats = RenderGraphStats();
+    m_stats.passCount = static_cast<uint32_t>(m_passes.size());
+
+    CullPasses();
+    ComputeLifetimes();
+    PlaceTransients(backend);
+    ScheduleBarriers();
+
+    m_stats.compileMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    m_compiled = true;
+}
+
+void RenderGraph::CullPasses()
+{
+    // Walk the passes backwards from the imported resources, which are the
+    // outputs of the graph. A pass is live if it writes something a later live
+    // pass still needs; a write that does not read the resource ends the need
+    // for whatever was written before it.
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t i = 0; i < m_resources.size(); ++i)
+    {
+        needed[i] = m_resources[i].imported;
+    }
+
+    for (size_t p = m_passes.size(); p-- > 0;)
+    {
+        Pass& pass = m_passes[p];
+
+        bool live = pass.sideEffect;
+        for (const Access& access : pass.accesses)
+        {
+            live = live || (access.write && needed[access.resource]);
+        }
+
+        pass.culled = !live;
+        if (!live)
+        {
+            m_stats.culledPassCount++;
+            continue;
+        }
+
+        for (const Access& access : pass.accesses)
+        {
+            if (access.write)
+            {
+                needed[access.resource] = false;
+            }
+        }
+        for (const Access& access : pass.accesses)
+        {
+            if (!access.write || access.state == UnorderedAccessState)
+            {
+                needed[access.resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::ComputeLifetimes()
+{
+    m_livePasses.clear();
+    for (Resource& resource : m_resources)
+    {
+        resource.uses.clear();
+    }
+
+    for (uint32_t p = 0; p < m_passes.size(); ++p)
+    {
+        if (m_passes[p].culled)
+        {
+            continue;
+        }
+
+        const uint32_t livePass = static_cast<uint32_t>(m_livePasses.size());
+        m_livePasses.push_back(p);
+
+        for (const Access& access : m_passes[p].accesses)
+        {
+            Use use = { livePass, access.state, access.write };
+            m_resources[access.resource].uses.push_back(use);
+        }
+    }
+}
+
+void RenderGraph::PlaceTransients(IRenderGraphBackend& backend)
+{
+    std::vector<RenderGraphResource> transients;
+    for (RenderGraphResource r = 0; r < m_resources.size(); ++r)
+    {
+        Resource& resource = m_resources[r];
+        resource.offset = 0;
+        resource.aliased = false;
+        resource.aliasBefore = InvalidResource;
+
+        if (!resource.imported && !resource.uses.empty())
+        {
+            resource.allocation = backend.GetAllocationInfo(resource.desc);
+            transients.push_back(r);
+        }
+    }
+
+    // Largest first, each one at the lowest offset that does not collide with
+    // a texture alive at the same time.
+    std::vector<RenderGraphResource> order = transients;
+    std::stable_sort(order.begin(), order.end(), [this](RenderGraphResource a, RenderGraphResource b)
+    {
+        return m_resources[a].allocation.size > m_resources[b].allocation.size;
+    });
+
+    auto lifetimesOverlap = [this](const Resource& a, const Resource& b)
+    {
+        return a.uses.front().livePass <= b.uses.back().livePass && b.uses.front().livePass <= a.uses.back().livePass;
+    };
+
+    uint64_t heapSize = 0;
+    uint64_t heapAlignment = 0;
+    std::vector<RenderGraphResource> placed;
+    std::vector<std::pair<uint64_t, uint64_t>> occupied;
+    for (RenderGraphResource r : order)
+    {
+        Resource& resource = m_resources[r];
+
+        occupied.clear();
+        for (RenderGraphResource q : placed)
+        {
+            if (lifetimesOverlap(resource, m_resources[q]))
+            {
+                occupied.push_back(std::make_pair(m_resources[q].offset, m_resources[q].offset + m_resources[q].allocation.size));
+            }
+        }
+        std::sort(occupied.begin(), occupied.end());
+
+        uint64_t offset = 0;
+        for (const auto& range : occupied)
+        {
+            if (offset + resource.allocation.size <= range.first)
+            {
+                break;
+            }
+            offset = std::max<uint64_t>(offset, AlignUp(range.second, resource.allocation.alignment));
+        }
+
+        resource.offset = offset;
+        placed.push_back(r);
+
+        heapSize = std::max<uint64_t>(heapSize, offset + resource.allocation.size);
+        heapAlignment = std::max<uint64_t>(heapAlignment, resource.allocation.alignment);
+        m_stats.unaliasedSize += AlignUp(resource.allocation.size, resource.allocation.alignment);
+    }
+
+    // Textures sharing memory need an aliasing barrier and have to be
+    // initialized when they become active.
+    for (RenderGraphResource r : transients)
+    {
+        Resource& resource = m_resources[r];
+        uint32_t overlapCount = 0;
+        for (RenderGraphResource q : transients)
+        {
+            const Resource& other = m_resources[q];
+            if (q != r && resource.offset < other.offset + other.allocation.size && other.offset < resource.offset + resource.allocation.size)
+            {
+                resource.aliasBefore = q;
+                overlapCount++;
+            }
+        }
+
+        resource.aliased = overlapCount > 0;
+        if (overlapCount > 1)
+        {
+            resource.aliasBefore = InvalidResource;
+        }
+        m_stats.aliasedTextureCount += resource.aliased ? 1 : 0;
+    }
+
+    for (uint32_t livePass = 0; livePass < m_livePasses.size(); ++livePass)
+    {
+        uint64_t liveSize = 0;
+        for (RenderGraphResource r : transients)
+        {
+            const Resource& resource = m_resources[r];
+            if (resource.uses.front().livePass <= livePass && livePass <= resource.uses.back().livePass)
+            {
+                liveSize += resource.allocation.size;
+            }
+        }
+        m_stats.peakLiveSize = std::max<uint64_t>(m_stats.peakLiveSize, liveSize);
+    }
+
+    m_stats.transientTextureCount = static_cast<uint32_t>(transients.size());
+    m_stats.transientHeapSize = heapSize;
+
+    // A transient is left in the state of its last use, so that is the state
+    // it is created in and the one every frame starts from.
+    RenderGraphLayout layout;
+    layout.heapSize = heapSize;
+    layout.heapAlignment = heapAlignment;
+    for (RenderGraphResource r : transients)
+    {
+        const Resource& resource = m_resources[r];
+        RenderGraphTexturePlacement placement = { r, resource.desc, resource.offset, resource.allocation.size, resource.uses.back().state };
+        layout.textures.push_back(placement);
+    }
+
+    layout.version = m_layout.version;
+    if (!SameLayout(layout, m_layout))
+    {
+        layout.version++;
+    }
+    m_layout = layout;
+}
+
+void RenderGraph::AddTransition(RenderGraphResource resource, uint32_t before, uint32_t after, uint32_t beginBoundary, uint32_t endBoundary)
+{
+    RenderGraphBarrier barrier = { RenderGraphBarrierTransition, resource, InvalidResource, before, after, ResourceBarrierFlagNone };
+
+    // Start the transition as soon as the previous use is over when there are
+    // passes in between, the GPU can overlap it with their work.
+    if (beginBoundary < endBoundary)
+    {
+        barrier.flags = ResourceBarrierFlagBeginOnly;
+        m_boundaries[beginBoundary].barriers.push_back(barrier);
+        barrier.flags = ResourceBarrierFlagEndOnly;
+        m_stats.splitBarrierCount++;
+        m_stats.barrierCount++;
+    }
+
+    m_boundaries[endBoundary].barriers.push_back(barrier);
+    m_stats.barrierCount++;
+}
+
+void RenderGraph::ScheduleBarriers()
+{
+    m_boundaries.assign(m_livePasses.size() + 1, Boundary());
+
+    for (RenderGraphResource r = 0; r < m_resources.size(); ++r)
+    {
+        const Resource& resource = m_resources[r];
+        if (resource.uses.empty())
+        {
+            continue;
+        }
+
+        uint32_t state = resource.imported ? resource.initialState : resource.uses.back().state;
+
+        // Nothing of a transient carries over from one frame to the next, and a
+        // placed texture has to be initialized before it is used: every
+        // transient is discarded at its first use, once it is in that state.
+        if (!resource.imported)
+        {
+            const Use& first = resource.uses.front();
+            if (!first.write || (first.state != RenderTargetState && first.state != UnorderedAccessState && first.state != DepthWriteState))
+            {
+                throw std::logic_error("RenderGraph: " + resource.name + " must be written as a render target, depth or unordered access first");
+            }
+            m_boundaries[first.livePass].activated.push_back(r);
+        }
+
+        // Boundary the next transition may begin at.
+        uint32_t earliest = 0;
+        bool lastWrite = false;
+
+        if (resource.aliased)
+        {
+            const uint32_t first = resource.uses.front().livePass;
+            RenderGraphBarrier barrier = { RenderGraphBarrierAliasing, r, resource.aliasBefore, 0, 0, ResourceBarrierFlagNone };
+            m_boundaries[first].barriers.push_back(barrier);
+            m_stats.aliasingBarrierCount++;
+
+            // The memory belongs to another texture until then.
+            earliest = first;
+        }
+
+        for (const Use& use : resource.uses)
+        {
+            const uint32_t resolved = ResourceStateTracker::ResolveState(state, use.state);
+            if (resolved != state)
+            {
+                AddTransition(r, state, resolved, earliest, use.livePass);
+                state = resolved;
+            }
+            else if (state == UnorderedAccessState && (use.write || lastWrite))
+            {
+                RenderGraphBarrier barrier = { RenderGraphBarrierUav, r, InvalidResource, state, state, ResourceBarrierFlagNone };
+                m_boundaries[use.livePass].barriers.push_back(barrier);
+                m_stats.uavBarrierCount++;
+            }
+
+            earliest = use.livePass + 1;
+            lastWrite = use.write;
+        }
+
+        if (resource.imported && state != resource.finalState)
+        {
+            AddTransition(r, state, resource.finalState, earliest, static_cast<uint32_t>(m_livePasses.size()));
+        }
+    }
+
+    // Aliasing barriers have to come before anything touching the activated texture.
+    for (Boundary& boundary : m_boundaries)
+    {
+        std::stable_sort(boundary.barriers.begin(), boundary.barriers.end(), [](const RenderGraphBarrier& a, const RenderGraphBarrier& b)
+        {
+            return a.type == RenderGraphBarrierAliasing && b.type != RenderGraphBarrierAliasing;
+        });
+    }
+}
+
+void RenderGraph::RecordBoundary(IRenderGraphBackend& backend, uint32_t list, uint32_t boundary)
+{
+    backend.RecordBarriers(list, boundary);
+
+    for (RenderGraphResource resource : m_boundaries[boundary].activated)
+    {
+        backend.DiscardResource(list, resource);
+    }
+}
+
+void RenderGraph::Execute(IRenderGraphBackend& backend, ParallelCommandRecorder& recorder)
+{
+    if (!m_compiled)
+    {
+        throw std::logic_error("RenderGraph::Execute before Compile");
+    }
+
+    backend.BeginGraph(m_layout);
+
+    // Barriers depend on the states left by the previous boundaries, so they
+    // are resolved in order before the passes are spread over the threads.
+    for (uint32_t boundary = 0; boundary < m_boundaries.size(); ++boundary)
+    {
+        const std::vector<RenderGraphBarrier>& barriers = m_boundaries[boundary].barriers;
+        backend.PrepareBarriers(boundary, barriers.data(), static_cast<uint32_t>(barriers.size()));
+    }
+
+    const uint32_t livePassCount = static_cast<uint32_t>(m_livePasses.size());
+    recorder.Record(livePassCount, [&](uint32_t livePass, uint32_t list)
+    {
+        RecordBoundary(backend, list, livePass);
+
+        Pass& pass = m_passes[m_livePasses[livePass]];
+        backend.BeginPass(list, pass.name);
+        if (pass.execute)
+        {
+            pass.execute(list);
+        }
+        backend.EndPass(list);
+
+        // The last list also takes the barriers after the last pass.
+        if (livePass + 1 == livePassCount)
+        {
+            RecordBoundary(backend, list, livePassCount);
+        }
+    });
+}
+
+RecordingRenderGraphBackend::RecordingRenderGraphBackend(uint32_t bytesPerPixel) :
+    m_bytesPerPixel(bytesPerPixel),
+    m_barrierCalls(0),
+    m_heapCreates(0),
+    m_layoutVersion(0)
+{
+}
+
+RenderGraphAllocationInfo RecordingRenderGraphBackend::GetAllocationInfo(const RenderGraphTextureDesc& desc)
+{
+    const uint64_t alignment = 64 * 1024;
+    RenderGraphAllocationInfo info = { AlignUp(static_cast<uint64_t>(desc.width) * desc.height * m_bytesPerPixel, alignment), alignment };
+    return info;
+}
+
+void RecordingRenderGraphBackend::BeginGraph(const RenderGraphLayout& layout)
+{
+    if (layout.version != m_layoutVersion)
+    {
+        m_layoutVersion = layout.version;
+        m_heapCreates++;
+    }
+
+    Command command = { CommandBeginGraph, 0, RenderGraphBarrier(), RenderGraph::InvalidResource, std::string() };
+    Push(command);
+}
+
+void RecordingRenderGraphBackend::PrepareBarriers(uint32_t boundary, const RenderGraphBarrier* barriers, uint32_t count)
+{
+    if (boundary >= m_prepared.size())
+    {
+        m_prepared.resize(boundary + 1);
+    }
+    m_prepared[boundary].assign(barriers, barriers + count);
+}
+
+void RecordingRenderGraphBackend::RecordBarriers(uint32_t list, uint32_t boundary)
+{
+    const std::vector<RenderGraphBarrier>& barriers = m_prepared.at(boundary);
+    if (barriers.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const RenderGraphBarrier& barrier : barriers)
+    {
+        Command command = { CommandBarrier, list, barrier, barrier.resource, std::string() };
+        m_commands.push_back(command);
+    }
+    m_barrierCalls++;
+}
+
+void RecordingRenderGraphBackend::DiscardResource(uint32_t list, RenderGraphResource resource)
+{
+    Command command = { CommandDiscard, list, RenderGraphBarrier(), resource, std::string() };
+    Push(command);
+}
+
+void RecordingRenderGraphBackend::BeginPass(uint32_t list, const std::string& name)
+{
+    Command command = { CommandBeginPass, list, RenderGraphBarrier(), RenderGraph::InvalidResource, name };
+    Push(command);
+}
+
+void RecordingRenderGraphBackend::EndPass(uint32_t list)
+{
+    Command command = { CommandEndPass, list, RenderGraphBarrier(), RenderGraph::InvalidResource, std::string() };
+    Push(command);
+}
+
+void RecordingRenderGraphBackend::Push(const Command& command)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.push_back(command);
+}
+
+void RecordingRenderGraphBackend::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_commands.clear();
+    m_barrierCalls = 0;
+}
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "ResourceStateTracker.h"
+#include "CommandRecorder.h"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Declarative frame graph, independent of D3D12. Passes declare the textures
+// they read and write; Compile culls the passes nothing depends on, places the
+// transient textures in a single heap, aliasing the ones whose lifetimes do not
+// overlap, and schedules every barrier. Execute replays the result through a
+// backend, recording the passes in parallel. States use the
+// D3D12_RESOURCE_STATES values, like ResourceStateTracker.
+
+typedef uint32_t RenderGraphResource;
+
+struct RenderGraphTextureDesc
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;                // DXGI_FORMAT
+    bool     allowUnorderedAccess;
+    float    clearColor[4];
+};
+
+struct RenderGraphAllocationInfo
+{
+    uint64_t size;
+    uint64_t alignment;
+};
+
+enum RenderGraphBarrierType
+{
+    RenderGraphBarrierTransition,
+    RenderGraphBarrierAliasing,
+    RenderGraphBarrierUav,
+};
+
+struct RenderGraphBarrier
+{
+    RenderGraphBarrierType  type;
+    RenderGraphResource     resource;
+    RenderGraphResource     resourceBefore;     // Aliasing only, InvalidResource for any.
+    uint32_t                before;
+    uint32_t                after;
+    ResourceBarrierFlags    flags;
+};
+
+struct RenderGraphTexturePlacement
+{
+    RenderGraphResource     resource;
+    RenderGraphTextureDesc  desc;
+    uint64_t                offset;
+    uint64_t                size;
+    uint32_t                initialState;       // State the texture is created in and left in every frame.
+};
+
+// Transient heap the backend has to provide. version changes whenever the
+// placements do, so the backend only recreates its resources then.
+struct RenderGraphLayout
+{
+    uint64_t heapSize;
+    uint64_t heapAlignment;
+    std::vector<RenderGraphTexturePlacement> textures;
+    uint64_t version;
+};
+
+struct RenderGraphStats
+{
+    uint32_t passCount;
+    uint32_t culledPassCount;
+    uint32_t transientTextureCount;     // Transient textures used by a live pass.
+    uint32_t aliasedTextureCount;       // Sharing memory with another texture.
+    uint32_t barrierCount;              // Transitions, split halves included.
+    uint32_t splitBarrierCount;
+    uint32_t aliasingBarrierCount;
+    uint32_t uavBarrierCount;
+    uint64_t transientHeapSize;         // Peak transient memory, with aliasing.
+    uint64_t unaliasedSize;             // Every transient in its own allocation.
+    uint64_t peakLiveSize;              // Largest set of transients alive at once.
+    double   compileMs;
+};
+
+class IRenderGraphBackend
+{
+public:
+    virtual ~IRenderGraphBackend() {}
+
+    // Size and alignment of the texture placed in a heap. Called by Compile.
+    virtual RenderGraphAllocationInfo GetAllocationInfo(const RenderGraphTextureDesc& desc) = 0;
+
+    // Called by Execute before the first pass.
+    virtual void BeginGraph(const RenderGraphLayout& layout) = 0;
+
+    // Called for every pass boundary in order, on the thread running Execute,
+    // before any pass is recorded: resolve the barriers of the boundary,
+    // aliasing barriers first, so they can be recorded out of order.
+    virtual void PrepareBarriers(uint32_t boundary, const RenderGraphBarrier* barriers, uint32_t count) = 0;
+
+    // The rest is called while recording, concurrently for different lists.
+    virtual void RecordBarriers(uint32_t list, uint32_t boundary) = 0;
+
+    // Initialize a transient at its first use, after the barriers of its
+    // boundary: in aliased memory or not, its contents are undefined.
+    virtual void DiscardResource(uint32_t list, RenderGraphResource resource) = 0;
+
+    virtual void BeginPass(uint32_t /*list*/, const std::string& /*name*/) {}
+    virtual void EndPass(uint32_t /*list*/) {}
+};
+
+class RenderGraph
+{
+public:
+    static const RenderGraphResource InvalidResource = ~0u;
+
+    // Receives the index of the command list the pass records into.
+    typedef std::function<void(uint32_t list)> ExecuteCallback;
+
+    RenderGraph();
+
+    // Texture owned by the graph, only valid between its first and last use.
+    // The first use writes it as a render target, depth or unordered access,
+    // the states DiscardResource accepts; Compile throws std::logic_error
+    // otherwise.
+    RenderGraphResource CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc);
+
+    // Texture owned by the caller, in initialState when the graph starts and
+    // left in finalState. Writing to it keeps the writer alive.
+    RenderGraphResource ImportTexture(const std::string& name, uint32_t initialState, uint32_t finalState);
+
+    // Passes execute in the order they are added.
+    uint32_t AddPass(const std::string& name, ExecuteCallback execute);
+    void Read(uint32_t pass, RenderGraphResource resource, uint32_t state);
+    void Write(uint32_t pass, RenderGraphResource resource, uint32_t state);
+
+    // Never cull the pass, for passes with effects outside of the graph.
+    void SetSideEffect(uint32_t pass);
+
+    // Remove every pass and resource.
+    void Reset();
+
+    void Compile(IRenderGraphBackend& backend);
+
+    // Each live pass is a task of the recorder: passes are recorded on the job
+    // system and the lists submitted in order.
+    void Execute(IRenderGraphBackend& backend, ParallelCommandRecorder& recorder);
+
+    bool IsCompiled() const                                 { return m_compiled; }
+    bool IsPassCulled(uint32_t pass) const                  { return m_passes.at(pass).culled; }
+    const RenderGraphLayout& GetLayout() const              { return m_layout; }
+    const RenderGraphStats& GetStats() const                { return m_stats; }
+    const std::string& GetName(RenderGraphResource resource) const { return m_resources.at(resource).name; }
+
+    // Barriers issued before the live pass at index, GetLivePassCount() for
+    // the ones after the last pass.
+    uint32_t GetLivePassCount() const                       { return static_cast<uint32_t>(m_livePasses.size()); }
+    const std::vector<RenderGraphBarrier>& GetBarriers(uint32_t boundary) const { return m_boundaries.at(boundary).barriers; }
+
+private:
+    struct Access
+    {
+        RenderGraphResource resource;
+        uint32_t            state;
+        bool                write;
+    };
+
+    struct Pass
+    {
+        std::string         name;
+        ExecuteCallback     execute;
+        std::vector<Access> accesses;
+        bool                sideEffect;
+        bool                culled;
+    };
+
+    struct Use
+    {
+        uint32_t            livePass;
+        uint32_t            state;
+        bool                write;
+    };
+
+    struct Resource
+    {
+        std::string             name;
+        bool                    imported;
+        RenderGraphTextureDesc  desc;
+        uint32_t                initialState;
+        uint32_t                finalState;
+
+        // Compile results.
+        std::vector<Use>        uses;
+        RenderGraphAllocationInfo allocation;
+        uint64_t                offset;
+        bool                    aliased;
+        RenderGraphResource     aliasBefore;
+    };
+
+    struct Boundary
+    {
+        std::vector<RenderGraphBarrier>     barriers;
+        std::vector<RenderGraphResource>    activated;
+    };
+
+    void AddAccess(uint32_t pass, RenderGraphResource resource, uint32_t state, bool write);
+    void Invalidate() { m_compiled = false; }
+
+    void CullPasses();
+    void ComputeLifetimes();
+    void PlaceTransients(IRenderGraphBackend& backend);
+    void ScheduleBarriers();
+    void AddTransition(RenderGraphResource resource, uint32_t before, uint32_t after, uint32_t beginBoundary, uint32_t endBoundary);
+    void RecordBoundary(IRenderGraphBackend& backend, uint32_t list, uint32_t boundary);
+
+    std::vector<Pass> m_passes;
+    std::vector<Resource> m_resources;
+
+    bool m_compiled;
+    std::vector<uint32_t> m_livePasses;
+    std::vector<Boundary> m_boundaries;
+    RenderGraphLayout m_layout;
+    RenderGraphStats m_stats;
+};
+
+// Backend that only records what the graph asks for, to check and time graph
+// compilation without a GPU. Texture sizes assume bytesPerPixel and 64KB
+// placement alignment. Commands of all the lists go to one locked stream.
+class RecordingRenderGraphBackend : public IRenderGraphBackend
+{
+public:
+    enum CommandType
+    {
+        CommandBeginGraph,
+        CommandBarrier,
+        CommandDiscard,
+        CommandBeginPass,
+        CommandEndPass,
+    };
+
+    struct Command
+    {
+        CommandType             type;
+        uint32_t                list;
+        RenderGraphBarrier      barrier;
+        RenderGraphResource     resource;
+        std::string             name;
+    };
+
+    explicit RecordingRenderGraphBackend(uint32_t bytesPerPixel = 4);
+
+    virtual RenderGraphAllocationInfo GetAllocationInfo(const RenderGraphTextureDesc& desc);
+    virtual void BeginGraph(const RenderGraphLayout& layout);
+    virtual void PrepareBarriers(uint32_t boundary, const RenderGraphBarrier* barriers, uint32_t count);
+    virtual void RecordBarriers(uint32_t list, uint32_t boundary);
+    virtual void DiscardResource(uint32_t list, RenderGraphResource resource);
+    virtual void BeginPass(uint32_t list, const std::string& name);
+    virtual void EndPass(uint32_t list);
+
+    const std::vector<Command>& GetCommands() const { return m_commands; }
+    uint32_t GetBarrierCallCount() const            { return m_barrierCalls; }
+    uint32_t GetHeapCreateCount() const             { return m_heapCreates; }
+    void Clear();
+
+private:
+    void Push(const Command& command);
+
+    uint32_t m_bytesPerPixel;
+    std::vector<std::vector<RenderGraphBarrier>> m_prepared;
+    std::mutex m_mutex;
+    std::vector<Command> m_commands;
+    uint32_t m_barrierCalls;
+    uint32_t m_heapCreates;
+    uint64_t m_layoutVersion;
+};
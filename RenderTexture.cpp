@@ -12,6 +12,9 @@ using namespace DirectX;
 
 RenderTexture::RenderTexture(DXGI_FORMAT format) noexcept :
     m_state(D3D12_RESOURCE_STATE_COMMON),
+    m_stateTracker(nullptr),
+    m_pool(nullptr),
+    m_poolTexture(TexturePool::InvalidTexture),
     m_srvDescriptor{},
     m_rtvDescriptor{},
     m_clearColor{},
@@ -52,7 +55,8 @@ void RenderTexture::SetDevice(_In_ ID3D12Device* device, D3D12_CPU_DESCRIPTOR_HA
         }
     }
 
-    if (!srvDescriptor.ptr || !rtvDescriptor.ptr)
+    // The SRV is optional, output-only targets are never sampled.
+    if (!rtvDescriptor.ptr)
     {
         throw std::runtime_error("Invalid descriptors");
     }
@@ -63,6 +67,58 @@ void RenderTexture::SetDevice(_In_ ID3D12Device* device, D3D12_CPU_DESCRIPTOR_HA
     m_rtvDescriptor = rtvDescriptor;
 }
 
+void RenderTexture::SetStateTracker(_In_opt_ D3D12ResourceStateTracker* stateTracker)
+{
+    if (stateTracker == m_stateTracker)
+        return;
+
+    if (m_stateTracker && m_resource)
+    {
+        m_state = m_stateTracker->GetState(m_resource.Get());
+        m_stateTracker->Untrack(m_resource.Get());
+    }
+
+    m_stateTracker = stateTracker;
+
+    if (m_stateTracker && m_resource)
+    {
+        m_stateTracker->Track(m_resource.Get(), m_state);
+    }
+}
+
+void RenderTexture::SetPool(_In_opt_ D3D12RenderTargetPool* pool)
+{
+    if (pool == m_pool)
+        return;
+
+    // The current texture belongs to the previous allocator, the next
+    // SizeResources call gets one from the new one.
+    ReleaseResource();
+    m_width = m_height = 0;
+
+    m_pool = pool;
+}
+
+void RenderTexture::ReleaseResource() noexcept
+{
+    if (!m_resource)
+        return;
+
+    if (m_stateTracker)
+    {
+        m_state = m_stateTracker->GetState(m_resource.Get());
+        m_stateTracker->Untrack(m_resource.Get());
+    }
+
+    if (m_pool && m_poolTexture != TexturePool::InvalidTexture)
+    {
+        m_pool->Release(m_poolTexture, m_state);
+        m_poolTexture = TexturePool::InvalidTexture;
+    }
+
+    m_resource.Reset();
+}
+
 void RenderTexture::SizeResources(size_t width, size_t height)
 {
     if (width == m_width && height == m_height)
@@ -78,34 +134,56 @@ void RenderTexture::SizeResources(size_t width, size_t height)
 
     m_width = m_height = 0;
 
-    auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+    ReleaseResource();
+
+    if (m_pool)
+    {
+        // A texture of the same size released earlier is reused as it is,
+        // otherwise a new one is placed in the pool heaps.
+        m_poolTexture = m_pool->Acquire(m_format, static_cast<UINT>(width), static_cast<UINT>(height),
+            D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET, m_clearColor);
+        m_resource = m_pool->GetResource(m_poolTexture);
+        m_state = m_pool->GetState(m_poolTexture);
+    }
+    else
+    {
+        auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+
+        D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(m_format,
+            static_cast<UINT64>(width),
+            static_cast<UINT>(height),
+            1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
 
-    D3D12_RESOURCE_DESC desc = CD3DX12_RESOURCE_DESC::Tex2D(m_format,
-        static_cast<UINT64>(width),
-        static_cast<UINT>(height),
-        1, 1, 1, 0, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET);
+        D3D12_CLEAR_VALUE clearValue = { m_format, {} };
+        memcpy(clearValue.Color, m_clearColor, sizeof(clearValue.Color));
 
-    D3D12_CLEAR_VALUE clearValue = { m_format, {} };
-    memcpy(clearValue.Color, m_clearColor, sizeof(clearValue.Color));
+        m_state = D3D12_RESOURCE_STATE_RENDER_TARGET;
 
-    m_state = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        // Create a render target
+        ThrowIfFailed(
+            m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
+                &desc,
+                m_state, 
+                &clearValue,
+                IID_PPV_ARGS(m_resource.ReleaseAndGetAddressOf()))
+        );
 
-    // Create a render target
-    ThrowIfFailed(
-        m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
-            &desc,
-            m_state, 
-            &clearValue,
-            IID_PPV_ARGS(m_resource.ReleaseAndGetAddressOf()))
-    );
+        m_resource->SetName(L"Render Texture");
+    }
 
-    m_resource->SetName(L"Constant Buffer Upload Resource Heap");
+    if (m_stateTracker)
+    {
+        m_stateTracker->Track(m_resource.Get(), m_state);
+    }
 
     // Create RTV.
     m_device->CreateRenderTargetView(m_resource.Get(), nullptr, m_rtvDescriptor);
 
     // Create SRV.
-    m_device->CreateShaderResourceView(m_resource.Get(), nullptr, m_srvDescriptor);
+    if (m_srvDescriptor.ptr)
+    {
+        m_device->CreateShaderResourceView(m_resource.Get(), nullptr, m_srvDescriptor);
+    }
 
     m_width = width;
     m_height = height;
@@ -113,7 +191,7 @@ void RenderTexture::SizeResources(size_t width, size_t height)
 
 void RenderTexture::ReleaseDevice() noexcept
 {
-    m_resource.Reset();
+    ReleaseResource();
     m_device.Reset();
 
     m_state = D3D12_RESOURCE_STATE_COMMON;
@@ -124,6 +202,13 @@ void RenderTexture::ReleaseDevice() noexcept
 
 void RenderTexture::TransitionTo(_In_ ID3D12GraphicsCommandList* commandList, D3D12_RESOURCE_STATES afterState)
 {
+    if (m_stateTracker)
+    {
+        m_stateTracker->Transition(m_resource.Get(), afterState);
+        m_state = m_stateTracker->GetState(m_resource.Get());
+        return;
+    }
+
     commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_resource.Get(), m_state, afterState));
     m_state = afterState;
 }
@@ -139,7 +224,7 @@ void RenderTexture::SetWindow(const RECT& output)
 
 void RenderTexture::BeginScene(_In_ ID3D12GraphicsCommandList* commandList)
 {
-    if (m_state != D3D12_RESOURCE_STATE_RENDER_TARGET) {
+    if (GetCurrentState() != D3D12_RESOURCE_STATE_RENDER_TARGET) {
         TransitionTo(commandList, D3D12_RESOURCE_STATE_RENDER_TARGET);
     }
 }
@@ -161,7 +246,8 @@ ID3D12Resource* RenderTexture::GetResource() const noexcept
 
 D3D12_RESOURCE_STATES RenderTexture::GetCurrentState() const noexcept
 { 
-    return m_state; 
+    // Other users of the tracker may have moved the resource.
+    return m_stateTracker && m_resource ? m_stateTracker->GetState(m_resource.Get()) : m_state;
 }
 
 DXGI_FORMAT RenderTexture::GetFormat() const noexcept
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "stdafx.h"
+#include "D3D12ResourceStateTracker.h"
+#include "D3D12RenderTargetPool.h"
 
 class RenderTexture
 {
@@ -9,6 +11,14 @@ public:
 
     void SetDevice(_In_ ID3D12Device* device, D3D12_CPU_DESCRIPTOR_HANDLE srvDescriptor, D3D12_CPU_DESCRIPTOR_HANDLE rtvDescriptor);
 
+    // With a tracker, transitions are queued on it and only reach the command
+    // list when the tracker is flushed.
+    void SetStateTracker(_In_opt_ D3D12ResourceStateTracker* stateTracker);
+
+    // With a pool, the texture is placed in one of its heaps and handed back
+    // to it on resize or release instead of being destroyed.
+    void SetPool(_In_opt_ D3D12RenderTargetPool* pool);
+
     void SizeResources(size_t width, size_t height);
 
     void ReleaseDevice() noexcept;
@@ -30,9 +40,14 @@ public:
     DXGI_FORMAT GetFormat() const noexcept;
 
 private:
+    void ReleaseResource() noexcept;
+
     Microsoft::WRL::ComPtr<ID3D12Device>                m_device;
     Microsoft::WRL::ComPtr<ID3D12Resource>              m_resource;
     D3D12_RESOURCE_STATES                               m_state;
+    D3D12ResourceStateTracker*                          m_stateTracker;
+    D3D12RenderTargetPool*                              m_pool;
+    UINT                                                m_poolTexture;
     D3D12_CPU_DESCRIPTOR_HANDLE                         m_srvDescriptor;
     D3D12_CPU_DESCRIPTOR_HANDLE                         m_rtvDescriptor;
     float                                               m_clearColor[4];
@@ -0,0 +1,288 @@
+#include "ResourceStateTracker.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    bool Overlaps(uint32_t a, uint32_t b)
+    {
+        return a == b || a == ResourceStateTracker::AllSubresources || b == ResourceStateTracker::AllSubresources;
+    }
+
+}
+
+uint32_t ResourceStateTracker::ResolveState(uint32_t before, uint32_t after)
+{
+    // A read state the subresource is already in does not need a barrier, the
+    // combined read state stays in place.
+    const bool readOnly = before != 0 && (before & ~ReadOnlyStates) == 0;
+    if (readOnly && after != 0 && (before & after) == after)
+    {
+        return before;
+    }
+
+    return after;
+}
+
+ResourceStateTracker::ResourceStateTracker()
+{
+    ResetStats();
+}
+
+void ResourceStateTracker::Track(const void* resource, uint32_t subresourceCount, uint32_t initialState)
+{
+    if (!resource || subresourceCount == 0)
+    {
+        throw std::invalid_argument("ResourceStateTracker::Track");
+    }
+
+    Untrack(resource);
+    m_states[resource].assign(subresourceCount, initialState);
+}
+
+void ResourceStateTracker::Untrack(const void* resource)
+{
+    if (m_states.erase(resource) == 0)
+    {
+        return;
+    }
+
+    m_pending.erase(std::remove_if(m_pending.begin(), m_pending.end(),
+        [resource](const ResourceTransition& transition) { return transition.resource == resource; }), m_pending.end());
+    m_splits.erase(std::remove_if(m_splits.begin(), m_splits.end(),
+        [resource](const SplitTransition& split) { return split.resource == resource; }), m_splits.end());
+}
+
+bool ResourceStateTracker::IsTracked(const void* resource) const
+{
+    return m_states.find(resource) != m_states.end();
+}
+
+std::vector<uint32_t>& ResourceStateTracker::GetStates(const void* resource)
+{
+    auto it = m_states.find(resource);
+    if (it == m_states.end())
+    {
+        throw std::logic_error("ResourceStateTracker: resource is not tracked");
+    }
+
+    return it->second;
+}
+
+const std::vector<uint32_t>& ResourceStateTracker::GetStates(const void* resource) const
+{
+    auto it = m_states.find(resource);
+    if (it == m_states.end())
+    {
+        throw std::logic_error("ResourceStateTracker: resource is not tracked");
+    }
+
+    return it->second;
+}
+
+uint32_t ResourceStateTracker::GetState(const void* resource, uint32_t subresource) const
+{
+    const std::vector<uint32_t>& states = GetStates(resource);
+    return states.at(subresource == AllSubresources ? 0 : subresource);
+}
+
+std::vector<ResourceStateTracker::SplitTransition>::iterator ResourceStateTracker::FindSplit(const void* resource, uint32_t subresource)
+{
+    return std::find_if(m_splits.begin(), m_splits.end(),
+        [resource, subresource](const SplitTransition& split) { return split.resource == resource && Overlaps(split.subresource, subresource); });
+}
+
+uint32_t ResourceStateTracker::Queue(const void* resource, uint32_t subresource, uint32_t before, uint32_t after)
+{
+    const uint32_t state = ResolveState(before, after);
+    if (state == before)
+    {
+        m_stats.transitionsDropped++;
+        return state;
+    }
+
+    // Fold into the last pending barrier touching these subresources when it
+    // covers exactly the same ones, a partial overlap has to keep its order.
+    for (auto it = m_pending.rbegin(); it != m_pending.rend(); ++it)
+    {
+        if (it->resource != resource || !Overlaps(it->subresource, subresource))
+        {
+            continue;
+        }
+
+        if (it->subresource == subresource && it->flags == ResourceBarrierFlagNone)
+        {
+            m_stats.transitionsDropped++;
+            it->after = state;
+            if (it->before == it->after)
+            {
+                m_pending.erase(std::next(it).base());
+            }
+            return state;
+        }
+        break;
+    }
+
+    ResourceTransition transition = { resource, subresource, before, state, ResourceBarrierFlagNone };
+    m_pending.push_back(transition);
+    return state;
+}
+
+void ResourceStateTracker::Transition(const void* resource, uint32_t state, uint32_t subresource)
+{
+    std::vector<uint32_t>& states = GetStates(resource);
+
+    auto split = FindSplit(resource, subresource);
+    if (split != m_splits.end())
+    {
+        if (split->subresource != subresource || split->after != ResolveState(split->after, state))
+        {
+            throw std::logic_error("ResourceStateTracker: transition during a split barrier");
+        }
+
+        // Asking for the state the resource is transitioning to closes the split.
+        EndTransition(resource, subresource);
+        return;
+    }
+
+    m_stats.transitionsRequested++;
+
+    if (subresource != AllSubresources)
+    {
+        states.at(subresource) = Queue(resource, subresource, states.at(subresource), state);
+        return;
+    }
+
+    if (std::all_of(states.begin(), states.end(), [&states](uint32_t s) { return s == states[0]; }))
+    {
+        std::fill(states.begin(), states.end(), Queue(resource, AllSubresources, states[0], state));
+        return;
+    }
+
+    // Subresources in different states need a barrier each.
+    for (uint32_t i = 0; i < states.size(); ++i)
+    {
+        states[i] = Queue(resource, i, states[i], state);
+    }
+}
+
+void ResourceStateTracker::BeginTransition(const void* resource, uint32_t state, uint32_t subresource)
+{
+    std::vector<uint32_t>& states = GetStates(resource);
+    m_stats.transitionsRequested++;
+
+    if (FindSplit(resource, subresource) != m_splits.end())
+    {
+        throw std::logic_error("ResourceStateTracker: split barrier already in progress");
+    }
+
+    uint32_t before;
+    if (subresource == AllSubresources)
+    {
+        before = states[0];
+        if (std::any_of(states.begin(), states.end(), [before](uint32_t s) { return s != before; }))
+        {
+            throw std::logic_error("ResourceStateTracker: split barrier over subresources in different states");
+        }
+    }
+    else
+    {
+        before = states.at(subresource);
+    }
+
+    const uint32_t after = ResolveState(before, state);
+    SplitTransition split = { resource, subresource, before, after, after == before };
+    m_splits.push_back(split);
+
+    if (split.dropped)
+    {
+        m_stats.transitionsDropped++;
+        return;
+    }
+
+    ResourceTransition transition = { resource, subresource, before, after, ResourceBarrierFlagBeginOnly };
+    m_pending.push_back(transition);
+
+    if (subresource == AllSubresources)
+    {
+        std::fill(states.begin(), states.end(), after);
+    }
+    else
+    {
+        states[subresource] = after;
+    }
+}
+
+void ResourceStateTracker::EndTransition(const void* resource, uint32_t subresource)
+{
+    m_stats.transitionsRequested++;
+
+    auto split = FindSplit(resource, subresource);
+    if (split == m_splits.end() || split->subresource != subresource)
+    {
+        throw std::logic_error("ResourceStateTracker: no split barrier to end");
+    }
+
+    const SplitTransition ended = *split;
+    m_splits.erase(split);
+
+    if (ended.dropped)
+    {
+        m_stats.transitionsDropped++;
+        return;
+    }
+
+    // A begin that has not been flushed yet turns into a plain barrier.
+    for (ResourceTransition& pending : m_pending)
+    {
+        if (pending.resource == resource && pending.subresource == subresource && pending.flags == ResourceBarrierFlagBeginOnly)
+        {
+            pending.flags = ResourceBarrierFlagNone;
+            m_stats.transitionsDropped++;
+            return;
+        }
+    }
+
+    ResourceTransition transition = { resource, subresource, ended.before, ended.after, ResourceBarrierFlagEndOnly };
+    m_pending.push_back(transition);
+}
+
+void ResourceStateTracker::Flush(IResourceBarrierSink& sink)
+{
+    if (m_pending.empty())
+    {
+        return;
+    }
+
+    sink.ResourceBarrier(m_pending.data(), static_cast<uint32_t>(m_pending.size()));
+
+    m_stats.barriersIssued += m_pending.size();
+    m_stats.barrierCalls++;
+    m_pending.clear();
+}
+
+uint64_t ResourceStateTracker::GetRemovedCallCount() const
+{
+    return m_stats.transitionsRequested > m_stats.barrierCalls ? m_stats.transitionsRequested - m_stats.barrierCalls : 0;
+}
+
+void ResourceStateTracker::ResetStats()
+{
+    m_stats = ResourceStateTrackerStats();
+}
+
+void RecordingResourceBarrierSink::ResourceBarrier(const ResourceTransition* transitions, uint32_t count)
+{
+    m_batches.push_back(std::vector<ResourceTransition>(transitions, transitions + count));
+}
+
+uint32_t RecordingResourceBarrierSink::GetBarrierCount() const
+{
+    uint32_t count = 0;
+    for (const std::vector<ResourceTransition>& batch : m_batches)
+    {
+        count += static_cast<uint32_t>(batch.size());
+    }
+    return count;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Resource state bookkeeping, independent of D3D12. States, subresource indices
+// and flags use the D3D12 values so the D3D12 side can pass them through as is.
+
+enum ResourceBarrierFlags : uint32_t
+{
+    ResourceBarrierFlagNone         = 0x0,  // D3D12_RESOURCE_BARRIER_FLAG_NONE
+    ResourceBarrierFlagBeginOnly    = 0x1,  // D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY
+    ResourceBarrierFlagEndOnly      = 0x2,  // D3D12_RESOURCE_BARRIER_FLAG_END_ONLY
+};
+
+struct ResourceTransition
+{
+    const void*             resource;
+    uint32_t                subresource;
+    uint32_t                before;
+    uint32_t                after;
+    ResourceBarrierFlags    flags;
+};
+
+// Receives each batch of transitions, ID3D12GraphicsCommandList::ResourceBarrier
+// in the D3D12 implementation.
+class IResourceBarrierSink
+{
+public:
+    virtual ~IResourceBarrierSink() {}
+
+    virtual void ResourceBarrier(const ResourceTransition* transitions, uint32_t count) = 0;
+};
+
+// Keeps every batch it receives, to check the tracker without a GPU.
+class RecordingResourceBarrierSink : public IResourceBarrierSink
+{
+public:
+    virtual void ResourceBarrier(const ResourceTransition* transitions, uint32_t count);
+
+    const std::vector<std::vector<ResourceTransition>>& GetBatches() const { return m_batches; }
+    uint32_t GetBarrierCount() const;
+    void Clear() { m_batches.clear(); }
+
+private:
+    std::vector<std::vector<ResourceTransition>> m_batches;
+};
+
+struct ResourceStateTrackerStats
+{
+    uint64_t transitionsRequested;  // Transition, BeginTransition and EndTransition calls.
+    uint64_t transitionsDropped;    // Redundant, merged into a pending barrier or cancelled out.
+    uint64_t barriersIssued;
+    uint64_t barrierCalls;          // Batches handed to the sink.
+};
+
+// Records the state every subresource will be in once the pending barriers
+// execute. Transitions are queued and handed to the sink in a single batch by
+// Flush, which callers issue right before each draw, dispatch, clear or copy.
+// A transition to the current state is dropped, as is one to a read state the
+// subresource already includes, and a transition queued behind a pending one
+// for the same subresource is folded into it.
+class ResourceStateTracker
+{
+public:
+    static const uint32_t AllSubresources = 0xffffffff;
+
+    // D3D12_RESOURCE_STATE_* bits that only allow reads and can be combined.
+    static const uint32_t ReadOnlyStates = 0x2ae3;
+
+    ResourceStateTracker();
+
+    // State a subresource in before ends up in when after is requested.
+    static uint32_t ResolveState(uint32_t before, uint32_t after);
+
+    // Start tracking a resource, every subresource being in initialState.
+    void Track(const void* resource, uint32_t subresourceCount, uint32_t initialState);
+
+    // Forget a resource along with the barriers still pending on it.
+    void Untrack(const void* resource);
+
+    bool IsTracked(const void* resource) const;
+
+    // State the subresource is in once the pending barriers have executed.
+    uint32_t GetState(const void* resource, uint32_t subresource = 0) const;
+
+    void Transition(const void* resource, uint32_t state, uint32_t subresource = AllSubresources);
+
+    // Split barrier: the transition starts at the next flush and must be closed
+    // with EndTransition, or with a Transition to the same state, before the
+    // resource is used. Every subresource in the range must be in the same state.
+    void BeginTransition(const void* resource, uint32_t state, uint32_t subresource = AllSubresources);
+    void EndTransition(const void* resource, uint32_t subresource = AllSubresources);
+
+    // Hand the pending transitions to the sink in one call, if there are any.
+    void Flush(IResourceBarrierSink& sink);
+
+    uint32_t GetPendingCount() const { return static_cast<uint32_t>(m_pending.size()); }
+
+    // Barrier calls saved compared to issuing one call per requested transition.
+    uint64_t GetRemovedCallCount() const;
+
+    ResourceStateTrackerStats GetStats() const { return m_stats; }
+    void ResetStats();
+
+private:
+    struct SplitTransition
+    {
+        const void* resource;
+        uint32_t    subresource;
+        uint32_t    before;
+        uint32_t    after;
+        bool        dropped;    // The begin was redundant, so is the end.
+    };
+
+    std::vector<uint32_t>& GetStates(const void* resource);
+    const std::vector<uint32_t>& GetStates(const void* resource) const;
+    std::vector<SplitTransition>::iterator FindSplit(const void* resource, uint32_t subresource);
+
+    // Queue one barrier and return the state the subresource ends up in.
+    uint32_t Queue(const void* resource, uint32_t subresource, uint32_t before, uint32_t after);
+
+    std::unordered_map<const void*, std::vector<uint32_t>> m_states;
+    std::vector<ResourceTransition> m_pending;
+    std::vector<SplitTransition> m_splits;
+    ResourceStateTrackerStats m_stats;
+};
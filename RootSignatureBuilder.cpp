@@ -0,0 +1,394 @@
+#include "RootSignatureBuilder.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+    const uint32_t RootDataMask = RootDataVolatile | RootDataStaticWhileSetAtExecute | RootDataStatic;
+
+    // Root space of a parameter in DWORDs.
+    uint32_t GetParameterCost(const RootParameterDesc& parameter)
+    {
+        switch (parameter.type)
+        {
+        case RootParameterConstants:
+            return parameter.count;
+        case RootParameterTable:
+            return 1;
+        default:
+            return 2;
+        }
+    }
+
+    // The register letter of HLSL: b, t, u or s.
+    char GetRegisterClass(RootParameterType type, RootRangeType rangeType)
+    {
+        switch (type)
+        {
+        case RootParameterConstants:
+        case RootParameterCbv:
+            return 'b';
+        case RootParameterSrv:
+            return 't';
+        case RootParameterUav:
+            return 'u';
+        default:
+            break;
+        }
+
+        switch (rangeType)
+        {
+        case RootRangeSrv:
+            return 't';
+        case RootRangeUav:
+            return 'u';
+        case RootRangeCbv:
+            return 'b';
+        default:
+            return 's';
+        }
+    }
+
+    struct RegisterRange
+    {
+        char registerClass;
+        uint32_t first;
+        uint32_t count;
+        uint32_t space;
+        RootVisibility visibility;
+    };
+
+    bool Overlap(const RegisterRange& a, const RegisterRange& b)
+    {
+        return a.registerClass == b.registerClass && a.space == b.space &&
+            a.first < b.first + b.count && b.first < a.first + a.count &&
+            (a.visibility == b.visibility || a.visibility == RootVisibilityAll || b.visibility == RootVisibilityAll);
+    }
+
+    // Exactly one data flag at most, and volatile descriptors with static
+    // data make no sense to the runtime.
+    void CheckDataFlags(uint32_t flags)
+    {
+        const uint32_t data = flags & RootDataMask;
+        if (data & (data - 1))
+        {
+            throw std::invalid_argument("RootSignatureBuilder: more than one data flag");
+        }
+        if ((flags & RootDescriptorsVolatile) && (data & RootDataStatic))
+        {
+            throw std::invalid_argument("RootSignatureBuilder: static data behind volatile descriptors");
+        }
+    }
+}
+
+RootSignatureLayout::RootSignatureLayout() :
+    m_flags(RootSignatureNone)
+{
+}
+
+uint32_t RootSignatureLayout::GetCost() const
+{
+    uint32_t cost = 0;
+    for (const RootParameterDesc& parameter : m_parameters)
+    {
+        cost += GetParameterCost(parameter);
+    }
+    return cost;
+}
+
+uint64_t RootSignatureLayout::GetHash() const
+{
+    // Field by field, the structs have enum members of unspecified size.
+    Hasher64 hasher;
+    hasher.UpdateValue(m_flags);
+    hasher.UpdateValue(static_cast<uint32_t>(m_parameters.size()));
+    for (const RootParameterDesc& parameter : m_parameters)
+    {
+        const uint32_t fields[] =
+        {
+            static_cast<uint32_t>(parameter.type), static_cast<uint32_t>(parameter.visibility), parameter.shaderRegister,
+            parameter.registerSpace, parameter.count, static_cast<uint32_t>(parameter.rangeType), parameter.flags
+        };
+        hasher.UpdateValue(fields);
+    }
+    hasher.UpdateValue(static_cast<uint32_t>(m_staticSamplers.size()));
+    for (const RootStaticSamplerDesc& sampler : m_staticSamplers)
+    {
+        const uint32_t fields[] =
+        {
+            sampler.filter, sampler.addressMode, sampler.shaderRegister, sampler.registerSpace, static_cast<uint32_t>(sampler.visibility)
+        };
+        hasher.UpdateValue(fields);
+    }
+    return hasher.Final();
+}
+
+std::string RootSignatureLayout::Describe() const
+{
+    static const char* const TypeNames[] = { "constants", "CBV", "SRV", "UAV", "table" };
+
+    std::string description;
+    for (const RootParameterDesc& parameter : m_parameters)
+    {
+        char space[24] = {};
+        if (parameter.registerSpace)
+        {
+            snprintf(space, sizeof(space), ",space%u", parameter.registerSpace);
+        }
+
+        char text[64] = {};
+        snprintf(text, sizeof(text), "%s%c%u%s %s %u", description.empty() ? "" : " + ",
+            GetRegisterClass(parameter.type, parameter.rangeType), parameter.shaderRegister, space,
+            TypeNames[parameter.type], GetParameterCost(parameter));
+        description += text;
+    }
+
+    char total[32] = {};
+    snprintf(total, sizeof(total), "%s%u DWORDs", description.empty() ? "" : " = ", GetCost());
+    return description + total;
+}
+
+bool RootSignatureLayout::operator==(const RootSignatureLayout& other) const
+{
+    if (m_flags != other.m_flags || m_parameters.size() != other.m_parameters.size() || m_staticSamplers.size() != other.m_staticSamplers.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < m_parameters.size(); ++i)
+    {
+        const RootParameterDesc& a = m_parameters[i];
+        const RootParameterDesc& b = other.m_parameters[i];
+        if (a.type != b.type || a.visibility != b.visibility || a.shaderRegister != b.shaderRegister ||
+            a.registerSpace != b.registerSpace || a.count != b.count || a.rangeType != b.rangeType || a.flags != b.flags)
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < m_staticSamplers.size(); ++i)
+    {
+        const RootStaticSamplerDesc& a = m_staticSamplers[i];
+        const RootStaticSamplerDesc& b = other.m_staticSamplers[i];
+        if (a.filter != b.filter || a.addressMode != b.addressMode || a.shaderRegister != b.shaderRegister ||
+            a.registerSpace != b.registerSpace || a.visibility != b.visibility)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+RootSignatureBuilder::RootSignatureBuilder(uint32_t rootConstantLimit) :
+    m_rootConstantLimit(rootConstantLimit),
+    m_flags(RootSignatureNone)
+{
+}
+
+uint32_t RootSignatureBuilder::AddConstantBuffer(uint32_t shaderRegister, uint32_t sizeInBytes, RootVisibility visibility, uint32_t registerSpace)
+{
+    if (!sizeInBytes)
+    {
+        throw std::invalid_argument("RootSignatureBuilder::AddConstantBuffer: empty constant buffer");
+    }
+
+    // A root CBV until Build knows what fits in the root.
+    RootParameterDesc parameter = {};
+    parameter.type = RootParameterCbv;
+    parameter.visibility = visibility;
+    parameter.shaderRegister = shaderRegister;
+    parameter.registerSpace = registerSpace;
+    parameter.flags = RootDataStatic;
+    m_parameters.push_back(parameter);
+    m_constantSizes.push_back(sizeInBytes);
+    return static_cast<uint32_t>(m_parameters.size() - 1);
+}
+
+uint32_t RootSignatureBuilder::AddRootConstants(uint32_t shaderRegister, uint32_t count, RootVisibility visibility, uint32_t registerSpace)
+{
+    if (!count)
+    {
+        throw std::invalid_argument("RootSignatureBuilder::AddRootConstants: no constants");
+    }
+
+    RootParameterDesc parameter = {};
+    parameter.type = RootParameterConstants;
+    parameter.visibility = visibility;
+    parameter.shaderRegister = shaderRegister;
+    parameter.registerSpace = registerSpace;
+    parameter.count = count;
+    m_parameters.push_back(parameter);
+    m_constantSizes.push_back(0);
+    return static_cast<uint32_t>(m_parameters.size() - 1);
+}
+
+uint32_t RootSignatureBuilder::AddRootView(RootParameterType type, uint32_t shaderRegister, RootVisibility visibility, uint32_t flags, uint32_t registerSpace)
+{
+    if (type != RootParameterSrv && type != RootParameterUav)
+    {
+        throw std::invalid_argument("RootSignatureBuilder::AddRootView: only SRVs and UAVs, constants go through AddConstantBuffer");
+    }
+    if (flags & RootDescriptorsVolatile)
+    {
+        throw std::invalid_argument("RootSignatureBuilder::AddRootView: a root view has no descriptor");
+    }
+    CheckDataFlags(flags);
+
+    RootParameterDesc parameter = {};
+    parameter.type = type;
+    parameter.visibility = visibility;
+    parameter.shaderRegister = shaderRegister;
+    parameter.registerSpace = registerSpace;
+    parameter.flags = flags;
+    m_parameters.push_back(parameter);
+    m_constantSizes.push_back(0);
+    return static_cast<uint32_t>(m_parameters.size() - 1);
+}
+
+uint32_t RootSignatureBuilder::AddTable(RootRangeType rangeType, uint32_t shaderRegister, uint32_t count, RootVisibility visibility, uint32_t flags, uint32_t registerSpace)
+{
+    if (!count)
+    {
+        throw std::invalid_argument("RootSignatureBuilder::AddTable: empty table");
+    }
+
+    if (rangeType == RootRangeSampler)
+    {
+        if (flags & RootDataMask)
+        {
+            throw std::invalid_argument("RootSignatureBuilder::AddTable: samplers take no data flags");
+        }
+    }
+    else if (!(flags & RootDataMask))
+    {
+        flags |= rangeType == RootRangeUav ? RootDataVolatile : RootDataStaticWhileSetAtExecute;
+    }
+    CheckDataFlags(flags);
+
+    RootParameterDesc parameter = {};
+    parameter.type = RootParameterTable;
+    parameter.visibility = visibility;
+    parameter.shaderRegister = shaderRegister;
+    parameter.registerSpace = registerSpace;
+    parameter.count = count;
+    parameter.rangeType = rangeType;
+    parameter.flags = flags;
+    m_parameters.push_back(parameter);
+    m_constantSizes.push_back(0);
+    return static_cast<uint32_t>(m_parameters.size() - 1);
+}
+
+void RootSignatureBuilder::AddStaticSampler(const RootStaticSamplerDesc& sampler)
+{
+    m_staticSamplers.push_back(sampler);
+}
+
+RootSignatureLayout RootSignatureBuilder::Build() const
+{
+    RootSignatureLayout layout;
+    layout.m_parameters = m_parameters;
+    layout.m_staticSamplers = m_staticSamplers;
+    layout.m_flags = m_flags;
+
+    // Registers bound twice for a stage.
+    std::vector<RegisterRange> ranges;
+    for (const RootParameterDesc& parameter : m_parameters)
+    {
+        const RegisterRange range = { GetRegisterClass(parameter.type, parameter.rangeType), parameter.shaderRegister,
+            parameter.type == RootParameterTable ? parameter.count : 1, parameter.registerSpace, parameter.visibility };
+        ranges.push_back(range);
+    }
+    for (const RootStaticSamplerDesc& sampler : m_staticSamplers)
+    {
+        const RegisterRange range = { 's', sampler.shaderRegister, 1, sampler.registerSpace, sampler.visibility };
+        ranges.push_back(range);
+    }
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        for (size_t j = i + 1; j < ranges.size(); ++j)
+        {
+            if (Overlap(ranges[i], ranges[j]))
+            {
+                char message[96] = {};
+                snprintf(message, sizeof(message), "RootSignatureBuilder: register %c%u space %u bound twice",
+                    ranges[j].registerClass, ranges[j].first, ranges[j].space);
+                throw std::invalid_argument(message);
+            }
+        }
+    }
+
+    // The smallest constant buffers go into the root first, a larger one never
+    // takes the place of several smaller ones.
+    std::vector<uint32_t> constantBuffers;
+    for (uint32_t i = 0; i < m_parameters.size(); ++i)
+    {
+        if (m_constantSizes[i])
+        {
+            constantBuffers.push_back(i);
+        }
+    }
+    std::stable_sort(constantBuffers.begin(), constantBuffers.end(),
+        [this](uint32_t a, uint32_t b) { return m_constantSizes[a] < m_constantSizes[b]; });
+
+    uint32_t cost = layout.GetCost();
+    for (uint32_t index : constantBuffers)
+    {
+        const uint32_t dwords = (m_constantSizes[index] + 3) / 4;
+        if (dwords > m_rootConstantLimit || cost - 2 + dwords > RootSignatureMaxCost)
+        {
+            break;
+        }
+
+        RootParameterDesc& parameter = layout.m_parameters[index];
+        parameter.type = RootParameterConstants;
+        parameter.count = dwords;
+        parameter.flags = RootDataDefault;
+        cost = cost - 2 + dwords;
+    }
+
+    if (cost > RootSignatureMaxCost)
+    {
+        char message[96] = {};
+        snprintf(message, sizeof(message), "RootSignatureBuilder: %u DWORDs of root space, the limit is %u", cost, RootSignatureMaxCost);
+        throw std::invalid_argument(message);
+    }
+    return layout;
+}
+
+RootSignatureCache::RootSignatureCache() :
+    m_stats()
+{
+}
+
+uint32_t RootSignatureCache::Add(const RootSignatureLayout& layout, bool* added)
+{
+    m_stats.requests++;
+
+    // Equal hashes are compared in full, a collision gets its own signature.
+    const uint64_t hash = layout.GetHash();
+    const auto candidates = m_indices.equal_range(hash);
+    for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
+    {
+        if (m_layouts[candidate->second] == layout)
+        {
+            if (added)
+            {
+                *added = false;
+            }
+            return candidate->second;
+        }
+    }
+
+    const uint32_t index = static_cast<uint32_t>(m_layouts.size());
+    m_layouts.push_back(layout);
+    m_indices.emplace(hash, index);
+    m_stats.signatures++;
+    if (added)
+    {
+        *added = true;
+    }
+    return index;
+}
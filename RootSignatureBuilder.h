@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Root space of a signature in DWORDs, D3D12_MAX_ROOT_COST.
+static const uint32_t RootSignatureMaxCost = 64;
+
+enum RootParameterType
+{
+    RootParameterConstants,
+    RootParameterCbv,
+    RootParameterSrv,
+    RootParameterUav,
+    RootParameterTable
+};
+
+// Values of D3D12_DESCRIPTOR_RANGE_TYPE.
+enum RootRangeType
+{
+    RootRangeSrv = 0,
+    RootRangeUav = 1,
+    RootRangeCbv = 2,
+    RootRangeSampler = 3
+};
+
+// Values of D3D12_SHADER_VISIBILITY.
+enum RootVisibility
+{
+    RootVisibilityAll = 0,
+    RootVisibilityVertex = 1,
+    RootVisibilityPixel = 5
+};
+
+// Values of D3D12_DESCRIPTOR_RANGE_FLAGS, the data flags are those of
+// D3D12_ROOT_DESCRIPTOR_FLAGS as well.
+enum RootDataFlags
+{
+    RootDataDefault = 0,
+    RootDescriptorsVolatile = 0x1,
+    RootDataVolatile = 0x2,
+    RootDataStaticWhileSetAtExecute = 0x4,
+    RootDataStatic = 0x8
+};
+
+// Values of D3D12_ROOT_SIGNATURE_FLAGS.
+enum RootSignatureFlags
+{
+    RootSignatureNone = 0,
+    RootSignatureAllowInputLayout = 0x1
+};
+
+// A root parameter of a version 1.1 signature. Tables hold a single range.
+struct RootParameterDesc
+{
+    RootParameterType type;
+    RootVisibility visibility;
+    uint32_t shaderRegister;
+    uint32_t registerSpace;
+    uint32_t count;             // DWORDs of constants, descriptors of a table.
+    RootRangeType rangeType;    // Tables only.
+    uint32_t flags;             // RootDataFlags, none for constants.
+};
+
+// The part of a D3D12_STATIC_SAMPLER_DESC that varies, the rest is the
+// default of CD3DX12_STATIC_SAMPLER_DESC.
+struct RootStaticSamplerDesc
+{
+    uint32_t filter;            // D3D12_FILTER.
+    uint32_t addressMode;       // D3D12_TEXTURE_ADDRESS_MODE, all three coordinates.
+    uint32_t shaderRegister;
+    uint32_t registerSpace;
+    RootVisibility visibility;
+};
+
+// A root signature as RootSignatureBuilder laid it out, parameter i is the
+// root parameter index i of the command list calls.
+class RootSignatureLayout
+{
+public:
+    RootSignatureLayout();
+
+    const std::vector<RootParameterDesc>& GetParameters() const     { return m_parameters; }
+    const RootParameterDesc& GetParameter(uint32_t index) const     { return m_parameters.at(index); }
+    const std::vector<RootStaticSamplerDesc>& GetStaticSamplers() const { return m_staticSamplers; }
+    uint32_t GetFlags() const                                       { return m_flags; }
+
+    // DWORDs of root space: one per table, two per root descriptor, one per
+    // constant. Static samplers are free.
+    uint32_t GetCost() const;
+
+    uint64_t GetHash() const;
+
+    // "b0 constants 12 + t0 table 1 + t1 SRV 2 = 15 DWORDs".
+    std::string Describe() const;
+
+    bool operator==(const RootSignatureLayout& other) const;
+    bool operator!=(const RootSignatureLayout& other) const         { return !(*this == other); }
+
+private:
+    friend class RootSignatureBuilder;
+
+    std::vector<RootParameterDesc> m_parameters;
+    std::vector<RootStaticSamplerDesc> m_staticSamplers;
+    uint32_t m_flags;
+};
+
+// Lays out a root signature from the bindings of its shaders. The parameters
+// keep the order they are added in, each Add returns its root parameter index.
+//
+// Constant buffers are laid out by size: the smallest go straight into the
+// root as constants, up to rootConstantLimit DWORDs each and as long as the
+// signature stays within RootSignatureMaxCost, the others become root CBVs.
+// Either way the command list holds the data, no descriptor is involved.
+class RootSignatureBuilder
+{
+public:
+    static const uint32_t DefaultRootConstantLimit = 16;
+
+    explicit RootSignatureBuilder(uint32_t rootConstantLimit = DefaultRootConstantLimit);
+
+    // Constants written by the CPU for the command lists that use them,
+    // DATA_STATIC as a root CBV.
+    uint32_t AddConstantBuffer(uint32_t shaderRegister, uint32_t sizeInBytes, RootVisibility visibility = RootVisibilityAll, uint32_t registerSpace = 0);
+
+    // count DWORDs set on the command list for each draw or dispatch, they
+    // have no memory to point a CBV to and always go into the root.
+    uint32_t AddRootConstants(uint32_t shaderRegister, uint32_t count, RootVisibility visibility = RootVisibilityAll, uint32_t registerSpace = 0);
+
+    // A buffer bound by its address, type is RootParameterSrv or RootParameterUav.
+    uint32_t AddRootView(RootParameterType type, uint32_t shaderRegister, RootVisibility visibility = RootVisibilityAll,
+        uint32_t flags = RootDataStaticWhileSetAtExecute, uint32_t registerSpace = 0);
+
+    // A table of count descriptors. The descriptors are volatile by default,
+    // they can be written up to the execution of the list: the views of this
+    // sample are transient. The data of SRV and CBV tables is static while set
+    // at execute, that of UAV tables volatile; samplers take no data flags.
+    uint32_t AddTable(RootRangeType rangeType, uint32_t shaderRegister, uint32_t count = 1, RootVisibility visibility = RootVisibilityAll,
+        uint32_t flags = RootDescriptorsVolatile, uint32_t registerSpace = 0);
+
+    void AddStaticSampler(const RootStaticSamplerDesc& sampler);
+    void SetFlags(uint32_t flags)       { m_flags = flags; }
+
+    // Throws std::invalid_argument if two bindings visible to the same stage
+    // share a register or the signature does not fit in RootSignatureMaxCost.
+    RootSignatureLayout Build() const;
+
+private:
+    uint32_t m_rootConstantLimit;
+    std::vector<RootParameterDesc> m_parameters;
+    std::vector<uint32_t> m_constantSizes;     // Bytes, by parameter, 0 for the others.
+    std::vector<RootStaticSamplerDesc> m_staticSamplers;
+    uint32_t m_flags;
+};
+
+struct RootSignatureCacheStats
+{
+    uint32_t requests;
+    uint32_t signatures;    // Distinct layouts, the others were shared.
+};
+
+// Deduplicates root signature layouts by their hash, identical layouts get the
+// same index. The D3D12 side creates one root signature per index.
+class RootSignatureCache
+{
+public:
+    RootSignatureCache();
+
+    // Index of the layout, added is set if it is new.
+    uint32_t Add(const RootSignatureLayout& layout, bool* added = nullptr);
+
+    const RootSignatureLayout& GetLayout(uint32_t index) const  { return m_layouts.at(index); }
+    uint32_t GetCount() const                                   { return static_cast<uint32_t>(m_layouts.size()); }
+    RootSignatureCacheStats GetStats() const                    { return m_stats; }
+
+private:
+    std::unordered_multimap<uint64_t, uint32_t> m_indices;  // By layout hash.
+    std::vector<RootSignatureLayout> m_layouts;
+    RootSignatureCacheStats m_stats;
+};
@@ -0,0 +1,89 @@
+#include "SampleFrame.h"
+
+#include <algorithm>
+#include <cmath>
+
+const float SampleSceneClearColor[4] = { 0.1f, 0.1f, 1.0f, 1.0f };
+const float SampleClearColor[4] = { 0.0f, 0.2f, 0.4f, 1.0f };
+
+const SoftwareTextureVertex SampleQuadVertices[SampleQuadVertexCount] =
+{
+    { { -1.0f,  1.0f, 0.0f }, { 0.0f, 0.0f } },
+    { {  1.0f,  1.0f, 0.0f }, { 1.0f, 0.0f } },
+    { {  1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f } },
+
+    { { -1.0f,  1.0f, 0.0f }, { 0.0f, 0.0f } },
+    { {  1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f } },
+    { { -1.0f, -1.0f, 0.0f }, { 0.0f, 1.0f } }
+};
+
+void GetSampleTriangleVertices(float aspectRatio, SoftwareVertex* vertices)
+{
+    const SoftwareVertex triangle[SampleTriangleVertexCount] =
+    {
+        { { 0.0f, 0.25f * aspectRatio, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+        { { 0.25f, -0.25f * aspectRatio, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+        { { -0.25f, -0.25f * aspectRatio, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } }
+    };
+    std::copy(triangle, triangle + SampleTriangleVertexCount, vertices);
+}
+
+float GetBoundingRadius(const SoftwareVertex* vertices, uint32_t vertexCount)
+{
+    float radius = 0.0f;
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        const float* position = vertices[i].position;
+        radius = std::max<float>(radius, std::sqrt(position[0] * position[0] + position[1] * position[1]));
+    }
+    return radius;
+}
+
+SoftwareShaderData GetSampleShaderData(const SampleFrameParams& params)
+{
+    SoftwareShaderData data = {};
+    data.solidColor[0] = params.color[0];
+    data.solidColor[1] = params.color[1];
+    data.solidColor[2] = params.color[2];
+    data.solidColor[3] = 1.0f;
+
+    // The quad samples the rendered corner of the scene, clamped half a texel
+    // inside so the bilinear filter never reaches the stale texels past it.
+    const float width = static_cast<float>(params.width);
+    const float height = static_cast<float>(params.height);
+    data.sceneUv[0] = params.sceneWidth / width;
+    data.sceneUv[1] = params.sceneHeight / height;
+    data.sceneUv[2] = (params.sceneWidth - 0.5f) / width;
+    data.sceneUv[3] = (params.sceneHeight - 0.5f) / height;
+
+    data.textureWeight[0] = params.textured ? 1.0f : 0.0f;
+    return data;
+}
+
+void BuildSampleFrame(const SampleFrameParams& params, const SoftwareVertex* triangleVertices, const InstanceData* instances,
+    uint32_t instanceCount, const SoftwareTexture* texture, BlurFilter* blur, SoftwareFrameDesc& desc)
+{
+    desc = SoftwareFrameDesc();
+
+    const SoftwareViewport sceneViewport = { 0.0f, 0.0f, static_cast<float>(params.sceneWidth), static_cast<float>(params.sceneHeight) };
+    const SoftwareRect sceneScissor = { 0, 0, static_cast<int32_t>(params.sceneWidth), static_cast<int32_t>(params.sceneHeight) };
+    desc.sceneViewport = sceneViewport;
+    desc.sceneScissor = sceneScissor;
+    std::copy(SampleSceneClearColor, SampleSceneClearColor + 4, desc.sceneClearColor);
+    desc.triangleVertices = triangleVertices;
+    desc.triangleVertexCount = SampleTriangleVertexCount;
+    desc.instances = instances;
+    desc.instanceCount = instanceCount;
+    desc.texture = params.textured ? texture : nullptr;
+    desc.blur = blur;
+
+    const SoftwareViewport viewport = { 0.0f, 0.0f, static_cast<float>(params.width), static_cast<float>(params.height) };
+    const SoftwareRect scissor = { 0, 0, static_cast<int32_t>(params.width), static_cast<int32_t>(params.height) };
+    desc.viewport = viewport;
+    desc.scissor = scissor;
+    std::copy(SampleClearColor, SampleClearColor + 4, desc.clearColor);
+    desc.quadVertices = SampleQuadVertices;
+    desc.quadVertexCount = SampleQuadVertexCount;
+
+    desc.constants = GetSampleShaderData(params);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "SoftwareRasterizer.h"
+
+#include <cstdint>
+
+// The geometry, clear colors and constants of the frames of D3D12HelloTriangle
+// in one place. LoadAssets, WriteFrameConstants and the passes of
+// PopulateCommandList take them from here, and BuildSampleFrame hands the
+// same values to SoftwareRasterizer, so its golden images are of the frames
+// the sample renders.
+
+static const uint32_t SampleTriangleVertexCount = 3;
+static const uint32_t SampleQuadVertexCount = 6;
+
+// RecordTrianglePass clears the scene to the first, RecordQuadPass the back
+// buffer to the second.
+extern const float SampleSceneClearColor[4];
+extern const float SampleClearColor[4];
+
+// Two triangles covering the target, uv (0, 0) at the top left.
+extern const SoftwareTextureVertex SampleQuadVertices[SampleQuadVertexCount];
+
+// The triangle, taller by the aspect ratio so it keeps its shape on screen.
+void GetSampleTriangleVertices(float aspectRatio, SoftwareVertex* vertices);
+
+// Radius of the circle around the origin holding the vertices, the bounding
+// radius CullInstances scales by each instance.
+float GetBoundingRadius(const SoftwareVertex* vertices, uint32_t vertexCount);
+
+// What a frame of the sample depends on, besides its instances and texture.
+struct SampleFrameParams
+{
+    uint32_t width;                 // The window.
+    uint32_t height;
+    uint32_t sceneWidth;            // The scaled corner of the scene drawn to, see UpdateSceneSize.
+    uint32_t sceneHeight;
+    float    color[3];              // FrameState::color.
+    bool     textured;              // A view of resident mips is bound.
+};
+
+// ShaderData of a frame, see WriteFrameConstants.
+SoftwareShaderData GetSampleShaderData(const SampleFrameParams& params);
+
+// The viewports, scissors, clears, vertex buffers and constants of
+// PopulateCommandList. instances are the visible ones, CullInstances output.
+void BuildSampleFrame(const SampleFrameParams& params, const SoftwareVertex* triangleVertices, const InstanceData* instances,
+    uint32_t instanceCount, const SoftwareTexture* texture, BlurFilter* blur, SoftwareFrameDesc& desc);
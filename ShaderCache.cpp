@@ -0,0 +1,222 @@
+#include "ShaderCache.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double ToMilliseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    std::string GetDirectory(const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    // Collect the names of the #include directives of a source file. Commented
+    // out includes are picked up as well, which only costs an extra hash.
+    std::vector<std::string> FindIncludes(const std::vector<uint8_t>& source)
+    {
+        std::vector<std::string> includes;
+        const std::string text(source.begin(), source.end());
+
+        size_t position = 0;
+        while ((position = text.find("#include", position)) != std::string::npos)
+        {
+            position += 8;
+
+            const size_t open = text.find_first_of("\"<\n", position);
+            if (open == std::string::npos || text[open] == '\n')
+            {
+                continue;
+            }
+
+            const size_t close = text.find_first_of(text[open] == '"' ? "\"\n" : ">\n", open + 1);
+            if (close == std::string::npos || text[close] == '\n')
+            {
+                continue;
+            }
+
+            includes.push_back(text.substr(open + 1, close - open - 1));
+            position = close + 1;
+        }
+
+        return includes;
+    }
+
+    void FindDependencies(const std::string& path, const std::vector<uint8_t>& source, std::vector<std::string>& files)
+    {
+        const std::string directory = GetDirectory(path);
+
+        for (const std::string& include : FindIncludes(source))
+        {
+            const std::string includePath = directory + include;
+            if (std::find(files.begin(), files.end(), includePath) != files.end())
+            {
+                continue;
+            }
+            files.push_back(includePath);
+
+            std::vector<uint8_t> contents;
+            if (ReadFileBytes(includePath, contents))
+            {
+                FindDependencies(includePath, contents, files);
+            }
+        }
+    }
+}
+
+void FindShaderDependencies(const std::string& sourcePath, std::vector<std::string>& files)
+{
+    files.clear();
+    files.push_back(sourcePath);
+
+    std::vector<uint8_t> source;
+    if (ReadFileBytes(sourcePath, source))
+    {
+        FindDependencies(sourcePath, source, files);
+    }
+}
+
+ShaderCache::ShaderCache(const std::string& packPath, const std::string& compilerId, ShaderCompileCallback compiler) :
+    m_compilerId(compilerId),
+    m_compiler(compiler),
+    m_store(packPath),
+    m_stats()
+{
+}
+
+void ShaderCache::HashIncludes(const std::string& path, const std::vector<uint8_t>& source,
+    std::vector<std::string>& visited, Hasher64& hasher) const
+{
+    const std::string directory = GetDirectory(path);
+
+    for (const std::string& include : FindIncludes(source))
+    {
+        const std::string includePath = directory + include;
+        if (std::find(visited.begin(), visited.end(), includePath) != visited.end())
+        {
+            continue;
+        }
+        visited.push_back(includePath);
+
+        // Includes that cannot be found next to the source are resolved by the
+        // compiler's own search paths, only their name is part of the key.
+        std::vector<uint8_t> contents;
+        hasher.UpdateString(include);
+        if (ReadFileBytes(includePath, contents))
+        {
+            hasher.UpdateValue(static_cast<uint64_t>(contents.size()));
+            hasher.Update(contents.data(), contents.size());
+            HashIncludes(includePath, contents, visited, hasher);
+        }
+    }
+}
+
+bool ShaderCache::ComputeKey(const ShaderCompileRequest& request, uint64_t* key, std::vector<uint8_t>* source) const
+{
+    std::vector<uint8_t> contents;
+    if (!ReadFileBytes(request.sourcePath, contents))
+    {
+        return false;
+    }
+
+    Hasher64 hasher;
+    hasher.UpdateString(m_compilerId);
+    hasher.UpdateString(request.entryPoint);
+    hasher.UpdateString(request.target);
+    hasher.UpdateValue(request.flags);
+    for (const auto& define : request.defines)
+    {
+        hasher.UpdateString(define.first);
+        hasher.UpdateString(define.second);
+    }
+
+    // The path itself is not hashed, moving the assets keeps the cache warm.
+    hasher.UpdateValue(static_cast<uint64_t>(contents.size()));
+    hasher.Update(contents.data(), contents.size());
+
+    std::vector<std::string> visited;
+    HashIncludes(request.sourcePath, contents, visited, hasher);
+
+    *key = hasher.Final();
+    if (source)
+    {
+        source->swap(contents);
+    }
+    return true;
+}
+
+ShaderBytecode ShaderCache::Get(const ShaderCompileRequest& request)
+{
+    const Clock::time_point hashStart = Clock::now();
+
+    uint64_t key;
+    std::vector<uint8_t> source;
+    if (!ComputeKey(request, &key, &source))
+    {
+        throw std::runtime_error("ShaderCache: cannot read " + request.sourcePath);
+    }
+
+    ShaderBytecode bytecode;
+
+    const uint8_t* cached;
+    uint64_t cachedSize;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.hashMilliseconds += ToMilliseconds(Clock::now() - hashStart);
+        if (m_store.Find(key, &cached, &cachedSize))
+        {
+            m_stats.hits++;
+            bytecode.data = cached;
+            bytecode.size = static_cast<size_t>(cachedSize);
+            return bytecode;
+        }
+
+        m_stats.misses++;
+    }
+
+    // The compiler runs unlocked, the times of concurrent compiles add up.
+    const Clock::time_point compileStart = Clock::now();
+
+    std::vector<uint8_t> output;
+    std::string errors;
+    if (!m_compiler(request, source, output, errors))
+    {
+        throw std::runtime_error("ShaderCache: failed to compile " + request.sourcePath + " (" + request.entryPoint + "): " + errors);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.compileMilliseconds += ToMilliseconds(Clock::now() - compileStart);
+
+    // The same request compiled twice at once keeps the first result, the
+    // bytecode handed out for it stays valid.
+    if (!m_store.Find(key, &cached, &cachedSize))
+    {
+        m_store.Add(key, output);
+        m_store.Find(key, &cached, &cachedSize);
+    }
+
+    bytecode.data = cached;
+    bytecode.size = static_cast<size_t>(cachedSize);
+    return bytecode;
+}
+
+bool ShaderCache::Save()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_store.Save();
+}
+
+ShaderCacheStats ShaderCache::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
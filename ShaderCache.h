@@ -0,0 +1,79 @@
+#pragma once
+
+#include "BlobPack.h"
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct ShaderCompileRequest
+{
+    std::string sourcePath;     // UTF-8.
+    std::string entryPoint;
+    std::string target;
+    uint32_t flags;
+    std::vector<std::pair<std::string, std::string>> defines;
+};
+
+struct ShaderBytecode
+{
+    const void* data;
+    size_t size;
+};
+
+struct ShaderCacheStats
+{
+    uint32_t hits;
+    uint32_t misses;
+    double hashMilliseconds;
+    double compileMilliseconds;
+};
+
+// Compiles source into bytecode. Returns false and fills errors on failure.
+typedef std::function<bool(const ShaderCompileRequest& request, const std::vector<uint8_t>& source,
+    std::vector<uint8_t>& bytecode, std::string& errors)> ShaderCompileCallback;
+
+// The files a shader is built from: its source, then the files it pulls in
+// with #include, resolved next to the file including them. Includes that do
+// not exist (yet) are listed as well.
+void FindShaderDependencies(const std::string& sourcePath, std::vector<std::string>& files);
+
+// Content-addressed shader bytecode cache. The key hashes the source file, every
+// file it pulls in with #include, the entry point, target, flags and defines, so
+// any change to them is a miss. Bytecode lives in a memory-mapped BlobPack and
+// the compiler callback only runs on a miss. Get can be called from several
+// threads at once, the compiles run in parallel.
+class ShaderCache
+{
+public:
+    // compilerId is hashed into every key, change it when the compiler changes.
+    ShaderCache(const std::string& packPath, const std::string& compilerId, ShaderCompileCallback compiler);
+
+    // The bytecode stays valid until the cache is saved or destroyed. Throws
+    // std::runtime_error if the shader fails to compile.
+    ShaderBytecode Get(const ShaderCompileRequest& request);
+
+    // Key of a request given the current contents of its files. Returns false
+    // if the source file cannot be read.
+    bool ComputeKey(const ShaderCompileRequest& request, uint64_t* key, std::vector<uint8_t>* source = nullptr) const;
+
+    // Persist the pack if anything was compiled since it was opened. The pack
+    // is remapped, which invalidates the bytecode returned so far. Not while
+    // Get runs on another thread.
+    bool Save();
+
+    ShaderCacheStats GetStats() const;
+
+private:
+    void HashIncludes(const std::string& path, const std::vector<uint8_t>& source,
+        std::vector<std::string>& visited, class Hasher64& hasher) const;
+
+    std::string m_compilerId;
+    ShaderCompileCallback m_compiler;
+    mutable std::mutex m_mutex;     // Guards the store and the stats.
+    BlobStore m_store;
+    ShaderCacheStats m_stats;
+};
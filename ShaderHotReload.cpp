@@ -0,0 +1,373 @@
+#include "ShaderHotReload.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // How long a file has to be left alone before it is compiled.
+    const std::chrono::milliseconds SettleTime(100);
+
+    double ToMilliseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    std::string GetDirectory(const std::string& normalizedPath)
+    {
+        const size_t slash = normalizedPath.find_last_of('/');
+        return slash == std::string::npos ? std::string(".") : normalizedPath.substr(0, slash + 1);
+    }
+
+    bool DependsOn(const std::vector<std::string>& files, const std::vector<std::string>& changed)
+    {
+        for (const std::string& file : files)
+        {
+            if (std::find(changed.begin(), changed.end(), file) != changed.end())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+ShaderHotReload::ShaderHotReload(IFileWatcher& watcher, ShaderCompileCallback compiler, PipelineRebuildCallback rebuild) :
+    m_watcher(watcher),
+    m_compiler(compiler),
+    m_rebuild(rebuild),
+    m_stats(),
+    m_stopping(false)
+{
+}
+
+ShaderHotReload::~ShaderHotReload()
+{
+    Stop();
+}
+
+std::string ShaderHotReload::NormalizePath(const std::string& path)
+{
+    // A leading separator is kept, two of them for a UNC path.
+    std::string prefix;
+    size_t position = 0;
+    while (position < path.size() && position < 2 && (path[position] == '/' || path[position] == '\\'))
+    {
+        prefix += '/';
+        position++;
+    }
+
+    std::vector<std::string> segments;
+    while (position <= path.size())
+    {
+        size_t end = path.find_first_of("/\\", position);
+        if (end == std::string::npos)
+        {
+            end = path.size();
+        }
+
+        const std::string segment = path.substr(position, end - position);
+        position = end + 1;
+
+        if (segment.empty() || segment == ".")
+        {
+            continue;
+        }
+
+        if (segment != "..")
+        {
+            segments.push_back(segment);
+            continue;
+        }
+
+        // ".." stops at the root and at a drive letter, and leads a relative
+        // path that climbs out of its directory.
+        const bool drive = !segments.empty() && segments.back().back() == ':';
+        if (!segments.empty() && segments.back() != ".." && !drive)
+        {
+            segments.pop_back();
+        }
+        else if (prefix.empty() && !drive)
+        {
+            segments.push_back(segment);
+        }
+    }
+
+    std::string normalized = prefix;
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        normalized += i ? "/" : "";
+        normalized += segments[i];
+    }
+
+#ifdef _WIN32
+    for (char& c : normalized)
+    {
+        c = (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+#endif
+    return normalized;
+}
+
+uint32_t ShaderHotReload::AddShader(const ShaderCompileRequest& request, const void* bytecode, size_t size)
+{
+    Shader shader;
+    shader.request = request;
+    shader.bytecode.assign(static_cast<const uint8_t*>(bytecode), static_cast<const uint8_t*>(bytecode) + size);
+
+    FindShaderDependencies(request.sourcePath, shader.files);
+    for (std::string& file : shader.files)
+    {
+        file = NormalizePath(file);
+    }
+
+    m_shaders.push_back(std::move(shader));
+    return static_cast<uint32_t>(m_shaders.size() - 1);
+}
+
+uint32_t ShaderHotReload::AddPipeline(const std::vector<uint32_t>& shaders)
+{
+    for (uint32_t shader : shaders)
+    {
+        if (shader >= m_shaders.size())
+        {
+            throw std::invalid_argument("ShaderHotReload: unknown shader");
+        }
+    }
+
+    m_pipelines.push_back(shaders);
+    return static_cast<uint32_t>(m_pipelines.size() - 1);
+}
+
+void ShaderHotReload::WatchFiles(const Shader& shader)
+{
+    // Directories that do not exist yet cannot be watched, their files are
+    // picked up once an include next to them changes.
+    for (const std::string& file : shader.files)
+    {
+        m_watcher.Watch(GetDirectory(file));
+    }
+}
+
+void ShaderHotReload::Start(uint32_t pollMilliseconds)
+{
+    if (m_thread.joinable())
+    {
+        throw std::logic_error("ShaderHotReload::Start: already running");
+    }
+
+    for (const Shader& shader : m_shaders)
+    {
+        WatchFiles(shader);
+    }
+
+    m_stopping = false;
+    m_thread = std::thread(&ShaderHotReload::ReloadThread, this, pollMilliseconds);
+}
+
+void ShaderHotReload::Stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    m_thread.join();
+}
+
+void ShaderHotReload::ReloadThread(uint32_t pollMilliseconds)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_stopping)
+    {
+        lock.unlock();
+        Update(Clock::now());
+        lock.lock();
+
+        m_wake.wait_for(lock, std::chrono::milliseconds(pollMilliseconds), [this] { return m_stopping; });
+    }
+}
+
+uint32_t ShaderHotReload::Update(Clock::time_point now)
+{
+    m_changed.clear();
+    m_watcher.Poll(m_changed);
+    for (const std::string& path : m_changed)
+    {
+        m_pendingFiles[NormalizePath(path)] = now;
+    }
+
+    // Files still being written wait for a later poll.
+    std::vector<std::string> settled;
+    for (auto file = m_pendingFiles.begin(); file != m_pendingFiles.end(); )
+    {
+        if (now - file->second >= SettleTime)
+        {
+            settled.push_back(file->first);
+            file = m_pendingFiles.erase(file);
+        }
+        else
+        {
+            ++file;
+        }
+    }
+
+    ShaderHotReloadStats stats = {};
+    stats.fileChanges = m_changed.size();
+
+    const Clock::time_point reloadStart = Clock::now();
+    std::vector<std::string> errors;
+    std::vector<bool> recompiled(m_shaders.size(), false);
+    for (size_t i = 0; i < m_shaders.size() && !settled.empty(); ++i)
+    {
+        Shader& shader = m_shaders[i];
+        if (!DependsOn(shader.files, settled))
+        {
+            continue;
+        }
+
+        stats.shaderCompiles++;
+        std::vector<uint8_t> source;
+        std::vector<uint8_t> bytecode;
+        std::string errorText;
+        bool compiled = false;
+        if (!ReadFileBytes(shader.request.sourcePath, source))
+        {
+            errorText = "cannot read the source";
+        }
+        else
+        {
+            try
+            {
+                compiled = m_compiler(shader.request, source, bytecode, errorText);
+            }
+            catch (const std::exception& e)
+            {
+                errorText = e.what();
+            }
+        }
+
+        if (!compiled)
+        {
+            stats.compileErrors++;
+            errors.push_back(shader.request.sourcePath + " (" + shader.request.entryPoint + "): " + errorText);
+            continue;
+        }
+
+        // The includes may have changed with the source.
+        shader.bytecode.swap(bytecode);
+        FindShaderDependencies(shader.request.sourcePath, shader.files);
+        for (std::string& file : shader.files)
+        {
+            file = NormalizePath(file);
+        }
+        WatchFiles(shader);
+        recompiled[i] = true;
+    }
+
+    std::vector<std::pair<uint32_t, std::unique_ptr<IReloadedPipeline>>> built;
+    for (uint32_t pipeline = 0; pipeline < m_pipelines.size() && stats.shaderCompiles; ++pipeline)
+    {
+        const std::vector<uint32_t>& shaders = m_pipelines[pipeline];
+        if (std::none_of(shaders.begin(), shaders.end(), [&recompiled](uint32_t shader) { return recompiled[shader]; }))
+        {
+            continue;
+        }
+
+        std::vector<ShaderBytecode> bytecode;
+        for (uint32_t shader : shaders)
+        {
+            const ShaderBytecode code = { m_shaders[shader].bytecode.data(), m_shaders[shader].bytecode.size() };
+            bytecode.push_back(code);
+        }
+
+        stats.pipelineBuilds++;
+        std::string errorText;
+        std::unique_ptr<IReloadedPipeline> rebuilt;
+        try
+        {
+            rebuilt = m_rebuild(pipeline, bytecode, errorText);
+        }
+        catch (const std::exception& e)
+        {
+            errorText = e.what();
+        }
+
+        if (!rebuilt)
+        {
+            stats.buildErrors++;
+            errors.push_back("pipeline " + std::to_string(pipeline) + ": " + errorText);
+            continue;
+        }
+        built.emplace_back(pipeline, std::move(rebuilt));
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // A pipeline rebuilt again before it was swapped in replaces the earlier
+    // build, which the GPU never saw.
+    for (auto& pipeline : built)
+    {
+        m_ready[pipeline.first] = std::move(pipeline.second);
+    }
+    m_errors.insert(m_errors.end(), errors.begin(), errors.end());
+
+    m_stats.fileChanges += stats.fileChanges;
+    m_stats.shaderCompiles += stats.shaderCompiles;
+    m_stats.compileErrors += stats.compileErrors;
+    m_stats.pipelineBuilds += stats.pipelineBuilds;
+    m_stats.buildErrors += stats.buildErrors;
+    if (stats.shaderCompiles)
+    {
+        m_stats.lastReloadMs = ToMilliseconds(Clock::now() - reloadStart);
+    }
+
+    return static_cast<uint32_t>(built.size());
+}
+
+uint32_t ShaderHotReload::Apply(uint64_t retireFenceValue, uint64_t completedFenceValue, const PipelineSwapCallback& swap)
+{
+    // Release the replaced pipelines the GPU is done with.
+    m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(),
+        [completedFenceValue](const std::pair<uint64_t, std::unique_ptr<IReloadedPipeline>>& retired) { return retired.first <= completedFenceValue; }),
+        m_retired.end());
+
+    std::map<uint32_t, std::unique_ptr<IReloadedPipeline>> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_ready.empty())
+        {
+            return 0;
+        }
+        ready.swap(m_ready);
+        m_stats.pipelineSwaps += ready.size();
+    }
+
+    for (auto& pipeline : ready)
+    {
+        swap(pipeline.first, *pipeline.second);
+        m_retired.emplace_back(retireFenceValue, std::move(pipeline.second));
+    }
+    return static_cast<uint32_t>(ready.size());
+}
+
+void ShaderHotReload::TakeErrors(std::vector<std::string>& errors)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    errors.insert(errors.end(), m_errors.begin(), m_errors.end());
+    m_errors.clear();
+}
+
+ShaderHotReloadStats ShaderHotReload::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "FileWatcher.h"
+#include "ShaderCache.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// A pipeline rebuilt from reloaded shaders. The D3D12 implementation holds an
+// ID3D12PipelineState.
+class IReloadedPipeline
+{
+public:
+    virtual ~IReloadedPipeline() {}
+};
+
+// Build pipeline from the bytecode of its shaders, in the order they were
+// given to AddPipeline. Runs on the reload thread. Returns null and fills
+// errors on failure.
+typedef std::function<std::unique_ptr<IReloadedPipeline>(uint32_t pipeline, const std::vector<ShaderBytecode>& shaders,
+    std::string& errors)> PipelineRebuildCallback;
+
+// Exchange the contents of a rebuilt pipeline with the live one. Afterwards
+// rebuilt holds the replaced pipeline, which is released once the GPU is done
+// with it.
+typedef std::function<void(uint32_t pipeline, IReloadedPipeline& rebuilt)> PipelineSwapCallback;
+
+struct ShaderHotReloadStats
+{
+    uint64_t fileChanges;
+    uint64_t shaderCompiles;
+    uint64_t compileErrors;
+    uint64_t pipelineBuilds;
+    uint64_t buildErrors;
+    uint64_t pipelineSwaps;
+    double lastReloadMs;        // Compiles and pipeline builds of the last batch of changes.
+};
+
+// Recompiles shaders when their files change and rebuilds the pipelines using
+// them, on a thread of its own. A shader depends on its source and on every
+// file it includes; a change to any of them recompiles the shader, and only
+// the pipelines built from a recompiled shader are rebuilt. Rebuilt pipelines
+// wait in a queue until the render thread swaps them in at a frame boundary,
+// so the render loop never waits on the compiler. A shader that fails to
+// compile keeps its last good bytecode and its pipelines are left alone.
+//
+// Changes are picked up once their file has been quiet for a moment, editors
+// write a file in several steps.
+class ShaderHotReload
+{
+public:
+    ShaderHotReload(IFileWatcher& watcher, ShaderCompileCallback compiler, PipelineRebuildCallback rebuild);
+    ~ShaderHotReload();
+
+    // Shaders and pipelines are added before Start. bytecode is the result of
+    // the initial compile and is copied.
+    uint32_t AddShader(const ShaderCompileRequest& request, const void* bytecode, size_t size);
+    uint32_t AddPipeline(const std::vector<uint32_t>& shaders);
+
+    // Watch the files of the shaders and process their changes on the reload
+    // thread every pollMilliseconds.
+    void Start(uint32_t pollMilliseconds = 50);
+    void Stop();
+
+    // Process the changes reported by the watcher so far: what the reload
+    // thread does on each poll, for drivers without the thread. Returns the
+    // number of pipelines rebuilt.
+    uint32_t Update(std::chrono::steady_clock::time_point now);
+
+    // At a frame boundary, on the render thread: swap the rebuilt pipelines
+    // in. The replaced ones are released once completedFenceValue reaches the
+    // retireFenceValue they were swapped out at. Returns the number swapped.
+    uint32_t Apply(uint64_t retireFenceValue, uint64_t completedFenceValue, const PipelineSwapCallback& swap);
+
+    // Compiler and pipeline errors since the last call.
+    void TakeErrors(std::vector<std::string>& errors);
+
+    ShaderHotReloadStats GetStats() const;
+
+    // Watched files are compared by their normalized path: '/' separators,
+    // "." and ".." resolved, and lower case on Windows.
+    static std::string NormalizePath(const std::string& path);
+
+private:
+    struct Shader
+    {
+        ShaderCompileRequest request;
+        std::vector<uint8_t> bytecode;
+        std::vector<std::string> files;     // Normalized.
+    };
+
+    void WatchFiles(const Shader& shader);
+    void ReloadThread(uint32_t pollMilliseconds);
+
+    IFileWatcher& m_watcher;
+    ShaderCompileCallback m_compiler;
+    PipelineRebuildCallback m_rebuild;
+
+    // Owned by the reload thread once started.
+    std::vector<Shader> m_shaders;
+    std::vector<std::vector<uint32_t>> m_pipelines;
+    std::map<std::string, std::chrono::steady_clock::time_point> m_pendingFiles;
+    std::vector<std::string> m_changed;
+
+    // Shared with the render thread.
+    mutable std::mutex m_mutex;
+    std::map<uint32_t, std::unique_ptr<IReloadedPipeline>> m_ready;
+    std::vector<std::string> m_errors;
+    ShaderHotReloadStats m_stats;
+
+    // Render thread only.
+    std::vector<std::pair<uint64_t, std::unique_ptr<IReloadedPipeline>>> m_retired;
+
+    std::thread m_thread;
+    std::condition_variable m_wake;
+    bool m_stopping;
+};
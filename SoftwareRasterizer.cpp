@@ -0,0 +1,724 @@
+#include "SoftwareRasterizer.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    const int64_t SubpixelBits = 8;
+    const int64_t SubpixelOne = 1 << SubpixelBits;
+
+    // Vertices further out are culled, so that the edge functions fit in 64 bits.
+    const float GuardBand = static_cast<float>(1 << 19);
+
+    // Triangles set up by a job of the vertex stage.
+    const uint32_t SetupBatchSize = 1024;
+
+    const uint32_t DxgiFormatR8G8B8A8Unorm = 28;
+    const uint32_t DxgiFormatB8G8R8A8Unorm = 87;
+
+    uint32_t ToUnorm8(float value)
+    {
+        // Written so that NaN ends up as 0.
+        const float clamped = value > 0.0f ? std::min<float>(value, 1.0f) : 0.0f;
+        return static_cast<uint32_t>(clamped * 255.0f + 0.5f);
+    }
+
+    uint32_t PackColor(const float color[4])
+    {
+        return ToUnorm8(color[0]) | (ToUnorm8(color[1]) << 8) | (ToUnorm8(color[2]) << 16) | (ToUnorm8(color[3]) << 24);
+    }
+
+    // D3D12_TEXTURE_ADDRESS_MODE_MIRROR, for texel indices.
+    int32_t Mirror(int32_t index, int32_t size)
+    {
+        if (static_cast<uint32_t>(index) < static_cast<uint32_t>(size))
+        {
+            return index;
+        }
+
+        const int32_t period = 2 * size;
+        int32_t wrapped = index % period;
+        if (wrapped < 0)
+        {
+            wrapped += period;
+        }
+        return wrapped < size ? wrapped : period - 1 - wrapped;
+    }
+
+    // a + (b - a) * weight / 256 for the four channels, two at a time: a
+    // channel times at most 256 still fits in the 16 bits of its lane.
+    uint32_t LerpColor(uint32_t a, uint32_t b, uint32_t weight)
+    {
+        const uint32_t inverse = 256 - weight;
+        const uint32_t redBlue = (((a & 0x00ff00ffu) * inverse + (b & 0x00ff00ffu) * weight + 0x00800080u) >> 8) & 0x00ff00ffu;
+        const uint32_t greenAlpha = (((a >> 8) & 0x00ff00ffu) * inverse + ((b >> 8) & 0x00ff00ffu) * weight + 0x00800080u) & 0xff00ff00u;
+        return redBlue | greenAlpha;
+    }
+
+    // std::floor is a library call without SSE4.1.
+    int32_t FloorToInt(float value)
+    {
+        const int32_t truncated = static_cast<int32_t>(value);
+        return value < static_cast<float>(truncated) ? truncated - 1 : truncated;
+    }
+
+    uint32_t ToWeight(float fraction)
+    {
+        return static_cast<uint32_t>(fraction * 256.0f + 0.5f);
+    }
+
+    // Filter weights have 8 bits of subtexel precision, as much as D3D
+    // requires of the hardware, so texels are blended as packed integers.
+    uint32_t SampleBilinear(const SoftwareImage& image, float u, float v)
+    {
+        const int32_t width = static_cast<int32_t>(image.GetWidth());
+        const int32_t height = static_cast<int32_t>(image.GetHeight());
+
+        // Far away coordinates have lost their fraction anyway, the limit keeps
+        // the texel indices in range. Comparisons are written so NaN clamps too.
+        const float limit = 8388608.0f;
+        float x = u * width - 0.5f;
+        float y = v * height - 0.5f;
+        x = x > -limit ? std::min<float>(x, limit) : -limit;
+        y = y > -limit ? std::min<float>(y, limit) : -limit;
+
+        const int32_t texelX = FloorToInt(x);
+        const int32_t texelY = FloorToInt(y);
+        const int32_t x0 = Mirror(texelX, width);
+        const int32_t x1 = Mirror(texelX + 1, width);
+        const uint32_t* row0 = image.GetRow(Mirror(texelY, height));
+        const uint32_t* row1 = image.GetRow(Mirror(texelY + 1, height));
+
+        const uint32_t weightX = ToWeight(x - static_cast<float>(texelX));
+        const uint32_t top = LerpColor(row0[x0], row0[x1], weightX);
+        const uint32_t bottom = LerpColor(row1[x0], row1[x1], weightX);
+        return LerpColor(top, bottom, ToWeight(y - static_cast<float>(texelY)));
+    }
+
+    // D3D12_FILTER_MIN_MAG_MIP_LINEAR over the mips of the texture.
+    uint32_t SampleTrilinear(const SoftwareTexture& texture, float u, float v, float lod)
+    {
+        const float maxLod = static_cast<float>(texture.GetMipCount() - 1);
+        lod = lod > 0.0f ? std::min<float>(lod, maxLod) : 0.0f;
+
+        const uint32_t mip = static_cast<uint32_t>(lod);
+        const uint32_t weight = ToWeight(lod - static_cast<float>(mip));
+        const uint32_t color = SampleBilinear(texture.GetMip(mip), u, v);
+        if (weight == 0)
+        {
+            return color;
+        }
+        return LerpColor(color, SampleBilinear(texture.GetMip(std::min<uint32_t>(mip + 1, texture.GetMipCount() - 1)), u, v), weight);
+    }
+
+    SoftwareRect Intersect(const SoftwareRect& a, const SoftwareRect& b)
+    {
+        SoftwareRect rect;
+        rect.left = std::max<int32_t>(a.left, b.left);
+        rect.top = std::max<int32_t>(a.top, b.top);
+        rect.right = std::min<int32_t>(a.right, b.right);
+        rect.bottom = std::min<int32_t>(a.bottom, b.bottom);
+        return rect;
+    }
+
+    bool IsEmpty(const SoftwareRect& rect)
+    {
+        return rect.left >= rect.right || rect.top >= rect.bottom;
+    }
+
+    // Pixels a draw may touch: the scissor, the viewport and the target.
+    SoftwareRect GetDrawBounds(const SoftwareImage& target, const SoftwareViewport& viewport, const SoftwareRect& scissor)
+    {
+        const SoftwareRect targetRect = { 0, 0, static_cast<int32_t>(target.GetWidth()), static_cast<int32_t>(target.GetHeight()) };
+        const SoftwareRect viewportRect =
+        {
+            static_cast<int32_t>(std::floor(viewport.x)),
+            static_cast<int32_t>(std::floor(viewport.y)),
+            static_cast<int32_t>(std::ceil(viewport.x + viewport.width)),
+            static_cast<int32_t>(std::ceil(viewport.y + viewport.height))
+        };
+        return Intersect(Intersect(targetRect, viewportRect), scissor);
+    }
+
+    void ToScreen(const SoftwareViewport& viewport, float x, float y, float* screenX, float* screenY)
+    {
+        *screenX = viewport.x + (x + 1.0f) * 0.5f * viewport.width;
+        *screenY = viewport.y + (1.0f - y) * 0.5f * viewport.height;
+    }
+
+    // Whitespace and comments, then a decimal number of a PPM header.
+    bool ReadPpmNumber(const std::vector<uint8_t>& data, size_t& offset, uint32_t& value)
+    {
+        while (offset < data.size())
+        {
+            if (data[offset] == '#')
+            {
+                while (offset < data.size() && data[offset] != '\n')
+                {
+                    offset++;
+                }
+            }
+            else if (data[offset] == ' ' || data[offset] == '\t' || data[offset] == '\r' || data[offset] == '\n')
+            {
+                offset++;
+            }
+            else
+            {
+                break;
+            }
+        }
+
+        uint64_t number = 0;
+        const size_t start = offset;
+        while (offset < data.size() && data[offset] >= '0' && data[offset] <= '9' && offset - start < 9)
+        {
+            number = number * 10 + (data[offset] - '0');
+            offset++;
+        }
+        value = static_cast<uint32_t>(number);
+        return offset > start;
+    }
+}
+
+SoftwareImage::SoftwareImage() :
+    m_width(0),
+    m_height(0)
+{
+}
+
+SoftwareImage::SoftwareImage(uint32_t width, uint32_t height) :
+    m_width(0),
+    m_height(0)
+{
+    Resize(width, height);
+}
+
+void SoftwareImage::Resize(uint32_t width, uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+    m_pixels.assign(static_cast<size_t>(width) * height, 0);
+}
+
+void SoftwareImage::Clear(const float color[4])
+{
+    std::fill(m_pixels.begin(), m_pixels.end(), PackColor(color));
+}
+
+void SoftwareImage::Clear(const float color[4], const SoftwareRect& rect)
+{
+    const SoftwareRect imageRect = { 0, 0, static_cast<int32_t>(m_width), static_cast<int32_t>(m_height) };
+    const SoftwareRect cleared = Intersect(rect, imageRect);
+    if (IsEmpty(cleared))
+    {
+        return;
+    }
+
+    const uint32_t packed = PackColor(color);
+    for (int32_t y = cleared.top; y < cleared.bottom; ++y)
+    {
+        uint32_t* row = GetRow(static_cast<uint32_t>(y));
+        std::fill(row + cleared.left, row + cleared.right, packed);
+    }
+}
+
+bool SoftwareImage::SavePpm(const std::string& path) const
+{
+    char header[64] = {};
+    const int headerSize = snprintf(header, sizeof(header), "P6\n%u %u\n255\n", m_width, m_height);
+
+    std::vector<uint8_t> image(header, header + headerSize);
+    image.reserve(image.size() + m_pixels.size() * 3);
+    for (uint32_t pixel : m_pixels)
+    {
+        image.push_back(static_cast<uint8_t>(pixel));
+        image.push_back(static_cast<uint8_t>(pixel >> 8));
+        image.push_back(static_cast<uint8_t>(pixel >> 16));
+    }
+    return WriteFileAtomic(path, image.data(), image.size());
+}
+
+bool SoftwareImage::LoadPpm(const std::string& path)
+{
+    std::vector<uint8_t> data;
+    if (!ReadFileBytes(path, data) || data.size() < 2 || data[0] != 'P' || data[1] != '6')
+    {
+        return false;
+    }
+
+    size_t offset = 2;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t maxValue = 0;
+    if (!ReadPpmNumber(data, offset, width) || !ReadPpmNumber(data, offset, height) || !ReadPpmNumber(data, offset, maxValue) ||
+        maxValue != 255 || offset >= data.size())
+    {
+        return false;
+    }
+
+    // A single whitespace character ends the header.
+    offset++;
+    const uint64_t pixelCount = static_cast<uint64_t>(width) * height;
+    if ((data.size() - offset) / 3 < pixelCount)
+    {
+        return false;
+    }
+
+    Resize(width, height);
+    const uint8_t* rgb = data.data() + offset;
+    for (uint32_t& pixel : m_pixels)
+    {
+        pixel = rgb[0] | (rgb[1] << 8) | (rgb[2] << 16) | 0xff000000u;
+        rgb += 3;
+    }
+    return true;
+}
+
+SoftwareImageDifference CompareImages(const SoftwareImage& a, const SoftwareImage& b, uint32_t tolerance)
+{
+    SoftwareImageDifference difference = {};
+    if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight())
+    {
+        difference.maxDelta = 255;
+        difference.differentPixels = static_cast<uint64_t>(std::max<uint32_t>(a.GetWidth(), b.GetWidth())) *
+            std::max<uint32_t>(a.GetHeight(), b.GetHeight());
+        return difference;
+    }
+
+    for (uint32_t y = 0; y < a.GetHeight(); ++y)
+    {
+        const uint32_t* rowA = a.GetRow(y);
+        const uint32_t* rowB = b.GetRow(y);
+        for (uint32_t x = 0; x < a.GetWidth(); ++x)
+        {
+            if (rowA[x] == rowB[x])
+            {
+                continue;
+            }
+
+            uint32_t pixelDelta = 0;
+            for (uint32_t shift = 0; shift < 32; shift += 8)
+            {
+                const int32_t delta = static_cast<int32_t>((rowA[x] >> shift) & 0xff) - static_cast<int32_t>((rowB[x] >> shift) & 0xff);
+                pixelDelta = std::max<uint32_t>(pixelDelta, static_cast<uint32_t>(std::abs(delta)));
+            }
+            difference.maxDelta = std::max<uint32_t>(difference.maxDelta, pixelDelta);
+            if (pixelDelta > tolerance)
+            {
+                difference.differentPixels++;
+            }
+        }
+    }
+    return difference;
+}
+
+bool SoftwareTexture::Load(const DdsTexture& texture, uint32_t firstMip)
+{
+    const TextureDesc& desc = texture.GetDesc();
+    if (desc.dimension != TextureDimension2D || desc.arraySize != 1 || desc.cube || firstMip >= desc.mipCount ||
+        (desc.format != DxgiFormatR8G8B8A8Unorm && desc.format != DxgiFormatB8G8R8A8Unorm))
+    {
+        return false;
+    }
+
+    const bool swapRedBlue = desc.format == DxgiFormatB8G8R8A8Unorm;
+    m_mips.resize(desc.mipCount - firstMip);
+    for (uint32_t mip = firstMip; mip < desc.mipCount; ++mip)
+    {
+        const DdsSubresource& subresource = texture.GetSubresource(mip);
+        const uint8_t* data = texture.GetSubresourceData(mip);
+
+        SoftwareImage& image = m_mips[mip - firstMip];
+        image.Resize(subresource.width, subresource.height);
+        for (uint32_t y = 0; y < subresource.height; ++y)
+        {
+            uint32_t* row = image.GetRow(y);
+            memcpy(row, data + static_cast<size_t>(y) * subresource.rowSize, static_cast<size_t>(subresource.width) * 4);
+            if (swapRedBlue)
+            {
+                for (uint32_t x = 0; x < subresource.width; ++x)
+                {
+                    row[x] = (row[x] & 0xff00ff00u) | ((row[x] >> 16) & 0xff) | ((row[x] & 0xff) << 16);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+SoftwareRasterizer::SoftwareRasterizer(JobSystem* jobs, uint32_t tileSize) :
+    m_jobs(jobs),
+    m_tileSize(tileSize),
+    m_tilesX(0),
+    m_tilesY(0),
+    m_stats()
+{
+    if (tileSize == 0)
+    {
+        throw std::invalid_argument("SoftwareRasterizer: the tile size must not be 0");
+    }
+}
+
+void SoftwareRasterizer::RunJobs(uint32_t count, const JobSystem::Job& job)
+{
+    if (m_jobs)
+    {
+        m_jobs->ParallelFor(count, job);
+        return;
+    }
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        job(i, 0);
+    }
+}
+
+void SoftwareRasterizer::DrawTriangles(SoftwareImage& target, const SoftwareViewport& viewport, const SoftwareRect& scissor,
+    const SoftwareVertex* vertices, uint32_t vertexCount, const InstanceData* instances, uint32_t instanceCount,
+    const SoftwareShaderData& constants, const SoftwareTexture* texture)
+{
+    const SoftwareRect bounds = GetDrawBounds(target, viewport, scissor);
+    const uint32_t trianglesPerInstance = vertexCount / 3;
+    const uint32_t triangleCount = trianglesPerInstance * instanceCount;
+    if (IsEmpty(bounds) || triangleCount == 0)
+    {
+        return;
+    }
+
+    // Without a texture the null view samples 0, which leaves a flat color too.
+    const float weight = constants.textureWeight[0];
+    const bool hasTexture = texture && texture->GetMipCount() > 0;
+    const bool textured = hasTexture && weight != 0.0f;
+    const float flatScale = hasTexture ? 1.0f : 1.0f - weight;
+
+    m_triangles.resize(triangleCount);
+    m_setupResults.resize(triangleCount);
+
+    // The vertex stage and the setup, in batches of triangles.
+    RunJobs((triangleCount + SetupBatchSize - 1) / SetupBatchSize, [&](uint32_t batch, uint32_t)
+    {
+        const uint32_t end = std::min<uint32_t>(triangleCount, (batch + 1) * SetupBatchSize);
+        for (uint32_t index = batch * SetupBatchSize; index < end; ++index)
+        {
+            const InstanceData& instance = instances[index / trianglesPerInstance];
+            const SoftwareVertex* triangleVertices = vertices + (index % trianglesPerInstance) * 3;
+
+            const float s = std::sin(instance.rotation);
+            const float c = std::cos(instance.rotation);
+
+            ScreenVertex screen[3];
+            for (uint32_t i = 0; i < 3; ++i)
+            {
+                const float* position = triangleVertices[i].position;
+                const float scaledX = position[0] * instance.scale;
+                const float scaledY = position[1] * instance.scale;
+                const float x = scaledX * c - scaledY * s + instance.position[0];
+                const float y = scaledX * s + scaledY * c + instance.position[1];
+
+                ToScreen(viewport, x, y, &screen[i].x, &screen[i].y);
+                screen[i].u = position[0] * 2.0f + 0.5f;
+                screen[i].v = position[1] * -2.0f + 0.5f;
+            }
+
+            Triangle& triangle = m_triangles[index];
+            m_setupResults[index] = SetupTriangle(screen, bounds, triangle) ? 1 : 0;
+            if (!m_setupResults[index])
+            {
+                continue;
+            }
+
+            float color[4];
+            for (uint32_t channel = 0; channel < 4; ++channel)
+            {
+                color[channel] = instance.color[channel] * constants.solidColor[channel];
+                triangle.colorValue[channel] = color[channel];
+                color[channel] *= flatScale;
+            }
+            triangle.color = PackColor(color);
+
+            // uv is linear, so are its derivatives and the LOD constant over the triangle.
+            if (textured)
+            {
+                const SoftwareImage& mip = texture->GetMip(0);
+                const float width = static_cast<float>(mip.GetWidth());
+                const float height = static_cast<float>(mip.GetHeight());
+                const float lengthX = std::sqrt(triangle.u[1] * width * triangle.u[1] * width + triangle.v[1] * height * triangle.v[1] * height);
+                const float lengthY = std::sqrt(triangle.u[2] * width * triangle.u[2] * width + triangle.v[2] * height * triangle.v[2] * height);
+                triangle.lod = std::log2(std::max<float>(std::max<float>(lengthX, lengthY), 1e-20f));
+            }
+        }
+    });
+
+    Rasterize(target, textured ? ShaderTextured : ShaderFlat, constants, texture, nullptr);
+}
+
+void SoftwareRasterizer::DrawQuad(SoftwareImage& target, const SoftwareViewport& viewport, const SoftwareRect& scissor,
+    const SoftwareTextureVertex* vertices, uint32_t vertexCount, const SoftwareShaderData& constants, const SoftwareImage& source)
+{
+    const SoftwareRect bounds = GetDrawBounds(target, viewport, scissor);
+    const uint32_t triangleCount = vertexCount / 3;
+    if (IsEmpty(bounds) || triangleCount == 0 || source.GetWidth() == 0 || source.GetHeight() == 0)
+    {
+        return;
+    }
+
+    m_triangles.resize(triangleCount);
+    m_setupResults.resize(triangleCount);
+    for (uint32_t index = 0; index < triangleCount; ++index)
+    {
+        ScreenVertex screen[3];
+        for (uint32_t i = 0; i < 3; ++i)
+        {
+            const SoftwareTextureVertex& vertex = vertices[index * 3 + i];
+            ToScreen(viewport, vertex.position[0], vertex.position[1], &screen[i].x, &screen[i].y);
+            screen[i].u = vertex.uv[0];
+            screen[i].v = vertex.uv[1];
+        }
+        m_setupResults[index] = SetupTriangle(screen, bounds, m_triangles[index]) ? 1 : 0;
+    }
+
+    Rasterize(target, ShaderQuad, constants, nullptr, &source);
+}
+
+void SoftwareRasterizer::RenderFrame(const SoftwareFrameDesc& desc, SoftwareImage& scene, SoftwareImage& display, SoftwareImage& output)
+{
+    scene.Clear(desc.sceneClearColor, desc.sceneScissor);
+    DrawTriangles(scene, desc.sceneViewport, desc.sceneScissor, desc.triangleVertices, desc.triangleVertexCount,
+        desc.instances, desc.instanceCount, desc.constants, desc.texture);
+
+    // The blur covers the scaled scene in the corner of the target.
+    const SoftwareImage* quadSource = &scene;
+    const SoftwareRect sceneRect = { 0, 0, static_cast<int32_t>(scene.GetWidth()), static_cast<int32_t>(scene.GetHeight()) };
+    const SoftwareRect blurred = Intersect(sceneRect, desc.sceneScissor);
+    if (desc.blur && !IsEmpty(blurred))
+    {
+        if (display.GetWidth() != scene.GetWidth() || display.GetHeight() != scene.GetHeight())
+        {
+            display.Resize(scene.GetWidth(), scene.GetHeight());
+        }
+        desc.blur->Apply(scene.GetData(), scene.GetPitch(), display.GetData(), display.GetPitch(),
+            static_cast<uint32_t>(blurred.right), static_cast<uint32_t>(blurred.bottom));
+        quadSource = &display;
+    }
+
+    output.Clear(desc.clearColor);
+    DrawQuad(output, desc.viewport, desc.scissor, desc.quadVertices, desc.quadVertexCount, desc.constants, *quadSource);
+}
+
+bool SoftwareRasterizer::SetupTriangle(const ScreenVertex* vertices, const SoftwareRect& bounds, Triangle& triangle)
+{
+    int64_t x[3];
+    int64_t y[3];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        // Also false for NaN.
+        if (!(std::fabs(vertices[i].x) < GuardBand && std::fabs(vertices[i].y) < GuardBand))
+        {
+            return false;
+        }
+        x[i] = static_cast<int64_t>(std::floor(static_cast<double>(vertices[i].x) * SubpixelOne + 0.5));
+        y[i] = static_cast<int64_t>(std::floor(static_cast<double>(vertices[i].y) * SubpixelOne + 0.5));
+    }
+
+    // Twice the area, positive for triangles clockwise on screen, the front faces.
+    const int64_t area = (y[2] - y[0]) * (x[1] - x[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+    if (area <= 0)
+    {
+        return false;
+    }
+
+    // Pixels whose center may be covered, max exclusive.
+    const int64_t minX = std::min<int64_t>(x[0], std::min<int64_t>(x[1], x[2]));
+    const int64_t minY = std::min<int64_t>(y[0], std::min<int64_t>(y[1], y[2]));
+    const int64_t maxX = std::max<int64_t>(x[0], std::max<int64_t>(x[1], x[2]));
+    const int64_t maxY = std::max<int64_t>(y[0], std::max<int64_t>(y[1], y[2]));
+    triangle.minX = static_cast<int32_t>(std::max<int64_t>(bounds.left, minX >> SubpixelBits));
+    triangle.minY = static_cast<int32_t>(std::max<int64_t>(bounds.top, minY >> SubpixelBits));
+    triangle.maxX = static_cast<int32_t>(std::min<int64_t>(bounds.right, (maxX >> SubpixelBits) + 1));
+    triangle.maxY = static_cast<int32_t>(std::min<int64_t>(bounds.bottom, (maxY >> SubpixelBits) + 1));
+    if (triangle.minX >= triangle.maxX || triangle.minY >= triangle.maxY)
+    {
+        return false;
+    }
+
+    // Edge i runs from vertex i to the next one. Its function is positive
+    // inside; the edges that are neither top nor left need it strictly
+    // positive, which the bias of -1 turns into a test against 0 for all.
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        const uint32_t next = (i + 1) % 3;
+        const int64_t dx = x[next] - x[i];
+        const int64_t dy = y[next] - y[i];
+        const bool topLeft = (dy == 0 && dx > 0) || dy < 0;
+
+        triangle.edgeA[i] = -dy * SubpixelOne;
+        triangle.edgeB[i] = dx * SubpixelOne;
+        triangle.edgeC[i] = (dx - dy) * (SubpixelOne / 2) + x[i] * dy - y[i] * dx + (topLeft ? 0 : -1);
+    }
+
+    // Planes of the attributes through the snapped vertices, in pixels.
+    const double x0 = static_cast<double>(x[0]) / SubpixelOne;
+    const double y0 = static_cast<double>(y[0]) / SubpixelOne;
+    const double x1 = static_cast<double>(x[1]) / SubpixelOne - x0;
+    const double y1 = static_cast<double>(y[1]) / SubpixelOne - y0;
+    const double x2 = static_cast<double>(x[2]) / SubpixelOne - x0;
+    const double y2 = static_cast<double>(y[2]) / SubpixelOne - y0;
+    const double determinant = x1 * y2 - x2 * y1;
+
+    const float values[2][3] =
+    {
+        { vertices[0].u, vertices[1].u, vertices[2].u },
+        { vertices[0].v, vertices[1].v, vertices[2].v }
+    };
+    float* planes[2] = { triangle.u, triangle.v };
+    for (uint32_t attribute = 0; attribute < 2; ++attribute)
+    {
+        const double a0 = values[attribute][0];
+        const double a1 = values[attribute][1] - a0;
+        const double a2 = values[attribute][2] - a0;
+        const double stepX = (a1 * y2 - a2 * y1) / determinant;
+        const double stepY = (a2 * x1 - a1 * x2) / determinant;
+
+        planes[attribute][0] = static_cast<float>(a0 + stepX * (0.5 - x0) + stepY * (0.5 - y0));
+        planes[attribute][1] = static_cast<float>(stepX);
+        planes[attribute][2] = static_cast<float>(stepY);
+    }
+
+    triangle.lod = 0.0f;
+    return true;
+}
+
+void SoftwareRasterizer::Rasterize(SoftwareImage& target, Shader shader, const SoftwareShaderData& constants,
+    const SoftwareTexture* texture, const SoftwareImage* source)
+{
+    const uint32_t tilesX = (target.GetWidth() + m_tileSize - 1) / m_tileSize;
+    const uint32_t tilesY = (target.GetHeight() + m_tileSize - 1) / m_tileSize;
+    if (tilesX != m_tilesX || tilesY != m_tilesY)
+    {
+        m_tilesX = tilesX;
+        m_tilesY = tilesY;
+        m_bins.resize(static_cast<size_t>(tilesX) * tilesY);
+    }
+
+    // Bins keep the draw order of their triangles.
+    const uint32_t triangleCount = static_cast<uint32_t>(m_triangles.size());
+    m_activeTiles.clear();
+    uint64_t binned = 0;
+    uint64_t culled = 0;
+    for (uint32_t index = 0; index < triangleCount; ++index)
+    {
+        if (!m_setupResults[index])
+        {
+            culled++;
+            continue;
+        }
+
+        const Triangle& triangle = m_triangles[index];
+        const uint32_t firstX = static_cast<uint32_t>(triangle.minX) / m_tileSize;
+        const uint32_t firstY = static_cast<uint32_t>(triangle.minY) / m_tileSize;
+        const uint32_t lastX = static_cast<uint32_t>(triangle.maxX - 1) / m_tileSize;
+        const uint32_t lastY = static_cast<uint32_t>(triangle.maxY - 1) / m_tileSize;
+        for (uint32_t tileY = firstY; tileY <= lastY; ++tileY)
+        {
+            for (uint32_t tileX = firstX; tileX <= lastX; ++tileX)
+            {
+                const uint32_t tile = tileY * m_tilesX + tileX;
+                if (m_bins[tile].empty())
+                {
+                    m_activeTiles.push_back(tile);
+                }
+                m_bins[tile].push_back(index);
+                binned++;
+            }
+        }
+    }
+
+    const uint32_t activeCount = static_cast<uint32_t>(m_activeTiles.size());
+    m_tilePixels.assign(activeCount, 0);
+    RunJobs(activeCount, [&](uint32_t index, uint32_t)
+    {
+        RasterizeTile(target, m_activeTiles[index], shader, constants, texture, source, m_tilePixels[index]);
+    });
+
+    for (uint32_t index = 0; index < activeCount; ++index)
+    {
+        m_bins[m_activeTiles[index]].clear();
+        m_stats.pixels += m_tilePixels[index];
+    }
+    m_stats.triangles += triangleCount;
+    m_stats.culledTriangles += culled;
+    m_stats.binnedTriangles += binned;
+    m_stats.tiles += activeCount;
+}
+
+void SoftwareRasterizer::RasterizeTile(SoftwareImage& target, uint32_t tile, Shader shader, const SoftwareShaderData& constants,
+    const SoftwareTexture* texture, const SoftwareImage* source, uint64_t& pixels)
+{
+    const int32_t tileLeft = static_cast<int32_t>((tile % m_tilesX) * m_tileSize);
+    const int32_t tileTop = static_cast<int32_t>((tile / m_tilesX) * m_tileSize);
+    const int32_t tileRight = tileLeft + static_cast<int32_t>(m_tileSize);
+    const int32_t tileBottom = tileTop + static_cast<int32_t>(m_tileSize);
+    const float weight = constants.textureWeight[0];
+
+    uint64_t shaded = 0;
+    for (uint32_t index : m_bins[tile])
+    {
+        const Triangle& triangle = m_triangles[index];
+        const int32_t left = std::max<int32_t>(triangle.minX, tileLeft);
+        const int32_t top = std::max<int32_t>(triangle.minY, tileTop);
+        const int32_t right = std::min<int32_t>(triangle.maxX, tileRight);
+        const int32_t bottom = std::min<int32_t>(triangle.maxY, tileBottom);
+
+        for (int32_t y = top; y < bottom; ++y)
+        {
+            int64_t edge0 = triangle.edgeC[0] + triangle.edgeA[0] * left + triangle.edgeB[0] * y;
+            int64_t edge1 = triangle.edgeC[1] + triangle.edgeA[1] * left + triangle.edgeB[1] * y;
+            int64_t edge2 = triangle.edgeC[2] + triangle.edgeA[2] * left + triangle.edgeB[2] * y;
+            uint32_t* row = target.GetRow(static_cast<uint32_t>(y));
+            const float rowU = triangle.u[0] + triangle.u[2] * y;
+            const float rowV = triangle.v[0] + triangle.v[2] * y;
+
+            for (int32_t x = left; x < right; ++x)
+            {
+                if ((edge0 | edge1 | edge2) >= 0)
+                {
+                    shaded++;
+                    if (shader == ShaderFlat)
+                    {
+                        row[x] = triangle.color;
+                    }
+                    else
+                    {
+                        const float u = rowU + triangle.u[1] * x;
+                        const float v = rowV + triangle.v[1] * x;
+                        if (shader == ShaderTextured)
+                        {
+                            const uint32_t texel = SampleTrilinear(*texture, u, v, triangle.lod);
+                            float color[4];
+                            for (uint32_t channel = 0; channel < 4; ++channel)
+                            {
+                                const float sample = static_cast<float>((texel >> (channel * 8)) & 0xff) * (1.0f / 255.0f);
+                                color[channel] = triangle.colorValue[channel] * (1.0f + (sample - 1.0f) * weight);
+                            }
+                            row[x] = PackColor(color);
+                        }
+                        else
+                        {
+                            row[x] = SampleBilinear(*source, std::min<float>(u * constants.sceneUv[0], constants.sceneUv[2]),
+                                std::min<float>(v * constants.sceneUv[1], constants.sceneUv[3]));
+                        }
+                    }
+                }
+                edge0 += triangle.edgeA[0];
+                edge1 += triangle.edgeA[1];
+                edge2 += triangle.edgeA[2];
+            }
+        }
+    }
+    pixels = shaded;
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "BlurFilter.h"
+#include "DdsTexture.h"
+#include "InstanceCulling.h"
+#include "JobSystem.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// D3D12_RECT: right and bottom are exclusive.
+struct SoftwareRect
+{
+    int32_t left;
+    int32_t top;
+    int32_t right;
+    int32_t bottom;
+};
+
+struct SoftwareViewport
+{
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+// RGBA8 image in memory, red in the low byte of each pixel like
+// DXGI_FORMAT_R8G8B8A8_UNORM. Rows are packed, so BlurFilter runs on it
+// directly. The render targets and textures of SoftwareRasterizer.
+class SoftwareImage
+{
+public:
+    SoftwareImage();
+    SoftwareImage(uint32_t width, uint32_t height);
+
+    void Resize(uint32_t width, uint32_t height);
+
+    // Colors are converted like a render target view does, rounded to nearest.
+    void Clear(const float color[4]);
+    void Clear(const float color[4], const SoftwareRect& rect);
+
+    uint32_t GetWidth() const                       { return m_width; }
+    uint32_t GetHeight() const                      { return m_height; }
+    size_t GetPitch() const                         { return static_cast<size_t>(m_width) * 4; }
+
+    uint8_t* GetData()                              { return reinterpret_cast<uint8_t*>(m_pixels.data()); }
+    const uint8_t* GetData() const                  { return reinterpret_cast<const uint8_t*>(m_pixels.data()); }
+    uint32_t* GetRow(uint32_t y)                    { return m_pixels.data() + static_cast<size_t>(y) * m_width; }
+    const uint32_t* GetRow(uint32_t y) const        { return m_pixels.data() + static_cast<size_t>(y) * m_width; }
+    uint32_t GetPixel(uint32_t x, uint32_t y) const { return GetRow(y)[x]; }
+
+    // Binary PPM, alpha is dropped on save and set to 255 on load.
+    bool SavePpm(const std::string& path) const;
+    bool LoadPpm(const std::string& path);
+
+private:
+    uint32_t m_width;
+    uint32_t m_height;
+    std::vector<uint32_t> m_pixels;
+};
+
+// How far two images of the same size are apart, per channel.
+struct SoftwareImageDifference
+{
+    uint32_t maxDelta;              // Largest channel difference, 255 when the sizes differ.
+    uint64_t differentPixels;       // Pixels with a channel more than tolerance apart.
+};
+
+// Golden image comparison: GPU and software results are not bit exact, a
+// small tolerance absorbs the differences of filtering and rounding.
+SoftwareImageDifference CompareImages(const SoftwareImage& a, const SoftwareImage& b, uint32_t tolerance);
+
+// Mip chain of a 2D texture, sampled the way the static sampler of the root
+// signature does: trilinear filtering, mirrored addressing.
+class SoftwareTexture
+{
+public:
+    // Mips firstMip and below of a 2D RGBA8 or BGRA8 texture, the range a view
+    // of the resident mips covers. False for any other kind of texture.
+    bool Load(const DdsTexture& texture, uint32_t firstMip);
+
+    uint32_t GetMipCount() const                    { return static_cast<uint32_t>(m_mips.size()); }
+    const SoftwareImage& GetMip(uint32_t mip) const { return m_mips[mip]; }
+
+private:
+    std::vector<SoftwareImage> m_mips;
+};
+
+// Layouts of the two input layouts, Vertex and TextureVertex of the sample.
+struct SoftwareVertex
+{
+    float position[3];
+    float color[4];
+};
+
+struct SoftwareTextureVertex
+{
+    float position[3];
+    float uv[2];
+};
+
+// ShaderData, the constant buffer both shaders read.
+struct SoftwareShaderData
+{
+    float solidColor[4];
+    float sceneUv[4];
+    float textureWeight[4];
+};
+
+// Everything PopulateCommandList records for a frame, see RenderFrame.
+struct SoftwareFrameDesc
+{
+    SoftwareViewport sceneViewport;
+    SoftwareRect sceneScissor;
+    float sceneClearColor[4];
+    const SoftwareVertex* triangleVertices;
+    uint32_t triangleVertexCount;
+    const InstanceData* instances;              // The visible ones.
+    uint32_t instanceCount;
+    const SoftwareTexture* texture;             // Null for the null view.
+    BlurFilter* blur;                           // Null when the scene is not blurred.
+
+    SoftwareViewport viewport;
+    SoftwareRect scissor;
+    float clearColor[4];
+    const SoftwareTextureVertex* quadVertices;
+    uint32_t quadVertexCount;
+
+    SoftwareShaderData constants;
+};
+
+struct SoftwareRasterizerStats
+{
+    uint64_t triangles;             // Triangles set up.
+    uint64_t culledTriangles;       // Back facing, degenerate, off the target or out of the guard band.
+    uint64_t binnedTriangles;       // Triangle and tile pairs.
+    uint64_t tiles;                 // Tile jobs run.
+    uint64_t pixels;                // Pixels shaded.
+};
+
+// Tile-binned rasterizer running the pipelines of the sample on the CPU, so
+// frames can be rendered and checked against golden images without a GPU.
+//
+// Draws follow the D3D12 rules: clockwise triangles are front facing and
+// back faces are culled, vertices snap to 1/256 of a pixel, pixels are
+// sampled at their centers with the top-left fill rule, and there is no
+// blending. Positions have a w of 1, so attributes interpolate linearly.
+//
+// A draw first runs the vertex stage and sets up every triangle, then bins
+// the triangles into square tiles of the target and rasterizes the tiles as
+// jobs: a tile is owned by one job, which draws its triangles in order.
+class SoftwareRasterizer
+{
+public:
+    static const uint32_t DefaultTileSize = 64;
+
+    // Without a job system everything runs on the calling thread.
+    explicit SoftwareRasterizer(JobSystem* jobs, uint32_t tileSize = DefaultTileSize);
+
+    // shaders.hlsl: vertexCount vertices of a triangle list drawn for each
+    // instance, rotated, scaled and moved by it, colored with its color times
+    // solidColor and blended with the texture by textureWeight.x.
+    void DrawTriangles(SoftwareImage& target, const SoftwareViewport& viewport, const SoftwareRect& scissor,
+        const SoftwareVertex* vertices, uint32_t vertexCount, const InstanceData* instances, uint32_t instanceCount,
+        const SoftwareShaderData& constants, const SoftwareTexture* texture);
+
+    // quad_shaders.hlsl: a triangle list sampling source at its uv scaled by
+    // sceneUv.xy and clamped to sceneUv.zw.
+    void DrawQuad(SoftwareImage& target, const SoftwareViewport& viewport, const SoftwareRect& scissor,
+        const SoftwareTextureVertex* vertices, uint32_t vertexCount, const SoftwareShaderData& constants, const SoftwareImage& source);
+
+    // The passes of PopulateCommandList: clear the scaled scene and draw the
+    // triangles into it, blur it, then clear output and draw the quad over
+    // it. scene and display are the intermediate targets, display is only
+    // used with a blur.
+    void RenderFrame(const SoftwareFrameDesc& desc, SoftwareImage& scene, SoftwareImage& display, SoftwareImage& output);
+
+    const SoftwareRasterizerStats& GetStats() const { return m_stats; }
+    void ResetStats()                               { m_stats = SoftwareRasterizerStats(); }
+
+private:
+    enum Shader
+    {
+        ShaderFlat,                 // shaders.hlsl without a texture contribution.
+        ShaderTextured,             // shaders.hlsl.
+        ShaderQuad                  // quad_shaders.hlsl.
+    };
+
+    // A triangle after setup, edges and uv in the space of the target.
+    struct Triangle
+    {
+        int64_t edgeA[3];           // Edge function steps per pixel in x and y, in 1/256 pixel units.
+        int64_t edgeB[3];
+        int64_t edgeC[3];           // Edge functions at pixel (0, 0), top-left bias included.
+        int32_t minX;               // Bounds in pixels, clipped to the scissor, max exclusive.
+        int32_t minY;
+        int32_t maxX;
+        int32_t maxY;
+        float u[3];                 // Plane of u: value at pixel (0, 0), step in x, step in y.
+        float v[3];
+        float lod;
+        uint32_t color;             // Flat triangles.
+        float colorValue[4];        // Textured triangles.
+    };
+
+    struct ScreenVertex
+    {
+        float x;
+        float y;
+        float u;
+        float v;
+    };
+
+    // ParallelFor, or a loop without a job system.
+    void RunJobs(uint32_t count, const JobSystem::Job& job);
+
+    bool SetupTriangle(const ScreenVertex* vertices, const SoftwareRect& bounds, Triangle& triangle);
+    void Rasterize(SoftwareImage& target, Shader shader, const SoftwareShaderData& constants,
+        const SoftwareTexture* texture, const SoftwareImage* source);
+    void RasterizeTile(SoftwareImage& target, uint32_t tile, Shader shader, const SoftwareShaderData& constants,
+        const SoftwareTexture* texture, const SoftwareImage* source, uint64_t& pixels);
+
+    JobSystem* m_jobs;
+    uint32_t m_tileSize;
+    uint32_t m_tilesX;
+    uint32_t m_tilesY;
+
+    // Per draw, kept to reuse their storage.
+    std::vector<ScreenVertex> m_vertices;
+    std::vector<Triangle> m_triangles;
+    std::vector<uint8_t> m_setupResults;
+    std::vector<std::vector<uint32_t>> m_bins;
+    std::vector<uint32_t> m_activeTiles;
+    std::vector<uint64_t> m_tilePixels;
+
+    SoftwareRasterizerStats m_stats;
+};
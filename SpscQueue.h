@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Bounded lock-free queue between exactly one producer thread and one
+// consumer thread. Each side only writes its own index: the producer
+// publishes an element with a release store of the tail, the consumer frees
+// its slot with a release store of the head. The indices sit on separate
+// cache lines so the two threads do not share one.
+template<typename T>
+class SpscQueue
+{
+public:
+    // The capacity is rounded up to a power of two.
+    explicit SpscQueue(size_t capacity) :
+        m_head(0),
+        m_tail(0)
+    {
+        if (capacity == 0)
+        {
+            throw std::invalid_argument("SpscQueue");
+        }
+
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_elements.resize(size);
+        m_mask = size - 1;
+    }
+
+    // Producer thread. False when the queue is full.
+    bool TryPush(const T& element)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) > m_mask)
+        {
+            return false;
+        }
+
+        m_elements[tail & m_mask] = element;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread. False when the queue is empty.
+    bool TryPop(T& element)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        element = m_elements[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Either thread, only exact while the other one is idle.
+    size_t GetSize() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    size_t GetCapacity() const { return m_elements.size(); }
+
+private:
+    static const size_t CacheLineSize = 64;
+
+    std::vector<T>          m_elements;
+    size_t                  m_mask;
+    char                    m_padding0[CacheLineSize];
+    std::atomic<size_t>     m_head;         // Written by the consumer.
+    char                    m_padding1[CacheLineSize - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t>     m_tail;         // Written by the producer.
+    char                    m_padding2[CacheLineSize - sizeof(std::atomic<size_t>)];
+};
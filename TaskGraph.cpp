@@ -0,0 +1,208 @@
+#include "TaskGraph.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    double ToMilliseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+TaskGraph::TaskGraph() :
+    m_stats(),
+    m_done(0)
+{
+}
+
+uint32_t TaskGraph::AddTask(const std::string& name, const Task& task, const std::vector<uint32_t>& dependencies)
+{
+    const uint32_t index = static_cast<uint32_t>(m_tasks.size());
+    for (uint32_t dependency : dependencies)
+    {
+        if (dependency >= index)
+        {
+            throw std::invalid_argument("TaskGraph: dependency on a task added later");
+        }
+    }
+
+    for (uint32_t dependency : dependencies)
+    {
+        m_tasks[dependency].dependents.push_back(index);
+    }
+
+    Node node = {};
+    node.name = name;
+    node.task = task;
+    node.dependencies = dependencies;
+    m_tasks.push_back(node);
+    return index;
+}
+
+void TaskGraph::Run(JobSystem& jobs)
+{
+    // Dependents come after their dependencies, one backwards pass gives the
+    // length of the chains.
+    m_ready.clear();
+    for (size_t i = m_tasks.size(); i-- > 0; )
+    {
+        Node& node = m_tasks[i];
+        node.height = 1;
+        for (uint32_t dependent : node.dependents)
+        {
+            node.height = std::max<uint32_t>(node.height, m_tasks[dependent].height + 1);
+        }
+
+        node.waitingOn = static_cast<uint32_t>(node.dependencies.size());
+        node.startMs = 0.0;
+        node.endMs = 0.0;
+        if (!node.waitingOn)
+        {
+            m_ready.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    // Ties go to the task added first.
+    std::reverse(m_ready.begin(), m_ready.end());
+
+    m_done = 0;
+    m_error = nullptr;
+    m_start = Clock::now();
+
+    // Every thread of the pool takes tasks until the graph is done.
+    jobs.ParallelFor(jobs.GetThreadCount(), [this](uint32_t /*index*/, uint32_t /*thread*/)
+    {
+        RunTasks();
+    });
+
+    if (m_error)
+    {
+        std::rethrow_exception(m_error);
+    }
+
+    m_stats.threadCount = jobs.GetThreadCount();
+    Analyze();
+}
+
+void TaskGraph::RunTasks()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;)
+    {
+        m_wake.wait(lock, [this] { return !m_ready.empty() || m_done == m_tasks.size() || m_error; });
+        if (m_ready.empty())
+        {
+            return;
+        }
+
+        // The head of the longest chain first, its dependents are the most
+        // likely to hold the run up.
+        std::vector<uint32_t>::iterator next = std::max_element(m_ready.begin(), m_ready.end(),
+            [this](uint32_t a, uint32_t b) { return m_tasks[a].height < m_tasks[b].height; });
+        Node& node = m_tasks[*next];
+        m_ready.erase(next);
+        lock.unlock();
+
+        const Clock::time_point start = Clock::now();
+        try
+        {
+            node.task();
+        }
+        catch (...)
+        {
+            // The tasks already running finish, no other starts.
+            lock.lock();
+            if (!m_error)
+            {
+                m_error = std::current_exception();
+            }
+            m_ready.clear();
+            m_wake.notify_all();
+            return;
+        }
+        const Clock::time_point end = Clock::now();
+
+        lock.lock();
+        node.startMs = ToMilliseconds(start - m_start);
+        node.endMs = ToMilliseconds(end - m_start);
+        m_done++;
+
+        if (m_error)
+        {
+            continue;
+        }
+
+        for (uint32_t dependent : node.dependents)
+        {
+            if (--m_tasks[dependent].waitingOn == 0)
+            {
+                m_ready.push_back(dependent);
+            }
+        }
+        m_wake.notify_all();
+    }
+}
+
+void TaskGraph::Analyze()
+{
+    m_stats.taskCount = static_cast<uint32_t>(m_tasks.size());
+    m_stats.wallMs = 0.0;
+    m_stats.totalTaskMs = 0.0;
+    m_stats.criticalPathMs = 0.0;
+    m_criticalPath.clear();
+
+    // Longest chain of measured times ending at each task, dependencies first.
+    std::vector<double> chainMs(m_tasks.size(), 0.0);
+    std::vector<uint32_t> previous(m_tasks.size(), ~0u);
+    double firstStart = m_tasks.empty() ? 0.0 : m_tasks[0].startMs;
+    uint32_t last = ~0u;
+    for (uint32_t i = 0; i < m_tasks.size(); ++i)
+    {
+        const Node& node = m_tasks[i];
+        for (uint32_t dependency : node.dependencies)
+        {
+            if (chainMs[dependency] > chainMs[i])
+            {
+                chainMs[i] = chainMs[dependency];
+                previous[i] = dependency;
+            }
+        }
+
+        const double taskMs = node.endMs - node.startMs;
+        chainMs[i] += taskMs;
+        m_stats.totalTaskMs += taskMs;
+        firstStart = std::min<double>(firstStart, node.startMs);
+        m_stats.wallMs = std::max<double>(m_stats.wallMs, node.endMs);
+
+        if (last == ~0u || chainMs[i] > chainMs[last])
+        {
+            last = i;
+        }
+    }
+    m_stats.wallMs -= firstStart;
+
+    for (uint32_t task = last; task != ~0u; task = previous[task])
+    {
+        m_criticalPath.push_back(task);
+    }
+    std::reverse(m_criticalPath.begin(), m_criticalPath.end());
+    m_stats.criticalPathMs = last == ~0u ? 0.0 : chainMs[last];
+}
+
+std::string TaskGraph::FormatCriticalPath() const
+{
+    std::string path;
+    for (uint32_t task : m_criticalPath)
+    {
+        char time[32] = {};
+        snprintf(time, sizeof(time), " %.1f ms", GetTaskMs(task));
+        path += path.empty() ? "" : " > ";
+        path += m_tasks[task].name + time;
+    }
+    return path;
+}
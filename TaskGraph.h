@@ -0,0 +1,78 @@
+#pragma once
+
+#include "JobSystem.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct TaskGraphStats
+{
+    uint32_t taskCount;
+    uint32_t threadCount;
+    double   wallMs;            // First task started to last task done.
+    double   totalTaskMs;       // Sum of the task times, what one thread takes.
+    double   criticalPathMs;    // Longest chain of dependent tasks, what any number of threads takes at best.
+};
+
+// Graph of tasks with dependencies, run on a JobSystem. A task starts
+// as soon as the tasks it depends on are done, on whichever thread is free;
+// among the ready tasks the one heading the longest chain of dependents goes
+// first. Every task is timed, and the chain of dependent tasks that bounded
+// the run is reported as the critical path.
+class TaskGraph
+{
+public:
+    typedef std::function<void()> Task;
+
+    TaskGraph();
+
+    // A task can only depend on tasks added before it, so the graph has no
+    // cycles.
+    uint32_t AddTask(const std::string& name, const Task& task, const std::vector<uint32_t>& dependencies = std::vector<uint32_t>());
+
+    // Run every task once. The first exception a task throws is rethrown
+    // here, the tasks depending on it do not run. Tasks must not use jobs.
+    void Run(JobSystem& jobs);
+
+    const TaskGraphStats& GetStats() const                  { return m_stats; }
+    const std::vector<uint32_t>& GetCriticalPath() const    { return m_criticalPath; }
+    const std::string& GetTaskName(uint32_t task) const     { return m_tasks.at(task).name; }
+    double GetTaskMs(uint32_t task) const                   { return m_tasks.at(task).endMs - m_tasks.at(task).startMs; }
+
+    // "name 12.3 ms > name 4.5 ms", first task of the path first.
+    std::string FormatCriticalPath() const;
+
+private:
+    struct Node
+    {
+        std::string name;
+        Task task;
+        std::vector<uint32_t> dependencies;
+        std::vector<uint32_t> dependents;
+        uint32_t height;            // Tasks on the longest chain starting here.
+        uint32_t waitingOn;
+        double startMs;
+        double endMs;
+    };
+
+    void RunTasks();
+    void Analyze();
+
+    std::vector<Node> m_tasks;
+    TaskGraphStats m_stats;
+    std::vector<uint32_t> m_criticalPath;
+
+    // Scheduling state of a run.
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<uint32_t> m_ready;
+    uint32_t m_done;
+    std::exception_ptr m_error;
+    std::chrono::steady_clock::time_point m_start;
+};
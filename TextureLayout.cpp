@@ -0,0 +1,100 @@
+#include "TextureLayout.h"
+
+namespace
+{
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+bool GetFormatBlockInfo(uint32_t format, uint32_t* blockSize, uint32_t* bytesPerBlock)
+{
+    uint32_t size = 1;
+    uint32_t bytes = 0;
+
+    switch (format)
+    {
+    case 1: case 2: case 3: case 4:                 // R32G32B32A32
+        bytes = 16;
+        break;
+    case 5: case 6: case 7: case 8:                 // R32G32B32
+        bytes = 12;
+        break;
+    case 9: case 10: case 11: case 12: case 13: case 14: // R16G16B16A16
+    case 15: case 16: case 17: case 18:             // R32G32
+    case 19: case 20: case 21: case 22:             // R32G8X24 and its depth views
+        bytes = 8;
+        break;
+    case 23: case 24: case 25: case 26:             // R10G10B10A2, R11G11B10
+    case 27: case 28: case 29: case 30: case 31: case 32: // R8G8B8A8
+    case 33: case 34: case 35: case 36: case 37: case 38: // R16G16
+    case 39: case 40: case 41: case 42: case 43:    // R32, D32
+    case 44: case 45: case 46: case 47:             // R24G8 and its depth views
+    case 67:                                        // R9G9B9E5
+    case 87: case 88: case 89: case 90: case 91: case 92: case 93: // B8G8R8A8, B8G8R8X8
+        bytes = 4;
+        break;
+    case 48: case 49: case 50: case 51: case 52:    // R8G8
+    case 53: case 54: case 55: case 56: case 57: case 58: case 59: // R16, D16
+    case 85: case 86: case 115:                     // B5G6R5, B5G5R5A1, B4G4R4A4
+        bytes = 2;
+        break;
+    case 60: case 61: case 62: case 63: case 64: case 65: // R8, A8
+        bytes = 1;
+        break;
+    case 70: case 71: case 72:                      // BC1
+    case 79: case 80: case 81:                      // BC4
+        size = 4;
+        bytes = 8;
+        break;
+    case 73: case 74: case 75:                      // BC2
+    case 76: case 77: case 78:                      // BC3
+    case 82: case 83: case 84:                      // BC5
+    case 94: case 95: case 96:                      // BC6H
+    case 97: case 98: case 99:                      // BC7
+        size = 4;
+        bytes = 16;
+        break;
+    default:
+        return false;
+    }
+
+    *blockSize = size;
+    *bytesPerBlock = bytes;
+    return true;
+}
+
+uint64_t GetCopyableFootprints(const TextureDesc& desc, uint32_t firstSubresource, uint32_t count, uint64_t baseOffset, TextureFootprint* footprints)
+{
+    uint32_t blockSize = 0;
+    uint32_t bytesPerBlock = 0;
+    if (desc.mipCount == 0 || !GetFormatBlockInfo(desc.format, &blockSize, &bytesPerBlock))
+    {
+        return 0;
+    }
+
+    uint64_t offset = baseOffset;
+    uint64_t end = baseOffset;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t mip = (firstSubresource + i) % desc.mipCount;
+        const uint32_t blocksWide = (GetMipSize(desc.width, mip) + blockSize - 1) / blockSize;
+        const uint32_t blocksHigh = (GetMipSize(desc.height, mip) + blockSize - 1) / blockSize;
+
+        TextureFootprint& footprint = footprints[i];
+        footprint.offset = AlignUp(offset, TexturePlacementAlignment);
+        footprint.format = desc.format;
+        footprint.width = blocksWide * blockSize;
+        footprint.height = blocksHigh * blockSize;
+        footprint.depth = desc.dimension == TextureDimension3D ? GetMipSize(desc.depth, mip) : 1;
+        footprint.rowSize = static_cast<uint64_t>(blocksWide) * bytesPerBlock;
+        footprint.rowPitch = static_cast<uint32_t>(AlignUp(footprint.rowSize, TexturePitchAlignment));
+        footprint.rowCount = blocksHigh;
+
+        end = footprint.offset + static_cast<uint64_t>(footprint.rowPitch) * (static_cast<uint64_t>(footprint.rowCount) * footprint.depth - 1) + footprint.rowSize;
+        offset = end;
+    }
+
+    return end - baseOffset;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+
+// Row pitch and placement alignments of texture data in buffers, the values
+// of D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT.
+static const uint32_t TexturePitchAlignment = 256;
+static const uint32_t TexturePlacementAlignment = 512;
+
+// Values of D3D12_RESOURCE_DIMENSION.
+enum TextureDimension
+{
+    TextureDimension1D = 2,
+    TextureDimension2D = 3,
+    TextureDimension3D = 4
+};
+
+struct TextureDesc
+{
+    TextureDimension dimension;
+    uint32_t format;                // DXGI_FORMAT.
+    uint32_t width;
+    uint32_t height;
+    uint32_t depth;
+    uint32_t mipCount;
+    uint32_t arraySize;             // Six per cube, the faces of a cube are consecutive slices.
+    bool     cube;
+};
+
+// Layout of one subresource in a buffer, the D3D12_PLACED_SUBRESOURCE_FOOTPRINT,
+// row count and row size ID3D12Device::GetCopyableFootprints returns for it.
+struct TextureFootprint
+{
+    uint64_t offset;
+    uint32_t format;
+    uint32_t width;                 // Rounded up to whole blocks, like height.
+    uint32_t height;
+    uint32_t depth;
+    uint32_t rowPitch;              // Multiple of TexturePitchAlignment.
+    uint32_t rowCount;              // Rows of blocks per depth slice.
+    uint64_t rowSize;               // Bytes of data per row, the rest of the pitch is padding.
+};
+
+// Blocks are blockSize x blockSize pixels: 4 for the block compressed formats,
+// 1 for the others. Returns false for the formats without a fixed size per
+// block (planar, video and packed 4:2:2 formats) and unknown values.
+bool GetFormatBlockInfo(uint32_t format, uint32_t* blockSize, uint32_t* bytesPerBlock);
+
+// Size of mip of a dimension of size, never below 1.
+inline uint32_t GetMipSize(uint32_t size, uint32_t mip)
+{
+    return mip < 32 && (size >> mip) > 0 ? size >> mip : 1;
+}
+
+// Subresource index of a mip of an array slice, D3D12CalcSubresource.
+inline uint32_t GetSubresourceIndex(const TextureDesc& desc, uint32_t mip, uint32_t slice)
+{
+    return mip + slice * desc.mipCount;
+}
+
+// Fills the footprints of count subresources from firstSubresource, placed one
+// after the other from baseOffset, and returns the size they take, like
+// GetCopyableFootprints: every subresource starts at a multiple of
+// TexturePlacementAlignment and the last row of a subresource is not padded.
+// Returns 0 when the format has no block layout.
+uint64_t GetCopyableFootprints(const TextureDesc& desc, uint32_t firstSubresource, uint32_t count, uint64_t baseOffset, TextureFootprint* footprints);
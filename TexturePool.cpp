@@ -0,0 +1,353 @@
+#include "TexturePool.h"
+#include "Hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+
+namespace
+{
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+bool TexturePoolKey::operator==(const TexturePoolKey& other) const
+{
+    return width == other.width && height == other.height && format == other.format && flags == other.flags
+        && memcmp(clearColor, other.clearColor, sizeof(clearColor)) == 0;
+}
+
+TexturePool::TexturePool(ITexturePoolBackend& backend, uint64_t heapSize) :
+    m_backend(backend),
+    m_heapSize(heapSize),
+    m_stats()
+{
+    if (heapSize == 0)
+    {
+        throw std::invalid_argument("TexturePool");
+    }
+}
+
+TexturePool::~TexturePool()
+{
+    for (uint32_t texture = 0; texture < m_textures.size(); ++texture)
+    {
+        if (m_textures[texture].state != TextureDestroyed)
+        {
+            m_backend.DestroyTexture(texture);
+        }
+    }
+    for (uint32_t heap = 0; heap < m_heaps.size(); ++heap)
+    {
+        if (m_heaps[heap].size)
+        {
+            m_backend.DestroyHeap(heap);
+        }
+    }
+}
+
+uint64_t TexturePool::HashKey(const TexturePoolKey& key)
+{
+    // The key has no padding, its bytes can be hashed as they are.
+    Hasher64 hasher;
+    hasher.UpdateValue(key);
+    return hasher.Final();
+}
+
+uint32_t TexturePool::Acquire(const TexturePoolKey& key)
+{
+    m_stats.acquires++;
+    const uint64_t hash = HashKey(key);
+
+    auto bucket = m_cachedByHash.find(hash);
+    if (bucket != m_cachedByHash.end())
+    {
+        // Most recently released first, it is the likeliest to still be in caches.
+        std::vector<uint32_t>& cached = bucket->second;
+        for (size_t i = cached.size(); i-- > 0;)
+        {
+            const uint32_t texture = cached[i];
+            Texture& entry = m_textures[texture];
+            if (!(entry.key == key))
+            {
+                continue;
+            }
+
+            cached.erase(cached.begin() + i);
+            if (cached.empty())
+            {
+                m_cachedByHash.erase(bucket);
+            }
+            m_cachedOrder.erase(entry.cachedPosition);
+            entry.state = TextureLive;
+
+            m_stats.reuseHits++;
+            m_stats.cachedBytes -= entry.size;
+            m_stats.liveBytes += entry.size;
+            m_stats.peakLiveBytes = std::max<uint64_t>(m_stats.peakLiveBytes, m_stats.liveBytes);
+            return texture;
+        }
+    }
+
+    const TexturePoolAllocationInfo info = m_backend.GetAllocationInfo(key);
+
+    // Make room by destroying the least recently released textures, and only
+    // grow when the cache is empty.
+    uint32_t heap = 0;
+    uint64_t offset = 0;
+    while (!AllocateBlock(info.size, info.alignment, heap, offset))
+    {
+        if (m_cachedOrder.empty())
+        {
+            heap = CreateHeap(std::max<uint64_t>(m_heapSize, AlignUp(info.size, info.alignment)));
+            if (!AllocateBlock(info.size, info.alignment, heap, offset))
+            {
+                throw std::logic_error("TexturePool: new heap too small");
+            }
+            break;
+        }
+
+        m_stats.evictions++;
+        DestroyTexture(m_cachedOrder.front());
+    }
+
+    uint32_t texture = static_cast<uint32_t>(m_textures.size());
+    if (!m_freeTextureIds.empty())
+    {
+        texture = m_freeTextureIds.back();
+        m_freeTextureIds.pop_back();
+    }
+    else
+    {
+        m_textures.push_back(Texture());
+    }
+
+    Texture& entry = m_textures[texture];
+    entry.key = key;
+    entry.hash = hash;
+    entry.heap = heap;
+    entry.offset = offset;
+    entry.size = info.size;
+    entry.fenceValue = 0;
+    entry.state = TextureLive;
+    entry.cachedPosition = m_cachedOrder.end();
+
+    m_backend.CreateTexture(texture, key, heap, offset);
+
+    m_stats.creations++;
+    m_stats.liveBytes += info.size;
+    m_stats.peakLiveBytes = std::max<uint64_t>(m_stats.peakLiveBytes, m_stats.liveBytes);
+    return texture;
+}
+
+void TexturePool::Release(uint32_t texture, uint64_t fenceValue)
+{
+    Texture& entry = m_textures.at(texture);
+    if (entry.state != TextureLive)
+    {
+        throw std::logic_error("TexturePool::Release of a texture that is not acquired");
+    }
+
+    entry.state = TexturePending;
+    entry.fenceValue = fenceValue;
+    m_pending.push_back(texture);
+}
+
+void TexturePool::ReleaseCompleted(uint64_t completedFenceValue)
+{
+    // Released textures are rarely more than a few frames worth, a linear
+    // pass keeps them in release order.
+    size_t kept = 0;
+    for (uint32_t texture : m_pending)
+    {
+        Texture& entry = m_textures[texture];
+        if (entry.fenceValue > completedFenceValue)
+        {
+            m_pending[kept++] = texture;
+            continue;
+        }
+
+        entry.state = TextureCached;
+        entry.cachedPosition = m_cachedOrder.insert(m_cachedOrder.end(), texture);
+        m_cachedByHash[entry.hash].push_back(texture);
+
+        m_stats.liveBytes -= entry.size;
+        m_stats.cachedBytes += entry.size;
+    }
+    m_pending.resize(kept);
+}
+
+void TexturePool::Trim()
+{
+    while (!m_cachedOrder.empty())
+    {
+        DestroyTexture(m_cachedOrder.front());
+    }
+
+    for (uint32_t heap = 0; heap < m_heaps.size(); ++heap)
+    {
+        Heap& entry = m_heaps[heap];
+        if (entry.size && entry.used == 0)
+        {
+            m_backend.DestroyHeap(heap);
+            m_stats.heapCount--;
+            m_stats.heapBytes -= entry.size;
+            entry.size = 0;
+            entry.freeBlocks.clear();
+        }
+    }
+}
+
+double TexturePool::GetFragmentation() const
+{
+    uint64_t freeBytes = 0;
+    uint64_t largest = 0;
+    for (const Heap& heap : m_heaps)
+    {
+        for (const auto& block : heap.freeBlocks)
+        {
+            freeBytes += block.second;
+            largest = std::max<uint64_t>(largest, block.second);
+        }
+    }
+    return freeBytes ? 1.0 - static_cast<double>(largest) / freeBytes : 0.0;
+}
+
+bool TexturePool::AllocateBlock(uint64_t size, uint64_t alignment, uint32_t& heap, uint64_t& offset)
+{
+    // Best fit over every heap, the smallest block that still fits once aligned.
+    uint64_t bestWaste = UINT64_MAX;
+    for (uint32_t h = 0; h < m_heaps.size(); ++h)
+    {
+        for (const auto& block : m_heaps[h].freeBlocks)
+        {
+            const uint64_t aligned = AlignUp(block.first, alignment);
+            if (aligned + size > block.first + block.second)
+            {
+                continue;
+            }
+
+            const uint64_t waste = block.second - size;
+            if (waste < bestWaste)
+            {
+                bestWaste = waste;
+                heap = h;
+                offset = aligned;
+            }
+        }
+    }
+
+    if (bestWaste == UINT64_MAX)
+    {
+        return false;
+    }
+
+    // Split the block around the allocation, the alignment padding in front
+    // stays free.
+    Heap& entry = m_heaps[heap];
+    auto block = entry.freeBlocks.upper_bound(offset);
+    --block;
+    const uint64_t blockOffset = block->first;
+    const uint64_t blockEnd = block->first + block->second;
+    entry.freeBlocks.erase(block);
+
+    if (offset > blockOffset)
+    {
+        entry.freeBlocks[blockOffset] = offset - blockOffset;
+    }
+    if (offset + size < blockEnd)
+    {
+        entry.freeBlocks[offset + size] = blockEnd - offset - size;
+    }
+
+    entry.used += size;
+    return true;
+}
+
+void TexturePool::FreeBlock(uint32_t heap, uint64_t offset, uint64_t size)
+{
+    Heap& entry = m_heaps[heap];
+    entry.used -= size;
+
+    // Merge with the neighbouring free blocks.
+    auto next = entry.freeBlocks.lower_bound(offset);
+    if (next != entry.freeBlocks.end() && next->first == offset + size)
+    {
+        size += next->second;
+        next = entry.freeBlocks.erase(next);
+    }
+    if (next != entry.freeBlocks.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            previous->second += size;
+            return;
+        }
+    }
+    entry.freeBlocks[offset] = size;
+}
+
+uint32_t TexturePool::CreateHeap(uint64_t size)
+{
+    uint32_t heap = static_cast<uint32_t>(m_heaps.size());
+    for (uint32_t h = 0; h < m_heaps.size(); ++h)
+    {
+        if (m_heaps[h].size == 0)
+        {
+            heap = h;
+            break;
+        }
+    }
+    if (heap == m_heaps.size())
+    {
+        m_heaps.push_back(Heap());
+    }
+
+    Heap& entry = m_heaps[heap];
+    entry.size = size;
+    entry.used = 0;
+    entry.freeBlocks.clear();
+    entry.freeBlocks[0] = size;
+
+    m_backend.CreateHeap(heap, size);
+
+    m_stats.heapCount++;
+    m_stats.heapBytes += size;
+    m_stats.peakHeapBytes = std::max<uint64_t>(m_stats.peakHeapBytes, m_stats.heapBytes);
+    return heap;
+}
+
+void TexturePool::DestroyTexture(uint32_t texture)
+{
+    Texture& entry = m_textures[texture];
+    if (entry.state != TextureCached)
+    {
+        throw std::logic_error("TexturePool: only cached textures are destroyed");
+    }
+
+    m_cachedOrder.erase(entry.cachedPosition);
+    std::vector<uint32_t>& cached = m_cachedByHash[entry.hash];
+    cached.erase(std::find(cached.begin(), cached.end(), texture));
+    if (cached.empty())
+    {
+        m_cachedByHash.erase(entry.hash);
+    }
+
+    m_backend.DestroyTexture(texture);
+    FreeBlock(entry.heap, entry.offset, entry.size);
+
+    m_stats.cachedBytes -= entry.size;
+    entry.state = TextureDestroyed;
+    m_freeTextureIds.push_back(texture);
+}
+
+TexturePoolAllocationInfo NullTexturePoolBackend::GetAllocationInfo(const TexturePoolKey& key)
+{
+    const uint64_t alignment = 64 * 1024;
+    TexturePoolAllocationInfo info = { AlignUp(static_cast<uint64_t>(key.width) * key.height * m_bytesPerPixel, alignment), alignment };
+    return info;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+// Everything two textures must share to be interchangeable.
+struct TexturePoolKey
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;                // DXGI_FORMAT
+    uint32_t flags;                 // D3D12_RESOURCE_FLAGS
+    float    clearColor[4];
+
+    bool operator==(const TexturePoolKey& other) const;
+};
+
+struct TexturePoolAllocationInfo
+{
+    uint64_t size;
+    uint64_t alignment;
+};
+
+struct TexturePoolStats
+{
+    uint64_t acquires;
+    uint64_t reuseHits;             // Acquires served by a released texture.
+    uint64_t creations;
+    uint64_t evictions;             // Released textures destroyed to make room.
+    uint32_t heapCount;
+    uint64_t heapBytes;
+    uint64_t peakHeapBytes;
+    uint64_t liveBytes;             // Acquired, or released but not yet completed.
+    uint64_t peakLiveBytes;
+    uint64_t cachedBytes;           // Released, completed and kept for reuse.
+};
+
+// Heaps and placed textures of a TexturePool. Heaps and textures are
+// identified by small indices the pool picks.
+class ITexturePoolBackend
+{
+public:
+    virtual ~ITexturePoolBackend() {}
+
+    virtual TexturePoolAllocationInfo GetAllocationInfo(const TexturePoolKey& key) = 0;
+
+    virtual void CreateHeap(uint32_t heap, uint64_t size) = 0;
+    virtual void DestroyHeap(uint32_t heap) = 0;
+
+    virtual void CreateTexture(uint32_t texture, const TexturePoolKey& key, uint32_t heap, uint64_t offset) = 0;
+    virtual void DestroyTexture(uint32_t texture) = 0;
+};
+
+// Render targets placed in large heaps and recycled by key. A released
+// texture stays alive until the fence of its last use has completed, then
+// waits in a cache for the next Acquire of the same key. When the heaps are
+// full the least recently released textures are destroyed first, a new heap
+// is only created when that is not enough.
+class TexturePool
+{
+public:
+    static const uint32_t InvalidTexture = ~0u;
+
+    // Heaps are at least heapSize bytes, larger for textures that need it.
+    TexturePool(ITexturePoolBackend& backend, uint64_t heapSize = 64 * 1024 * 1024);
+    ~TexturePool();
+
+    uint32_t Acquire(const TexturePoolKey& key);
+    void Release(uint32_t texture, uint64_t fenceValue);
+
+    // Move the textures released at or before completedFenceValue to the cache.
+    void ReleaseCompleted(uint64_t completedFenceValue);
+
+    // Destroy every cached texture and the heaps left empty.
+    void Trim();
+
+    // 1 - largest free block / free bytes, over all heaps. 0 without free space.
+    double GetFragmentation() const;
+
+    TexturePoolStats GetStats() const       { return m_stats; }
+
+private:
+    enum TextureState
+    {
+        TextureDestroyed,
+        TextureLive,
+        TexturePending,         // Released, fence not reached.
+        TextureCached,
+    };
+
+    struct Texture
+    {
+        TexturePoolKey  key;
+        uint64_t        hash;
+        uint32_t        heap;
+        uint64_t        offset;
+        uint64_t        size;
+        uint64_t        fenceValue;
+        TextureState    state;
+        std::list<uint32_t>::iterator cachedPosition;
+    };
+
+    struct Heap
+    {
+        uint64_t size;
+        uint64_t used;
+        std::map<uint64_t, uint64_t> freeBlocks;        // Offset to size, coalesced.
+    };
+
+    static uint64_t HashKey(const TexturePoolKey& key);
+
+    bool AllocateBlock(uint64_t size, uint64_t alignment, uint32_t& heap, uint64_t& offset);
+    void FreeBlock(uint32_t heap, uint64_t offset, uint64_t size);
+    uint32_t CreateHeap(uint64_t size);
+    void DestroyTexture(uint32_t texture);
+
+    ITexturePoolBackend& m_backend;
+    uint64_t m_heapSize;
+    std::vector<Heap> m_heaps;                          // Size 0 once destroyed.
+    std::vector<Texture> m_textures;
+    std::vector<uint32_t> m_freeTextureIds;
+    std::vector<uint32_t> m_pending;
+    std::list<uint32_t> m_cachedOrder;                  // Least recently released first.
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cachedByHash;
+    TexturePoolStats m_stats;
+};
+
+// GPU-less backend, textures take width * height * bytesPerPixel rounded up
+// to the 64KB placement alignment of D3D12.
+class NullTexturePoolBackend : public ITexturePoolBackend
+{
+public:
+    explicit NullTexturePoolBackend(uint32_t bytesPerPixel = 4) : m_bytesPerPixel(bytesPerPixel) {}
+
+    virtual TexturePoolAllocationInfo GetAllocationInfo(const TexturePoolKey& key);
+    virtual void CreateHeap(uint32_t /*heap*/, uint64_t /*size*/) {}
+    virtual void DestroyHeap(uint32_t /*heap*/) {}
+    virtual void CreateTexture(uint32_t /*texture*/, const TexturePoolKey& /*key*/, uint32_t /*heap*/, uint64_t /*offset*/) {}
+    virtual void DestroyTexture(uint32_t /*texture*/) {}
+
+private:
+    uint32_t m_bytesPerPixel;
+};
@@ -0,0 +1,72 @@
+#include "TextureStreamer.h"
+
+TextureStreamer::TextureStreamer(BufferUploader& uploader, const DdsTexture& texture, void* destination) :
+    m_uploader(uploader),
+    m_texture(texture),
+    m_destination(destination),
+    m_nextMip(texture.GetDesc().mipCount),
+    m_residentMip(texture.GetDesc().mipCount),
+    m_stats()
+{
+}
+
+void TextureStreamer::Update(uint64_t byteBudget)
+{
+    if (m_nextMip == 0)
+    {
+        return;
+    }
+    m_stats.updates++;
+
+    const TextureDesc& desc = m_texture.GetDesc();
+    uint64_t spent = 0;
+    const uint32_t firstMip = m_nextMip;
+    while (m_nextMip > 0)
+    {
+        const uint32_t mip = m_nextMip - 1;
+        const uint64_t mipBytes = m_texture.GetMipBytes(mip);
+        if (m_nextMip != firstMip && spent + mipBytes > byteBudget)
+        {
+            break;
+        }
+
+        for (uint32_t slice = 0; slice < desc.arraySize; ++slice)
+        {
+            const uint32_t subresource = GetSubresourceIndex(desc, mip, slice);
+            const DdsSubresource& source = m_texture.GetSubresource(subresource);
+
+            TextureFootprint footprint;
+            GetCopyableFootprints(desc, subresource, 1, 0, &footprint);
+            m_uploader.UploadTexture(m_destination, subresource, footprint, m_texture.GetSubresourceData(subresource),
+                source.rowSize, static_cast<uint64_t>(source.rowSize) * source.rowCount);
+        }
+
+        spent += mipBytes;
+        m_nextMip--;
+        m_stats.mipsUploaded++;
+    }
+
+    // Large mips may have been flushed in several batches, the last fence covers them all.
+    const uint64_t fenceValue = m_uploader.Flush();
+    for (uint32_t mip = firstMip; mip > m_nextMip; --mip)
+    {
+        PendingMip pending = { mip - 1, fenceValue };
+        m_pending.push_back(pending);
+    }
+    m_stats.bytes += spent;
+}
+
+uint32_t TextureStreamer::GetResidentMip()
+{
+    while (!m_pending.empty() && m_uploader.IsComplete(m_pending.front().fenceValue))
+    {
+        m_residentMip = m_pending.front().mip;
+        m_pending.pop_front();
+
+        if (m_stats.firstResidentUpdate == 0)
+        {
+            m_stats.firstResidentUpdate = static_cast<uint32_t>(m_stats.updates);
+        }
+    }
+    return m_residentMip;
+}
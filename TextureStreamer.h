@@ -0,0 +1,54 @@
+#pragma once
+
+#include "BufferUploader.h"
+#include "DdsTexture.h"
+
+#include <cstdint>
+#include <deque>
+
+struct TextureStreamerStats
+{
+    uint64_t updates;               // Updates that had mips left to upload.
+    uint64_t bytes;
+    uint32_t mipsUploaded;
+    uint32_t firstResidentUpdate;   // Updates done when a mip was first found resident, 0 while none is.
+};
+
+// Streams the mips of a DDS texture into a GPU texture coarsest first, a byte
+// budget per Update, so the tail of the chain is resident after the first
+// frames and the larger mips follow. A mip goes out whole, over every array
+// slice, and one mip is uploaded per Update at least. Each Update flushes its
+// copies; a mip becomes resident once the fence of its batch has completed,
+// and only after every coarser one.
+//
+// The resident mips are the range views should cover, the others may still be
+// written by the upload queue.
+class TextureStreamer
+{
+public:
+    // texture and destination must outlive the streamer.
+    TextureStreamer(BufferUploader& uploader, const DdsTexture& texture, void* destination);
+
+    void Update(uint64_t byteBudget);
+
+    // Most detailed resident mip, the mip count while none is resident.
+    uint32_t GetResidentMip();
+    bool IsComplete()                               { return GetResidentMip() == 0; }
+
+    const TextureStreamerStats& GetStats() const    { return m_stats; }
+
+private:
+    struct PendingMip
+    {
+        uint32_t mip;
+        uint64_t fenceValue;
+    };
+
+    BufferUploader& m_uploader;
+    const DdsTexture& m_texture;
+    void* m_destination;
+    uint32_t m_nextMip;             // Coarsest mip not uploaded yet, plus one.
+    uint32_t m_residentMip;
+    std::deque<PendingMip> m_pending;
+    TextureStreamerStats m_stats;
+};
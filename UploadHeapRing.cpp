@@ -0,0 +1,54 @@
+#include "stdafx.h"
+#include "UploadHeapRing.h"
+#include "DXSampleHelper.h"
+
+UploadHeapRing::UploadHeapRing(_In_ ID3D12Device* device, UINT64 size, _In_ IFrameQueue* queue) :
+    m_cpuAddress(nullptr),
+    m_gpuAddress(0),
+    m_ring(size),
+    m_queue(queue)
+{
+    ThrowIfFailed(device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(size),
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&m_resource)));
+    m_resource->SetName(L"Upload Ring");
+
+    // Upload heaps can stay mapped for their whole lifetime.
+    CD3DX12_RANGE readRange(0, 0);    // We do not intend to read from this resource on the CPU.
+    ThrowIfFailed(m_resource->Map(0, &readRange, reinterpret_cast<void**>(&m_cpuAddress)));
+    m_gpuAddress = m_resource->GetGPUVirtualAddress();
+}
+
+UploadHeapRing::~UploadHeapRing()
+{
+    if (m_resource)
+    {
+        m_resource->Unmap(0, nullptr);
+    }
+}
+
+UploadAllocation UploadHeapRing::Allocate(UINT64 size, UINT64 alignment)
+{
+    const UINT64 offset = m_ring.AllocateBlocking(size, alignment, *m_queue);
+
+    UploadAllocation allocation;
+    allocation.cpuAddress = m_cpuAddress + offset;
+    allocation.gpuAddress = m_gpuAddress + offset;
+    allocation.offset = offset;
+    allocation.size = size;
+    return allocation;
+}
+
+void UploadHeapRing::FinishFrame(UINT64 fenceValue)
+{
+    m_ring.FinishFrame(fenceValue);
+}
+
+void UploadHeapRing::ReleaseCompleted()
+{
+    m_ring.ReleaseCompleted(m_queue->GetCompletedValue());
+}
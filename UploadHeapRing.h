@@ -0,0 +1,52 @@
+#pragma once
+
+#include "stdafx.h"
+#include "UploadRing.h"
+
+#include <cstring>
+
+struct UploadAllocation
+{
+    void*                       cpuAddress;
+    D3D12_GPU_VIRTUAL_ADDRESS   gpuAddress;
+    UINT64                      offset;
+    UINT64                      size;
+};
+
+// One persistently mapped upload buffer handed out in slices through an
+// UploadRing. Slices are recycled once the frame that used them has completed
+// on the queue, so any number of draws can each get their own constants.
+class UploadHeapRing
+{
+public:
+    UploadHeapRing(_In_ ID3D12Device* device, UINT64 size, _In_ IFrameQueue* queue);
+    ~UploadHeapRing();
+
+    // Blocks on the queue if the ring is full of frames still in flight.
+    UploadAllocation Allocate(UINT64 size, UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+    // Allocate a 256-byte aligned slice and copy data into it.
+    template<typename T>
+    UploadAllocation AllocateConstants(const T& data)
+    {
+        UploadAllocation allocation = Allocate(sizeof(T));
+        memcpy(allocation.cpuAddress, &data, sizeof(T));
+        return allocation;
+    }
+
+    // Close the current frame, see UploadRing::FinishFrame.
+    void FinishFrame(UINT64 fenceValue);
+
+    // Reclaim the slices of every frame the queue has completed.
+    void ReleaseCompleted();
+
+    ID3D12Resource* GetResource() const noexcept { return m_resource.Get(); }
+    const UploadRing& GetRing() const noexcept { return m_ring; }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Resource>              m_resource;
+    UINT8*                                              m_cpuAddress;
+    D3D12_GPU_VIRTUAL_ADDRESS                           m_gpuAddress;
+    UploadRing                                          m_ring;
+    IFrameQueue*                                        m_queue;
+};
@@ -0,0 +1,142 @@
+#include "UploadRing.h"
+
+#include <stdexcept>
+
+namespace
+{
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+const uint64_t UploadRing::InvalidOffset;
+
+UploadRing::UploadRing(uint64_t size) :
+    m_size(size),
+    m_head(0),
+    m_tail(0),
+    m_used(0),
+    m_frameUsed(0),
+    m_stats()
+{
+    if (size == 0)
+    {
+        throw std::invalid_argument("UploadRing");
+    }
+}
+
+uint64_t UploadRing::Allocate(uint64_t size, uint64_t alignment)
+{
+    if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        throw std::invalid_argument("UploadRing::Allocate");
+    }
+
+    uint64_t offset = InvalidOffset;
+    uint64_t consumed = 0;
+
+    if (m_used < m_size)
+    {
+        const uint64_t aligned = AlignUp(m_head, alignment);
+
+        if (m_head >= m_tail)
+        {
+            // Free space is [head, size) followed by [0, tail).
+            if (aligned + size <= m_size)
+            {
+                offset = aligned;
+                consumed = aligned + size - m_head;
+            }
+            else if (size <= m_tail)
+            {
+                // Skip the end of the ring, offset 0 is always aligned.
+                offset = 0;
+                consumed = (m_size - m_head) + size;
+            }
+        }
+        else if (aligned + size <= m_tail)
+        {
+            // Free space is [head, tail).
+            offset = aligned;
+            consumed = aligned + size - m_head;
+        }
+    }
+
+    if (offset == InvalidOffset)
+    {
+        m_stats.failedAllocations++;
+        return InvalidOffset;
+    }
+
+    m_head = offset + size;
+    m_used += consumed;
+    m_frameUsed += consumed;
+
+    m_stats.allocations++;
+    if (m_used > m_stats.peakUsedSize)
+    {
+        m_stats.peakUsedSize = m_used;
+    }
+
+    return offset;
+}
+
+uint64_t UploadRing::AllocateBlocking(uint64_t size, uint64_t alignment, IFrameQueue& queue)
+{
+    if (size > m_size)
+    {
+        throw std::length_error("UploadRing: allocation larger than the ring");
+    }
+
+    ReleaseCompleted(queue.GetCompletedValue());
+
+    for (;;)
+    {
+        const uint64_t offset = Allocate(size, alignment);
+        if (offset != InvalidOffset)
+        {
+            return offset;
+        }
+
+        // Only the frame being recorded holds the ring, nothing will ever free up.
+        if (m_frames.empty())
+        {
+            throw std::length_error("UploadRing: out of memory for the current frame");
+        }
+
+        m_stats.fenceWaits++;
+        queue.WaitForValue(m_frames.front().fenceValue);
+        ReleaseCompleted(queue.GetCompletedValue());
+    }
+}
+
+void UploadRing::FinishFrame(uint64_t fenceValue)
+{
+    if (!m_frames.empty() && fenceValue < m_frames.back().fenceValue)
+    {
+        throw std::logic_error("UploadRing: fence values must increase");
+    }
+
+    FrameMarker marker = { fenceValue, m_head, m_frameUsed };
+    m_frames.push_back(marker);
+    m_frameUsed = 0;
+}
+
+void UploadRing::ReleaseCompleted(uint64_t completedFenceValue)
+{
+    while (!m_frames.empty() && m_frames.front().fenceValue <= completedFenceValue)
+    {
+        const FrameMarker& marker = m_frames.front();
+        m_used -= marker.size;
+        m_tail = marker.end;
+        m_frames.pop_front();
+    }
+
+    // Restart from the beginning once everything is free, nothing is wasted
+    // on wrapping around.
+    if (m_used == 0)
+    {
+        m_head = m_tail = 0;
+    }
+}
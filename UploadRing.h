@@ -0,0 +1,62 @@
+#pragma once
+
+#include "FrameScheduler.h"
+
+#include <cstdint>
+#include <deque>
+
+struct UploadRingStats
+{
+    uint64_t allocations;
+    uint64_t failedAllocations;     // Allocate calls that found the ring full.
+    uint64_t fenceWaits;            // Times AllocateBlocking had to wait on the queue.
+    uint64_t peakUsedSize;
+};
+
+// Linear sub-allocator over a ring of memory, typically one persistently mapped
+// upload buffer. Slices are handed out in order; FinishFrame tags everything
+// allocated since the previous call with a fence value, and the space is only
+// given back once the queue has reached that value.
+//
+// Only offsets are managed here, the owner maps them to CPU and GPU addresses.
+class UploadRing
+{
+public:
+    static const uint64_t InvalidOffset = ~0ull;
+
+    explicit UploadRing(uint64_t size);
+
+    // Returns the offset of an aligned slice, or InvalidOffset when the ring
+    // does not have enough free space. alignment must be a power of two.
+    uint64_t Allocate(uint64_t size, uint64_t alignment);
+
+    // Same as Allocate, but waits on the queue for older frames to retire
+    // when the ring is full. Throws if the request can never fit.
+    uint64_t AllocateBlocking(uint64_t size, uint64_t alignment, IFrameQueue& queue);
+
+    // Close the current frame, its slices are reclaimed once fenceValue completes.
+    void FinishFrame(uint64_t fenceValue);
+
+    // Reclaim the slices of every frame whose fence is <= completedFenceValue.
+    void ReleaseCompleted(uint64_t completedFenceValue);
+
+    uint64_t GetSize() const        { return m_size; }
+    uint64_t GetUsedSize() const    { return m_used; }
+    UploadRingStats GetStats() const { return m_stats; }
+
+private:
+    struct FrameMarker
+    {
+        uint64_t fenceValue;
+        uint64_t end;       // Head position when the frame was closed.
+        uint64_t size;      // Bytes used by the frame, padding included.
+    };
+
+    uint64_t m_size;
+    uint64_t m_head;        // Next free byte.
+    uint64_t m_tail;        // Oldest byte still in use.
+    uint64_t m_used;
+    uint64_t m_frameUsed;   // Bytes used by the frame being recorded.
+    std::deque<FrameMarker> m_frames;
+    UploadRingStats m_stats;
+};
@@ -11,8 +11,12 @@
 
 #include "stdafx.h"
 #include "Win32Application.h"
+#include "HeadlessDriver.h"
+
+#include <cstdio>
 
 HWND Win32Application::m_hwnd = nullptr;
+FrameLoop* Win32Application::m_frameLoop = nullptr;
 
 int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
 {
@@ -22,6 +26,12 @@ int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
     pSample->ParseCommandLineArgs(argv, argc);
     LocalFree(argv);
 
+    // Batch jobs only need the offscreen output, skip the window entirely.
+    if (pSample->IsHeadless())
+    {
+        return RunHeadless(pSample);
+    }
+
     // Initialize the window class.
     WNDCLASSEX windowClass = { 0 };
     windowClass.cbSize = sizeof(WNDCLASSEX);
@@ -54,7 +64,12 @@ int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
 
     ShowWindow(m_hwnd, nCmdShow);
 
-    // Main sample loop.
+    // Main sample loop. Input and the simulation run on this thread between
+    // the messages, rendering runs here too or on the loop's render thread.
+    FrameLoop loop(*pSample, pSample->GetFrameLoopSettings());
+    loop.Start(FrameLoop::Now());
+    m_frameLoop = &loop;
+
     MSG msg = {};
     while (msg.message != WM_QUIT)
     {
@@ -63,15 +78,46 @@ int Win32Application::Run(DXSample* pSample, HINSTANCE hInstance, int nCmdShow)
         {
             TranslateMessage(&msg);
             DispatchMessage(&msg);
+            continue;
+        }
+
+        if (loop.IsRunning())
+        {
+            loop.Tick(FrameLoop::Now());
         }
     }
 
+    loop.Stop();
+    m_frameLoop = nullptr;
     pSample->OnDestroy();
 
     // Return this part of the WM_QUIT message to Windows.
     return static_cast<char>(msg.wParam);
 }
 
+// Render a fixed number of frames without a window and report the frame rate.
+int Win32Application::RunHeadless(DXSample* pSample)
+{
+    HeadlessRunStats stats = HeadlessDriver::Run(*pSample, pSample->GetHeadlessFrameCount(), pSample->GetFrameLoopSettings());
+
+    char buff[128] = {};
+    sprintf_s(buff, "Headless: %u frames in %.3f s (%.1f fps), %llu simulation steps\n", stats.frameCount, stats.seconds, stats.framesPerSecond, stats.loop.steps);
+    OutputDebugStringA(buff);
+
+    // Also report to the console that launched us, if any.
+    if (AttachConsole(ATTACH_PARENT_PROCESS))
+    {
+        FILE* console = nullptr;
+        if (freopen_s(&console, "CONOUT$", "w", stdout) == 0)
+        {
+            fputs(buff, stdout);
+            fflush(stdout);
+        }
+    }
+
+    return 0;
+}
+
 // Main message handler for the sample.
 LRESULT CALLBACK Win32Application::WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
@@ -102,12 +148,17 @@ LRESULT CALLBACK Win32Application::WindowProc(HWND hWnd, UINT message, WPARAM wP
         return 0;
 
     case WM_PAINT:
-        if (pSample)
+        // Frames come from the main loop, only mark the window as painted.
+        ValidateRect(hWnd, nullptr);
+        return 0;
+
+    case WM_CLOSE:
+        // The render thread may be presenting, stop it while the window exists.
+        if (m_frameLoop)
         {
-            pSample->OnUpdate();
-            pSample->OnRender();
+            m_frameLoop->Stop();
         }
-        return 0;
+        break;
 
     case WM_DESTROY:
         PostQuitMessage(0);
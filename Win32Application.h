@@ -14,6 +14,7 @@
 #include "DXSample.h"
 
 class DXSample;
+class FrameLoop;
 
 class Win32Application
 {
@@ -22,8 +23,12 @@ public:
     static HWND GetHwnd() { return m_hwnd; }
 
 protected:
+    static int RunHeadless(DXSample* pSample);
     static LRESULT CALLBACK WindowProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
 
 private:
     static HWND m_hwnd;
+
+    // The loop of the window, stopped before the window goes away.
+    static FrameLoop* m_frameLoop;
 };
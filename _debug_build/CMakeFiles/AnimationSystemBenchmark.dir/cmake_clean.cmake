@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "AnimationSystemBenchmark"
+  "AnimationSystemBenchmark.pdb"
+  "CMakeFiles/AnimationSystemBenchmark.dir/tests/AnimationSystemBenchmark.cpp.o"
+  "CMakeFiles/AnimationSystemBenchmark.dir/tests/AnimationSystemBenchmark.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/AnimationSystemBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "AnimationSystemTests"
+  "AnimationSystemTests.pdb"
+  "CMakeFiles/AnimationSystemTests.dir/tests/AnimationSystemTests.cpp.o"
+  "CMakeFiles/AnimationSystemTests.dir/tests/AnimationSystemTests.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/AnimationSystemTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BlurFilterBenchmark"
+  "BlurFilterBenchmark.pdb"
+  "CMakeFiles/BlurFilterBenchmark.dir/tests/BlurFilterBenchmark.cpp.o"
+  "CMakeFiles/BlurFilterBenchmark.dir/tests/BlurFilterBenchmark.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BlurFilterBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
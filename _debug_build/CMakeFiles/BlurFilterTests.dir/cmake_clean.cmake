@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BlurFilterTests"
+  "BlurFilterTests.pdb"
+  "CMakeFiles/BlurFilterTests.dir/tests/BlurFilterTests.cpp.o"
+  "CMakeFiles/BlurFilterTests.dir/tests/BlurFilterTests.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BlurFilterTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BufferUploaderBenchmark"
+  "BufferUploaderBenchmark.pdb"
+  "CMakeFiles/BufferUploaderBenchmark.dir/tests/BufferUploaderBenchmark.cpp.o"
+  "CMakeFiles/BufferUploaderBenchmark.dir/tests/BufferUploaderBenchmark.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BufferUploaderBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "BufferUploaderTests"
+  "BufferUploaderTests.pdb"
+  "CMakeFiles/BufferUploaderTests.dir/tests/BufferUploaderTests.cpp.o"
+  "CMakeFiles/BufferUploaderTests.dir/tests/BufferUploaderTests.cpp.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/BufferUploaderTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
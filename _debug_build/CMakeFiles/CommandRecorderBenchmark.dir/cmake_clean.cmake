@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/CommandRecorderBenchmark.dir/tests/CommandRecorderBenchmark.cpp.o"
+  "CMakeFiles/CommandRecorderBenchmark.dir/tests/CommandRecorderBenchmark.cpp.o.d"
+  "CommandRecorderBenchmark"
+  "CommandRecorderBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/CommandRecorderBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
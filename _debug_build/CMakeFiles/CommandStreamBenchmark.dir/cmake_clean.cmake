@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/CommandStreamBenchmark.dir/tests/CommandStreamBenchmark.cpp.o"
+  "CMakeFiles/CommandStreamBenchmark.dir/tests/CommandStreamBenchmark.cpp.o.d"
+  "CommandStreamBenchmark"
+  "CommandStreamBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/CommandStreamBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
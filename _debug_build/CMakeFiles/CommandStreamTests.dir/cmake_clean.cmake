@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/CommandStreamTests.dir/tests/CommandStreamTests.cpp.o"
+  "CMakeFiles/CommandStreamTests.dir/tests/CommandStreamTests.cpp.o.d"
+  "CommandStreamTests"
+  "CommandStreamTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/CommandStreamTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DdsTextureBenchmark.dir/tests/DdsTextureBenchmark.cpp.o"
+  "CMakeFiles/DdsTextureBenchmark.dir/tests/DdsTextureBenchmark.cpp.o.d"
+  "DdsTextureBenchmark"
+  "DdsTextureBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DdsTextureBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
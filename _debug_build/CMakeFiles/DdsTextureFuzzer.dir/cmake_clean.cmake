@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DdsTextureFuzzer.dir/tests/DdsTextureFuzzer.cpp.o"
+  "CMakeFiles/DdsTextureFuzzer.dir/tests/DdsTextureFuzzer.cpp.o.d"
+  "DdsTextureFuzzer"
+  "DdsTextureFuzzer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DdsTextureFuzzer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
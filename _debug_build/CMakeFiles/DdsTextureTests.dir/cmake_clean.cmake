@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DdsTextureTests.dir/tests/DdsTextureTests.cpp.o"
+  "CMakeFiles/DdsTextureTests.dir/tests/DdsTextureTests.cpp.o.d"
+  "DdsTextureTests"
+  "DdsTextureTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DdsTextureTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DescriptorAllocatorBenchmark.dir/tests/DescriptorAllocatorBenchmark.cpp.o"
+  "CMakeFiles/DescriptorAllocatorBenchmark.dir/tests/DescriptorAllocatorBenchmark.cpp.o.d"
+  "DescriptorAllocatorBenchmark"
+  "DescriptorAllocatorBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DescriptorAllocatorBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
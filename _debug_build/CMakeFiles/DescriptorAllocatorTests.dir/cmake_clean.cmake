@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DescriptorAllocatorTests.dir/tests/DescriptorAllocatorTests.cpp.o"
+  "CMakeFiles/DescriptorAllocatorTests.dir/tests/DescriptorAllocatorTests.cpp.o.d"
+  "DescriptorAllocatorTests"
+  "DescriptorAllocatorTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DescriptorAllocatorTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
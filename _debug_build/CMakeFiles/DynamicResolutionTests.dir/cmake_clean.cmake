@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/DynamicResolutionTests.dir/tests/DynamicResolutionTests.cpp.o"
+  "CMakeFiles/DynamicResolutionTests.dir/tests/DynamicResolutionTests.cpp.o.d"
+  "DynamicResolutionTests"
+  "DynamicResolutionTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/DynamicResolutionTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrameLoopTests.dir/tests/FrameLoopTests.cpp.o"
+  "CMakeFiles/FrameLoopTests.dir/tests/FrameLoopTests.cpp.o.d"
+  "FrameLoopTests"
+  "FrameLoopTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrameLoopTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrameSchedulerBenchmark.dir/tests/FrameSchedulerBenchmark.cpp.o"
+  "CMakeFiles/FrameSchedulerBenchmark.dir/tests/FrameSchedulerBenchmark.cpp.o.d"
+  "FrameSchedulerBenchmark"
+  "FrameSchedulerBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrameSchedulerBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
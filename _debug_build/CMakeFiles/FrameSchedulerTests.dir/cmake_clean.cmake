@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/FrameSchedulerTests.dir/tests/FrameSchedulerTests.cpp.o"
+  "CMakeFiles/FrameSchedulerTests.dir/tests/FrameSchedulerTests.cpp.o.d"
+  "FrameSchedulerTests"
+  "FrameSchedulerTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/FrameSchedulerTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/HeadlessDriverTests.dir/tests/HeadlessDriverTests.cpp.o"
+  "CMakeFiles/HeadlessDriverTests.dir/tests/HeadlessDriverTests.cpp.o.d"
+  "HeadlessDriverTests"
+  "HeadlessDriverTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/HeadlessDriverTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/HeadlessRunner.dir/tests/HeadlessRunner.cpp.o"
+  "CMakeFiles/HeadlessRunner.dir/tests/HeadlessRunner.cpp.o.d"
+  "HeadlessRunner"
+  "HeadlessRunner.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/HeadlessRunner.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
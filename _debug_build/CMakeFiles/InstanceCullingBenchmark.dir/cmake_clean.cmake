@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/InstanceCullingBenchmark.dir/tests/InstanceCullingBenchmark.cpp.o"
+  "CMakeFiles/InstanceCullingBenchmark.dir/tests/InstanceCullingBenchmark.cpp.o.d"
+  "InstanceCullingBenchmark"
+  "InstanceCullingBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/InstanceCullingBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/InstanceCullingTests.dir/tests/InstanceCullingTests.cpp.o"
+  "CMakeFiles/InstanceCullingTests.dir/tests/InstanceCullingTests.cpp.o.d"
+  "InstanceCullingTests"
+  "InstanceCullingTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/InstanceCullingTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
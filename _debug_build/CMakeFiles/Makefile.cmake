@@ -0,0 +1,93 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCXXSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFileCXX.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "CMakeFiles/Portable.dir/DependInfo.cmake"
+  "CMakeFiles/TestHarness.dir/DependInfo.cmake"
+  "CMakeFiles/FrameSchedulerTests.dir/DependInfo.cmake"
+  "CMakeFiles/FrameSchedulerBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/HeadlessRunner.dir/DependInfo.cmake"
+  "CMakeFiles/HeadlessDriverTests.dir/DependInfo.cmake"
+  "CMakeFiles/UploadRingTests.dir/DependInfo.cmake"
+  "CMakeFiles/UploadRingBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/PipelineStateCacheTests.dir/DependInfo.cmake"
+  "CMakeFiles/DescriptorAllocatorTests.dir/DependInfo.cmake"
+  "CMakeFiles/DescriptorAllocatorBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/RenderGraphTests.dir/DependInfo.cmake"
+  "CMakeFiles/BlurFilterTests.dir/DependInfo.cmake"
+  "CMakeFiles/BlurFilterBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/BufferUploaderTests.dir/DependInfo.cmake"
+  "CMakeFiles/BufferUploaderBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/TexturePoolTests.dir/DependInfo.cmake"
+  "CMakeFiles/TexturePoolBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/DynamicResolutionTests.dir/DependInfo.cmake"
+  "CMakeFiles/InstanceCullingTests.dir/DependInfo.cmake"
+  "CMakeFiles/InstanceCullingBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/AnimationSystemTests.dir/DependInfo.cmake"
+  "CMakeFiles/AnimationSystemBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/ProfilerTests.dir/DependInfo.cmake"
+  "CMakeFiles/FrameLoopTests.dir/DependInfo.cmake"
+  "CMakeFiles/MappedFileTests.dir/DependInfo.cmake"
+  "CMakeFiles/MappedFileBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/DdsTextureTests.dir/DependInfo.cmake"
+  "CMakeFiles/DdsTextureBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/DdsTextureFuzzer.dir/DependInfo.cmake"
+  "CMakeFiles/SoftwareRasterizerTests.dir/DependInfo.cmake"
+  "CMakeFiles/SoftwareRasterizerBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/CommandStreamTests.dir/DependInfo.cmake"
+  "CMakeFiles/CommandStreamBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/ShaderHotReloadTests.dir/DependInfo.cmake"
+  "CMakeFiles/TaskGraphTests.dir/DependInfo.cmake"
+  "CMakeFiles/TaskGraphBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/RootSignatureBuilderTests.dir/DependInfo.cmake"
+  "CMakeFiles/ShaderCacheTests.dir/DependInfo.cmake"
+  "CMakeFiles/ShaderCacheBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/ResourceStateTrackerTests.dir/DependInfo.cmake"
+  "CMakeFiles/CommandRecorderBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/ProfilerBenchmark.dir/DependInfo.cmake"
+  "CMakeFiles/ReadbackRingTests.dir/DependInfo.cmake"
+  )
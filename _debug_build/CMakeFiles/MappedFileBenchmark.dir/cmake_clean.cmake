@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MappedFileBenchmark.dir/tests/MappedFileBenchmark.cpp.o"
+  "CMakeFiles/MappedFileBenchmark.dir/tests/MappedFileBenchmark.cpp.o.d"
+  "MappedFileBenchmark"
+  "MappedFileBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MappedFileBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
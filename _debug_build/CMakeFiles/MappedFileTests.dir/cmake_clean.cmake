@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/MappedFileTests.dir/tests/MappedFileTests.cpp.o"
+  "CMakeFiles/MappedFileTests.dir/tests/MappedFileTests.cpp.o.d"
+  "MappedFileTests"
+  "MappedFileTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/MappedFileTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
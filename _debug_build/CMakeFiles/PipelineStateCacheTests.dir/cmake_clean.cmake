@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/PipelineStateCacheTests.dir/tests/PipelineStateCacheTests.cpp.o"
+  "CMakeFiles/PipelineStateCacheTests.dir/tests/PipelineStateCacheTests.cpp.o.d"
+  "PipelineStateCacheTests"
+  "PipelineStateCacheTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/PipelineStateCacheTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
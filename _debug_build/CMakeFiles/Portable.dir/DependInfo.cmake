@@ -0,0 +1,50 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/AnimationSystem.cpp" "CMakeFiles/Portable.dir/AnimationSystem.cpp.o" "gcc" "CMakeFiles/Portable.dir/AnimationSystem.cpp.o.d"
+  "/root/repo/BlobPack.cpp" "CMakeFiles/Portable.dir/BlobPack.cpp.o" "gcc" "CMakeFiles/Portable.dir/BlobPack.cpp.o.d"
+  "/root/repo/BlurFilter.cpp" "CMakeFiles/Portable.dir/BlurFilter.cpp.o" "gcc" "CMakeFiles/Portable.dir/BlurFilter.cpp.o.d"
+  "/root/repo/BufferUploader.cpp" "CMakeFiles/Portable.dir/BufferUploader.cpp.o" "gcc" "CMakeFiles/Portable.dir/BufferUploader.cpp.o.d"
+  "/root/repo/CommandRecorder.cpp" "CMakeFiles/Portable.dir/CommandRecorder.cpp.o" "gcc" "CMakeFiles/Portable.dir/CommandRecorder.cpp.o.d"
+  "/root/repo/CommandStream.cpp" "CMakeFiles/Portable.dir/CommandStream.cpp.o" "gcc" "CMakeFiles/Portable.dir/CommandStream.cpp.o.d"
+  "/root/repo/DdsTexture.cpp" "CMakeFiles/Portable.dir/DdsTexture.cpp.o" "gcc" "CMakeFiles/Portable.dir/DdsTexture.cpp.o.d"
+  "/root/repo/DescriptorAllocator.cpp" "CMakeFiles/Portable.dir/DescriptorAllocator.cpp.o" "gcc" "CMakeFiles/Portable.dir/DescriptorAllocator.cpp.o.d"
+  "/root/repo/DynamicResolution.cpp" "CMakeFiles/Portable.dir/DynamicResolution.cpp.o" "gcc" "CMakeFiles/Portable.dir/DynamicResolution.cpp.o.d"
+  "/root/repo/FileWatcher.cpp" "CMakeFiles/Portable.dir/FileWatcher.cpp.o" "gcc" "CMakeFiles/Portable.dir/FileWatcher.cpp.o.d"
+  "/root/repo/FrameBackend.cpp" "CMakeFiles/Portable.dir/FrameBackend.cpp.o" "gcc" "CMakeFiles/Portable.dir/FrameBackend.cpp.o.d"
+  "/root/repo/FrameLoop.cpp" "CMakeFiles/Portable.dir/FrameLoop.cpp.o" "gcc" "CMakeFiles/Portable.dir/FrameLoop.cpp.o.d"
+  "/root/repo/FrameScheduler.cpp" "CMakeFiles/Portable.dir/FrameScheduler.cpp.o" "gcc" "CMakeFiles/Portable.dir/FrameScheduler.cpp.o.d"
+  "/root/repo/HeadlessDriver.cpp" "CMakeFiles/Portable.dir/HeadlessDriver.cpp.o" "gcc" "CMakeFiles/Portable.dir/HeadlessDriver.cpp.o.d"
+  "/root/repo/InstanceCulling.cpp" "CMakeFiles/Portable.dir/InstanceCulling.cpp.o" "gcc" "CMakeFiles/Portable.dir/InstanceCulling.cpp.o.d"
+  "/root/repo/JobSystem.cpp" "CMakeFiles/Portable.dir/JobSystem.cpp.o" "gcc" "CMakeFiles/Portable.dir/JobSystem.cpp.o.d"
+  "/root/repo/MappedFile.cpp" "CMakeFiles/Portable.dir/MappedFile.cpp.o" "gcc" "CMakeFiles/Portable.dir/MappedFile.cpp.o.d"
+  "/root/repo/PipelineStateCache.cpp" "CMakeFiles/Portable.dir/PipelineStateCache.cpp.o" "gcc" "CMakeFiles/Portable.dir/PipelineStateCache.cpp.o.d"
+  "/root/repo/Profiler.cpp" "CMakeFiles/Portable.dir/Profiler.cpp.o" "gcc" "CMakeFiles/Portable.dir/Profiler.cpp.o.d"
+  "/root/repo/ReadbackRing.cpp" "CMakeFiles/Portable.dir/ReadbackRing.cpp.o" "gcc" "CMakeFiles/Portable.dir/ReadbackRing.cpp.o.d"
+  "/root/repo/RenderGraph.cpp" "CMakeFiles/Portable.dir/RenderGraph.cpp.o" "gcc" "CMakeFiles/Portable.dir/RenderGraph.cpp.o.d"
+  "/root/repo/ResourceStateTracker.cpp" "CMakeFiles/Portable.dir/ResourceStateTracker.cpp.o" "gcc" "CMakeFiles/Portable.dir/ResourceStateTracker.cpp.o.d"
+  "/root/repo/RootSignatureBuilder.cpp" "CMakeFiles/Portable.dir/RootSignatureBuilder.cpp.o" "gcc" "CMakeFiles/Portable.dir/RootSignatureBuilder.cpp.o.d"
+  "/root/repo/SampleFrame.cpp" "CMakeFiles/Portable.dir/SampleFrame.cpp.o" "gcc" "CMakeFiles/Portable.dir/SampleFrame.cpp.o.d"
+  "/root/repo/ShaderCache.cpp" "CMakeFiles/Portable.dir/ShaderCache.cpp.o" "gcc" "CMakeFiles/Portable.dir/ShaderCache.cpp.o.d"
+  "/root/repo/ShaderHotReload.cpp" "CMakeFiles/Portable.dir/ShaderHotReload.cpp.o" "gcc" "CMakeFiles/Portable.dir/ShaderHotReload.cpp.o.d"
+  "/root/repo/SoftwareRasterizer.cpp" "CMakeFiles/Portable.dir/SoftwareRasterizer.cpp.o" "gcc" "CMakeFiles/Portable.dir/SoftwareRasterizer.cpp.o.d"
+  "/root/repo/TaskGraph.cpp" "CMakeFiles/Portable.dir/TaskGraph.cpp.o" "gcc" "CMakeFiles/Portable.dir/TaskGraph.cpp.o.d"
+  "/root/repo/TextureLayout.cpp" "CMakeFiles/Portable.dir/TextureLayout.cpp.o" "gcc" "CMakeFiles/Portable.dir/TextureLayout.cpp.o.d"
+  "/root/repo/TexturePool.cpp" "CMakeFiles/Portable.dir/TexturePool.cpp.o" "gcc" "CMakeFiles/Portable.dir/TexturePool.cpp.o.d"
+  "/root/repo/TextureStreamer.cpp" "CMakeFiles/Portable.dir/TextureStreamer.cpp.o" "gcc" "CMakeFiles/Portable.dir/TextureStreamer.cpp.o.d"
+  "/root/repo/UploadRing.cpp" "CMakeFiles/Portable.dir/UploadRing.cpp.o" "gcc" "CMakeFiles/Portable.dir/UploadRing.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
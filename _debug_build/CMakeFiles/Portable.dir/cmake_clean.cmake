@@ -0,0 +1,73 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/Portable.dir/AnimationSystem.cpp.o"
+  "CMakeFiles/Portable.dir/AnimationSystem.cpp.o.d"
+  "CMakeFiles/Portable.dir/BlobPack.cpp.o"
+  "CMakeFiles/Portable.dir/BlobPack.cpp.o.d"
+  "CMakeFiles/Portable.dir/BlurFilter.cpp.o"
+  "CMakeFiles/Portable.dir/BlurFilter.cpp.o.d"
+  "CMakeFiles/Portable.dir/BufferUploader.cpp.o"
+  "CMakeFiles/Portable.dir/BufferUploader.cpp.o.d"
+  "CMakeFiles/Portable.dir/CommandRecorder.cpp.o"
+  "CMakeFiles/Portable.dir/CommandRecorder.cpp.o.d"
+  "CMakeFiles/Portable.dir/CommandStream.cpp.o"
+  "CMakeFiles/Portable.dir/CommandStream.cpp.o.d"
+  "CMakeFiles/Portable.dir/DdsTexture.cpp.o"
+  "CMakeFiles/Portable.dir/DdsTexture.cpp.o.d"
+  "CMakeFiles/Portable.dir/DescriptorAllocator.cpp.o"
+  "CMakeFiles/Portable.dir/DescriptorAllocator.cpp.o.d"
+  "CMakeFiles/Portable.dir/DynamicResolution.cpp.o"
+  "CMakeFiles/Portable.dir/DynamicResolution.cpp.o.d"
+  "CMakeFiles/Portable.dir/FileWatcher.cpp.o"
+  "CMakeFiles/Portable.dir/FileWatcher.cpp.o.d"
+  "CMakeFiles/Portable.dir/FrameBackend.cpp.o"
+  "CMakeFiles/Portable.dir/FrameBackend.cpp.o.d"
+  "CMakeFiles/Portable.dir/FrameLoop.cpp.o"
+  "CMakeFiles/Portable.dir/FrameLoop.cpp.o.d"
+  "CMakeFiles/Portable.dir/FrameScheduler.cpp.o"
+  "CMakeFiles/Portable.dir/FrameScheduler.cpp.o.d"
+  "CMakeFiles/Portable.dir/HeadlessDriver.cpp.o"
+  "CMakeFiles/Portable.dir/HeadlessDriver.cpp.o.d"
+  "CMakeFiles/Portable.dir/InstanceCulling.cpp.o"
+  "CMakeFiles/Portable.dir/InstanceCulling.cpp.o.d"
+  "CMakeFiles/Portable.dir/JobSystem.cpp.o"
+  "CMakeFiles/Portable.dir/JobSystem.cpp.o.d"
+  "CMakeFiles/Portable.dir/MappedFile.cpp.o"
+  "CMakeFiles/Portable.dir/MappedFile.cpp.o.d"
+  "CMakeFiles/Portable.dir/PipelineStateCache.cpp.o"
+  "CMakeFiles/Portable.dir/PipelineStateCache.cpp.o.d"
+  "CMakeFiles/Portable.dir/Profiler.cpp.o"
+  "CMakeFiles/Portable.dir/Profiler.cpp.o.d"
+  "CMakeFiles/Portable.dir/ReadbackRing.cpp.o"
+  "CMakeFiles/Portable.dir/ReadbackRing.cpp.o.d"
+  "CMakeFiles/Portable.dir/RenderGraph.cpp.o"
+  "CMakeFiles/Portable.dir/RenderGraph.cpp.o.d"
+  "CMakeFiles/Portable.dir/ResourceStateTracker.cpp.o"
+  "CMakeFiles/Portable.dir/ResourceStateTracker.cpp.o.d"
+  "CMakeFiles/Portable.dir/RootSignatureBuilder.cpp.o"
+  "CMakeFiles/Portable.dir/RootSignatureBuilder.cpp.o.d"
+  "CMakeFiles/Portable.dir/SampleFrame.cpp.o"
+  "CMakeFiles/Portable.dir/SampleFrame.cpp.o.d"
+  "CMakeFiles/Portable.dir/ShaderCache.cpp.o"
+  "CMakeFiles/Portable.dir/ShaderCache.cpp.o.d"
+  "CMakeFiles/Portable.dir/ShaderHotReload.cpp.o"
+  "CMakeFiles/Portable.dir/ShaderHotReload.cpp.o.d"
+  "CMakeFiles/Portable.dir/SoftwareRasterizer.cpp.o"
+  "CMakeFiles/Portable.dir/SoftwareRasterizer.cpp.o.d"
+  "CMakeFiles/Portable.dir/TaskGraph.cpp.o"
+  "CMakeFiles/Portable.dir/TaskGraph.cpp.o.d"
+  "CMakeFiles/Portable.dir/TextureLayout.cpp.o"
+  "CMakeFiles/Portable.dir/TextureLayout.cpp.o.d"
+  "CMakeFiles/Portable.dir/TexturePool.cpp.o"
+  "CMakeFiles/Portable.dir/TexturePool.cpp.o.d"
+  "CMakeFiles/Portable.dir/TextureStreamer.cpp.o"
+  "CMakeFiles/Portable.dir/TextureStreamer.cpp.o.d"
+  "CMakeFiles/Portable.dir/UploadRing.cpp.o"
+  "CMakeFiles/Portable.dir/UploadRing.cpp.o.d"
+  "libPortable.a"
+  "libPortable.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/Portable.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
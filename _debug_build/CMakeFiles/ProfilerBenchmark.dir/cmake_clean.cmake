@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ProfilerBenchmark.dir/tests/ProfilerBenchmark.cpp.o"
+  "CMakeFiles/ProfilerBenchmark.dir/tests/ProfilerBenchmark.cpp.o.d"
+  "ProfilerBenchmark"
+  "ProfilerBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ProfilerBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
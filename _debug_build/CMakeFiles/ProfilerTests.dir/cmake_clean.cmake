@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ProfilerTests.dir/tests/ProfilerTests.cpp.o"
+  "CMakeFiles/ProfilerTests.dir/tests/ProfilerTests.cpp.o.d"
+  "ProfilerTests"
+  "ProfilerTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ProfilerTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
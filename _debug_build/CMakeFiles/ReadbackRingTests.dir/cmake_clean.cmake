@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ReadbackRingTests.dir/tests/ReadbackRingTests.cpp.o"
+  "CMakeFiles/ReadbackRingTests.dir/tests/ReadbackRingTests.cpp.o.d"
+  "ReadbackRingTests"
+  "ReadbackRingTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ReadbackRingTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/RenderGraphTests.dir/tests/RenderGraphTests.cpp.o"
+  "CMakeFiles/RenderGraphTests.dir/tests/RenderGraphTests.cpp.o.d"
+  "RenderGraphTests"
+  "RenderGraphTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/RenderGraphTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ResourceStateTrackerTests.dir/tests/ResourceStateTrackerTests.cpp.o"
+  "CMakeFiles/ResourceStateTrackerTests.dir/tests/ResourceStateTrackerTests.cpp.o.d"
+  "ResourceStateTrackerTests"
+  "ResourceStateTrackerTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ResourceStateTrackerTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/RootSignatureBuilderTests.dir/tests/RootSignatureBuilderTests.cpp.o"
+  "CMakeFiles/RootSignatureBuilderTests.dir/tests/RootSignatureBuilderTests.cpp.o.d"
+  "RootSignatureBuilderTests"
+  "RootSignatureBuilderTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/RootSignatureBuilderTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
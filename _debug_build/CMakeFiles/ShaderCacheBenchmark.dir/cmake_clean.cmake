@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ShaderCacheBenchmark.dir/tests/ShaderCacheBenchmark.cpp.o"
+  "CMakeFiles/ShaderCacheBenchmark.dir/tests/ShaderCacheBenchmark.cpp.o.d"
+  "ShaderCacheBenchmark"
+  "ShaderCacheBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ShaderCacheBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
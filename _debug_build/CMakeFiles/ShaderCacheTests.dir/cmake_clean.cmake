@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ShaderCacheTests.dir/tests/ShaderCacheTests.cpp.o"
+  "CMakeFiles/ShaderCacheTests.dir/tests/ShaderCacheTests.cpp.o.d"
+  "ShaderCacheTests"
+  "ShaderCacheTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ShaderCacheTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ShaderHotReloadTests.dir/tests/ShaderHotReloadTests.cpp.o"
+  "CMakeFiles/ShaderHotReloadTests.dir/tests/ShaderHotReloadTests.cpp.o.d"
+  "ShaderHotReloadTests"
+  "ShaderHotReloadTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ShaderHotReloadTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
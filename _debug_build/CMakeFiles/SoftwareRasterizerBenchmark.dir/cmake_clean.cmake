@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/SoftwareRasterizerBenchmark.dir/tests/SoftwareRasterizerBenchmark.cpp.o"
+  "CMakeFiles/SoftwareRasterizerBenchmark.dir/tests/SoftwareRasterizerBenchmark.cpp.o.d"
+  "SoftwareRasterizerBenchmark"
+  "SoftwareRasterizerBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/SoftwareRasterizerBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
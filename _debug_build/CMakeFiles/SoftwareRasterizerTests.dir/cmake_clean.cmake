@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/SoftwareRasterizerTests.dir/tests/SoftwareRasterizerTests.cpp.o"
+  "CMakeFiles/SoftwareRasterizerTests.dir/tests/SoftwareRasterizerTests.cpp.o.d"
+  "SoftwareRasterizerTests"
+  "SoftwareRasterizerTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/SoftwareRasterizerTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
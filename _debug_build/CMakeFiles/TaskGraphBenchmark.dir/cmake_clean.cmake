@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/TaskGraphBenchmark.dir/tests/TaskGraphBenchmark.cpp.o"
+  "CMakeFiles/TaskGraphBenchmark.dir/tests/TaskGraphBenchmark.cpp.o.d"
+  "TaskGraphBenchmark"
+  "TaskGraphBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/TaskGraphBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
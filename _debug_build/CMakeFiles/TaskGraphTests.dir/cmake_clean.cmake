@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/TaskGraphTests.dir/tests/TaskGraphTests.cpp.o"
+  "CMakeFiles/TaskGraphTests.dir/tests/TaskGraphTests.cpp.o.d"
+  "TaskGraphTests"
+  "TaskGraphTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/TaskGraphTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/TestHarness.dir/tests/TestMain.cpp.o"
+  "CMakeFiles/TestHarness.dir/tests/TestMain.cpp.o.d"
+  "libTestHarness.a"
+  "libTestHarness.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/TestHarness.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
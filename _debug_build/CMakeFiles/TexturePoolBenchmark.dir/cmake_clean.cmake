@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/TexturePoolBenchmark.dir/tests/TexturePoolBenchmark.cpp.o"
+  "CMakeFiles/TexturePoolBenchmark.dir/tests/TexturePoolBenchmark.cpp.o.d"
+  "TexturePoolBenchmark"
+  "TexturePoolBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/TexturePoolBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
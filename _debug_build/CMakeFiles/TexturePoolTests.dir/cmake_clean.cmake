@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/TexturePoolTests.dir/tests/TexturePoolTests.cpp.o"
+  "CMakeFiles/TexturePoolTests.dir/tests/TexturePoolTests.cpp.o.d"
+  "TexturePoolTests"
+  "TexturePoolTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/TexturePoolTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/UploadRingBenchmark.dir/tests/UploadRingBenchmark.cpp.o"
+  "CMakeFiles/UploadRingBenchmark.dir/tests/UploadRingBenchmark.cpp.o.d"
+  "UploadRingBenchmark"
+  "UploadRingBenchmark.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/UploadRingBenchmark.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
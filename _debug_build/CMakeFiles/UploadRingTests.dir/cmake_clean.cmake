@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/UploadRingTests.dir/tests/UploadRingTests.cpp.o"
+  "CMakeFiles/UploadRingTests.dir/tests/UploadRingTests.cpp.o.d"
+  "UploadRingTests"
+  "UploadRingTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/UploadRingTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
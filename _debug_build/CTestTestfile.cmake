@@ -0,0 +1,92 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_debug_build
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(FrameSchedulerTests "/root/repo/_debug_build/FrameSchedulerTests")
+set_tests_properties(FrameSchedulerTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;89;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(FrameSchedulerBenchmark "/root/repo/_debug_build/FrameSchedulerBenchmark" "--quick")
+set_tests_properties(FrameSchedulerBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;90;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(HeadlessRunner "/root/repo/_debug_build/HeadlessRunner" "200")
+set_tests_properties(HeadlessRunner PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;96;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(HeadlessRunnerRenderThread "/root/repo/_debug_build/HeadlessRunner" "200" "-renderthread" "-draws" "1000" "-threads" "2")
+set_tests_properties(HeadlessRunnerRenderThread PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;97;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(HeadlessDriverTests "/root/repo/_debug_build/HeadlessDriverTests")
+set_tests_properties(HeadlessDriverTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;99;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(UploadRingTests "/root/repo/_debug_build/UploadRingTests")
+set_tests_properties(UploadRingTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;101;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(UploadRingBenchmark "/root/repo/_debug_build/UploadRingBenchmark" "--quick")
+set_tests_properties(UploadRingBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;102;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(PipelineStateCacheTests "/root/repo/_debug_build/PipelineStateCacheTests")
+set_tests_properties(PipelineStateCacheTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;104;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(DescriptorAllocatorTests "/root/repo/_debug_build/DescriptorAllocatorTests")
+set_tests_properties(DescriptorAllocatorTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;106;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(DescriptorAllocatorBenchmark "/root/repo/_debug_build/DescriptorAllocatorBenchmark" "--quick")
+set_tests_properties(DescriptorAllocatorBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;107;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(RenderGraphTests "/root/repo/_debug_build/RenderGraphTests")
+set_tests_properties(RenderGraphTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;109;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(BlurFilterTests "/root/repo/_debug_build/BlurFilterTests")
+set_tests_properties(BlurFilterTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;111;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(BlurFilterBenchmark "/root/repo/_debug_build/BlurFilterBenchmark" "--quick")
+set_tests_properties(BlurFilterBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;112;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(BufferUploaderTests "/root/repo/_debug_build/BufferUploaderTests")
+set_tests_properties(BufferUploaderTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;114;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(BufferUploaderBenchmark "/root/repo/_debug_build/BufferUploaderBenchmark" "--quick")
+set_tests_properties(BufferUploaderBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;115;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(TexturePoolTests "/root/repo/_debug_build/TexturePoolTests")
+set_tests_properties(TexturePoolTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;117;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(TexturePoolBenchmark "/root/repo/_debug_build/TexturePoolBenchmark" "--quick")
+set_tests_properties(TexturePoolBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;118;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(DynamicResolutionTests "/root/repo/_debug_build/DynamicResolutionTests")
+set_tests_properties(DynamicResolutionTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;120;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(InstanceCullingTests "/root/repo/_debug_build/InstanceCullingTests")
+set_tests_properties(InstanceCullingTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;122;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(InstanceCullingBenchmark "/root/repo/_debug_build/InstanceCullingBenchmark" "--quick")
+set_tests_properties(InstanceCullingBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;123;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(AnimationSystemTests "/root/repo/_debug_build/AnimationSystemTests")
+set_tests_properties(AnimationSystemTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;125;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(AnimationSystemBenchmark "/root/repo/_debug_build/AnimationSystemBenchmark" "--quick")
+set_tests_properties(AnimationSystemBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;126;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(ProfilerTests "/root/repo/_debug_build/ProfilerTests")
+set_tests_properties(ProfilerTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;128;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(FrameLoopTests "/root/repo/_debug_build/FrameLoopTests")
+set_tests_properties(FrameLoopTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;130;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(MappedFileTests "/root/repo/_debug_build/MappedFileTests")
+set_tests_properties(MappedFileTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;132;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(MappedFileBenchmark "/root/repo/_debug_build/MappedFileBenchmark" "--quick")
+set_tests_properties(MappedFileBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;133;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(DdsTextureTests "/root/repo/_debug_build/DdsTextureTests")
+set_tests_properties(DdsTextureTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;135;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(DdsTextureBenchmark "/root/repo/_debug_build/DdsTextureBenchmark" "--quick")
+set_tests_properties(DdsTextureBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;136;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(DdsTextureFuzzer "/root/repo/_debug_build/DdsTextureFuzzer" "-mutations" "20000" "/root/repo/tests/data/dds/ati2.dds" "/root/repo/tests/data/dds/b5g6r5.dds" "/root/repo/tests/data/dds/bgra8_npot.dds" "/root/repo/tests/data/dds/cube_dxt1.dds" "/root/repo/tests/data/dds/dx10_bc6h_cube_array.dds" "/root/repo/tests/data/dds/dx10_bc7_array.dds" "/root/repo/tests/data/dds/dx10_r32f_1d.dds" "/root/repo/tests/data/dds/dx10_rgba16f_3d.dds" "/root/repo/tests/data/dds/dxt1_mips.dds" "/root/repo/tests/data/dds/dxt5_npot.dds" "/root/repo/tests/data/dds/l8.dds" "/root/repo/tests/data/dds/rgba8_mips.dds" "/root/repo/tests/data/dds/truncated_dxt1.dds" "/root/repo/tests/data/dds/volume_rgba8.dds")
+set_tests_properties(DdsTextureFuzzer PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;156;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(SoftwareRasterizerTests "/root/repo/_debug_build/SoftwareRasterizerTests")
+set_tests_properties(SoftwareRasterizerTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;159;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(SoftwareRasterizerBenchmark "/root/repo/_debug_build/SoftwareRasterizerBenchmark" "--quick")
+set_tests_properties(SoftwareRasterizerBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;160;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(CommandStreamTests "/root/repo/_debug_build/CommandStreamTests")
+set_tests_properties(CommandStreamTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;162;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(CommandStreamBenchmark "/root/repo/_debug_build/CommandStreamBenchmark" "--quick")
+set_tests_properties(CommandStreamBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;163;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(ShaderHotReloadTests "/root/repo/_debug_build/ShaderHotReloadTests")
+set_tests_properties(ShaderHotReloadTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;165;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(TaskGraphTests "/root/repo/_debug_build/TaskGraphTests")
+set_tests_properties(TaskGraphTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;167;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(TaskGraphBenchmark "/root/repo/_debug_build/TaskGraphBenchmark" "--quick")
+set_tests_properties(TaskGraphBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;168;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(RootSignatureBuilderTests "/root/repo/_debug_build/RootSignatureBuilderTests")
+set_tests_properties(RootSignatureBuilderTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;170;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(ShaderCacheTests "/root/repo/_debug_build/ShaderCacheTests")
+set_tests_properties(ShaderCacheTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;172;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(ShaderCacheBenchmark "/root/repo/_debug_build/ShaderCacheBenchmark" "--quick")
+set_tests_properties(ShaderCacheBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;173;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(ResourceStateTrackerTests "/root/repo/_debug_build/ResourceStateTrackerTests")
+set_tests_properties(ResourceStateTrackerTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;175;add_portable_test;/root/repo/CMakeLists.txt;0;")
+add_test(CommandRecorderBenchmark "/root/repo/_debug_build/CommandRecorderBenchmark" "--quick")
+set_tests_properties(CommandRecorderBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;177;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(ProfilerBenchmark "/root/repo/_debug_build/ProfilerBenchmark" "--quick")
+set_tests_properties(ProfilerBenchmark PROPERTIES  LABELS "benchmark" _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;85;add_test;/root/repo/CMakeLists.txt;179;add_portable_benchmark;/root/repo/CMakeLists.txt;0;")
+add_test(ReadbackRingTests "/root/repo/_debug_build/ReadbackRingTests")
+set_tests_properties(ReadbackRingTests PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;75;add_test;/root/repo/CMakeLists.txt;181;add_portable_test;/root/repo/CMakeLists.txt;0;")
@@ -0,0 +1,67 @@
+// Separable blur, one dispatch per direction. The arithmetic is the one of
+// BlurFilter on the CPU: 8-bit inputs, 1.15 fixed point weights summing to
+// 32768 and a rounding to 8 bits after each pass, so both agree bit for bit.
+
+#define GROUP_SIZE 256
+#define MAX_RADIUS 32
+
+cbuffer BlurKernel : register(b0)
+{
+    uint  radius;
+    uint3 padding;
+    uint4 weights[(2 * MAX_RADIUS + 1 + 3) / 4];
+};
+
+cbuffer BlurPass : register(b1)
+{
+    int2 direction;     // (1, 0) blurs the rows, (0, 1) the columns.
+    int2 size;          // Blurred corner of the textures, smaller than them under dynamic resolution.
+};
+
+Texture2D<float4> source : register(t0);
+RWTexture2D<float4> destination : register(u0);
+
+// A line of GROUP_SIZE pixels along the direction, plus the radius on each side.
+groupshared uint tile[GROUP_SIZE + 2 * MAX_RADIUS];
+
+uint Pack(float4 color)
+{
+    uint4 c = uint4(round(saturate(color) * 255.0f));
+    return c.r | (c.g << 8) | (c.b << 16) | (c.a << 24);
+}
+
+uint4 Unpack(uint c)
+{
+    return uint4(c & 0xff, (c >> 8) & 0xff, (c >> 16) & 0xff, c >> 24);
+}
+
+// Dispatched as (ceil(length / GROUP_SIZE), lines, 1).
+[numthreads(GROUP_SIZE, 1, 1)]
+void CSMain(uint3 groupId : SV_GroupID, uint groupIndex : SV_GroupIndex)
+{
+    const int length = direction.x ? size.x : size.y;
+    const int2 lineStart = (int2(1, 1) - direction) * groupId.y;
+    const int first = int(groupId.x * GROUP_SIZE) - int(radius);
+
+    // Every thread loads one or two pixels, clamped to the edges.
+    for (uint i = groupIndex; i < GROUP_SIZE + 2 * radius; i += GROUP_SIZE)
+    {
+        const int along = clamp(first + int(i), 0, length - 1);
+        tile[i] = Pack(source[uint2(direction * along + lineStart)]);
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    const int along = int(groupId.x * GROUP_SIZE + groupIndex);
+    if (along >= length)
+    {
+        return;
+    }
+
+    uint4 sum = 1 << 14;
+    for (uint tap = 0; tap <= 2 * radius; ++tap)
+    {
+        sum += Unpack(tile[groupIndex + tap]) * weights[tap >> 2][tap & 3];
+    }
+
+    destination[uint2(direction * along + lineStart)] = float4(sum >> 15) / 255.0f;
+}
@@ -13,7 +13,8 @@
 cbuffer ConstantBuffer : register(b0)
 {
     float4 solidColor;
-    float4 padding[15];
+    float4 sceneUv;
+    float4 textureWeight;
 };
 
 Texture2D t1 : register(t0);
@@ -37,10 +38,7 @@ PSInput VSMain(float4 position : POSITION, float2 uv : TEXCOORD)
 
 float4 PSMain(PSInput input) : SV_TARGET
 {
-    float2 pixelSize;
-    t1.GetDimensions(0, pixelSize.x, pixelSize.y);
-
-    return t1.Sample(s1, input.uv);
+    return t1.Sample(s1, min(input.uv * sceneUv.xy, sceneUv.zw));
     //return float4(input.uv.x, input.uv.y, 0.0, 1.0); //return solidColor;
     //return input.color;
 }
@@ -12,27 +12,50 @@
 cbuffer ConstantBuffer : register(b0)
 {
     float4 solidColor;
-    float4 padding[15];
+    float4 sceneUv;
+    float4 textureWeight;
 };
 
+// The mips streamed in so far, null until the first ones are.
+Texture2D diffuse : register(t0);
+SamplerState linearSampler : register(s0);
+
+// InstanceData of InstanceCulling.h, only the visible instances.
+struct Instance
+{
+    float2 position;
+    float  scale;
+    float  rotation;
+    float4 color;
+};
+
+StructuredBuffer<Instance> instances : register(t1);
+
 struct PSInput
 {
     float4 position : SV_POSITION;
     float4 color : COLOR;
+    float2 uv : TEXCOORD;
 };
 
-PSInput VSMain(float4 position : POSITION, float4 color : COLOR)
+PSInput VSMain(float4 position : POSITION, float4 color : COLOR, uint instanceId : SV_InstanceID)
 {
     PSInput result;
 
-    result.position = position;
-    result.color = color;
+    const Instance instance = instances[instanceId];
+    float s, c;
+    sincos(instance.rotation, s, c);
+    const float2 scaled = position.xy * instance.scale;
+
+    result.position = float4(scaled.x * c - scaled.y * s + instance.position.x, scaled.x * s + scaled.y * c + instance.position.y, position.zw);
+    result.color = instance.color * solidColor;
+    // The triangle spans a quarter of the screen around its origin, the texture all of it.
+    result.uv = position.xy * float2(2.0f, -2.0f) + 0.5f;
 
     return result;
 }
 
 float4 PSMain(PSInput input) : SV_TARGET
 {
-    return solidColor;
-    //return input.color;
+    return input.color * lerp(float4(1.0f, 1.0f, 1.0f, 1.0f), diffuse.Sample(linearSampler, input.uv), textureWeight.x);
 }
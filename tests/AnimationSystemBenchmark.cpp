@@ -0,0 +1,51 @@
+#include "AnimationSystem.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+// Parameters animated per second by Update and UpdateReference, with the
+// three curves mixed in equal parts.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t counts[] = { 3, 1000, 10000, 100000, 1000000 };
+
+    printf("%s\n", AnimationSystem::GetSimdName());
+    printf("%-10s %16s %16s %8s\n", "params", "updated/s", "reference/s", "speedup");
+
+    for (uint32_t count : counts)
+    {
+        AnimationSystem system;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            system.Add(0.0f, 1.0f + (i % 7), 0.5f + (i % 11), static_cast<AnimationCurve>(i % 3), (i % 13) / 13.0f);
+        }
+        std::vector<float> values(count);
+
+        // About 100M parameters per version.
+        const uint32_t iterations = quick ? 1 : 100000000 / count;
+        double seconds[2] = {};
+        for (uint32_t version = 0; version < 2; ++version)
+        {
+            BenchmarkTimer timer;
+            for (uint32_t i = 0; i < iterations; ++i)
+            {
+                if (version == 0)
+                {
+                    system.Update(0.016f, values.data());
+                }
+                else
+                {
+                    system.UpdateReference(0.016f, values.data());
+                }
+            }
+            seconds[version] = timer.GetMilliseconds() / 1000.0;
+        }
+        KeepResult(values[count - 1]);
+
+        const double total = static_cast<double>(count) * iterations;
+        printf("%-10u %16.0f %16.0f %7.2fx\n", count, total / seconds[0], total / seconds[1], seconds[1] / seconds[0]);
+    }
+    return 0;
+}
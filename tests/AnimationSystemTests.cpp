@@ -0,0 +1,174 @@
+#include "AnimationSystem.h"
+#include "TestHarness.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed) {}
+
+        // Uniform in [0, 1).
+        float Next()
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return static_cast<float>(m_state >> 8) / 16777216.0f;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+    // Two systems with the same count random parameters of every curve.
+    void AddRandom(AnimationSystem& first, AnimationSystem& second, uint32_t count, uint32_t seed)
+    {
+        Random random(seed);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const float from = random.Next() * 2.0f - 1.0f;
+            const float to = random.Next() * 10.0f;
+            const float period = 0.05f + random.Next() * 10.0f;
+            const float phase = random.Next() * 3.0f;
+            const AnimationCurve curve = static_cast<AnimationCurve>(i % 3);
+            first.Add(from, to, period, curve, phase);
+            second.Add(from, to, period, curve, phase);
+        }
+    }
+}
+
+TEST(CurvesFollowTheirDefinition)
+{
+    AnimationSystem system;
+    system.Add(2.0f, 6.0f, 4.0f, AnimationCurveLinear);
+    system.Add(2.0f, 6.0f, 4.0f, AnimationCurvePingPong);
+    system.Add(2.0f, 6.0f, 4.0f, AnimationCurveEased);
+    CHECK_EQUAL(3u, system.GetCount());
+
+    float values[3] = {};
+    system.Update(0.0f, values);
+    CHECK_NEAR(2.0f, values[0], 1e-6f);
+    CHECK_NEAR(2.0f, values[1], 1e-6f);
+    CHECK_NEAR(2.0f, values[2], 1e-6f);
+
+    // A quarter of the cycle: the ping-pong is halfway up, the eased one at
+    // smoothstep(0.5).
+    system.Update(1.0f, values);
+    CHECK_NEAR(3.0f, values[0], 1e-6f);
+    CHECK_NEAR(4.0f, values[1], 1e-6f);
+    CHECK_NEAR(4.0f, values[2], 1e-6f);
+
+    system.Update(1.0f, values);
+    CHECK_NEAR(4.0f, values[0], 1e-6f);
+    CHECK_NEAR(6.0f, values[1], 1e-6f);
+    CHECK_NEAR(6.0f, values[2], 1e-6f);
+
+    // Five eighths: the eased one is still slow after the top.
+    system.Update(0.5f, values);
+    CHECK_NEAR(4.5f, values[0], 1e-6f);
+    CHECK_NEAR(5.0f, values[1], 1e-6f);
+    CHECK_NEAR(2.0f + 4.0f * 0.84375f, values[2], 1e-6f);
+
+    // Past the end of the cycle the linear one starts over, the ping-pong
+    // is on its way up again.
+    system.Update(1.0f, values);
+    system.Update(1.0f, values);
+    CHECK_NEAR(2.5f, values[0], 1e-5f);
+    CHECK_NEAR(3.0f, values[1], 1e-5f);
+}
+
+TEST(PhaseStartsTheCycleAndWraps)
+{
+    AnimationSystem system;
+    system.Add(0.0f, 1.0f, 2.0f, AnimationCurvePingPong, 0.5f);
+    system.Add(0.0f, 1.0f, 2.0f, AnimationCurveLinear, 1.25f);
+    system.Add(0.0f, 1.0f, 2.0f, AnimationCurveLinear, -0.25f);
+
+    float values[3] = {};
+    system.Update(0.0f, values);
+    CHECK_NEAR(1.0f, values[0], 1e-6f);
+    CHECK_NEAR(0.25f, values[1], 1e-6f);
+    CHECK_NEAR(0.75f, values[2], 1e-6f);
+
+    system.Update(0.5f, values);
+    CHECK_NEAR(0.5f, values[0], 1e-6f);
+    CHECK_NEAR(0.5f, values[1], 1e-6f);
+    CHECK_NEAR(0.0f, values[2], 1e-6f);
+}
+
+TEST(StepIsClampedToMaxStep)
+{
+    AnimationSystem system;
+    system.Add(0.0f, 100.0f, 100.0f, AnimationCurveLinear);
+
+    float value = 0.0f;
+    system.Update(30.0f, &value);
+    CHECK_NEAR(AnimationSystem::MaxStepSeconds, value, 1e-4f);
+
+    // Time never runs backwards.
+    system.Update(-5.0f, &value);
+    CHECK_NEAR(AnimationSystem::MaxStepSeconds, value, 1e-4f);
+}
+
+TEST(MatchesTheReferenceBitForBit)
+{
+    // Counts around the groups of four and eight of the SIMD kernels.
+    const uint32_t counts[] = { 0, 1, 3, 4, 5, 7, 8, 9, 12, 15, 16, 17, 1001 };
+    for (uint32_t count : counts)
+    {
+        AnimationSystem system;
+        AnimationSystem reference;
+        AddRandom(system, reference, count, count + 1);
+
+        std::vector<float> values(count + 1, -1.0f);
+        std::vector<float> expected(count + 1, -1.0f);
+        for (uint32_t frame = 0; frame < 200; ++frame)
+        {
+            // Frame times of a running sample, a hitch and a clamped stall.
+            float elapsed = 0.016f + 0.002f * (frame % 5);
+            elapsed = frame == 50 ? 0.3f : frame == 100 ? 5.0f : elapsed;
+
+            system.Update(elapsed, values.data());
+            reference.UpdateReference(elapsed, expected.data());
+            CHECK(count == 0 || memcmp(expected.data(), values.data(), count * sizeof(float)) == 0);
+        }
+        CHECK_EQUAL(-1.0f, values[count]);
+    }
+}
+
+TEST(ValuesStayBetweenTheirEnds)
+{
+    AnimationSystem system;
+    AnimationSystem reference;
+    AddRandom(system, reference, 333, 17);
+
+    std::vector<float> values(system.GetCount());
+    for (uint32_t frame = 0; frame < 500; ++frame)
+    {
+        system.Update(0.0137f * (1 + frame % 7), values.data());
+        for (uint32_t i = 0; i < system.GetCount(); i += 37)
+        {
+            CHECK(values[i] >= -1.0f && values[i] <= 10.0f);
+        }
+    }
+}
+
+TEST(AddRejectsBadPeriodsAndClearEmpties)
+{
+    AnimationSystem system;
+    CHECK_THROWS(system.Add(0.0f, 1.0f, 0.0f, AnimationCurveLinear), std::invalid_argument);
+    CHECK_THROWS(system.Add(0.0f, 1.0f, -1.0f, AnimationCurveLinear), std::invalid_argument);
+    CHECK_THROWS(system.Add(0.0f, 1.0f, std::numeric_limits<float>::quiet_NaN(), AnimationCurveLinear), std::invalid_argument);
+    CHECK_EQUAL(0u, system.GetCount());
+
+    CHECK_EQUAL(0u, system.Add(0.0f, 1.0f, 1.0f, AnimationCurveLinear));
+    CHECK_EQUAL(1u, system.Add(0.0f, 1.0f, 1.0f, AnimationCurveEased));
+    system.Clear();
+    CHECK_EQUAL(0u, system.GetCount());
+    CHECK_EQUAL(0u, system.Add(0.0f, 1.0f, 1.0f, AnimationCurveLinear));
+}
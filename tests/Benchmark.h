@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstring>
+
+// The benchmarks print their results as a table. ctest runs them with --quick,
+// a few iterations so they keep building and working; run them by hand
+// without it for numbers.
+inline bool IsQuickBenchmark(int argc, char** argv)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+class BenchmarkTimer
+{
+public:
+    BenchmarkTimer() : m_start(Clock::now()) {}
+
+    void Restart()              { m_start = Clock::now(); }
+    double GetMilliseconds() const
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - m_start).count();
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    Clock::time_point m_start;
+};
+
+// Keeps the optimizer from dropping a result the benchmark does not otherwise use.
+template<typename T>
+inline void KeepResult(const T& value)
+{
+    volatile T sink = value;
+    (void)sink;
+}
@@ -0,0 +1,49 @@
+#include "BlurFilter.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+// Megapixels per second of both passes over a 1080p frame, for a few radii,
+// against the plain reference.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t width = quick ? 256 : 1920;
+    const uint32_t height = quick ? 144 : 1080;
+    const uint32_t iterations = quick ? 1 : 5;
+
+    std::vector<uint8_t> source(static_cast<size_t>(width) * height * 4);
+    uint32_t state = 1;
+    for (uint8_t& value : source)
+    {
+        state = state * 1664525u + 1013904223u;
+        value = static_cast<uint8_t>(state >> 24);
+    }
+    std::vector<uint8_t> destination(source.size());
+
+    printf("%ux%u, SIMD %s\n", width, height, BlurFilter::HasSimd() ? "on" : "off");
+    printf("%8s %12s %12s %12s\n", "radius", "ms", "Mpix/s", "ref Mpix/s");
+    const uint32_t radii[] = { 1, 2, 4, 8, 16, 32 };
+    for (uint32_t radius : radii)
+    {
+        BlurFilter filter(BlurKernel::Gaussian(radius));
+        filter.Apply(source.data(), width * 4, destination.data(), width * 4, width, height);
+
+        BenchmarkTimer timer;
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            filter.Apply(source.data(), width * 4, destination.data(), width * 4, width, height);
+        }
+        const double milliseconds = timer.GetMilliseconds() / iterations;
+
+        timer.Restart();
+        filter.ApplyReference(source.data(), width * 4, destination.data(), width * 4, width, height);
+        const double referenceMilliseconds = timer.GetMilliseconds();
+        KeepResult(destination[destination.size() / 2]);
+
+        const double megapixels = static_cast<double>(width) * height / 1e6;
+        printf("%8u %12.2f %12.1f %12.1f\n", radius, milliseconds, megapixels / milliseconds * 1000.0, megapixels / referenceMilliseconds * 1000.0);
+    }
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include "BlurFilter.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed) {}
+
+        uint8_t NextByte()
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return static_cast<uint8_t>(m_state >> 24);
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+    std::vector<uint8_t> RandomImage(size_t pitch, uint32_t height, uint32_t seed)
+    {
+        Random random(seed);
+        std::vector<uint8_t> image(pitch * height);
+        for (uint8_t& value : image)
+        {
+            value = random.NextByte();
+        }
+        return image;
+    }
+
+    // One direction of blur.hlsl, group by group and thread by thread: the
+    // tile of GROUP_SIZE + 2 * radius clamped pixels, the 1.15 weights and
+    // the rounding of the shader. Texels go through the UNORM conversion both
+    // ways, which is exact for 8-bit values.
+    void EmulateBlurShader(const BlurKernel& kernel, const std::vector<uint8_t>& source, std::vector<uint8_t>& destination, uint32_t pitchPixels,
+        int32_t width, int32_t height, bool vertical)
+    {
+        const uint32_t GroupSize = 256;
+        const int32_t radius = static_cast<int32_t>(kernel.GetRadius());
+        const int32_t length = vertical ? height : width;
+        const int32_t lines = vertical ? width : height;
+        const uint32_t groups = (static_cast<uint32_t>(length) + GroupSize - 1) / GroupSize;
+
+        std::vector<uint32_t> tile(GroupSize + 2 * BlurKernel::MaxRadius);
+        for (int32_t line = 0; line < lines; ++line)
+        {
+            for (uint32_t group = 0; group < groups; ++group)
+            {
+                const int32_t first = static_cast<int32_t>(group * GroupSize) - radius;
+                for (uint32_t i = 0; i < GroupSize + 2 * static_cast<uint32_t>(radius); ++i)
+                {
+                    const int32_t along = std::min<int32_t>(std::max<int32_t>(first + static_cast<int32_t>(i), 0), length - 1);
+                    const uint32_t pixel = vertical ? along * pitchPixels + line : line * pitchPixels + along;
+                    uint32_t packed = 0;
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        const float texel = source[pixel * 4 + c] / 255.0f;
+                        packed |= static_cast<uint32_t>(std::floor(std::min<float>(std::max<float>(texel, 0.0f), 1.0f) * 255.0f + 0.5f)) << (8 * c);
+                    }
+                    tile[i] = packed;
+                }
+
+                for (uint32_t thread = 0; thread < GroupSize; ++thread)
+                {
+                    const int32_t along = static_cast<int32_t>(group * GroupSize + thread);
+                    if (along >= length)
+                    {
+                        break;
+                    }
+
+                    uint32_t sum[4] = { 1 << 14, 1 << 14, 1 << 14, 1 << 14 };
+                    for (uint32_t tap = 0; tap <= 2 * static_cast<uint32_t>(radius); ++tap)
+                    {
+                        for (uint32_t c = 0; c < 4; ++c)
+                        {
+                            sum[c] += ((tile[thread + tap] >> (8 * c)) & 0xff) * kernel.GetWeights()[tap];
+                        }
+                    }
+
+                    const uint32_t pixel = vertical ? along * pitchPixels + line : line * pitchPixels + along;
+                    for (uint32_t c = 0; c < 4; ++c)
+                    {
+                        const float value = static_cast<float>(sum[c] >> 15) / 255.0f;
+                        destination[pixel * 4 + c] = static_cast<uint8_t>(std::floor(value * 255.0f + 0.5f));
+                    }
+                }
+            }
+        }
+    }
+
+    // FNV-1a, to pin the output of a fixed input.
+    uint32_t HashBytes(const std::vector<uint8_t>& bytes)
+    {
+        uint32_t hash = 2166136261u;
+        for (uint8_t value : bytes)
+        {
+            hash = (hash ^ value) * 16777619u;
+        }
+        return hash;
+    }
+}
+
+TEST(KernelsSumToOne)
+{
+    for (uint32_t radius = 0; radius <= BlurKernel::MaxRadius; ++radius)
+    {
+        const BlurKernel kernels[] = { BlurKernel::Box(radius), BlurKernel::Gaussian(radius), BlurKernel::Gaussian(radius, 2.5) };
+        for (const BlurKernel& kernel : kernels)
+        {
+            uint32_t sum = 0;
+            for (uint32_t tap = 0; tap < kernel.GetTapCount(); ++tap)
+            {
+                sum += kernel.GetWeights()[tap];
+            }
+            CHECK_EQUAL(1u << BlurKernel::WeightBits, sum);
+            CHECK_EQUAL(radius, kernel.GetRadius());
+        }
+    }
+
+    CHECK_THROWS(BlurKernel::Box(BlurKernel::MaxRadius + 1), std::invalid_argument);
+    CHECK_THROWS(BlurKernel::Gaussian(BlurKernel::MaxRadius + 1), std::invalid_argument);
+}
+
+TEST(ApplyMatchesTheReferenceBitForBit)
+{
+    const uint32_t radii[] = { 0, 1, 3, 8, 32 };
+    const uint32_t sizes[][2] = { { 1, 1 }, { 7, 3 }, { 33, 17 }, { 64, 64 }, { 300, 5 } };
+    for (uint32_t radius : radii)
+    {
+        for (uint32_t gaussian = 0; gaussian < 2; ++gaussian)
+        {
+            BlurFilter filter(gaussian ? BlurKernel::Gaussian(radius) : BlurKernel::Box(radius));
+            for (const uint32_t* size : sizes)
+            {
+                const uint32_t width = size[0];
+                const uint32_t height = size[1];
+                const size_t pitch = width * 4 + 12;
+                const std::vector<uint8_t> source = RandomImage(pitch, height, radius * 100 + width);
+
+                std::vector<uint8_t> simd(width * 4 * height);
+                std::vector<uint8_t> reference(width * 4 * height);
+                filter.Apply(source.data(), pitch, simd.data(), width * 4, width, height);
+                filter.ApplyReference(source.data(), pitch, reference.data(), width * 4, width, height);
+                CHECK(simd == reference);
+
+                // In place gives the same result.
+                std::vector<uint8_t> inPlace = source;
+                filter.Apply(inPlace.data(), pitch, inPlace.data(), pitch, width, height);
+                for (uint32_t y = 0; y < height; ++y)
+                {
+                    CHECK(memcmp(&inPlace[y * pitch], &reference[y * width * 4], width * 4) == 0);
+                }
+            }
+        }
+    }
+}
+
+TEST(FlatImagesAreUnchanged)
+{
+    BlurFilter filter(BlurKernel::Gaussian(9));
+    std::vector<uint8_t> flat(40 * 30 * 4, 77);
+    std::vector<uint8_t> result(flat.size());
+    filter.Apply(flat.data(), 160, result.data(), 160, 40, 30);
+    CHECK(result == flat);
+}
+
+// blur.hlsl, emulated one direction at a time over the blurred corner of a
+// larger texture as under dynamic resolution, gives the bytes of the filter.
+TEST(ComputeShaderArithmeticMatchesTheFilter)
+{
+    const uint32_t radii[] = { 1, 4, 32 };
+    for (uint32_t radius : radii)
+    {
+        const BlurKernel kernel = BlurKernel::Gaussian(radius);
+        const uint32_t textureWidth = 600;
+        const uint32_t textureHeight = 40;
+        const uint32_t width = 517;
+        const uint32_t height = 31;
+
+        const std::vector<uint8_t> texture = RandomImage(textureWidth * 4, textureHeight, radius);
+        std::vector<uint8_t> temp(texture.size(), 0);
+        std::vector<uint8_t> shader(texture.size(), 0);
+        EmulateBlurShader(kernel, texture, temp, textureWidth, width, height, false);
+        EmulateBlurShader(kernel, temp, shader, textureWidth, width, height, true);
+
+        BlurFilter filter(kernel);
+        std::vector<uint8_t> cpu(width * 4 * height);
+        filter.Apply(texture.data(), textureWidth * 4, cpu.data(), width * 4, width, height);
+
+        bool same = true;
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            same &= memcmp(&shader[y * textureWidth * 4], &cpu[y * width * 4], width * 4) == 0;
+        }
+        CHECK(same);
+    }
+}
+
+// The output of a fixed input, so a change to the arithmetic on any platform
+// shows up even when Apply and ApplyReference change together.
+TEST(OutputOfAFixedInputIsPinned)
+{
+    const std::vector<uint8_t> source = RandomImage(64 * 4, 48, 2024);
+    std::vector<uint8_t> result(source.size());
+
+    BlurFilter gaussian(BlurKernel::Gaussian(5));
+    gaussian.Apply(source.data(), 64 * 4, result.data(), 64 * 4, 64, 48);
+    const uint32_t gaussianHash = HashBytes(result);
+
+    BlurFilter box(BlurKernel::Box(2));
+    box.Apply(source.data(), 64 * 4, result.data(), 64 * 4, 64, 48);
+    const uint32_t boxHash = HashBytes(result);
+
+    CHECK_EQUAL(30003873u, gaussianHash);
+    CHECK_EQUAL(219896968u, boxHash);
+}
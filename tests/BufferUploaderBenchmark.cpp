@@ -0,0 +1,119 @@
+#include "BufferUploader.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    // Copy queue that is always done, what is left is the cost of staging.
+    class IdleFrameQueue : public IFrameQueue
+    {
+    public:
+        IdleFrameQueue() : m_value(0) {}
+
+        virtual void Signal(uint64_t fenceValue)    { m_value = fenceValue; }
+        virtual uint64_t GetCompletedValue()        { return m_value; }
+        virtual void WaitForValue(uint64_t)         {}
+
+    private:
+        uint64_t m_value;
+    };
+
+    void Report(const char* name, const BufferUploader& uploader, double milliseconds)
+    {
+        const BufferUploaderStats stats = uploader.GetStats();
+        printf("%-18s %10.0f %10.0f %10llu %8llu\n", name, stats.bytes / 1e6 / milliseconds * 1000.0, stats.uploads / milliseconds * 1000.0,
+            static_cast<unsigned long long>(stats.submissions), static_cast<unsigned long long>(stats.stagingWaits));
+    }
+}
+
+// Upload throughput through a 4MB staging ring into CPU memory: buffers from
+// 256 bytes to 16MB flushed every 64 uploads, a 2048x2048 RGBA8 texture, and
+// the same buffers against a copy queue taking 1 ms per batch.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint64_t stagingSize = 4 * 1024 * 1024;
+    const uint64_t totalBytes = quick ? 8 * 1024 * 1024 : 512 * 1024 * 1024;
+
+    std::vector<uint8_t> staging(stagingSize);
+    std::vector<uint8_t> source(16 * 1024 * 1024, 0x5a);
+    std::vector<uint8_t> destination(source.size());
+
+    printf("%-18s %10s %10s %10s %8s\n", "upload", "MB/s", "uploads/s", "batches", "waits");
+    const uint64_t sizes[] = { 256, 4096, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024 };
+    for (uint64_t size : sizes)
+    {
+        RecordingUploadBackend backend(staging.data());
+        IdleFrameQueue queue;
+        BufferUploader uploader(backend, queue, staging.data(), stagingSize);
+
+        const uint64_t count = std::max<uint64_t>(totalBytes / size, 1);
+        BenchmarkTimer timer;
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uploader.Upload(destination.data(), 0, source.data(), size);
+            if (i % 64 == 63)
+            {
+                uploader.Flush();
+            }
+        }
+        uploader.WaitForIdle();
+        const double milliseconds = timer.GetMilliseconds();
+
+        char name[32];
+        if (size < 1024)
+        {
+            snprintf(name, sizeof(name), "buffer %llu B", static_cast<unsigned long long>(size));
+        }
+        else
+        {
+            snprintf(name, sizeof(name), "buffer %llu KB", static_cast<unsigned long long>(size / 1024));
+        }
+        Report(name, uploader, milliseconds);
+    }
+
+    {
+        const TextureDesc desc = { TextureDimension2D, 28, quick ? 256u : 2048u, quick ? 256u : 2048u, 1, 1, 1, false };
+        RecordingTexture texture;
+        texture.footprints.resize(1);
+        texture.data.resize(static_cast<size_t>(GetCopyableFootprints(desc, 0, 1, 0, texture.footprints.data())));
+
+        RecordingUploadBackend backend(staging.data());
+        IdleFrameQueue queue;
+        BufferUploader uploader(backend, queue, staging.data(), stagingSize);
+        const TextureFootprint& footprint = texture.footprints[0];
+        const uint32_t count = quick ? 2 : 32;
+
+        BenchmarkTimer timer;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uploader.UploadTexture(&texture, 0, footprint, source.data(), footprint.rowSize, footprint.rowSize * footprint.rowCount);
+        }
+        uploader.WaitForIdle();
+        Report("texture", uploader, timer.GetMilliseconds());
+    }
+
+    {
+        RecordingUploadBackend backend(staging.data());
+        SimulatedFrameQueue queue(std::chrono::milliseconds(1));
+        BufferUploader uploader(backend, queue, staging.data(), stagingSize);
+        const uint32_t count = quick ? 64 : 4096;
+
+        BenchmarkTimer timer;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uploader.Upload(destination.data(), 0, source.data(), 256 * 1024);
+            if (i % 4 == 3)
+            {
+                uploader.Flush();
+            }
+        }
+        uploader.WaitForIdle();
+        Report("1 ms copy queue", uploader, timer.GetMilliseconds());
+    }
+    return 0;
+}
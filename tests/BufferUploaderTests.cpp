@@ -0,0 +1,274 @@
+#include "BufferUploader.h"
+#include "TestHarness.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Copy queue that only completes what is waited for.
+    class ManualFrameQueue : public IFrameQueue
+    {
+    public:
+        ManualFrameQueue() : completedValue(0) {}
+
+        virtual void Signal(uint64_t fenceValue)            { signals.push_back(fenceValue); }
+        virtual uint64_t GetCompletedValue()                { return completedValue; }
+        virtual void WaitForValue(uint64_t fenceValue)
+        {
+            waits.push_back(fenceValue);
+            completedValue = fenceValue > completedValue ? fenceValue : completedValue;
+        }
+
+        uint64_t completedValue;
+        std::vector<uint64_t> signals;
+        std::vector<uint64_t> waits;
+    };
+
+    std::vector<uint8_t> Pattern(size_t size, uint32_t seed)
+    {
+        std::vector<uint8_t> data(size);
+        uint32_t state = seed;
+        for (uint8_t& value : data)
+        {
+            state = state * 1664525u + 1013904223u;
+            value = static_cast<uint8_t>(state >> 24);
+        }
+        return data;
+    }
+
+    // Every subresource of desc laid out in CPU memory like a GPU texture.
+    RecordingTexture CreateTexture(const TextureDesc& desc)
+    {
+        RecordingTexture texture;
+        const uint32_t count = desc.mipCount * desc.arraySize;
+        texture.footprints.resize(count);
+        texture.data.assign(static_cast<size_t>(GetCopyableFootprints(desc, 0, count, 0, texture.footprints.data())), 0);
+        return texture;
+    }
+
+    // Uploads subresource 0 from rows sourceRowPitch apart and checks every
+    // row of every slice arrives. Returns the copies it took.
+    uint64_t CheckTextureUpload(const TextureDesc& desc, uint64_t stagingSize, uint64_t maxChunkSize)
+    {
+        std::vector<uint8_t> staging(static_cast<size_t>(stagingSize));
+        RecordingUploadBackend backend(staging.data());
+        ManualFrameQueue queue;
+        BufferUploader uploader(backend, queue, staging.data(), stagingSize, maxChunkSize);
+
+        RecordingTexture texture = CreateTexture(desc);
+        const TextureFootprint& footprint = texture.footprints[0];
+        const uint64_t sourceRowPitch = footprint.rowSize + 24;
+        const uint64_t sourceSlicePitch = sourceRowPitch * footprint.rowCount;
+        const std::vector<uint8_t> source = Pattern(static_cast<size_t>(sourceSlicePitch * footprint.depth), desc.width);
+
+        uploader.UploadTexture(&texture, 0, footprint, source.data(), sourceRowPitch, sourceSlicePitch);
+        uploader.WaitForIdle();
+
+        bool same = true;
+        for (uint32_t slice = 0; slice < footprint.depth; ++slice)
+        {
+            for (uint32_t row = 0; row < footprint.rowCount; ++row)
+            {
+                const uint8_t* expected = source.data() + slice * sourceSlicePitch + row * sourceRowPitch;
+                const uint8_t* actual = texture.data.data() + footprint.offset + (static_cast<uint64_t>(slice) * footprint.rowCount + row) * footprint.rowPitch;
+                same &= memcmp(expected, actual, static_cast<size_t>(footprint.rowSize)) == 0;
+            }
+        }
+        CHECK(same);
+        return uploader.GetStats().copies;
+    }
+}
+
+TEST(RejectsInvalidArguments)
+{
+    std::vector<uint8_t> staging(1024);
+    RecordingUploadBackend backend(staging.data());
+    ManualFrameQueue queue;
+    CHECK_THROWS(BufferUploader(backend, queue, nullptr, 1024), std::invalid_argument);
+    CHECK_THROWS(BufferUploader(backend, queue, staging.data(), 1024, 2048), std::invalid_argument);
+    CHECK_THROWS(BufferUploader(backend, queue, staging.data(), 2), std::invalid_argument);
+}
+
+TEST(DataArrivesWithItsBatch)
+{
+    std::vector<uint8_t> staging(4096);
+    RecordingUploadBackend backend(staging.data());
+    ManualFrameQueue queue;
+    BufferUploader uploader(backend, queue, staging.data(), staging.size());
+
+    const std::vector<uint8_t> a = Pattern(100, 1);
+    const std::vector<uint8_t> b = Pattern(200, 2);
+    std::vector<uint8_t> destination(400, 0);
+    CHECK_EQUAL(1ull, uploader.Upload(destination.data(), 0, a.data(), a.size()));
+    CHECK_EQUAL(1ull, uploader.Upload(destination.data(), 150, b.data(), b.size()));
+    CHECK_EQUAL(2ull, uploader.GetPendingCopyCount());
+    CHECK_EQUAL(0u, backend.GetSubmitCount());
+    CHECK(destination[0] == 0);
+
+    // Both go out as one batch signalling the value they returned.
+    CHECK_EQUAL(1ull, uploader.Flush());
+    CHECK_EQUAL(1u, backend.GetSubmitCount());
+    CHECK_EQUAL(2ull, backend.GetLargestBatch());
+    CHECK_EQUAL(1u, queue.signals.size());
+    CHECK(memcmp(destination.data(), a.data(), a.size()) == 0);
+    CHECK(memcmp(destination.data() + 150, b.data(), b.size()) == 0);
+
+    // Nothing pending: no submission, the last value.
+    CHECK_EQUAL(1ull, uploader.Flush());
+    CHECK_EQUAL(1u, backend.GetSubmitCount());
+    CHECK(!uploader.IsComplete(1));
+    queue.completedValue = 1;
+    CHECK(uploader.IsComplete(1));
+    CHECK_EQUAL(2ull, uploader.Upload(destination.data(), 0, b.data(), 10));
+}
+
+TEST(FenceValuesStartAfterTheCompletedValue)
+{
+    std::vector<uint8_t> staging(1024);
+    RecordingUploadBackend backend(staging.data());
+    ManualFrameQueue queue;
+    queue.completedValue = 9;
+    BufferUploader uploader(backend, queue, staging.data(), staging.size());
+
+    uint8_t value = 7;
+    CHECK_EQUAL(10ull, uploader.Upload(&value, 0, &value, 1));
+    CHECK_EQUAL(10ull, uploader.Flush());
+}
+
+TEST(LargeUploadsAreSplitInChunks)
+{
+    std::vector<uint8_t> staging(1024);
+    RecordingUploadBackend backend(staging.data());
+    ManualFrameQueue queue;
+    BufferUploader uploader(backend, queue, staging.data(), staging.size());
+
+    // 1000 bytes in chunks of a quarter of the ring.
+    const std::vector<uint8_t> data = Pattern(1000, 3);
+    std::vector<uint8_t> destination(1000, 0);
+    uploader.Upload(destination.data(), 0, data.data(), data.size());
+    CHECK_EQUAL(4ull, uploader.GetStats().copies);
+    CHECK_EQUAL(1ull, uploader.GetStats().uploads);
+    CHECK_EQUAL(1000ull, uploader.GetStats().bytes);
+
+    uploader.Flush();
+    CHECK(destination == data);
+}
+
+// A ring of four chunks: uploads larger than the ring go through in several
+// batches, each waiting for the oldest one.
+TEST(WrapsTheRingAndWaitsOnlyWhenItIsFull)
+{
+    std::vector<uint8_t> staging(1024);
+    RecordingUploadBackend backend(staging.data());
+    ManualFrameQueue queue;
+    BufferUploader uploader(backend, queue, staging.data(), staging.size(), 256);
+
+    // Three batches in flight, the ring still has room.
+    std::vector<std::vector<uint8_t>> sources;
+    std::vector<std::vector<uint8_t>> destinations;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        sources.push_back(Pattern(256, 10 + i));
+        destinations.push_back(std::vector<uint8_t>(256, 0));
+        uploader.Upload(destinations.back().data(), 0, sources.back().data(), 256);
+        uploader.Flush();
+    }
+    CHECK(queue.waits.empty());
+
+    // 1000 more bytes: one chunk fits, the next ones wait for batches 1 to 3.
+    sources.push_back(Pattern(1000, 20));
+    destinations.push_back(std::vector<uint8_t>(1000, 0));
+    uploader.Upload(destinations.back().data(), 0, sources.back().data(), 1000);
+    uploader.WaitForIdle();
+
+    const BufferUploaderStats stats = uploader.GetStats();
+    CHECK_EQUAL(3ull, stats.stagingWaits);
+    CHECK_EQUAL(7ull, stats.copies);
+
+    // Each chunk that did not fit submitted the one before it and waited for
+    // the oldest batch; WaitForIdle waited for the last one.
+    const uint64_t waits[] = { 1, 2, 3, 7 };
+    CHECK_EQUAL(4u, queue.waits.size());
+    for (size_t i = 0; i < queue.waits.size() && i < 4; ++i)
+    {
+        CHECK_EQUAL(waits[i], queue.waits[i]);
+    }
+    for (size_t i = 0; i < sources.size(); ++i)
+    {
+        CHECK(sources[i] == destinations[i]);
+    }
+
+    // Every batch got its own fence value.
+    for (size_t i = 1; i < queue.signals.size(); ++i)
+    {
+        CHECK_EQUAL(queue.signals[i - 1] + 1, queue.signals[i]);
+    }
+}
+
+TEST(ManySmallUploadsShareABatch)
+{
+    std::vector<uint8_t> staging(64 * 1024);
+    RecordingUploadBackend backend(staging.data());
+    ManualFrameQueue queue;
+    BufferUploader uploader(backend, queue, staging.data(), staging.size());
+
+    std::vector<uint8_t> destination(100 * 64, 0);
+    const std::vector<uint8_t> data = Pattern(destination.size(), 4);
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        uploader.Upload(destination.data(), i * 64, data.data() + i * 64, 64);
+    }
+    uploader.Flush();
+
+    CHECK_EQUAL(1u, backend.GetSubmitCount());
+    CHECK_EQUAL(100ull, backend.GetLargestBatch());
+    CHECK_EQUAL(0ull, uploader.GetStats().stagingWaits);
+    CHECK(destination == data);
+}
+
+TEST(TexturesGoInBandsOfRows)
+{
+    // RGBA8, 100 x 70: rows of 400 bytes on a 512 pitch.
+    TextureDesc desc = { TextureDimension2D, 28, 100, 70, 1, 1, 1, false };
+
+    // The whole texture fits a chunk: one copy.
+    CHECK_EQUAL(1ull, CheckTextureUpload(desc, 256 * 1024, 0));
+
+    // 16 rows per chunk: 5 bands.
+    CHECK_EQUAL(5ull, CheckTextureUpload(desc, 4 * 16 * 512, 16 * 512));
+
+    // A single row per chunk.
+    CHECK_EQUAL(70ull, CheckTextureUpload(desc, 4 * 512, 512));
+}
+
+TEST(BlockCompressedAndVolumeTextures)
+{
+    // BC1, 64 x 64: 16 rows of blocks of 128 bytes.
+    TextureDesc bc1 = { TextureDimension2D, 71, 64, 64, 1, 1, 1, false };
+    CHECK_EQUAL(4ull, CheckTextureUpload(bc1, 16 * 1024, 4 * 256));
+
+    // A 3D texture goes slice by slice, in bands within each.
+    TextureDesc volume = { TextureDimension3D, 28, 32, 20, 3, 1, 1, false };
+    CHECK_EQUAL(3ull, CheckTextureUpload(volume, 64 * 1024, 0));
+    CHECK_EQUAL(6ull, CheckTextureUpload(volume, 4 * 10 * 256, 10 * 256));
+}
+
+TEST(RejectsRowsLargerThanAChunk)
+{
+    std::vector<uint8_t> staging(1024);
+    RecordingUploadBackend backend(staging.data());
+    ManualFrameQueue queue;
+    BufferUploader uploader(backend, queue, staging.data(), staging.size());
+
+    TextureDesc desc = { TextureDimension2D, 28, 128, 4, 1, 1, 1, false };
+    RecordingTexture texture = CreateTexture(desc);
+    std::vector<uint8_t> source(512 * 4);
+    CHECK_THROWS(uploader.UploadTexture(&texture, 0, texture.footprints[0], source.data(), 512, 2048), std::invalid_argument);
+
+    // Source rows shorter than the texture rows.
+    TextureDesc small = { TextureDimension2D, 28, 16, 4, 1, 1, 1, false };
+    RecordingTexture smallTexture = CreateTexture(small);
+    CHECK_THROWS(uploader.UploadTexture(&smallTexture, 0, smallTexture.footprints[0], source.data(), 32, 128), std::invalid_argument);
+}
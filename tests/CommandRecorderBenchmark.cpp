@@ -0,0 +1,103 @@
+#include "CommandRecorder.h"
+#include "FrameBackend.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct RecordResult
+    {
+        double milliseconds;        // Per frame.
+        uint32_t lists;
+        uint64_t hash;
+    };
+
+    // frameCount frames of drawCount stand-in draws, in batches of
+    // NullFrameBackend::DrawsPerBatch like -headless -draws records them.
+    RecordResult RecordFrames(uint32_t threads, uint32_t drawCount, uint32_t frameCount)
+    {
+        JobSystem jobs(threads);
+        RecordingCommandListBackend backend(jobs.GetThreadCount());
+        ParallelCommandRecorder recorder(jobs, backend);
+
+        const uint32_t batchSize = NullFrameBackend::DrawsPerBatch;
+        const uint32_t batchCount = (drawCount + batchSize - 1) / batchSize;
+        const ParallelCommandRecorder::RecordTask record = [&backend, drawCount, batchSize](uint32_t batch, uint32_t list)
+        {
+            const uint32_t end = std::min<uint32_t>(drawCount, (batch + 1) * batchSize);
+            for (uint32_t draw = batch * batchSize; draw < end; ++draw)
+            {
+                backend.RecordCommand(list, draw);
+            }
+        };
+
+        // One frame to size the lists, then the timed ones.
+        RecordResult result = {};
+        result.lists = recorder.Record(batchCount, record);
+        recorder.ResetStats();
+        for (uint32_t frame = 0; frame < frameCount; ++frame)
+        {
+            recorder.Record(batchCount, record);
+        }
+        result.milliseconds = recorder.GetStats().totalRecordMs / frameCount;
+        result.hash = backend.GetSubmittedHash();
+        return result;
+    }
+}
+
+// CPU time of recording a frame of stand-in draws through
+// ParallelCommandRecorder into RecordingCommandListBackend, from 1 thread to
+// one per core: ms per frame, lists used and the speedup over one thread. The
+// submitted commands are checked to be the same for every thread count.
+//
+//   CommandRecorderBenchmark [--quick] [-threads N]    N cores rather than the machine's
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t frameCount = quick ? 2 : 200;
+    uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (strcmp(argv[i], "-threads") == 0)
+        {
+            cores = std::max(1, atoi(argv[i + 1]));
+        }
+    }
+
+    std::vector<uint32_t> threadCounts;
+    for (uint32_t threads = 1; threads < cores; threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    printf("%-8s %8s %6s %10s %9s\n", "draws", "threads", "lists", "ms/frame", "speedup");
+    const uint32_t drawCounts[] = { 1000, 10000, 100000 };
+    for (uint32_t drawCount : drawCounts)
+    {
+        double singleThreadMs = 0.0;
+        uint64_t singleThreadHash = 0;
+        for (uint32_t threads : threadCounts)
+        {
+            const RecordResult result = RecordFrames(threads, drawCount, frameCount);
+            if (threads == 1)
+            {
+                singleThreadMs = result.milliseconds;
+                singleThreadHash = result.hash;
+            }
+            else if (result.hash != singleThreadHash)
+            {
+                printf("%u threads recorded other commands than 1\n", threads);
+                return 1;
+            }
+            printf("%-8u %8u %6u %10.3f %8.2fx\n", drawCount, threads, result.lists, result.milliseconds, singleThreadMs / result.milliseconds);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "CommandStream.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // A list of many small draws, each with its own constants and vertex
+    // buffer, the shape where the recording overhead per command matters.
+    void RecordDrawHeavyList(CommandStreamWriter& writer, uint32_t drawCount)
+    {
+        const CommandHandle heap = 0x7000;
+        const CommandViewport viewport = { 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+        const CommandRect scissor = { 0, 0, 1280, 720 };
+        writer.SetRootSignature(false, 0x1000);
+        writer.SetDescriptorHeaps(1, &heap);
+        writer.SetViewports(1, &viewport);
+        writer.SetScissorRects(1, &scissor);
+        writer.SetPrimitiveTopology(4);
+
+        uint32_t state = 1;
+        for (uint32_t draw = 0; draw < drawCount; ++draw)
+        {
+            state = state * 1664525u + 1013904223u;
+            writer.SetPipelineState(0x2000 + ((state >> 8) % 4) * 0x100);
+            const uint32_t constants[4] = { draw, state, state >> 8, 0x3f800000u };
+            writer.SetRoot32BitConstants(false, 1, 4, constants, 0);
+            const CommandVertexBufferView view = { 0x100000000ull + draw * 256ull, 84, 28 };
+            writer.SetVertexBuffers(0, 1, &view);
+            writer.SetRootDescriptorTable(false, 2, 0x9000 + ((state >> 8) % 64) * 32);
+            writer.Draw(3, 1, 0, 0);
+        }
+    }
+
+    void PrintRow(const char* name, uint64_t commands, uint64_t bytes, double encodeMilliseconds, double replayMilliseconds)
+    {
+        printf("%-28s %10llu %12.2f %14.1f %14.1f\n", name, static_cast<unsigned long long>(commands),
+            static_cast<double>(bytes) / commands, commands / encodeMilliseconds / 1000.0, commands / replayMilliseconds / 1000.0);
+    }
+}
+
+// Recording and replaying command streams, in millions of commands per
+// second: the frames of tests/data/commands/sample_frames.cap replayed into
+// CommandStreamWriter, which decodes and encodes them again, and into
+// NullCommandStreamSink, which only decodes; then a list of 10000 draws with
+// their own constants and vertex buffers recorded and replayed.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+
+    CommandCapture capture;
+    if (!capture.Load(std::string(TEST_DATA_DIR) + "/commands/sample_frames.cap"))
+    {
+        printf("cannot load the capture\n");
+        return 1;
+    }
+
+    printf("%-28s %10s %12s %14s %14s\n", "stream", "commands", "bytes/cmd", "encode Mcmd/s", "replay Mcmd/s");
+
+    // The capture, a frame at a time like -cmdcapture records it.
+    {
+        const uint32_t repeats = quick ? 1 : 20000;
+        CommandStreamWriter writer;
+        uint64_t bytes = 0;
+        BenchmarkTimer timer;
+        for (uint32_t repeat = 0; repeat < repeats; ++repeat)
+        {
+            for (uint32_t frame = 0; frame < capture.GetFrameCount(); ++frame)
+            {
+                for (const std::vector<uint8_t>& list : capture.GetFrame(frame).lists)
+                {
+                    writer.Reset();
+                    ReplayCommandStream(list.data(), list.size(), writer);
+                    bytes += writer.GetData().size();
+                }
+            }
+        }
+        const double encodeMilliseconds = timer.GetMilliseconds();
+
+        NullCommandStreamSink sink;
+        timer.Restart();
+        for (uint32_t repeat = 0; repeat < repeats; ++repeat)
+        {
+            for (uint32_t frame = 0; frame < capture.GetFrameCount(); ++frame)
+            {
+                capture.Replay(frame, sink);
+            }
+        }
+        const double replayMilliseconds = timer.GetMilliseconds();
+        KeepResult(sink.GetStats().errors);
+
+        const uint64_t commands = sink.GetStats().commands;
+        PrintRow("sample_frames.cap", commands, bytes, encodeMilliseconds, replayMilliseconds);
+    }
+
+    {
+        const uint32_t drawCount = 10000;
+        const uint32_t repeats = quick ? 1 : 200;
+        CommandStreamWriter writer;
+        BenchmarkTimer timer;
+        for (uint32_t repeat = 0; repeat < repeats; ++repeat)
+        {
+            writer.Reset();
+            RecordDrawHeavyList(writer, drawCount);
+        }
+        const double encodeMilliseconds = timer.GetMilliseconds();
+
+        NullCommandStreamSink sink;
+        timer.Restart();
+        for (uint32_t repeat = 0; repeat < repeats; ++repeat)
+        {
+            ReplayCommandStream(writer.GetData().data(), writer.GetData().size(), sink);
+        }
+        const double replayMilliseconds = timer.GetMilliseconds();
+        KeepResult(sink.GetStats().draws);
+
+        PrintRow("10000 draws", sink.GetStats().commands, writer.GetData().size() * repeats, encodeMilliseconds, replayMilliseconds);
+    }
+    return 0;
+}
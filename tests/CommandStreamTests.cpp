@@ -0,0 +1,556 @@
+#include "CommandStream.h"
+#include "MappedFile.h"
+#include "TestHarness.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const uint32_t FixtureFrameCount = 8;
+
+    // Writes every call as a line of text, floats as their bits, so two sinks
+    // that received the same calls have the same log.
+    class CallLog : public ICommandStreamSink
+    {
+    public:
+        std::string GetText() const { return m_text.str(); }
+
+        virtual void BeginList(uint32_t list)                       { m_text << "begin " << list << "\n"; }
+        virtual void EndList(uint32_t list)                         { m_text << "end " << list << "\n"; }
+
+        virtual void SetPipelineState(CommandHandle pipelineState)  { m_text << "pso " << pipelineState << "\n"; }
+
+        virtual void SetRootSignature(bool compute, CommandHandle rootSignature)
+        {
+            m_text << "rootsig " << compute << " " << rootSignature << "\n";
+        }
+
+        virtual void SetDescriptorHeaps(uint32_t count, const CommandHandle* heaps)
+        {
+            m_text << "heaps";
+            WriteArray(count, heaps);
+        }
+
+        virtual void SetRootDescriptorTable(bool compute, uint32_t index, CommandHandle baseDescriptor)
+        {
+            m_text << "table " << compute << " " << index << " " << baseDescriptor << "\n";
+        }
+
+        virtual void SetRootView(bool compute, CommandRootView view, uint32_t index, CommandHandle address)
+        {
+            m_text << "view " << compute << " " << view << " " << index << " " << address << "\n";
+        }
+
+        virtual void SetRoot32BitConstants(bool compute, uint32_t index, uint32_t count, const uint32_t* values, uint32_t offset)
+        {
+            m_text << "constants " << compute << " " << index << " " << offset;
+            WriteArray(count, values);
+        }
+
+        virtual void ResourceBarriers(uint32_t count, const CommandBarrier* barriers)
+        {
+            m_text << "barriers";
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const CommandBarrier& barrier = barriers[i];
+                m_text << " " << barrier.type << "/" << barrier.flags << "/" << barrier.resource << "/" << barrier.resourceBefore << "/"
+                    << barrier.subresource << "/" << barrier.stateBefore << "/" << barrier.stateAfter;
+            }
+            m_text << "\n";
+        }
+
+        virtual void DiscardResource(CommandHandle resource)        { m_text << "discard " << resource << "\n"; }
+
+        virtual void SetRenderTargets(uint32_t count, const CommandHandle* renderTargets, CommandHandle depthStencil)
+        {
+            m_text << "targets " << depthStencil;
+            WriteArray(count, renderTargets);
+        }
+
+        virtual void ClearRenderTarget(CommandHandle renderTarget, const float color[4], uint32_t rectCount, const CommandRect* rects)
+        {
+            m_text << "clear " << renderTarget;
+            WriteFloats(4, color);
+            WriteRects(rectCount, rects);
+        }
+
+        virtual void SetViewports(uint32_t count, const CommandViewport* viewports)
+        {
+            m_text << "viewports";
+            WriteFloats(count * 6, &viewports->x);
+            m_text << "\n";
+        }
+
+        virtual void SetScissorRects(uint32_t count, const CommandRect* rects)
+        {
+            m_text << "scissors";
+            WriteRects(count, rects);
+        }
+
+        virtual void SetPrimitiveTopology(uint32_t topology)        { m_text << "topology " << topology << "\n"; }
+
+        virtual void SetVertexBuffers(uint32_t startSlot, uint32_t count, const CommandVertexBufferView* views)
+        {
+            m_text << "vertexbuffers " << startSlot;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                m_text << " " << views[i].address << "/" << views[i].size << "/" << views[i].stride;
+            }
+            m_text << "\n";
+        }
+
+        virtual void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance)
+        {
+            m_text << "draw " << vertexCount << " " << instanceCount << " " << startVertex << " " << startInstance << "\n";
+        }
+
+        virtual void ExecuteIndirect(CommandHandle commandSignature, uint32_t maxCommandCount, CommandHandle argumentBuffer,
+            uint64_t argumentOffset, CommandHandle countBuffer, uint64_t countOffset)
+        {
+            m_text << "indirect " << commandSignature << " " << maxCommandCount << " " << argumentBuffer << " " << argumentOffset << " "
+                << countBuffer << " " << countOffset << "\n";
+        }
+
+        virtual void Dispatch(uint32_t x, uint32_t y, uint32_t z)   { m_text << "dispatch " << x << " " << y << " " << z << "\n"; }
+
+    private:
+        template <typename T>
+        void WriteArray(uint32_t count, const T* values)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                m_text << " " << values[i];
+            }
+            m_text << "\n";
+        }
+
+        void WriteFloats(uint32_t count, const float* values)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                uint32_t bits;
+                memcpy(&bits, &values[i], sizeof(bits));
+                m_text << " " << bits;
+            }
+        }
+
+        void WriteRects(uint32_t count, const CommandRect* rects)
+        {
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                m_text << " " << rects[i].left << "," << rects[i].top << "," << rects[i].right << "," << rects[i].bottom;
+            }
+            m_text << "\n";
+        }
+
+        std::ostringstream m_text;
+    };
+
+    // Every command, with the values the encoding treats specially: 64-bit
+    // handles, negative rects, NaN and denormal floats, compute variants.
+    void RecordEveryCommand(ICommandStreamSink& sink)
+    {
+        const CommandHandle heaps[] = { 0x7f0000001000ull, 0xffffffffffffffffull };
+        sink.SetDescriptorHeaps(2, heaps);
+        sink.SetRootSignature(false, 0x1000);
+        sink.SetRootSignature(true, 0x1100);
+        sink.SetPipelineState(0x2000);
+        sink.SetRootDescriptorTable(false, 1, 0x100000009000ull);
+        sink.SetRootDescriptorTable(true, 3, 0);
+        sink.SetRootView(false, CommandRootViewCbv, 0, 0xc000);
+        sink.SetRootView(true, CommandRootViewSrv, 2, 0xffffffff00000000ull);
+        sink.SetRootView(true, CommandRootViewUav, 4, 1);
+        const uint32_t constants[] = { 0, 1, 0xffffffffu, 0x80000000u };
+        sink.SetRoot32BitConstants(true, 1, 4, constants, 2);
+        sink.SetRoot32BitConstants(false, 0, 0, constants, 0);
+
+        CommandBarrier barriers[3] = {};
+        barriers[0].type = CommandBarrierTransition;
+        barriers[0].resource = 0x5000;
+        barriers[0].subresource = 0xffffffffu;
+        barriers[0].stateBefore = 0x800;
+        barriers[0].stateAfter = 4;
+        barriers[1].type = CommandBarrierAliasing;
+        barriers[1].resource = 0x5100;
+        barriers[1].resourceBefore = 0x5000;
+        barriers[2].type = CommandBarrierUav;
+        barriers[2].flags = 1;
+        barriers[2].resource = 0x5200;
+        sink.ResourceBarriers(3, barriers);
+        sink.DiscardResource(0x5000);
+
+        const CommandHandle targets[] = { 0x8000, 0x8100 };
+        sink.SetRenderTargets(2, targets, 0x8200);
+        sink.SetRenderTargets(1, targets, 0);
+        float color[4] = { 0.0f, -0.5f, 1e-40f, 0.0f };
+        const uint32_t nan = 0x7fc00001u;
+        memcpy(&color[3], &nan, sizeof(nan));
+        const CommandRect rects[] = { { 0, 0, 1280, 720 }, { -16, -2147483647 - 1, 2147483647, -1 } };
+        sink.ClearRenderTarget(0x8000, color, 2, rects);
+        sink.ClearRenderTarget(0x8100, color, 0, nullptr);
+        const CommandViewport viewports[] = { { 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f }, { 0.5f, -3.25f, 1.0f, 2.0f, 0.25f, 0.75f } };
+        sink.SetViewports(2, viewports);
+        sink.SetScissorRects(2, rects);
+
+        sink.SetPrimitiveTopology(4);
+        const CommandVertexBufferView views[] = { { 0xa000, 48, 16 }, { 0x1000000000ull, 0xffffffffu, 0 } };
+        sink.SetVertexBuffers(1, 2, views);
+        sink.Draw(6, 1, 0, 0);
+        sink.Draw(0xffffffffu, 0xffffffffu, 7, 9);
+        sink.ExecuteIndirect(0x3000, 1, 0x4000, 0x100000014ull, 0, 0);
+        sink.ExecuteIndirect(0x3000, 64, 0x4000, 20, 0x4100, 0xffffffffffffffffull);
+        sink.Dispatch(5, 720, 1);
+        sink.Dispatch(0, 0xffffffffu, 65535);
+    }
+
+    // The lists of a frame of the sample, the way PopulateCommandList records
+    // them: the triangle pass into the scene, the two blur passes, then the
+    // quad pass onto the back buffer. Descriptors and addresses move with the
+    // frame like those of the constant ring and the swap chain.
+    CapturedFrame RecordSampleFrame(uint64_t frame)
+    {
+        CapturedFrame captured;
+        captured.frame = frame;
+
+        const CommandHandle heap = 0x7000;
+        const CommandHandle constants = 0x10000 + (frame % 3) * 0x1000;
+        const CommandHandle backBuffer = 0x6000 + (frame % 2) * 0x100;
+        const CommandViewport viewport = { 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+        const CommandRect scissor = { 0, 0, 1280, 720 };
+        const CommandViewport sceneViewport = { 0.0f, 0.0f, 960.0f, 540.0f, 0.0f, 1.0f };
+        const CommandRect sceneScissor = { 0, 0, 960, 540 };
+        const float sceneClear[4] = { 0.1f, 0.1f, 1.0f, 1.0f };
+        const float clear[4] = { 0.0f, 0.2f, 0.4f, 1.0f };
+
+        CommandStreamWriter writer;
+        const auto setup = [&]()
+        {
+            writer.SetRootSignature(false, 0x1000);
+            writer.SetViewports(1, &viewport);
+            writer.SetScissorRects(1, &scissor);
+            writer.SetDescriptorHeaps(1, &heap);
+            writer.SetRootView(false, CommandRootViewCbv, 0, constants);
+        };
+        const auto transition = [&](CommandHandle resource, uint32_t before, uint32_t after)
+        {
+            CommandBarrier barrier = {};
+            barrier.type = CommandBarrierTransition;
+            barrier.resource = resource;
+            barrier.subresource = 0xffffffffu;
+            barrier.stateBefore = before;
+            barrier.stateAfter = after;
+            writer.ResourceBarriers(1, &barrier);
+        };
+        const auto finish = [&]()
+        {
+            captured.lists.push_back(writer.GetData());
+            writer.Reset();
+        };
+
+        const CommandHandle scene = 0x5000;
+        transition(scene, 0x80, 4);
+        setup();
+        const CommandHandle sceneTarget = 0x9000;
+        writer.SetRenderTargets(1, &sceneTarget, 0);
+        writer.ClearRenderTarget(sceneTarget, sceneClear, 1, &sceneScissor);
+        writer.SetViewports(1, &sceneViewport);
+        writer.SetScissorRects(1, &sceneScissor);
+        writer.SetPrimitiveTopology(4);
+        writer.SetPipelineState(0x2000);
+        const CommandVertexBufferView triangle = { 0xa000, 84, 28 };
+        writer.SetVertexBuffers(0, 1, &triangle);
+        writer.SetRootDescriptorTable(false, 1, 0x9100);
+        writer.SetRootView(false, CommandRootViewSrv, 2, 0xb000);
+        writer.ExecuteIndirect(0x3000, 1, 0x10000, (frame % 3) * 0x1000 + 0x200, 0, 0);
+        finish();
+
+        for (uint32_t pass = 0; pass < 2; ++pass)
+        {
+            const CommandHandle source = pass == 0 ? scene : 0x5100;
+            const CommandHandle destination = pass == 0 ? 0x5100 : 0x5200;
+            transition(source, pass == 0 ? 4 : 8, 0x40);
+            transition(destination, 0x40, 8);
+            setup();
+            writer.SetRootSignature(true, 0x1100);
+            writer.SetPipelineState(0x2100);
+            writer.SetRootView(true, CommandRootViewCbv, 0, constants + 0x100);
+            const uint32_t blurConstants[] = { pass, 960, 540, 4 };
+            writer.SetRoot32BitConstants(true, 1, 4, blurConstants, 0);
+            writer.SetRootDescriptorTable(true, 2, 0x9200 + pass * 0x40);
+            writer.SetRootDescriptorTable(true, 3, 0x9300 + pass * 0x40);
+            writer.Dispatch(pass == 0 ? 4 : 960, pass == 0 ? 540 : 3, 1);
+            finish();
+        }
+
+        transition(0x5200, 8, 0x40);
+        transition(backBuffer, 0, 4);
+        setup();
+        const CommandHandle target = 0x9400 + (frame % 2) * 0x20;
+        writer.SetRenderTargets(1, &target, 0);
+        writer.SetViewports(1, &viewport);
+        writer.SetScissorRects(1, &scissor);
+        writer.ClearRenderTarget(target, clear, 0, nullptr);
+        writer.SetPrimitiveTopology(4);
+        writer.SetPipelineState(0x2200);
+        writer.SetRootDescriptorTable(false, 1, 0x9500);
+        const CommandVertexBufferView quad = { 0xa100, 120, 20 };
+        writer.SetVertexBuffers(0, 1, &quad);
+        writer.Draw(6, 1, 0, 0);
+        transition(backBuffer, 4, 0);
+        finish();
+        return captured;
+    }
+
+    // Replays the stream one byte shorter each time: a prefix that ends
+    // inside a command must fail, one that ends between commands replays.
+    uint32_t CountReplayablePrefixes(const std::vector<uint8_t>& data)
+    {
+        uint32_t replayed = 0;
+        for (size_t size = 0; size <= data.size(); ++size)
+        {
+            // Exactly size bytes, so reading past the end is an error under ASan.
+            std::vector<uint8_t> prefix(data.begin(), data.begin() + size);
+            NullCommandStreamSink sink;
+            if (ReplayCommandStream(prefix.data(), prefix.size(), sink))
+            {
+                replayed++;
+            }
+        }
+        return replayed;
+    }
+
+    std::string FixturePath()
+    {
+        return std::string(TEST_DATA_DIR) + "/commands/sample_frames.cap";
+    }
+}
+
+TEST(ReplayReproducesEveryCall)
+{
+    CallLog recorded;
+    RecordEveryCommand(recorded);
+
+    CommandStreamWriter writer;
+    RecordEveryCommand(writer);
+    CHECK_EQUAL(27ull, static_cast<unsigned long long>(writer.GetCommandCount()));
+
+    CallLog replayed;
+    CHECK(ReplayCommandStream(writer.GetData().data(), writer.GetData().size(), replayed));
+    CHECK(recorded.GetText() == replayed.GetText());
+
+    // Re-encoding the replay gives the same bytes.
+    CommandStreamWriter reencoded;
+    CHECK(ReplayCommandStream(writer.GetData().data(), writer.GetData().size(), reencoded));
+    CHECK(writer.GetData() == reencoded.GetData());
+}
+
+TEST(RepeatedObjectsCostTheirIndex)
+{
+    CommandStreamWriter writer;
+    writer.SetPipelineState(0x7f0000002000ull);
+    const size_t first = writer.GetData().size();
+    writer.SetPipelineState(0x7f0000002000ull);
+    CHECK_EQUAL(2u, static_cast<uint32_t>(writer.GetData().size() - first));
+
+    // The table belongs to the stream: after Reset the object is written again.
+    writer.Reset();
+    CHECK_EQUAL(0u, static_cast<uint32_t>(writer.GetData().size()));
+    CHECK_EQUAL(0ull, static_cast<unsigned long long>(writer.GetCommandCount()));
+    writer.SetPipelineState(0x7f0000002000ull);
+    CHECK_EQUAL(first, writer.GetData().size());
+
+    CallLog log;
+    writer.SetPipelineState(0x2100);
+    writer.SetPipelineState(0x7f0000002000ull);
+    CHECK(ReplayCommandStream(writer.GetData().data(), writer.GetData().size(), log));
+    CHECK(log.GetText() == "pso 139637976735744\npso 8448\npso 139637976735744\n");
+}
+
+TEST(NullSinkCountsAndChecksState)
+{
+    CommandStreamWriter writer;
+    writer.Draw(3, 1, 0, 0);                    // No pipeline, no root signature.
+    writer.SetPipelineState(0x2000);
+    writer.Draw(3, 1, 0, 0);                    // No root signature.
+    writer.SetRootSignature(false, 0x1000);
+    writer.Draw(3, 1, 0, 0);
+    writer.Dispatch(1, 1, 1);                   // The graphics root signature does not count.
+    writer.SetRootSignature(true, 0x1100);
+    writer.Dispatch(1, 1, 1);
+    CommandBarrier barriers[2] = {};
+    writer.ResourceBarriers(2, barriers);
+
+    NullCommandStreamSink sink;
+    CHECK(ReplayCommandStream(writer.GetData().data(), writer.GetData().size(), sink));
+    const NullCommandStreamStats& stats = sink.GetStats();
+    CHECK_EQUAL(9ull, static_cast<unsigned long long>(stats.commands));
+    CHECK_EQUAL(3ull, static_cast<unsigned long long>(stats.draws));
+    CHECK_EQUAL(2ull, static_cast<unsigned long long>(stats.dispatches));
+    CHECK_EQUAL(2ull, static_cast<unsigned long long>(stats.barriers));
+    CHECK_EQUAL(3ull, static_cast<unsigned long long>(stats.stateChanges));
+    CHECK_EQUAL(3ull, static_cast<unsigned long long>(stats.errors));
+
+    // A new list starts without state.
+    CommandCapture capture;
+    CapturedFrame frame;
+    frame.frame = 0;
+    frame.lists.push_back(writer.GetData());
+    writer.Reset();
+    writer.Draw(3, 1, 0, 0);
+    frame.lists.push_back(writer.GetData());
+    capture.AddFrame(std::move(frame));
+    NullCommandStreamSink lists;
+    CHECK(capture.Replay(0, lists));
+    CHECK_EQUAL(2ull, static_cast<unsigned long long>(lists.GetStats().lists));
+    CHECK_EQUAL(4ull, static_cast<unsigned long long>(lists.GetStats().errors));
+}
+
+TEST(MalformedStreamsStopAtTheBadCommand)
+{
+    // Built a command at a time, the prefixes ending between commands are known.
+    CommandStreamWriter writer;
+    RecordEveryCommand(writer);
+    CHECK_EQUAL(static_cast<uint32_t>(writer.GetCommandCount()) + 1, CountReplayablePrefixes(writer.GetData()));
+
+    const uint8_t unknownOp[] = { 0x00 };
+    const uint8_t badOp[] = { 0x7f, 0x00 };
+    const uint8_t unterminatedVarint[] = { 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x01 };
+    const uint8_t objectNotInTable[] = { 0x01, 0x05 };
+    const uint8_t hugeCount[] = { 0x03, 0xff, 0xff, 0xff, 0xff, 0x0f };
+    const struct
+    {
+        const uint8_t* data;
+        size_t size;
+    } malformed[] =
+    {
+        { unknownOp, sizeof(unknownOp) },
+        { badOp, sizeof(badOp) },
+        { unterminatedVarint, sizeof(unterminatedVarint) },
+        { objectNotInTable, sizeof(objectNotInTable) },
+        { hugeCount, sizeof(hugeCount) },
+    };
+    for (const auto& stream : malformed)
+    {
+        std::vector<uint8_t> data(stream.data, stream.data + stream.size);
+        NullCommandStreamSink sink;
+        CHECK(!ReplayCommandStream(data.data(), data.size(), sink));
+        CHECK_EQUAL(0ull, static_cast<unsigned long long>(sink.GetStats().commands));
+    }
+
+    // Commands before the bad one are replayed.
+    std::vector<uint8_t> data = writer.GetData();
+    data.push_back(0x00);
+    NullCommandStreamSink sink;
+    CHECK(!ReplayCommandStream(data.data(), data.size(), sink));
+    CHECK_EQUAL(writer.GetCommandCount(), sink.GetStats().commands);
+
+    // Random corruption never reads past the stream or crashes.
+    uint32_t state = 1;
+    for (uint32_t i = 0; i < 20000; ++i)
+    {
+        std::vector<uint8_t> mutated = writer.GetData();
+        for (uint32_t j = 0; j < 4; ++j)
+        {
+            state = state * 1664525u + 1013904223u;
+            mutated[(state >> 8) % mutated.size()] = static_cast<uint8_t>(state >> 24);
+        }
+        state = state * 1664525u + 1013904223u;
+        mutated.resize(1 + (state >> 8) % mutated.size());
+        NullCommandStreamSink mutatedSink;
+        ReplayCommandStream(mutated.data(), mutated.size(), mutatedSink);
+    }
+}
+
+TEST(CaptureSavesAndLoads)
+{
+    CommandCapture capture;
+    for (uint64_t frame = 0; frame < 60; ++frame)
+    {
+        capture.AddFrame(RecordSampleFrame(frame * 3 + 100));
+    }
+    const std::string path = "CommandStreamTests.cap";
+    CHECK(capture.Save(path));
+
+    CommandCapture loaded;
+    CHECK(loaded.Load(path));
+    CHECK_EQUAL(60u, loaded.GetFrameCount());
+    CHECK_EQUAL(capture.GetByteSize(), loaded.GetByteSize());
+    for (uint32_t i = 0; i < loaded.GetFrameCount(); ++i)
+    {
+        CHECK_EQUAL(capture.GetFrame(i).frame, loaded.GetFrame(i).frame);
+        CHECK(capture.GetFrame(i).lists == loaded.GetFrame(i).lists);
+    }
+
+    // Every truncation of the file is rejected, and leaves the capture empty.
+    std::vector<uint8_t> file;
+    CHECK(ReadFileBytes(path, file));
+    uint32_t truncatedLoads = 0;
+    for (size_t size = 0; size < file.size(); size += 7)
+    {
+        CHECK(WriteFileAtomic(path, file.data(), size));
+        if (loaded.Load(path) || loaded.GetFrameCount() != 0)
+        {
+            truncatedLoads++;
+        }
+    }
+    CHECK_EQUAL(0u, truncatedLoads);
+
+    // So are files of another format or version.
+    std::vector<uint8_t> foreign = file;
+    foreign[0] ^= 0xff;
+    CHECK(WriteFileAtomic(path, foreign.data(), foreign.size()));
+    CHECK(!loaded.Load(path));
+    foreign = file;
+    foreign[4]++;
+    CHECK(WriteFileAtomic(path, foreign.data(), foreign.size()));
+    CHECK(!loaded.Load(path));
+    CHECK(!loaded.Load("CommandStreamTests.missing.cap"));
+    remove(path.c_str());
+}
+
+// tests/data/commands/sample_frames.cap holds frames of RecordSampleFrame; a
+// change to the encoding that old captures no longer load or replay under
+// shows up here. With COMMAND_STREAM_UPDATE_FIXTURE set the file is rewritten.
+TEST(FixtureReplaysLikeTheSample)
+{
+    CommandCapture expected;
+    for (uint64_t frame = 0; frame < FixtureFrameCount; ++frame)
+    {
+        expected.AddFrame(RecordSampleFrame(frame));
+    }
+    if (getenv("COMMAND_STREAM_UPDATE_FIXTURE"))
+    {
+        CHECK(expected.Save(FixturePath()));
+    }
+
+    CommandCapture fixture;
+    CHECK(fixture.Load(FixturePath()));
+    CHECK_EQUAL(FixtureFrameCount, fixture.GetFrameCount());
+    for (uint32_t i = 0; i < fixture.GetFrameCount() && i < FixtureFrameCount; ++i)
+    {
+        CHECK(fixture.GetFrame(i).lists == expected.GetFrame(i).lists);
+
+        CallLog fixtureLog;
+        CallLog expectedLog;
+        CHECK(fixture.Replay(i, fixtureLog));
+        CHECK(expected.Replay(i, expectedLog));
+        CHECK(fixtureLog.GetText() == expectedLog.GetText());
+    }
+
+    NullCommandStreamSink sink;
+    for (uint32_t i = 0; i < fixture.GetFrameCount(); ++i)
+    {
+        CHECK(fixture.Replay(i, sink));
+    }
+    const NullCommandStreamStats& stats = sink.GetStats();
+    CHECK_EQUAL(4ull * FixtureFrameCount, static_cast<unsigned long long>(stats.lists));
+    CHECK_EQUAL(2ull * FixtureFrameCount, static_cast<unsigned long long>(stats.draws));
+    CHECK_EQUAL(2ull * FixtureFrameCount, static_cast<unsigned long long>(stats.dispatches));
+    CHECK_EQUAL(8ull * FixtureFrameCount, static_cast<unsigned long long>(stats.barriers));
+    CHECK_EQUAL(0ull, static_cast<unsigned long long>(stats.errors));
+}
@@ -0,0 +1,89 @@
+#include "DdsTexture.h"
+#include "MappedFile.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* CorpusFiles[] =
+    {
+        "rgba8_mips.dds", "bgra8_npot.dds", "b5g6r5.dds", "l8.dds", "dxt1_mips.dds", "dxt5_npot.dds", "ati2.dds",
+        "cube_dxt1.dds", "volume_rgba8.dds", "dx10_bc7_array.dds", "dx10_bc6h_cube_array.dds", "dx10_rgba16f_3d.dds",
+        "dx10_r32f_1d.dds",
+    };
+}
+
+// DdsTexture::Parse and GetCopyableFootprints over the seed corpus of
+// DdsTextureFuzzer, files parsed per second and subresources laid out per
+// second, then the footprints of large textures the corpus has no room for.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t iterations = quick ? 10 : 200000;
+
+    printf("%-26s %8s %14s %18s\n", "file", "subres", "parses/s", "footprints/s");
+    for (const char* name : CorpusFiles)
+    {
+        std::vector<uint8_t> data;
+        if (!ReadFileBytes(std::string(TEST_DATA_DIR) + "/dds/" + name, data))
+        {
+            printf("cannot read %s\n", name);
+            return 1;
+        }
+
+        DdsTexture texture;
+        uint32_t subresources = 0;
+        BenchmarkTimer timer;
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            if (texture.Parse(data.data(), data.size()) == DdsResultOk)
+            {
+                subresources += texture.GetSubresourceCount();
+            }
+        }
+        const double parseSeconds = timer.GetMilliseconds() / 1000.0;
+        KeepResult(subresources);
+
+        std::vector<TextureFootprint> footprints(texture.GetSubresourceCount());
+        uint64_t total = 0;
+        timer.Restart();
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            total += GetCopyableFootprints(texture.GetDesc(), 0, texture.GetSubresourceCount(), 0, footprints.data());
+        }
+        const double footprintSeconds = timer.GetMilliseconds() / 1000.0;
+        KeepResult(total);
+
+        printf("%-26s %8u %14.0f %18.0f\n", name, texture.GetSubresourceCount(), iterations / parseSeconds,
+            static_cast<double>(iterations) * texture.GetSubresourceCount() / footprintSeconds);
+    }
+
+    const TextureDesc large[] =
+    {
+        { TextureDimension2D, 98, 16384, 16384, 1, 15, 1, false },
+        { TextureDimension2D, 10, 2048, 2048, 1, 12, 6 * 16, true },
+        { TextureDimension3D, 28, 512, 512, 512, 10, 1, false },
+    };
+    const char* largeNames[] = { "16384^2 BC7", "2048^2 rgba16f cube x16", "512^3 rgba8" };
+
+    printf("\n%-26s %8s %18s\n", "desc", "subres", "footprints/s");
+    for (uint32_t d = 0; d < sizeof(large) / sizeof(large[0]); ++d)
+    {
+        const uint32_t count = large[d].mipCount * large[d].arraySize;
+        std::vector<TextureFootprint> footprints(count);
+        const uint32_t repeats = quick ? 10 : 20000000 / count;
+        uint64_t total = 0;
+        BenchmarkTimer timer;
+        for (uint32_t i = 0; i < repeats; ++i)
+        {
+            total += GetCopyableFootprints(large[d], 0, count, 0, footprints.data());
+        }
+        const double seconds = timer.GetMilliseconds() / 1000.0;
+        KeepResult(total);
+        printf("%-26s %8u %18.0f\n", largeNames[d], count, static_cast<double>(repeats) * count / seconds);
+    }
+    return 0;
+}
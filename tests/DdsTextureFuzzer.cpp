@@ -0,0 +1,180 @@
+#include "DdsTexture.h"
+#include "TextureLayout.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef PORTABLE_LIBFUZZER
+#include "MappedFile.h"
+#endif
+
+namespace
+{
+    void Require(bool condition, const char* what)
+    {
+        if (!condition)
+        {
+            fprintf(stderr, "DdsTextureFuzzer: %s\n", what);
+            abort();
+        }
+    }
+
+    volatile uint32_t s_sink;
+}
+
+// Parses one input. A parsed texture must describe subresources that are in
+// the input, one after the other, with the rows GetCopyableFootprints gives
+// them; reading their first and last bytes lets the sanitizers catch the rest.
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    DdsTexture texture;
+    if (texture.Parse(data, size) != DdsResultOk)
+    {
+        return 0;
+    }
+
+    const TextureDesc& desc = texture.GetDesc();
+    const uint32_t count = texture.GetSubresourceCount();
+    Require(count == desc.mipCount * desc.arraySize, "subresource count");
+
+    std::vector<TextureFootprint> footprints(count);
+    const uint64_t total = GetCopyableFootprints(desc, 0, count, 0, footprints.data());
+    Require(total > 0, "footprints of a parsed format");
+
+    uint64_t end = 0;
+    uint32_t sum = 0;
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        const DdsSubresource& subresource = texture.GetSubresource(index);
+        const TextureFootprint& footprint = footprints[index];
+        Require(subresource.offset >= end && subresource.offset <= size && subresource.size <= size - subresource.offset, "subresource in the input");
+        Require(subresource.size == static_cast<uint64_t>(subresource.rowSize) * subresource.rowCount * subresource.depth, "subresource size");
+        Require(footprint.rowSize == subresource.rowSize && footprint.rowCount == subresource.rowCount && footprint.depth == subresource.depth, "footprint rows");
+        Require(footprint.rowPitch >= footprint.rowSize && footprint.rowPitch % TexturePitchAlignment == 0, "footprint pitch");
+        Require(footprint.offset % TexturePlacementAlignment == 0 && footprint.offset < total, "footprint placement");
+        end = subresource.offset + subresource.size;
+
+        if (subresource.size)
+        {
+            const uint8_t* bytes = texture.GetSubresourceData(index);
+            sum += bytes[0] + bytes[subresource.size - 1];
+        }
+    }
+
+    uint64_t mipBytes = 0;
+    for (uint32_t mip = 0; mip < desc.mipCount; ++mip)
+    {
+        mipBytes += texture.GetMipBytes(mip);
+    }
+    Require(mipBytes <= size, "mip bytes");
+    s_sink = sum;
+    return 0;
+}
+
+#ifndef PORTABLE_LIBFUZZER
+
+namespace
+{
+    uint32_t Random(uint32_t& state, uint32_t range)
+    {
+        state = state * 1664525 + 1013904223;
+        return (state >> 8) % range;
+    }
+
+    // Values that push the header fields to their limits.
+    const uint32_t InterestingValues[] = { 0, 1, 2, 3, 4, 6, 7, 16, 32, 124, 0x7fff, 0x8000, 16384, 16385, 0x7fffffff, 0x80000000, 0xffffffff };
+
+    // The input in a buffer of its exact size, so that reading past it is caught.
+    void Run(const std::vector<uint8_t>& input)
+    {
+        std::vector<uint8_t> exact(input);
+        LLVMFuzzerTestOneInput(exact.empty() ? nullptr : exact.data(), exact.size());
+    }
+
+    // Bit flips, bytes and header fields overwritten, truncation: most of the
+    // mutations land in the 148 header bytes, where the checks are.
+    void Mutate(std::vector<uint8_t>& input, uint32_t& state)
+    {
+        const uint32_t mutations = 1 + Random(state, 6);
+        for (uint32_t m = 0; m < mutations && !input.empty(); ++m)
+        {
+            const size_t limit = Random(state, 4) ? std::min<size_t>(input.size(), 148) : input.size();
+            const size_t at = Random(state, static_cast<uint32_t>(limit));
+            switch (Random(state, 3))
+            {
+            case 0:
+                input[at] ^= static_cast<uint8_t>(1u << Random(state, 8));
+                break;
+            case 1:
+                input[at] = static_cast<uint8_t>(Random(state, 256));
+                break;
+            default:
+                if (at + 4 <= input.size())
+                {
+                    const uint32_t value = InterestingValues[Random(state, sizeof(InterestingValues) / sizeof(InterestingValues[0]))];
+                    memcpy(&input[at & ~size_t(3)], &value, 4);
+                }
+                break;
+            }
+        }
+
+        if (Random(state, 4) == 0)
+        {
+            input.resize(Random(state, static_cast<uint32_t>(input.size() + 1)));
+        }
+    }
+}
+
+// Without libFuzzer: runs the files given on the command line, every prefix
+// of their headers and -mutations N mutated copies of each, deterministically.
+// afl-fuzz can run it on one file at a time, with -mutations 0.
+int main(int argc, char** argv)
+{
+    std::vector<std::vector<uint8_t>> corpus;
+    uint32_t mutations = 1000;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-mutations") == 0 && i + 1 < argc)
+        {
+            mutations = static_cast<uint32_t>(atoi(argv[++i]));
+            continue;
+        }
+
+        std::vector<uint8_t> input;
+        if (!ReadFileBytes(argv[i], input))
+        {
+            fprintf(stderr, "DdsTextureFuzzer: cannot read %s\n", argv[i]);
+            return 1;
+        }
+        corpus.push_back(input);
+    }
+
+    uint64_t runs = 0;
+    uint32_t state = 1;
+    for (const std::vector<uint8_t>& input : corpus)
+    {
+        Run(input);
+        for (size_t size = 0; size < std::min<size_t>(input.size(), 149); ++size)
+        {
+            Run(std::vector<uint8_t>(input.begin(), input.begin() + size));
+        }
+        runs += 1 + std::min<size_t>(input.size(), 149);
+
+        for (uint32_t m = 0; m < mutations; ++m)
+        {
+            std::vector<uint8_t> mutated(input);
+            Mutate(mutated, state);
+            Run(mutated);
+        }
+        runs += mutations;
+    }
+
+    printf("%llu inputs from %u files\n", static_cast<unsigned long long>(runs), static_cast<uint32_t>(corpus.size()));
+    return 0;
+}
+
+#endif
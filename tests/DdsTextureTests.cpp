@@ -0,0 +1,113 @@
+#include "DdsTexture.h"
+#include "MappedFile.h"
+#include "TestHarness.h"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct CorpusFile
+    {
+        const char* name;
+        TextureDimension dimension;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth;
+        uint32_t mipCount;
+        uint32_t arraySize;
+        bool cube;
+    };
+
+    // The seed corpus of DdsTextureFuzzer, in tests/data/dds.
+    const CorpusFile Corpus[] =
+    {
+        { "rgba8_mips.dds",             TextureDimension2D, 28, 32, 32, 1, 6, 1,  false },
+        { "bgra8_npot.dds",             TextureDimension2D, 87, 30, 20, 1, 5, 1,  false },
+        { "b5g6r5.dds",                 TextureDimension2D, 85, 16, 8,  1, 1, 1,  false },
+        { "l8.dds",                     TextureDimension2D, 61, 17, 9,  1, 1, 1,  false },
+        { "dxt1_mips.dds",              TextureDimension2D, 71, 64, 64, 1, 7, 1,  false },
+        { "dxt5_npot.dds",              TextureDimension2D, 77, 50, 26, 1, 6, 1,  false },
+        { "ati2.dds",                   TextureDimension2D, 83, 32, 32, 1, 1, 1,  false },
+        { "cube_dxt1.dds",              TextureDimension2D, 71, 16, 16, 1, 5, 6,  true },
+        { "volume_rgba8.dds",           TextureDimension3D, 28, 8,  8,  4, 4, 1,  false },
+        { "dx10_bc7_array.dds",         TextureDimension2D, 98, 32, 32, 1, 6, 3,  false },
+        { "dx10_bc6h_cube_array.dds",   TextureDimension2D, 95, 16, 16, 1, 5, 12, true },
+        { "dx10_rgba16f_3d.dds",        TextureDimension3D, 10, 8,  4,  4, 4, 1,  false },
+        { "dx10_r32f_1d.dds",           TextureDimension1D, 41, 64, 1,  1, 7, 1,  false },
+    };
+
+    std::string CorpusPath(const char* name)
+    {
+        return std::string(TEST_DATA_DIR) + "/dds/" + name;
+    }
+}
+
+TEST(CorpusFilesParse)
+{
+    for (const CorpusFile& expected : Corpus)
+    {
+        AssetFile file;
+        CHECK(file.Open(CorpusPath(expected.name)));
+
+        DdsTexture texture;
+        CHECK_EQUAL(DdsResultOk, texture.Parse(file.GetData(), file.GetSize()));
+        const TextureDesc& desc = texture.GetDesc();
+        CHECK_EQUAL(expected.dimension, desc.dimension);
+        CHECK_EQUAL(expected.format, desc.format);
+        CHECK_EQUAL(expected.width, desc.width);
+        CHECK_EQUAL(expected.height, desc.height);
+        CHECK_EQUAL(expected.depth, desc.depth);
+        CHECK_EQUAL(expected.mipCount, desc.mipCount);
+        CHECK_EQUAL(expected.arraySize, desc.arraySize);
+        CHECK_EQUAL(expected.cube, desc.cube);
+
+        // The subresources fill the file after the header, and one byte less is truncated.
+        const uint32_t last = texture.GetSubresourceCount() - 1;
+        CHECK_EQUAL(expected.mipCount * expected.arraySize, texture.GetSubresourceCount());
+        CHECK_EQUAL(file.GetSize(), texture.GetSubresource(last).offset + texture.GetSubresource(last).size);
+        DdsTexture truncated;
+        CHECK_EQUAL(DdsResultTruncated, truncated.Parse(file.GetData(), file.GetSize() - 1));
+    }
+}
+
+TEST(TruncatedSeedIsRejected)
+{
+    std::vector<uint8_t> data;
+    CHECK(ReadFileBytes(CorpusPath("truncated_dxt1.dds"), data));
+    DdsTexture texture;
+    CHECK_EQUAL(DdsResultTruncated, texture.Parse(data.data(), data.size()));
+    CHECK_EQUAL(DdsResultTruncated, texture.Parse(data.data(), 100));
+    CHECK_EQUAL(DdsResultTruncated, texture.Parse(nullptr, 0));
+
+    data[0] = 'X';
+    CHECK_EQUAL(DdsResultBadMagic, texture.Parse(data.data(), data.size()));
+}
+
+// Values ID3D12Device::GetCopyableFootprints returns for the same descs.
+TEST(FootprintsMatchD3D12)
+{
+    const TextureDesc rgba = { TextureDimension2D, 28, 100, 100, 1, 1, 1, false };
+    TextureFootprint footprint;
+    CHECK_EQUAL(51088ull, static_cast<unsigned long long>(GetCopyableFootprints(rgba, 0, 1, 0, &footprint)));
+    CHECK_EQUAL(512u, footprint.rowPitch);
+    CHECK_EQUAL(400ull, static_cast<unsigned long long>(footprint.rowSize));
+
+    const TextureDesc bc1 = { TextureDimension2D, 71, 256, 256, 1, 9, 1, false };
+    TextureFootprint mips[9];
+    GetCopyableFootprints(bc1, 0, 9, 0, mips);
+    CHECK_EQUAL(512u, mips[0].rowPitch);
+    CHECK_EQUAL(64u, mips[0].rowCount);
+    CHECK_EQUAL(4u, mips[8].width);
+    CHECK_EQUAL(4u, mips[8].height);
+    CHECK_EQUAL(8ull, static_cast<unsigned long long>(mips[8].rowSize));
+    for (uint32_t mip = 1; mip < 9; ++mip)
+    {
+        CHECK_EQUAL(0ull, static_cast<unsigned long long>(mips[mip].offset % TexturePlacementAlignment));
+        CHECK(mips[mip].offset >= mips[mip - 1].offset + mips[mip - 1].rowPitch * (mips[mip - 1].rowCount - 1) + mips[mip - 1].rowSize);
+    }
+
+    const TextureDesc planar = { TextureDimension2D, 103, 64, 64, 1, 1, 1, false };
+    CHECK_EQUAL(0ull, static_cast<unsigned long long>(GetCopyableFootprints(planar, 0, 1, 0, &footprint)));
+}
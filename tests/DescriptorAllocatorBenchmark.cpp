@@ -0,0 +1,89 @@
+#include "DescriptorAllocator.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    class IdleFrameQueue : public IFrameQueue
+    {
+    public:
+        IdleFrameQueue() : m_value(0) {}
+
+        virtual void Signal(uint64_t fenceValue)    { m_value = fenceValue; }
+        virtual uint64_t GetCompletedValue()        { return m_value; }
+        virtual void WaitForValue(uint64_t)         {}
+
+    private:
+        uint64_t m_value;
+    };
+}
+
+// Allocations per second: single persistent slots in a heap kept half full,
+// ranges of 8, and per-frame transient ranges.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t capacity = 65536;
+    const uint32_t rounds = quick ? 2 : 200;
+
+    printf("%-22s %14s %10s\n", "pattern", "allocs/s", "ns/alloc");
+
+    for (uint32_t count = 1; count <= 8; count *= 8)
+    {
+        PersistentDescriptorAllocator allocator(0, capacity);
+        std::vector<uint32_t> slots;
+        for (uint32_t i = 0; i < capacity / 2 / count; ++i)
+        {
+            slots.push_back(allocator.Allocate(count));
+        }
+
+        // Free every other allocation and allocate it again, the holes are
+        // spread over the whole heap.
+        uint64_t allocations = 0;
+        uint64_t checksum = 0;
+        BenchmarkTimer timer;
+        for (uint32_t round = 0; round < rounds; ++round)
+        {
+            for (size_t i = round % 2; i < slots.size(); i += 2)
+            {
+                allocator.Free(slots[i], count);
+            }
+            for (size_t i = round % 2; i < slots.size(); i += 2)
+            {
+                slots[i] = allocator.Allocate(count);
+                checksum += slots[i];
+                allocations++;
+            }
+        }
+        const double milliseconds = timer.GetMilliseconds();
+        KeepResult(checksum);
+
+        char name[32];
+        snprintf(name, sizeof(name), "persistent x%u", count);
+        printf("%-22s %14.0f %10.2f\n", name, allocations / milliseconds * 1000.0, milliseconds * 1e6 / allocations);
+    }
+
+    IdleFrameQueue queue;
+    TransientDescriptorAllocator transient(0, capacity);
+    const uint32_t frames = quick ? 10 : 10000;
+    const uint32_t perFrame = 1024;
+    uint64_t checksum = 0;
+    BenchmarkTimer timer;
+    for (uint32_t frame = 1; frame <= frames; ++frame)
+    {
+        transient.ReleaseCompleted(frame > 2 ? frame - 2 : 0);
+        for (uint32_t i = 0; i < perFrame; ++i)
+        {
+            checksum += transient.Allocate(4, queue);
+        }
+        transient.FinishFrame(frame);
+    }
+    const double milliseconds = timer.GetMilliseconds();
+    KeepResult(checksum);
+
+    const double allocations = static_cast<double>(frames) * perFrame;
+    printf("%-22s %14.0f %10.2f\n", "transient x4", allocations / milliseconds * 1000.0, milliseconds * 1e6 / allocations);
+    return 0;
+}
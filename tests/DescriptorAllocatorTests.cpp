@@ -0,0 +1,190 @@
+#include "DescriptorAllocator.h"
+#include "TestHarness.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    class FakeFrameQueue : public IFrameQueue
+    {
+    public:
+        FakeFrameQueue() : completedValue(0), waits(0) {}
+
+        virtual void Signal(uint64_t)                   {}
+        virtual uint64_t GetCompletedValue()            { return completedValue; }
+        virtual void WaitForValue(uint64_t fenceValue)
+        {
+            waits++;
+            completedValue = fenceValue > completedValue ? fenceValue : completedValue;
+        }
+
+        uint64_t completedValue;
+        uint32_t waits;
+    };
+
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed) {}
+
+        uint32_t Next(uint32_t range)
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return (m_state >> 8) % range;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+}
+
+TEST(SingleSlotsComeLowestFirst)
+{
+    PersistentDescriptorAllocator allocator(10, 100);
+    CHECK_EQUAL(10u, allocator.Allocate());
+    CHECK_EQUAL(11u, allocator.Allocate());
+    CHECK_EQUAL(12u, allocator.Allocate());
+    CHECK_EQUAL(3u, allocator.GetAllocatedCount());
+
+    // A freed slot is the next one handed out.
+    allocator.Free(11);
+    CHECK_EQUAL(11u, allocator.Allocate());
+    CHECK_EQUAL(13u, allocator.Allocate());
+}
+
+TEST(NeverHandsOutSlotsPastTheEnd)
+{
+    // 70 slots: the second word only has 6.
+    PersistentDescriptorAllocator allocator(0, 70);
+    for (uint32_t i = 0; i < 70; ++i)
+    {
+        CHECK_EQUAL(i, allocator.Allocate());
+    }
+    CHECK_EQUAL(PersistentDescriptorAllocator::InvalidIndex, allocator.Allocate());
+    CHECK_EQUAL(70u, allocator.GetAllocatedCount());
+
+    allocator.Free(69);
+    CHECK_EQUAL(PersistentDescriptorAllocator::InvalidIndex, allocator.Allocate(2));
+    CHECK_EQUAL(69u, allocator.Allocate());
+}
+
+TEST(RangesAreFirstFitAcrossWords)
+{
+    PersistentDescriptorAllocator allocator(0, 256);
+    CHECK_EQUAL(0u, allocator.Allocate(60));
+    CHECK_EQUAL(60u, allocator.Allocate(8));     // Straddles the first two words.
+    CHECK_EQUAL(68u, allocator.Allocate(1));
+    allocator.Free(0, 60);
+
+    // The hole at 0 fits 60, not 61.
+    CHECK_EQUAL(69u, allocator.Allocate(61));
+    CHECK_EQUAL(0u, allocator.Allocate(60));
+    CHECK_EQUAL(PersistentDescriptorAllocator::InvalidIndex, allocator.Allocate(200));
+    CHECK_EQUAL(PersistentDescriptorAllocator::InvalidIndex, allocator.Allocate(0));
+}
+
+TEST(RejectsBadFrees)
+{
+    PersistentDescriptorAllocator allocator(16, 64);
+    allocator.Allocate(4);
+
+    CHECK_THROWS(allocator.Free(15), std::out_of_range);
+    CHECK_THROWS(allocator.Free(80), std::out_of_range);
+    CHECK_THROWS(allocator.Free(70, 20), std::out_of_range);
+    CHECK_THROWS(allocator.Free(18, 4), std::logic_error);
+
+    allocator.Free(16, 4);
+    CHECK_THROWS(allocator.Free(16), std::logic_error);
+    CHECK_EQUAL(0u, allocator.GetAllocatedCount());
+}
+
+// Random allocations and frees of 1 to 8 slots against a plain array of flags.
+TEST(RandomUseAgainstAModel)
+{
+    const uint32_t capacity = 1000;
+    PersistentDescriptorAllocator allocator(5, capacity);
+    std::vector<bool> used(capacity, false);
+    struct Allocation { uint32_t slot; uint32_t count; };
+    std::vector<Allocation> allocations;
+    Random random(7);
+
+    for (uint32_t step = 0; step < 20000; ++step)
+    {
+        if (!allocations.empty() && random.Next(2) == 0)
+        {
+            const uint32_t pick = random.Next(static_cast<uint32_t>(allocations.size()));
+            const Allocation allocation = allocations[pick];
+            allocations[pick] = allocations.back();
+            allocations.pop_back();
+
+            allocator.Free(5 + allocation.slot, allocation.count);
+            for (uint32_t i = 0; i < allocation.count; ++i)
+            {
+                used[allocation.slot + i] = false;
+            }
+            continue;
+        }
+
+        const uint32_t count = random.Next(4) == 0 ? 1 + random.Next(8) : 1;
+        const uint32_t index = allocator.Allocate(count);
+
+        // First fit: the lowest run of count free slots of the model.
+        uint32_t expected = PersistentDescriptorAllocator::InvalidIndex;
+        for (uint32_t slot = 0, run = 0; slot < capacity; ++slot)
+        {
+            run = used[slot] ? 0 : run + 1;
+            if (run == count)
+            {
+                expected = slot + 1 - count;
+                break;
+            }
+        }
+
+        if (expected == PersistentDescriptorAllocator::InvalidIndex)
+        {
+            CHECK_EQUAL(PersistentDescriptorAllocator::InvalidIndex, index);
+            continue;
+        }
+        CHECK_EQUAL(5 + expected, index);
+        if (index != 5 + expected)
+        {
+            return;
+        }
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            used[expected + i] = true;
+        }
+        const Allocation allocation = { expected, count };
+        allocations.push_back(allocation);
+    }
+
+    uint32_t usedCount = 0;
+    for (bool slot : used)
+    {
+        usedCount += slot ? 1 : 0;
+    }
+    CHECK_EQUAL(usedCount, allocator.GetAllocatedCount());
+}
+
+TEST(TransientRangesAreRecycledByFence)
+{
+    FakeFrameQueue queue;
+    TransientDescriptorAllocator allocator(100, 16);
+    CHECK_EQUAL(100u, allocator.Allocate(6, queue));
+    CHECK_EQUAL(106u, allocator.Allocate(6, queue));
+    allocator.FinishFrame(1);
+    CHECK_EQUAL(12u, allocator.GetUsedCount());
+
+    // Four left at the end: a range of 6 waits for frame 1 and wraps to 100.
+    CHECK_EQUAL(100u, allocator.Allocate(6, queue));
+    CHECK_EQUAL(1u, queue.waits);
+    CHECK_EQUAL(1ull, queue.completedValue);
+    allocator.FinishFrame(2);
+
+    allocator.ReleaseCompleted(2);
+    CHECK_EQUAL(0u, allocator.GetUsedCount());
+    CHECK_EQUAL(100u, allocator.Allocate(16, queue));
+    CHECK_EQUAL(16u, allocator.GetCapacity());
+}
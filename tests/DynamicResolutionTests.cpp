@@ -0,0 +1,185 @@
+#include "DynamicResolution.h"
+#include "TestHarness.h"
+
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* TracePath = TEST_DATA_DIR "/dynres_trace.txt";
+
+    // Cost of the passes that do not scale with the resolution in the
+    // simulations: the quad and the blur setup of the sample.
+    const double FixedMs = 1.5;
+
+    bool WriteText(const std::string& path, const std::string& text)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file)
+        {
+            return false;
+        }
+        const bool written = fwrite(text.data(), 1, text.size(), file) == text.size();
+        return fclose(file) == 0 && written;
+    }
+}
+
+TEST(SteadyLoadSettlesUnderTheBudget)
+{
+    DynamicResolutionSettings settings;
+    DynamicResolutionController controller(settings);
+
+    // 24 ms at full resolution, two frames of latency.
+    std::vector<double> scales(1, controller.GetScale());
+    double ms = 0.0;
+    for (uint32_t frame = 0; frame < 200; ++frame)
+    {
+        ms = 24.0 * scales.back() * scales.back();
+        const size_t measured = scales.size() > 2 ? scales.size() - 3 : 0;
+        scales.push_back(controller.Update(24.0 * scales[measured] * scales[measured], scales[measured]));
+    }
+
+    // Within the deadband of the budget minus its headroom.
+    const double targetMs = settings.targetMs * (1.0 - settings.headroom);
+    CHECK(ms <= targetMs * (1.0 + settings.deadband));
+    CHECK(ms >= targetMs * (1.0 - 2.0 * settings.deadband));
+    CHECK_NEAR(scales[scales.size() - 2], scales.back(), 1e-9);
+}
+
+TEST(ScaleStaysWithinItsLimits)
+{
+    DynamicResolutionSettings settings;
+    settings.minScale = 0.6;
+    settings.maxScale = 0.9;
+    DynamicResolutionController controller(settings);
+    CHECK_NEAR(0.9, controller.GetScale(), 1e-12);
+
+    double scale = controller.GetScale();
+    for (uint32_t frame = 0; frame < 50; ++frame)
+    {
+        scale = controller.Update(100.0 * scale * scale, scale);
+    }
+    CHECK_NEAR(0.6, scale, 1e-12);
+
+    for (uint32_t frame = 0; frame < 200; ++frame)
+    {
+        scale = controller.Update(1.0 * scale * scale, scale);
+    }
+    CHECK_NEAR(0.9, scale, 1e-12);
+
+    controller.Reset();
+    CHECK_NEAR(0.9, controller.GetScale(), 1e-12);
+}
+
+TEST(PanicDropsOnceForAStaleSpike)
+{
+    DynamicResolutionSettings settings;
+    DynamicResolutionController controller(settings);
+
+    // A frame three times over budget drops the area at once to what fits.
+    const double targetMs = settings.targetMs * (1.0 - settings.headroom);
+    const double dropped = controller.Update(3.0 * settings.targetMs, 1.0);
+    CHECK_NEAR(std::sqrt(targetMs / (3.0 * settings.targetMs)), dropped, 1e-9);
+
+    // The frames in flight were rendered at full size before the drop and
+    // say the same, they must not drop it again.
+    CHECK_NEAR(dropped, controller.Update(3.0 * settings.targetMs, 1.0), 1e-9);
+    CHECK_NEAR(dropped, controller.Update(3.0 * settings.targetMs, 1.0), 1e-9);
+}
+
+TEST(MissingMeasurementsKeepTheScale)
+{
+    DynamicResolutionController controller;
+    CHECK_NEAR(1.0, controller.Update(0.0, 1.0), 1e-12);
+    CHECK_NEAR(1.0, controller.Update(-1.0, 1.0), 1e-12);
+
+    DynamicResolutionSettings settings;
+    settings.minScale = 1.5;
+    CHECK_THROWS(DynamicResolutionController bad(settings), std::invalid_argument);
+}
+
+TEST(ScaledSizeIsAlignedAndClamped)
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    DynamicResolutionController::GetScaledSize(0.75, 1280, 720, 8, width, height);
+    CHECK_EQUAL(960u, width);
+    CHECK_EQUAL(536u, height);
+
+    DynamicResolutionController::GetScaledSize(0.001, 1280, 720, 8, width, height);
+    CHECK_EQUAL(8u, width);
+    CHECK_EQUAL(8u, height);
+
+    DynamicResolutionController::GetScaledSize(1.0, 1283, 721, 8, width, height);
+    CHECK_EQUAL(1280u, width);
+    CHECK_EQUAL(720u, height);
+}
+
+TEST(TraceFilesRoundTrip)
+{
+    const std::string path = "DynamicResolutionTests.trace.txt";
+    const std::vector<double> trace = { 12.5, 0.25, 33.125 };
+    CHECK(SaveDynamicResolutionTrace(path, trace, "Two lines\nof comment"));
+
+    std::vector<double> loaded;
+    CHECK(LoadDynamicResolutionTrace(path, loaded));
+    CHECK_EQUAL(trace.size(), loaded.size());
+    for (size_t i = 0; i < trace.size() && i < loaded.size(); ++i)
+    {
+        CHECK_NEAR(trace[i], loaded[i], 1e-9);
+    }
+
+    // CRLF, blank lines and trailing blanks are accepted, anything else is not.
+    CHECK(WriteText(path, "# comment\r\n1.5\r\n\r\n2 \r\n"));
+    CHECK(LoadDynamicResolutionTrace(path, loaded));
+    CHECK_EQUAL(2u, loaded.size());
+    CHECK(WriteText(path, "1.5\n2ms\n"));
+    CHECK(!LoadDynamicResolutionTrace(path, loaded));
+    CHECK(WriteText(path, "-1\n"));
+    CHECK(!LoadDynamicResolutionTrace(path, loaded));
+    CHECK(!LoadDynamicResolutionTrace("DynamicResolutionTests.missing.txt", loaded));
+    remove(path.c_str());
+}
+
+// The trace in tests/data goes from 12 to 30 ms at full resolution with a spike
+// every 350 frames, against a 16 ms budget. Whatever the readback latency,
+// the controller has to keep all but the spikes within the budget without
+// giving away more resolution than the load needs; rendering at full size
+// misses the budget on most frames.
+TEST(TraceStaysWithinBudget)
+{
+    std::vector<double> trace;
+    CHECK(LoadDynamicResolutionTrace(TracePath, trace));
+    CHECK_EQUAL(3000u, trace.size());
+    if (trace.empty())
+    {
+        return;
+    }
+
+    DynamicResolutionSettings settings;
+    settings.targetMs = 16.0;
+
+    for (uint32_t latency = 0; latency <= 4; latency += 2)
+    {
+        const DynamicResolutionSimulation result = SimulateDynamicResolution(settings, trace, FixedMs, latency);
+        printf("latency %u: %u of %u frames over budget, average %.2f ms, max %.2f ms, average scale %.3f, min %.3f\n",
+            latency, result.framesOverBudget, result.frames, result.averageMs, result.maxMs, result.averageScale, result.minScale);
+
+        CHECK_EQUAL(3000u, result.frames);
+        CHECK(result.framesOverBudget <= result.frames / 100);
+        CHECK(result.averageMs <= settings.targetMs * (1.0 - settings.headroom));
+        CHECK(result.averageMs >= settings.targetMs * (1.0 - 2.0 * settings.headroom));
+        CHECK(result.averageScale >= 0.8);
+        CHECK(result.minScale >= settings.minScale);
+    }
+
+    DynamicResolutionSettings fixed = settings;
+    fixed.minScale = 1.0;
+    fixed.maxScale = 1.0;
+    const DynamicResolutionSimulation full = SimulateDynamicResolution(fixed, trace, FixedMs, 2);
+    CHECK(full.framesOverBudget > full.frames / 2);
+    CHECK_EQUAL(0u, full.scaleChanges);
+}
@@ -0,0 +1,204 @@
+#include "FrameLoop.h"
+#include "TestHarness.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Records the packets it renders. With a gate, OnRender blocks until
+    // the gate is opened, to hold the render thread on a packet.
+    class GatedBackend : public IFrameBackend
+    {
+    public:
+        GatedBackend() : updates(0), m_gated(false) {}
+
+        virtual void OnInit()                           {}
+        virtual void OnUpdate(double /*stepSeconds*/)   { updates++; }
+        virtual void OnPreparePacket(const FramePacket& packet) { prepared.push_back(packet); }
+        virtual void OnDestroy()                        {}
+
+        virtual void OnRender(const FramePacket& packet)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_opened.wait(lock, [&]() { return !m_gated; });
+            rendered.push_back(packet);
+        }
+
+        void SetGate(bool closed)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_gated = closed;
+            }
+            m_opened.notify_all();
+        }
+
+        uint32_t updates;
+        std::vector<FramePacket> prepared;
+        std::vector<FramePacket> rendered;      // Read once the loop has stopped.
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_opened;
+        bool m_gated;
+    };
+
+    // Seconds of CPU time used by the process, all threads included.
+    double ProcessCpuSeconds()
+    {
+        return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+    }
+}
+
+TEST(StepsFollowTheClock)
+{
+    GatedBackend backend;
+    FrameLoopSettings settings;
+    settings.stepSeconds = 0.25;
+    FrameLoop loop(backend, settings);
+
+    loop.Start(10.0);
+    loop.Tick(10.1);            // No whole step yet.
+    loop.Tick(10.6);            // Two steps, 0.1 left over.
+    loop.Tick(10.5);            // The clock went back, nothing happens.
+    loop.Tick(10.75);           // 0.35: one step.
+    loop.Stop();
+
+    CHECK_EQUAL(3u, backend.updates);
+    CHECK_EQUAL(4u, backend.prepared.size());
+    CHECK_EQUAL(0u, backend.prepared[0].steps);
+    CHECK_EQUAL(2u, backend.prepared[1].steps);
+    CHECK_EQUAL(0u, backend.prepared[2].steps);
+    CHECK_EQUAL(1u, backend.prepared[3].steps);
+    CHECK_NEAR(0.4, backend.prepared[0].alpha, 1e-9);
+    CHECK_NEAR(0.4, backend.prepared[1].alpha, 1e-9);
+    CHECK_NEAR(0.4, backend.prepared[3].alpha, 1e-9);
+    CHECK_NEAR(0.75, backend.prepared[3].time, 1e-9);
+
+    const FrameLoopStats stats = loop.GetStats();
+    CHECK_EQUAL(4ull, stats.ticks);
+    CHECK_EQUAL(3ull, stats.steps);
+    CHECK_EQUAL(4ull, stats.packetsRendered);
+    CHECK_EQUAL(0ull, stats.slotWaits);
+    CHECK_NEAR(0.75, stats.simulationSeconds, 1e-9);
+}
+
+TEST(FallingBehindDropsWholeSteps)
+{
+    GatedBackend backend;
+    FrameLoopSettings settings;
+    settings.stepSeconds = 0.1;
+    settings.maxStepsPerTick = 3;
+    FrameLoop loop(backend, settings);
+
+    loop.Start(0.0);
+    loop.Tick(1.05);
+    loop.Stop();
+
+    CHECK_EQUAL(3u, backend.updates);
+    const FrameLoopStats stats = loop.GetStats();
+    CHECK_NEAR(0.7, stats.droppedSeconds, 1e-9);
+    CHECK_NEAR(0.5, backend.prepared[0].alpha, 1e-6);
+}
+
+TEST(PacketsAreRenderedInOrderOnTheRenderThread)
+{
+    GatedBackend backend;
+    FrameLoopSettings settings;
+    settings.renderThread = true;
+    FrameLoop loop(backend, settings);
+
+    loop.Start(0.0);
+    for (uint32_t frame = 1; frame <= 100; ++frame)
+    {
+        loop.Tick(frame / 60.0);
+    }
+    loop.Stop();
+    CHECK(!loop.IsRunning());
+
+    CHECK_EQUAL(100u, backend.rendered.size());
+    for (uint32_t frame = 0; frame < backend.rendered.size(); ++frame)
+    {
+        CHECK_EQUAL(static_cast<uint64_t>(frame), backend.rendered[frame].frame);
+        CHECK(backend.rendered[frame].slot < FramePacketSlotCount);
+    }
+    CHECK_EQUAL(100ull, loop.GetStats().packetsRendered);
+
+    // The loop starts again with every slot free.
+    loop.Start(10.0);
+    loop.Tick(10.1);
+    loop.Stop();
+    CHECK_EQUAL(101u, backend.rendered.size());
+}
+
+TEST(TickWaitsForAFreeSlot)
+{
+    GatedBackend backend;
+    FrameLoopSettings settings;
+    settings.renderThread = true;
+    FrameLoop loop(backend, settings);
+
+    // The render thread holds the first packet, the other slots fill up and
+    // the next tick has to wait until the gate opens.
+    backend.SetGate(true);
+    loop.Start(0.0);
+    for (uint32_t frame = 0; frame < FramePacketSlotCount; ++frame)
+    {
+        loop.Tick(0.0);
+    }
+    CHECK_EQUAL(0ull, loop.GetStats().slotWaits);
+
+    std::thread opener([&]()
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        backend.SetGate(false);
+    });
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    loop.Tick(0.0);
+    const double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    opener.join();
+    loop.Stop();
+
+    CHECK(waited >= 0.04);
+    CHECK_EQUAL(1ull, loop.GetStats().slotWaits);
+    CHECK_EQUAL(static_cast<size_t>(FramePacketSlotCount + 1), backend.rendered.size());
+}
+
+TEST(IdleRenderThreadSleeps)
+{
+    GatedBackend backend;
+    FrameLoopSettings settings;
+    settings.renderThread = true;
+    FrameLoop loop(backend, settings);
+
+    // A render thread spinning for packets would use the whole 300 ms.
+    loop.Start(0.0);
+    loop.Tick(0.0);
+    const double cpuStart = ProcessCpuSeconds();
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const double cpuSeconds = ProcessCpuSeconds() - cpuStart;
+    loop.Tick(1.0);
+    loop.Stop();
+
+    CHECK(cpuSeconds < 0.1);
+    CHECK_EQUAL(2u, backend.rendered.size());
+}
+
+TEST(MisuseThrows)
+{
+    GatedBackend backend;
+    FrameLoopSettings settings;
+    settings.stepSeconds = 0.0;
+    CHECK_THROWS(FrameLoop(backend, settings), std::invalid_argument);
+
+    FrameLoop loop(backend);
+    loop.Start(0.0);
+    CHECK_THROWS(loop.Start(0.0), std::logic_error);
+    loop.Stop();
+}
@@ -0,0 +1,85 @@
+#include "FrameScheduler.h"
+#include "Benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace
+{
+    // Queue that is always done, what is left is the cost of the scheduler.
+    class IdleFrameQueue : public IFrameQueue
+    {
+    public:
+        IdleFrameQueue() : m_value(0) {}
+
+        virtual void Signal(uint64_t fenceValue)    { m_value = fenceValue; }
+        virtual uint64_t GetCompletedValue()        { return m_value; }
+        virtual void WaitForValue(uint64_t)         {}
+
+    private:
+        uint64_t m_value;
+    };
+
+    void BusyWait(std::chrono::microseconds duration)
+    {
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+}
+
+// Frame rate, stalls and latency of 1 to 4 frames in flight, CPU bound and GPU
+// bound, then the overhead of a frame with nothing to wait for.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t frameCount = quick ? 20 : 300;
+
+    struct Workload
+    {
+        const char* name;
+        std::chrono::microseconds cpu;
+        std::chrono::microseconds gpu;
+    };
+    const Workload workloads[] =
+    {
+        { "cpu bound", std::chrono::microseconds(2000), std::chrono::microseconds(1000) },
+        { "gpu bound", std::chrono::microseconds(1000), std::chrono::microseconds(2000) },
+        { "balanced", std::chrono::microseconds(1500), std::chrono::microseconds(1500) }
+    };
+
+    printf("%-10s %6s %8s %8s %10s %10s\n", "workload", "frames", "fps", "stalled", "avg lat ms", "max lat ms");
+    for (const Workload& workload : workloads)
+    {
+        for (uint32_t framesInFlight = 1; framesInFlight <= 4; ++framesInFlight)
+        {
+            SimulatedFrameQueue queue(workload.gpu);
+            FrameScheduler scheduler(&queue, framesInFlight);
+            for (uint32_t frame = 0; frame < frameCount; ++frame)
+            {
+                scheduler.BeginFrame();
+                BusyWait(workload.cpu);
+                scheduler.EndFrame();
+            }
+            scheduler.WaitForIdle();
+
+            const FrameSchedulerStats stats = scheduler.GetStats();
+            printf("%-10s %6u %8.1f %8llu %10.2f %10.2f\n", workload.name, framesInFlight, stats.framesPerSecond,
+                static_cast<unsigned long long>(stats.framesStalled), stats.averageLatencyMs, stats.maxLatencyMs);
+        }
+    }
+
+    IdleFrameQueue queue;
+    FrameScheduler scheduler(&queue, 3);
+    const uint32_t overheadFrames = quick ? 1000 : 10000000;
+    BenchmarkTimer timer;
+    for (uint32_t frame = 0; frame < overheadFrames; ++frame)
+    {
+        scheduler.BeginFrame();
+        scheduler.EndFrame();
+    }
+    printf("overhead: %.1f ns per frame\n", timer.GetMilliseconds() * 1e6 / overheadFrames);
+    return 0;
+}
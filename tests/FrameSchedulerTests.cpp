@@ -0,0 +1,183 @@
+#include "FrameScheduler.h"
+#include "TestHarness.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Queue whose GPU only progresses when the test says so. A wait completes
+    // the GPU up to the value waited for and is recorded.
+    class ManualFrameQueue : public IFrameQueue
+    {
+    public:
+        ManualFrameQueue() : completedValue(0) {}
+
+        virtual void Signal(uint64_t fenceValue)            { signals.push_back(fenceValue); }
+        virtual uint64_t GetCompletedValue()                { return completedValue; }
+        virtual void WaitForValue(uint64_t fenceValue)
+        {
+            waits.push_back(fenceValue);
+            completedValue = fenceValue > completedValue ? fenceValue : completedValue;
+        }
+
+        uint64_t completedValue;
+        std::vector<uint64_t> signals;
+        std::vector<uint64_t> waits;
+    };
+}
+
+TEST(RejectsInvalidArguments)
+{
+    ManualFrameQueue queue;
+    CHECK_THROWS(FrameScheduler(nullptr, 2), std::invalid_argument);
+    CHECK_THROWS(FrameScheduler(&queue, 0), std::invalid_argument);
+}
+
+TEST(BlocksOnlyAFullRingAhead)
+{
+    ManualFrameQueue queue;
+    FrameScheduler scheduler(&queue, 3);
+
+    // Three frames go out without the GPU finishing any.
+    for (uint32_t frame = 0; frame < 3; ++frame)
+    {
+        CHECK_EQUAL(frame, scheduler.BeginFrame());
+        CHECK_EQUAL(frame + 1ull, scheduler.EndFrame());
+    }
+    CHECK(queue.waits.empty());
+
+    // The fourth reuses the slot of the first and waits for its fence only.
+    CHECK_EQUAL(0u, scheduler.BeginFrame());
+    CHECK_EQUAL(1u, queue.waits.size());
+    CHECK_EQUAL(1ull, queue.waits[0]);
+    scheduler.EndFrame();
+
+    CHECK_EQUAL(1u, scheduler.BeginFrame());
+    CHECK_EQUAL(2u, queue.waits.size());
+    CHECK_EQUAL(2ull, queue.waits[1]);
+    scheduler.EndFrame();
+
+    const FrameSchedulerStats stats = scheduler.GetStats();
+    CHECK_EQUAL(5ull, stats.framesSubmitted);
+    CHECK_EQUAL(2ull, stats.framesStalled);
+}
+
+TEST(DoesNotBlockWhenTheGpuKeepsUp)
+{
+    ManualFrameQueue queue;
+    FrameScheduler scheduler(&queue, 2);
+    for (uint32_t frame = 0; frame < 10; ++frame)
+    {
+        CHECK_EQUAL(frame % 2, scheduler.BeginFrame());
+        queue.completedValue = scheduler.EndFrame();
+    }
+
+    CHECK(queue.waits.empty());
+    CHECK_EQUAL(0ull, scheduler.GetStats().framesStalled);
+}
+
+TEST(SingleFrameInFlightWaitsEveryFrame)
+{
+    ManualFrameQueue queue;
+    FrameScheduler scheduler(&queue, 1);
+    for (uint32_t frame = 0; frame < 4; ++frame)
+    {
+        CHECK_EQUAL(0u, scheduler.BeginFrame());
+        scheduler.EndFrame();
+    }
+
+    // Every frame but the first waits for the one before it.
+    CHECK_EQUAL(3u, queue.waits.size());
+    CHECK_EQUAL(3ull, scheduler.GetStats().framesStalled);
+}
+
+TEST(FenceValuesStartAfterTheCompletedValue)
+{
+    ManualFrameQueue queue;
+    queue.completedValue = 41;
+    FrameScheduler scheduler(&queue, 2);
+
+    CHECK_EQUAL(42ull, scheduler.GetCurrentFenceValue());
+    scheduler.BeginFrame();
+    CHECK_EQUAL(42ull, scheduler.EndFrame());
+    CHECK_EQUAL(43ull, scheduler.GetCurrentFenceValue());
+}
+
+TEST(RejectsUnbalancedFrames)
+{
+    ManualFrameQueue queue;
+    FrameScheduler scheduler(&queue, 2);
+    CHECK_THROWS(scheduler.EndFrame(), std::logic_error);
+
+    scheduler.BeginFrame();
+    CHECK_THROWS(scheduler.BeginFrame(), std::logic_error);
+}
+
+TEST(WaitForIdleCoversWorkOutsideFrames)
+{
+    ManualFrameQueue queue;
+    FrameScheduler scheduler(&queue, 2);
+    scheduler.BeginFrame();
+    scheduler.EndFrame();
+
+    // A value of its own, past the last frame.
+    scheduler.WaitForIdle();
+    CHECK_EQUAL(2u, queue.signals.size());
+    CHECK_EQUAL(2ull, queue.signals.back());
+    CHECK_EQUAL(1u, queue.waits.size());
+    CHECK_EQUAL(2ull, queue.waits.back());
+
+    // Every slot is free again.
+    scheduler.BeginFrame();
+    scheduler.EndFrame();
+    scheduler.BeginFrame();
+    CHECK_EQUAL(1u, queue.waits.size());
+}
+
+TEST(SimulatedQueueCompletesInOrderAtItsFrameTime)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    SimulatedFrameQueue queue(std::chrono::milliseconds(2));
+    CHECK_EQUAL(0ull, queue.GetCompletedValue());
+
+    const Clock::time_point start = Clock::now();
+    for (uint64_t value = 1; value <= 5; ++value)
+    {
+        queue.Signal(value);
+    }
+    CHECK(queue.GetCompletedValue() < 5);
+
+    // The frames run back to back, the last one 10 ms after the first started.
+    queue.WaitForValue(5);
+    CHECK_EQUAL(5ull, queue.GetCompletedValue());
+    CHECK(Clock::now() - start >= std::chrono::milliseconds(10));
+}
+
+TEST(GpuBoundFramesAreStalledAndPacedByTheGpu)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // GPU frames long enough that the CPU thread being descheduled on a busy
+    // machine does not let a frame retire before the CPU gets to it.
+    SimulatedFrameQueue queue(std::chrono::milliseconds(10));
+    FrameScheduler scheduler(&queue, 2);
+
+    const Clock::time_point start = Clock::now();
+    for (uint32_t frame = 0; frame < 20; ++frame)
+    {
+        scheduler.BeginFrame();
+        scheduler.EndFrame();
+    }
+    scheduler.WaitForIdle();
+
+    // The CPU has nothing to do, so it waits on nearly every frame and the run
+    // takes as long as the GPU frames.
+    const FrameSchedulerStats stats = scheduler.GetStats();
+    CHECK(Clock::now() - start >= std::chrono::milliseconds(200));
+    CHECK(stats.framesStalled >= 17);
+    CHECK(stats.averageLatencyMs >= 10.0);
+    CHECK(stats.maxLatencyMs >= stats.averageLatencyMs);
+}
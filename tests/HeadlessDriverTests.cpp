@@ -0,0 +1,74 @@
+#include "HeadlessDriver.h"
+#include "FrameBackend.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    size_t CountCalls(const NullFrameBackend& backend, NullFrameBackend::Call call)
+    {
+        const std::vector<NullFrameBackend::Call>& calls = backend.GetCalls();
+        return static_cast<size_t>(std::count(calls.begin(), calls.end(), call));
+    }
+
+    void CheckRun(const FrameLoopSettings& settings)
+    {
+        NullFrameBackend backend(2, std::chrono::microseconds(100));
+        const HeadlessRunStats stats = HeadlessDriver::Run(backend, 50, settings);
+
+        CHECK_EQUAL(50u, stats.frameCount);
+        CHECK(stats.seconds > 0.0);
+        CHECK(stats.framesPerSecond > 0.0);
+        CHECK_EQUAL(50ull, stats.loop.ticks);
+        CHECK_EQUAL(50ull, stats.loop.packetsRendered);
+
+        // Init first, destroy last, every frame prepared and rendered in order.
+        const std::vector<NullFrameBackend::Call>& calls = backend.GetCalls();
+        CHECK(!calls.empty() && calls.front() == NullFrameBackend::CallInit);
+        CHECK(!calls.empty() && calls.back() == NullFrameBackend::CallDestroy);
+        CHECK_EQUAL(50u, CountCalls(backend, NullFrameBackend::CallPreparePacket));
+        CHECK_EQUAL(50u, CountCalls(backend, NullFrameBackend::CallRender));
+        CHECK_EQUAL(static_cast<size_t>(stats.loop.steps), CountCalls(backend, NullFrameBackend::CallUpdate));
+        CHECK_EQUAL(50ull, backend.GetFramesRendered());
+        CHECK_EQUAL(0ull, backend.GetPacketErrors());
+
+        // Once before the timed frames and once after them.
+        CHECK_EQUAL(2u, CountCalls(backend, NullFrameBackend::CallWaitForIdle));
+        CHECK_EQUAL(50ull, backend.GetSchedulerStats().framesSubmitted);
+    }
+}
+
+TEST(RunsTheFramesOnTheSimulationThread)
+{
+    CheckRun(FrameLoopSettings());
+}
+
+TEST(RunsTheFramesOnARenderThread)
+{
+    FrameLoopSettings settings;
+    settings.renderThread = true;
+    CheckRun(settings);
+}
+
+TEST(FrameRateFollowsTheGpu)
+{
+    // 30 frames of 2 ms on the GPU cannot take less than 60 ms.
+    NullFrameBackend backend(3, std::chrono::milliseconds(2));
+    const HeadlessRunStats stats = HeadlessDriver::Run(backend, 30);
+    CHECK(stats.seconds >= 0.06);
+    CHECK(stats.framesPerSecond <= 500.0);
+}
+
+TEST(RecordsTheDrawsOfEveryFrame)
+{
+    NullFrameBackend backend(2, std::chrono::microseconds(0));
+    backend.SetRecordingWorkload(2, 1000);
+    HeadlessDriver::Run(backend, 10);
+
+    const CommandRecorderStats stats = backend.GetRecorderStats();
+    CHECK_EQUAL(10ull, backend.GetFramesRendered());
+    CHECK_EQUAL(10ull, stats.frames);
+    CHECK_EQUAL(160ull, stats.tasks);
+}
@@ -0,0 +1,88 @@
+#include "HeadlessDriver.h"
+#include "FrameBackend.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// The -headless mode of the sample with NullFrameBackend in place of the
+// renderer: runs N frames (1000 by default) through HeadlessDriver and
+// reports the frame rate.
+//
+//   HeadlessRunner [N] [-renderthread] [-step HZ] [-gpu US] [-update US] [-draws N] [-threads N]
+int main(int argc, char** argv)
+{
+    uint32_t frameCount = 1000;
+    uint32_t framesInFlight = 2;
+    uint32_t gpuMicroseconds = 1000;
+    uint32_t updateMicroseconds = 0;
+    uint32_t draws = 0;
+    uint32_t threads = 1;
+    FrameLoopSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "-renderthread") == 0)
+        {
+            settings.renderThread = true;
+        }
+        else if (strcmp(argv[i], "-step") == 0 && hasValue)
+        {
+            settings.stepSeconds = 1.0 / atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-gpu") == 0 && hasValue)
+        {
+            gpuMicroseconds = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "-update") == 0 && hasValue)
+        {
+            updateMicroseconds = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "-draws") == 0 && hasValue)
+        {
+            draws = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if (strcmp(argv[i], "-threads") == 0 && hasValue)
+        {
+            threads = static_cast<uint32_t>(atoi(argv[++i]));
+        }
+        else if (atoi(argv[i]) > 0)
+        {
+            frameCount = static_cast<uint32_t>(atoi(argv[i]));
+        }
+        else
+        {
+            fprintf(stderr, "Unknown argument %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    NullFrameBackend backend(framesInFlight, std::chrono::microseconds(gpuMicroseconds));
+    backend.SetUpdateWorkload(std::chrono::microseconds(updateMicroseconds));
+    if (draws)
+    {
+        backend.SetRecordingWorkload(threads, draws);
+    }
+
+    const HeadlessRunStats stats = HeadlessDriver::Run(backend, frameCount, settings);
+    printf("Headless: %u frames in %.3f s (%.1f fps), %llu simulation steps\n", stats.frameCount, stats.seconds, stats.framesPerSecond,
+        static_cast<unsigned long long>(stats.loop.steps));
+    if (draws)
+    {
+        const CommandRecorderStats recorder = backend.GetRecorderStats();
+        printf("Recording: %u draws on %u threads, %.3f ms per frame, %llu lists in %llu frames\n", draws, threads,
+            recorder.frames ? recorder.totalRecordMs / recorder.frames : 0.0, static_cast<unsigned long long>(recorder.lists),
+            static_cast<unsigned long long>(recorder.frames));
+    }
+
+    // A frame out of order or from the wrong slot is a bug of the loop.
+    if (backend.GetFramesRendered() != frameCount || backend.GetPacketErrors())
+    {
+        fprintf(stderr, "%llu frames rendered, %llu packet errors\n", static_cast<unsigned long long>(backend.GetFramesRendered()),
+            static_cast<unsigned long long>(backend.GetPacketErrors()));
+        return 1;
+    }
+    return 0;
+}
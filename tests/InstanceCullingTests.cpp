@@ -0,0 +1,159 @@
+#include "InstanceCulling.h"
+#include "TestHarness.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    const CullRect Screen = { -1.0f, -1.0f, 1.0f, 1.0f };
+
+    // Runs both versions on the set and checks they agree: the same count, the
+    // same visible instances in the same order, the same draw arguments, and
+    // nothing written past the capacity.
+    uint32_t CheckMatchesReference(const InstanceSet& instances, const CullRect& rect, float boundingRadius)
+    {
+        const uint32_t count = instances.GetCount();
+        InstanceData guard = {};
+        guard.scale = -1.0f;
+
+        std::vector<InstanceData> visible(count + 1, guard);
+        std::vector<InstanceData> expected(count + 1, guard);
+        IndirectDrawArguments arguments = {};
+        IndirectDrawArguments expectedArguments = {};
+
+        const uint32_t visibleCount = CullInstances(instances, rect, boundingRadius, visible.data(), count, 3, arguments);
+        const uint32_t expectedCount = CullInstancesReference(instances, rect, boundingRadius, expected.data(), count, 3, expectedArguments);
+
+        CHECK_EQUAL(expectedCount, visibleCount);
+        CHECK(memcmp(&expectedArguments, &arguments, sizeof(arguments)) == 0);
+        CHECK(visibleCount == 0 || memcmp(expected.data(), visible.data(), visibleCount * sizeof(InstanceData)) == 0);
+        CHECK(memcmp(&guard, &visible[count], sizeof(guard)) == 0);
+        return visibleCount;
+    }
+
+    InstanceData MakeInstance(float x, float y, float scale)
+    {
+        InstanceData instance = { { x, y }, scale, 0.5f, { 0.25f, 0.5f, 0.75f, 1.0f } };
+        return instance;
+    }
+}
+
+TEST(SetAndGetRoundTrip)
+{
+    InstanceSet instances;
+    instances.Resize(3);
+    const InstanceData instance = { { 0.25f, -0.5f }, 0.125f, 1.5f, { 0.1f, 0.2f, 0.3f, 0.4f } };
+    instances.Set(1, instance);
+
+    const InstanceData read = instances.Get(1);
+    CHECK(memcmp(&instance, &read, sizeof(instance)) == 0);
+    CHECK_EQUAL(32u, sizeof(InstanceData));
+    CHECK_EQUAL(16u, sizeof(IndirectDrawArguments));
+}
+
+TEST(ScatterIsDeterministic)
+{
+    const CullRect area = { -2.0f, -1.0f, 2.0f, 1.0f };
+    InstanceSet first;
+    InstanceSet second;
+    first.Scatter(1000, area, 0.02f, 0.08f, 7);
+    second.Scatter(1000, area, 0.02f, 0.08f, 7);
+
+    CHECK_EQUAL(1000u, first.GetCount());
+    CHECK(first.positionX == second.positionX);
+    CHECK(first.rotation == second.rotation);
+    CHECK(first.alpha == second.alpha);
+    for (uint32_t i = 0; i < first.GetCount(); ++i)
+    {
+        CHECK(first.positionX[i] >= area.minX && first.positionX[i] <= area.maxX);
+        CHECK(first.scale[i] >= 0.02f && first.scale[i] <= 0.08f);
+    }
+
+    second.Scatter(1000, area, 0.02f, 0.08f, 8);
+    CHECK(first.positionX != second.positionX);
+}
+
+TEST(KeepsTheInstancesTouchingTheRect)
+{
+    // Radius 0.5 times scale 0.2: a bounding circle of 0.1.
+    InstanceSet instances;
+    instances.Resize(6);
+    instances.Set(0, MakeInstance(0.0f, 0.0f, 0.2f));       // Inside.
+    instances.Set(1, MakeInstance(1.05f, 0.0f, 0.2f));      // Straddles the right edge.
+    instances.Set(2, MakeInstance(1.25f, 0.0f, 0.2f));      // Right of it.
+    instances.Set(3, MakeInstance(0.0f, -1.5f, 0.2f));      // Below.
+    instances.Set(4, MakeInstance(-1.0f, 1.0f, 0.2f));      // On the corner.
+    instances.Set(5, MakeInstance(0.5f, 0.5f, 0.2f));       // Inside, past the SIMD part.
+
+    std::vector<InstanceData> visible(instances.GetCount());
+    IndirectDrawArguments arguments = {};
+    CHECK_EQUAL(4u, CullInstances(instances, Screen, 0.5f, visible.data(), instances.GetCount(), 3, arguments));
+    CHECK_EQUAL(0.0f, visible[0].position[0]);
+    CHECK_EQUAL(1.05f, visible[1].position[0]);
+    CHECK_EQUAL(-1.0f, visible[2].position[0]);
+    CHECK_EQUAL(0.5f, visible[3].position[0]);
+
+    CHECK_EQUAL(3u, arguments.vertexCountPerInstance);
+    CHECK_EQUAL(4u, arguments.instanceCount);
+    CHECK_EQUAL(0u, arguments.startVertexLocation);
+    CHECK_EQUAL(0u, arguments.startInstanceLocation);
+
+    CheckMatchesReference(instances, Screen, 0.5f);
+}
+
+TEST(MatchesTheReferenceForEveryRemainder)
+{
+    // Counts around the groups of four, and large sets where every group
+    // pattern of visible and culled instances occurs.
+    const CullRect area = { -1.5f, -1.5f, 1.5f, 1.5f };
+    const uint32_t counts[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 63, 1000, 4097 };
+    for (uint32_t count : counts)
+    {
+        InstanceSet instances;
+        instances.Scatter(count, area, 0.02f, 0.3f, count + 1);
+        const uint32_t visibleCount = CheckMatchesReference(instances, Screen, 0.5f);
+        CHECK(visibleCount <= count);
+        if (count >= 1000)
+        {
+            CHECK(visibleCount > 0 && visibleCount < count);
+        }
+    }
+}
+
+TEST(MatchesTheReferenceForAnyRect)
+{
+    InstanceSet instances;
+    const CullRect area = { -1.2f, -1.2f, 1.2f, 1.2f };
+    instances.Scatter(2048, area, 0.02f, 0.08f, 11);
+
+    const CullRect rects[] =
+    {
+        { -1.0f, -1.0f, 1.0f, 1.0f },
+        { 0.0f, 0.0f, 0.25f, 0.25f },
+        { -0.1f, -2.0f, 0.1f, 2.0f },
+        { 3.0f, 3.0f, 4.0f, 4.0f },             // Nothing visible.
+        { -5.0f, -5.0f, 5.0f, 5.0f },           // Everything visible.
+    };
+    CHECK_EQUAL(0u, CheckMatchesReference(instances, rects[3], 0.5f));
+    CHECK_EQUAL(2048u, CheckMatchesReference(instances, rects[4], 0.5f));
+    for (const CullRect& rect : rects)
+    {
+        CheckMatchesReference(instances, rect, 0.5f);
+        CheckMatchesReference(instances, rect, 0.0f);
+        CheckMatchesReference(instances, rect, 4.0f);
+    }
+}
+
+TEST(OutputMustHoldEveryInstance)
+{
+    InstanceSet instances;
+    const CullRect area = { -1.0f, -1.0f, 1.0f, 1.0f };
+    instances.Scatter(8, area, 0.1f, 0.1f, 1);
+
+    std::vector<InstanceData> visible(8);
+    IndirectDrawArguments arguments = {};
+    CHECK_THROWS(CullInstances(instances, Screen, 0.5f, visible.data(), 7, 3, arguments), std::invalid_argument);
+    CHECK_THROWS(CullInstancesReference(instances, Screen, 0.5f, visible.data(), 7, 3, arguments), std::invalid_argument);
+}
@@ -0,0 +1,115 @@
+#include "MappedFile.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // What ReadDataFromFile does: one allocation and one read of the whole file.
+    uint8_t* ReadWithMalloc(const std::string& path, size_t& size)
+    {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file)
+        {
+            return nullptr;
+        }
+        fseek(file, 0, SEEK_END);
+        size = static_cast<size_t>(ftell(file));
+        fseek(file, 0, SEEK_SET);
+
+        uint8_t* data = static_cast<uint8_t*>(malloc(size));
+        if (data && fread(data, 1, size, file) != size)
+        {
+            free(data);
+            data = nullptr;
+        }
+        fclose(file);
+        return data;
+    }
+
+    // One byte per stride, all of them for a full scan.
+    uint64_t Touch(const uint8_t* data, uint64_t size, uint64_t stride)
+    {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < size; i += stride)
+        {
+            sum += data[i];
+        }
+        return sum;
+    }
+
+    // Opens, touches and closes the file iterations times, in milliseconds per open.
+    double Measure(uint32_t method, const std::string& path, uint64_t stride, uint32_t iterations)
+    {
+        uint64_t sum = 0;
+        BenchmarkTimer timer;
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            if (method == 0)
+            {
+                size_t size = 0;
+                uint8_t* data = ReadWithMalloc(path, size);
+                sum += data ? Touch(data, size, stride) : 0;
+                free(data);
+            }
+            else
+            {
+                AssetFile asset;
+                asset.Open(path, method == 1);
+                sum += Touch(asset.GetData(), asset.GetSize(), stride);
+            }
+        }
+        KeepResult(sum);
+        return timer.GetMilliseconds() / iterations;
+    }
+}
+
+// Opening an asset file from the page cache with the malloc and read of
+// ReadDataFromFile, mapped by AssetFile and streamed by AssetFile in chunks,
+// then reading one byte per 4KB page, one per 64KB (a parser looking at a
+// few headers) or every byte.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint64_t sizes[] = { 64 * 1024, 4 * 1024 * 1024, 64 * 1024 * 1024, 256 * 1024 * 1024 };
+    const uint32_t sizeCount = quick ? 2 : 4;
+    const uint64_t strides[] = { 65536, 4096, 1 };
+    const std::string path = "MappedFileBenchmark.bin";
+
+    printf("%-10s %-8s %14s %14s %14s\n", "size", "stride", "malloc+read ms", "mapped ms", "streamed ms");
+    for (uint32_t s = 0; s < sizeCount; ++s)
+    {
+        const uint64_t size = sizes[s];
+        std::vector<uint8_t> contents(static_cast<size_t>(size));
+        for (size_t i = 0; i < contents.size(); ++i)
+        {
+            contents[i] = static_cast<uint8_t>((i * 131) >> 3);
+        }
+        if (!WriteFileAtomic(path, contents.data(), contents.size()))
+        {
+            printf("cannot write %s\n", path.c_str());
+            return 1;
+        }
+
+        // About 1GB of file opened per measurement, and once first to fill the cache.
+        const uint32_t iterations = quick ? 2 : static_cast<uint32_t>(std::max<uint64_t>(1024ull * 1024 * 1024 / size, 4));
+        for (uint64_t stride : strides)
+        {
+            double milliseconds[3];
+            for (uint32_t method = 0; method < 3; ++method)
+            {
+                Measure(method, path, stride, 1);
+                milliseconds[method] = Measure(method, path, stride, iterations);
+            }
+            printf("%-10llu %-8llu %14.3f %14.3f %14.3f\n", static_cast<unsigned long long>(size), static_cast<unsigned long long>(stride),
+                milliseconds[0], milliseconds[1], milliseconds[2]);
+        }
+    }
+
+    remove(path.c_str());
+    return 0;
+}
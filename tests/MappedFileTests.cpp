@@ -0,0 +1,216 @@
+#include "MappedFile.h"
+#include "TestHarness.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // Bytes that differ from one page and one chunk to the next.
+    std::vector<uint8_t> MakeContents(size_t size)
+    {
+        std::vector<uint8_t> contents(size);
+        uint32_t state = 12345;
+        for (uint8_t& byte : contents)
+        {
+            state = state * 1664525 + 1013904223;
+            byte = static_cast<uint8_t>(state >> 24);
+        }
+        return contents;
+    }
+
+    bool SameBytes(const std::vector<uint8_t>& expected, const uint8_t* data, uint64_t size)
+    {
+        return size == expected.size() && (size == 0 || memcmp(expected.data(), data, expected.size()) == 0);
+    }
+
+    bool FileExists(const std::string& path)
+    {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file)
+        {
+            fclose(file);
+        }
+        return file != nullptr;
+    }
+}
+
+TEST(MappedAndStreamedReadTheSameBytes)
+{
+    const std::string path = "MappedFileTests.asset.bin";
+    const std::vector<uint8_t> contents = MakeContents(100000);
+    CHECK(WriteFileAtomic(path, contents.data(), contents.size()));
+    CHECK(!FileExists(path + ".tmp"));
+
+    MappedFile mapped;
+    CHECK(mapped.Open(path));
+    CHECK(mapped.IsOpen());
+    CHECK(SameBytes(contents, mapped.GetData(), mapped.GetSize()));
+
+    AssetFile asset;
+    CHECK(asset.Open(path));
+    CHECK(asset.IsMapped());
+    CHECK(SameBytes(contents, asset.GetData(), asset.GetSize()));
+
+    AssetFile streamed;
+    CHECK(streamed.Open(path, false));
+    CHECK(streamed.IsOpen() && !streamed.IsMapped());
+    CHECK(SameBytes(contents, streamed.GetData(), streamed.GetSize()));
+
+    remove(path.c_str());
+}
+
+TEST(StreamedReadsCrossChunks)
+{
+    const std::string path = "MappedFileTests.chunks.bin";
+    const std::vector<uint8_t> contents = MakeContents(2 * ReadChunkSize + 123);
+    CHECK(WriteFileAtomic(path, contents.data(), contents.size()));
+
+    std::vector<uint8_t> read;
+    CHECK(ReadFileBytes(path, read));
+    CHECK(read == contents);
+
+    remove(path.c_str());
+}
+
+TEST(RangesMustBeInTheFile)
+{
+    const std::string path = "MappedFileTests.range.bin";
+    const std::vector<uint8_t> contents = MakeContents(4096);
+    CHECK(WriteFileAtomic(path, contents.data(), contents.size()));
+
+    for (uint32_t allowMapping = 0; allowMapping < 2; ++allowMapping)
+    {
+        AssetFile asset;
+        CHECK(asset.Open(path, allowMapping != 0));
+        CHECK(asset.GetRange(0, 4096) == asset.GetData());
+        CHECK(asset.GetRange(4000, 96) == asset.GetData() + 4000);
+        CHECK(asset.GetRange(4096, 0) == asset.GetData() + 4096);
+        CHECK(asset.GetRange(4000, 97) == nullptr);
+        CHECK(asset.GetRange(4097, 0) == nullptr);
+        CHECK(asset.GetRange(16, UINT64_MAX) == nullptr);
+        CHECK(asset.GetRange(UINT64_MAX, 1) == nullptr);
+    }
+
+    remove(path.c_str());
+}
+
+TEST(MissingAndEmptyFiles)
+{
+    MappedFile mapped;
+    CHECK(!mapped.Open("MappedFileTests.missing.bin"));
+    CHECK(!mapped.IsOpen() && mapped.GetData() == nullptr && mapped.GetSize() == 0);
+
+    AssetFile asset;
+    CHECK(!asset.Open("MappedFileTests.missing.bin"));
+    CHECK(!asset.IsOpen());
+    std::vector<uint8_t> read(3);
+    CHECK(!ReadFileBytes("MappedFileTests.missing.bin", read));
+
+    // Empty files are open with no data, mapped or not.
+    const std::string path = "MappedFileTests.empty.bin";
+    CHECK(WriteFileAtomic(path, nullptr, 0));
+    CHECK(mapped.Open(path));
+    CHECK_EQUAL(0ull, static_cast<unsigned long long>(mapped.GetSize()));
+    CHECK(asset.Open(path, false));
+    CHECK_EQUAL(0ull, static_cast<unsigned long long>(asset.GetSize()));
+    CHECK(asset.GetRange(0, 1) == nullptr);
+    CHECK(ReadFileBytes(path, read));
+    CHECK(read.empty());
+
+    remove(path.c_str());
+}
+
+TEST(ReopeningReplacesTheFile)
+{
+    const std::string first = "MappedFileTests.first.bin";
+    const std::string second = "MappedFileTests.second.bin";
+    const std::vector<uint8_t> firstContents = MakeContents(10);
+    const std::vector<uint8_t> secondContents = MakeContents(70000);
+    CHECK(WriteFileAtomic(first, firstContents.data(), firstContents.size()));
+    CHECK(WriteFileAtomic(second, secondContents.data(), secondContents.size()));
+
+    AssetFile asset;
+    CHECK(asset.Open(first, false));
+    CHECK(asset.Open(second));
+    CHECK(asset.IsMapped());
+    CHECK(SameBytes(secondContents, asset.GetData(), asset.GetSize()));
+
+    // A failed open leaves the file closed, not the previous one open.
+    CHECK(!asset.Open("MappedFileTests.missing.bin"));
+    CHECK(!asset.IsOpen() && !asset.IsMapped() && asset.GetSize() == 0);
+
+    asset.Close();
+    asset.Close();
+    remove(first.c_str());
+    remove(second.c_str());
+}
+
+TEST(AtomicWriteReplacesTheFile)
+{
+    const std::string path = "MappedFileTests.replace.bin";
+    const std::vector<uint8_t> before = MakeContents(5000);
+    const std::vector<uint8_t> after(17, 0xab);
+    CHECK(WriteFileAtomic(path, before.data(), before.size()));
+
+    // A mapping of the old file keeps its bytes while the new one takes the path.
+    MappedFile mapped;
+    CHECK(mapped.Open(path));
+    CHECK(WriteFileAtomic(path, after.data(), after.size()));
+    CHECK(!FileExists(path + ".tmp"));
+#ifndef _WIN32
+    CHECK(SameBytes(before, mapped.GetData(), mapped.GetSize()));
+#endif
+    mapped.Close();
+
+    std::vector<uint8_t> read;
+    CHECK(ReadFileBytes(path, read));
+    CHECK(read == after);
+
+    CHECK(!WriteFileAtomic("MappedFileTests.missing/file.bin", after.data(), after.size()));
+    remove(path.c_str());
+}
+
+#ifndef _WIN32
+// A sparse file past 4GB, mapped: only the page read at the end is loaded.
+TEST(FilesOver4GBAreMapped)
+{
+    if (sizeof(size_t) < 8)
+    {
+        return;
+    }
+
+    const std::string path = "MappedFileTests.large.bin";
+    const uint64_t tailOffset = 5ull << 30;
+    const int file = open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    CHECK(file >= 0);
+    if (file < 0)
+    {
+        return;
+    }
+    const bool written = pwrite(file, "TAIL", 4, static_cast<off_t>(tailOffset)) == 4;
+    close(file);
+    CHECK(written);
+
+    AssetFile asset;
+    CHECK(asset.Open(path));
+    CHECK(asset.IsMapped());
+    CHECK_EQUAL(static_cast<unsigned long long>(tailOffset + 4), static_cast<unsigned long long>(asset.GetSize()));
+    const uint8_t* tail = asset.GetRange(tailOffset, 4);
+    CHECK(tail != nullptr && memcmp(tail, "TAIL", 4) == 0);
+    CHECK(asset.GetRange(tailOffset + 1, 4) == nullptr);
+    const uint8_t* head = asset.GetRange(1ull << 32, 1);
+    CHECK(head != nullptr && *head == 0);
+
+    asset.Close();
+    remove(path.c_str());
+}
+#endif
@@ -0,0 +1,258 @@
+#include "PipelineStateCache.h"
+#include "JobSystem.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // Stand-in for a device, shared by the builders of a run: records which
+    // pipelines were created how. A blob is the key of its pipeline followed
+    // by the driver version, and is rejected by another driver.
+    struct RecordingDevice
+    {
+        explicit RecordingDevice(uint8_t version) : driverVersion(version), blobCreates(0), scratchCreates(0), rejectedBlobs(0) {}
+
+        uint8_t driverVersion;
+        std::atomic<uint32_t> blobCreates;
+        std::atomic<uint32_t> scratchCreates;
+        std::atomic<uint32_t> rejectedBlobs;
+    };
+
+    class RecordingPipelineBuilder : public IPipelineBuilder
+    {
+    public:
+        RecordingPipelineBuilder(RecordingDevice& device, uint8_t pipeline) : m_device(device), m_pipeline(pipeline), m_created(false) {}
+
+        virtual bool CreateFromBlob(const void* blob, size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(blob);
+            if (size != 2 || bytes[0] != m_pipeline || bytes[1] != m_device.driverVersion)
+            {
+                m_device.rejectedBlobs++;
+                return false;
+            }
+            m_device.blobCreates++;
+            m_created = true;
+            return true;
+        }
+
+        virtual void CreateFromScratch()
+        {
+            m_device.scratchCreates++;
+            m_created = true;
+        }
+
+        virtual bool GetCachedBlob(std::vector<uint8_t>& blob)
+        {
+            blob.clear();
+            blob.push_back(m_pipeline);
+            blob.push_back(m_device.driverVersion);
+            return true;
+        }
+
+        bool IsCreated() const { return m_created; }
+
+    private:
+        RecordingDevice& m_device;
+        uint8_t m_pipeline;
+        bool m_created;
+    };
+
+    // Holds CreateFromBlob until released, then checks the blob it was given
+    // still holds what it held on entry, and rejects it.
+    class BlockingPipelineBuilder : public IPipelineBuilder
+    {
+    public:
+        BlockingPipelineBuilder() : m_entered(false), m_released(false), m_blobIntact(false) {}
+
+        virtual bool CreateFromBlob(const void* blob, size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(blob);
+            const std::vector<uint8_t> onEntry(bytes, bytes + size);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_entered = true;
+            m_changed.notify_all();
+            m_changed.wait(lock, [this] { return m_released; });
+
+            m_blobIntact = std::equal(onEntry.begin(), onEntry.end(), bytes);
+            return false;
+        }
+
+        virtual void CreateFromScratch()                            {}
+        virtual bool GetCachedBlob(std::vector<uint8_t>& /*blob*/)  { return false; }
+
+        void WaitUntilEntered()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_changed.wait(lock, [this] { return m_entered; });
+        }
+
+        void Release()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_released = true;
+            m_changed.notify_all();
+        }
+
+        bool IsBlobIntact() const { return m_blobIntact; }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+        bool m_entered;
+        bool m_released;
+        bool m_blobIntact;
+    };
+
+    const char* const PackPath = "PipelineStateCacheTests.pack";
+
+    // One start of the application: creates pipelines 0 to count - 1 and saves.
+    PipelineStateCacheStats Start(RecordingDevice& device, uint8_t count)
+    {
+        PipelineStateCache cache(PackPath);
+        for (uint8_t pipeline = 0; pipeline < count; ++pipeline)
+        {
+            RecordingPipelineBuilder builder(device, pipeline);
+            cache.Create(0x1000 + pipeline, builder);
+            CHECK(builder.IsCreated());
+        }
+        CHECK(cache.Save());
+        return cache.GetStats();
+    }
+}
+
+TEST(WarmStartCreatesNoPipelineFromScratch)
+{
+    remove(PackPath);
+
+    RecordingDevice cold(1);
+    const PipelineStateCacheStats coldStats = Start(cold, 8);
+    CHECK_EQUAL(8u, cold.scratchCreates.load());
+    CHECK_EQUAL(0u, cold.blobCreates.load());
+    CHECK_EQUAL(8u, coldStats.scratchCreates);
+
+    RecordingDevice warm(1);
+    const PipelineStateCacheStats warmStats = Start(warm, 8);
+    CHECK_EQUAL(0u, warm.scratchCreates.load());
+    CHECK_EQUAL(8u, warm.blobCreates.load());
+    CHECK_EQUAL(0u, warmStats.scratchCreates);
+    CHECK_EQUAL(8u, warmStats.blobCreates);
+    CHECK_EQUAL(0u, warmStats.rejectedBlobs);
+
+    remove(PackPath);
+}
+
+TEST(NewPipelinesAreAddedToTheCache)
+{
+    remove(PackPath);
+
+    RecordingDevice first(1);
+    Start(first, 4);
+
+    // Four more pipelines: only they are created from scratch.
+    RecordingDevice second(1);
+    Start(second, 8);
+    CHECK_EQUAL(4u, second.scratchCreates.load());
+    CHECK_EQUAL(4u, second.blobCreates.load());
+
+    RecordingDevice third(1);
+    Start(third, 8);
+    CHECK_EQUAL(0u, third.scratchCreates.load());
+
+    remove(PackPath);
+}
+
+TEST(StaleBlobsAreRecreatedAndReplaced)
+{
+    remove(PackPath);
+
+    RecordingDevice oldDriver(1);
+    Start(oldDriver, 4);
+
+    // A new driver refuses every blob, the pipelines are compiled again...
+    RecordingDevice newDriver(2);
+    const PipelineStateCacheStats stats = Start(newDriver, 4);
+    CHECK_EQUAL(4u, newDriver.rejectedBlobs.load());
+    CHECK_EQUAL(4u, newDriver.scratchCreates.load());
+    CHECK_EQUAL(4u, stats.rejectedBlobs);
+
+    // ...and their new blobs saved over the old ones.
+    RecordingDevice warm(2);
+    Start(warm, 4);
+    CHECK_EQUAL(0u, warm.rejectedBlobs.load());
+    CHECK_EQUAL(0u, warm.scratchCreates.load());
+    CHECK_EQUAL(4u, warm.blobCreates.load());
+
+    remove(PackPath);
+}
+
+TEST(ParallelCreatesOfTheSamePipelines)
+{
+    remove(PackPath);
+
+    // 64 creates of 8 pipelines on 4 threads, cold then warm.
+    for (uint8_t run = 0; run < 2; ++run)
+    {
+        RecordingDevice device(1);
+        PipelineStateCache cache(PackPath);
+        JobSystem jobs(4);
+        jobs.ParallelFor(64, [&](uint32_t index, uint32_t)
+        {
+            RecordingPipelineBuilder builder(device, static_cast<uint8_t>(index % 8));
+            cache.Create(0x1000 + index % 8, builder);
+        });
+        CHECK(cache.Save());
+
+        CHECK_EQUAL(64u, device.blobCreates.load() + device.scratchCreates.load());
+        CHECK_EQUAL(0u, device.rejectedBlobs.load());
+        if (run == 1)
+        {
+            CHECK_EQUAL(0u, device.scratchCreates.load());
+        }
+    }
+
+    remove(PackPath);
+}
+
+// A stale blob added earlier in the run is replaced by the first create that
+// rebuilds its pipeline, while another create of the same pipeline is still
+// reading it.
+TEST(StaleBlobOutlivesItsReplacement)
+{
+    remove(PackPath);
+    PipelineStateCache cache(PackPath);
+
+    RecordingDevice oldDriver(1);
+    RecordingPipelineBuilder first(oldDriver, 7);
+    cache.Create(0x1007, first);
+
+    BlockingPipelineBuilder reading;
+    std::thread reader([&cache, &reading] { cache.Create(0x1007, reading); });
+    reading.WaitUntilEntered();
+
+    RecordingDevice newDriver(2);
+    RecordingPipelineBuilder rebuilding(newDriver, 7);
+    cache.Create(0x1007, rebuilding);
+    CHECK_EQUAL(1u, newDriver.scratchCreates.load());
+
+    reading.Release();
+    reader.join();
+    CHECK(reading.IsBlobIntact());
+
+    // The blob of the new driver is the one kept.
+    RecordingDevice warm(2);
+    RecordingPipelineBuilder again(warm, 7);
+    cache.Create(0x1007, again);
+    CHECK_EQUAL(1u, warm.blobCreates.load());
+
+    remove(PackPath);
+}
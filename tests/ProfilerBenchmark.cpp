@@ -0,0 +1,93 @@
+#include "Profiler.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // The work a scope would time, small enough for the scope to dominate.
+    inline uint32_t Step(uint32_t state)
+    {
+        return state * 1664525u + 1013904223u;
+    }
+
+    enum LoopKind
+    {
+        LoopEmpty,          // The work alone.
+        LoopDisabled,       // ProfileScope without a profiler, as with profiling off.
+        LoopClock,          // One Profiler::Now per iteration.
+        LoopScope,          // A ProfileScope per iteration.
+    };
+
+    const char* const LoopNames[] = { "empty loop", "disabled scope", "clock read", "scope" };
+
+    void RunLoop(LoopKind kind, Profiler* profiler, uint32_t iterations)
+    {
+        uint32_t state = 1;
+        int64_t clock = 0;
+        for (uint32_t i = 0; i < iterations; ++i)
+        {
+            if (kind == LoopClock)
+            {
+                clock += Profiler::Now();
+            }
+            if (kind == LoopScope || kind == LoopDisabled)
+            {
+                ProfileScope scope(kind == LoopScope ? profiler : nullptr, "Benchmark");
+                state = Step(state);
+            }
+            else
+            {
+                state = Step(state);
+            }
+        }
+        KeepResult(state);
+        KeepResult(clock);
+    }
+
+    // Nanoseconds per iteration with threads threads running the loop at once
+    // on the same profiler.
+    double TimeLoop(LoopKind kind, uint32_t threads, uint32_t iterations)
+    {
+        Profiler profiler;
+        std::vector<std::thread> workers;
+        BenchmarkTimer timer;
+        for (uint32_t thread = 1; thread < threads; ++thread)
+        {
+            workers.push_back(std::thread(RunLoop, kind, &profiler, iterations));
+        }
+        RunLoop(kind, &profiler, iterations);
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+        return timer.GetMilliseconds() * 1e6 / iterations;
+    }
+}
+
+// What a ProfileScope costs: ns per iteration of a loop timing a few
+// instructions with a scope, against the same loop without one, with a
+// disabled scope and with a single clock read. Then the same with 2 to 8
+// threads recording into one profiler at once, where the scopes share its
+// event counter; the time is per iteration of each thread.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t iterations = quick ? 10000 : 10000000;
+    const uint32_t threadCounts[] = { 1, 2, 4, 8 };
+
+    printf("%-16s %8s %10s %12s\n", "loop", "threads", "ns/iter", "overhead ns");
+    for (uint32_t threads : threadCounts)
+    {
+        const double emptyNs = TimeLoop(LoopEmpty, threads, iterations);
+        for (uint32_t kind = LoopEmpty; kind <= LoopScope; ++kind)
+        {
+            const double ns = kind == LoopEmpty ? emptyNs : TimeLoop(static_cast<LoopKind>(kind), threads, iterations);
+            printf("%-16s %8u %10.2f %12.2f\n", LoopNames[kind], threads, ns, std::max(0.0, ns - emptyNs));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include "Profiler.h"
+#include "TestHarness.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const ProfilerSummary* FindSummary(const std::vector<ProfilerSummary>& summary, const std::string& name, bool gpu)
+    {
+        for (const ProfilerSummary& item : summary)
+        {
+            if (item.name == name && item.gpu == gpu)
+            {
+                return &item;
+            }
+        }
+        return nullptr;
+    }
+
+    uint32_t CountOccurrences(const std::string& text, const std::string& pattern)
+    {
+        uint32_t count = 0;
+        for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1))
+        {
+            count++;
+        }
+        return count;
+    }
+}
+
+TEST(ScopesAreSummarizedByName)
+{
+    Profiler profiler(64, 8);
+    for (uint32_t frame = 0; frame < 3; ++frame)
+    {
+        ProfileScope outer(&profiler, "Frame");
+        {
+            ProfileScope inner(&profiler, "Update");
+        }
+        {
+            ProfileScope inner(&profiler, "Update");
+        }
+    }
+    profiler.AddGpuEvent("Update", 0, 1000, 3001000);
+    profiler.EndFrame();
+    CHECK_EQUAL(1u, profiler.GetFrame());
+
+    const std::vector<ProfilerSummary> summary = profiler.GetSummary();
+    CHECK_EQUAL(3u, summary.size());
+    const ProfilerSummary* frame = FindSummary(summary, "Frame", false);
+    const ProfilerSummary* update = FindSummary(summary, "Update", false);
+    const ProfilerSummary* gpu = FindSummary(summary, "Update", true);
+    CHECK(frame && update && gpu);
+    if (frame && update && gpu)
+    {
+        CHECK_EQUAL(3u, frame->samples);
+        CHECK_EQUAL(6u, update->samples);
+        CHECK(update->minMs <= update->avgMs && update->avgMs <= update->p99Ms);
+        CHECK_EQUAL(1u, gpu->samples);
+        CHECK_NEAR(3.0, gpu->avgMs, 1e-9);
+    }
+}
+
+TEST(WindowKeepsTheLastSamples)
+{
+    Profiler profiler(64, 4);
+    for (int64_t ms = 1; ms <= 10; ++ms)
+    {
+        profiler.AddGpuEvent("Pass", 0, 0, ms * 1000000);
+        profiler.EndFrame();
+    }
+
+    const std::vector<ProfilerSummary> summary = profiler.GetSummary();
+    CHECK_EQUAL(1u, summary.size());
+    CHECK_EQUAL(4u, summary[0].samples);
+    CHECK_NEAR(7.0, summary[0].minMs, 1e-9);
+    CHECK_NEAR(8.5, summary[0].avgMs, 1e-9);
+    CHECK_NEAR(10.0, summary[0].p99Ms, 1e-9);
+}
+
+TEST(OpenScopesAreCountedOnceClosed)
+{
+    Profiler profiler(64, 16);
+    const uint64_t scope = profiler.BeginScope("Long");
+    {
+        ProfileScope inner(&profiler, "Short");
+    }
+
+    // Open at the end of the frame: not in the statistics or the trace yet.
+    profiler.EndFrame();
+    const std::vector<ProfilerSummary> open = profiler.GetSummary();
+    CHECK(FindSummary(open, "Long", false) == nullptr);
+    CHECK(FindSummary(open, "Short", false) != nullptr);
+    CHECK_EQUAL(0u, CountOccurrences(profiler.ExportChromeTrace(), "\"Long\""));
+
+    profiler.EndScope(scope);
+    profiler.EndFrame();
+    const std::vector<ProfilerSummary> closed = profiler.GetSummary();
+    const ProfilerSummary* item = FindSummary(closed, "Long", false);
+    CHECK(item != nullptr && item->samples == 1);
+    CHECK_EQUAL(1u, CountOccurrences(profiler.ExportChromeTrace(), "\"Long\""));
+
+    // Counted once.
+    profiler.EndFrame();
+    const std::vector<ProfilerSummary> again = profiler.GetSummary();
+    item = FindSummary(again, "Long", false);
+    CHECK(item != nullptr && item->samples == 1);
+}
+
+TEST(RingKeepsTheLastEvents)
+{
+    Profiler profiler(8, 64);
+    const uint64_t lapped = profiler.BeginScope("Lapped");
+    for (uint32_t i = 0; i < 20; ++i)
+    {
+        profiler.AddGpuEvent(i < 12 ? "Old" : "New", i, i * 1000, i * 1000 + 500);
+    }
+
+    // The scope lost its slot, closing it leaves the event there alone.
+    profiler.EndScope(lapped);
+
+    const std::string trace = profiler.ExportChromeTrace();
+    CHECK_EQUAL(0u, CountOccurrences(trace, "\"Old\""));
+    CHECK_EQUAL(8u, CountOccurrences(trace, "\"New\""));
+    CHECK_EQUAL(0u, CountOccurrences(trace, "\"Lapped\""));
+
+    profiler.EndFrame();
+    const std::vector<ProfilerSummary> summary = profiler.GetSummary();
+    CHECK_EQUAL(1u, summary.size());
+    CHECK_EQUAL(8u, summary[0].samples);
+    CHECK_NEAR(0.0005, summary[0].avgMs, 1e-12);
+}
+
+TEST(ChromeTraceIsEscaped)
+{
+    Profiler profiler(16, 4);
+    profiler.AddGpuEvent("Quote\" and \\ and \n", 7, 2000, 5000);
+    {
+        ProfileScope scope(&profiler, "Cpu");
+    }
+
+    const std::string trace = profiler.ExportChromeTrace();
+    CHECK(trace.find("\"name\":\"Quote\\\" and \\\\ and \\u000a\"") != std::string::npos);
+    CHECK(trace.find("\"ts\":0.000,\"dur\":3.000,\"pid\":1,\"tid\":0,\"args\":{\"frame\":7}") != std::string::npos);
+    CHECK(trace.find("\"cat\":\"cpu\"") != std::string::npos);
+    CHECK(trace.find("{\"name\":\"GPU\"}") != std::string::npos);
+    CHECK_EQUAL('\n', trace.back());
+}
+
+// Scopes on one thread while another ends the frames, as with -renderthread:
+// every scope is counted exactly once, none while it is open.
+TEST(EndFrameRunsConcurrentlyWithScopes)
+{
+    const uint32_t scopeCount = 20000;
+    Profiler profiler(1 << 16, 1 << 16);
+
+    std::atomic<bool> done(false);
+    std::thread simulation([&]()
+    {
+        for (uint32_t i = 0; i < scopeCount; ++i)
+        {
+            ProfileScope outer(&profiler, "Outer");
+            ProfileScope inner(&profiler, "Inner");
+        }
+        done = true;
+    });
+
+    uint32_t frames = 0;
+    while (!done)
+    {
+        profiler.EndFrame();
+        if (frames % 16 == 0)
+        {
+            profiler.ExportChromeTrace();
+        }
+        frames++;
+    }
+    simulation.join();
+    profiler.EndFrame();
+
+    const std::vector<ProfilerSummary> summary = profiler.GetSummary();
+    const ProfilerSummary* outer = FindSummary(summary, "Outer", false);
+    const ProfilerSummary* inner = FindSummary(summary, "Inner", false);
+    CHECK(outer != nullptr && inner != nullptr);
+    if (outer && inner)
+    {
+        CHECK_EQUAL(scopeCount, outer->samples);
+        CHECK_EQUAL(scopeCount, inner->samples);
+        CHECK(outer->minMs >= 0.0);
+    }
+    CHECK_EQUAL(frames + 1, profiler.GetFrame());
+}
+
+TEST(EmptyRingIsRejected)
+{
+    CHECK_THROWS(Profiler(0, 4), std::invalid_argument);
+    CHECK_THROWS(Profiler(4, 0), std::invalid_argument);
+}
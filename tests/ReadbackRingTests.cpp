@@ -0,0 +1,229 @@
+#include "ReadbackRing.h"
+#include "FrameScheduler.h"
+#include "TestHarness.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // What the copy of a frame writes into its slot: every pixel byte is
+    // frame + row + column, the padding is left alone.
+    void CopyFrame(std::vector<uint8_t>& memory, const ReadbackFootprint& footprint, uint64_t frame)
+    {
+        for (uint32_t row = 0; row < footprint.rowCount; ++row)
+        {
+            for (uint32_t column = 0; column < footprint.rowSize; ++column)
+            {
+                memory[footprint.offset + row * footprint.rowPitch + column] = static_cast<uint8_t>(frame + row + column);
+            }
+        }
+    }
+
+    bool HasFrame(const ReadbackView& view, uint64_t frame)
+    {
+        for (uint32_t row = 0; row < view.rowCount; ++row)
+        {
+            for (uint32_t column = 0; column < view.rowSize; ++column)
+            {
+                if (view.data[row * view.rowPitch + column] != static_cast<uint8_t>(frame + row + column))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+// Captures complete once the queue reaches the fence of their frame, oldest
+// first, with the frame their copy wrote.
+TEST(CapturesAreAcquiredInFenceOrder)
+{
+    const uint32_t rowSize = 10 * 4;
+    const uint32_t rowCount = 4;
+    const uint64_t slotSize = ReadbackRing::GetSlotSize(rowSize, rowCount);
+    std::vector<uint8_t> memory(static_cast<size_t>(3 * slotSize), 0xcd);
+    ReadbackRing ring(memory.data(), 3, slotSize);
+
+    // Long GPU frames, so the first check comes well before the fence.
+    SimulatedFrameQueue queue(std::chrono::milliseconds(50));
+    for (uint64_t frame = 0; frame < 3; ++frame)
+    {
+        const uint32_t capture = ring.Begin(rowSize, rowCount, frame);
+        CHECK_EQUAL(static_cast<uint32_t>(frame), capture);
+        CopyFrame(memory, ring.GetFootprint(capture), frame);
+        ring.FinishFrame(frame + 1);
+        queue.Signal(frame + 1);
+    }
+
+    ReadbackView view;
+    CHECK(!ring.Acquire(queue.GetCompletedValue(), view));
+
+    queue.WaitForValue(1);
+    CHECK(ring.Acquire(queue.GetCompletedValue(), view));
+    CHECK_EQUAL(0ull, view.frame);
+    CHECK_EQUAL(0u, view.capture);
+    CHECK(HasFrame(view, 0));
+    CHECK(!ring.Acquire(1, view));
+
+    queue.WaitForValue(3);
+    ReadbackView second;
+    ReadbackView third;
+    CHECK(ring.Acquire(queue.GetCompletedValue(), second));
+    CHECK(ring.Acquire(queue.GetCompletedValue(), third));
+    CHECK(!ring.Acquire(queue.GetCompletedValue(), view));
+    CHECK_EQUAL(1ull, second.frame);
+    CHECK_EQUAL(2ull, third.frame);
+    CHECK(HasFrame(second, 1));
+    CHECK(HasFrame(third, 2));
+    CHECK(second.data == memory.data() + slotSize);
+
+    ring.Release(0);
+    ring.Release(second.capture);
+    ring.Release(third.capture);
+    const ReadbackRingStats stats = ring.GetStats();
+    CHECK_EQUAL(3ull, stats.captures);
+    CHECK_EQUAL(3ull, stats.completedCaptures);
+    CHECK_EQUAL(0ull, stats.droppedCaptures);
+    CHECK_EQUAL(3u, stats.peakSlotsInUse);
+}
+
+// A frame can hold several captures, they complete together.
+TEST(CapturesOfAFrameShareItsFence)
+{
+    std::vector<uint8_t> memory(4 * 512);
+    ReadbackRing ring(memory.data(), 4, 512);
+    const uint32_t first = ring.Begin(16, 1, 7);
+    const uint32_t second = ring.Begin(16, 1, 7);
+    ring.FinishFrame(5);
+    ring.Begin(16, 1, 8);
+
+    ReadbackView view;
+    CHECK(!ring.Acquire(4, view));
+    CHECK(ring.Acquire(5, view));
+    CHECK_EQUAL(first, view.capture);
+    CHECK(ring.Acquire(5, view));
+    CHECK_EQUAL(second, view.capture);
+
+    // The capture of the unfinished frame is not pending yet.
+    CHECK(!ring.Acquire(100, view));
+}
+
+// When every slot is in flight the capture is dropped, nothing waits; a
+// released slot is handed out again.
+TEST(FullRingDropsCaptures)
+{
+    std::vector<uint8_t> memory(2 * 1024);
+    ReadbackRing ring(memory.data(), 2, 1000);
+    CHECK_EQUAL(1024ull, ring.GetSlotSize());
+    CHECK_EQUAL(0u, ring.Begin(64, 2, 0));
+    ring.FinishFrame(1);
+    CHECK_EQUAL(1u, ring.Begin(64, 2, 1));
+    ring.FinishFrame(2);
+    CHECK_EQUAL(ReadbackRing::InvalidCapture, ring.Begin(64, 2, 2));
+    ring.FinishFrame(3);
+
+    ReadbackView view;
+    CHECK(ring.Acquire(3, view));
+    CHECK_EQUAL(ReadbackRing::InvalidCapture, ring.Begin(64, 2, 3));
+    ring.Release(view.capture);
+    CHECK_EQUAL(0u, ring.Begin(64, 2, 4));
+    CHECK_EQUAL(1024ull, ring.GetFootprint(1).offset);
+
+    const ReadbackRingStats stats = ring.GetStats();
+    CHECK_EQUAL(3ull, stats.captures);
+    CHECK_EQUAL(2ull, stats.droppedCaptures);
+    CHECK_EQUAL(2u, stats.peakSlotsInUse);
+
+    // A copy that can never fit is an error, not a dropped capture.
+    CHECK_THROWS(ring.Begin(256, 5, 5), std::invalid_argument);
+    CHECK_THROWS(ring.Begin(64, 0, 5), std::invalid_argument);
+    CHECK_THROWS(ReadbackRing(nullptr, 2, 1024), std::invalid_argument);
+    CHECK_THROWS(ReadbackRing(memory.data(), 0, 1024), std::invalid_argument);
+}
+
+TEST(ReleaseWithoutAcquireThrows)
+{
+    std::vector<uint8_t> memory(2 * 512);
+    ReadbackRing ring(memory.data(), 2, 512);
+    const uint32_t capture = ring.Begin(16, 2, 0);
+    CHECK_THROWS(ring.Release(capture), std::logic_error);
+    ring.FinishFrame(1);
+    CHECK_THROWS(ring.Release(capture), std::logic_error);
+    CHECK_THROWS(ring.Release(1), std::logic_error);
+
+    ReadbackView view;
+    CHECK(ring.Acquire(1, view));
+    ring.Release(capture);
+    CHECK_THROWS(ring.Release(capture), std::logic_error);
+    CHECK_THROWS(ring.Release(2), std::out_of_range);
+}
+
+// Rows are 256-byte aligned, slots 512-byte aligned, and the last row of a
+// slot goes without its padding.
+TEST(PitchesAndSlotsAreAligned)
+{
+    CHECK_EQUAL(256u, ReadbackRing::GetRowPitch(1));
+    CHECK_EQUAL(256u, ReadbackRing::GetRowPitch(256));
+    CHECK_EQUAL(512u, ReadbackRing::GetRowPitch(257));
+    CHECK_EQUAL(5120u, ReadbackRing::GetRowPitch(1280 * 4));
+    CHECK_EQUAL(5376u, ReadbackRing::GetRowPitch(1283 * 4));
+
+    CHECK_EQUAL(0ull, ReadbackRing::GetSlotSize(64, 0));
+    CHECK_EQUAL(512ull, ReadbackRing::GetSlotSize(1, 1));
+    CHECK_EQUAL(1024ull, ReadbackRing::GetSlotSize(100, 3));        // 2 * 256 + 100
+    CHECK_EQUAL(1024ull, ReadbackRing::GetSlotSize(256, 4));
+    CHECK_EQUAL(5120ull * 720, ReadbackRing::GetSlotSize(1280 * 4, 720));
+    CHECK_EQUAL(5376ull * 719 + 5376, ReadbackRing::GetSlotSize(1283 * 4, 720));    // 5132 bytes of the last row, aligned
+
+    std::vector<uint8_t> memory(3 * 1536);
+    ReadbackRing ring(memory.data(), 3, 1025);
+    CHECK_EQUAL(1536ull, ring.GetSlotSize());
+    ring.Begin(100, 3, 0);
+    const ReadbackFootprint& footprint = ring.GetFootprint(ring.Begin(300, 2, 0));
+    CHECK_EQUAL(1536ull, footprint.offset);
+    CHECK_EQUAL(300u, footprint.rowSize);
+    CHECK_EQUAL(512u, footprint.rowPitch);
+    CHECK_EQUAL(2u, footprint.rowCount);
+}
+
+// CopyRows drops the padding into a tight or wider image, and copies the
+// rows as they are into an image with the same pitch.
+TEST(CopyRowsRemovesThePadding)
+{
+    const uint32_t rowSize = 12;
+    const uint32_t rowCount = 3;
+    std::vector<uint8_t> memory(static_cast<size_t>(ReadbackRing::GetSlotSize(rowSize, rowCount)), 0xcd);
+    ReadbackRing ring(memory.data(), 1, memory.size());
+    const uint32_t capture = ring.Begin(rowSize, rowCount, 9);
+    CopyFrame(memory, ring.GetFootprint(capture), 9);
+    ring.FinishFrame(1);
+    ReadbackView view;
+    CHECK(ring.Acquire(1, view));
+
+    std::vector<uint8_t> tight(rowSize * rowCount, 0);
+    view.CopyRows(tight.data(), rowSize);
+    for (uint32_t row = 0; row < rowCount; ++row)
+    {
+        for (uint32_t column = 0; column < rowSize; ++column)
+        {
+            CHECK_EQUAL(static_cast<uint32_t>(9 + row + column), static_cast<uint32_t>(tight[row * rowSize + column]));
+        }
+    }
+
+    // A wider pitch leaves the bytes past each row alone.
+    const uint32_t widePitch = 16;
+    std::vector<uint8_t> wide(widePitch * rowCount, 0xee);
+    view.CopyRows(wide.data(), widePitch);
+    CHECK_EQUAL(static_cast<uint32_t>(9 + 2 + 11), static_cast<uint32_t>(wide[2 * widePitch + 11]));
+    CHECK_EQUAL(0xeeu, static_cast<uint32_t>(wide[widePitch - 1]));
+    CHECK_EQUAL(0xeeu, static_cast<uint32_t>(wide[3 * widePitch - 1]));
+
+    // The same pitch takes the padding along, but never reads past the last row.
+    std::vector<uint8_t> same(view.rowPitch * (rowCount - 1) + rowSize, 0);
+    view.CopyRows(same.data(), view.rowPitch);
+    CHECK(std::vector<uint8_t>(memory.begin(), memory.begin() + same.size()) == same);
+    ring.Release(capture);
+}
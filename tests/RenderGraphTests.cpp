@@ -0,0 +1,381 @@
+#include "RenderGraph.h"
+#include "JobSystem.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // D3D12_RESOURCE_STATES.
+    const uint32_t PresentState = 0x0;
+    const uint32_t RenderTargetState = 0x4;
+    const uint32_t UnorderedAccessState = 0x8;
+    const uint32_t NonPixelShaderResourceState = 0x40;
+    const uint32_t PixelShaderResourceState = 0x80;
+    const uint32_t CopySourceState = 0x800;
+
+    RenderGraphTextureDesc TextureDesc(uint32_t width, uint32_t height, bool allowUnorderedAccess = false)
+    {
+        RenderGraphTextureDesc desc = { width, height, 28, allowUnorderedAccess, { 0.0f, 0.0f, 0.0f, 1.0f } };
+        return desc;
+    }
+
+    typedef RecordingRenderGraphBackend::Command Command;
+
+    std::vector<Command> GetCommands(const RecordingRenderGraphBackend& backend, RecordingRenderGraphBackend::CommandType type)
+    {
+        std::vector<Command> commands;
+        for (const Command& command : backend.GetCommands())
+        {
+            if (command.type == type)
+            {
+                commands.push_back(command);
+            }
+        }
+        return commands;
+    }
+
+    // Commands of each list in order, lists in submission order.
+    std::string GetSignature(const RenderGraph& graph, const RecordingRenderGraphBackend& backend)
+    {
+        std::vector<Command> commands = backend.GetCommands();
+        std::stable_sort(commands.begin(), commands.end(), [](const Command& a, const Command& b)
+        {
+            return a.list < b.list;
+        });
+
+        std::string signature;
+        for (const Command& command : commands)
+        {
+            signature += std::to_string(command.type) + " ";
+            signature += command.resource == RenderGraph::InvalidResource ? command.name : graph.GetName(command.resource);
+            signature += command.type == RecordingRenderGraphBackend::CommandBarrier
+                ? " " + std::to_string(command.barrier.before) + ">" + std::to_string(command.barrier.after) : std::string();
+            signature += "\n";
+        }
+        return signature;
+    }
+
+    // The graph of the sample: the triangle pass writes Scene, the optional
+    // blur goes through BlurTemp into Blurred, the quad writes the back buffer.
+    struct SampleGraph
+    {
+        SampleGraph(bool blur, uint32_t width = 1280, uint32_t height = 720)
+        {
+            scene = graph.CreateTexture("Scene", TextureDesc(width, height));
+            backBuffer = graph.ImportTexture("BackBuffer", PresentState, PresentState);
+
+            const uint32_t triangle = graph.AddPass("Triangle", nullptr);
+            graph.Write(triangle, scene, RenderTargetState);
+
+            display = scene;
+            if (blur)
+            {
+                blurTemp = graph.CreateTexture("BlurTemp", TextureDesc(width, height, true));
+                blurred = graph.CreateTexture("Blurred", TextureDesc(width, height, true));
+
+                const uint32_t rows = graph.AddPass("BlurRows", nullptr);
+                graph.Read(rows, scene, NonPixelShaderResourceState);
+                graph.Write(rows, blurTemp, UnorderedAccessState);
+
+                const uint32_t columns = graph.AddPass("BlurColumns", nullptr);
+                graph.Read(columns, blurTemp, NonPixelShaderResourceState);
+                graph.Write(columns, blurred, UnorderedAccessState);
+                display = blurred;
+            }
+
+            const uint32_t quad = graph.AddPass("Quad", nullptr);
+            graph.Read(quad, display, PixelShaderResourceState);
+            graph.Write(quad, backBuffer, RenderTargetState);
+        }
+
+        RenderGraph graph;
+        RenderGraphResource scene;
+        RenderGraphResource blurTemp;
+        RenderGraphResource blurred;
+        RenderGraphResource display;
+        RenderGraphResource backBuffer;
+    };
+}
+
+TEST(CullsPassesNothingReads)
+{
+    JobSystem jobs(2);
+    RecordingCommandListBackend lists(2);
+    ParallelCommandRecorder recorder(jobs, lists);
+    RecordingRenderGraphBackend backend;
+
+    SampleGraph sample(false);
+    uint32_t deadRuns = 0;
+    const uint32_t dead = sample.graph.AddPass("Dead", [&](uint32_t) { deadRuns++; });
+    sample.graph.Write(dead, sample.graph.CreateTexture("Unused", TextureDesc(64, 64)), RenderTargetState);
+
+    sample.graph.Compile(backend);
+    sample.graph.Execute(backend, recorder);
+
+    CHECK(sample.graph.IsPassCulled(dead));
+    CHECK_EQUAL(0u, deadRuns);
+    CHECK_EQUAL(2u, sample.graph.GetLivePassCount());
+    CHECK_EQUAL(1u, sample.graph.GetStats().culledPassCount);
+    CHECK_EQUAL(1u, sample.graph.GetStats().transientTextureCount);
+}
+
+TEST(TransitionsFollowTheUses)
+{
+    RecordingRenderGraphBackend backend;
+    SampleGraph sample(false);
+    sample.graph.Compile(backend);
+
+    // Scene is left where its last use put it and goes back to a render
+    // target first; the back buffer transition starts right away.
+    const std::vector<RenderGraphBarrier>& first = sample.graph.GetBarriers(0);
+    CHECK_EQUAL(2u, first.size());
+    CHECK_EQUAL(sample.scene, first[0].resource);
+    CHECK_EQUAL(PixelShaderResourceState, first[0].before);
+    CHECK_EQUAL(RenderTargetState, first[0].after);
+    CHECK_EQUAL(sample.backBuffer, first[1].resource);
+    CHECK(first[1].flags == ResourceBarrierFlagBeginOnly);
+
+    const std::vector<RenderGraphBarrier>& second = sample.graph.GetBarriers(1);
+    CHECK_EQUAL(2u, second.size());
+    const std::vector<RenderGraphBarrier>& last = sample.graph.GetBarriers(2);
+    CHECK_EQUAL(1u, last.size());
+    CHECK_EQUAL(sample.backBuffer, last[0].resource);
+    CHECK_EQUAL(PresentState, last[0].after);
+
+    CHECK_EQUAL(PixelShaderResourceState, sample.graph.GetLayout().textures[0].initialState);
+}
+
+TEST(TransitionsAreSplitOverIdlePasses)
+{
+    RecordingRenderGraphBackend backend;
+    RenderGraph graph;
+    const RenderGraphResource output = graph.ImportTexture("Output", PresentState, CopySourceState);
+    const RenderGraphResource early = graph.CreateTexture("Early", TextureDesc(64, 64));
+    const RenderGraphResource other = graph.CreateTexture("Other", TextureDesc(64, 64));
+
+    const uint32_t a = graph.AddPass("A", nullptr);
+    graph.Write(a, early, RenderTargetState);
+    const uint32_t b = graph.AddPass("B", nullptr);
+    graph.Write(b, other, RenderTargetState);
+    const uint32_t c = graph.AddPass("C", nullptr);
+    graph.Read(c, early, PixelShaderResourceState);
+    graph.Read(c, other, PixelShaderResourceState);
+    graph.Write(c, output, RenderTargetState);
+    graph.Compile(backend);
+
+    // Early is done after A, its transition to a shader resource starts
+    // before B and ends before C.
+    bool begun = false;
+    for (const RenderGraphBarrier& barrier : graph.GetBarriers(1))
+    {
+        begun |= barrier.resource == early && barrier.flags == ResourceBarrierFlagBeginOnly;
+    }
+    bool ended = false;
+    for (const RenderGraphBarrier& barrier : graph.GetBarriers(2))
+    {
+        ended |= barrier.resource == early && barrier.flags == ResourceBarrierFlagEndOnly;
+    }
+    CHECK(begun);
+    CHECK(ended);
+    CHECK(graph.GetStats().splitBarrierCount >= 1);
+}
+
+TEST(AliasesTexturesWhoseLifetimesDoNotOverlap)
+{
+    RecordingRenderGraphBackend backend;
+    RenderGraph graph;
+    const RenderGraphResource output = graph.ImportTexture("Output", PresentState, PresentState);
+
+    // A chain of 8 passes, each reading the texture of the one before.
+    RenderGraphResource previous = RenderGraph::InvalidResource;
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        const RenderGraphResource texture = graph.CreateTexture("T" + std::to_string(i), TextureDesc(1920, 1080));
+        const uint32_t pass = graph.AddPass("P" + std::to_string(i), nullptr);
+        if (previous != RenderGraph::InvalidResource)
+        {
+            graph.Read(pass, previous, PixelShaderResourceState);
+        }
+        graph.Write(pass, texture, RenderTargetState);
+        previous = texture;
+    }
+    const uint32_t final = graph.AddPass("Final", nullptr);
+    graph.Read(final, previous, PixelShaderResourceState);
+    graph.Write(final, output, RenderTargetState);
+    graph.Compile(backend);
+
+    // Two textures are alive at once, the heap holds two.
+    const RenderGraphStats& stats = graph.GetStats();
+    CHECK_EQUAL(stats.peakLiveSize, stats.transientHeapSize);
+    CHECK_EQUAL(stats.unaliasedSize / 4, stats.transientHeapSize);
+    CHECK_EQUAL(8u, stats.aliasedTextureCount);
+    CHECK_EQUAL(8u, stats.aliasingBarrierCount);
+
+    // The aliasing barrier of a boundary comes before its transitions.
+    for (uint32_t boundary = 0; boundary <= graph.GetLivePassCount(); ++boundary)
+    {
+        const std::vector<RenderGraphBarrier>& barriers = graph.GetBarriers(boundary);
+        for (size_t i = 1; i < barriers.size(); ++i)
+        {
+            CHECK(!(barriers[i].type == RenderGraphBarrierAliasing && barriers[i - 1].type != RenderGraphBarrierAliasing));
+        }
+    }
+}
+
+// Every transient is initialized at its first use, after the barriers that
+// put it in the state of that use, whether it shares memory or not.
+TEST(DiscardsEveryTransientAtItsFirstUse)
+{
+    JobSystem jobs(1);
+    RecordingCommandListBackend lists(1);
+    ParallelCommandRecorder recorder(jobs, lists);
+
+    for (uint32_t blur = 0; blur < 2; ++blur)
+    {
+        RecordingRenderGraphBackend backend;
+        SampleGraph sample(blur != 0);
+        sample.graph.Compile(backend);
+        sample.graph.Execute(backend, recorder);
+
+        // Scene and Blurred share memory, BlurTemp has its own.
+        const uint32_t transients = blur ? 3 : 1;
+        CHECK_EQUAL(blur ? 2u : 0u, sample.graph.GetStats().aliasedTextureCount);
+        CHECK_EQUAL(transients, GetCommands(backend, RecordingRenderGraphBackend::CommandDiscard).size());
+
+        // Replay the commands: a discard comes after the texture's barriers
+        // into a state DiscardResource accepts and before its pass.
+        std::vector<uint32_t> states(4, ~0u);
+        for (const RenderGraphTexturePlacement& placement : sample.graph.GetLayout().textures)
+        {
+            states[placement.resource] = placement.initialState;
+        }
+
+        std::vector<RenderGraphResource> discarded;
+        std::string pass;
+        for (const Command& command : backend.GetCommands())
+        {
+            if (command.type == RecordingRenderGraphBackend::CommandBarrier && command.barrier.type == RenderGraphBarrierTransition
+                && command.barrier.flags != ResourceBarrierFlagBeginOnly)
+            {
+                states[command.resource] = command.barrier.after;
+            }
+            else if (command.type == RecordingRenderGraphBackend::CommandDiscard)
+            {
+                CHECK(states[command.resource] == RenderTargetState || states[command.resource] == UnorderedAccessState);
+                discarded.push_back(command.resource);
+            }
+            else if (command.type == RecordingRenderGraphBackend::CommandBeginPass)
+            {
+                pass = command.name;
+                if (pass == "Triangle" || pass == "BlurRows" || pass == "BlurColumns")
+                {
+                    const RenderGraphResource written = pass == "Triangle" ? sample.scene : pass == "BlurRows" ? sample.blurTemp : sample.blurred;
+                    CHECK(std::find(discarded.begin(), discarded.end(), written) != discarded.end());
+                }
+            }
+        }
+    }
+}
+
+TEST(DiscardsAgainEveryFrameAndAfterTheLayoutChanges)
+{
+    JobSystem jobs(1);
+    RecordingCommandListBackend lists(1);
+    ParallelCommandRecorder recorder(jobs, lists);
+    RecordingRenderGraphBackend backend;
+
+    SampleGraph sample(true);
+    sample.graph.Compile(backend);
+    sample.graph.Execute(backend, recorder);
+    sample.graph.Execute(backend, recorder);
+    CHECK_EQUAL(6u, GetCommands(backend, RecordingRenderGraphBackend::CommandDiscard).size());
+    CHECK_EQUAL(1u, backend.GetHeapCreateCount());
+
+    // The same graph compiled again keeps its heap.
+    sample.graph.Compile(backend);
+    sample.graph.Execute(backend, recorder);
+    CHECK_EQUAL(1u, backend.GetHeapCreateCount());
+
+    // Another size is a new layout, the new textures are discarded as well.
+    SampleGraph resized(true, 1920, 1080);
+    backend.Clear();
+    resized.graph.Compile(backend);
+    CHECK(resized.graph.GetLayout().version != 0);
+    resized.graph.Execute(backend, recorder);
+    CHECK_EQUAL(3u, GetCommands(backend, RecordingRenderGraphBackend::CommandDiscard).size());
+}
+
+TEST(RejectsTransientsNotWrittenFirst)
+{
+    RecordingRenderGraphBackend backend;
+    RenderGraph graph;
+    const RenderGraphResource output = graph.ImportTexture("Output", PresentState, PresentState);
+    const RenderGraphResource texture = graph.CreateTexture("ReadFirst", TextureDesc(64, 64));
+    const uint32_t pass = graph.AddPass("Pass", nullptr);
+    graph.Read(pass, texture, PixelShaderResourceState);
+    graph.Write(pass, output, RenderTargetState);
+    CHECK_THROWS(graph.Compile(backend), std::logic_error);
+
+    RenderGraph copied;
+    const RenderGraphResource copiedOutput = copied.ImportTexture("Output", PresentState, PresentState);
+    const RenderGraphResource copiedTexture = copied.CreateTexture("CopiedTo", TextureDesc(64, 64));
+    const uint32_t copy = copied.AddPass("Copy", nullptr);
+    copied.Write(copy, copiedTexture, 0x400);
+    const uint32_t use = copied.AddPass("Use", nullptr);
+    copied.Read(use, copiedTexture, PixelShaderResourceState);
+    copied.Write(use, copiedOutput, RenderTargetState);
+    CHECK_THROWS(copied.Compile(backend), std::logic_error);
+}
+
+TEST(RecordingOrderDoesNotDependOnTheThreadCount)
+{
+    std::string signatures[3];
+    const uint32_t threadCounts[] = { 1, 3, 4 };
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        JobSystem jobs(threadCounts[i]);
+        RecordingCommandListBackend lists(threadCounts[i]);
+        ParallelCommandRecorder recorder(jobs, lists);
+        RecordingRenderGraphBackend backend;
+
+        RenderGraph graph;
+        const RenderGraphResource output = graph.ImportTexture("Output", PresentState, PresentState);
+        RenderGraphResource previous = RenderGraph::InvalidResource;
+        for (uint32_t p = 0; p < 40; ++p)
+        {
+            const RenderGraphResource texture = graph.CreateTexture("T" + std::to_string(p), TextureDesc(256 + (p % 7) * 128, 256));
+            const uint32_t pass = graph.AddPass("P" + std::to_string(p), nullptr);
+            if (previous != RenderGraph::InvalidResource)
+            {
+                graph.Read(pass, previous, PixelShaderResourceState);
+            }
+            graph.Write(pass, texture, RenderTargetState);
+            previous = texture;
+        }
+        const uint32_t final = graph.AddPass("Final", nullptr);
+        graph.Read(final, previous, PixelShaderResourceState);
+        graph.Write(final, output, RenderTargetState);
+
+        graph.Compile(backend);
+        graph.Execute(backend, recorder);
+        signatures[i] = GetSignature(graph, backend);
+    }
+
+    CHECK(!signatures[0].empty());
+    CHECK(signatures[0] == signatures[1]);
+    CHECK(signatures[0] == signatures[2]);
+}
+
+TEST(ExecuteBeforeCompileThrows)
+{
+    JobSystem jobs(1);
+    RecordingCommandListBackend lists(1);
+    ParallelCommandRecorder recorder(jobs, lists);
+    RecordingRenderGraphBackend backend;
+    SampleGraph sample(false);
+    CHECK_THROWS(sample.graph.Execute(backend, recorder), std::logic_error);
+}
@@ -0,0 +1,243 @@
+#include "ResourceStateTracker.h"
+#include "TestHarness.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // D3D12_RESOURCE_STATE_* values.
+    const uint32_t StateCommon = 0x0;
+    const uint32_t StateRenderTarget = 0x4;
+    const uint32_t StateUnorderedAccess = 0x8;
+    const uint32_t StateNonPixelShaderResource = 0x40;
+    const uint32_t StatePixelShaderResource = 0x80;
+    const uint32_t StateCopyDest = 0x400;
+    const uint32_t StateCopySource = 0x800;
+    const uint32_t StateShaderResource = StateNonPixelShaderResource | StatePixelShaderResource;
+
+    // Stand-ins for the resources, only their addresses are used.
+    const int SceneTexture = 0;
+    const int BlurTexture = 1;
+    const void* const Scene = &SceneTexture;
+    const void* const Blur = &BlurTexture;
+
+    void CheckTransition(const ResourceTransition& transition, const void* resource, uint32_t subresource, uint32_t before, uint32_t after,
+        ResourceBarrierFlags flags = ResourceBarrierFlagNone)
+    {
+        CHECK(transition.resource == resource);
+        CHECK_EQUAL(subresource, transition.subresource);
+        CHECK_EQUAL(before, transition.before);
+        CHECK_EQUAL(after, transition.after);
+        CHECK_EQUAL(static_cast<uint32_t>(flags), static_cast<uint32_t>(transition.flags));
+    }
+}
+
+TEST(RedundantTransitionsAreDropped)
+{
+    ResourceStateTracker tracker;
+    RecordingResourceBarrierSink sink;
+    tracker.Track(Scene, 1, StateRenderTarget);
+    tracker.Transition(Scene, StateRenderTarget);
+    CHECK_EQUAL(0u, tracker.GetPendingCount());
+    tracker.Flush(sink);
+    CHECK(sink.GetBatches().empty());
+
+    tracker.Transition(Scene, StatePixelShaderResource);
+    tracker.Flush(sink);
+    tracker.Transition(Scene, StatePixelShaderResource);
+    tracker.Flush(sink);
+    CHECK_EQUAL(1u, static_cast<uint32_t>(sink.GetBatches().size()));
+    CheckTransition(sink.GetBatches()[0][0], Scene, ResourceStateTracker::AllSubresources, StateRenderTarget, StatePixelShaderResource);
+
+    const ResourceStateTrackerStats stats = tracker.GetStats();
+    CHECK_EQUAL(3ull, stats.transitionsRequested);
+    CHECK_EQUAL(2ull, stats.transitionsDropped);
+    CHECK_EQUAL(1ull, stats.barriersIssued);
+    CHECK_EQUAL(1ull, stats.barrierCalls);
+}
+
+// A read state already included in the current one needs no barrier, and
+// a combined read state is kept rather than narrowed.
+TEST(ReadStatesAreCombined)
+{
+    CHECK_EQUAL(StateShaderResource, ResourceStateTracker::ResolveState(StateShaderResource, StatePixelShaderResource));
+    CHECK_EQUAL(StatePixelShaderResource, ResourceStateTracker::ResolveState(StateCopySource, StatePixelShaderResource));
+    CHECK_EQUAL(StateCopyDest, ResourceStateTracker::ResolveState(StateShaderResource, StateCopyDest));
+    CHECK_EQUAL(StateCommon, ResourceStateTracker::ResolveState(StateShaderResource, StateCommon));
+    CHECK_EQUAL(StateRenderTarget, ResourceStateTracker::ResolveState(StateUnorderedAccess, StateRenderTarget));
+
+    ResourceStateTracker tracker;
+    RecordingResourceBarrierSink sink;
+    tracker.Track(Scene, 1, StatePixelShaderResource);
+    tracker.Transition(Scene, StateShaderResource);
+    tracker.Flush(sink);
+    tracker.Transition(Scene, StateNonPixelShaderResource);
+    tracker.Transition(Scene, StatePixelShaderResource);
+    tracker.Flush(sink);
+    CHECK_EQUAL(StateShaderResource, tracker.GetState(Scene));
+    CHECK_EQUAL(1u, sink.GetBarrierCount());
+    CheckTransition(sink.GetBatches()[0][0], Scene, ResourceStateTracker::AllSubresources, StatePixelShaderResource, StateShaderResource);
+}
+
+// Transitions of the same subresources queued before a flush become one
+// barrier from the first state to the last, or none if they cancel out.
+TEST(RepeatedTransitionsAreFolded)
+{
+    ResourceStateTracker tracker;
+    RecordingResourceBarrierSink sink;
+    tracker.Track(Scene, 1, StateRenderTarget);
+    tracker.Track(Blur, 1, StateUnorderedAccess);
+    tracker.Transition(Scene, StatePixelShaderResource);
+    tracker.Transition(Blur, StateNonPixelShaderResource);
+    tracker.Transition(Scene, StateCopySource);
+    CHECK_EQUAL(2u, tracker.GetPendingCount());
+    tracker.Flush(sink);
+    CHECK_EQUAL(1u, static_cast<uint32_t>(sink.GetBatches().size()));
+    CheckTransition(sink.GetBatches()[0][0], Scene, ResourceStateTracker::AllSubresources, StateRenderTarget, StateCopySource);
+    CheckTransition(sink.GetBatches()[0][1], Blur, ResourceStateTracker::AllSubresources, StateUnorderedAccess, StateNonPixelShaderResource);
+
+    tracker.Transition(Scene, StateRenderTarget);
+    tracker.Transition(Scene, StateCopySource);
+    CHECK_EQUAL(0u, tracker.GetPendingCount());
+    CHECK_EQUAL(StateCopySource, tracker.GetState(Scene));
+    tracker.Flush(sink);
+    CHECK_EQUAL(1u, static_cast<uint32_t>(sink.GetBatches().size()));
+}
+
+// Once its subresources are in different states, a whole resource transition
+// takes a barrier per subresource; back in one state it takes one again.
+TEST(SubresourcesSplitAfterAWholeResourceState)
+{
+    ResourceStateTracker tracker;
+    RecordingResourceBarrierSink sink;
+    tracker.Track(Scene, 3, StateRenderTarget);
+    tracker.Transition(Scene, StatePixelShaderResource, 1);
+    tracker.Flush(sink);
+    CheckTransition(sink.GetBatches()[0][0], Scene, 1, StateRenderTarget, StatePixelShaderResource);
+    CHECK_EQUAL(StateRenderTarget, tracker.GetState(Scene, 0));
+    CHECK_EQUAL(StatePixelShaderResource, tracker.GetState(Scene, 1));
+
+    tracker.Transition(Scene, StateCopyDest);
+    tracker.Flush(sink);
+    const std::vector<ResourceTransition>& split = sink.GetBatches()[1];
+    CHECK_EQUAL(3u, static_cast<uint32_t>(split.size()));
+    CheckTransition(split[0], Scene, 0, StateRenderTarget, StateCopyDest);
+    CheckTransition(split[1], Scene, 1, StatePixelShaderResource, StateCopyDest);
+    CheckTransition(split[2], Scene, 2, StateRenderTarget, StateCopyDest);
+
+    tracker.Transition(Scene, StateRenderTarget);
+    tracker.Flush(sink);
+    CHECK_EQUAL(1u, static_cast<uint32_t>(sink.GetBatches()[2].size()));
+    CheckTransition(sink.GetBatches()[2][0], Scene, ResourceStateTracker::AllSubresources, StateCopyDest, StateRenderTarget);
+
+    // A subresource transition behind a whole resource one keeps its order.
+    tracker.Transition(Scene, StatePixelShaderResource);
+    tracker.Transition(Scene, StateCopySource, 2);
+    tracker.Flush(sink);
+    CHECK_EQUAL(2u, static_cast<uint32_t>(sink.GetBatches()[3].size()));
+    CheckTransition(sink.GetBatches()[3][1], Scene, 2, StatePixelShaderResource, StateCopySource);
+}
+
+TEST(SplitBarriersBeginAndEnd)
+{
+    ResourceStateTracker tracker;
+    RecordingResourceBarrierSink sink;
+    tracker.Track(Scene, 1, StateRenderTarget);
+    tracker.BeginTransition(Scene, StatePixelShaderResource);
+    CHECK_EQUAL(StatePixelShaderResource, tracker.GetState(Scene));
+    tracker.Flush(sink);
+    tracker.EndTransition(Scene);
+    tracker.Flush(sink);
+    CHECK_EQUAL(2u, static_cast<uint32_t>(sink.GetBatches().size()));
+    CheckTransition(sink.GetBatches()[0][0], Scene, ResourceStateTracker::AllSubresources, StateRenderTarget, StatePixelShaderResource,
+        ResourceBarrierFlagBeginOnly);
+    CheckTransition(sink.GetBatches()[1][0], Scene, ResourceStateTracker::AllSubresources, StateRenderTarget, StatePixelShaderResource,
+        ResourceBarrierFlagEndOnly);
+
+    // Begun and ended before one flush, it is a plain barrier.
+    sink.Clear();
+    tracker.BeginTransition(Scene, StateRenderTarget);
+    tracker.EndTransition(Scene);
+    tracker.Flush(sink);
+    CHECK_EQUAL(1u, sink.GetBarrierCount());
+    CheckTransition(sink.GetBatches()[0][0], Scene, ResourceStateTracker::AllSubresources, StatePixelShaderResource, StateRenderTarget);
+
+    // Asking for the state being transitioned to closes the split.
+    sink.Clear();
+    tracker.BeginTransition(Scene, StateCopySource);
+    tracker.Flush(sink);
+    tracker.Transition(Scene, StateCopySource);
+    tracker.Flush(sink);
+    CheckTransition(sink.GetBatches()[1][0], Scene, ResourceStateTracker::AllSubresources, StateRenderTarget, StateCopySource,
+        ResourceBarrierFlagEndOnly);
+
+    // A redundant begin ends with nothing either.
+    sink.Clear();
+    tracker.BeginTransition(Scene, StateCopySource);
+    tracker.EndTransition(Scene);
+    tracker.Flush(sink);
+    CHECK(sink.GetBatches().empty());
+}
+
+TEST(SplitBarrierMisuseThrows)
+{
+    ResourceStateTracker tracker;
+    tracker.Track(Scene, 2, StateRenderTarget);
+    CHECK_THROWS(tracker.EndTransition(Scene), std::logic_error);
+
+    tracker.BeginTransition(Scene, StatePixelShaderResource, 0);
+    CHECK_THROWS(tracker.BeginTransition(Scene, StatePixelShaderResource), std::logic_error);
+    CHECK_THROWS(tracker.Transition(Scene, StateCopyDest, 0), std::logic_error);
+    CHECK_THROWS(tracker.EndTransition(Scene, 1), std::logic_error);
+    tracker.EndTransition(Scene, 0);
+
+    // The subresources are in different states now.
+    CHECK_THROWS(tracker.BeginTransition(Scene, StateCopyDest), std::logic_error);
+    CHECK_THROWS(tracker.Transition(Blur, StateCopyDest), std::logic_error);
+    CHECK_THROWS(tracker.Track(nullptr, 1, StateCommon), std::invalid_argument);
+}
+
+// A frame of the sample: the scene is drawn, blurred and read by the quad,
+// the back buffer presented. Each flush is one call in place of one per
+// requested transition.
+TEST(RemovedCallsAreCounted)
+{
+    const int backBufferResource = 0;
+    const void* const backBuffer = &backBufferResource;
+
+    ResourceStateTracker tracker;
+    RecordingResourceBarrierSink sink;
+    tracker.Track(Scene, 1, StatePixelShaderResource);
+    tracker.Track(Blur, 1, StatePixelShaderResource);
+    tracker.Track(backBuffer, 1, StateCommon);
+
+    tracker.Transition(Scene, StateRenderTarget);
+    tracker.Transition(backBuffer, StateRenderTarget);
+    tracker.Flush(sink);
+    tracker.Transition(Scene, StateNonPixelShaderResource);
+    tracker.Transition(Blur, StateUnorderedAccess);
+    tracker.Flush(sink);
+    tracker.Transition(Blur, StatePixelShaderResource);
+    tracker.Transition(Scene, StateNonPixelShaderResource);
+    tracker.Flush(sink);
+    tracker.Transition(backBuffer, StateCommon);
+    tracker.Flush(sink);
+
+    CHECK_EQUAL(4u, static_cast<uint32_t>(sink.GetBatches().size()));
+    CHECK_EQUAL(6u, sink.GetBarrierCount());
+    CHECK_EQUAL(7ull, tracker.GetStats().transitionsRequested);
+    CHECK_EQUAL(1ull, tracker.GetStats().transitionsDropped);
+    CHECK_EQUAL(6ull, tracker.GetStats().barriersIssued);
+    CHECK_EQUAL(3ull, tracker.GetRemovedCallCount());
+
+    tracker.ResetStats();
+    CHECK_EQUAL(0ull, tracker.GetRemovedCallCount());
+
+    // Forgetting a resource drops its pending barriers.
+    tracker.Transition(Scene, StateCopySource);
+    tracker.Transition(Blur, StateCopyDest);
+    tracker.Untrack(Scene);
+    CHECK(!tracker.IsTracked(Scene));
+    CHECK_EQUAL(1u, tracker.GetPendingCount());
+}
@@ -0,0 +1,257 @@
+#include "RootSignatureBuilder.h"
+#include "TestHarness.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+    const RootStaticSamplerDesc LinearWrapSampler = { 0x15, 1, 0, 0, RootVisibilityPixel };
+
+    // The signature of the triangle and quad passes, as LoadPipeline builds it.
+    RootSignatureBuilder MainBuilder(uint32_t rootConstantLimit = RootSignatureBuilder::DefaultRootConstantLimit)
+    {
+        RootSignatureBuilder builder(rootConstantLimit);
+        builder.AddConstantBuffer(0, 48);
+        builder.AddTable(RootRangeSrv, 0, 1, RootVisibilityPixel);
+        builder.AddRootView(RootParameterSrv, 1, RootVisibilityVertex, RootDataStatic);
+        builder.AddStaticSampler(LinearWrapSampler);
+        builder.SetFlags(RootSignatureAllowInputLayout);
+        return builder;
+    }
+
+    // The signature of the blur pass: 36 weights and offsets do not fit the
+    // default limit, the pass index and direction always go into the root.
+    RootSignatureBuilder BlurBuilder()
+    {
+        RootSignatureBuilder builder;
+        builder.AddConstantBuffer(0, 16 + 4 * 36);
+        builder.AddRootConstants(1, 4);
+        builder.AddTable(RootRangeSrv, 0);
+        builder.AddTable(RootRangeUav, 0);
+        return builder;
+    }
+
+    // A layout with a single static sampler, the filter and address mode
+    // taken from value.
+    RootSignatureLayout SamplerLayout(uint64_t value)
+    {
+        const RootStaticSamplerDesc sampler = { static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32), 0, 0, RootVisibilityPixel };
+        RootSignatureBuilder builder;
+        builder.AddStaticSampler(sampler);
+        return builder.Build();
+    }
+}
+
+TEST(SampleSignaturesAreLaidOutAndCosted)
+{
+    RootSignatureBuilder builder = MainBuilder();
+    const RootSignatureLayout layout = builder.Build();
+    CHECK_EQUAL(3u, static_cast<uint32_t>(layout.GetParameters().size()));
+    CHECK_EQUAL(RootParameterConstants, layout.GetParameter(0).type);
+    CHECK_EQUAL(12u, layout.GetParameter(0).count);
+    CHECK_EQUAL(static_cast<uint32_t>(RootDescriptorsVolatile | RootDataStaticWhileSetAtExecute), layout.GetParameter(1).flags);
+    CHECK_EQUAL(static_cast<uint32_t>(RootDataStatic), layout.GetParameter(2).flags);
+    CHECK_EQUAL(1u, static_cast<uint32_t>(layout.GetStaticSamplers().size()));
+    CHECK_EQUAL(static_cast<uint32_t>(RootSignatureAllowInputLayout), layout.GetFlags());
+    CHECK_EQUAL(15u, layout.GetCost());
+    CHECK(layout.Describe() == "b0 constants 12 + t0 table 1 + t1 SRV 2 = 15 DWORDs");
+
+    const RootSignatureLayout blur = BlurBuilder().Build();
+    CHECK_EQUAL(RootParameterCbv, blur.GetParameter(0).type);
+    CHECK_EQUAL(static_cast<uint32_t>(RootDataStatic), blur.GetParameter(0).flags);
+    CHECK_EQUAL(RootParameterConstants, blur.GetParameter(1).type);
+    CHECK_EQUAL(4u, blur.GetParameter(1).count);
+    CHECK_EQUAL(static_cast<uint32_t>(RootDescriptorsVolatile | RootDataVolatile), blur.GetParameter(3).flags);
+    CHECK_EQUAL(8u, blur.GetCost());
+    CHECK(blur.Describe() == "b0 CBV 2 + b1 constants 4 + t0 table 1 + u0 table 1 = 8 DWORDs");
+
+    CHECK_EQUAL(0u, RootSignatureLayout().GetCost());
+    CHECK(RootSignatureLayout().Describe() == "0 DWORDs");
+}
+
+// Each Add returns the index its parameter has in the layout, whatever
+// becomes of the constant buffers.
+TEST(AddReturnsTheRootParameterIndex)
+{
+    RootSignatureBuilder builder;
+    CHECK_EQUAL(0u, builder.AddConstantBuffer(0, 256));
+    CHECK_EQUAL(1u, builder.AddRootConstants(1, 4));
+    CHECK_EQUAL(2u, builder.AddTable(RootRangeSrv, 0, 2));
+    CHECK_EQUAL(3u, builder.AddRootView(RootParameterUav, 0));
+    CHECK_EQUAL(4u, builder.AddConstantBuffer(2, 16));
+
+    const RootSignatureLayout layout = builder.Build();
+    CHECK_EQUAL(RootParameterCbv, layout.GetParameter(0).type);
+    CHECK_EQUAL(1u, layout.GetParameter(1).shaderRegister);
+    CHECK_EQUAL(RootParameterTable, layout.GetParameter(2).type);
+    CHECK_EQUAL(RootParameterUav, layout.GetParameter(3).type);
+    CHECK_EQUAL(RootParameterConstants, layout.GetParameter(4).type);
+    CHECK_EQUAL(2u, layout.GetParameter(4).shaderRegister);
+}
+
+// The smallest constant buffers are promoted first, equal sizes in the order
+// they were added, until the next one would overflow the root.
+TEST(SmallestConstantBuffersArePromotedFirst)
+{
+    RootSignatureBuilder builder;
+    const uint32_t sizes[] = { 64, 16, 48, 32, 64, 16 };
+    for (uint32_t i = 0; i < 6; ++i)
+    {
+        builder.AddConstantBuffer(i, sizes[i]);
+    }
+    for (uint32_t i = 0; i < 8; ++i)
+    {
+        builder.AddRootView(RootParameterSrv, i);
+    }
+
+    // 28 DWORDs of root descriptors, then 4, 4, 8, 12 and one of the two 16
+    // DWORD buffers: the second would take 78.
+    const RootSignatureLayout layout = builder.Build();
+    CHECK_EQUAL(RootParameterConstants, layout.GetParameter(1).type);
+    CHECK_EQUAL(RootParameterConstants, layout.GetParameter(5).type);
+    CHECK_EQUAL(RootParameterConstants, layout.GetParameter(3).type);
+    CHECK_EQUAL(RootParameterConstants, layout.GetParameter(2).type);
+    CHECK_EQUAL(RootParameterConstants, layout.GetParameter(0).type);
+    CHECK_EQUAL(16u, layout.GetParameter(0).count);
+    CHECK_EQUAL(RootParameterCbv, layout.GetParameter(4).type);
+    CHECK_EQUAL(static_cast<uint32_t>(RootDataStatic), layout.GetParameter(4).flags);
+    CHECK_EQUAL(62u, layout.GetCost());
+}
+
+// Buffers over the limit stay root CBVs, and so do the larger ones after them.
+TEST(RootConstantLimitIsRespected)
+{
+    const RootSignatureLayout limited = MainBuilder(8).Build();
+    CHECK_EQUAL(RootParameterCbv, limited.GetParameter(0).type);
+    CHECK_EQUAL(5u, limited.GetCost());
+    CHECK(limited != MainBuilder().Build());
+
+    RootSignatureBuilder builder(4);
+    builder.AddConstantBuffer(0, 20);
+    builder.AddConstantBuffer(1, 14);
+    builder.AddConstantBuffer(2, 64);
+    const RootSignatureLayout layout = builder.Build();
+    CHECK_EQUAL(RootParameterCbv, layout.GetParameter(0).type);
+    CHECK_EQUAL(RootParameterConstants, layout.GetParameter(1).type);
+    CHECK_EQUAL(4u, layout.GetParameter(1).count);
+    CHECK_EQUAL(RootParameterCbv, layout.GetParameter(2).type);
+    CHECK(layout.Describe() == "b0 CBV 2 + b1 constants 4 + b2 CBV 2 = 8 DWORDs");
+}
+
+// 64 DWORDs fit, one more does not; static samplers take no root space.
+TEST(RootSpaceIsLimitedTo64Dwords)
+{
+    RootSignatureBuilder builder;
+    for (uint32_t i = 0; i < 32; ++i)
+    {
+        builder.AddRootView(RootParameterSrv, i);
+    }
+    for (uint32_t i = 0; i < 16; ++i)
+    {
+        const RootStaticSamplerDesc sampler = { 0, 1, i, 0, RootVisibilityAll };
+        builder.AddStaticSampler(sampler);
+    }
+    CHECK_EQUAL(64u, builder.Build().GetCost());
+
+    builder.AddTable(RootRangeUav, 0);
+    CHECK_THROWS(builder.Build(), std::invalid_argument);
+
+    RootSignatureBuilder constants;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        constants.AddRootConstants(i, 16);
+    }
+    CHECK_EQUAL(64u, constants.Build().GetCost());
+    constants.AddRootConstants(4, 1);
+    CHECK_THROWS(constants.Build(), std::invalid_argument);
+}
+
+// A register is bound once per stage and space: a table covers its whole
+// range, and a binding visible to all stages overlaps every stage.
+TEST(OverlappingRegistersAreRejected)
+{
+    RootSignatureBuilder table;
+    table.AddTable(RootRangeSrv, 0, 4, RootVisibilityPixel);
+    table.AddRootView(RootParameterSrv, 3, RootVisibilityAll);
+    CHECK_THROWS(table.Build(), std::invalid_argument);
+
+    RootSignatureBuilder constants;
+    constants.AddConstantBuffer(0, 16);
+    constants.AddRootConstants(0, 4, RootVisibilityPixel);
+    CHECK_THROWS(constants.Build(), std::invalid_argument);
+
+    RootSignatureBuilder samplers;
+    samplers.AddTable(RootRangeSampler, 0, 2, RootVisibilityPixel, RootDataDefault);
+    samplers.AddStaticSampler(LinearWrapSampler);
+    CHECK_THROWS(samplers.Build(), std::invalid_argument);
+
+    // Other stages, spaces, registers or classes do not overlap.
+    RootSignatureBuilder apart;
+    apart.AddTable(RootRangeSrv, 0, 4, RootVisibilityPixel);
+    apart.AddRootView(RootParameterSrv, 3, RootVisibilityVertex);
+    apart.AddRootView(RootParameterSrv, 0, RootVisibilityAll, RootDataStaticWhileSetAtExecute, 1);
+    apart.AddTable(RootRangeSrv, 4, 2);
+    apart.AddRootView(RootParameterUav, 0);
+    apart.AddConstantBuffer(0, 16);
+    apart.AddStaticSampler(LinearWrapSampler);
+    CHECK_EQUAL(6u, static_cast<uint32_t>(apart.Build().GetParameters().size()));
+}
+
+TEST(InvalidDataFlagsAreRejected)
+{
+    RootSignatureBuilder builder;
+    CHECK_THROWS(builder.AddTable(RootRangeSrv, 0, 1, RootVisibilityAll, RootDescriptorsVolatile | RootDataStatic), std::invalid_argument);
+    CHECK_THROWS(builder.AddTable(RootRangeSrv, 0, 1, RootVisibilityAll, RootDataVolatile | RootDataStatic), std::invalid_argument);
+    CHECK_THROWS(builder.AddTable(RootRangeSampler, 0, 1, RootVisibilityAll, RootDataStatic), std::invalid_argument);
+    CHECK_THROWS(builder.AddRootView(RootParameterSrv, 0, RootVisibilityAll, RootDataVolatile | RootDataStatic), std::invalid_argument);
+    CHECK_EQUAL(0u, static_cast<uint32_t>(builder.Build().GetParameters().size()));
+}
+
+// Identical layouts share an index, different ones get their own.
+TEST(CacheSharesIdenticalLayouts)
+{
+    RootSignatureCache cache;
+    bool added = false;
+    CHECK_EQUAL(0u, cache.Add(MainBuilder().Build(), &added));
+    CHECK(added);
+    CHECK_EQUAL(1u, cache.Add(BlurBuilder().Build(), &added));
+    CHECK(added);
+    CHECK_EQUAL(0u, cache.Add(MainBuilder().Build(), &added));
+    CHECK(!added);
+    CHECK_EQUAL(2u, cache.Add(MainBuilder(8).Build(), &added));
+    CHECK(added);
+    CHECK_EQUAL(1u, cache.Add(BlurBuilder().Build(), &added));
+    CHECK(!added);
+
+    CHECK(cache.GetLayout(1) == BlurBuilder().Build());
+    CHECK_EQUAL(3u, cache.GetCount());
+    CHECK_EQUAL(5u, cache.GetStats().requests);
+    CHECK_EQUAL(3u, cache.GetStats().signatures);
+    CHECK(MainBuilder().Build().GetHash() == MainBuilder().Build().GetHash());
+    CHECK(MainBuilder().Build().GetHash() != BlurBuilder().Build().GetHash());
+}
+
+// Two layouts with the same 64-bit hash, found by a cycle search over the
+// filter and address mode of a sampler, are still told apart.
+TEST(CacheSeparatesHashCollisions)
+{
+    const RootSignatureLayout first = SamplerLayout(0x06769ab77367d628ull);
+    const RootSignatureLayout second = SamplerLayout(0x2164bc335a3377b9ull);
+    CHECK(first != second);
+    CHECK(first.GetHash() == second.GetHash());
+
+    RootSignatureCache cache;
+    bool added = false;
+    CHECK_EQUAL(0u, cache.Add(first, &added));
+    CHECK(added);
+    CHECK_EQUAL(1u, cache.Add(second, &added));
+    CHECK(added);
+    CHECK_EQUAL(0u, cache.Add(first, &added));
+    CHECK(!added);
+    CHECK_EQUAL(1u, cache.Add(second, &added));
+    CHECK(!added);
+    CHECK(cache.GetLayout(1) == second);
+    CHECK_EQUAL(4u, cache.GetStats().requests);
+    CHECK_EQUAL(2u, cache.GetStats().signatures);
+}
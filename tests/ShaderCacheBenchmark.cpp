@@ -0,0 +1,132 @@
+#include "ShaderCache.h"
+#include "Benchmark.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // The shaders LoadAssets compiles, with what fxc -O3 takes for them in ms.
+    struct SampleShader
+    {
+        const char* file;
+        const char* entryPoint;
+        const char* target;
+        double compileMs;
+    };
+
+    const SampleShader SampleShaders[] =
+    {
+        { "shaders.hlsl",      "VSMain", "vs_5_0", 30.0 },
+        { "shaders.hlsl",      "PSMain", "ps_5_0", 55.0 },
+        { "quad_shaders.hlsl", "VSMain", "vs_5_0", 20.0 },
+        { "quad_shaders.hlsl", "PSMain", "ps_5_0", 35.0 },
+        { "blur.hlsl",         "CSMain", "cs_5_0", 60.0 },
+    };
+
+    const std::string PackPath = "ShaderCacheBenchmark.pack";
+
+    // The sample's shaders, compiled once per variant with a define of its
+    // own, like a material system would.
+    std::vector<ShaderCompileRequest> MakeRequests(uint32_t variants)
+    {
+        std::vector<ShaderCompileRequest> requests;
+        for (uint32_t variant = 0; variant < variants; ++variant)
+        {
+            for (const SampleShader& shader : SampleShaders)
+            {
+                ShaderCompileRequest request;
+                request.sourcePath = std::string(TEST_DATA_DIR) + "/../../" + shader.file;
+                request.entryPoint = shader.entryPoint;
+                request.target = shader.target;
+                request.flags = 0;
+                if (variants > 1)
+                {
+                    request.defines.push_back(std::make_pair("VARIANT", std::to_string(variant)));
+                }
+                requests.push_back(request);
+            }
+        }
+        return requests;
+    }
+
+    // A compiler that takes the time of fxc, simulated by a sleep, and returns
+    // 4KB of bytecode.
+    ShaderCompileCallback MakeSlowCompiler(double scale)
+    {
+        return [scale](const ShaderCompileRequest& request, const std::vector<uint8_t>& /*source*/, std::vector<uint8_t>& bytecode,
+            std::string& /*errors*/)
+        {
+            double compileMs = 0.0;
+            for (const SampleShader& shader : SampleShaders)
+            {
+                if (request.sourcePath.find(shader.file) != std::string::npos && request.entryPoint == shader.entryPoint)
+                {
+                    compileMs = shader.compileMs * scale;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(compileMs * 1000.0)));
+            bytecode.assign(4096, static_cast<uint8_t>(request.entryPoint[0]));
+            return true;
+        };
+    }
+
+    void PrintRow(const char* name, uint32_t shaders, const ShaderCache& cache, double milliseconds)
+    {
+        const ShaderCacheStats stats = cache.GetStats();
+        printf("%-8s %8u %8u %8u %12.2f %10.3f %12.2f %12.4f\n", name, shaders, stats.hits, stats.misses, milliseconds,
+            stats.hashMilliseconds, stats.compileMilliseconds, milliseconds / shaders);
+    }
+}
+
+// Getting the sample's five shaders through ShaderCache with a compiler that
+// takes as long as fxc: cold, without a pack, then warm, from the pack the
+// cold run saved. Then 20 variants of each, where a warm start only hashes
+// the sources and looks the keys up.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const double scale = quick ? 0.02 : 1.0;
+    const uint32_t variantCounts[] = { 1, 20 };
+
+    printf("%-8s %8s %8s %8s %12s %10s %12s %12s\n", "start", "shaders", "hits", "misses", "total ms", "hash ms", "compile ms", "ms/shader");
+    for (uint32_t variants : variantCounts)
+    {
+        const std::vector<ShaderCompileRequest> requests = MakeRequests(variants);
+        const uint32_t count = static_cast<uint32_t>(requests.size());
+        remove(PackPath.c_str());
+
+        {
+            BenchmarkTimer timer;
+            ShaderCache cache(PackPath, "slow 1", MakeSlowCompiler(scale));
+            size_t bytes = 0;
+            for (const ShaderCompileRequest& request : requests)
+            {
+                bytes += cache.Get(request).size;
+            }
+            cache.Save();
+            const double milliseconds = timer.GetMilliseconds();
+            KeepResult(bytes);
+            PrintRow("cold", count, cache, milliseconds);
+        }
+
+        {
+            BenchmarkTimer timer;
+            ShaderCache cache(PackPath, "slow 1", MakeSlowCompiler(scale));
+            size_t bytes = 0;
+            for (const ShaderCompileRequest& request : requests)
+            {
+                bytes += cache.Get(request).size;
+            }
+            const double milliseconds = timer.GetMilliseconds();
+            KeepResult(bytes);
+            PrintRow("warm", count, cache, milliseconds);
+        }
+    }
+    remove(PackPath.c_str());
+    return 0;
+}
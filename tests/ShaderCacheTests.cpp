@@ -0,0 +1,374 @@
+#include "ShaderCache.h"
+#include "MappedFile.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    // The shaders live in a scratch directory next to the test:
+    //   a.hlsl            includes inc/common.hlsli
+    //   inc/common.hlsli  includes ../b.hlsl
+    //   b.hlsl
+    const std::string Directory = "ShaderCacheTests.dir/";
+    const std::string PackPath = Directory + "shaders.pack";
+    const char* const ScratchFiles[] = { "a.hlsl", "inc/common.hlsli", "b.hlsl", "shaders.pack", "copy.pack" };
+
+    void MakeDirectory(const std::string& path)
+    {
+#ifdef _WIN32
+        _mkdir(path.c_str());
+#else
+        mkdir(path.c_str(), 0755);
+#endif
+    }
+
+    void WriteText(const std::string& name, const std::string& text)
+    {
+        CHECK(WriteFileAtomic(Directory + name, text.data(), text.size()));
+    }
+
+    void CreateSources()
+    {
+        MakeDirectory(Directory);
+        MakeDirectory(Directory + "inc");
+        remove(PackPath.c_str());
+        WriteText("a.hlsl", "#include \"inc/common.hlsli\"\nA1");
+        WriteText("inc/common.hlsli", "#include \"../b.hlsl\"\nC1");
+        WriteText("b.hlsl", "B1");
+    }
+
+    void RemoveSources()
+    {
+        for (const char* name : ScratchFiles)
+        {
+            remove((Directory + name).c_str());
+        }
+        remove((Directory + "inc").c_str());
+        remove(Directory.c_str());
+    }
+
+    ShaderCompileRequest MakeRequest(const char* entryPoint = "VSMain")
+    {
+        ShaderCompileRequest request;
+        request.sourcePath = Directory + "a.hlsl";
+        request.entryPoint = entryPoint;
+        request.target = "vs_5_0";
+        request.flags = 0;
+        return request;
+    }
+
+    std::string ToString(const ShaderBytecode& bytecode)
+    {
+        return std::string(static_cast<const char*>(bytecode.data), bytecode.size);
+    }
+
+    // Stands in for D3DCompileFromFile: the bytecode is the entry point and the
+    // source, a source containing ERROR does not compile.
+    class FakeCompiler
+    {
+    public:
+        FakeCompiler() : m_compiles(0) {}
+
+        ShaderCompileCallback GetCallback()
+        {
+            return [this](const ShaderCompileRequest& request, const std::vector<uint8_t>& source, std::vector<uint8_t>& bytecode,
+                std::string& errors)
+            {
+                m_compiles++;
+                const std::string text(source.begin(), source.end());
+                if (text.find("ERROR") != std::string::npos)
+                {
+                    errors = "syntax error";
+                    return false;
+                }
+                const std::string code = request.entryPoint + ":" + text;
+                bytecode.assign(code.begin(), code.end());
+                return true;
+            };
+        }
+
+        uint32_t GetCompiles() const { return m_compiles.load(); }
+
+    private:
+        std::atomic<uint32_t> m_compiles;
+    };
+
+    bool ReadPack(const std::string& path, std::vector<uint8_t>& contents)
+    {
+        return ReadFileBytes(path, contents) && !contents.empty();
+    }
+}
+
+TEST(HitAfterMiss)
+{
+    CreateSources();
+    FakeCompiler compiler;
+    ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+
+    const std::string first = ToString(cache.Get(MakeRequest()));
+    CHECK(first == "VSMain:#include \"inc/common.hlsli\"\nA1");
+    const std::string second = ToString(cache.Get(MakeRequest()));
+    CHECK(second == first);
+    CHECK_EQUAL(1u, compiler.GetCompiles());
+
+    // Another entry point of the same file is a shader of its own.
+    CHECK(ToString(cache.Get(MakeRequest("PSMain"))).find("PSMain:") == 0);
+    CHECK_EQUAL(2u, compiler.GetCompiles());
+
+    const ShaderCacheStats stats = cache.GetStats();
+    CHECK_EQUAL(1u, stats.hits);
+    CHECK_EQUAL(2u, stats.misses);
+    RemoveSources();
+}
+
+// Editing a file pulled in through a chain of includes changes the key;
+// putting it back finds the first bytecode again.
+TEST(IncludeChangesMiss)
+{
+    CreateSources();
+    FakeCompiler compiler;
+    ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+
+    uint64_t original;
+    CHECK(cache.ComputeKey(MakeRequest(), &original));
+    cache.Get(MakeRequest());
+
+    WriteText("b.hlsl", "B2");
+    uint64_t edited;
+    CHECK(cache.ComputeKey(MakeRequest(), &edited));
+    CHECK(edited != original);
+    cache.Get(MakeRequest());
+    CHECK_EQUAL(2u, compiler.GetCompiles());
+
+    WriteText("b.hlsl", "B1");
+    cache.Get(MakeRequest());
+    CHECK_EQUAL(2u, compiler.GetCompiles());
+
+    // An include that goes missing is a change as well.
+    remove((Directory + "b.hlsl").c_str());
+    cache.Get(MakeRequest());
+    CHECK_EQUAL(3u, compiler.GetCompiles());
+    CHECK_EQUAL(1u, cache.GetStats().hits);
+
+    std::vector<std::string> files;
+    FindShaderDependencies(Directory + "a.hlsl", files);
+    CHECK_EQUAL(3u, static_cast<uint32_t>(files.size()));
+    CHECK(files[2] == Directory + "inc/../b.hlsl");
+    RemoveSources();
+}
+
+// Every part of the request is in the key, the compiler id as well.
+TEST(FlagsAndDefinesMiss)
+{
+    CreateSources();
+    FakeCompiler compiler;
+    ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+    cache.Get(MakeRequest());
+
+    ShaderCompileRequest request = MakeRequest();
+    request.flags = 1;
+    cache.Get(request);
+    CHECK_EQUAL(2u, compiler.GetCompiles());
+
+    request.defines.push_back(std::make_pair("BLUR_RADIUS", "4"));
+    cache.Get(request);
+    CHECK_EQUAL(3u, compiler.GetCompiles());
+
+    request.defines.back().second = "8";
+    cache.Get(request);
+    CHECK_EQUAL(4u, compiler.GetCompiles());
+
+    request = MakeRequest();
+    request.target = "vs_5_1";
+    cache.Get(request);
+    CHECK_EQUAL(5u, compiler.GetCompiles());
+
+    // The same requests again are all hits.
+    cache.Get(MakeRequest());
+    cache.Get(request);
+    CHECK_EQUAL(5u, compiler.GetCompiles());
+
+    uint64_t key;
+    uint64_t otherCompilerKey;
+    CHECK(cache.ComputeKey(MakeRequest(), &key));
+    ShaderCache otherCompiler(PackPath, "fake 2", compiler.GetCallback());
+    CHECK(otherCompiler.ComputeKey(MakeRequest(), &otherCompilerKey));
+    CHECK(key != otherCompilerKey);
+    RemoveSources();
+}
+
+// A saved cache is warm when it is opened again, and the pack keeps the
+// entries of the earlier runs.
+TEST(SavedPackIsWarm)
+{
+    CreateSources();
+    {
+        FakeCompiler compiler;
+        ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+        cache.Get(MakeRequest());
+        CHECK(cache.Save());
+    }
+    {
+        FakeCompiler compiler;
+        ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+        CHECK(ToString(cache.Get(MakeRequest())).find("VSMain:") == 0);
+        CHECK_EQUAL(0u, compiler.GetCompiles());
+        cache.Get(MakeRequest("PSMain"));
+        CHECK(cache.Save());
+        CHECK(ToString(cache.Get(MakeRequest("PSMain"))).find("PSMain:") == 0);
+    }
+    {
+        FakeCompiler compiler;
+        ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+        cache.Get(MakeRequest());
+        cache.Get(MakeRequest("PSMain"));
+        CHECK_EQUAL(0u, compiler.GetCompiles());
+        CHECK_EQUAL(2u, cache.GetStats().hits);
+    }
+    RemoveSources();
+}
+
+TEST(BlobPackRoundTrip)
+{
+    MakeDirectory(Directory);
+    const std::string path = Directory + "copy.pack";
+    const char* const blobs[] = { "first", "", "third blob, longer than the alignment of 16 bytes" };
+    const uint64_t keys[] = { 0x30, 0x10, 0xffffffffffffffffull };
+
+    BlobPackWriter writer;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        writer.Add(keys[i], blobs[i], strlen(blobs[i]));
+    }
+    writer.Add(0x30, "replaced", 8);
+    CHECK(writer.Contains(0x10));
+    CHECK_EQUAL(3u, static_cast<uint32_t>(writer.GetEntryCount()));
+    CHECK(writer.Write(path));
+
+    BlobPackReader reader;
+    CHECK(reader.Open(path));
+    CHECK_EQUAL(3u, reader.GetEntryCount());
+
+    const uint8_t* data;
+    uint64_t size;
+    CHECK(reader.Find(0x30, &data, &size));
+    CHECK(std::string(reinterpret_cast<const char*>(data), static_cast<size_t>(size)) == "replaced");
+    CHECK(reader.Find(0x10, &data, &size));
+    CHECK_EQUAL(0ull, size);
+    CHECK(reader.Find(keys[2], &data, &size));
+    CHECK(std::string(reinterpret_cast<const char*>(data), static_cast<size_t>(size)) == blobs[2]);
+    CHECK_EQUAL(0u, static_cast<uint32_t>(reinterpret_cast<uintptr_t>(data) % 16));
+    CHECK(!reader.Find(0x20, &data, &size));
+
+    // The entries are sorted by key.
+    uint64_t key;
+    reader.GetEntry(0, &key, &data, &size);
+    CHECK_EQUAL(0x10ull, key);
+    reader.GetEntry(2, &key, &data, &size);
+    CHECK_EQUAL(keys[2], key);
+    reader.Close();
+
+    // A store over the pack finds its blobs, the added ones first.
+    BlobStore store(path);
+    std::vector<uint8_t> blob(4, 7);
+    store.Add(0x10, blob);
+    CHECK(store.IsDirty());
+    CHECK(store.Find(0x10, &data, &size));
+    CHECK_EQUAL(4ull, size);
+    CHECK(store.Save());
+    CHECK(!store.IsDirty());
+    CHECK(store.Find(0x30, &data, &size));
+    CHECK(store.Find(0x10, &data, &size));
+    CHECK_EQUAL(4ull, size);
+    RemoveSources();
+}
+
+// Truncated or overwritten packs are rejected as a whole: the store is empty,
+// the shaders compile again and saving writes a valid pack.
+TEST(CorruptPacksAreEmpty)
+{
+    CreateSources();
+    {
+        FakeCompiler compiler;
+        ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+        cache.Get(MakeRequest());
+        cache.Get(MakeRequest("PSMain"));
+        CHECK(cache.Save());
+    }
+    std::vector<uint8_t> pack;
+    CHECK(ReadPack(PackPath, pack));
+
+    std::vector<std::vector<uint8_t>> corrupt;
+    const size_t lengths[] = { 0, 8, 16 + 24, 16 + 2 * 24 + 4 };     // Into the header, the table, the first blob.
+    for (size_t length : lengths)
+    {
+        corrupt.push_back(std::vector<uint8_t>(pack.begin(), pack.begin() + length));
+    }
+    corrupt.push_back(pack);
+    corrupt.back()[0] ^= 0xff;      // Magic.
+    corrupt.push_back(pack);
+    corrupt.back()[8] = 0xff;       // Entry count past the end of the file.
+    corrupt.push_back(pack);
+    corrupt.back()[16 + 8 + 7] = 0x7f;  // Offset of the first blob.
+    corrupt.push_back(pack);
+    std::swap_ranges(corrupt.back().begin() + 16, corrupt.back().begin() + 16 + 24, corrupt.back().begin() + 16 + 24);  // Unsorted keys.
+
+    for (const std::vector<uint8_t>& contents : corrupt)
+    {
+        CHECK(WriteFileAtomic(PackPath, contents.data(), contents.size()));
+        BlobPackReader reader;
+        CHECK(!reader.Open(PackPath));
+        CHECK_EQUAL(0u, reader.GetEntryCount());
+
+        FakeCompiler compiler;
+        ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+        CHECK(ToString(cache.Get(MakeRequest())).find("VSMain:") == 0);
+        CHECK_EQUAL(1u, compiler.GetCompiles());
+    }
+
+    {
+        FakeCompiler compiler;
+        ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+        cache.Get(MakeRequest());
+        CHECK(cache.Save());
+    }
+    BlobPackReader reader;
+    CHECK(reader.Open(PackPath));
+    CHECK_EQUAL(1u, reader.GetEntryCount());
+    RemoveSources();
+}
+
+TEST(FailedCompilesThrow)
+{
+    CreateSources();
+    FakeCompiler compiler;
+    ShaderCache cache(PackPath, "fake 1", compiler.GetCallback());
+    WriteText("a.hlsl", "ERROR");
+    CHECK_THROWS(cache.Get(MakeRequest()), std::runtime_error);
+
+    // Nothing was stored, the fixed source compiles.
+    WriteText("a.hlsl", "#include \"inc/common.hlsli\"\nA1");
+    cache.Get(MakeRequest());
+    CHECK_EQUAL(2u, compiler.GetCompiles());
+
+    ShaderCompileRequest missing = MakeRequest();
+    missing.sourcePath = Directory + "missing.hlsl";
+    CHECK_THROWS(cache.Get(missing), std::runtime_error);
+    CHECK_EQUAL(2u, compiler.GetCompiles());
+    RemoveSources();
+}
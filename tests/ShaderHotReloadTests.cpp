@@ -0,0 +1,429 @@
+#include "ShaderHotReload.h"
+#include "MappedFile.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Past the time ShaderHotReload lets a changed file settle.
+    const std::chrono::milliseconds Settled(150);
+
+    // The shaders live in a scratch directory next to the test:
+    //   a.hlsl            includes inc/common.hlsli
+    //   inc/common.hlsli  includes ../b.hlsl
+    //   b.hlsl, q.hlsl
+    const std::string Directory = "ShaderHotReloadTests.dir/";
+    const char* const ScratchFiles[] = { "a.hlsl", "inc/common.hlsli", "b.hlsl", "q.hlsl" };
+
+    void MakeDirectory(const std::string& path)
+    {
+#ifdef _WIN32
+        _mkdir(path.c_str());
+#else
+        mkdir(path.c_str(), 0755);
+#endif
+    }
+
+    void WriteSource(const std::string& name, const std::string& text)
+    {
+        CHECK(WriteFileAtomic(Directory + name, text.data(), text.size()));
+    }
+
+    void CreateSources()
+    {
+        MakeDirectory(Directory);
+        MakeDirectory(Directory + "inc");
+        WriteSource("a.hlsl", "#include \"inc/common.hlsli\"\nA1");
+        WriteSource("inc/common.hlsli", "#include \"../b.hlsl\"\nC1");
+        WriteSource("b.hlsl", "B1");
+        WriteSource("q.hlsl", "Q1");
+    }
+
+    void RemoveSources()
+    {
+        for (const char* name : ScratchFiles)
+        {
+            remove((Directory + name).c_str());
+        }
+        remove((Directory + "inc").c_str());
+        remove(Directory.c_str());
+    }
+
+    ShaderCompileRequest MakeRequest(const char* name, const char* entryPoint)
+    {
+        ShaderCompileRequest request;
+        request.sourcePath = Directory + name;
+        request.entryPoint = entryPoint;
+        request.target = "vs_5_0";
+        request.flags = 0;
+        return request;
+    }
+
+    // Stands in for D3DCompileFromFile: the bytecode is the entry point and
+    // the source, and a source containing ERROR does not compile.
+    class FakeCompiler
+    {
+    public:
+        FakeCompiler() : m_compiles(0) {}
+
+        ShaderCompileCallback GetCallback()
+        {
+            return [this](const ShaderCompileRequest& request, const std::vector<uint8_t>& source, std::vector<uint8_t>& bytecode,
+                std::string& errors)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_compiles++;
+                const std::string text(source.begin(), source.end());
+                if (text.find("ERROR") != std::string::npos)
+                {
+                    errors = "syntax error";
+                    return false;
+                }
+                const std::string code = request.entryPoint + ":" + text.substr(text.find_last_of('\n') + 1);
+                bytecode.assign(code.begin(), code.end());
+                return true;
+            };
+        }
+
+        uint32_t GetCompiles()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_compiles;
+        }
+
+    private:
+        std::mutex m_mutex;
+        uint32_t m_compiles;
+    };
+
+    // The pipeline is the bytecode of its shaders joined with '|'. Counts the
+    // live ones, so the test sees when replaced pipelines are released.
+    class FakePipeline : public IReloadedPipeline
+    {
+    public:
+        explicit FakePipeline(const std::string& code) : m_code(code)    { s_alive++; }
+        ~FakePipeline()                                                 { s_alive--; }
+
+        std::string& GetCode()                  { return m_code; }
+        static int GetAliveCount()              { return s_alive; }
+
+    private:
+        std::string m_code;
+        static int s_alive;
+    };
+
+    int FakePipeline::s_alive = 0;
+
+    PipelineRebuildCallback MakeRebuild()
+    {
+        return [](uint32_t /*pipeline*/, const std::vector<ShaderBytecode>& shaders, std::string& errors) -> std::unique_ptr<IReloadedPipeline>
+        {
+            std::string code;
+            for (const ShaderBytecode& shader : shaders)
+            {
+                code += code.empty() ? "" : "|";
+                code.append(static_cast<const char*>(shader.data), shader.size);
+            }
+            if (code.find("BADPSO") != std::string::npos)
+            {
+                errors = "invalid pipeline";
+                return nullptr;
+            }
+            return std::unique_ptr<IReloadedPipeline>(new FakePipeline(code));
+        };
+    }
+
+    // Changes reported by hand instead of by the file system.
+    class FakeWatcher : public IFileWatcher
+    {
+    public:
+        virtual bool Watch(const std::string& directory)
+        {
+            m_directories.push_back(directory);
+            return true;
+        }
+
+        virtual void Poll(std::vector<std::string>& changed)
+        {
+            changed.insert(changed.end(), m_changed.begin(), m_changed.end());
+            m_changed.clear();
+        }
+
+        void Touch(const std::string& path)                         { m_changed.push_back(path); }
+        const std::vector<std::string>& GetDirectories() const      { return m_directories; }
+
+    private:
+        std::vector<std::string> m_directories;
+        std::vector<std::string> m_changed;
+    };
+
+    // Three pipelines over four shaders of the scratch sources:
+    //   0: a.hlsl VS + a.hlsl PS
+    //   1: q.hlsl VS + a.hlsl PS
+    //   2: b.hlsl CS
+    class HotReloadFixture
+    {
+    public:
+        HotReloadFixture() :
+            m_reload(m_watcher, m_compiler.GetCallback(), MakeRebuild()),
+            m_start(Clock::now())
+        {
+            CreateSources();
+            const uint32_t aVertex = m_reload.AddShader(MakeRequest("a.hlsl", "VS"), "VS:A1", 5);
+            const uint32_t aPixel = m_reload.AddShader(MakeRequest("a.hlsl", "PS"), "PS:A1", 5);
+            const uint32_t q = m_reload.AddShader(MakeRequest("q.hlsl", "VS"), "VS:Q1", 5);
+            const uint32_t b = m_reload.AddShader(MakeRequest("b.hlsl", "CS"), "CS:B1", 5);
+            m_reload.AddPipeline({ aVertex, aPixel });
+            m_reload.AddPipeline({ q, aPixel });
+            m_reload.AddPipeline({ b });
+            m_live[0] = "VS:A1|PS:A1";
+            m_live[1] = "VS:Q1|PS:A1";
+            m_live[2] = "CS:B1";
+        }
+
+        ~HotReloadFixture()
+        {
+            RemoveSources();
+        }
+
+        // Write a file and report it at time, in milliseconds from the start.
+        void Change(const std::string& name, const std::string& text, const std::string& reportedPath, uint32_t time)
+        {
+            WriteSource(name, text);
+            m_watcher.Touch(reportedPath);
+            m_reload.Update(At(time));
+        }
+
+        uint32_t UpdateSettled(uint32_t time)   { return m_reload.Update(At(time) + Settled); }
+
+        uint32_t Apply(uint64_t retireFenceValue, uint64_t completedFenceValue)
+        {
+            return m_reload.Apply(retireFenceValue, completedFenceValue, [this](uint32_t pipeline, IReloadedPipeline& rebuilt)
+            {
+                m_live[pipeline].swap(static_cast<FakePipeline&>(rebuilt).GetCode());
+            });
+        }
+
+        std::vector<std::string> TakeErrors()
+        {
+            std::vector<std::string> errors;
+            m_reload.TakeErrors(errors);
+            return errors;
+        }
+
+        Clock::time_point At(uint32_t milliseconds) const  { return m_start + std::chrono::milliseconds(milliseconds); }
+
+        FakeWatcher m_watcher;
+        FakeCompiler m_compiler;
+        ShaderHotReload m_reload;
+        std::string m_live[3];
+
+    private:
+        Clock::time_point m_start;
+    };
+}
+
+TEST(NormalizePathResolvesDotsAndSeparators)
+{
+    CHECK(ShaderHotReload::NormalizePath("shaders/inc/../b.hlsl") == "shaders/b.hlsl");
+    CHECK(ShaderHotReload::NormalizePath("shaders\\.\\\\b.hlsl") == "shaders/b.hlsl");
+    CHECK(ShaderHotReload::NormalizePath("a/../../b/./c") == "../b/c");
+    CHECK(ShaderHotReload::NormalizePath("/../x//y/") == "/x/y");
+    CHECK(ShaderHotReload::NormalizePath("\\\\server\\share\\f") == "//server/share/f");
+#ifdef _WIN32
+    CHECK(ShaderHotReload::NormalizePath("C:\\X\\..\\..\\Y") == "c:/y");
+#else
+    CHECK(ShaderHotReload::NormalizePath("C:\\X\\..\\..\\Y") == "C:/Y");
+#endif
+}
+
+TEST(DependenciesFollowIncludes)
+{
+    CreateSources();
+    WriteSource("q.hlsl", "#include \"missing.hlsli\"\nQ1");
+
+    std::vector<std::string> files;
+    FindShaderDependencies(Directory + "a.hlsl", files);
+    CHECK_EQUAL(3u, static_cast<uint32_t>(files.size()));
+    CHECK(files[0] == Directory + "a.hlsl");
+    CHECK(ShaderHotReload::NormalizePath(files[1]) == Directory + "inc/common.hlsli");
+    CHECK(ShaderHotReload::NormalizePath(files[2]) == Directory + "b.hlsl");
+
+    // An include that does not exist yet is listed, so creating it reloads the shader.
+    FindShaderDependencies(Directory + "q.hlsl", files);
+    CHECK_EQUAL(2u, static_cast<uint32_t>(files.size()));
+    CHECK(ShaderHotReload::NormalizePath(files[1]) == Directory + "missing.hlsli");
+    RemoveSources();
+}
+
+TEST(OnlyPipelinesOfChangedShadersAreRebuilt)
+{
+    HotReloadFixture fixture;
+    fixture.Change("q.hlsl", "Q2", Directory + "./q.hlsl", 0);
+
+    // Nothing happens until the file has been quiet for a while.
+    CHECK_EQUAL(0u, fixture.m_reload.Update(fixture.At(50)));
+    CHECK_EQUAL(0u, fixture.m_compiler.GetCompiles());
+    CHECK_EQUAL(1u, fixture.UpdateSettled(0));
+    CHECK_EQUAL(1u, fixture.m_compiler.GetCompiles());
+
+    // Rebuilt pipelines wait for Apply.
+    CHECK(fixture.m_live[1] == "VS:Q1|PS:A1");
+    CHECK_EQUAL(1u, fixture.Apply(10, 5));
+    CHECK(fixture.m_live[1] == "VS:Q2|PS:A1");
+    CHECK(fixture.m_live[0] == "VS:A1|PS:A1");
+    CHECK_EQUAL(0u, fixture.Apply(11, 5));
+
+    // A change to an include recompiles the shaders using it, reported under any path to it.
+    fixture.Change("b.hlsl", "B2", Directory + "inc/../b.hlsl", 1000);
+    CHECK_EQUAL(3u, fixture.UpdateSettled(1000));
+    CHECK_EQUAL(4u, fixture.m_compiler.GetCompiles());
+    CHECK_EQUAL(3u, fixture.Apply(12, 10));
+    CHECK(fixture.m_live[0] == "VS:A1|PS:A1");
+    CHECK(fixture.m_live[1] == "VS:Q2|PS:A1");
+    CHECK(fixture.m_live[2] == "CS:B2");
+
+    const ShaderHotReloadStats stats = fixture.m_reload.GetStats();
+    CHECK_EQUAL(2ull, static_cast<unsigned long long>(stats.fileChanges));
+    CHECK_EQUAL(4ull, static_cast<unsigned long long>(stats.shaderCompiles));
+    CHECK_EQUAL(4ull, static_cast<unsigned long long>(stats.pipelineBuilds));
+    CHECK_EQUAL(4ull, static_cast<unsigned long long>(stats.pipelineSwaps));
+    CHECK_EQUAL(0ull, static_cast<unsigned long long>(stats.compileErrors + stats.buildErrors));
+}
+
+TEST(FailedCompilesKeepTheLastGoodPipeline)
+{
+    HotReloadFixture fixture;
+    fixture.Change("q.hlsl", "ERROR", Directory + "q.hlsl", 0);
+    CHECK_EQUAL(0u, fixture.UpdateSettled(0));
+    CHECK_EQUAL(0u, fixture.Apply(10, 5));
+    CHECK(fixture.m_live[1] == "VS:Q1|PS:A1");
+
+    std::vector<std::string> errors = fixture.TakeErrors();
+    CHECK_EQUAL(1u, static_cast<uint32_t>(errors.size()));
+    CHECK(!errors.empty() && errors[0] == Directory + "q.hlsl (VS): syntax error");
+    CHECK(fixture.TakeErrors().empty());
+
+    // The pipeline builder failing leaves the live pipeline too.
+    fixture.Change("q.hlsl", "BADPSO", Directory + "q.hlsl", 1000);
+    CHECK_EQUAL(0u, fixture.UpdateSettled(1000));
+    errors = fixture.TakeErrors();
+    CHECK(errors.size() == 1 && errors[0] == "pipeline 1: invalid pipeline");
+
+    // Fixing the file reloads it, with the bytecode of the other shaders unchanged.
+    fixture.Change("q.hlsl", "Q3", Directory + "q.hlsl", 2000);
+    CHECK_EQUAL(1u, fixture.UpdateSettled(2000));
+    CHECK_EQUAL(1u, fixture.Apply(11, 10));
+    CHECK(fixture.m_live[1] == "VS:Q3|PS:A1");
+
+    const ShaderHotReloadStats stats = fixture.m_reload.GetStats();
+    CHECK_EQUAL(1ull, static_cast<unsigned long long>(stats.compileErrors));
+    CHECK_EQUAL(1ull, static_cast<unsigned long long>(stats.buildErrors));
+    CHECK_EQUAL(1ull, static_cast<unsigned long long>(stats.pipelineSwaps));
+}
+
+TEST(ReplacedPipelinesWaitForTheGpu)
+{
+    HotReloadFixture fixture;
+    const int aliveBefore = FakePipeline::GetAliveCount();
+
+    // Rebuilt twice before the frame boundary: the first build is dropped
+    // without ever being swapped in.
+    fixture.Change("q.hlsl", "Q2", Directory + "q.hlsl", 0);
+    CHECK_EQUAL(1u, fixture.UpdateSettled(0));
+    fixture.Change("q.hlsl", "Q3", Directory + "q.hlsl", 1000);
+    CHECK_EQUAL(1u, fixture.UpdateSettled(1000));
+    CHECK_EQUAL(aliveBefore + 1, FakePipeline::GetAliveCount());
+    CHECK_EQUAL(1u, fixture.Apply(10, 5));
+    CHECK(fixture.m_live[1] == "VS:Q3|PS:A1");
+
+    // The replaced pipeline is held until the fence of the frame it was
+    // swapped out at has completed.
+    CHECK_EQUAL(aliveBefore + 1, FakePipeline::GetAliveCount());
+    fixture.Apply(11, 9);
+    CHECK_EQUAL(aliveBefore + 1, FakePipeline::GetAliveCount());
+    fixture.Apply(12, 10);
+    CHECK_EQUAL(aliveBefore, FakePipeline::GetAliveCount());
+}
+
+TEST(MisuseThrows)
+{
+    HotReloadFixture fixture;
+    CHECK_THROWS(fixture.m_reload.AddPipeline({ 0, 4 }), std::invalid_argument);
+    fixture.m_reload.Start(10);
+    CHECK_THROWS(fixture.m_reload.Start(10), std::logic_error);
+    fixture.m_reload.Stop();
+    fixture.m_reload.Stop();
+
+    // Start watches the directory of every file, the include's too.
+    const std::vector<std::string>& directories = fixture.m_watcher.GetDirectories();
+    CHECK(std::find(directories.begin(), directories.end(), Directory + "inc/") != directories.end());
+    CHECK(std::find(directories.begin(), directories.end(), Directory) != directories.end());
+}
+
+// FileWatcher and the reload thread together: a file written in place and
+// one replaced by a rename are both picked up and swapped in.
+TEST(ReloadThreadPicksUpWrittenFiles)
+{
+    CreateSources();
+    FakeCompiler compiler;
+    FileWatcher watcher;
+    ShaderHotReload reload(watcher, compiler.GetCallback(), MakeRebuild());
+    const uint32_t shader = reload.AddShader(MakeRequest("a.hlsl", "VS"), "VS:A1", 5);
+    reload.AddPipeline({ shader });
+    reload.Start(10);
+
+    std::string live = "VS:A1";
+    const auto waitForSwap = [&](uint64_t fenceValue)
+    {
+        const Clock::time_point start = Clock::now();
+        while (Clock::now() - start < std::chrono::seconds(5))
+        {
+            if (reload.Apply(fenceValue, fenceValue - 1, [&live](uint32_t, IReloadedPipeline& rebuilt)
+                { live.swap(static_cast<FakePipeline&>(rebuilt).GetCode()); }))
+            {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return false;
+    };
+
+    // WriteFileAtomic renames over the include.
+    WriteSource("inc/common.hlsli", "C2");
+    CHECK(waitForSwap(1));
+    CHECK(live == "VS:A1");
+
+    FILE* file = fopen((Directory + "a.hlsl").c_str(), "wb");
+    CHECK(file != nullptr);
+    if (file)
+    {
+        fputs("A2", file);
+        fclose(file);
+    }
+    CHECK(waitForSwap(2));
+    CHECK(live == "VS:A2");
+
+    reload.Stop();
+    CHECK_EQUAL(2u, compiler.GetCompiles());
+    CHECK(reload.GetStats().lastReloadMs >= 0.0);
+    RemoveSources();
+}
@@ -0,0 +1,123 @@
+#include "SampleFrame.h"
+#include "MappedFile.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const uint32_t Width = 1280;
+    const uint32_t Height = 720;
+
+    struct Scenario
+    {
+        const char* name;
+        uint32_t instanceCount;
+        bool textured;
+        bool quad;                  // The quad pass instead of the triangles.
+    };
+}
+
+// Pixels shaded per second by the passes of a 1280x720 sample frame built by
+// BuildSampleFrame: the single triangle, 10000 scattered instances flat and
+// textured, and the quad pass over the whole target, for 1 thread up to the
+// hardware threads.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const Scenario scenarios[] =
+    {
+        { "triangle",           1,     false, false },
+        { "instances",          10000, false, false },
+        { "textured instances", 10000, true,  false },
+        { "quad",               1,     false, true },
+    };
+
+    AssetFile file;
+    DdsTexture dds;
+    SoftwareTexture texture;
+    if (!file.Open(std::string(TEST_DATA_DIR) + "/dds/rgba8_mips.dds") || dds.Parse(file.GetData(), file.GetSize()) != DdsResultOk ||
+        !texture.Load(dds, 0))
+    {
+        printf("cannot load the texture\n");
+        return 1;
+    }
+
+    std::vector<uint32_t> threadCounts(1, 1);
+    for (uint32_t threads = 2; threads <= std::max<uint32_t>(std::thread::hardware_concurrency(), 1); threads *= 2)
+    {
+        threadCounts.push_back(threads);
+    }
+
+    printf("%-20s %8s %12s %14s %10s\n", "pass", "threads", "pixels", "Mpixels/s", "ms/frame");
+    for (const Scenario& scenario : scenarios)
+    {
+        SoftwareVertex vertices[SampleTriangleVertexCount];
+        GetSampleTriangleVertices(static_cast<float>(Width) / Height, vertices);
+
+        InstanceSet instances;
+        if (scenario.instanceCount > 1)
+        {
+            const CullRect area = { -1.5f, -1.5f, 1.5f, 1.5f };
+            instances.Scatter(scenario.instanceCount, area, 0.05f, 0.15f, 1);
+        }
+        else
+        {
+            const InstanceData instance = { { 0.0f, 0.0f }, 1.0f, 0.0f, { 1.0f, 1.0f, 1.0f, 1.0f } };
+            instances.Resize(1);
+            instances.Set(0, instance);
+        }
+        std::vector<InstanceData> visible(instances.GetCount());
+        const CullRect screen = { -1.0f, -1.0f, 1.0f, 1.0f };
+        IndirectDrawArguments arguments;
+        const uint32_t visibleCount = CullInstances(instances, screen, GetBoundingRadius(vertices, SampleTriangleVertexCount),
+            visible.data(), instances.GetCount(), SampleTriangleVertexCount, arguments);
+
+        SampleFrameParams params = {};
+        params.width = Width;
+        params.height = Height;
+        params.sceneWidth = Width;
+        params.sceneHeight = Height;
+        params.color[0] = params.color[1] = params.color[2] = 1.0f;
+        params.textured = scenario.textured;
+        SoftwareFrameDesc desc;
+        BuildSampleFrame(params, vertices, visible.data(), visibleCount, &texture, nullptr, desc);
+
+        SoftwareImage scene(Width, Height);
+        SoftwareImage output(Width, Height);
+        scene.Clear(desc.sceneClearColor);
+
+        for (uint32_t threads : threadCounts)
+        {
+            JobSystem jobs(threads);
+            SoftwareRasterizer rasterizer(threads > 1 ? &jobs : nullptr);
+
+            // About a second per measurement.
+            const uint32_t frames = quick ? 1 : (scenario.textured ? 20 : 200);
+            BenchmarkTimer timer;
+            for (uint32_t frame = 0; frame < frames; ++frame)
+            {
+                if (scenario.quad)
+                {
+                    rasterizer.DrawQuad(output, desc.viewport, desc.scissor, desc.quadVertices, desc.quadVertexCount, desc.constants, scene);
+                }
+                else
+                {
+                    rasterizer.DrawTriangles(scene, desc.sceneViewport, desc.sceneScissor, desc.triangleVertices, desc.triangleVertexCount,
+                        desc.instances, desc.instanceCount, desc.constants, desc.texture);
+                }
+            }
+            const double milliseconds = timer.GetMilliseconds();
+            KeepResult(output.GetPixel(0, 0) + scene.GetPixel(Width / 2, Height / 2));
+
+            const uint64_t pixels = rasterizer.GetStats().pixels;
+            printf("%-20s %8u %12llu %14.1f %10.3f\n", scenario.name, threads, static_cast<unsigned long long>(pixels / frames),
+                pixels / milliseconds / 1000.0, milliseconds / frames);
+        }
+    }
+    return 0;
+}
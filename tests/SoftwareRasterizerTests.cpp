@@ -0,0 +1,239 @@
+#include "SampleFrame.h"
+#include "MappedFile.h"
+#include "TestHarness.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const uint32_t Width = 192;
+    const uint32_t Height = 108;
+
+    // Channels may differ by one, the trilinear filter and the blur round
+    // differently with and without SSE2.
+    const uint32_t Tolerance = 1;
+
+    // A frame of the sample as SoftwareRasterizer renders it: the instances
+    // are culled like WriteFrameConstants does and the rest of the frame
+    // comes from BuildSampleFrame.
+    class SampleScene
+    {
+    public:
+        SampleScene(uint32_t instanceCount, uint32_t sceneWidth, uint32_t sceneHeight) :
+            m_visibleCount(0)
+        {
+            GetSampleTriangleVertices(static_cast<float>(Width) / Height, m_vertices);
+            if (instanceCount > 1)
+            {
+                const CullRect area = { -1.5f, -1.5f, 1.5f, 1.5f };
+                m_instances.Scatter(instanceCount, area, 0.05f, 0.15f, 1);
+            }
+            else
+            {
+                const InstanceData instance = { { 0.0f, 0.0f }, 1.0f, 0.0f, { 1.0f, 1.0f, 1.0f, 1.0f } };
+                m_instances.Resize(1);
+                m_instances.Set(0, instance);
+            }
+
+            const CullRect screen = { -1.0f, -1.0f, 1.0f, 1.0f };
+            IndirectDrawArguments arguments;
+            m_visible.resize(m_instances.GetCount());
+            m_visibleCount = CullInstances(m_instances, screen, GetBoundingRadius(m_vertices, SampleTriangleVertexCount),
+                m_visible.data(), m_instances.GetCount(), SampleTriangleVertexCount, arguments);
+
+            m_params = SampleFrameParams();
+            m_params.width = Width;
+            m_params.height = Height;
+            m_params.sceneWidth = sceneWidth;
+            m_params.sceneHeight = sceneHeight;
+            m_params.color[0] = 1.0f;
+            m_params.color[1] = 0.75f;
+            m_params.color[2] = 0.5f;
+        }
+
+        SampleFrameParams& GetParams()                  { return m_params; }
+        uint32_t GetVisibleCount() const                { return m_visibleCount; }
+
+        // Every instance, culled or not: the same image when the culling is right.
+        void DrawAllInstances()
+        {
+            for (uint32_t i = 0; i < m_instances.GetCount(); ++i)
+            {
+                m_visible[i] = m_instances.Get(i);
+            }
+            m_visibleCount = m_instances.GetCount();
+        }
+
+        void Render(SoftwareRasterizer& rasterizer, const SoftwareTexture* texture, BlurFilter* blur, SoftwareImage& output)
+        {
+            SoftwareFrameDesc desc;
+            BuildSampleFrame(m_params, m_vertices, m_visible.data(), m_visibleCount, texture, blur, desc);
+
+            SoftwareImage scene(Width, Height);
+            SoftwareImage display;
+            output.Resize(Width, Height);
+            rasterizer.RenderFrame(desc, scene, display, output);
+        }
+
+    private:
+        SoftwareVertex m_vertices[SampleTriangleVertexCount];
+        InstanceSet m_instances;
+        std::vector<InstanceData> m_visible;
+        uint32_t m_visibleCount;
+        SampleFrameParams m_params;
+    };
+
+    // Compares against tests/data/golden/<name>.ppm. A mismatch leaves the
+    // frame next to the test as <name>.actual.ppm; with
+    // SOFTWARE_RASTERIZER_UPDATE_GOLDEN set the golden image is rewritten.
+    bool MatchesGolden(const SoftwareImage& image, const char* name)
+    {
+        const std::string goldenPath = std::string(TEST_DATA_DIR) + "/golden/" + name + ".ppm";
+        if (getenv("SOFTWARE_RASTERIZER_UPDATE_GOLDEN"))
+        {
+            return image.SavePpm(goldenPath);
+        }
+
+        SoftwareImage golden;
+        if (!golden.LoadPpm(goldenPath))
+        {
+            printf("  missing golden image %s\n", goldenPath.c_str());
+            return false;
+        }
+
+        // Saved images lose their alpha, the frame is compared the same way.
+        SoftwareImage opaque(image.GetWidth(), image.GetHeight());
+        for (uint32_t y = 0; y < image.GetHeight(); ++y)
+        {
+            for (uint32_t x = 0; x < image.GetWidth(); ++x)
+            {
+                opaque.GetRow(y)[x] = image.GetPixel(x, y) | 0xff000000u;
+            }
+        }
+
+        const SoftwareImageDifference difference = CompareImages(golden, opaque, Tolerance);
+        if (difference.differentPixels != 0)
+        {
+            printf("  %s: %llu pixels differ, by up to %u\n", name, static_cast<unsigned long long>(difference.differentPixels), difference.maxDelta);
+            image.SavePpm(std::string(name) + ".actual.ppm");
+            return false;
+        }
+        return true;
+    }
+
+    bool SameImages(const SoftwareImage& a, const SoftwareImage& b)
+    {
+        const SoftwareImageDifference difference = CompareImages(a, b, 0);
+        return difference.maxDelta == 0 && difference.differentPixels == 0;
+    }
+}
+
+TEST(TriangleMatchesGolden)
+{
+    SampleScene scene(1, Width, Height);
+    SoftwareRasterizer rasterizer(nullptr);
+    SoftwareImage output;
+    scene.Render(rasterizer, nullptr, nullptr, output);
+    CHECK(MatchesGolden(output, "triangle"));
+
+    // The scene clear color is where the triangle is not, and the quad is two triangles.
+    CHECK_EQUAL(0xffff1a1au, output.GetPixel(0, 0));
+    CHECK_EQUAL(3ull, static_cast<unsigned long long>(rasterizer.GetStats().triangles));
+}
+
+TEST(InstancesMatchGolden)
+{
+    SampleScene scene(400, Width * 3 / 4, Height * 3 / 4);
+    SoftwareRasterizer rasterizer(nullptr);
+    SoftwareImage output;
+    scene.Render(rasterizer, nullptr, nullptr, output);
+    CHECK(MatchesGolden(output, "instances"));
+    CHECK(scene.GetVisibleCount() < 400);
+
+    // The culled instances are the ones that draw nothing.
+    SoftwareImage unculled;
+    scene.DrawAllInstances();
+    scene.Render(rasterizer, nullptr, nullptr, unculled);
+    CHECK(SameImages(output, unculled));
+}
+
+TEST(TexturedTriangleMatchesGolden)
+{
+    AssetFile file;
+    CHECK(file.Open(std::string(TEST_DATA_DIR) + "/dds/rgba8_mips.dds"));
+    DdsTexture dds;
+    CHECK_EQUAL(DdsResultOk, dds.Parse(file.GetData(), file.GetSize()));
+    SoftwareTexture texture;
+    CHECK(texture.Load(dds, 0));
+
+    SampleScene scene(1, Width, Height);
+    scene.GetParams().textured = true;
+    SoftwareRasterizer rasterizer(nullptr);
+    SoftwareImage output;
+    scene.Render(rasterizer, &texture, nullptr, output);
+    CHECK(MatchesGolden(output, "textured"));
+
+    // Without resident mips the texture is not bound.
+    SoftwareImage untextured;
+    SoftwareImage flat;
+    scene.GetParams().textured = false;
+    scene.Render(rasterizer, &texture, nullptr, untextured);
+    scene.Render(rasterizer, nullptr, nullptr, flat);
+    CHECK(SameImages(untextured, flat));
+    CHECK(!SameImages(untextured, output));
+}
+
+TEST(BlurredSceneMatchesGolden)
+{
+    SampleScene scene(1, Width / 2, Height / 2);
+    BlurFilter blur(BlurKernel::Gaussian(3));
+    SoftwareRasterizer rasterizer(nullptr);
+    SoftwareImage output;
+    scene.Render(rasterizer, nullptr, &blur, output);
+    CHECK(MatchesGolden(output, "blurred"));
+}
+
+// Tiles are owned by one job each and draw their triangles in order, the
+// frame is the same for any thread count and tile size.
+TEST(ThreadsAndTilesGiveTheSameFrame)
+{
+    SampleScene scene(2000, Width, Height);
+    SoftwareRasterizer serial(nullptr);
+    SoftwareImage expected;
+    scene.Render(serial, nullptr, nullptr, expected);
+
+    JobSystem jobs(4);
+    const uint32_t tileSizes[] = { 8, 16, 64, 256 };
+    for (uint32_t tileSize : tileSizes)
+    {
+        SoftwareRasterizer rasterizer(&jobs, tileSize);
+        SoftwareImage output;
+        scene.Render(rasterizer, nullptr, nullptr, output);
+        CHECK(SameImages(expected, output));
+    }
+}
+
+TEST(ShaderDataMatchesTheScene)
+{
+    SampleFrameParams params = {};
+    params.width = 1280;
+    params.height = 720;
+    params.sceneWidth = 960;
+    params.sceneHeight = 536;
+    params.color[0] = 0.25f;
+    const SoftwareShaderData data = GetSampleShaderData(params);
+    CHECK_NEAR(0.25f, data.solidColor[0], 1e-6f);
+    CHECK_NEAR(1.0f, data.solidColor[3], 1e-6f);
+    CHECK_NEAR(0.75f, data.sceneUv[0], 1e-6f);
+    CHECK_NEAR(536.0f / 720.0f, data.sceneUv[1], 1e-6f);
+    CHECK_NEAR(959.5f / 1280.0f, data.sceneUv[2], 1e-6f);
+    CHECK_NEAR(0.0f, data.textureWeight[0], 1e-6f);
+
+    SoftwareVertex vertices[SampleTriangleVertexCount];
+    GetSampleTriangleVertices(2.0f, vertices);
+    CHECK_NEAR(0.5f, vertices[0].position[1], 1e-6f);
+    CHECK_NEAR(0.5590170f, GetBoundingRadius(vertices, SampleTriangleVertexCount), 1e-6f);
+}
@@ -0,0 +1,138 @@
+#include "TaskGraph.h"
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // A pass of the sample and what building it costs: the shader compiles
+    // of fxc -O3 and the driver compile of its pipeline state, in ms.
+    struct PassCost
+    {
+        const char* name;
+        double vertexShaderMs;      // 0 for a compute pass.
+        double shaderMs;            // Pixel or compute shader.
+        double pipelineMs;
+    };
+
+    const PassCost SamplePasses[] =
+    {
+        { "Triangle", 30.0, 55.0, 25.0 },
+        { "Quad",     20.0, 35.0, 25.0 },
+        { "Blur",     0.0,  60.0, 10.0 },
+    };
+
+    // Compiles simulated by sleeps: they take the time of a compile and leave
+    // the core to the others, like the compiler waiting on its own threads
+    // and the driver would not.
+    TaskGraph::Task Compile(double milliseconds)
+    {
+        return [milliseconds]
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(static_cast<int64_t>(milliseconds * 1000.0)));
+        };
+    }
+
+    // The startup graph of LoadAssets with passCount passes, the sample's
+    // three repeated; the costs vary by up to 20% from pass to pass.
+    void BuildStartupGraph(TaskGraph& graph, uint32_t passCount, double scale)
+    {
+        uint32_t state = 7;
+        const auto jitter = [&state]()
+        {
+            state = state * 1664525u + 1013904223u;
+            return 0.8 + 0.4 * ((state >> 8) % 1000) / 1000.0;
+        };
+
+        for (uint32_t pass = 0; pass < passCount; ++pass)
+        {
+            const PassCost& cost = SamplePasses[pass % 3];
+            const std::string name = std::string(cost.name) + (pass >= 3 ? std::to_string(pass) : "");
+            std::vector<uint32_t> shaders;
+            if (cost.vertexShaderMs > 0.0)
+            {
+                shaders.push_back(graph.AddTask(name + " VS", Compile(cost.vertexShaderMs * jitter() * scale)));
+                shaders.push_back(graph.AddTask(name + " PS", Compile(cost.shaderMs * jitter() * scale)));
+            }
+            else
+            {
+                shaders.push_back(graph.AddTask(name + " CS", Compile(cost.shaderMs * jitter() * scale)));
+            }
+            graph.AddTask(name + " PSO", Compile(cost.pipelineMs * jitter() * scale), shaders);
+        }
+    }
+
+    // taskCount empty tasks, each depending on up to three of the 64 added
+    // before it: what scheduling a task costs, without the task.
+    void BuildEmptyGraph(TaskGraph& graph, uint32_t taskCount, std::atomic<uint32_t>& runs)
+    {
+        uint32_t state = 1;
+        for (uint32_t task = 0; task < taskCount; ++task)
+        {
+            std::vector<uint32_t> dependencies;
+            state = state * 1664525u + 1013904223u;
+            const uint32_t dependencyCount = task ? (state >> 8) % 4 : 0;
+            for (uint32_t i = 0; i < dependencyCount; ++i)
+            {
+                state = state * 1664525u + 1013904223u;
+                dependencies.push_back(task - 1 - (state >> 8) % std::min<uint32_t>(task, 64));
+            }
+            graph.AddTask("task", [&runs] { runs++; }, dependencies);
+        }
+    }
+}
+
+// TaskGraph on the startup graph of the sample, 3 passes and 8 tasks, and on
+// one with 8 passes, compiles simulated by sleeps: wall time against the sum
+// of the task times and the critical path, for 1 to 8 threads. Then the
+// scheduling cost per task on a graph of 10000 empty tasks.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const double scale = quick ? 0.02 : 1.0;
+    const uint32_t threadCounts[] = { 1, 2, 4, 8 };
+
+    printf("%-8s %8s %6s %10s %10s %10s %9s\n", "passes", "threads", "tasks", "wall ms", "serial ms", "path ms", "speedup");
+    const uint32_t passCounts[] = { 3, 8 };
+    for (uint32_t passCount : passCounts)
+    {
+        for (uint32_t threads : threadCounts)
+        {
+            TaskGraph graph;
+            BuildStartupGraph(graph, passCount, scale);
+            JobSystem jobs(threads);
+            graph.Run(jobs);
+
+            const TaskGraphStats& stats = graph.GetStats();
+            printf("%-8u %8u %6u %10.1f %10.1f %10.1f %8.2fx\n", passCount, threads, stats.taskCount, stats.wallMs, stats.totalTaskMs,
+                stats.criticalPathMs, stats.totalTaskMs / stats.wallMs);
+        }
+    }
+
+    const uint32_t taskCount = quick ? 1000 : 10000;
+    const uint32_t repeats = quick ? 1 : 20;
+    printf("\n%-8s %8s %12s\n", "tasks", "threads", "us/task");
+    for (uint32_t threads : threadCounts)
+    {
+        std::atomic<uint32_t> runs(0);
+        TaskGraph graph;
+        BuildEmptyGraph(graph, taskCount, runs);
+        JobSystem jobs(threads);
+
+        BenchmarkTimer timer;
+        for (uint32_t repeat = 0; repeat < repeats; ++repeat)
+        {
+            graph.Run(jobs);
+        }
+        const double milliseconds = timer.GetMilliseconds();
+        KeepResult(runs.load());
+        printf("%-8u %8u %12.3f\n", taskCount, threads, milliseconds * 1000.0 / (static_cast<double>(taskCount) * repeats));
+    }
+    return 0;
+}
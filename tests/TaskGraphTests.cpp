@@ -0,0 +1,198 @@
+#include "TaskGraph.h"
+#include "TestHarness.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void Sleep(uint32_t milliseconds)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    }
+
+    // Order in which the tasks of a run started.
+    class StartOrder
+    {
+    public:
+        TaskGraph::Task Record(const std::string& name, uint32_t milliseconds = 0)
+        {
+            return [this, name, milliseconds]
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_order += m_order.empty() ? name : " " + name;
+                }
+                Sleep(milliseconds);
+            };
+        }
+
+        std::string Get()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_order;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::string m_order;
+    };
+}
+
+// A random graph on 4 threads: every task finds the tasks it depends on done.
+TEST(TasksRunAfterTheirDependencies)
+{
+    const uint32_t taskCount = 500;
+    std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[taskCount]);
+    std::atomic<uint32_t> early(0);
+    std::atomic<uint32_t> runs(0);
+
+    TaskGraph graph;
+    uint32_t state = 1;
+    for (uint32_t task = 0; task < taskCount; ++task)
+    {
+        done[task] = false;
+        std::vector<uint32_t> dependencies;
+        state = state * 1664525u + 1013904223u;
+        const uint32_t dependencyCount = task ? (state >> 8) % 4 : 0;
+        for (uint32_t i = 0; i < dependencyCount; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            dependencies.push_back((state >> 8) % task);
+        }
+
+        graph.AddTask("t" + std::to_string(task), [&done, &early, &runs, task, dependencies]
+        {
+            for (uint32_t dependency : dependencies)
+            {
+                if (!done[dependency])
+                {
+                    early++;
+                }
+            }
+            runs++;
+            done[task] = true;
+        }, dependencies);
+    }
+
+    JobSystem jobs(4);
+    graph.Run(jobs);
+    CHECK_EQUAL(taskCount, runs.load());
+    CHECK_EQUAL(0u, early.load());
+    CHECK_EQUAL(taskCount, graph.GetStats().taskCount);
+    CHECK_EQUAL(4u, graph.GetStats().threadCount);
+
+    // The critical path is a chain of dependencies.
+    const std::vector<uint32_t>& path = graph.GetCriticalPath();
+    CHECK(!path.empty());
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        CHECK(path[i - 1] < path[i]);
+    }
+
+    // A graph runs again from scratch.
+    for (uint32_t task = 0; task < taskCount; ++task)
+    {
+        done[task] = false;
+    }
+    graph.Run(jobs);
+    CHECK_EQUAL(2 * taskCount, runs.load());
+    CHECK_EQUAL(0u, early.load());
+}
+
+// On one thread the ready task heading the longest chain goes first, ties go
+// to the task that became ready first.
+TEST(LongestChainStartsFirst)
+{
+    StartOrder order;
+    TaskGraph graph;
+    graph.AddTask("lone", order.Record("lone"));
+    const uint32_t shortHead = graph.AddTask("short", order.Record("short"));
+    graph.AddTask("shortEnd", order.Record("shortEnd"), { shortHead });
+    const uint32_t longHead = graph.AddTask("long", order.Record("long"));
+    const uint32_t longMiddle = graph.AddTask("longMiddle", order.Record("longMiddle"), { longHead });
+    graph.AddTask("longEnd", order.Record("longEnd"), { longMiddle, shortHead });
+
+    JobSystem jobs(1);
+    graph.Run(jobs);
+    CHECK(order.Get() == "long short longMiddle lone shortEnd longEnd");
+}
+
+// The run takes the longest chain of measured task times, whatever the
+// number of threads, and that chain is reported.
+TEST(CriticalPathBoundsTheRun)
+{
+    StartOrder order;
+    TaskGraph graph;
+    const uint32_t shader = graph.AddTask("Triangle PS", order.Record("Triangle PS", 40));
+    graph.AddTask("Triangle PSO", order.Record("Triangle PSO", 20), { shader });
+    const uint32_t quad = graph.AddTask("Quad VS", order.Record("Quad VS", 10));
+    graph.AddTask("Quad PSO", order.Record("Quad PSO", 10), { quad });
+    graph.AddTask("Blur CS", order.Record("Blur CS", 30));
+
+    JobSystem jobs(3);
+    graph.Run(jobs);
+    const TaskGraphStats& stats = graph.GetStats();
+    CHECK_EQUAL(2u, static_cast<uint32_t>(graph.GetCriticalPath().size()));
+    CHECK(graph.GetTaskName(graph.GetCriticalPath().front()) == "Triangle PS");
+    CHECK(graph.GetTaskName(graph.GetCriticalPath().back()) == "Triangle PSO");
+    CHECK(graph.FormatCriticalPath().find("Triangle PS ") == 0);
+    CHECK(graph.FormatCriticalPath().find(" ms > Triangle PSO ") != std::string::npos);
+
+    CHECK(stats.criticalPathMs >= 60.0);
+    CHECK(stats.totalTaskMs >= 110.0);
+    CHECK(stats.wallMs >= stats.criticalPathMs - 0.1);
+    CHECK(stats.wallMs < stats.totalTaskMs);
+    CHECK(graph.GetTaskMs(0) >= 40.0);
+}
+
+// The first exception is rethrown by Run, and the tasks depending on the
+// failed one never start.
+TEST(FailedTasksStopTheirDependents)
+{
+    std::atomic<uint32_t> runs(0);
+    TaskGraph graph;
+    const uint32_t failing = graph.AddTask("failing", [] { throw std::runtime_error("compile failed"); });
+    graph.AddTask("dependent", [&runs] { runs++; }, { failing });
+    graph.AddTask("independent", [&runs] { runs++; });
+
+    // The failing task heads the longest chain, it runs first and nothing after it.
+    JobSystem jobs(1);
+    CHECK_THROWS(graph.Run(jobs), std::runtime_error);
+    CHECK_EQUAL(0u, runs.load());
+}
+
+// Dependencies on tasks not added yet are rejected, and leave the graph as it
+// was: the first task does not gain a dependent and run ahead of the chain.
+TEST(ForwardDependenciesAreRejected)
+{
+    StartOrder order;
+    TaskGraph graph;
+    graph.AddTask("first", order.Record("first"));
+    CHECK_THROWS(graph.AddTask("self", [] {}, { 1 }), std::invalid_argument);
+    CHECK_THROWS(graph.AddTask("partly", [] {}, { 0, 2 }), std::invalid_argument);
+    graph.AddTask("lone", order.Record("lone"));
+    const uint32_t chainHead = graph.AddTask("chainHead", order.Record("chainHead"));
+    graph.AddTask("chainEnd", order.Record("chainEnd"), { chainHead });
+
+    JobSystem jobs(1);
+    graph.Run(jobs);
+    CHECK(order.Get() == "chainHead first lone chainEnd");
+    CHECK_EQUAL(4u, graph.GetStats().taskCount);
+}
+
+TEST(EmptyGraphRuns)
+{
+    TaskGraph graph;
+    JobSystem jobs(2);
+    graph.Run(jobs);
+    CHECK_EQUAL(0u, graph.GetStats().taskCount);
+    CHECK(graph.GetCriticalPath().empty());
+    CHECK(graph.FormatCriticalPath().empty());
+}
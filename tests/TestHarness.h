@@ -0,0 +1,75 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+
+// Minimal test registry for the Linux build of the portable sources. Every
+// tests/*Tests.cpp is an executable of its own, linked with TestMain.cpp; its
+// TESTs run in the order they are defined. A failed CHECK is reported and
+// counted, the test goes on.
+typedef void (*TestFunction)();
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* name, TestFunction function);
+};
+
+void ReportTestFailure(const char* file, int line, const std::string& message);
+
+#define TEST(name) \
+    static void name(); \
+    static TestRegistrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            ReportTestFailure(__FILE__, __LINE__, #condition); \
+        } \
+    } while (false)
+
+#define CHECK_EQUAL(expected, actual) \
+    do \
+    { \
+        const auto& expectedValue = (expected); \
+        const auto& actualValue = (actual); \
+        if (!(expectedValue == actualValue)) \
+        { \
+            std::ostringstream message; \
+            message << #actual << " is " << +actualValue << ", expected " << +expectedValue; \
+            ReportTestFailure(__FILE__, __LINE__, message.str()); \
+        } \
+    } while (false)
+
+#define CHECK_NEAR(expected, actual, tolerance) \
+    do \
+    { \
+        const double expectedValue = (expected); \
+        const double actualValue = (actual); \
+        if (!(actualValue >= expectedValue - (tolerance) && actualValue <= expectedValue + (tolerance))) \
+        { \
+            std::ostringstream message; \
+            message << #actual << " is " << actualValue << ", expected " << expectedValue << " +/- " << (tolerance); \
+            ReportTestFailure(__FILE__, __LINE__, message.str()); \
+        } \
+    } while (false)
+
+#define CHECK_THROWS(expression, exception) \
+    do \
+    { \
+        bool thrown = false; \
+        try \
+        { \
+            expression; \
+        } \
+        catch (const exception&) \
+        { \
+            thrown = true; \
+        } \
+        if (!thrown) \
+        { \
+            ReportTestFailure(__FILE__, __LINE__, #expression " does not throw " #exception); \
+        } \
+    } while (false)
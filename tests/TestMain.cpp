@@ -0,0 +1,69 @@
+#include "TestHarness.h"
+
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+namespace
+{
+    struct TestCase
+    {
+        const char* name;
+        TestFunction function;
+    };
+
+    std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    unsigned g_failures = 0;
+}
+
+TestRegistrar::TestRegistrar(const char* name, TestFunction function)
+{
+    const TestCase testCase = { name, function };
+    GetTestCases().push_back(testCase);
+}
+
+void ReportTestFailure(const char* file, int line, const std::string& message)
+{
+    fprintf(stderr, "%s(%d): check failed: %s\n", file, line, message.c_str());
+    g_failures++;
+}
+
+// Runs every test, or those whose name contains the first argument.
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    unsigned failedTests = 0;
+    unsigned run = 0;
+    for (const TestCase& testCase : GetTestCases())
+    {
+        if (filter && !strstr(testCase.name, filter))
+        {
+            continue;
+        }
+
+        const unsigned failuresBefore = g_failures;
+        try
+        {
+            testCase.function();
+        }
+        catch (const std::exception& e)
+        {
+            ReportTestFailure(testCase.name, 0, std::string("unexpected exception: ") + e.what());
+        }
+
+        run++;
+        const bool passed = g_failures == failuresBefore;
+        failedTests += passed ? 0 : 1;
+        printf("%s %s\n", passed ? "[ OK ]" : "[FAIL]", testCase.name);
+    }
+
+    printf("%u tests, %u failed\n", run, failedTests);
+    return failedTests ? 1 : 0;
+}
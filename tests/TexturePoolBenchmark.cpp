@@ -0,0 +1,78 @@
+#include "TexturePool.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed) {}
+
+        uint32_t Next(uint32_t range)
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return (m_state >> 8) % range;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+}
+
+// Frames of a dynamic resolution renderer on the null backend: 3 to 8 render
+// targets a frame, most at a scale that changes every scalePeriod frames, the
+// rest odd sizes, released two frames before the GPU is done with them.
+// Prints the reuse rate, heap memory and fragmentation the pool ends up with
+// and the cost of an acquire.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t sizes[][2] = { { 1920, 1080 }, { 1280, 720 }, { 960, 540 }, { 640, 360 }, { 3840, 2160 }, { 256, 256 }, { 512, 512 } };
+    const uint32_t formats[] = { 28, 10, 2 };
+    const uint64_t frames = quick ? 200 : 20000;
+
+    printf("%-8s %8s %9s %9s %6s %10s %10s %9s %9s\n",
+        "period", "hits %", "creates", "evicts", "heaps", "peak MB", "live MB", "frag avg", "ns/acq");
+
+    for (uint32_t scalePeriod = 10; scalePeriod <= 1000; scalePeriod *= 10)
+    {
+        NullTexturePoolBackend backend;
+        TexturePool pool(backend);
+        Random random(7);
+
+        std::vector<uint32_t> textures;
+        double fragmentation = 0.0;
+        BenchmarkTimer timer;
+        for (uint64_t frame = 1; frame <= frames; ++frame)
+        {
+            const uint32_t scale = (frame / scalePeriod) % 4;
+            const uint32_t count = 3 + random.Next(6);
+            textures.clear();
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                const uint32_t* size = sizes[random.Next(3) == 0 ? random.Next(7) : scale];
+                TexturePoolKey key = { size[0], size[1], formats[random.Next(3)], 0x1, { 0.0f, 0.0f, 0.0f, 1.0f } };
+                textures.push_back(pool.Acquire(key));
+            }
+            for (uint32_t texture : textures)
+            {
+                pool.Release(texture, frame);
+            }
+            pool.ReleaseCompleted(frame > 2 ? frame - 2 : 0);
+            fragmentation += pool.GetFragmentation();
+        }
+        const double milliseconds = timer.GetMilliseconds();
+
+        const TexturePoolStats stats = pool.GetStats();
+        KeepResult(stats.liveBytes);
+        printf("%-8u %8.1f %9llu %9llu %6u %10.1f %10.1f %9.3f %9.1f\n",
+            scalePeriod, 100.0 * stats.reuseHits / stats.acquires,
+            static_cast<unsigned long long>(stats.creations), static_cast<unsigned long long>(stats.evictions),
+            stats.heapCount, stats.peakHeapBytes / 1048576.0, stats.peakLiveBytes / 1048576.0,
+            fragmentation / frames, milliseconds * 1e6 / stats.acquires);
+    }
+    return 0;
+}
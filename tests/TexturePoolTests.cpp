@@ -0,0 +1,362 @@
+#include "TexturePool.h"
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Sizes of the null backend, checking every texture lies inside a live
+    // heap without overlapping another one.
+    class CheckingBackend : public NullTexturePoolBackend
+    {
+    public:
+        struct Placement
+        {
+            uint32_t heap;
+            uint64_t offset;
+            uint64_t size;
+        };
+
+        CheckingBackend() : heapCreates(0), heapDestroys(0), textureCreates(0) {}
+
+        virtual void CreateHeap(uint32_t heap, uint64_t size)
+        {
+            CHECK(heaps.count(heap) == 0);
+            heaps[heap] = size;
+            heapCreates++;
+        }
+
+        virtual void DestroyHeap(uint32_t heap)
+        {
+            CHECK(heaps.count(heap) == 1);
+            for (const auto& texture : textures)
+            {
+                CHECK(texture.second.heap != heap);
+            }
+            heaps.erase(heap);
+            heapDestroys++;
+        }
+
+        virtual void CreateTexture(uint32_t texture, const TexturePoolKey& key, uint32_t heap, uint64_t offset)
+        {
+            const Placement placement = { heap, offset, GetAllocationInfo(key).size };
+            CHECK(textures.count(texture) == 0);
+            CHECK(heaps.count(heap) == 1);
+            CHECK(offset % (64 * 1024) == 0);
+            CHECK(offset + placement.size <= heaps[heap]);
+            for (const auto& other : textures)
+            {
+                const Placement& p = other.second;
+                CHECK(p.heap != heap || p.offset + p.size <= offset || offset + placement.size <= p.offset);
+            }
+            textures[texture] = placement;
+            textureCreates++;
+        }
+
+        virtual void DestroyTexture(uint32_t texture)
+        {
+            CHECK(textures.count(texture) == 1);
+            textures.erase(texture);
+            destroyed.push_back(texture);
+        }
+
+        std::map<uint32_t, uint64_t> heaps;
+        std::map<uint32_t, Placement> textures;
+        std::vector<uint32_t> destroyed;
+        uint32_t heapCreates;
+        uint32_t heapDestroys;
+        uint32_t textureCreates;
+    };
+
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed) {}
+
+        uint32_t Next(uint32_t range)
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return (m_state >> 8) % range;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+
+    // 128 x 128 RGBA8 is exactly one 64KB placement.
+    const uint64_t TextureSize = 64 * 1024;
+
+    TexturePoolKey MakeKey(uint32_t width, uint32_t height, uint32_t format = 28)
+    {
+        TexturePoolKey key = { width, height, format, 0x1, { 0.0f, 0.0f, 0.0f, 1.0f } };
+        return key;
+    }
+}
+
+TEST(ReleasedTextureIsReusedOnceItsFenceCompletes)
+{
+    CheckingBackend backend;
+    TexturePool pool(backend, 4 * TextureSize);
+
+    const uint32_t first = pool.Acquire(MakeKey(128, 128));
+    pool.Release(first, 5);
+
+    // Still in use by the GPU, the same key needs a second texture.
+    pool.ReleaseCompleted(4);
+    const uint32_t second = pool.Acquire(MakeKey(128, 128));
+    CHECK(second != first);
+    pool.Release(second, 6);
+
+    pool.ReleaseCompleted(6);
+    CHECK_EQUAL(second, pool.Acquire(MakeKey(128, 128)));
+    CHECK_EQUAL(first, pool.Acquire(MakeKey(128, 128)));
+
+    const TexturePoolStats stats = pool.GetStats();
+    CHECK_EQUAL(4u, stats.acquires);
+    CHECK_EQUAL(2u, stats.reuseHits);
+    CHECK_EQUAL(2u, stats.creations);
+    CHECK_EQUAL(2u, backend.textureCreates);
+    CHECK_EQUAL(2 * TextureSize, stats.liveBytes);
+    CHECK_EQUAL(0u, stats.cachedBytes);
+}
+
+TEST(EveryFieldOfTheKeyMatters)
+{
+    CheckingBackend backend;
+    TexturePool pool(backend, 16 * TextureSize);
+
+    const uint32_t texture = pool.Acquire(MakeKey(128, 128));
+    pool.Release(texture, 1);
+    pool.ReleaseCompleted(1);
+
+    TexturePoolKey other = MakeKey(128, 128);
+    other.clearColor[2] = 1.0f;
+    CHECK(pool.Acquire(other) != texture);
+    other = MakeKey(128, 128);
+    other.flags = 0x4;
+    CHECK(pool.Acquire(other) != texture);
+    CHECK(pool.Acquire(MakeKey(128, 128, 10)) != texture);
+    CHECK(pool.Acquire(MakeKey(64, 256)) != texture);
+
+    CHECK_EQUAL(texture, pool.Acquire(MakeKey(128, 128)));
+    CHECK_EQUAL(1u, pool.GetStats().reuseHits);
+}
+
+TEST(FullHeapEvictsTheLeastRecentlyReleased)
+{
+    CheckingBackend backend;
+    TexturePool pool(backend, 2 * TextureSize);
+
+    const uint32_t a = pool.Acquire(MakeKey(128, 128));
+    const uint32_t b = pool.Acquire(MakeKey(128, 128, 10));
+    pool.Release(b, 1);
+    pool.Release(a, 2);
+    pool.ReleaseCompleted(2);
+
+    // b was released first, it goes first.
+    pool.Acquire(MakeKey(128, 128, 2));
+    CHECK_EQUAL(1u, backend.destroyed.size());
+    CHECK_EQUAL(b, backend.destroyed[0]);
+    CHECK_EQUAL(1u, backend.heapCreates);
+
+    // a is still cached.
+    CHECK_EQUAL(a, pool.Acquire(MakeKey(128, 128)));
+
+    const TexturePoolStats stats = pool.GetStats();
+    CHECK_EQUAL(1u, stats.evictions);
+    CHECK_EQUAL(1u, stats.heapCount);
+}
+
+TEST(ReuseRefreshesTheEvictionOrder)
+{
+    CheckingBackend backend;
+    TexturePool pool(backend, 2 * TextureSize);
+
+    const uint32_t a = pool.Acquire(MakeKey(128, 128));
+    const uint32_t b = pool.Acquire(MakeKey(128, 128, 10));
+    pool.Release(a, 1);
+    pool.Release(b, 2);
+    pool.ReleaseCompleted(2);
+
+    // Reusing a and releasing it again makes b the oldest.
+    CHECK_EQUAL(a, pool.Acquire(MakeKey(128, 128)));
+    pool.Release(a, 3);
+    pool.ReleaseCompleted(3);
+
+    pool.Acquire(MakeKey(128, 128, 2));
+    CHECK_EQUAL(1u, backend.destroyed.size());
+    CHECK_EQUAL(b, backend.destroyed[0]);
+}
+
+TEST(HeapsOnlyGrowWhenNothingCanBeEvicted)
+{
+    CheckingBackend backend;
+    TexturePool pool(backend, 2 * TextureSize);
+
+    const uint32_t a = pool.Acquire(MakeKey(128, 128));
+    pool.Acquire(MakeKey(128, 128));
+
+    // Pending textures cannot be evicted.
+    pool.Release(a, 10);
+    pool.Acquire(MakeKey(128, 128));
+    CHECK_EQUAL(2u, backend.heapCreates);
+    CHECK_EQUAL(0u, pool.GetStats().evictions);
+
+    // A texture larger than the heap size gets a heap of its own size.
+    pool.Acquire(MakeKey(256, 256));
+    CHECK_EQUAL(3u, backend.heapCreates);
+    CHECK_EQUAL(4 * TextureSize, backend.heaps[2]);
+
+    const TexturePoolStats stats = pool.GetStats();
+    CHECK_EQUAL(3u, stats.heapCount);
+    CHECK_EQUAL(8 * TextureSize, stats.heapBytes);
+    CHECK_EQUAL(8 * TextureSize, stats.peakHeapBytes);
+    CHECK_EQUAL(7 * TextureSize, stats.liveBytes);
+}
+
+TEST(TrimDestroysTheCacheAndEmptyHeaps)
+{
+    CheckingBackend backend;
+    TexturePool pool(backend, 2 * TextureSize);
+
+    std::vector<uint32_t> textures;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        textures.push_back(pool.Acquire(MakeKey(128, 128)));
+    }
+    CHECK_EQUAL(2u, backend.heapCreates);
+
+    // Heap 0 keeps a pending texture, which survives, heap 1 only has
+    // cached ones.
+    pool.Release(textures[0], 1);
+    pool.Release(textures[2], 1);
+    pool.Release(textures[3], 1);
+    pool.ReleaseCompleted(1);
+    pool.Release(textures[1], 2);
+
+    pool.Trim();
+    CHECK_EQUAL(3u, backend.destroyed.size());
+    CHECK_EQUAL(1u, backend.heapDestroys);
+    CHECK_EQUAL(1u, backend.heaps.size());
+
+    const TexturePoolStats stats = pool.GetStats();
+    CHECK_EQUAL(1u, stats.heapCount);
+    CHECK_EQUAL(2 * TextureSize, stats.heapBytes);
+    CHECK_EQUAL(4 * TextureSize, stats.peakHeapBytes);
+    CHECK_EQUAL(0u, stats.cachedBytes);
+    CHECK_EQUAL(TextureSize, stats.liveBytes);
+
+    // The remaining texture is still reused after trimming.
+    pool.ReleaseCompleted(2);
+    CHECK_EQUAL(textures[1], pool.Acquire(MakeKey(128, 128)));
+}
+
+TEST(FragmentationComparesTheLargestBlockToAllFreeSpace)
+{
+    CheckingBackend backend;
+    TexturePool pool(backend, 4 * TextureSize);
+    CHECK_NEAR(0.0, pool.GetFragmentation(), 1e-9);
+
+    std::vector<uint32_t> textures;
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        textures.push_back(pool.Acquire(MakeKey(128, 128, 10 + i)));
+    }
+    CHECK_NEAR(0.0, pool.GetFragmentation(), 1e-9);
+
+    // Free blocks 0 and 2, not adjacent: half of the free space is usable at once.
+    pool.Release(textures[0], 1);
+    pool.Release(textures[2], 1);
+    pool.ReleaseCompleted(1);
+    pool.Trim();
+    CHECK_NEAR(0.5, pool.GetFragmentation(), 1e-9);
+
+    // Freeing 1 merges the three blocks.
+    pool.Release(textures[1], 2);
+    pool.ReleaseCompleted(2);
+    pool.Trim();
+    CHECK_NEAR(0.0, pool.GetFragmentation(), 1e-9);
+
+    // The merged block fits a texture three times the size.
+    pool.Acquire(MakeKey(128, 384));
+    CHECK_EQUAL(1u, backend.heapCreates);
+}
+
+TEST(MisuseThrows)
+{
+    CheckingBackend backend;
+    CHECK_THROWS(TexturePool(backend, 0), std::invalid_argument);
+
+    TexturePool pool(backend);
+    const uint32_t texture = pool.Acquire(MakeKey(128, 128));
+    pool.Release(texture, 1);
+    CHECK_THROWS(pool.Release(texture, 2), std::logic_error);
+    CHECK_THROWS(pool.Release(texture + 1, 2), std::out_of_range);
+}
+
+// Frames of a dynamic resolution renderer: the main targets follow a scale
+// that changes every 50 frames, a third of the acquires are odd sizes, and
+// textures are released two frames before the GPU is done with them. The
+// checking backend sees every placement; the stats have to add up, the pool
+// has to reuse three textures out of four and stay within a few heaps.
+TEST(DynamicResolutionSimulation)
+{
+    const uint32_t sizes[][2] = { { 1920, 1080 }, { 1280, 720 }, { 960, 540 }, { 640, 360 }, { 3840, 2160 }, { 256, 256 }, { 512, 512 } };
+    const uint32_t formats[] = { 28, 10, 2 };
+    const uint64_t heapSize = 64 * 1024 * 1024;
+
+    CheckingBackend backend;
+    TexturePool pool(backend, heapSize);
+    Random random(14);
+
+    const uint64_t frames = 2000;
+    uint64_t peakLiveBytes = 0;
+    for (uint64_t frame = 1; frame <= frames; ++frame)
+    {
+        const uint32_t scale = (frame / 50) % 4;
+        std::vector<uint32_t> textures;
+        const uint32_t count = 3 + random.Next(6);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t* size = sizes[random.Next(3) == 0 ? random.Next(7) : scale];
+            textures.push_back(pool.Acquire(MakeKey(size[0], size[1], formats[random.Next(3)])));
+        }
+
+        peakLiveBytes = std::max<uint64_t>(peakLiveBytes, pool.GetStats().liveBytes);
+
+        for (uint32_t texture : textures)
+        {
+            pool.Release(texture, frame);
+        }
+        pool.ReleaseCompleted(frame > 2 ? frame - 2 : 0);
+
+        const TexturePoolStats stats = pool.GetStats();
+        uint64_t placedBytes = 0;
+        for (const auto& texture : backend.textures)
+        {
+            placedBytes += texture.second.size;
+        }
+        CHECK_EQUAL(placedBytes, stats.liveBytes + stats.cachedBytes);
+        CHECK(stats.heapBytes >= placedBytes);
+        CHECK(pool.GetFragmentation() >= 0.0 && pool.GetFragmentation() < 1.0);
+
+        if (frame % 500 == 0)
+        {
+            pool.Trim();
+            CHECK_EQUAL(0u, pool.GetStats().cachedBytes);
+        }
+    }
+
+    const TexturePoolStats stats = pool.GetStats();
+    CHECK_EQUAL(stats.acquires, stats.reuseHits + stats.creations);
+    CHECK_EQUAL(backend.textureCreates, stats.creations);
+    CHECK_EQUAL(peakLiveBytes, stats.peakLiveBytes);
+    CHECK(stats.reuseHits * 4 > stats.acquires * 3);
+
+    // Cached textures and fragmentation cost at most as much as the peak of
+    // the live ones, plus the heap that could not be filled.
+    CHECK(stats.peakHeapBytes <= 2 * stats.peakLiveBytes + heapSize);
+}
@@ -0,0 +1,42 @@
+#include "UploadRing.h"
+#include "Benchmark.h"
+
+#include <cstdio>
+
+// Allocations per second of 256-byte constant slices, the per-draw pattern
+// of the sample, for a few frame sizes. The GPU is two frames behind.
+int main(int argc, char** argv)
+{
+    const bool quick = IsQuickBenchmark(argc, argv);
+    const uint32_t frameCount = quick ? 10 : 2000;
+    const uint32_t drawCounts[] = { 16, 256, 4096, 16384 };
+
+    printf("%8s %14s %12s\n", "draws", "allocs/s", "ns/alloc");
+    for (uint32_t draws : drawCounts)
+    {
+        UploadRing ring(3ull * draws * 256);
+        uint64_t checksum = 0;
+
+        BenchmarkTimer timer;
+        for (uint32_t frame = 1; frame <= frameCount; ++frame)
+        {
+            ring.ReleaseCompleted(frame > 2 ? frame - 2 : 0);
+            for (uint32_t draw = 0; draw < draws; ++draw)
+            {
+                checksum += ring.Allocate(sizeof(float) * 12, 256);
+            }
+            ring.FinishFrame(frame);
+        }
+        const double milliseconds = timer.GetMilliseconds();
+        KeepResult(checksum);
+
+        const double allocations = static_cast<double>(ring.GetStats().allocations);
+        printf("%8u %14.0f %12.2f\n", draws, allocations / milliseconds * 1000.0, milliseconds * 1e6 / allocations);
+        if (ring.GetStats().failedAllocations)
+        {
+            fprintf(stderr, "the ring ran out of space\n");
+            return 1;
+        }
+    }
+    return 0;
+}
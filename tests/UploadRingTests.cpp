@@ -0,0 +1,228 @@
+#include "UploadRing.h"
+#include "TestHarness.h"
+
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Fence that completes what is waited for, and nothing else.
+    class FakeFrameQueue : public IFrameQueue
+    {
+    public:
+        FakeFrameQueue() : completedValue(0), waits(0) {}
+
+        virtual void Signal(uint64_t)                   {}
+        virtual uint64_t GetCompletedValue()            { return completedValue; }
+        virtual void WaitForValue(uint64_t fenceValue)
+        {
+            waits++;
+            completedValue = fenceValue > completedValue ? fenceValue : completedValue;
+        }
+
+        uint64_t completedValue;
+        uint32_t waits;
+    };
+
+    struct Slice
+    {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t fenceValue;    // 0 while its frame is recorded.
+    };
+
+    // Deterministic, the same sequence on every platform.
+    class Random
+    {
+    public:
+        explicit Random(uint32_t seed) : m_state(seed) {}
+
+        uint32_t Next(uint32_t range)
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return (m_state >> 8) % range;
+        }
+
+    private:
+        uint32_t m_state;
+    };
+}
+
+TEST(RejectsInvalidArguments)
+{
+    CHECK_THROWS(UploadRing(0), std::invalid_argument);
+
+    UploadRing ring(1024);
+    CHECK_THROWS(ring.Allocate(0, 256), std::invalid_argument);
+    CHECK_THROWS(ring.Allocate(16, 0), std::invalid_argument);
+    CHECK_THROWS(ring.Allocate(16, 24), std::invalid_argument);
+
+    FakeFrameQueue queue;
+    CHECK_THROWS(ring.AllocateBlocking(2048, 256, queue), std::length_error);
+
+    ring.FinishFrame(2);
+    CHECK_THROWS(ring.FinishFrame(1), std::logic_error);
+}
+
+TEST(HandsOutAlignedSlicesInOrder)
+{
+    UploadRing ring(4096);
+    CHECK_EQUAL(0ull, ring.Allocate(48, 256));
+    CHECK_EQUAL(256ull, ring.Allocate(48, 256));
+    CHECK_EQUAL(304ull, ring.Allocate(16, 16));
+    CHECK_EQUAL(512ull, ring.Allocate(256, 256));
+    CHECK_EQUAL(768ull, ring.GetUsedSize());
+    CHECK_EQUAL(4ull, ring.GetStats().allocations);
+}
+
+TEST(ReclaimsByFenceValue)
+{
+    UploadRing ring(1024);
+    CHECK_EQUAL(0ull, ring.Allocate(512, 256));
+    ring.FinishFrame(1);
+    CHECK_EQUAL(512ull, ring.Allocate(512, 256));
+    ring.FinishFrame(2);
+
+    CHECK_EQUAL(UploadRing::InvalidOffset, ring.Allocate(256, 256));
+    CHECK_EQUAL(1ull, ring.GetStats().failedAllocations);
+
+    // The first frame's half comes back, the ring wraps into it.
+    ring.ReleaseCompleted(1);
+    CHECK_EQUAL(512ull, ring.GetUsedSize());
+    CHECK_EQUAL(0ull, ring.Allocate(256, 256));
+    CHECK_EQUAL(256ull, ring.Allocate(256, 256));
+    CHECK_EQUAL(UploadRing::InvalidOffset, ring.Allocate(256, 256));
+
+    // A completed value past every frame restarts the ring at 0.
+    ring.FinishFrame(3);
+    ring.ReleaseCompleted(3);
+    CHECK_EQUAL(0ull, ring.GetUsedSize());
+    CHECK_EQUAL(0ull, ring.Allocate(1024, 256));
+    CHECK_EQUAL(1024ull, ring.GetStats().peakUsedSize);
+}
+
+TEST(SkipsTheEndOfTheRingWhenASliceDoesNotFit)
+{
+    UploadRing ring(1024);
+    ring.Allocate(256, 256);
+    ring.FinishFrame(1);
+    ring.Allocate(512, 256);
+    ring.FinishFrame(2);
+    ring.ReleaseCompleted(1);
+
+    // 256 bytes left at the end and 256 at the start: a 512 byte slice fits
+    // neither, a 256 one goes at the end.
+    CHECK_EQUAL(UploadRing::InvalidOffset, ring.Allocate(512, 256));
+    CHECK_EQUAL(768ull, ring.Allocate(256, 256));
+
+    // The wasted end counts as used until the frame retires.
+    ring.FinishFrame(3);
+    ring.ReleaseCompleted(2);
+    CHECK_EQUAL(0ull, ring.Allocate(384, 128));
+    CHECK_EQUAL(256ull + 384ull, ring.GetUsedSize());
+}
+
+TEST(AllocateBlockingWaitsForTheOldestFrame)
+{
+    FakeFrameQueue queue;
+    UploadRing ring(1024);
+    ring.AllocateBlocking(512, 256, queue);
+    ring.FinishFrame(1);
+    ring.AllocateBlocking(512, 256, queue);
+    ring.FinishFrame(2);
+
+    CHECK_EQUAL(0ull, ring.AllocateBlocking(512, 256, queue));
+    CHECK_EQUAL(1u, queue.waits);
+    CHECK_EQUAL(1ull, queue.completedValue);
+    CHECK_EQUAL(1ull, ring.GetStats().fenceWaits);
+
+    // Nothing can free the current frame's space.
+    CHECK_THROWS(ring.AllocateBlocking(1024, 256, queue), std::length_error);
+}
+
+// Random frames of random slices against a model of the live slices: every
+// slice is aligned, inside the ring and overlaps no slice still in flight, and
+// the ring only reports itself full when the model agrees it may be.
+TEST(StressAgainstAModelOfTheLiveSlices)
+{
+    const uint64_t ringSize = 64 * 1024;
+    UploadRing ring(ringSize);
+    FakeFrameQueue queue;
+    Random random(12345);
+    std::vector<Slice> live;
+    uint64_t fenceValue = 0;
+    uint64_t allocations = 0;
+
+    for (uint32_t frame = 0; frame < 2000; ++frame)
+    {
+        // The GPU is 0 to 3 frames behind.
+        const uint64_t lag = random.Next(4);
+        queue.completedValue = fenceValue > lag ? fenceValue - lag : 0;
+        ring.ReleaseCompleted(queue.completedValue);
+        for (size_t i = 0; i < live.size();)
+        {
+            if (live[i].fenceValue != 0 && live[i].fenceValue <= queue.completedValue)
+            {
+                live[i] = live.back();
+                live.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        const uint32_t sliceCount = 1 + random.Next(40);
+        for (uint32_t i = 0; i < sliceCount; ++i)
+        {
+            const uint64_t alignment = 1ull << random.Next(9);
+            const uint64_t size = 1 + random.Next(random.Next(8) == 0 ? 8192 : 512);
+            const uint64_t offset = ring.AllocateBlocking(size, alignment, queue);
+
+            // A wait retired frames, the model follows.
+            for (size_t j = 0; j < live.size();)
+            {
+                if (live[j].fenceValue != 0 && live[j].fenceValue <= queue.completedValue)
+                {
+                    live[j] = live.back();
+                    live.pop_back();
+                }
+                else
+                {
+                    ++j;
+                }
+            }
+
+            CHECK_EQUAL(0ull, offset % alignment);
+            CHECK(offset + size <= ringSize);
+            for (const Slice& other : live)
+            {
+                if (offset < other.offset + other.size && other.offset < offset + size)
+                {
+                    ReportTestFailure(__FILE__, __LINE__, "slice overlaps a live slice");
+                    return;
+                }
+            }
+
+            const Slice slice = { offset, size, 0 };
+            live.push_back(slice);
+            allocations++;
+        }
+
+        fenceValue++;
+        ring.FinishFrame(fenceValue);
+        for (Slice& slice : live)
+        {
+            slice.fenceValue = slice.fenceValue ? slice.fenceValue : fenceValue;
+        }
+        CHECK(ring.GetUsedSize() <= ringSize);
+    }
+
+    const UploadRingStats stats = ring.GetStats();
+    CHECK_EQUAL(allocations, stats.allocations);
+    CHECK(stats.fenceWaits > 0);
+    CHECK(stats.peakUsedSize <= ringSize);
+
+    ring.ReleaseCompleted(fenceValue);
+    CHECK_EQUAL(0ull, ring.GetUsedSize());
+}